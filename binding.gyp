@@ -4,6 +4,46 @@
       "variables": {
         "realm_download_binaries": "1"
       }
+    }],
+    ["realm_build_benchmarks", {
+      "targets": [
+        {
+          # The micro-benchmarks of tests/benchmarks/native.js. The global
+          # operator new is replaced by the module to count allocations, so
+          # it is bound within the module rather than exported to node.
+          "target_name": "realm-benchmarks",
+          "conditions": [
+            [ "OS!='mac'", {
+              "dependencies": [ "object-store", "OpenSSL" ],
+            }, {
+              "dependencies": [ "object-store" ],
+            }],
+            ["OS=='linux'", {
+              "ldflags": [ "-Wl,-Bsymbolic" ],
+            }],
+            ["realm_enable_sync", {
+              "sources": [
+                "src/node/sync_logger.cpp",
+              ]
+            }]
+          ],
+          "xcode_settings": {
+            "OTHER_LDFLAGS": ["-framework Foundation", "-Wl,-exported_symbols_list /dev/null"],
+          },
+          "sources": [
+            "src/js_realm.cpp",
+            "src/node/node_benchmarks.cpp",
+            "src/node/platform.cpp",
+
+            "src/js_benchmarks.hpp",
+          ],
+          "include_dirs": [
+            "src",
+            "src/object-store/src",
+            "src/object-store/external/json",
+          ],
+        }
+      ]
     }]
   ],
   "includes": [
@@ -25,6 +65,8 @@
             "src/node/sync_logger.cpp",
             "src/node/sync_logger.hpp",
             "src/node/js_adapter.hpp",
+            "src/node/changeset_chunker.hpp",
+            "src/node/change_set_codec.hpp",
             "src/node/js_global_notifier.hpp",
           ]
         }]
@@ -37,18 +79,26 @@
         "src/node/node_init.cpp",
         "src/node/platform.cpp",
 
-        "src/concurrent_deque.hpp",
+        "src/boundary_stats.hpp",
+        "src/concurrent_stack.hpp",
+        "src/file_maintenance.hpp",
+        "src/in_memory_snapshot.hpp",
         "src/js_class.hpp",
         "src/js_collection.hpp",
+        "src/js_frozen.hpp",
         "src/js_list.hpp",
+        "src/js_migration.hpp",
         "src/js_object_accessor.hpp",
         "src/js_observable.hpp",
+        "src/js_plain.hpp",
         "src/js_realm.hpp",
         "src/js_realm_object.hpp",
         "src/js_results.hpp",
         "src/js_schema.hpp",
         "src/js_types.hpp",
         "src/js_util.hpp",
+        "src/memory_stats.hpp",
+        "src/trace_events.hpp",
         "src/node/node_class.hpp",
         "src/node/node_context.hpp",
         "src/node/node_exception.hpp",
@@ -173,6 +223,10 @@
         "tests/js/worker-tests-script.js",
         "tests/js/worker.js",
         "tests/package.json",
+        "tests/benchmarks/index.js",
+        "tests/benchmarks/native.js",
+        "tests/benchmarks/property-read.js",
+        "tests/benchmarks/scenarios.js",
         "tests/spec/helpers/mock_realm.js",
         "tests/spec/helpers/reporters.js",
         "tests/spec/helpers/setup-module-path.js",
@@ -126,6 +126,113 @@ class Collection {
      */
     sorted(descriptor, reverse) { }
 
+    /**
+     * Like {@link Realm.Collection#filtered filtered()}, but evaluates the query on a
+     * background thread. Reading the returned _Results_ does not evaluate the query again until
+     * the Realm advances to a newer version.
+     *
+     * Inside a write transaction the query is not evaluated in advance.
+     * @param {string} query - Query used to filter objects from the collection.
+     * @param {...any} [arg] - Each subsequent argument is used by the placeholders
+     *   (e.g. `$0`, `$1`, `$2`, …) in the query.
+     * @returns {Promise<Realm.Results<T>>} resolved with the filtered results once they have been evaluated.
+     * @since 3.7.0
+     */
+    filteredAsync(query, ...arg) { }
+
+    /**
+     * Like {@link Realm.Collection#filtered filtered()}, but with a query prepared by
+     * {@link Realm#prepareQuery prepareQuery()}, which isn't parsed again.
+     * @param {Realm.PreparedQuery} query - A query prepared for the type of objects in this
+     *   collection, in the same Realm.
+     * @param {...any} [arg] - Each subsequent argument is used by the placeholders
+     *   (e.g. `$0`, `$1`, `$2`, …) in the query.
+     * @returns {Realm.Results<T>} filtered according to the provided query.
+     * @since 3.7.0
+     */
+    filteredPrepared(query, ...arg) { }
+
+    /**
+     * Like {@link Realm.Collection#sorted sorted()}, but sorts on a background thread,
+     * as {@link Realm.Collection#filteredAsync filteredAsync()} does.
+     * @param {string|Realm.Collection~SortDescriptor[]} [descriptor] - The property name(s) to sort the collection on.
+     * @param {boolean} [reverse=false] - Sort in descending order rather than ascended.
+     * @returns {Promise<Realm.Results<T>>} resolved with the sorted results once they have been evaluated.
+     * @since 3.7.0
+     */
+    sortedAsync(descriptor, reverse) { }
+
+    /**
+     * Returns new _Results_ with at most `count` objects of this collection, after any sorting
+     * and distinct have been applied. This is the same as adding `LIMIT(count)` to a query.
+     *
+     * Only the objects within the limit are ever read through the returned _Results_, which
+     * stay live: when objects within the limit are removed, those after them take their place.
+     * @example
+     * let mostExpensive = wines.sorted('price', true).limit(20);
+     * @param {number} count - The maximum number of objects.
+     * @throws {Error} If `count` is not a non-negative integer.
+     * @returns {Realm.Results<T>} of at most `count` objects.
+     * @since 3.7.0
+     */
+    limit(count) { }
+
+    /**
+     * Returns a cursor which pages through the objects in this collection in the order of
+     * `options.sortBy`. Each page starts after the last object of the one before it, rather than
+     * at an offset, so objects added or removed before it don't move objects between pages.
+     * Each page is picked without sorting the whole collection.
+     *
+     * The cursor follows the objects which match the collection's query when each page is read.
+     * Its order is that of `options.sortBy` only, not any sorting of the collection itself.
+     * @example
+     * let cursor = orders.cursor({ sortBy: [['date', true]], pageSize: 50 });
+     * while (!cursor.done) {
+     *     let page = cursor.next();
+     * }
+     * @param {Object} [options] - Options for the cursor.
+     * @param {string|Realm.Collection~SortDescriptor[]} [options.sortBy] - The property name(s)
+     *   to order the objects by, as for {@link Realm.Collection#sorted sorted()}. The properties
+     *   must be booleans, numbers, strings or dates. Objects with the same values are ordered by
+     *   their primary key. Defaults to the primary key.
+     * @param {number} [options.pageSize=100] - The greatest number of objects in a page.
+     * @param {Realm.Object} [options.after] - An object to start after, such as the last object
+     *   of a page read by an earlier cursor.
+     * @throws {Error} If the collection does not contain objects with a primary key, or if a
+     *   property does not exist or cannot be ordered by.
+     * @returns {Realm.ResultsCursor<T>}
+     * @since 3.7.0
+     */
+    cursor(options) { }
+
+    /**
+     * Returns all the objects that link to any object in this collection in the specified
+     * relationship, each of them once. They are found in a single pass rather than by calling
+     * {@link Realm.Object#linkingObjects linkingObjects()} for every object. The results are
+     * kept up to date as links to these objects are added and removed, but don't follow
+     * objects which are added to this collection later.
+     * @param {string} objectType - The type of the objects that link to this collection's type.
+     * @param {string} property - The name of the property that references objects of this
+     *   collection's type.
+     * @throws {Error} If the relationship is not valid, or if this is not a collection of objects.
+     * @returns {Realm.Results} the objects that link to the objects in this collection.
+     * @since 3.7.0
+     */
+    linkingObjects(objectType, property) { }
+
+    /**
+     * Counts the links to each object in this collection in the specified relationship, which
+     * is faster than calling {@link Realm.Object#linkingObjects linkingObjects()} for each of
+     * them. An object which is in the same list more than once is counted once for each time.
+     * @param {string} objectType - The type of the objects that link to this collection's type.
+     * @param {string} property - The name of the property that references objects of this
+     *   collection's type.
+     * @throws {Error} If the relationship is not valid, or if this is not a collection of objects.
+     * @returns {Int32Array} holding the number of links to each object, in the order of the collection.
+     * @since 3.7.0
+     */
+    linkingObjectsCounts(objectType, property) { }
+
     /**
      * Create a frozen snapshot of the collection.
      *
@@ -228,11 +335,77 @@ class Collection {
      *   index will be include in the return value. If negative, then the end index will be
      *   counted from the end of the collection. If omitted, then all objects from the start
      *   index will be included in the return value.
+     * @param {Object} [options] - Options for the returned array.
+     * @param {string[]} [options.properties] - If given, plain JS objects holding only these
+     *   properties are returned instead of {@link Realm.Object} instances. Link and list
+     *   values within them are still live Realm objects and collections.
      * @returns {T[]} containing the objects from the start index up to, but not
      *   including, the end index.
      * @since 0.11.0
      */
-    slice(start, end) { }
+    slice(start, end, options) { }
+
+    /**
+     * Copies the values of a collection of numbers or booleans into a typed array in a single
+     * call, rather than reading them one at a time. Lists of `"int"` and `"double"` are copied
+     * into a `Float64Array`, lists of `"float"` into a `Float32Array` and lists of `"bool"` into a
+     * `Uint8Array`, unless another type is asked for. Nulls are copied as `NaN`.
+     * @example
+     * let samples = reading.samples.toTypedArray();
+     * let counts = reading.counts.toTypedArray("Int32Array");
+     * @param {string} [type] - The name of the typed array to copy into, such as `"Int32Array"`.
+     * @throws {Error} If the collection isn't of numbers or booleans, or if a value can't be
+     *   stored in an element of the typed array, such as a null in an integer array.
+     * @returns {TypedArray} holding the values of the collection, in order.
+     * @since 3.7.0
+     */
+    toTypedArray(type) { }
+
+    /**
+     * Copies the objects or values of this collection into a plain array in a single call, as
+     * {@link Realm.Object#toPlain Realm.Object.toPlain()} copies each object.
+     * @example
+     * let body = realm.objects('Person').filtered('age > 30').toPlain({depth: 1, json: true});
+     * @param {Object} [options]
+     * @param {number} [options.depth] - How many links to follow from each object.
+     * @param {string[]} [options.properties] - The properties to copy from each object of the
+     *   collection.
+     * @param {boolean} [options.json=false] - Return a JSON string rather than an array.
+     * @returns {Array|string} the copy of the collection.
+     * @since 3.7.0
+     */
+    toPlain(options) { }
+
+    /**
+     * Returns an iterator over a snapshot of this collection, which reads its elements from
+     * the Realm a chunk at a time rather than one by one. Iterating over the collection with
+     * `for...of`, or through {@link Realm.Collection#values values()} and
+     * {@link Realm.Collection#entries entries()}, reads it in chunks of the default size.
+     * @example
+     * for (let person of realm.objects('Person').iterate({plain: {properties: ['name']}})) {
+     *     names.push(person.name);
+     * }
+     * @param {Object} [options]
+     * @param {number} [options.chunkSize=64] - How many elements to read at a time.
+     * @param {boolean|Object} [options.plain] - Read the elements as plain objects or values
+     *   rather than as {@link Realm.Object}s, either with the defaults or with the options of
+     *   {@link Realm.Collection#toPlain toPlain()}.
+     * @throws {Error} If the options are invalid, or if a property of `options.plain.properties`
+     *   does not exist.
+     * @returns {Iterator<T|Object>}
+     * @since 3.7.0
+     */
+    iterate(options) { }
+
+    /**
+     * Returns a read-only handle to the objects of this collection as they are in the current
+     * version of the Realm, which can be read on any thread. See {@link Realm.FrozenResults}.
+     * @throws {Error} If the collection does not contain objects, or if called inside a write
+     *   transaction, or on a read-only or synchronized Realm.
+     * @returns {Realm.FrozenResults}
+     * @since 3.7.0
+     */
+    freeze() { }
 
     /**
      * @see {@link https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Array/find Array.prototype.find}
@@ -441,6 +614,21 @@ class Collection {
      *      inserted, updated or deleted respectively. `deletions` and `oldModifications` are
      *      indices into the collection before the change happened, while `insertions` and
      *      `newModifications` are indices into the new version of the collection.
+     *      Each list is only created when it is first read.
+     * @param {Object} [options] - Options for the listener.
+     * @param {string} [options.changeSetFormat="array"] - How the lists of indices in `changes`
+     *   are represented: `"array"` for an array of indices, `"int32Array"` for an `Int32Array`
+     *   of indices, or `"ranges"` for an array of `[start, length]` pairs, one for each run of
+     *   consecutive indices.
+     * @param {number} [options.minInterval] - The minimum number of milliseconds between two calls
+     *   of `callback`. Changes arriving sooner are combined into a single change set, which is
+     *   delivered once the interval has passed.
+     * @param {number} [options.maxDelay] - The maximum number of milliseconds a change may be held
+     *   back before `callback` is called with it, even if `minInterval` has not passed.
+     *   `minInterval` and `maxDelay` are not supported with JavaScriptCore, where they throw.
+     * @param {string[]} [options.keyPaths] - The properties to observe on the objects in the
+     *   collection, such as `"name"` or `"owner.avatar"`. Modifications which do not change any
+     *   of them are left out of `changes`, and `callback` is not called if nothing else is left.
      * @throws {Error} If `callback` is not a function.
      * @example
      * wines.addListener((collection, changes) => {
@@ -451,12 +639,43 @@ class Collection {
      *  console.log(`new size of collection: ${collection.length}`);
      * });
      */
-    addListener(callback) { }
+    addListener(callback, options) { }
+
+    /**
+     * Add a listener `callback` which is called with the value of an aggregate of a property of
+     * the objects in a **live** collection: once when it has first been computed, and again each
+     * time it changes. The aggregate is updated from the changes to the collection rather than
+     * being computed over every object again, so keeping it up to date is cheap for large
+     * collections which change a little at a time.
+     *
+     * Listeners added with this method are removed by
+     * {@link Realm.Collection#removeListener removeListener()} and
+     * {@link Realm.Collection#removeAllListeners removeAllListeners()}.
+     * @param {string} aggregate - One of `"min"`, `"max"`, `"sum"` or `"avg"`.
+     * @param {string} property - The name of an `int`, `float` or `double` property of the
+     *   objects in the collection.
+     * @param {function(value, details)} callback - A function to be called with two arguments:
+     *   - `value`: the aggregate, or `undefined` if there are no values to aggregate
+     *      (for `"min"`, `"max"` and `"avg"`),
+     *   - `details`: an object with the `previousValue` of the aggregate (`undefined` when it has
+     *      first been computed), the number of `insertions`, `deletions` and `modifications` of
+     *      the change, and `rescanned`, which is `true` if the aggregate was computed over every
+     *      object again, such as when the current minimum or maximum is removed.
+     * @throws {Error} If `aggregate` is not known, if the collection does not contain objects or
+     *   if `property` does not exist or is not numeric.
+     * @example
+     * orders.observeAggregate("sum", "amount", (total, details) => {
+     *     console.log(`total is now ${total}, was ${details.previousValue}`);
+     * });
+     * @since 3.7.0
+     */
+    observeAggregate(aggregate, property, callback) { }
 
     /**
      * Remove the listener `callback` from the collection instance.
      * @param {function(collection, changes)} callback - Callback function that was previously
-     *   added as a listener through the {@link Collection#addListener addListener} method.
+     *   added as a listener through the {@link Collection#addListener addListener} or
+     *   {@link Collection#observeAggregate observeAggregate} method.
      * @throws {Error} If `callback` is not a function.
      */
     removeListener(callback) { }
@@ -0,0 +1,136 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2020 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A read-only handle to a version of a Realm, returned by {@link Realm#freeze freeze()} or
+ * {@link Realm.resolveFrozen}. It never changes as the Realm is written to, and keeps its
+ * version in the file until every handle to it has been closed or garbage collected.
+ *
+ * A handle belongs to the thread it was created on. Its {@link Realm.FrozenRealm#id id} can be
+ * posted to any other thread, such as a Node.js worker thread, and resolved there with
+ * {@link Realm.resolveFrozen} while the handle is alive. Each thread then reads the version on
+ * its own, without waiting for the others.
+ * @memberof Realm
+ * @since 3.7.0
+ */
+class FrozenRealm {
+
+    /**
+     * The id with which this version can be resolved on another thread.
+     * @type {number}
+     * @readonly
+     */
+    get id() { }
+
+    /**
+     * The version of the Realm this handle reads.
+     * @type {number}
+     * @readonly
+     */
+    get version() { }
+
+    /**
+     * Whether {@link Realm.FrozenRealm#close close()} has been called on this handle.
+     * @type {boolean}
+     * @readonly
+     */
+    get isClosed() { }
+
+    /**
+     * Returns every object of a type, as it is in this version.
+     * @param {string} type - The name of the object type.
+     * @throws {Error} If the type is not in the schema of the Realm.
+     * @returns {Realm.FrozenResults}
+     */
+    objects(type) { }
+
+    /**
+     * Releases this handle. The version is released once every handle to it has been.
+     */
+    close() { }
+}
+
+/**
+ * A read-only handle to the objects of a collection as they were in one version of a Realm,
+ * returned by {@link Realm.Collection#freeze freeze()}, {@link Realm.FrozenRealm#objects objects()}
+ * or {@link Realm.resolveFrozen}. The objects are read as plain objects, with the options of
+ * {@link Realm.Collection#toPlain toPlain()}.
+ *
+ * It is shared with other threads by its {@link Realm.FrozenResults#id id}, as a
+ * {@link Realm.FrozenRealm} is.
+ * @memberof Realm
+ * @since 3.7.0
+ */
+class FrozenResults {
+
+    /**
+     * The number of objects.
+     * @type {number}
+     * @readonly
+     */
+    get length() { }
+
+    /**
+     * The name of the type of the objects.
+     * @type {string}
+     * @readonly
+     */
+    get objectType() { }
+
+    /**
+     * The id with which this collection can be resolved on another thread.
+     * @type {number}
+     * @readonly
+     */
+    get id() { }
+
+    /**
+     * The version of the Realm this handle reads.
+     * @type {number}
+     * @readonly
+     */
+    get version() { }
+
+    /**
+     * Whether {@link Realm.FrozenResults#close close()} has been called on this handle.
+     * @type {boolean}
+     * @readonly
+     */
+    get isClosed() { }
+
+    /**
+     * Reads an object as a plain object.
+     * @param {number} index - The index of the object.
+     * @param {Object} [options] - The options of {@link Realm.Collection#toPlain toPlain()}.
+     * @returns {Object|null|undefined} the object, `null` if it had been deleted from the
+     *   snapshot which was frozen, or `undefined` if `index` is out of range.
+     */
+    get(index, options) { }
+
+    /**
+     * Reads every object as a plain object.
+     * @param {Object} [options] - The options of {@link Realm.Collection#toPlain toPlain()}.
+     * @returns {Array<Object|null>|string}
+     */
+    toPlain(options) { }
+
+    /**
+     * Releases this handle. The version is released once every handle to it has been.
+     */
+    close() { }
+}
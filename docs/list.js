@@ -73,6 +73,48 @@ class List extends Collection {
      */
     splice(index, count, ...object) { }
 
+    /**
+     * Replaces the contents of the list with `items`, changing only what differs. Values which
+     * are already in the list are kept, as few of them as possible are moved, and only the
+     * others are deleted or inserted. Listeners and sync are told about those changes only,
+     * rather than about the whole list being replaced.
+     *
+     * Objects in the list are the same as items which are the same Realm object, or, for types
+     * with a primary key, plain objects with the same primary key. Values in lists of other types
+     * are the same when they are equal.
+     * @example
+     * realm.write(() => {
+     *     person.dogs.assign(sortedDogs);
+     *     person.tags.assign(["a", "b", "c"]);
+     * });
+     * @param {T[]} items - The new contents of the list.
+     * @param {Object} [options] - Options for lists of objects.
+     * @param {string} [options.key] - The name of a property which identifies objects instead. A
+     *   plain object item with the value of `key` of an object in the list is written to that
+     *   object rather than creating a new one.
+     * @throws {Error} If not inside a write transaction, if an item is not valid for the list, or if
+     *   `key` is given for a list of values or is not a property of its objects.
+     * @returns {Object} with the numbers of `deletions`, `insertions` and `moves` made to the list.
+     * @since 3.7.0
+     */
+    assign(items, options) { }
+
+    /**
+     * Replaces the contents of a list of numbers or booleans with the elements of a typed array
+     * in a single call. Values which are already at their index are left alone, so only the
+     * elements which change are reported to listeners and sync.
+     * @example
+     * realm.write(() => {
+     *     reading.samples.setFromTypedArray(new Float64Array(buffer));
+     * });
+     * @param {TypedArray} array - The new contents of the list. Elements written to a list of
+     *   `"int"` must be integers, and non-zero elements are `true` in a list of `"bool"`.
+     * @throws {Error} If not inside a write transaction, if the list isn't of numbers or
+     *   booleans, or if an element can't be stored in the list.
+     * @since 3.7.0
+     */
+    setFromTypedArray(array) { }
+
     /**
      * Add one or more values to the _beginning_ of the list.
      *
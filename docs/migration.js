@@ -0,0 +1,86 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2020 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+/**
+ * The operations passed to the `migration` function of a {@link Realm~Configuration configuration},
+ * which change a property of every object of a type in a single pass, rather than one object at
+ * a time. They can only be used during the migration function.
+ * @memberof Realm
+ * @since 3.7.0
+ */
+class Migration {
+
+    /**
+     * Renames a property, keeping its values. `newName` must be in the new schema and `oldName`
+     * must not be.
+     * @param {string} objectType - The type of the objects.
+     * @param {string} oldName - The name of the property in the old schema.
+     * @param {string} newName - The name of the property in the new schema.
+     */
+    renameProperty(objectType, oldName, newName) { }
+
+    /**
+     * Copies the values of a property of the old Realm to a property of the new one. Objects are
+     * matched by their position, so properties must be copied before objects of the type are
+     * created or deleted.
+     * @param {string} objectType - The type of the objects.
+     * @param {string} from - The property of the old schema to copy from.
+     * @param {string} to - The property of the new schema to copy to.
+     * @param {string|function} [transform] - How values are converted:
+     *   - `'toString'` - Numbers and booleans are written as strings.
+     *   - `'toNumber'` - Strings and booleans are written as numbers, as `Number()` would convert
+     *     them. Strings which aren't numbers can't be written to `int` properties.
+     *   - `'default'` - Values are copied as they are, and `null` is replaced by the default value
+     *     of the property.
+     *   - A function, which is called with each value and returns the value to write.
+     *
+     *   Without a transform, values are copied as they are, and numbers are converted between
+     *   `int`, `float` and `double`.
+     * @throws {Error} If the values of `from` can't be written to `to`.
+     */
+    copyProperty(objectType, from, to, transform) { }
+
+    /**
+     * Writes the same value to a property of every object of a type.
+     * @param {string} objectType - The type of the objects.
+     * @param {string} property - The property of the new schema to write.
+     * @param {any} [value] - The value to write, which by default is the `default` of the
+     *   property in the schema, or `null` for optional properties without one.
+     * @throws {Error} If no value is given and the property has no default value.
+     */
+    fillDefault(objectType, property, value) { }
+
+    /**
+     * Deletes the objects of a type in the new Realm which match a query.
+     * @param {string} objectType - The type of the objects.
+     * @param {string} query - The query, as given to {@link Realm.Collection#filtered filtered()}.
+     * @param {...any} [arg] - The values of the placeholders of the query.
+     * @returns {number} the number of objects which were deleted.
+     */
+    deleteWhere(objectType, query, ...arg) { }
+
+    /**
+     * Sets the function called as the operations progress. It is called with the name of the
+     * operation, the type of the objects, the number of objects done and the number of objects
+     * in total, every 65536 objects and when the operation is done.
+     * @param {?callback(string, string, number, number)} callback - The function, or `null` to
+     *   stop reporting progress.
+     */
+    setProgressCallback(callback) { }
+
+}
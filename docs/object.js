@@ -32,7 +32,8 @@ class Object {
     isValid() { }
 
     /**
-     * Returns the schema for the type this object belongs to.
+     * Returns the schema for the type this object belongs to. The object is frozen, and is the
+     * same one found in {@link Realm#schema Realm.schema}.
      * @returns {Realm~ObjectSchema} the schema that describes this object.
      * @since 1.8.1
      */
@@ -55,6 +56,25 @@ class Object {
      */
     linkingObjectsCount() { }
 
+    /**
+     * Copies this object into a plain JS object in a single call, following its links to other
+     * objects. An object reached through several links is copied once, so the copy links back
+     * to itself where the objects do. Computed properties such as linking objects are left out,
+     * dates are copied as `Date` objects and data as `ArrayBuffer` copies.
+     * @param {Object} [options]
+     * @param {number} [options.depth] - How many links to follow from this object. Links further
+     *   away are `null`. All of them are followed by default.
+     * @param {string[]} [options.properties] - The properties to copy from this object, rather
+     *   than all of them. The objects it links to are copied whole.
+     * @param {boolean} [options.json=false] - Return a JSON string rather than a plain object,
+     *   without creating the objects in between. Dates are written as `Date.toJSON()` writes
+     *   them and data as base64. Links which lead back to an object being written can't be
+     *   written, and throw an error unless `depth` stops before them.
+     * @returns {Object|string} the copy of the object.
+     * @since 3.7.0
+     */
+    toPlain(options) { }
+
     /**
      * Add a listener `callback` which will be called when a **live** object instance changes.
      * @param {function(obj, changes)} callback - A function to be called when changes occur.
@@ -63,7 +83,11 @@ class Object {
      *   - `changes`: a dictionary with keys `deleted`, and `changedProperties`. `deleted` is true
      *       if the object has been deleted. `changesProperties` is an array of properties that have changed
      *       their value.
-     * @throws {Error} If `callback` is not a function.
+     * @param {Object} [options] - Options for the listener.
+     * @param {string[]} [options.keyPaths] - The properties to observe, such as `"name"`, or
+     *   `"owner"` for a link. `callback` is only called when one of them changes or the object
+     *   is deleted.
+     * @throws {Error} If `callback` is not a function, or if a key path does not refer to a property.
      * @since 2.23.0
      * @example
      * wine.addListener((obj, changes) => {
@@ -75,7 +99,7 @@ class Object {
      *   });
      * })
      */
-    addListener(callback) { }
+    addListener(callback, options) { }
 
     /**
      * Remove the listener `callback`
@@ -0,0 +1,35 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2020 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A query returned by {@link Realm#prepareQuery prepareQuery()}. It is parsed once, and can be
+ * run many times with different arguments for its placeholders.
+ * @memberof Realm
+ * @since 3.7.0
+ */
+class PreparedQuery {
+
+    /**
+     * Runs the query against all objects of the type it was prepared for.
+     * @param {...any} [arg] - Each argument is used by the placeholders
+     *   (e.g. `$0`, `$1`, `$2`, …) in the query.
+     * @returns {Realm.Results} of the objects matching the query.
+     */
+    run(...arg) { }
+
+}
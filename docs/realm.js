@@ -54,6 +54,7 @@ class Realm {
     /**
      * A normalized representation of the schema provided in the
      * {@link Realm~Configuration Configuration} when this Realm was constructed.
+     * The same frozen array is returned until the schema changes.
      * @type {Realm~ObjectSchema[]}
      * @readonly
      * @since 0.12.0
@@ -117,6 +118,23 @@ class Realm {
      */
     static open(config) { }
 
+    /**
+     * Open several Realms asynchronously with a promise. Synced Realms are downloaded in parallel,
+     * over a single connection if session multiplexing is enabled, so the time it takes is bounded
+     * by the largest of them rather than by their sum.
+     * If any of the Realms fails to open, the ones which are still being opened are cancelled and
+     * the promise is rejected with the error. Realms which were already opened are left open.
+     * @param {Array<Realm~Configuration>} configs - the configurations of the Realms to open
+     * @param {Object} [options]
+     * @param {number} [options.concurrency] - how many Realms are opened at a time, all of them by default
+     * @returns {ProgressPromise} - a promise that will be resolved with the Realms, in the order of
+     *   their configurations, once all of them are available. Its progress callbacks receive the
+     *   bytes transferred and transferable summed over all of the Realms.
+     * @throws {Error} If `configs` is not an array or `options.concurrency` is invalid.
+     * @since 3.7.0
+     */
+    static openAll(configs, options) { }
+
     /**
      * Open a Realm asynchronously with a callback. If the Realm is synced, it will be fully
      * synchronized before it is available.
@@ -148,6 +166,32 @@ class Realm {
      */
     static createTemplateObject(objectSchema) { }
 
+    /**
+     * Starts recording trace events for the work done by Realm: write transactions, queries,
+     * change listeners, the progress and connection changes of the sync sessions which are open,
+     * and the requests of the Chrome debugger. Each thread keeps its most recent events, so that
+     * tracing can be left on without its memory growing.
+     * @param {Object} [options]
+     * @param {number} [options.bufferSize=65536] - how many events are kept per thread.
+     * @throws {Error} If tracing has already been started.
+     * @see {@link Realm.stopTracing stopTracing()}
+     * @since 3.7.0
+     */
+    static startTracing(options) { }
+
+    /**
+     * Stops recording trace events.
+     * @example
+     * Realm.startTracing();
+     * // ...
+     * fs.writeFileSync('realm-trace.json', Realm.stopTracing());
+     * @returns {string} The events in Chrome's trace event format, which can be opened in
+     *   `chrome://tracing` or Perfetto.
+     * @throws {Error} If tracing hasn't been started.
+     * @since 3.7.0
+     */
+    static stopTracing() { }
+
     /**
      * Closes this Realm so it may be re-opened with a newer schema version.
      * All objects and collections from this Realm are no longer valid after calling this method.
@@ -207,12 +251,36 @@ class Realm {
      */
     create(type, properties, updateMode) {}
 
+    /**
+     * Create new Realm objects of the given type from each of the provided property sets in a single call.
+     * This avoids the per-object overhead of calling {@link Realm#create create()} in a loop when inserting
+     * many objects, and no `Realm.Object` instances are created for the new objects.
+     * @param {Realm~ObjectType} type - The type of Realm objects to create.
+     * @param {Array<Object|Array>} objects - Property values for each object to create. Each element is either
+     *   an object, like for {@link Realm#create create()}, or an array with a value for every property in the
+     *   order of the schema.
+     * @param {boolean|string} [updateMode='never'] - Optional update mode, see {@link Realm#create create()}.
+     * @since 3.7.0
+     */
+    createMany(type, objects, updateMode) {}
+
     /**
      * Deletes the provided Realm object, or each one inside the provided collection.
      * @param {Realm.Object|Realm.Object[]|Realm.List|Realm.Results} object
      */
     delete(object) { }
 
+    /**
+     * Deletes the objects of the given type with the provided primary keys, without first having to look
+     * up the objects. Keys which don't match an object are ignored.
+     * @param {Realm~ObjectType} type - The type of Realm objects to delete.
+     * @param {Array<number|string>} keys - The primary keys of the objects to delete.
+     * @throws {Error} If the type does not have a primary key.
+     * @returns {number} The number of objects which were deleted.
+     * @since 3.7.0
+     */
+    deleteByPrimaryKeys(type, keys) { }
+
     /**
      * Deletes a Realm model, including all of its objects.
      * If called outside a migration function, {@link Realm#schema schema} and {@link Realm#schemaVersion schemaVersion} are updated.
@@ -244,6 +312,36 @@ class Realm {
      */
     objectForPrimaryKey(type, key) { }
 
+    /**
+     * Searches for Realm objects by their primary keys. This is faster than calling
+     * {@link Realm#objectForPrimaryKey objectForPrimaryKey()} for each key, as the type is only
+     * looked up once for all of them.
+     * @example
+     * let [first, second] = realm.objectsForPrimaryKeys('Person', [1, 2]);
+     * @param {Realm~ObjectType} type - The type of Realm object to search for.
+     * @param {number[]|string[]} keys - The primary key values of the objects to search for.
+     * @throws {Error} If type passed into this method is invalid, if the object type did
+     *   not have a `primaryKey` specified in its {@link Realm~ObjectSchema ObjectSchema}, or if
+     *   a key is not of the type of the primary key.
+     * @returns {Array<Realm.Object|null>} with the object for each key, at the same index as the
+     *   key, or `null` where no object has the key.
+     * @since 3.7.0
+     */
+    objectsForPrimaryKeys(type, keys) { }
+
+    /**
+     * Parses a query for objects of a type once, so that it can be run many times with different
+     * arguments without being parsed again.
+     * @param {Realm~ObjectType} type - The type of Realm object the query is run on.
+     * @param {string} query - Query used to filter objects, as for
+     *   {@link Realm.Collection#filtered filtered()}.
+     * @throws {Error} If the type or the query is invalid.
+     * @returns {Realm.PreparedQuery} to run against all objects of the type, or to pass to
+     *   {@link Realm.Collection#filteredPrepared filteredPrepared()}.
+     * @since 3.7.0
+     */
+    prepareQuery(type, query) { }
+
     /**
      * Add a listener `callback` for the specified event `name`.
      * @param {string} name - The name of event that should cause the callback to be called.
@@ -251,9 +349,16 @@ class Realm {
      * @param {callback(Realm, string)|callback(Realm, string, Schema)} callback - Function to be called when a change event occurs.
      *   Each callback will only be called once per event, regardless of the number of times
      *   it was added.
-     * @throws {Error} If an invalid event `name` is supplied, or if `callback` is not a function.
+     * @param {Object} [options] - Options for the listener.
+     * @param {number} [options.minInterval] - The minimum number of milliseconds between two calls
+     *   of `callback`. Events arriving sooner result in a single call once the interval has passed.
+     * @param {number} [options.maxDelay] - The maximum number of milliseconds an event may be held
+     *   back before `callback` is called, even if `minInterval` has not passed.
+     *   `minInterval` and `maxDelay` are not supported with JavaScriptCore, where they throw.
+     * @throws {Error} If an invalid event `name` is supplied, if `callback` is not a function, or if
+     *   the Realm was opened in a Node.js worker thread, where change events aren't delivered.
      */
-    addListener(name, callback) { }
+    addListener(name, callback, options) { }
 
     /**
      * Remove the listener `callback` for the specfied event `name`.
@@ -285,6 +390,48 @@ class Realm {
      */
     write(callback) { }
 
+    /**
+     * Call the provided `callback` inside a write transaction at a later turn of the event loop.
+     * Writes queued with `writeAsync()` before then are run one after the other in a single
+     * write transaction, so a burst of writes pays for only one commit.
+     *
+     * If a callback throws, its promise is rejected with the exception, and the other callbacks of
+     * the group are run again in a new transaction without it. Callbacks should therefore only make
+     * changes to the Realm.
+     *
+     * The commit itself still happens on the calling thread.
+     * @param {function(Realm)} callback - Called with the Realm within the write transaction.
+     * @returns {Promise} which is resolved with the return value of `callback` once the write
+     *   transaction has been committed.
+     * @since 3.7.0
+     */
+    writeAsync(callback) { }
+
+    /**
+     * Create a reference to this Realm, or to an object or collection in it, which can be
+     * resolved on another thread with {@link Realm.resolveThreadSafeReference}. The reference
+     * is a plain object, so it can be posted to a Node.js worker thread.
+     *
+     * The object or collection is resolved as it is in the current version of the Realm, or newer.
+     * As the reference keeps that version in the file, it expires if it is not resolved within
+     * five minutes.
+     * @param {Realm.Object|Realm.Results|Realm.List} [value] - What to reference. The Realm itself
+     *   is referenced if it is omitted.
+     * @throws {Error} If `value` does not belong to this Realm, or if called inside a write transaction.
+     * @returns {Realm~ThreadSafeReference} which can be resolved once.
+     * @since 3.7.0
+     */
+    createThreadSafeReference(value) { }
+
+    /**
+     * Returns a read-only handle to the current version of this Realm, which can be read on any
+     * thread. See {@link Realm.FrozenRealm}.
+     * @throws {Error} If called inside a write transaction, or on a read-only or synchronized Realm.
+     * @returns {Realm.FrozenRealm}
+     * @since 3.7.0
+     */
+    freeze() { }
+
     /**
      * Initiate a write transaction.
      *
@@ -340,6 +487,75 @@ class Realm {
      */
     compact() { }
 
+    /**
+     * Compacts the database file like {@link Realm#compact compact()}, but on a background thread so
+     * that the JavaScript thread isn't blocked while the file is rewritten.
+     *
+     * The Realm is closed while the compaction runs and reopened before the promise settles, so
+     * objects, collections and listeners obtained from it before the call are invalidated. Other
+     * `Realm` instances opened with the same configuration on this thread share the closed Realm
+     * and must be opened again. Instances opened with `_reuseOpen` are the exception: while others
+     * share the Realm, only this one is closed and the file isn't compacted.
+     *
+     * Cannot be called from a write transaction, or on a read-only or in-memory Realm.
+     * @param {callback(writtenBytes, totalBytes)} [progress] - Called on the JavaScript thread as the
+     *   compacted copy is written. `totalBytes` is an estimate of the size of the compacted file.
+     * @returns {Promise<boolean>} - a promise resolving to `true` if the file was compacted, or
+     *   `false` if it wasn't because other `Realm` instances were open.
+     * @since 3.7.0
+     */
+    compactAsync(progress) { }
+
+    /**
+     * Reports how the space in the Realm file is used, which can help to decide when to call
+     * {@link Realm#compact compact()}.
+     *
+     * Cannot be called on a read-only, in-memory or synchronized Realm.
+     * @returns {Object} with `fileSize`, the size of the file in bytes, `usedSize`, the bytes
+     *   holding data which compaction would keep, `freeSize`, the bytes in the free list which
+     *   compaction would give back, and `activeVersions`, the number of versions of the data kept
+     *   in the file for readers which haven't caught up with the latest write.
+     *
+     *   For an encrypted Realm, `encryption` has the `pageSize` in bytes of the pages the file is
+     *   encrypted in, `filePages` and `usedPages`, the number of pages of the file and of those
+     *   holding data, which is the largest working set of the Realm, and `decryptedPages`, the
+     *   number of pages currently decrypted in memory for all the encrypted Realms of the
+     *   process. It is `null` for a Realm which isn't encrypted.
+     * @since 3.7.0
+     */
+    fileStats() { }
+
+    /**
+     * Reports what this Realm keeps alive, which can help to find long-lived results or
+     * forgotten `Realm` instances keeping old versions of the data in the file.
+     * @returns {Object} with `fileSize`, the size of the file in bytes (`null` for an
+     *   in-memory Realm), `pinnedVersions`, the number of versions kept in the file for readers
+     *   which haven't caught up with the latest write (`null` for in-memory, read-only and
+     *   synchronized Realms), `readVersionAgeMs`, how long this Realm has been reading its
+     *   current version, `oldestReadVersionAgeMs`, the same for the Realm on this thread which
+     *   has read the same version the longest, and `liveResults`, `liveLists`, `liveObjects`
+     *   and `listeners`, the number of {@link Realm.Results Results}, {@link Realm.List List}
+     *   and {@link Realm.Object Object} instances of this Realm which are alive, and of the
+     *   listeners added to them, and `frozenVersions`, the number of versions of the file kept
+     *   by {@link Realm.FrozenRealm frozen} handles on any thread, and `snapshotError`, the
+     *   error of the last snapshot written for `inMemory: {persistTo}` if it failed, or `null`.
+     * @since 3.7.0
+     */
+    memoryStats() { }
+
+    /**
+     * Sets a callback which is called when the number of versions kept in the Realm file goes
+     * above a threshold, either on a write or when this Realm is refreshed. It is called again
+     * each time the number goes back under the threshold and above it again.
+     *
+     * Cannot be called on a read-only, in-memory or synchronized Realm.
+     * @param {number} threshold - The number of versions above which the callback is called.
+     * @param {?callback(realm, pinnedVersions)} callback - Called with this Realm and the number
+     *   of versions. `null` removes the callback.
+     * @since 3.7.0
+     */
+    setPinnedVersionsWarning(threshold, callback) { }
+
     /**
      * Writes a compacted copy of the Realm to the given path.
      *
@@ -352,6 +568,32 @@ class Realm {
      */
     writeCopyTo(path, encryptionKey) { }
 
+    /**
+     * Writes a compacted copy of the Realm like {@link Realm#writeCopyTo writeCopyTo()}, but on a
+     * background thread so that the JavaScript thread isn't blocked while the copy is written.
+     *
+     * The copy holds the data as of the latest write transaction committed when it starts. Writes
+     * made while it is being written aren't included.
+     *
+     * Instead of a path, a function may be given as the sink for the copy. It is called with an
+     * `ArrayBuffer` for each chunk of the file in order, and may return a promise; the next chunk
+     * isn't handed to it until the promise resolves. If the promise rejects, the copy is cancelled
+     * and the promise returned by this method rejects with the same error.
+     * @param {string|function(ArrayBuffer)} target - the path to write the copy to, which cannot
+     *   already exist, or a function to stream it to.
+     * @param {ArrayBuffer|ArrayBufferView} [encryptionKey] - Optional 64-byte encryption key to
+     *   encrypt the new file with. An encrypted copy can only be written to a path, and without a
+     *   `bytesPerSecond` limit.
+     * @param {Object} [options]
+     * @param {number} [options.bytesPerSecond] - the most bytes to write per second, on average.
+     * @param {callback(writtenBytes, totalBytes)} [options.progress] - Called on the JavaScript
+     *   thread as the copy is written. `totalBytes` is an estimate of the size of the copy.
+     * @returns {Promise<number>} - a promise resolving to the size of the copy in bytes. Calling
+     *   `cancel()` on the promise stops the copy, removes the partially written file and rejects it.
+     * @since 3.7.0
+     */
+    writeCopyToAsync(target, encryptionKey, options) { }
+
     /**
      * Get the current schema version of the Realm at the given path.
      * @param {string} path - The path to the file where the
@@ -370,6 +612,30 @@ class Realm {
      */
     static deleteFile(config) { }
 
+    /**
+     * Delete the files of many Realms, off the JS thread. The files of a Realm
+     * which is still open are left alone.
+     * @param {Array<Realm~Configuration|string>} configs - The configurations
+     *   of the Realms, or the paths of their files.
+     * @throws {Error} If anything in the provided `configs` is invalid.
+     * @returns {Promise<Realm~FileRemovalReport>} a promise which is resolved
+     *   once every file has been removed, or has failed to be.
+     * @since 3.7.0
+     */
+    static deleteFiles(configs) { }
+
+    /**
+     * Delete the files of every Realm in many directories, off the JS thread,
+     * and then each directory which is left empty. The files of a Realm which
+     * is still open are left alone, and so is the directory holding them.
+     * @param {string[]} paths - The paths of the directories.
+     * @throws {Error} If any of the `paths` is invalid.
+     * @returns {Promise<Realm~FileRemovalReport>} a promise which is resolved
+     *   once every file has been removed, or has failed to be.
+     * @since 3.7.0
+     */
+    static deleteDirectories(paths) { }
+
     /**
      * Checks if the Realm already exists on disk.
      * @param {Realm~Configuration} config The configuration for the Realm.
@@ -378,6 +644,28 @@ class Realm {
      */
     static exists(config) { }
 
+    /**
+     * Resolve a reference created by {@link Realm#createThreadSafeReference createThreadSafeReference()}
+     * on this thread. The Realm is opened with the configuration it was opened with on the
+     * original thread, without its migration function and object constructors.
+     * @param {Realm~ThreadSafeReference} reference - The reference to resolve.
+     * @throws {Error} If the reference has already been resolved.
+     * @returns {Realm|Realm.Object|Realm.Results|Realm.List} what the reference refers to.
+     * @since 3.7.0
+     */
+    static resolveThreadSafeReference(reference) { }
+
+    /**
+     * Resolve a frozen handle by its id on this thread, as long as a handle to it is still alive.
+     * The handle which is returned reads the same version, and keeps it alive too.
+     * @param {number} id - The {@link Realm.FrozenRealm#id id} of a {@link Realm.FrozenRealm}
+     *   or {@link Realm.FrozenResults}.
+     * @throws {Error} If every handle with this id has been released.
+     * @returns {Realm.FrozenRealm|Realm.FrozenResults}
+     * @since 3.7.0
+     */
+    static resolveFrozen(id) { }
+
     /**
      * Copy all bundled Realm files to app's default file folder.
      * This is only implemented for React Native.
@@ -394,6 +682,20 @@ class Realm {
      */
     subscriptions(name) { }
 
+    /**
+     * Subscribe to several queries at once. The subscriptions are written in a single write
+     * transaction, so they reach the server together rather than one at a time.
+     * THIS METHOD IS IN BETA AND MAY CHANGE IN FUTURE VERSIONS.
+     * @param {Array<{results: Realm.Results, options: (string|Realm.Sync.SubscriptionOptions)}>} subscriptions -
+     *   The results to subscribe to, each with the name or the options that would be given to
+     *   {@link Realm.Results#subscribe subscribe()}.
+     * @throws {Error} If this isn't a query-based Realm, or any of the results or options are invalid.
+     *   No subscription is created then.
+     * @returns {Realm.Sync.SubscriptionGroup} the combined state of the subscriptions.
+     * @since 3.7.0
+     */
+    subscribeAll(subscriptions) { }
+
     /**
      * Unsubscribe a named subscription. THIS METHOD IS IN BETA AND MAY CHANGE IN FUTURE VERSIONS.
      * @param {string} name - The name of the subscription.
@@ -407,12 +709,14 @@ class Realm {
  * @type {Object}
  * @property {ArrayBuffer|ArrayBufferView} [encryptionKey] - The 512-bit (64-byte) encryption
  *   key used to encrypt and decrypt all data in the Realm.
- * @property {callback(Realm, Realm)} [migration] - The function to run if a migration is needed.
+ * @property {callback(Realm, Realm, Realm.Migration)} [migration] - The function to run if a migration is needed.
  *   This function should provide all the logic for converting data models from previous schemas
  *   to the new schema.
- *   This function takes two arguments:
+ *   This function takes three arguments:
  *   - `oldRealm` - The Realm before migration is performed.
  *   - `newRealm` - The Realm that uses the latest `schema`, which should be modified as necessary.
+ *   - `migration` - The {@link Realm.Migration} operations, which change every object of a type
+ *     at once.
  * @property {boolean} [deleteRealmIfMigrationNeeded=false] - Specifies if this Realm should be deleted
  *   if a migration is needed.
  * @property {callback(number, number)} [shouldCompactOnLaunch] - The function called when opening
@@ -430,11 +734,16 @@ class Realm {
  * In that case Realm needs a different location to store these files and this property defines that location.
  * The FIFO special files are very lightweight and the main Realm file will still be stored in the location defined
  * by the `path` property. This property is ignored if the directory defined by `path` allow FIFO special files.
- * @property {boolean} [inMemory=false] - Specifies if this Realm should be opened in-memory. This
+ * @property {boolean|Object} [inMemory=false] - Specifies if this Realm should be opened in-memory. This
  *    still requires a path (can be the default path) to identify the Realm so other processes can
  *    open the same Realm. The file will also be used as swap space if the Realm becomes bigger than
  *    what fits in memory, but it is not persistent and will be removed when the last instance
  *    is closed.
+ *    An object `{persistTo, intervalMs}` opens the Realm in-memory and writes snapshots of it to the
+ *    file at `persistTo` from a background thread, every `intervalMs` milliseconds (5000 by default)
+ *    if it changed and when it is closed. A Realm opened while it is not already open starts from
+ *    the latest snapshot. A snapshot which fails is tried again at the next interval, and its
+ *    error is reported by {@link Realm#memoryStats memoryStats()}. Since 3.7.0.
  * @property {boolean} [readOnly=false] - Specifies if this Realm should be opened as read-only.
  * @property {boolean} [disableFormatUpgrade=false] - Specifies if this Realm's file format should
  *    be automatically upgraded if it was created with an older version of the Realm library.
@@ -447,6 +756,15 @@ class Realm {
  * @property {Realm.Sync~SyncConfiguration} [sync] - Sync configuration parameters.
  */
 
+/**
+ * A reference to a Realm, or to an object or collection in it, which can be passed to another thread.
+ * @typedef Realm~ThreadSafeReference
+ * @type {Object}
+ * @property {number} id - Identifies the reference within the process.
+ * @property {string} type - One of `"Realm"`, `"Object"`, `"Results"` or `"List"`.
+ * @property {string} path - The path of the Realm.
+ */
+
 /**
  * Realm objects will inherit methods, getters, and setters from the `prototype` of this
  * constructor. It is **highly recommended** that this constructor inherit from
@@ -505,6 +823,17 @@ class Realm {
  *   name. Queries can be done using both the public and the underlying property name.
  */
 
+/**
+ * What deleting the files of many Realms did.
+ * @typedef Realm~FileRemovalReport
+ * @type {Object}
+ * @property {string[]} removed - The paths of the files and directories which were removed.
+ * @property {string[]} skipped - The paths of the Realms which were left alone because they are still open.
+ * @property {Array<{path: string, message: string}>} failed - The paths which couldn't be removed,
+ *   with the reason why.
+ * @since 3.7.0
+ */
+
 /**
  * The type of an object may either be specified as a string equal to the `name` in a
  * {@link Realm~ObjectSchema ObjectSchema} definition, **or** a constructor that was specified
@@ -30,10 +30,40 @@
 class Results extends Collection {
     /**
      * Bulk update objects in the collection.
-     * @param {string} property - The name of the property.
-     * @param {string} value - The updated property value.
+     *
+     * Either a single property is updated by passing its name and value, or several properties are updated in one
+     * pass by passing an object mapping property names to values. Each value is converted once and written to all
+     * objects, so an object value for a link property creates or updates a single object which all objects then
+     * link to.
+     * @param {string|Object} property - The name of the property, or an object with the values of each property
+     *   to update.
+     * @param {any} [value] - The updated property value, when a property name is given.
      * @throws {Error} If no property with the name exists.
      * @since 2.0.0-rc20
      */
     update(property, value) { }
+
+    /**
+     * Describes how the query behind these results is run, without running it.
+     * @returns {Object} with `objectType`, `query`, the query as the core compiled it with its
+     *   arguments filled in, `ordering`, the sort, distinct and limit clauses applied after it, and
+     *   `conditions`, an array with an entry for each comparison in the query. Each entry has the
+     *   `keyPath` it compares, whether the property is `indexed`, and whether the comparison
+     *   `usesIndex` rather than examining every object. Only case-sensitive equality on an indexed
+     *   property of the objects themselves uses the index.
+     * @since 3.7.0
+     */
+    explain() { }
+
+    /**
+     * Runs the query behind these results and reports how long each step took, along with what
+     * {@link Realm.Results#explain explain()} reports.
+     * @returns {Object} with the properties of `explain()`, and `parseMillis`, the time taken to
+     *   parse and build the query again, `evaluateMillis`, the time taken to find the matching
+     *   objects, `orderMillis`, the time taken to sort, make distinct and limit them, and
+     *   `rowsExamined`, `rowsMatched` and `rowsReturned`, the number of objects of the type, of
+     *   those which matched the query, and of those which were left after the ordering.
+     * @since 3.7.0
+     */
+    profile() { }
 }
@@ -0,0 +1,42 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2020 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A cursor returned by {@link Realm.Collection#cursor cursor()}, which reads the objects of a
+ * collection one page at a time.
+ * @memberof Realm
+ * @since 3.7.0
+ */
+class ResultsCursor {
+
+    /**
+     * Whether the last page has been read. This is `true` after {@link Realm.ResultsCursor#next next()}
+     * returns fewer objects than the page size.
+     * @type {boolean}
+     * @readonly
+     */
+    get done() { }
+
+    /**
+     * Reads the next page, and moves the cursor past it.
+     * @returns {Realm.Object[]} the objects of the page, in order. The array is empty once the
+     *   cursor is done.
+     */
+    next() { }
+
+}
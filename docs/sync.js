@@ -60,6 +60,39 @@
  *    file to complete and then open. If not set, the Realm will be downloaded before opened.
  */
 
+/**
+ * @typedef {Object} Realm.Sync~SyncStats
+ * @property {boolean} multiplexing - whether session multiplexing is enabled.
+ * @property {Realm.Sync~ConnectionStats[]} connections - the connections the sessions are using.
+ * @property {Realm.Sync~SessionStats[]} sessions - the open sessions.
+ */
+
+/**
+ * @typedef {Object} Realm.Sync~ConnectionStats
+ * @property {string} serverUrl - the server the connection is to.
+ * @property {string} multiplexIdentifier - the sync label the sessions share the connection by.
+ * @property {string} state - `"connected"` if any of its sessions is connected, and otherwise `"connecting"` or `"disconnected"`.
+ * @property {number} sessions - the number of sessions on the connection.
+ * @property {number} uploadedBytes - the sum of the bytes uploaded by its sessions.
+ * @property {number} uploadableBytes - the sum of the bytes its sessions have to upload.
+ * @property {number} downloadedBytes - the sum of the bytes downloaded by its sessions.
+ * @property {number} downloadableBytes - the sum of the bytes its sessions have to download.
+ * @property {number} reconnects - the most times any of its sessions has reconnected.
+ */
+
+/**
+ * @typedef {Object} Realm.Sync~SessionStats
+ * @property {string} path - the path of the Realm file.
+ * @property {string} state - `"active"` or `"inactive"`.
+ * @property {string} connectionState - `"connected"`, `"connecting"` or `"disconnected"`.
+ * @property {number} connection - the index of the session's connection in `connections`.
+ * @property {number} uploadedBytes
+ * @property {number} uploadableBytes
+ * @property {number} downloadedBytes
+ * @property {number} downloadableBytes
+ * @property {number} reconnects - the number of times the session has reconnected.
+ */
+
 /**
  * This describes the client resync modes.
  * @typedef {("recover"|"discard"|"manual")} Realm.Sync~ClientResyncMode
@@ -79,6 +112,10 @@
  * @property {string} certificatePath - A path where to find trusted SSL certificates.
  * @property {Realm.Sync~sslValidateCallback} validateCallback - A callback function used to
  * accept or reject the server's SSL certificate.
+ * @property {number} [validateCallbackCacheMs] - If set, the answers of `validateCallback` are remembered for this
+ * many milliseconds, for every session using the same callback function. A certificate which is presented again by
+ * the same server at the same depth in the chain is then answered without calling the callback, e.g. when many
+ * sessions reconnect at once. Since 3.7.0.
  */
 
 /**
@@ -117,6 +154,21 @@
  * @property {SyncUser} adminUser - an admin user obtained by calling {@linkcode Realm.Sync.User.login|User.login} with admin credentials.
  * @property {string} filterRegex - A regular expression used to determine which changed Realms should trigger events. Use `.*` to match all Realms.
  * @property {Realm.Sync.SSLConfiguration} sslConfiguration - SSL configuration used by the Realms being observed.
+ * @property {string[]} [classNames] - Only call the listener for changes to objects of these classes. Notifications
+ * which change none of the classes of any listener are discarded before they reach JavaScript.
+ * @property {Realm.Sync~RealmPathFilter|RegExp} [filter] - A filter evaluated natively for each Realm the server reports,
+ * before `filterRegex` is tested in JavaScript. Realms it rejects are not reported to this listener, while other
+ * listeners are still called according to their own filters.
+ */
+
+/**
+ * A declarative filter of Realm paths, evaluated natively. A path is accepted if it matches any of the criteria.
+ * @typedef {Object} Realm.Sync~RealmPathFilter
+ * @property {string|RegExp} [regex] - A regular expression which must match part of the path.
+ * @property {string|string[]} [prefixes] - Paths starting with any of these are accepted.
+ * @property {string|string[]} [glob] - Glob patterns, where `*` and `?` match within one path component and `**`
+ * matches across components, such as `'/~/**'`.
+ * @since 3.7.0
  */
 
 /**
@@ -236,6 +288,18 @@ class Sync {
      */
     static reconnect() { }
 
+    /**
+     * Get counters for the sync sessions of the process, grouped by the connection they share. The counters
+     * are kept up to date natively, so this is cheap enough to call periodically.
+     *
+     * The byte counts are those reported by the sync client. Reconnects are counted from the first time a
+     * session is included in the statistics. When session multiplexing is enabled, sessions for the same
+     * server and sync label share a connection, and otherwise each session has its own.
+     * @returns {Realm.Sync~SyncStats}
+     * @since 3.7.0
+     */
+    static getStats() { }
+
     /**
      * Remove a previously registered sync listener.
      *
@@ -275,10 +339,33 @@ class Sync {
      */
 
     /**
-     * Capture the sync client's log.
-     * @param {Realm.Sync~logCallback} logger - The log callback.
+     * A callback passed to `Realm.Sync.setLogger` with the `batch` option, receiving the log entries
+     * queued since the previous call.
+     * @callback Realm.Sync~logBatchCallback
+     * @param {number[]} levels The levels of the log entries, as for {@link Realm.Sync~logCallback}.
+     * @param {string[]} messages The messages of the log entries.
+     * @param {number} dropped The number of entries dropped since the previous call because more than
+     * `bufferSize` were waiting to be delivered.
      */
-    static setLogger(logger) { }
+
+    /**
+     * Capture the sync client's log.
+     *
+     * Log entries are queued by the sync client's thread and delivered on the event loop. At the `debug` and
+     * `trace` levels, the options can be used to limit the cost of delivering them.
+     * @param {Realm.Sync~logCallback|Realm.Sync~logBatchCallback} logger - The log callback.
+     * @param {Object} [options]
+     * @param {boolean} [options.batch=false] - Call `logger` once per turn of the event loop with all entries
+     * queued since the previous call, as a {@link Realm.Sync~logBatchCallback}.
+     * @param {number} [options.bufferSize] - The number of entries to keep while waiting for the event loop.
+     * Once reached, the oldest entries are dropped. Without `batch`, a `warn` entry reports how many were dropped.
+     * By default the buffer is unbounded.
+     * @param {string|string[]} [options.filter] - Only entries whose message contains this substring, or one
+     * of these substrings, are queued, such as `'Connection[1]'`. They are searched for on the sync client's thread.
+     * @param {boolean} [options.ignoreCase=false] - Whether `filter` ignores the case of ASCII letters.
+     * @since 3.7.0
+     */
+    static setLogger(logger, options) { }
 
     /**
      * Set the application part of the User-Agent string that will be sent to the Realm Object Server when a session
@@ -403,6 +490,17 @@ class ChangeEvent {
      * @type {object}
      */
     get changes() { }
+
+    /**
+     * Serialize the event, so that it can be handled in another process.
+     * @param {Object} [options]
+     * @param {boolean} [options.binary=false] - serialize to a compact binary form, returned as an `ArrayBuffer`.
+     * @param {boolean} [options.includeChanges=false] - include the `changes` of the event in the binary form,
+     *  so that they aren't computed again when it is deserialized.
+     * @returns {string|ArrayBuffer}
+     * @since 3.7.0
+     */
+    serialize(options) { }
 }
 
 /**
@@ -685,6 +783,27 @@ class User {
      */
     logout() { }
 
+    /**
+     * Register a progress notification callback for all of the user's sessions which are open, which is called with
+     * the sum of their progress. It takes the same arguments as {@link Realm.Sync.Session#addProgressNotification},
+     * and sessions opened later aren't included.
+     * @param {string} direction - `download` or `upload`.
+     * @param {string} mode - `reportIndefinitely` or `forCurrentlyOutstandingWork`.
+     * @param {callback(transferred, transferable)} callback - called with the bytes transferred and transferable
+     *   by all of the sessions.
+     * @param {Realm.Sync~ProgressNotificationOptions} [options] - Limits on how often the callback is called.
+     * @since 3.7.0
+     */
+    addProgressNotification(direction, mode, progressCallback, options) { }
+
+    /**
+     * Unregister a progress notification callback that was previously registered with
+     * {@link Realm.Sync.User#addProgressNotification}.
+     * @param {callback(transferred, transferable)} callback - a previously registered progress callback
+     * @since 3.7.0
+     */
+    removeProgressNotification(progressCallback) { }
+
     /**
      * Get account information for a user. (requires administrator privilidges)
      * @param {string} provider - the provider to query for user account information (ex. 'password')
@@ -786,6 +905,16 @@ class User {
     static authenticate(server, provider, options) { }
 }
 
+/**
+ * Limits on how often a progress notification callback is called. Progress which completes the outstanding work is
+ * always reported.
+ * @typedef {Object} Realm.Sync~ProgressNotificationOptions
+ * @property {number} [minIntervalMs=0] - The least number of milliseconds between two callbacks.
+ * @property {number} [minDeltaBytes=0] - The least number of bytes by which the transferred or transferable bytes
+ *   have to change between two callbacks.
+ * @since 3.7.0
+ */
+
 /**
  * An object encapsulating a Realm Object Server session. Sessions represent the communication between the
  * client (and a local Realm file on disk), and the server (and a remote Realm at a given URL stored on a Realm Object Server).
@@ -836,8 +965,10 @@ class Session {
      * @param {callback(transferred, transferable)} callback - called with the following arguments:
      *   - `transferred` - the current number of bytes already transferred
      *   - `transferable` - the total number of transferable bytes (the number of bytes already transferred plus the number of bytes pending transfer)
+     * @param {Realm.Sync~ProgressNotificationOptions} [options] - Limits on how often the callback is called. When
+     *   given, progress reported while a callback is pending is combined into it, so the callback gets the latest values.
      */
-    addProgressNotification(direction, mode, progressCallback) { }
+    addProgressNotification(direction, mode, progressCallback, options) { }
 
     /** Unregister a progress notification callback that was previously registered with addProgressNotification.
      * Calling the function multiple times with the same callback is ignored.
@@ -1063,6 +1194,65 @@ class Subscription {
     removeAllListeners() { }
 }
 
+/**
+ * The subscriptions created together by {@link Realm#subscribeAll Realm.subscribeAll()}.
+ *
+ * @memberof Realm.Sync
+ * @since 3.7.0
+ */
+class SubscriptionGroup {
+    /**
+     * The subscriptions, in the order they were given in.
+     * @type {Realm.Sync.Subscription[]}
+     */
+    get subscriptions() { }
+
+    /**
+     * Gets the combined state of the subscriptions. It is `Realm.Sync.SubscriptionState.Error` or
+     * `Realm.Sync.SubscriptionState.Invalidated` if that is the state of any of them, and otherwise the
+     * least advanced of their states, so `Realm.Sync.SubscriptionState.Complete` only once all of them are.
+     * @type {number}
+     */
+    get state() { }
+
+    /**
+     * Returns the error message of the first subscription which failed, or `undefined` if none has.
+     * @type {string}
+     */
+    get error() { }
+
+    /**
+     * Unsubscribe all of the subscriptions.
+     */
+    unsubscribe() { }
+
+    /**
+     * Adds a listener `callback` which will be called when the combined state of the subscriptions changes.
+     * @param {function(group, state)} callback - A function to be called when the combined state changes.
+     * @throws {Error} If `callback` is not a function.
+     */
+    addListener(callback) { }
+
+    /**
+     * Remove the listener `callback` from the group.
+     * @param {function(group, state)} callback - Callback function that was previously
+     *   added as a listener through the {@link Realm.Sync.SubscriptionGroup#addListener addListener} method.
+     */
+    removeListener(callback) { }
+
+    /**
+     * Remove all listeners from the group.
+     */
+    removeAllListeners() { }
+
+    /**
+     * Waits for all of the subscriptions to be complete.
+     * @returns {Promise<Realm.Sync.SubscriptionGroup>} which resolves with the group once every subscription
+     *   is complete, and rejects if any of them fails or is removed first.
+     */
+    waitForCompletion() { }
+}
+
 /**
  * A Realm Worker can be used to process Sync events in multiple automatically-managed child processes.
  *
@@ -1134,8 +1324,10 @@ class Adapter {
 	 * @param {string} localPath - the local path where realm files are stored
 	 * @param {string} serverUrl - the sync server to listen to
 	 * @param {SyncUser} adminUser - an admin user obtained by calling {@linkcode Realm.Sync.User.login|User.login} with admin credentials.
-	 * @param {(string|Realm.Sync.Adapter~RealmWatchPredicate)} filter - a filter used to determine which changed Realms should be monitored -
-	 *  can be a regular expression string or a predicate function. Use `'.*'` to match all Realms.
+	 * @param {(string|RegExp|Realm.Sync~RealmPathFilter|Realm.Sync.Adapter~RealmWatchPredicate)} filter - a filter used to determine which changed Realms should be monitored -
+	 *  can be a regular expression string which must match the whole path, a `RegExp`, a declarative filter or a predicate function.
+	 *  Use `'.*'` to match all Realms. Declarative filters are evaluated on the sync thread, and may have a `predicate`
+	 *  function which is only called for paths they don't accept. The result is remembered for each path.
 	 * @param {Realm.Sync.Adapter~RealmChangeCallback} changeCallback - called when a new transaction is available
 	 *  to process for the given realm_path
      * @param {Realm.Sync~SSLConfiguration} [ssl] - SSL configuration for the spawned sync sessions.
@@ -1198,16 +1390,38 @@ class Adapter {
      * - `identity` - old row value for the object
      * - `new_identity` - new row value for the object
      *
-	 * @returns {Array(instructions)} or {undefined} if all transactions have been processed
+	 * @param {Object} [options]
+	 * @param {boolean} [options.raw=false] - return the changeset as it is encoded by the adapter, i.e. the
+	 *  instructions as UTF-8 encoded JSON, instead of converting it to objects.
+	 * @returns {Array(instructions)|ArrayBuffer} or {undefined} if all transactions have been processed
+	 */
+    current(path, options) { }
+
+	/**
+	 * Iterate over the current instructions for the given Realm in chunks. Each chunk is only converted
+	 * to objects when the iterator gets to it, so the instructions of a large transaction don't all have
+	 * to be in memory as objects at once. The iterator keeps its own copy of the transaction, and isn't
+	 * affected by calling `advance`.
+	 * @param {string} path - the path for the Realm being monitored
+	 * @param {number} chunkSize - the largest number of instructions in a chunk
+	 * @returns {Iterator<Array(instructions)>} which yields nothing if all transactions have been processed
+	 * @example
+	 * for (const instructions of adapter.currentChunks(path, 1000)) {
+	 *     await writeToDatabase(instructions);
+	 * }
+	 * adapter.advance(path);
+	 * @since 3.7.0
 	 */
-    current(path) { }
+    currentChunks(path, chunkSize) { }
 
 	/**
 	 * Advance the to the next transaction indicating that you are done processing the current
 	 * instructions for the given Realm.
 	 * @param {string} path - the path for the Realm to advance
+	 * @param {number} [count=1] - the number of transactions to advance by. Advancing stops after the
+	 *  last transaction which is available.
 	 */
-    advance(path) { }
+    advance(path, count) { }
 
 	/**
 	 * Open the Realm used by the Adapter for the given path. This is useful for writing two way
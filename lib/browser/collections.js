@@ -34,10 +34,24 @@ function isIndex(propertyName) {
 
 const mutable = Symbol('mutable');
 
+// Fetches the window of elements starting at an index which hasn't been
+// fetched yet, so that iterating doesn't need a request per element.
+function getIndex(collection, index) {
+    let window = rpc.getPrefetchWindow();
+    let realmId = collection[keys.realm];
+    if (window > 0 && realmId !== undefined && index >= 0 && !util.isCached(collection, index)) {
+        let range = rpc.getRange(realmId, collection[keys.id], Number(index), window);
+        if (range) {
+            util.cacheProperties(realmId, collection[keys.id], range);
+        }
+    }
+    return util.getProperty(collection, index);
+}
+
 const traps = {
     get(collection, property, receiver) {
         if (isIndex(property)) {
-            return util.getProperty(collection, property);
+            return getIndex(collection, property);
         }
 
         return Reflect.get(collection, property, collection);
@@ -103,5 +117,9 @@ export function createCollection(prototype, realmId, info, _mutable) {
     collection[keys.type] = info.type;
     collection[mutable] = _mutable;
 
+    if (info.prefetch) {
+        util.cacheProperties(realmId, info.id, rpc.deserializeRange(realmId, info.prefetch));
+    }
+
     return new Proxy(collection, traps);
 }
@@ -43,6 +43,7 @@ export const propTypes = {};
     'SESSION',
     'SUBSCRIPTION',
     'ASYNCOPENTASK',
+    'BATCHRESULT',
     'UNDEFINED',
 ].forEach(function(type) {
     Object.defineProperty(objectTypes, type, {
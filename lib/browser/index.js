@@ -127,6 +127,16 @@ export default class Realm {
         return method.apply(this, [getObjectType(this, type), ...args]);
     }
 
+    createMany(type, ...args) {
+        let method = util.createMethod(objectTypes.REALM, 'createMany', true);
+        return method.apply(this, [getObjectType(this, type), ...args]);
+    }
+
+    deleteByPrimaryKeys(type, ...args) {
+        let method = util.createMethod(objectTypes.REALM, 'deleteByPrimaryKeys', true);
+        return method.apply(this, [getObjectType(this, type), ...args]);
+    }
+
     objects(type, ...args) {
         let method = util.createMethod(objectTypes.REALM, 'objects');
         return method.apply(this, [getObjectType(this, type), ...args]);
@@ -136,6 +146,16 @@ export default class Realm {
         let method = util.createMethod(objectTypes.REALM, 'objectForPrimaryKey');
         return method.apply(this, [getObjectType(this, type), ...args]);
     }
+
+    objectsForPrimaryKeys(type, ...args) {
+        let method = util.createMethod(objectTypes.REALM, 'objectsForPrimaryKeys');
+        return method.apply(this, [getObjectType(this, type), ...args]);
+    }
+
+    _setLinks(type, ...args) {
+        let method = util.createMethod(objectTypes.REALM, '_setLinks', true);
+        return method.apply(this, [getObjectType(this, type), ...args]);
+    }
 }
 
 // Non-mutating methods:
@@ -143,10 +163,15 @@ util.createMethods(Realm.prototype, objectTypes.REALM, [
     'addListener',
     'removeListener',
     'removeAllListeners',
+    '_setListenerDispatchHook',
     'privileges',
     'writeCopyTo',
     '_waitForDownload',
     '_objectForObjectId',
+    '_objectsForObjectIds',
+    '_subscribeAll',
+    'memoryStats',
+    'setPinnedVersionsWarning',
 ]);
 
 // Mutating methods:
@@ -156,15 +181,19 @@ util.createMethods(Realm.prototype, objectTypes.REALM, [
     'deleteAll',
     'write',
     'compact',
+    '_compactAsync',
+    'fileStats',
     'close',
     'beginTransaction',
     'commitTransaction',
     'cancelTransaction',
 ], true);
 
+let syncSetUp = false;
 const Sync = {
     '_hasExistingSessions': () => rpc.callSyncFunction('_hasExistingSessions'),
     '_initializeSyncManager': (userAgent) => rpc.callSyncFunction('_initializeSyncManager', [userAgent]),
+    'getStats': () => rpc.callSyncFunction('getStats'),
     'reconnect': () => rpc.callSyncFunction('reconnect'),
     'setLogLevel': (logLevel) => rpc.callSyncFunction('setLogLevel', [logLevel]),
     'setUserAgent': (userAgent) => rpc.callSyncFunction('setUserAgent', [userAgent]),
@@ -186,8 +215,15 @@ Object.defineProperties(Realm, {
     Object: {
         value: RealmObject,
     },
+    // Set up by the library the first time it is read, as Realm.Sync is.
     Sync: {
-        value: Sync,
+        get: function() {
+            if (!syncSetUp && Realm._setupSync) {
+                syncSetUp = true;
+                Realm._setupSync(Sync);
+            }
+            return Sync;
+        },
     },
     defaultPath: {
         get: util.getterForProperty('defaultPath', false),
@@ -225,6 +261,47 @@ Object.defineProperties(Realm, {
             return rpc.callMethod(undefined, Realm[keys.id], 'exists', Array.from(arguments));
         }
     },
+    startTracing: {
+        value: function(options) {
+            return rpc.callMethod(undefined, Realm[keys.id], 'startTracing', Array.from(arguments));
+        }
+    },
+    stopTracing: {
+        value: function() {
+            return rpc.callMethod(undefined, Realm[keys.id], 'stopTracing', Array.from(arguments));
+        }
+    },
+    _reuseOpenStats: {
+        value: function(reset) {
+            return rpc.callMethod(undefined, Realm[keys.id], '_reuseOpenStats', Array.from(arguments));
+        }
+    },
+    _boundaryStats: {
+        value: function(reset) {
+            return rpc.callMethod(undefined, Realm[keys.id], '_boundaryStats', Array.from(arguments));
+        }
+    },
+    _enableBoundaryStats: {
+        value: function(enabled) {
+            return rpc.callMethod(undefined, Realm[keys.id], '_enableBoundaryStats', Array.from(arguments));
+        }
+    },
+    _startupStats: {
+        value: function() {
+            return rpc.callMethod(undefined, Realm[keys.id], '_startupStats', []);
+        }
+    },
+    _setPrefetchOptions: {
+        value: function(options) {
+            util.invalidateCache();
+            rpc.setPrefetchOptions(options);
+        }
+    },
+    _rpcStats: {
+        value: function(options) {
+            return rpc.getStats(options);
+        }
+    },
 });
 
 for (let i = 0, len = debugHosts.length; i < len; i++) {
@@ -29,10 +29,16 @@ export default class List extends Collection {
 createMethods(List.prototype, objectTypes.LIST, [
     'filtered',
     'sorted',
+    'limit',
+    'linkingObjects',
+    'linkingObjectsCounts',
     'snapshot',
     'isValid',
     'isEmpty',
     'indexOf',
+    'slice',
+    'toTypedArray',
+    'toPlain',
     'min',
     'max',
     'sum',
@@ -49,6 +55,8 @@ createMethods(List.prototype, objectTypes.LIST, [
     'push',
     'unshift',
     'splice',
+    'assign',
+    'setFromTypedArray',
 ], true);
 
 export function createList(realmId, info) {
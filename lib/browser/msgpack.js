@@ -0,0 +1,401 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2020 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+'use strict';
+
+// MessagePack encoding of RPC messages, matching src/rpc_msgpack.hpp.
+// ArrayBuffers and typed arrays are sent as bins and decoded as Uint8Arrays,
+// and Dates are sent as timestamp extensions. Properties whose value is
+// undefined are left out, as they are by JSON.stringify().
+
+function utf8Encode(string) {
+    const bytes = [];
+    for (let i = 0; i < string.length; i++) {
+        let code = string.charCodeAt(i);
+        if (code >= 0xd800 && code < 0xdc00 && i + 1 < string.length) {
+            const low = string.charCodeAt(i + 1);
+            if (low >= 0xdc00 && low < 0xe000) {
+                code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+                i++;
+            }
+        }
+        if (code < 0x80) {
+            bytes.push(code);
+        } else if (code < 0x800) {
+            bytes.push(0xc0 | (code >> 6), 0x80 | (code & 0x3f));
+        } else if (code < 0x10000) {
+            bytes.push(0xe0 | (code >> 12), 0x80 | ((code >> 6) & 0x3f), 0x80 | (code & 0x3f));
+        } else {
+            bytes.push(0xf0 | (code >> 18), 0x80 | ((code >> 12) & 0x3f), 0x80 | ((code >> 6) & 0x3f), 0x80 | (code & 0x3f));
+        }
+    }
+    return bytes;
+}
+
+function utf8Decode(bytes, start, end) {
+    let string = '';
+    let i = start;
+    while (i < end) {
+        const byte = bytes[i++];
+        let code;
+        if (byte < 0x80) {
+            code = byte;
+        } else if (byte < 0xe0) {
+            code = ((byte & 0x1f) << 6) | (bytes[i++] & 0x3f);
+        } else if (byte < 0xf0) {
+            code = ((byte & 0x0f) << 12) | ((bytes[i++] & 0x3f) << 6) | (bytes[i++] & 0x3f);
+        } else {
+            code = ((byte & 0x07) << 18) | ((bytes[i++] & 0x3f) << 12) | ((bytes[i++] & 0x3f) << 6) | (bytes[i++] & 0x3f);
+        }
+        string += String.fromCodePoint(code);
+    }
+    return string;
+}
+
+class Writer {
+    constructor() {
+        this.bytes = new Uint8Array(256);
+        this.view = new DataView(this.bytes.buffer);
+        this.length = 0;
+    }
+
+    reserve(size) {
+        if (this.length + size <= this.bytes.length) {
+            return;
+        }
+        let capacity = this.bytes.length * 2;
+        while (capacity < this.length + size) {
+            capacity *= 2;
+        }
+        const bytes = new Uint8Array(capacity);
+        bytes.set(this.bytes.subarray(0, this.length));
+        this.bytes = bytes;
+        this.view = new DataView(bytes.buffer);
+    }
+
+    byte(value) {
+        this.reserve(1);
+        this.bytes[this.length++] = value;
+    }
+
+    uint(value, size) {
+        this.reserve(size);
+        if (size === 1) {
+            this.view.setUint8(this.length, value);
+        } else if (size === 2) {
+            this.view.setUint16(this.length, value);
+        } else if (size === 4) {
+            this.view.setUint32(this.length, value);
+        } else {
+            this.view.setUint32(this.length, Math.floor(value / 0x100000000));
+            this.view.setUint32(this.length + 4, value >>> 0);
+        }
+        this.length += size;
+    }
+
+    raw(bytes) {
+        this.reserve(bytes.length);
+        this.bytes.set(bytes, this.length);
+        this.length += bytes.length;
+    }
+
+    header(size, fixTag, fixLimit, tag16) {
+        if (size < fixLimit) {
+            this.byte(fixTag | size);
+        } else if (size <= 0xffff) {
+            this.byte(tag16);
+            this.uint(size, 2);
+        } else {
+            this.byte(tag16 + 1);
+            this.uint(size, 4);
+        }
+    }
+
+    number(value) {
+        if (Number.isInteger(value) && Math.abs(value) <= Number.MAX_SAFE_INTEGER) {
+            if (value >= 0) {
+                if (value < 0x80) {
+                    this.byte(value);
+                } else if (value <= 0xff) {
+                    this.byte(0xcc);
+                    this.uint(value, 1);
+                } else if (value <= 0xffff) {
+                    this.byte(0xcd);
+                    this.uint(value, 2);
+                } else if (value <= 0xffffffff) {
+                    this.byte(0xce);
+                    this.uint(value, 4);
+                } else {
+                    this.byte(0xcf);
+                    this.uint(value, 8);
+                }
+                return;
+            }
+            if (value >= -32) {
+                this.byte(value & 0xff);
+                return;
+            }
+            if (value >= -0x80000000) {
+                this.byte(0xd2);
+                this.reserve(4);
+                this.view.setInt32(this.length, value);
+                this.length += 4;
+                return;
+            }
+        }
+        this.byte(0xcb);
+        this.reserve(8);
+        this.view.setFloat64(this.length, value);
+        this.length += 8;
+    }
+
+    string(value) {
+        const bytes = utf8Encode(value);
+        const size = bytes.length;
+        if (size < 32) {
+            this.byte(0xa0 | size);
+        } else if (size <= 0xff) {
+            this.byte(0xd9);
+            this.uint(size, 1);
+        } else if (size <= 0xffff) {
+            this.byte(0xda);
+            this.uint(size, 2);
+        } else {
+            this.byte(0xdb);
+            this.uint(size, 4);
+        }
+        this.raw(bytes);
+    }
+
+    binary(bytes) {
+        const size = bytes.length;
+        if (size <= 0xff) {
+            this.byte(0xc4);
+            this.uint(size, 1);
+        } else if (size <= 0xffff) {
+            this.byte(0xc5);
+            this.uint(size, 2);
+        } else {
+            this.byte(0xc6);
+            this.uint(size, 4);
+        }
+        this.raw(bytes);
+    }
+
+    date(date) {
+        const milliseconds = date.getTime();
+        const seconds = Math.floor(milliseconds / 1000);
+        // timestamp 96
+        this.byte(0xc7);
+        this.byte(12);
+        this.byte(0xff);
+        this.uint(Math.round((milliseconds - seconds * 1000) * 1000000), 4);
+        this.reserve(8);
+        this.view.setInt32(this.length, Math.floor(seconds / 0x100000000));
+        this.view.setUint32(this.length + 4, seconds >>> 0);
+        this.length += 8;
+    }
+
+    value(value) {
+        if (value === null || value === undefined) {
+            this.byte(0xc0);
+        } else if (typeof value === 'boolean') {
+            this.byte(value ? 0xc3 : 0xc2);
+        } else if (typeof value === 'number') {
+            this.number(value);
+        } else if (typeof value === 'string') {
+            this.string(value);
+        } else if (value instanceof Date) {
+            this.date(value);
+        } else if (value instanceof ArrayBuffer) {
+            this.binary(new Uint8Array(value));
+        } else if (ArrayBuffer.isView(value)) {
+            this.binary(new Uint8Array(value.buffer, value.byteOffset, value.byteLength));
+        } else if (Array.isArray(value)) {
+            this.header(value.length, 0x90, 16, 0xdc);
+            for (const item of value) {
+                this.value(item);
+            }
+        } else {
+            const keys = Object.keys(value).filter((key) => value[key] !== undefined);
+            this.header(keys.length, 0x80, 16, 0xde);
+            for (const key of keys) {
+                this.string(key);
+                this.value(value[key]);
+            }
+        }
+    }
+}
+
+class Reader {
+    constructor(bytes) {
+        this.bytes = bytes;
+        this.view = new DataView(bytes.buffer, bytes.byteOffset, bytes.byteLength);
+        this.offset = 0;
+    }
+
+    uint(size) {
+        const offset = this.offset;
+        this.offset += size;
+        if (size === 1) {
+            return this.view.getUint8(offset);
+        } else if (size === 2) {
+            return this.view.getUint16(offset);
+        } else if (size === 4) {
+            return this.view.getUint32(offset);
+        }
+        return this.view.getUint32(offset) * 0x100000000 + this.view.getUint32(offset + 4);
+    }
+
+    int(size) {
+        const offset = this.offset;
+        this.offset += size;
+        if (size === 1) {
+            return this.view.getInt8(offset);
+        } else if (size === 2) {
+            return this.view.getInt16(offset);
+        } else if (size === 4) {
+            return this.view.getInt32(offset);
+        }
+        return this.view.getInt32(offset) * 0x100000000 + this.view.getUint32(offset + 4);
+    }
+
+    string(size) {
+        const start = this.offset;
+        this.offset += size;
+        return utf8Decode(this.bytes, start, this.offset);
+    }
+
+    binary(size) {
+        const start = this.offset;
+        this.offset += size;
+        return this.bytes.slice(start, this.offset);
+    }
+
+    array(size) {
+        const array = new Array(size);
+        for (let i = 0; i < size; i++) {
+            array[i] = this.value();
+        }
+        return array;
+    }
+
+    map(size) {
+        const object = {};
+        for (let i = 0; i < size; i++) {
+            const key = this.value();
+            object[key] = this.value();
+        }
+        return object;
+    }
+
+    ext(size) {
+        const type = this.int(1);
+        if (type !== -1) {
+            throw new Error(`Unsupported MessagePack extension type ${type}`);
+        }
+        if (size === 4) {
+            return new Date(this.uint(4) * 1000);
+        }
+        if (size === 8) {
+            const high = this.uint(4);
+            const low = this.uint(4);
+            const nanoseconds = high >>> 2;
+            const seconds = (high & 0x3) * 0x100000000 + low;
+            return new Date(seconds * 1000 + nanoseconds / 1000000);
+        }
+        if (size === 12) {
+            const nanoseconds = this.uint(4);
+            const seconds = this.int(8);
+            return new Date(seconds * 1000 + nanoseconds / 1000000);
+        }
+        throw new Error('Invalid MessagePack timestamp');
+    }
+
+    value() {
+        const tag = this.uint(1);
+        if (tag < 0x80) {
+            return tag;
+        }
+        if (tag >= 0xe0) {
+            return tag - 0x100;
+        }
+        if ((tag & 0xf0) === 0x80) {
+            return this.map(tag & 0x0f);
+        }
+        if ((tag & 0xf0) === 0x90) {
+            return this.array(tag & 0x0f);
+        }
+        if ((tag & 0xe0) === 0xa0) {
+            return this.string(tag & 0x1f);
+        }
+
+        switch (tag) {
+            case 0xc0: return null;
+            case 0xc2: return false;
+            case 0xc3: return true;
+            case 0xc4: return this.binary(this.uint(1));
+            case 0xc5: return this.binary(this.uint(2));
+            case 0xc6: return this.binary(this.uint(4));
+            case 0xc7: return this.ext(this.uint(1));
+            case 0xc8: return this.ext(this.uint(2));
+            case 0xc9: return this.ext(this.uint(4));
+            case 0xca: {
+                const value = this.view.getFloat32(this.offset);
+                this.offset += 4;
+                return value;
+            }
+            case 0xcb: {
+                const value = this.view.getFloat64(this.offset);
+                this.offset += 8;
+                return value;
+            }
+            case 0xcc: return this.uint(1);
+            case 0xcd: return this.uint(2);
+            case 0xce: return this.uint(4);
+            case 0xcf: return this.uint(8);
+            case 0xd0: return this.int(1);
+            case 0xd1: return this.int(2);
+            case 0xd2: return this.int(4);
+            case 0xd3: return this.int(8);
+            case 0xd4: return this.ext(1);
+            case 0xd5: return this.ext(2);
+            case 0xd6: return this.ext(4);
+            case 0xd7: return this.ext(8);
+            case 0xd8: return this.ext(16);
+            case 0xd9: return this.string(this.uint(1));
+            case 0xda: return this.string(this.uint(2));
+            case 0xdb: return this.string(this.uint(4));
+            case 0xdc: return this.array(this.uint(2));
+            case 0xdd: return this.array(this.uint(4));
+            case 0xde: return this.map(this.uint(2));
+            case 0xdf: return this.map(this.uint(4));
+        }
+        throw new Error(`Invalid MessagePack data (tag ${tag})`);
+    }
+}
+
+export function encode(value) {
+    const writer = new Writer();
+    writer.value(value);
+    return writer.bytes.subarray(0, writer.length);
+}
+
+export function decode(bytes) {
+    return new Reader(bytes).value();
+}
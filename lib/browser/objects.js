@@ -34,6 +34,7 @@ createMethods(RealmObject.prototype, objectTypes.OBJECT, [
     'objectSchema',
     'linkingObjects',
     'linkingObjectsCount',
+    'toPlain',
     '_objectId',
     '_isSameObject',
     'addListener',
@@ -30,11 +30,17 @@ createMethods(Results.prototype, objectTypes.RESULTS, [
     'description',
     'filtered',
     'sorted',
+    'limit',
+    'linkingObjects',
+    'linkingObjectsCounts',
     'snapshot',
     'subscribe',
     'isValid',
     'isEmpty',
     'indexOf',
+    'slice',
+    'toTypedArray',
+    'toPlain',
     'min',
     'max',
     'sum',
@@ -42,6 +48,7 @@ createMethods(Results.prototype, objectTypes.RESULTS, [
     'addListener',
     'removeListener',
     'removeAllListeners',
+    '_evaluateAsync',
 ]);
 
 // Mutating methods:
@@ -19,6 +19,7 @@
 'use strict';
 
 import * as base64 from './base64';
+import * as msgpack from './msgpack';
 import * as util from './util';
 import { keys, objectTypes } from './constants';
 
@@ -30,10 +31,34 @@ const typeConverters = {};
 // carry this symbol so they are not wiped in clearTestState.
 const persistentCallback = Symbol("persistentCallback");
 
+// Marks the placeholders created by batchResult(), which are sent as they are.
+const batchPlaceholder = Symbol("batchPlaceholder");
+
 let XMLHttpRequest = global.originalXMLHttpRequest || global.XMLHttpRequest;
 let sessionHost;
 let sessionId;
 
+// Set once the RPC server has agreed to exchange MessagePack instead of JSON.
+let binaryEncoding = false;
+const msgpackContentType = 'application/x-msgpack';
+
+// A persistent connection to the RPC server, over which callbacks are pushed
+// and sendRequestAsync() sends its requests, if the server has one.
+let webSocket;
+let webSocketRequests = new Map();
+let nextWebSocketRequestId = 1;
+
+// The ids of objects which have been garbage collected, which are released
+// on the server in batches. Each deserialized object has an id of its own.
+const objectRegistry = typeof FinalizationRegistry != 'undefined' ? new FinalizationRegistry(releaseObject) : null;
+const releaseBatchSize = 1000;
+let releasedIds = [];
+let releaseTimeoutId;
+
+// How many rows of a Results or List are fetched at a time, and how long a
+// string property can be to be sent along with its object.
+let prefetchOptions = { window: 20, maxStringSize: 100 };
+
 // Check if XMLHttpRequest has been overridden, and get the native one if that's the case.
 if (XMLHttpRequest.__proto__ != global.XMLHttpRequestEventTarget) {
     let fakeXMLHttpRequest = XMLHttpRequest;
@@ -42,8 +67,8 @@ if (XMLHttpRequest.__proto__ != global.XMLHttpRequestEventTarget) {
     global.XMLHttpRequest = fakeXMLHttpRequest;
 }
 
-registerTypeConverter(objectTypes.DATA, (_, { value }) => base64.decode(value));
-registerTypeConverter(objectTypes.DATE, (_, { value }) => new Date(value));
+registerTypeConverter(objectTypes.DATA, deserializeData);
+registerTypeConverter(objectTypes.DATE, (_, { value, timestamp }) => timestamp || new Date(value));
 registerTypeConverter(objectTypes.DICT, deserializeDict);
 registerTypeConverter(objectTypes.FUNCTION, deserializeFunction);
 
@@ -53,8 +78,22 @@ export function registerTypeConverter(type, handler) {
 
 export function createSession(refreshAccessToken, host) {
     refreshAccessToken[persistentCallback] = true;
-    sessionId = sendRequest('create_session', { refreshAccessToken: serialize(undefined, refreshAccessToken) }, host);
+    binaryEncoding = false;
+    const session = sendRequest('create_session', {
+        refreshAccessToken: serialize(undefined, refreshAccessToken),
+        encodings: ['msgpack'],
+        prefetch: prefetchOptions,
+    }, host);
+
+    // Older servers reply with just the session id.
+    if (session && typeof session == 'object') {
+        sessionId = session.sessionId;
+        binaryEncoding = session.encoding === 'msgpack';
+    } else {
+        sessionId = session;
+    }
     sessionHost = host;
+    connectWebSocket(host, session && session.webSocketPort);
     return sessionId;
 }
 
@@ -119,9 +158,28 @@ export function callSyncFunction(name, args) {
     return deserialize(undefined, result);
 }
 
+// Methods whose callbacks return nothing the server needs, so it can carry on
+// without waiting for the browser to run them. The beforenotify listener is
+// the exception, as it keeps the server from advancing the Realm until the
+// browser has caught up.
+const asyncCallbackMethods = new Set([
+    'addListener',
+    'removeListener',
+    'addProgressNotification',
+    'removeProgressNotification',
+    'addConnectionNotification',
+    'removeConnectionNotification',
+]);
+
 export function callMethod(realmId, id, name, args) {
     if (args) {
-        args = args.map((arg) => serialize(realmId, arg));
+        const asyncCallbacks = asyncCallbackMethods.has(name) && args[0] !== 'beforenotify';
+        args = args.map((arg) => {
+            if (asyncCallbacks && typeof arg == 'function') {
+                return { type: objectTypes.FUNCTION, value: registerCallback(arg), async: true };
+            }
+            return serialize(realmId, arg);
+        });
     }
 
     let result = sendRequest('call_method', { realmId, id, name, arguments: args });
@@ -139,6 +197,40 @@ export function getObject(realmId, id, name) {
     return result;
 }
 
+export function getPrefetchWindow() {
+    return prefetchOptions.window;
+}
+
+export function setPrefetchOptions(options) {
+    prefetchOptions = Object.assign({}, prefetchOptions, options);
+    if (sessionId) {
+        sendRequest('set_prefetch_options', { options: prefetchOptions });
+    }
+}
+
+// Returns the server's per-request counters and latency histograms. The
+// options can set the threshold in milliseconds above which requests are
+// logged as slow (0 turns the log off), and reset the stats once read.
+export function getStats(options) {
+    return sendRequest('stats', Object.assign({}, options));
+}
+
+// Returns the length of a Results or List and `count` of its elements from
+// `start`, keyed by their index.
+export function getRange(realmId, id, start, count) {
+    let result = sendRequest('get_range', { realmId, id, start, count });
+    return result && deserializeRange(realmId, result);
+}
+
+export function deserializeRange(realmId, range) {
+    let { length, start, values } = range;
+    let properties = { length };
+    for (let i = 0; i < values.length; i++) {
+        properties[start + i] = deserialize(realmId, values[i]);
+    }
+    return properties;
+}
+
 export function getProperty(realmId, id, name) {
     let result = sendRequest('get_property', { realmId, id, name });
     return deserialize(realmId, result);
@@ -149,6 +241,41 @@ export function setProperty(realmId, id, name, value) {
     sendRequest('set_property', { realmId, id, name, value });
 }
 
+// Sends several requests in one round trip and returns their results in order.
+// Each request is an object like `{ request: 'call_method', id, name, arguments }`
+// or `{ request: 'set_property', id, name, value }`, where `id`, the arguments
+// and the value can be placeholders from batchResult() for the result of an
+// earlier request in the same batch. If a request throws, the ones after it
+// are not run.
+export function sendBatch(realmId, requests) {
+    requests = requests.map((request) => {
+        let data = Object.assign({ realmId }, request);
+        if (request.arguments) {
+            data.arguments = request.arguments.map((arg) => serialize(realmId, arg));
+        }
+        if ('value' in request) {
+            data.value = serialize(realmId, request.value);
+        }
+        return data;
+    });
+
+    // Any of the requests might modify the Realm.
+    util.invalidateCache(realmId);
+    try {
+        let results = sendRequest('batch', { realmId, requests });
+        return results.map((result) => result && deserialize(realmId, result));
+    }
+    finally {
+        util.invalidateCache(realmId);
+    }
+}
+
+// A placeholder for the result of the request at `index` in a batch, or for
+// one of its fields, such as `batchResult(0, 'id')` for the id of an object.
+export function batchResult(index, field) {
+    return { type: objectTypes.BATCHRESULT, index, field, [batchPlaceholder]: true };
+}
+
 export function getAllUsers() {
     let result = sendRequest('get_all_users');
     return deserialize(undefined, result);
@@ -176,6 +303,9 @@ function serialize(realmId, value) {
     if (!value || typeof value != 'object') {
         return { value: value };
     }
+    if (value[batchPlaceholder]) {
+        return value;
+    }
 
     let id = value[idKey];
     if (id) {
@@ -183,6 +313,9 @@ function serialize(realmId, value) {
     }
 
     if (value instanceof Date) {
+        if (binaryEncoding) {
+            return { type: objectTypes.DATE, timestamp: value };
+        }
         return { type: objectTypes.DATE, value: value.getTime() };
     }
 
@@ -192,6 +325,9 @@ function serialize(realmId, value) {
     }
 
     if (value instanceof ArrayBuffer || ArrayBuffer.isView(value)) {
+        if (binaryEncoding) {
+            return { type: objectTypes.DATA, bytes: value };
+        }
         return { type: objectTypes.DATA, value: base64.encode(value) };
     }
 
@@ -204,7 +340,11 @@ export function deserialize(realmId, info) {
     let type = info.type;
     let handler = type && typeConverters[type];
     if (handler) {
-        return handler(realmId, info);
+        let value = handler(realmId, info);
+        if (objectRegistry && info.id && value && typeof value == 'object') {
+            objectRegistry.register(value, { id: info.id, session: sessionId });
+        }
+        return value;
     }
 
     let value = info.value;
@@ -215,6 +355,39 @@ export function deserialize(realmId, info) {
     return value;
 }
 
+function releaseObject({ id, session }) {
+    // Objects from a previous session are gone already.
+    if (session !== sessionId) {
+        return;
+    }
+    releasedIds.push(id);
+    if (releasedIds.length >= releaseBatchSize) {
+        releaseObjects();
+    }
+    else if (!releaseTimeoutId) {
+        releaseTimeoutId = setTimeout(releaseObjects, 1000);
+    }
+}
+
+function releaseObjects() {
+    clearTimeout(releaseTimeoutId);
+    releaseTimeoutId = undefined;
+
+    let ids = releasedIds;
+    releasedIds = [];
+    if (sessionId && ids.length) {
+        sendRequestAsync('release_objects', { ids }).catch(() => {});
+    }
+}
+
+function deserializeData(realmId, info) {
+    let { bytes } = info;
+    if (bytes) {
+        return bytes.buffer.slice(bytes.byteOffset, bytes.byteOffset + bytes.byteLength);
+    }
+    return base64.decode(info.value);
+}
+
 function deserializeDict(realmId, info) {
     let { keys, values } = info;
     let object = {};
@@ -230,7 +403,53 @@ function deserializeFunction(realmId, info) {
     return registeredCallbacks[info.value];
 }
 
+function makeBinaryRequest(url, data) {
+    let body = msgpack.encode(data);
+    let statusCode;
+    let bytes;
+
+    // The global __debug__ object is provided by Visual Studio Code.
+    if (global.__debug__) {
+        let request = global.__debug__.require('sync-request');
+        let response = request('POST', url, {
+            body: Buffer.from(body.buffer, body.byteOffset, body.byteLength),
+            headers: {
+                "Content-Type": msgpackContentType
+            }
+        });
+
+        statusCode = response.statusCode;
+        bytes = new Uint8Array(response.body);
+    } else {
+        let request = new XMLHttpRequest();
+
+        request.open('POST', url, false);
+        request.setRequestHeader('Content-Type', msgpackContentType);
+
+        // Synchronous requests can't set a responseType, so read the bytes back from the text.
+        request.overrideMimeType('text/plain; charset=x-user-defined');
+        request.send(body);
+
+        statusCode = request.status;
+        let text = request.responseText;
+        bytes = new Uint8Array(text.length);
+        for (let i = 0; i < text.length; i++) {
+            bytes[i] = text.charCodeAt(i) & 0xff;
+        }
+    }
+
+    if (statusCode != 200) {
+        throw new Error(String.fromCharCode.apply(null, bytes));
+    }
+
+    return msgpack.decode(bytes);
+}
+
 function makeRequest(url, data) {
+    if (binaryEncoding) {
+        return makeBinaryRequest(url, data);
+    }
+
     let statusCode;
     let responseText;
 
@@ -284,6 +503,80 @@ function deserialize_json_value(value) {
     return result;
 }
 
+function responseError(command, response) {
+    let error = response && response.error;
+
+    // Remove the type prefix from the error message (e.g. "Error: ").
+    if (error && error.replace) {
+        error = error.replace(/^[a-z]+: /i, '');
+    }
+    else if (error.type && error.type === 'dict') {
+        const responseError = deserialize_json_value(error);
+        let responeMessage;
+        if (response.message && response.message !== '') {
+            // Remove the type prefix from the error message (e.g. "Error: ").
+            responeMessage = response.message.replace(/^[a-z]+: /i, '');
+        }
+
+        const exceptionToReport = new Error(responeMessage);
+        Object.assign(exceptionToReport, responseError);
+        return exceptionToReport;
+    }
+
+    return new Error(error || `Invalid response for "${command}"`);
+}
+
+// Calls the callback the server asked for, and returns the request to send
+// its result back with.
+function runCallback(command, realmId, response) {
+    let { callback } = response;
+    let result, error, stack;
+    try {
+        let thisObject = deserialize(realmId, response.this);
+        let args = deserialize(realmId, response.arguments);
+        const fn = registeredCallbacks[callback];
+        if (fn) {
+            result = serialize(realmId, fn.apply(thisObject, args));
+        }
+        else {
+            error = `Unknown callback id: ${callback}`
+        }
+    } catch (e) {
+        error = e.message || ('' + e);
+        if (e.stack) {
+            stack = JSON.stringify(e.stack);
+        }
+    }
+
+    let callbackCommand = "callback_result";
+    if (command === 'callbacks_poll' || command === 'callback_poll_result') {
+        callbackCommand = "callback_poll_result";
+    }
+
+    return [callbackCommand, { callback, result, error, stack, "callback_call_counter": response.callback_call_counter }];
+}
+
+// Runs the callbacks the server called without waiting for their results,
+// once whatever is handling the current response is done.
+function runAsyncCallbacks(realmId, callbacks) {
+    if (!callbacks || !callbacks.length) {
+        return;
+    }
+    Promise.resolve().then(() => {
+        for (const { callback, this: thisObject, arguments: args } of callbacks) {
+            const fn = registeredCallbacks[callback];
+            if (!fn) {
+                continue;
+            }
+            try {
+                fn.apply(deserialize(realmId, thisObject), deserialize(realmId, args));
+            } catch (e) {
+                console.error(e);
+            }
+        }
+    });
+}
+
 function sendRequest(command, data, host = sessionHost) {
     clearTimeout(pollTimeoutId);
     try {
@@ -296,11 +589,12 @@ function sendRequest(command, data, host = sessionHost) {
         let url = 'http://' + host + '/' + command;
         let response = makeRequest(url, data);
         let callback = response && response.callback;
+        runAsyncCallbacks(data.realmId, response && response.callbacks);
 
         // Reset the callback poll interval to 10ms every time we either hit a
         // callback or call any other method, and double it each time we poll
         // for callbacks and get nothing until it's over a second.
-        if (callback || command !== 'callbacks_poll') {
+        if (callback || (response && response.callbacks) || command !== 'callbacks_poll') {
             pollTimeout = 10;
         }
         else if (pollTimeout < 1000) {
@@ -308,58 +602,102 @@ function sendRequest(command, data, host = sessionHost) {
         }
 
         if (!response || response.error) {
-            let error = response && response.error;
-
-            // Remove the type prefix from the error message (e.g. "Error: ").
-            if (error && error.replace) {
-                error = error.replace(/^[a-z]+: /i, '');
-            }
-            else if (error.type && error.type === 'dict') {
-                const responseError = deserialize_json_value(error);
-                let responeMessage;
-                if (response.message && response.message !== '') {
-                    // Remove the type prefix from the error message (e.g. "Error: ").
-                    responeMessage = response.message.replace(/^[a-z]+: /i, '');
-                }
-
-                const exceptionToReport = new Error(responeMessage);
-                Object.assign(exceptionToReport, responseError);
-                throw exceptionToReport;
-            }
-
-            throw new Error(error || `Invalid response for "${command}"`);
+            throw responseError(command, response);
         }
         if (callback != null) {
-            let result, error, stack;
-            try {
-                let realmId = data.realmId;
-                let thisObject = deserialize(realmId, response.this);
-                let args = deserialize(realmId, response.arguments);
-                const fn = registeredCallbacks[callback];
-                if (fn) {
-                    result = serialize(realmId, fn.apply(thisObject, args));
-                }
-                else {
-                    error = `Unknown callback id: ${callback}`
-                }
-            } catch (e) {
-                error = e.message || ('' + e);
-                if (e.stack) {
-                    stack = JSON.stringify(e.stack);
-                }
-            }
-
-            let callbackCommand = "callback_result";
-            if (command === 'callbacks_poll' || command === 'callback_poll_result') {
-                callbackCommand = "callback_poll_result";
-            }
-
-            return sendRequest(callbackCommand, { callback, result, error, stack, "callback_call_counter": response.callback_call_counter });
+            return sendRequest(...runCallback(command, data.realmId, response));
         }
 
         return response.result;
     }
     finally {
-        pollTimeoutId = setTimeout(() => sendRequest('callbacks_poll'), pollTimeout);
+        // Callbacks are pushed over the WebSocket while it's connected.
+        if (!webSocket) {
+            pollTimeoutId = setTimeout(() => sendRequest('callbacks_poll'), pollTimeout);
+        }
     }
 }
+
+// Sends a request over the WebSocket if it's connected, or as a normal
+// request otherwise, and returns a promise for its result. Nothing waits for
+// the response, so requests whose results aren't needed right away don't
+// block.
+export function sendRequestAsync(command, data) {
+    if (!webSocket) {
+        return new Promise((resolve) => resolve(sendRequest(command, data)));
+    }
+
+    data = Object.assign({}, data, { sessionId });
+    return sendWebSocketMessage(command, data).then((response) => handleAsyncResponse(command, data.realmId, response));
+}
+
+function sendWebSocketMessage(command, data) {
+    return new Promise((resolve, reject) => {
+        const id = nextWebSocketRequestId++;
+        webSocketRequests.set(id, { resolve, reject });
+
+        const message = { id, request: '/' + command, body: data };
+        webSocket.send(binaryEncoding ? msgpack.encode(message) : JSON.stringify(message));
+    });
+}
+
+function handleAsyncResponse(command, realmId, response) {
+    runAsyncCallbacks(realmId, response && response.callbacks);
+    if (!response || response.error) {
+        throw responseError(command, response);
+    }
+    if (response.callback != null) {
+        let [callbackCommand, data] = runCallback(command, realmId, response);
+        return sendRequestAsync(callbackCommand, Object.assign({ realmId }, data));
+    }
+    return response.result;
+}
+
+function connectWebSocket(host, port) {
+    if (!port || typeof WebSocket == 'undefined') {
+        return;
+    }
+
+    // A new session replaces the connection of the previous one.
+    if (webSocket) {
+        webSocket.close();
+    }
+
+    const socket = new WebSocket(`ws://${host.replace(/:\d+$/, '')}:${port}`);
+    socket.binaryType = 'arraybuffer';
+    socket.onopen = () => {
+        webSocket = socket;
+        clearTimeout(pollTimeoutId);
+    };
+    socket.onclose = () => {
+        if (webSocket !== socket) {
+            return;
+        }
+        webSocket = undefined;
+        for (const { reject } of webSocketRequests.values()) {
+            reject(new Error('The connection to the RPC server was closed'));
+        }
+        webSocketRequests.clear();
+
+        // Go back to polling for callbacks.
+        pollTimeoutId = setTimeout(() => sendRequest('callbacks_poll'), pollTimeout);
+    };
+    socket.onmessage = ({ data }) => {
+        const message = typeof data == 'string' ? JSON.parse(data) : msgpack.decode(new Uint8Array(data));
+
+        // Callbacks invoked from the server's event loop, which would
+        // otherwise have been picked up by callbacks_poll.
+        if (message.push) {
+            Promise.resolve(message.push)
+                .then((response) => handleAsyncResponse('callbacks_poll', undefined, response))
+                .catch((e) => console.error(e));
+            return;
+        }
+
+        const request = webSocketRequests.get(message.id);
+        if (request) {
+            webSocketRequests.delete(message.id);
+            request.resolve(message.response);
+        }
+    };
+}
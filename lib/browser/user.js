@@ -47,7 +47,9 @@ Object.defineProperties(User.prototype, {
 
 createMethods(User.prototype, objectTypes.USER, [
     '_logout',
-    '_sessionForOnDiskPath'
+    '_sessionForOnDiskPath',
+    'addProgressNotification',
+    'removeProgressNotification',
 ]);
 
 export function createUser(realmId, info) {
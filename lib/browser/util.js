@@ -82,6 +82,17 @@ export function cacheObject(realmId, id, value) {
     getRealmCache(realmId)[id] = value;
 }
 
+// Adds to the cached properties of an object rather than replacing them.
+export function cacheProperties(realmId, id, values) {
+    let realmCache = getRealmCache(realmId);
+    realmCache[id] = Object.assign(realmCache[id] || {}, values);
+}
+
+export function isCached(obj, name) {
+    let objCache = getRealmCache(obj[keys.realm])[obj[keys.id]];
+    return !!objCache && name in objCache;
+}
+
 export function getProperty(obj, name, cache = true) {
     let realmId = obj[keys.realm];
     let id = obj[keys.id];
@@ -53,8 +53,54 @@ Object.defineProperty(iteratorPrototype, Symbol.iterator, {
     }
 });
 
+// Iterates over the elements which the native iterator reads a chunk at a
+// time, so that each step but the first of a chunk stays in JS.
+function createChunkedIterator(collection, methodName, options) {
+    var iterator = collection._iterate(options);
+    var chunk = [];
+    var position = 0;
+    var index = 0;
+
+    return Object.create(iteratorPrototype, {
+        next: {
+            value: function() {
+                if (position >= chunk.length) {
+                    chunk = iterator && !iterator.done ? iterator.next() : [];
+                    position = 0;
+                    if (chunk.length === 0) {
+                        iterator = null;
+                        return {done: true, value: undefined};
+                    }
+                }
+
+                var value = chunk[position++];
+                if (methodName === 'entries') {
+                    value = [index, value];
+                }
+                index++;
+                return {done: false, value: value};
+            }
+        }
+    });
+}
+
+exports.iterate = {
+    value: function(options) {
+        if (!this._iterate) {
+            throw new Error('Iterating in chunks is not supported by this collection.');
+        }
+        return createChunkedIterator(this, 'values', options);
+    },
+    configurable: true,
+    writable: true,
+};
+
 ['entries', 'keys', 'values'].forEach(function(methodName) {
     var method = function() {
+        if (methodName !== 'keys' && this._iterate) {
+            return createChunkedIterator(this, methodName);
+        }
+
         var self = this.snapshot();
         var index = 0;
 
@@ -89,3 +135,32 @@ Object.defineProperty(iteratorPrototype, Symbol.iterator, {
 });
 
 exports[Symbol.iterator] = exports.values;
+
+// Resolves once the results have been evaluated on the notification thread.
+function evaluateAsync(results) {
+    return new Promise(function(resolve, reject) {
+        results._evaluateAsync(function(results, error) {
+            if (error) {
+                reject(new Error(error));
+            } else {
+                resolve(results);
+            }
+        });
+    });
+}
+
+exports.filteredAsync = {
+    value: function() {
+        return evaluateAsync(this.filtered.apply(this, arguments));
+    },
+    configurable: true,
+    writable: true,
+};
+
+exports.sortedAsync = {
+    value: function() {
+        return evaluateAsync(this.sorted.apply(this, arguments));
+    },
+    configurable: true,
+    writable: true,
+};
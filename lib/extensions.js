@@ -95,6 +95,50 @@ function waitForCompletion(session, fn, timeout, timeoutErrorMessage) {
     ]);
 }
 
+// Async writes queued on each Realm which have not been committed yet.
+const pendingAsyncWrites = new WeakMap();
+
+const scheduleAsyncWrites = typeof setImmediate === 'function' ? setImmediate : (fn) => setTimeout(fn, 0);
+
+/**
+ * Runs the queued async writes of a Realm in a single write transaction. A callback which throws
+ * rejects its own promise, and the rest of the group is retried without it.
+ */
+function commitAsyncWrites(realm, writes) {
+    if (realm.isClosed) {
+        const error = new Error('The Realm was closed before the write could be committed.');
+        writes.forEach((write) => write.reject(error));
+        return;
+    }
+
+    const results = [];
+    let failed = null;
+    try {
+        realm.write(() => {
+            for (const write of writes) {
+                try {
+                    results.push(write.callback(realm));
+                } catch (error) {
+                    failed = { write, error };
+                    throw error;
+                }
+            }
+        });
+    } catch (error) {
+        if (!failed) {
+            writes.forEach((write) => write.reject(error));
+            return;
+        }
+        failed.write.reject(failed.error);
+        const remaining = writes.filter((write) => write !== failed.write);
+        if (remaining.length > 0) {
+            commitAsyncWrites(realm, remaining);
+        }
+        return;
+    }
+    writes.forEach((write, index) => write.resolve(results[index]));
+}
+
 function openLocalRealm(realmConstructor, config) {
     let promise = Promise.resolve(new realmConstructor(config));
     promise.progress = (callback) => { return promise; };
@@ -111,6 +155,12 @@ module.exports = function(realmConstructor, context) {
     setConstructorOnPrototype(realmConstructor.Results);
     setConstructorOnPrototype(realmConstructor.Object);
 
+    // Accept the `minInterval` and `maxDelay` listener options.
+    const listenerThrottle = require('./listener-throttle');
+    listenerThrottle.installCollectionListeners(realmConstructor.Results.prototype);
+    listenerThrottle.installCollectionListeners(realmConstructor.List.prototype);
+    listenerThrottle.installRealmListeners(realmConstructor.prototype);
+
     //Add static methods to the Realm object
     Object.defineProperties(realmConstructor, getOwnPropertyDescriptors({
         open(config) {
@@ -229,6 +279,91 @@ module.exports = function(realmConstructor, context) {
             return openPromise;
         },
 
+        openAll(configs, options) {
+            if (!Array.isArray(configs)) {
+                throw new TypeError('configs must be an array of configurations');
+            }
+            let concurrency = configs.length;
+            if (options && options.concurrency !== undefined) {
+                concurrency = options.concurrency;
+                if (typeof concurrency !== 'number' || !(concurrency >= 1)) {
+                    throw new Error(`'concurrency' must be a positive number: '${concurrency}'`);
+                }
+            }
+
+            // The downloads themselves run on the sync client, so opening
+            // several Realms at once only costs the JS thread the callbacks.
+            const realms = new Array(configs.length);
+            const progress = configs.map(() => ({ transferred: 0, transferable: 0 }));
+            const progressCallbacks = [];
+            const pending = new Set();
+            let next = 0;
+            let stopped = false;
+
+            const reportProgress = () => {
+                let transferred = 0;
+                let transferable = 0;
+                for (const entry of progress) {
+                    transferred += entry.transferred;
+                    transferable += entry.transferable;
+                }
+                for (const callback of progressCallbacks) {
+                    callback(transferred, transferable);
+                }
+            };
+
+            const openNext = () => {
+                if (stopped || next >= configs.length) {
+                    return Promise.resolve();
+                }
+                const index = next++;
+                const promise = this.open(configs[index]);
+                pending.add(promise);
+                if (typeof promise.progress === 'function') {
+                    promise.progress((transferred, transferable) => {
+                        progress[index] = { transferred, transferable };
+                        reportProgress();
+                    });
+                }
+                return promise.then((realm) => {
+                    pending.delete(promise);
+                    realms[index] = realm;
+                    return openNext();
+                }, (error) => {
+                    pending.delete(promise);
+                    throw error;
+                });
+            };
+
+            const cancel = () => {
+                stopped = true;
+                for (const promise of pending) {
+                    if (typeof promise.cancel === 'function') {
+                        promise.cancel();
+                    }
+                }
+                pending.clear();
+            };
+
+            const workers = [];
+            for (let i = 0; i < Math.min(concurrency, configs.length); i++) {
+                workers.push(openNext());
+            }
+
+            // The first failure cancels the opens which haven't finished yet.
+            // Realms which were already opened are left open.
+            let openPromise = Promise.all(workers).then(() => realms, (error) => {
+                cancel();
+                throw error;
+            });
+            openPromise.cancel = cancel;
+            openPromise.progress = (callback) => {
+                progressCallbacks.push(callback);
+                return openPromise;
+            };
+            return openPromise;
+        },
+
         openAsync(config, callback, progressCallback) {
             const message = "Realm.openAsync is now deprecated in favor of Realm.open. This function will be removed in future versions.";
             (console.warn || console.log).call(console, message);
@@ -284,7 +419,111 @@ module.exports = function(realmConstructor, context) {
                 }
             }
             return obj;
-        }
+        },
+
+        deleteFiles(configs) {
+            if (!Array.isArray(configs)) {
+                throw new TypeError('configs must be an array of configurations or paths');
+            }
+            configs = configs.map((config) => typeof config === 'string' ? { path: config } : config);
+            return new Promise((resolve) => realmConstructor._deleteFilesAsync(configs, [], resolve));
+        },
+
+        deleteDirectories(paths) {
+            if (!Array.isArray(paths)) {
+                throw new TypeError('paths must be an array of directories');
+            }
+            return new Promise((resolve) => realmConstructor._deleteFilesAsync([], paths, resolve));
+        },
+    }));
+
+    // Add instance methods to the Realm object
+    Object.defineProperties(realmConstructor.prototype, getOwnPropertyDescriptors({
+        writeAsync(callback) {
+            if (typeof callback !== 'function') {
+                throw new TypeError('Callback must be a function.');
+            }
+
+            let writes = pendingAsyncWrites.get(this);
+            if (!writes) {
+                writes = [];
+                pendingAsyncWrites.set(this, writes);
+                scheduleAsyncWrites(() => {
+                    pendingAsyncWrites.delete(this);
+                    commitAsyncWrites(this, writes);
+                });
+            }
+
+            return new Promise((resolve, reject) => {
+                writes.push({ callback, resolve, reject });
+            });
+        },
+
+        compactAsync(progress) {
+            if (progress !== undefined && typeof progress !== 'function') {
+                throw new TypeError('Progress callback must be a function.');
+            }
+
+            // The Realm is closed until the compaction has finished and it
+            // has been reopened. Invalid calls throw rather than reject.
+            let settle;
+            const promise = new Promise((resolve, reject) => {
+                settle = (error, compacted) => {
+                    if (error) {
+                        reject(error);
+                    } else {
+                        resolve(compacted);
+                    }
+                };
+            });
+            this._compactAsync(settle, progress);
+            return promise;
+        },
+
+        writeCopyToAsync(target, encryptionKey, options) {
+            const isBinary = (value) => value instanceof ArrayBuffer || ArrayBuffer.isView(value);
+            if (options === undefined && encryptionKey && !isBinary(encryptionKey)) {
+                options = encryptionKey;
+                encryptionKey = undefined;
+            }
+            options = options || {};
+
+            const sink = typeof target === 'function' ? target : undefined;
+            if (!sink && typeof target !== 'string') {
+                throw new TypeError('Target must be a path or a function.');
+            }
+            if (options.progress !== undefined && typeof options.progress !== 'function') {
+                throw new TypeError('Progress callback must be a function.');
+            }
+
+            let settle;
+            let sinkError;
+            const promise = new Promise((resolve, reject) => {
+                settle = (error, bytesWritten) => {
+                    if (sinkError || error) {
+                        reject(sinkError || error);
+                    } else {
+                        resolve(bytesWritten);
+                    }
+                };
+            });
+
+            // Each chunk is handed to the sink once it has taken the one
+            // before, so a slow sink holds the copy back.
+            const writeChunk = sink && ((chunk) => {
+                Promise.resolve()
+                    .then(() => sink(chunk))
+                    .then(() => task._resume(), (error) => {
+                        sinkError = error;
+                        task.cancel();
+                    });
+            });
+
+            const task = this._writeCopyToAsync(sink ? null : target, encryptionKey || null, options.bytesPerSecond || 0,
+                                                settle, options.progress, writeChunk);
+            promise.cancel = () => task.cancel();
+            return promise;
+        },
     }));
 
     // Add static properties to Realm Object
@@ -302,38 +541,104 @@ module.exports = function(realmConstructor, context) {
     }
 
     // Add sync methods
-    if (realmConstructor.Sync) {
-        let userMethods = require('./user-methods');
-        Object.defineProperties(realmConstructor.Sync.User, getOwnPropertyDescriptors(userMethods.static));
-        Object.defineProperties(realmConstructor.Sync.User.prototype, getOwnPropertyDescriptors(userMethods.instance));
-        Object.defineProperty(realmConstructor.Sync.User, '_realmConstructor', { value: realmConstructor });
-        realmConstructor.Sync.Credentials = {};
-        Object.defineProperties(realmConstructor.Sync.Credentials, getOwnPropertyDescriptors(userMethods.credentials));
-        realmConstructor.Sync.AuthError = require('./errors').AuthError;
-
-        if (realmConstructor.Sync.removeAllListeners) {
-            process.on('exit', realmConstructor.Sync.removeAllListeners);
-            process.on('SIGINT', function () {
-                realmConstructor.Sync.removeAllListeners();
-                process.exit(2);
-            });
-            process.on('uncaughtException', function(e) {
-                realmConstructor.Sync.removeAllListeners();
-                /* eslint-disable no-console */
-                console.log(e.stack);
-                process.exit(99);
-            });
-        }
+    if ('Sync' in realmConstructor) {
+        // Realm.Sync and the classes under it are only created the first time
+        // Realm.Sync is read, which is when each of these sets them up, in order.
+        const syncSetups = [function(Sync) {
+            let userMethods = require('./user-methods');
+            Object.defineProperties(Sync.User, getOwnPropertyDescriptors(userMethods.static));
+            Object.defineProperties(Sync.User.prototype, getOwnPropertyDescriptors(userMethods.instance));
+            Object.defineProperty(Sync.User, '_realmConstructor', { value: realmConstructor });
+            Sync.Credentials = {};
+            Object.defineProperties(Sync.Credentials, getOwnPropertyDescriptors(userMethods.credentials));
+            Sync.AuthError = require('./errors').AuthError;
+
+            if (Sync.removeAllListeners) {
+                process.on('exit', Sync.removeAllListeners);
+                process.on('SIGINT', function () {
+                    Sync.removeAllListeners();
+                    process.exit(2);
+                });
+                process.on('uncaughtException', function(e) {
+                    Sync.removeAllListeners();
+                    /* eslint-disable no-console */
+                    console.log(e.stack);
+                    process.exit(99);
+                });
+            }
 
-        //back compat. setSyncLogger is deprecated.
-        if (!realmConstructor.Sync.setSyncLogger) {
-            realmConstructor.Sync.setSyncLogger = function (level, message) {
-                realmConstructor.Sync.setLogger(level, message);
+            //back compat. setSyncLogger is deprecated.
+            if (!Sync.setSyncLogger) {
+                Sync.setSyncLogger = function (level, message) {
+                    Sync.setLogger(level, message);
+                }
             }
-        }
 
-        setConstructorOnPrototype(realmConstructor.Sync.User);
-        setConstructorOnPrototype(realmConstructor.Sync.Session);
+            setConstructorOnPrototype(Sync.User);
+            setConstructorOnPrototype(Sync.Session);
+
+            Sync.openLocalRealmBehavior = {
+                type: 'openImmediately'
+            };
+
+            Sync.downloadBeforeOpenBehavior = {
+                type: 'downloadBeforeOpen',
+                timeOut: 30 * 1000,
+                timeOutBehavior: 'throwException'
+            };
+
+            Sync.setFeatureToken = function() {
+                console.log('Realm.Sync.setFeatureToken() is deprecated and you can remove any calls to it.');
+            }
+
+            Sync.Session.prototype.uploadAllLocalChanges = function(timeout) {
+                return waitForCompletion(this, this._waitForUploadCompletion, timeout, `Uploading changes did not complete in ${timeout} ms.`);
+            };
+
+            Sync.Session.prototype.downloadAllServerChanges = function(timeout) {
+                return waitForCompletion(this, this._waitForDownloadCompletion, timeout, `Downloading changes did not complete in ${timeout} ms.`);
+            };
+
+            // The adapter is only available in Node.js. Each chunk of
+            // instructions is only converted to JS objects when it is asked for.
+            if (Sync.Adapter) {
+                Sync.Adapter.prototype.currentChunks = function*(path, chunkSize) {
+                    const chunks = this._currentChunks(path, chunkSize);
+                    if (!chunks) {
+                        return;
+                    }
+                    let chunk;
+                    while ((chunk = chunks.next()) !== undefined) {
+                        yield chunk;
+                    }
+                };
+            }
+
+            // Keep these value in sync with subscription_state.hpp
+            Sync.SubscriptionState = {
+                Error: -1,      // An error occurred while creating or processing the partial sync subscription.
+                Creating: 2,    // The subscription is being created.
+                Pending: 0,     // The subscription was created, but has not yet been processed by the sync server.
+                Complete: 1,    // The subscription has been processed by the sync server and data is being synced to the device.
+                Invalidated: 3, // The subscription has been removed.
+            };
+
+            Sync.ConnectionState = {
+                Disconnected: "disconnected",
+                Connecting: "connecting",
+                Connected: "connected",
+            };
+
+            Sync.ClientResyncMode = {
+                Discard: 'discard',
+                Manual: 'manual',
+                Recover: 'recover'
+            };
+        }];
+        Object.defineProperties(realmConstructor, {
+            _syncSetups: { value: syncSetups },
+            _setupSync: { value: (Sync) => syncSetups.forEach((setup) => setup(Sync)) },
+        });
 
         // A configuration for a default Realm
         realmConstructor.automaticSyncConfiguration = function() {
@@ -367,48 +672,94 @@ module.exports = function(realmConstructor, context) {
             return config;
         };
 
-        realmConstructor.Sync.openLocalRealmBehavior = {
-            type: 'openImmediately'
-        };
+        // The state of a group of subscriptions is the least advanced state of
+        // any of them, unless one of them has failed or been removed.
+        function combinedSubscriptionState(subscriptions) {
+            const states = subscriptions.map(subscription => subscription.state);
+            const SubscriptionState = realmConstructor.Sync.SubscriptionState;
+            for (const state of [SubscriptionState.Error, SubscriptionState.Invalidated, SubscriptionState.Creating, SubscriptionState.Pending]) {
+                if (states.indexOf(state) !== -1) {
+                    return state;
+                }
+            }
+            return SubscriptionState.Complete;
+        }
 
-        realmConstructor.Sync.downloadBeforeOpenBehavior = {
-            type: 'downloadBeforeOpen',
-            timeOut: 30 * 1000,
-            timeOutBehavior: 'throwException'
-        };
+        class SubscriptionGroup {
+            constructor(subscriptions) {
+                this.subscriptions = subscriptions;
+                this._listeners = [];
+                this._lastState = undefined;
+                this._onChange = () => {
+                    const state = this.state;
+                    if (state === this._lastState) {
+                        return;
+                    }
+                    this._lastState = state;
+                    this._listeners.slice().forEach(callback => callback(this, state));
+                };
+            }
 
-        realmConstructor.Sync.setFeatureToken = function() {
-            console.log('Realm.Sync.setFeatureToken() is deprecated and you can remove any calls to it.');
-        }
+            get state() {
+                return combinedSubscriptionState(this.subscriptions);
+            }
 
-        realmConstructor.Sync.Session.prototype.uploadAllLocalChanges = function(timeout) {
-            return waitForCompletion(this, this._waitForUploadCompletion, timeout, `Uploading changes did not complete in ${timeout} ms.`);
-        };
+            get error() {
+                const failed = this.subscriptions.find(subscription => subscription.state === realmConstructor.Sync.SubscriptionState.Error);
+                return failed ? failed.error : undefined;
+            }
 
-        realmConstructor.Sync.Session.prototype.downloadAllServerChanges = function(timeout) {
-            return waitForCompletion(this, this._waitForDownloadCompletion, timeout, `Downloading changes did not complete in ${timeout} ms.`);
-        };
+            addListener(callback) {
+                if (typeof callback !== 'function') {
+                    throw new Error('Callback must be a function.');
+                }
+                if (this._listeners.length === 0) {
+                    this._lastState = undefined;
+                    this.subscriptions.forEach(subscription => subscription.addListener(this._onChange));
+                }
+                this._listeners.push(callback);
+            }
 
-        // Keep these value in sync with subscription_state.hpp
-        realmConstructor.Sync.SubscriptionState = {
-            Error: -1,      // An error occurred while creating or processing the partial sync subscription.
-            Creating: 2,    // The subscription is being created.
-            Pending: 0,     // The subscription was created, but has not yet been processed by the sync server.
-            Complete: 1,    // The subscription has been processed by the sync server and data is being synced to the device.
-            Invalidated: 3, // The subscription has been removed.
-        };
+            removeListener(callback) {
+                const index = this._listeners.indexOf(callback);
+                if (index !== -1) {
+                    this._listeners.splice(index, 1);
+                    if (this._listeners.length === 0) {
+                        this.subscriptions.forEach(subscription => subscription.removeListener(this._onChange));
+                    }
+                }
+            }
 
-        realmConstructor.Sync.ConnectionState = {
-            Disconnected: "disconnected",
-            Connecting: "connecting",
-            Connected: "connected",
-        };
+            removeAllListeners() {
+                if (this._listeners.length !== 0) {
+                    this._listeners = [];
+                    this.subscriptions.forEach(subscription => subscription.removeListener(this._onChange));
+                }
+            }
 
-        realmConstructor.Sync.ClientResyncMode = {
-            Discard: 'discard',
-            Manual: 'manual',
-            Recover: 'recover'
-        };
+            // Resolves once every subscription is complete, and rejects with
+            // the error of the first one to fail.
+            waitForCompletion() {
+                return new Promise((resolve, reject) => {
+                    const callback = (group, state) => {
+                        if (state === realmConstructor.Sync.SubscriptionState.Complete) {
+                            this.removeListener(callback);
+                            resolve(this);
+                        }
+                        else if (state === realmConstructor.Sync.SubscriptionState.Error ||
+                                 state === realmConstructor.Sync.SubscriptionState.Invalidated) {
+                            this.removeListener(callback);
+                            reject(state === realmConstructor.Sync.SubscriptionState.Error ? this.error : new Error('A subscription was removed before it completed.'));
+                        }
+                    };
+                    this.addListener(callback);
+                });
+            }
+
+            unsubscribe() {
+                this.subscriptions.forEach(subscription => subscription.unsubscribe());
+            }
+        }
 
         // Define the permission schemas as constructors so that they can be
         // passed into directly to functions which want object type names
@@ -632,6 +983,13 @@ module.exports = function(realmConstructor, context) {
                 return allSubscriptions;
             },
 
+            subscribeAll(subscriptions) {
+                if (!this._isPartialRealm) {
+                    throw new Error("Wrong Realm type. 'subscribeAll()' is only available for Query-based Realms.");
+                }
+                return new SubscriptionGroup(this._subscribeAll(subscriptions));
+            },
+
             unsubscribe(name) {
                 if (!this._isPartialRealm) {
                     throw new Error("Wrong Realm type. 'unsubscribe()' is only available for Query-based Realms.");
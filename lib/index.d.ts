@@ -32,6 +32,40 @@ declare namespace Realm {
 
     type CollectionChangeCallback<T> = (collection: Collection<T>, change: CollectionChangeSet) => void;
 
+    type AggregateFunction = 'min' | 'max' | 'sum' | 'avg';
+
+    interface AggregateChange {
+        previousValue: number | undefined;
+        insertions: number;
+        deletions: number;
+        modifications: number;
+        rescanned: boolean;
+    }
+
+    type AggregateCallback = (value: number | undefined, details: AggregateChange) => void;
+
+    type ChangeSetFormat = 'array' | 'int32Array' | 'ranges';
+
+    interface ListenerThrottleOptions {
+        minInterval?: number;
+        maxDelay?: number;
+    }
+
+    interface ThreadSafeReference {
+        readonly id: number;
+        readonly type: 'Realm' | 'Object' | 'Results' | 'List';
+        readonly path: string;
+    }
+
+    interface ObjectListenerOptions {
+        keyPaths?: string[];
+    }
+
+    interface CollectionListenerOptions extends ListenerThrottleOptions {
+        changeSetFormat?: ChangeSetFormat;
+        keyPaths?: string[];
+    }
+
     /**
      * PropertyType
      * @see { @link https://realm.io/docs/javascript/latest/api/Realm.html#~PropertyType }
@@ -63,6 +97,90 @@ declare namespace Realm {
         All = 'all'
     }
 
+    /**
+     * PreparedQuery
+     * @see { @link https://realm.io/docs/javascript/latest/api/Realm.PreparedQuery.html }
+     */
+    interface PreparedQuery<T> {
+        run(...arg: any[]): Results<T>;
+    }
+
+    interface CursorOptions<T> {
+        after?: T | null;
+        pageSize?: number;
+        sortBy?: string | SortDescriptor[];
+    }
+
+    /**
+     * ResultsCursor
+     * @see { @link https://realm.io/docs/javascript/latest/api/Realm.ResultsCursor.html }
+     */
+    interface ResultsCursor<T> {
+        readonly done: boolean;
+        next(): T[];
+    }
+
+    interface FrozenRealm {
+        readonly id: number;
+        readonly version: number;
+        readonly isClosed: boolean;
+        objects(type: string): FrozenResults;
+        close(): void;
+    }
+
+    interface FrozenResults {
+        readonly length: number;
+        readonly objectType: string;
+        readonly id: number;
+        readonly version: number;
+        readonly isClosed: boolean;
+        get(index: number, options?: ToPlainOptions): { [key: string]: any } | null | undefined;
+        toPlain(options?: ToPlainOptions & { json?: false }): ({ [key: string]: any } | null)[];
+        toPlain(options: ToPlainOptions & { json: true }): string;
+        close(): void;
+    }
+
+    interface WriteCopyOptions {
+        bytesPerSecond?: number;
+        progress?: (writtenBytes: number, totalBytes: number) => void;
+    }
+
+    /**
+     * FileStats
+     * @see { @link https://realm.io/docs/javascript/latest/api/Realm.html#fileStats }
+     */
+    interface FileStats {
+        fileSize: number;
+        usedSize: number;
+        freeSize: number;
+        activeVersions: number;
+        encryption: EncryptionStats | null;
+    }
+
+    interface EncryptionStats {
+        pageSize: number;
+        filePages: number;
+        usedPages: number;
+        decryptedPages: number | null;
+    }
+
+    /**
+     * MemoryStats
+     * @see { @link https://realm.io/docs/javascript/latest/api/Realm.html#memoryStats }
+     */
+    interface MemoryStats {
+        fileSize: number | null;
+        pinnedVersions: number | null;
+        readVersionAgeMs: number;
+        oldestReadVersionAgeMs: number;
+        liveResults: number;
+        liveLists: number;
+        liveObjects: number;
+        listeners: number;
+        frozenVersions: number;
+        snapshotError: string | null;
+    }
+
     /**
      * ObjectSchema
      * @see { @link https://realm.io/docs/javascript/latest/api/Realm.html#~ObjectSchema }
@@ -92,7 +210,32 @@ declare namespace Realm {
     /**
      * A function which can be called to migrate a Realm from one version of the schema to another.
      */
-    type MigrationCallback = (oldRealm: Realm, newRealm: Realm) => void;
+    type MigrationCallback = (oldRealm: Realm, newRealm: Realm, migration: Migration) => void;
+
+    type MigrationTransform = 'toString' | 'toNumber' | 'default' | ((value: any) => any);
+
+    /**
+     * Migration
+     * @see { @link https://realm.io/docs/javascript/latest/api/Realm.Migration.html }
+     */
+    interface Migration {
+        renameProperty(objectType: string, oldName: string, newName: string): void;
+        copyProperty(objectType: string, from: string, to: string, transform?: MigrationTransform): void;
+        fillDefault(objectType: string, property: string, value?: any): void;
+        deleteWhere(objectType: string, query: string, ...args: any[]): number;
+        setProgressCallback(callback: ((operation: string, objectType: string, done: number, total: number) => void) | null): void;
+    }
+
+    interface InMemoryOptions {
+        persistTo: string;
+        intervalMs?: number;
+    }
+
+    interface FileRemovalReport {
+        removed: string[];
+        skipped: string[];
+        failed: { path: string, message: string }[];
+    }
 
     /**
      * realm configuration
@@ -105,7 +248,7 @@ declare namespace Realm {
         path?: string;
         fifoFilesFallbackPath?: string;
         readOnly?: boolean;
-        inMemory?: boolean;
+        inMemory?: boolean | InMemoryOptions;
         schema?: (ObjectClass | ObjectSchema)[];
         schemaVersion?: number;
         sync?: Partial<Realm.Sync.SyncConfiguration>;
@@ -157,10 +300,17 @@ declare namespace Realm {
          */
         linkingObjectsCount(): number;
 
+        /**
+         * @param  {ToPlainOptions} options?
+         * @returns a plain object, or a JSON string when `json` is true
+         */
+        toPlain(options?: ToPlainOptions & { json?: false }): { [key: string]: any };
+        toPlain(options: ToPlainOptions & { json: true }): string;
+
         /**
          * @returns void
          */
-        addListener(callback: ObjectChangeCallback): void;
+        addListener(callback: ObjectChangeCallback, options?: ObjectListenerOptions): void;
 
         removeListener(callback: ObjectChangeCallback): void;
 
@@ -181,6 +331,25 @@ declare namespace Realm {
      * Collection
      * @see { @link https://realm.io/docs/javascript/latest/api/Realm.Collection.html }
      */
+    interface SliceOptions {
+        properties?: string[];
+    }
+
+    interface ToPlainOptions {
+        depth?: number;
+        properties?: string[];
+        json?: boolean;
+    }
+
+    interface IterateOptions {
+        chunkSize?: number;
+        plain?: boolean | ToPlainOptions;
+    }
+
+    type TypedArray = Int8Array | Uint8Array | Int16Array | Uint16Array | Int32Array | Uint32Array | Float32Array | Float64Array;
+
+    type TypedArrayName = 'Int8Array' | 'Uint8Array' | 'Int16Array' | 'Uint16Array' | 'Int32Array' | 'Uint32Array' | 'Float32Array' | 'Float64Array';
+
     interface Collection<T> extends ReadonlyArray<T> {
         readonly type: PropertyType;
         readonly optional: boolean;
@@ -213,6 +382,79 @@ declare namespace Realm {
         sorted(descriptor: SortDescriptor[]): Results<T>;
         sorted(descriptor: string, reverse?: boolean): Results<T>;
 
+        filteredAsync(query: string, ...arg: any[]): Promise<Results<T>>;
+
+        /**
+         * @param  {PreparedQuery} query
+         * @param  {any[]} ...arg
+         * @returns Results
+         */
+        filteredPrepared(query: PreparedQuery<T>, ...arg: any[]): Results<T>;
+
+        sortedAsync(reverse?: boolean): Promise<Results<T>>;
+        sortedAsync(descriptor: SortDescriptor[]): Promise<Results<T>>;
+        sortedAsync(descriptor: string, reverse?: boolean): Promise<Results<T>>;
+
+        /**
+         * @param  {number} count
+         * @returns Results
+         */
+        limit(count: number): Results<T>;
+
+        /**
+         * @param  {CursorOptions} options
+         * @returns ResultsCursor
+         */
+        cursor(options?: CursorOptions<T>): ResultsCursor<T>;
+
+        /**
+         * @param  {string} objectType
+         * @param  {string} property
+         * @returns Results
+         */
+        linkingObjects<U>(objectType: string, property: string): Results<U & Realm.Object>;
+
+        /**
+         * @param  {string} objectType
+         * @param  {string} property
+         * @returns Int32Array
+         */
+        linkingObjectsCounts(objectType: string, property: string): Int32Array;
+
+        /**
+         * @param  {number} start
+         * @param  {number} end
+         * @param  {SliceOptions} options
+         * @returns T[] or plain objects when a projection is given
+         */
+        slice(start?: number, end?: number): T[];
+        slice(start: number | undefined, end: number | undefined, options: SliceOptions): { [key: string]: any }[];
+
+        /**
+         * @param  {TypedArrayName} type?
+         * @returns TypedArray
+         */
+        toTypedArray(type?: TypedArrayName): TypedArray;
+
+        /**
+         * @param  {ToPlainOptions} options?
+         * @returns plain objects or values, or a JSON string when `json` is true
+         */
+        toPlain(options?: ToPlainOptions & { json?: false }): any[];
+        toPlain(options: ToPlainOptions & { json: true }): string;
+
+        /**
+         * @param  {IterateOptions} options?
+         * @returns IterableIterator of the elements, or of plain copies of them when `plain` is given
+         */
+        iterate(options?: IterateOptions & { plain?: false }): IterableIterator<T>;
+        iterate(options: IterateOptions): IterableIterator<any>;
+
+        /**
+         * @returns FrozenResults
+         */
+        freeze(): FrozenResults;
+
         /**
          * @returns Results<T>
          */
@@ -228,7 +470,15 @@ declare namespace Realm {
          * @param  {(collection:any,changes:any)=>void} callback
          * @returns void
          */
-        addListener(callback: CollectionChangeCallback<T>): void;
+        addListener(callback: CollectionChangeCallback<T>, options?: CollectionListenerOptions): void;
+
+        /**
+         * @param  {string} aggregate one of 'min', 'max', 'sum' or 'avg'
+         * @param  {string} property a numeric property of the objects
+         * @param  {(value:number|undefined,details:AggregateChange)=>void} callback
+         * @returns void
+         */
+        observeAggregate(aggregate: AggregateFunction, property: string, callback: AggregateCallback): void;
 
         /**
          * @returns void
@@ -239,7 +489,7 @@ declare namespace Realm {
          * @param  {()=>void} callback this is the callback to remove
          * @returns void
          */
-        removeListener(callback: CollectionChangeCallback<T>): void;
+        removeListener(callback: CollectionChangeCallback<T> | AggregateCallback): void;
     }
 
     const Collection: {
@@ -275,6 +525,29 @@ declare namespace Realm {
          * @returns T
          */
         splice(index: number, count?: number, object?: any): T[];
+
+        /**
+         * @param  {any[]} items
+         * @param  {ListAssignOptions} options?
+         * @returns ListAssignChanges
+         */
+        assign(items: any[], options?: ListAssignOptions): ListAssignChanges;
+
+        /**
+         * @param  {TypedArray} array
+         * @returns void
+         */
+        setFromTypedArray(array: TypedArray): void;
+    }
+
+    interface ListAssignOptions {
+        key?: string;
+    }
+
+    interface ListAssignChanges {
+        deletions: number;
+        insertions: number;
+        moves: number;
     }
 
     const List: {
@@ -293,6 +566,39 @@ declare namespace Realm {
          * @returns void
          */
         update(property: string, value: any): void;
+
+        /**
+         * Bulk update several properties of the objects in the collection.
+         * @param  {Partial<T>} values
+         * @returns void
+         */
+        update(values: Partial<T> | { [key: string]: any }): void;
+
+        /**
+         * @returns QueryExplanation
+         */
+        explain(): QueryExplanation;
+
+        /**
+         * @returns QueryProfile
+         */
+        profile(): QueryProfile;
+    }
+
+    interface QueryExplanation {
+        objectType?: string;
+        query: string;
+        ordering: string;
+        conditions: { keyPath: string, indexed: boolean, usesIndex: boolean }[];
+    }
+
+    interface QueryProfile extends QueryExplanation {
+        parseMillis: number;
+        evaluateMillis: number;
+        orderMillis: number;
+        rowsExamined: number;
+        rowsMatched: number;
+        rowsReturned: number;
     }
 
     const Results: {
@@ -384,6 +690,8 @@ declare namespace Realm.Sync {
         createConfiguration(config?: Realm.PartialConfiguration): Realm.Configuration
         serialize(): SerializedUser | SerializedTokenUser;
         logout(): Promise<void>;
+        addProgressNotification(direction: ProgressDirection, mode: ProgressMode, progressCallback: ProgressNotificationCallback, options?: ProgressNotificationOptions): void;
+        removeProgressNotification(progressCallback: ProgressNotificationCallback): void;
         retrieveAccount(provider: string, username: string): Promise<Account>;
 
         getGrantedPermissions(recipient: 'any' | 'currentUser' | 'otherUser'): Promise<Permission[]>;
@@ -487,6 +795,7 @@ declare namespace Realm.Sync {
         validate?: boolean;
         certificatePath?: string;
         validateCallback?: SSLVerifyCallback;
+        validateCallbackCacheMs?: number;
     }
 
     const enum ClientResyncMode {
@@ -546,6 +855,11 @@ declare namespace Realm.Sync {
     type ProgressDirection = 'download' | 'upload';
     type ProgressMode = 'reportIndefinitely' | 'forCurrentlyOutstandingWork';
 
+    interface ProgressNotificationOptions {
+        minIntervalMs?: number;
+        minDeltaBytes?: number;
+    }
+
     type ConnectionNotificationCallback = (newState: ConnectionState, oldState: ConnectionState) => void;
 
     /**
@@ -559,7 +873,7 @@ declare namespace Realm.Sync {
         readonly user: User;
         readonly connectionState: ConnectionState;
 
-        addProgressNotification(direction: ProgressDirection, mode: ProgressMode, progressCallback: ProgressNotificationCallback): void;
+        addProgressNotification(direction: ProgressDirection, mode: ProgressMode, progressCallback: ProgressNotificationCallback, options?: ProgressNotificationOptions): void;
         removeProgressNotification(progressCallback: ProgressNotificationCallback): void;
 
         addConnectionNotification(callback: ConnectionNotificationCallback): void;
@@ -590,6 +904,29 @@ declare namespace Realm.Sync {
         removeAllListeners(): void;
     }
 
+    type SubscriptionGroupNotificationCallback = (group: SubscriptionGroup, state: SubscriptionState) => void;
+
+    /**
+     * SubscriptionGroup
+     * @see { @link https://realm.io/docs/javascript/latest/api/Realm.Sync.SubscriptionGroup.html }
+     */
+    interface SubscriptionGroup {
+        readonly subscriptions: Subscription[];
+        readonly state: SubscriptionState;
+        readonly error: string | undefined;
+
+        unsubscribe(): void;
+        addListener(callback: SubscriptionGroupNotificationCallback): void;
+        removeListener(callback: SubscriptionGroupNotificationCallback): void;
+        removeAllListeners(): void;
+        waitForCompletion(): Promise<SubscriptionGroup>;
+    }
+
+    interface SubscriptionRequest {
+        results: Realm.Results<any>;
+        options?: string | SubscriptionOptions;
+    }
+
     enum SubscriptionState {
         Error,
         Creating,
@@ -616,6 +953,9 @@ declare namespace Realm.Sync {
         readonly oldRealm: Realm;
         readonly path: string;
         readonly realm: Realm;
+
+        serialize(): string;
+        serialize(options: { binary: true, includeChanges?: boolean }): ArrayBuffer;
     }
 
     type RealmListenerEventName = 'available' | 'change' | 'delete';
@@ -625,6 +965,14 @@ declare namespace Realm.Sync {
         adminUser: User;
         filterRegex: string;
         sslConfiguration?: SSLConfiguration;
+        classNames?: string[];
+        filter?: RealmPathFilter | RegExp;
+    }
+
+    interface RealmPathFilter {
+        regex?: string | RegExp;
+        prefixes?: string | string[];
+        glob?: string | string[];
     }
 
     type LogLevel = 'all' | 'trace' | 'debug' | 'detail' | 'info' | 'warn' | 'error' | 'fatal' | 'off';
@@ -665,11 +1013,49 @@ declare namespace Realm.Sync {
     function removeAllListeners(): Promise<void>;
     function removeListener(regex: string, name: string, changeCallback: (changeEvent: ChangeEvent) => void): Promise<void>;
     function setLogLevel(logLevel: LogLevel): void;
-    function setLogger(callback: (level: NumericLogLevel, message: string) => void): void;
+    interface SyncLoggerOptions {
+        batch?: boolean;
+        bufferSize?: number;
+        filter?: string | string[];
+        ignoreCase?: boolean;
+    }
+
+    function setLogger(callback: (level: NumericLogLevel, message: string) => void, options?: SyncLoggerOptions & { batch?: false }): void;
+    function setLogger(callback: (levels: NumericLogLevel[], messages: string[], dropped: number) => void, options: SyncLoggerOptions & { batch: true }): void;
     function setUserAgent(userAgent: string): void;
     function initiateClientReset(path: string): void;
     function _hasExistingSessions(): boolean;
     function reconnect(): void;
+
+    interface TransferStats {
+        uploadedBytes: number;
+        uploadableBytes: number;
+        downloadedBytes: number;
+        downloadableBytes: number;
+        reconnects: number;
+    }
+
+    interface ConnectionStats extends TransferStats {
+        serverUrl: string;
+        multiplexIdentifier: string;
+        state: ConnectionState;
+        sessions: number;
+    }
+
+    interface SessionStats extends TransferStats {
+        path: string;
+        state: 'active' | 'inactive';
+        connectionState: ConnectionState;
+        connection: number;
+    }
+
+    interface SyncStats {
+        multiplexing: boolean;
+        connections: ConnectionStats[];
+        sessions: SessionStats[];
+    }
+
+    function getStats(): SyncStats;
     function localListenerRealms(regex: string): Array<LocalRealm>;
 
     /**
@@ -695,7 +1081,7 @@ declare namespace Realm.Sync {
             local_path: string,
             server_url: string,
             admin_user: User,
-            filter: string | RealmWatchPredicate,
+            filter: string | RegExp | RealmWatchPredicate | (RealmPathFilter & { predicate?: RealmWatchPredicate }),
             change_callback: Function,
             ssl?: SSLConfiguration
         )
@@ -704,9 +1090,11 @@ declare namespace Realm.Sync {
          * Advance the to the next transaction indicating that you are done processing the current instructions for the given Realm.
          * @param path the path for the Realm to advance
          */
-        advance(path: string): void;
+        advance(path: string, count?: number): void;
         close(): void;
         current(path: string): Array<Instruction>;
+        current(path: string, options: { raw: true }): ArrayBuffer | undefined;
+        currentChunks(path: string, chunkSize: number): IterableIterator<Array<Instruction>>;
         realmAtPath(path: string, schema?: ObjectSchema[]): Realm
     }
 }
@@ -780,6 +1168,15 @@ interface ProgressPromise extends Promise<Realm> {
     progress(callback: Realm.Sync.ProgressNotificationCallback): Promise<Realm>;
 }
 
+interface MultiProgressPromise extends Promise<Realm[]> {
+    cancel(): void;
+    progress(callback: Realm.Sync.ProgressNotificationCallback): Promise<Realm[]>;
+}
+
+interface CancellablePromise<T> extends Promise<T> {
+    cancel(): void;
+}
+
 interface NamedSubscription {
     readonly name: string,
     readonly objectType: string,
@@ -818,6 +1215,12 @@ declare class Realm {
      * @param {Configuration} config
      */
     static open(config: Realm.Configuration): ProgressPromise;
+    /**
+     * Open several realms asynchronously, downloading synced realms in parallel.
+     * @param {Configuration[]} configs
+     * @param {{ concurrency?: number }} options? how many realms are opened at a time, by default all of them
+     */
+    static openAll(configs: Realm.Configuration[], options?: { concurrency?: number }): MultiProgressPromise;
     /**
      * @deprecated in favor of `Realm.open`
      * Open a realm asynchronously with a callback. If the realm is synced, it will be fully synchronized before it is available.
@@ -846,6 +1249,20 @@ declare class Realm {
      */
     static deleteFile(config: Realm.Configuration): void;
 
+    /**
+     * Delete the files of many Realms off the JS thread, leaving those which are still open.
+     * @param {(Configuration|string)[]} configs
+     * @returns Promise<FileRemovalReport>
+     */
+    static deleteFiles(configs: (Realm.Configuration | string)[]): Promise<Realm.FileRemovalReport>;
+
+    /**
+     * Delete the files of every Realm in the directories off the JS thread, and then the directories left empty.
+     * @param {string[]} paths
+     * @returns Promise<FileRemovalReport>
+     */
+    static deleteDirectories(paths: string[]): Promise<Realm.FileRemovalReport>;
+
     /**
      * Copy all bundled Realm files to app's default file folder.
      */
@@ -862,6 +1279,28 @@ declare class Realm {
      */
     static exists(config: Realm.Configuration): boolean;
 
+    /**
+     * Starts recording trace events for the work done by Realm.
+     */
+    static startTracing(options?: { bufferSize?: number }): void;
+
+    /**
+     * Stops recording trace events, and returns them in Chrome's trace event format.
+     */
+    static stopTracing(): string;
+
+    /**
+     * @param  {Realm.ThreadSafeReference} reference
+     * @returns Realm, Realm.Object, Realm.Results or Realm.List
+     */
+    static resolveThreadSafeReference(reference: Realm.ThreadSafeReference): any;
+
+    /**
+     * @param  {number} id
+     * @returns Realm.FrozenRealm or Realm.FrozenResults
+     */
+    static resolveFrozen(id: number): Realm.FrozenRealm | Realm.FrozenResults;
+
     /**
      * @param  {Realm.Configuration} config?
      */
@@ -895,12 +1334,27 @@ declare class Realm {
      */
     create<T>(type: string | Realm.ObjectClass | Function, properties: T | Realm.ObjectPropsType, mode?: Realm.UpdateMode): T;
 
+    /**
+     * @param  {string|Realm.ObjectClass|Function} type
+     * @param  {(T&Realm.ObjectPropsType|any[])[]} objects
+     * @param  {Realm.UpdateMode} mode? If not provided, `Realm.UpdateMode.Never` is used.
+     * @returns void
+     */
+    createMany<T>(type: string | Realm.ObjectClass | Function, objects: (T | Realm.ObjectPropsType | any[])[], mode?: Realm.UpdateMode): void;
+
     /**
      * @param  {Realm.Object|Realm.Object[]|Realm.List<any>|Realm.Results<any>|any} object
      * @returns void
      */
     delete(object: Realm.Object | Realm.Object[] | Realm.List<any> | Realm.Results<any> | any): void;
 
+    /**
+     * @param  {string|Realm.ObjectType|Function} type
+     * @param  {(number|string)[]} keys
+     * @returns number
+     */
+    deleteByPrimaryKeys(type: string | Realm.ObjectType | Function, keys: (number | string)[]): number;
+
     /**
      * @returns void
      */
@@ -918,6 +1372,20 @@ declare class Realm {
      */
     objectForPrimaryKey<T>(type: string | Realm.ObjectType | Function, key: number | string): T & Realm.Object | undefined;
 
+    /**
+     * @param  {string|Realm.ObjectType|Function} type
+     * @param  {number[]|string[]} keys
+     * @returns {(T | null)[]}
+     */
+    objectsForPrimaryKeys<T>(type: string | Realm.ObjectType | Function, keys: (number | string | null)[]): (T & Realm.Object | null)[];
+
+    /**
+     * @param  {string|Realm.ObjectType|Function} type
+     * @param  {string} query
+     * @returns {Realm.PreparedQuery<T>}
+     */
+    prepareQuery<T>(type: string | Realm.ObjectType | Function, query: string): Realm.PreparedQuery<T & Realm.Object>;
+
     /**
      * @param  {string|Realm.ObjectType|Function} type
      * @returns Realm
@@ -929,8 +1397,8 @@ declare class Realm {
      * @param  {()=>void} callback
      * @returns void
      */
-    addListener(name: string, callback: (sender: Realm, event: 'change') => void): void;
-    addListener(name: string, callback: (sender: Realm, event: 'schema', schema: Realm.ObjectSchema[]) => void): void;
+    addListener(name: string, callback: (sender: Realm, event: 'change') => void, options?: Realm.ListenerThrottleOptions): void;
+    addListener(name: string, callback: (sender: Realm, event: 'schema', schema: Realm.ObjectSchema[]) => void, options?: Realm.ListenerThrottleOptions): void;
 
     /**
      * @param  {string} name
@@ -952,6 +1420,18 @@ declare class Realm {
      */
     write(callback: () => void): void;
 
+    /**
+     * @param  {(realm:Realm)=>T} callback
+     * @returns Promise<T>
+     */
+    writeAsync<T>(callback: (realm: Realm) => T): Promise<T>;
+
+    /**
+     * @param  {Realm.Object|Realm.Collection} value?
+     * @returns Realm.ThreadSafeReference
+     */
+    createThreadSafeReference(value?: Realm.Object | Realm.Collection<any>): Realm.ThreadSafeReference;
+
     /**
      * @returns void
      */
@@ -972,6 +1452,35 @@ declare class Realm {
      */
     compact(): boolean;
 
+    /**
+     * Compact the file on a background thread. The Realm is closed until the returned promise settles.
+     * @param progress called with the bytes written and the estimated size of the compacted file
+     * @returns Promise<boolean>
+     */
+    compactAsync(progress?: (writtenBytes: number, totalBytes: number) => void): Promise<boolean>;
+
+    /**
+     * @returns Realm.FileStats
+     */
+    fileStats(): Realm.FileStats;
+
+    /**
+     * @returns Realm.MemoryStats
+     */
+    memoryStats(): Realm.MemoryStats;
+
+    /**
+     * @returns Realm.FrozenRealm
+     */
+    freeze(): Realm.FrozenRealm;
+
+    /**
+     * @param  {number} threshold
+     * @param  {((realm: Realm, pinnedVersions: number) => void) | null} callback
+     * @returns void
+     */
+    setPinnedVersionsWarning(threshold: number, callback: ((realm: Realm, pinnedVersions: number) => void) | null): void;
+
     /**
      * Write a copy to destination path
      * @param path destination path
@@ -980,6 +1489,16 @@ declare class Realm {
      */
     writeCopyTo(path: string, encryptionKey?: ArrayBuffer | ArrayBufferView): void;
 
+    /**
+     * Write a copy to destination path or sink on a background thread
+     * @param target destination path, or a function called with each chunk of the copy
+     * @param encryptionKey encryption key to use
+     * @param options the bytes per second budget and a progress callback
+     * @returns Promise<number>
+     */
+    writeCopyToAsync(target: string | ((chunk: ArrayBuffer) => void | Promise<void>), encryptionKey?: ArrayBuffer | ArrayBufferView, options?: Realm.WriteCopyOptions): CancellablePromise<number>;
+    writeCopyToAsync(target: string | ((chunk: ArrayBuffer) => void | Promise<void>), options?: Realm.WriteCopyOptions): CancellablePromise<number>;
+
     privileges(): Realm.Permissions.RealmPrivileges;
     privileges(objectType: string | Realm.ObjectSchema | Function): Realm.Permissions.ClassPrivileges;
     privileges(obj: Realm.Object): Realm.Permissions.ObjectPrivileges;
@@ -988,6 +1507,7 @@ declare class Realm {
     permissions(objectType: string | Realm.ObjectSchema | Function): Realm.Permissions.Class;
 
     subscriptions(name?: string): Realm.Results<NamedSubscription>;
+    subscribeAll(subscriptions: Realm.Sync.SubscriptionRequest[]): Realm.Sync.SubscriptionGroup;
     unsubscribe(name: string): void;
 
     /**
@@ -115,9 +115,10 @@ const realmConstructor = getRealmConstructor(context);
 
 require('./extensions')(realmConstructor, context);
 
-if (realmConstructor.Sync) {
+// Reading Realm.Sync here would create it, so the notifier is only added once it is.
+if ('Sync' in realmConstructor) {
     if (context === 'node.js') {
-      nodeRequire('./notifier')(realmConstructor);
+      realmConstructor._syncSetups.push(() => nodeRequire('./notifier')(realmConstructor));
       if (!realmConstructor.Worker) {
           Object.defineProperty(realmConstructor, 'Worker', { value: nodeRequire('./worker') });
       }
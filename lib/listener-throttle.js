@@ -0,0 +1,395 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2020 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+'use strict';
+
+// Number of elements in the sorted array `indices` which are less than `value`.
+function countLess(indices, value) {
+    let low = 0, high = indices.length;
+    while (low < high) {
+        const mid = (low + high) >>> 1;
+        if (indices[mid] < value) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+function contains(indices, value) {
+    const i = countLess(indices, value);
+    return i < indices.length && indices[i] === value;
+}
+
+// The `rank`th index, counting from zero, which is not in the sorted array `skipped`.
+function nthNotIn(skipped, rank) {
+    let index = rank;
+    for (const skip of skipped) {
+        if (skip > index) {
+            break;
+        }
+        index++;
+    }
+    return index;
+}
+
+// Maps an index in the collection before `change` to its index after it. The row must not have been deleted.
+function mapForward(change, index) {
+    return nthNotIn(change.insertions, index - countLess(change.deletions, index));
+}
+
+// Maps an index in the collection after `change` to its index before it. The row must not have been inserted.
+function mapBackward(change, index) {
+    return nthNotIn(change.deletions, index - countLess(change.insertions, index));
+}
+
+function sortedUnique(indices) {
+    indices.sort((a, b) => a - b);
+    return indices.filter((index, i) => i === 0 || indices[i - 1] !== index);
+}
+
+function toArrays(changes) {
+    const deletions = Array.from(changes.deletions);
+    return {
+        all: deletions.length === 1 && deletions[0] === null,
+        deletions: deletions,
+        insertions: Array.from(changes.insertions),
+        newModifications: Array.from(changes.newModifications),
+    };
+}
+
+/**
+ * Combines the change sets of two consecutive notifications into the change set between the
+ * version before the first and the version after the second. Both arguments and the result
+ * have plain arrays for `deletions`, `insertions` and `newModifications`, and `all` set if
+ * everything was deleted.
+ */
+function mergeChangeSets(first, second) {
+    if (second.all) {
+        return second;
+    }
+
+    const insertions = second.insertions.slice();
+    for (const index of first.insertions) {
+        if (!contains(second.deletions, index)) {
+            insertions.push(mapForward(second, index));
+        }
+    }
+
+    const deletions = first.deletions.slice();
+    if (!first.all) {
+        for (const index of second.deletions) {
+            if (!contains(first.insertions, index)) {
+                deletions.push(mapBackward(first, index));
+            }
+        }
+    }
+
+    const merged = {
+        all: first.all,
+        deletions: first.all ? first.deletions : sortedUnique(deletions),
+        insertions: sortedUnique(insertions),
+    };
+
+    const modifications = second.newModifications.filter((index) => !contains(merged.insertions, index));
+    for (const index of first.newModifications) {
+        if (!contains(second.deletions, index) && !contains(first.insertions, index)) {
+            modifications.push(mapForward(second, index));
+        }
+    }
+    merged.newModifications = sortedUnique(modifications);
+    return merged;
+}
+
+function toRanges(indices) {
+    const ranges = [];
+    for (const index of indices) {
+        const last = ranges[ranges.length - 1];
+        if (last && last[0] + last[1] === index) {
+            last[1]++;
+        } else {
+            ranges.push([index, 1]);
+        }
+    }
+    return ranges;
+}
+
+// Builds the change set passed to listeners from a merged one.
+function toChangeSet(merged, format) {
+    const oldModifications = merged.all ? [] : merged.newModifications.map((index) => {
+        // Modified rows were there before, so only deletions and insertions moved them.
+        return nthNotIn(merged.deletions, index - countLess(merged.insertions, index));
+    });
+
+    const convert = (indices) => {
+        if (format === 'int32Array') {
+            return Int32Array.from(indices);
+        }
+        if (format === 'ranges') {
+            return toRanges(indices);
+        }
+        return indices;
+    };
+
+    const modifications = convert(oldModifications);
+    return {
+        deletions: merged.all ? [null] : convert(merged.deletions),
+        insertions: convert(merged.insertions),
+        modifications: modifications,
+        oldModifications: modifications,
+        newModifications: convert(merged.newModifications),
+    };
+}
+
+function validatedOptions(options) {
+    const result = {};
+    for (const name of ['minInterval', 'maxDelay']) {
+        const value = options[name];
+        if (value !== undefined && (typeof value !== 'number' || value < 0)) {
+            throw new TypeError(`'${name}' must be a non-negative number.`);
+        }
+        result[name] = value;
+    }
+    result.changeSetFormat = options.changeSetFormat;
+    return result;
+}
+
+// Native methods exposed through JavaScriptCore are read-only and cannot be wrapped.
+function canReplace(prototype) {
+    return ['addListener', 'removeListener', 'removeAllListeners'].every((name) => {
+        const descriptor = Object.getOwnPropertyDescriptor(prototype, name);
+        return !descriptor || descriptor.configurable;
+    });
+}
+
+function isThrottled(options) {
+    return !!options && (options.minInterval !== undefined || options.maxDelay !== undefined);
+}
+
+/**
+ * Calls `deliver` at most once every `minInterval` milliseconds. Calls in between are coalesced
+ * with `merge`, and are delivered no later than `maxDelay` milliseconds after the first of them.
+ */
+class Throttle {
+    constructor(options, deliver, merge) {
+        this.minInterval = options.minInterval || 0;
+        this.maxDelay = options.maxDelay === undefined ? Infinity : options.maxDelay;
+        this.deliver = deliver;
+        this.merge = merge;
+        this.lastDelivery = -Infinity;
+        this.pending = undefined;
+        this.timer = null;
+    }
+
+    push(value) {
+        const now = Date.now();
+        if (this.timer === null && now - this.lastDelivery >= this.minInterval) {
+            this.lastDelivery = now;
+            this.deliver(value);
+            return;
+        }
+
+        this.pending = this.pending === undefined ? value : this.merge(this.pending, value);
+        if (this.timer === null) {
+            const delay = Math.min(this.maxDelay, Math.max(0, this.lastDelivery + this.minInterval - now));
+            this.timer = setTimeout(() => this.flush(), delay);
+        }
+    }
+
+    flush() {
+        this.timer = null;
+        const value = this.pending;
+        this.pending = undefined;
+        this.lastDelivery = Date.now();
+        this.deliver(value);
+    }
+
+    cancel() {
+        if (this.timer !== null) {
+            clearTimeout(this.timer);
+            this.timer = null;
+        }
+        this.pending = undefined;
+    }
+}
+
+// Throttled wrappers of listener callbacks, per observed object and callback.
+const throttledListeners = new WeakMap();
+
+function registerWrapper(target, key, callback, wrapper) {
+    let wrappers = throttledListeners.get(target);
+    if (!wrappers) {
+        wrappers = new Map();
+        throttledListeners.set(target, wrappers);
+    }
+    const id = key + '\0';
+    if (!wrappers.has(id)) {
+        wrappers.set(id, new Map());
+    }
+    wrappers.get(id).set(callback, wrapper);
+}
+
+// Removes and returns the wrapper of `callback`, or all wrappers if `callback` is undefined.
+function takeWrappers(target, key, callback) {
+    const wrappers = throttledListeners.get(target);
+    const taken = [];
+    if (!wrappers) {
+        return taken;
+    }
+    for (const [id, callbacks] of wrappers) {
+        if (key !== undefined && id !== key + '\0') {
+            continue;
+        }
+        for (const [original, wrapper] of callbacks) {
+            if (callback === undefined || original === callback) {
+                wrapper.throttle.cancel();
+                taken.push(wrapper);
+                callbacks.delete(original);
+            }
+        }
+    }
+    return taken;
+}
+
+/**
+ * Replaces the listener methods of a collection prototype with ones which accept the
+ * `minInterval` and `maxDelay` options.
+ */
+function installCollectionListeners(prototype) {
+    if (!canReplace(prototype)) {
+        return;
+    }
+
+    const addListener = prototype.addListener;
+    const removeListener = prototype.removeListener;
+    const removeAllListeners = prototype.removeAllListeners;
+
+    Object.defineProperties(prototype, {
+        addListener: {
+            value: function(callback, options) {
+                if (!isThrottled(options)) {
+                    return addListener.apply(this, arguments);
+                }
+                if (typeof callback !== 'function') {
+                    throw new TypeError('Listener callback must be a function.');
+                }
+
+                const validated = validatedOptions(options);
+                const format = validated.changeSetFormat;
+                const nativeOptions = Object.assign({}, options, { changeSetFormat: 'array' });
+                delete nativeOptions.minInterval;
+                delete nativeOptions.maxDelay;
+
+                const throttle = new Throttle(validated, (value) => {
+                    callback(value.collection, toChangeSet(value.changes, format));
+                }, (pending, value) => {
+                    return { collection: value.collection, changes: mergeChangeSets(pending.changes, value.changes) };
+                });
+                const wrapper = (collection, changes) => throttle.push({ collection, changes: toArrays(changes) });
+                wrapper.throttle = throttle;
+
+                takeWrappers(this, '', callback).forEach((old) => removeListener.call(this, old));
+                registerWrapper(this, '', callback, wrapper);
+                return addListener.call(this, wrapper, nativeOptions);
+            },
+            configurable: true,
+            writable: true,
+        },
+        removeListener: {
+            value: function(callback) {
+                takeWrappers(this, '', callback).forEach((wrapper) => removeListener.call(this, wrapper));
+                return removeListener.apply(this, arguments);
+            },
+            configurable: true,
+            writable: true,
+        },
+        removeAllListeners: {
+            value: function() {
+                takeWrappers(this);
+                return removeAllListeners.apply(this, arguments);
+            },
+            configurable: true,
+            writable: true,
+        },
+    });
+}
+
+/**
+ * Replaces the listener methods of the Realm prototype with ones which accept the
+ * `minInterval` and `maxDelay` options. Coalesced notifications are delivered once.
+ */
+function installRealmListeners(prototype) {
+    if (!canReplace(prototype)) {
+        return;
+    }
+
+    const addListener = prototype.addListener;
+    const removeListener = prototype.removeListener;
+    const removeAllListeners = prototype.removeAllListeners;
+
+    Object.defineProperties(prototype, {
+        addListener: {
+            value: function(name, callback, options) {
+                // The options are validated natively, as they are where the methods can't be replaced.
+                if (!isThrottled(options)) {
+                    return addListener.apply(this, arguments);
+                }
+                if (typeof callback !== 'function') {
+                    throw new TypeError('Listener callback must be a function.');
+                }
+
+                const throttle = new Throttle(validatedOptions(options), (args) => {
+                    callback.apply(undefined, args);
+                }, (pending, args) => args);
+                const wrapper = function() {
+                    throttle.push(Array.prototype.slice.call(arguments));
+                };
+                wrapper.throttle = throttle;
+
+                takeWrappers(this, name, callback).forEach((old) => removeListener.call(this, name, old));
+                registerWrapper(this, name, callback, wrapper);
+                return addListener.call(this, name, wrapper);
+            },
+            configurable: true,
+            writable: true,
+        },
+        removeListener: {
+            value: function(name, callback) {
+                takeWrappers(this, name, callback).forEach((wrapper) => removeListener.call(this, name, wrapper));
+                return removeListener.apply(this, arguments);
+            },
+            configurable: true,
+            writable: true,
+        },
+        removeAllListeners: {
+            value: function(name) {
+                takeWrappers(this, name);
+                return removeAllListeners.apply(this, arguments);
+            },
+            configurable: true,
+            writable: true,
+        },
+    });
+}
+
+module.exports = {
+    installCollectionListeners,
+    installRealmListeners,
+    mergeChangeSets,
+};
@@ -23,12 +23,34 @@ const nodeRequire = require;
 
 const Worker = nodeRequire('./worker');
 
+// The number of changed Realms whose change sets are computed together, in parallel.
+const changeBatchSize = 64;
+
+// Whether any of the classes is changed, where no classes means all of them.
+function hasChangedClass(changes, classNames) {
+    if (!classNames) {
+        return true;
+    }
+    const changed = changes.changes;
+    return classNames.some((name) => changed[name] !== undefined);
+}
+
+// Whether a listener observes the Realm at `path`: its regex must match, and if
+// it has a native filter, the filter must have accepted the Realm when the
+// server reported it.
+function acceptsPath(listener, path) {
+    return listener.regex.test(path) && (!listener.filtered || listener.accepted[path] === true);
+}
+
 class FunctionListener {
-    constructor(regex, regexStr, event, fn) {
+    constructor(regex, regexStr, event, fn, classNames, filtered) {
         this.regex = regex;
         this.regexStr = regexStr;
         this.event = event;
         this.fn = fn;
+        this.classNames = classNames;
+        this.filtered = filtered;
+        this.accepted = {};
         this.seen = {};
         this.pending = [];
     }
@@ -42,7 +64,7 @@ class FunctionListener {
     }
 
     onavailable(path, id) {
-        if (this.regex.test(path)) {
+        if (acceptsPath(this, path)) {
             if (this.event === 'available' && !this.seen[id]) {
                 this.fn(path);
                 this.seen[id] = true;
@@ -74,7 +96,7 @@ class FunctionListener {
     }
 
     onchange(changes) {
-        if (this.event !== 'change' || !this.regex.test(changes.path)) {
+        if (this.event !== 'change' || !acceptsPath(this, changes.path)) {
             changes.release();
             return;
         }
@@ -82,12 +104,16 @@ class FunctionListener {
             changes.release();
             return;
         }
+        if (!hasChangedClass(changes, this.classNames)) {
+            changes.release();
+            return;
+        }
 
         this.invoke(changes, changes);
     }
 
     ondelete(changes) {
-        if (this.event !== 'delete' || !this.regex.test(changes.path)) {
+        if (this.event !== 'delete' || !acceptsPath(this, changes.path)) {
             changes.release();
             return;
         }
@@ -97,10 +123,13 @@ class FunctionListener {
 }
 
 class OutOfProcListener {
-    constructor(regex, regexStr, worker) {
+    constructor(regex, regexStr, worker, classNames, filtered) {
         this.regex = regex;
         this.regexStr = regexStr;
         this.worker = worker;
+        this.classNames = classNames;
+        this.filtered = filtered;
+        this.accepted = {};
         this.seen = {};
     }
 
@@ -113,7 +142,7 @@ class OutOfProcListener {
     }
 
     onavailable(path, id) {
-        if (this.regex.test(path)) {
+        if (acceptsPath(this, path)) {
             if (!this.seen[id]) {
                 this.worker.onavailable(path);
                 this.seen[id] = true;
@@ -124,14 +153,16 @@ class OutOfProcListener {
     }
 
     onchange(changes) {
-        if (!this.regex.test(changes.path)) {
+        if (!acceptsPath(this, changes.path) || !hasChangedClass(changes, this.classNames)) {
+            changes.release();
             return;
         }
         this.worker.onchange(changes);
     }
 
     ondelete(changes) {
-        if (!this.regex.test(changes.path)) {
+        if (!acceptsPath(this, changes.path)) {
+            changes.release();
             return;
         }
         this.worker.ondelete(changes);
@@ -140,7 +171,7 @@ class OutOfProcListener {
 
 class Listener {
     constructor(Sync, config) {
-        this.notifier = Sync._createNotifier(config.serverUrl, config.adminUser, (event, a1, a2) => this[event](a1, a2), config.sslConfiguration, config.listenerDirectory);
+        this.notifier = Sync._createNotifier(config.serverUrl, config.adminUser, (event, a1, a2, a3) => this[event](a1, a2, a3), config.sslConfiguration, config.listenerDirectory);
         this.initPromises = [];
         this.callbacks = [];
     }
@@ -158,10 +189,12 @@ class Listener {
     }
 
     change() {
-        const changes = this.notifier.next();
-        if (!changes) {
-            return;
+        for (const changes of this.notifier.nextBatch(changeBatchSize, this._classNames())) {
+            this._dispatch(changes);
         }
+    }
+
+    _dispatch(changes) {
         let refCount = 1;
         changes.release = () => {
             if (--refCount === 0) {
@@ -176,10 +209,17 @@ class Listener {
         changes.release();
     }
 
-    available(virtualPath, id) {
+    // `filterIds` are the ids of the native filters which accepted the Realm.
+    available(virtualPath, id, filterIds) {
         let watch = false;
         id = id || virtualPath;
         for (const callback of this.callbacks) {
+            if (filterIds.indexOf(callback.filterId) === -1) {
+                continue;
+            }
+            if (callback.filtered) {
+                callback.accepted[virtualPath] = true;
+            }
             if (callback.onavailable(virtualPath, id)) {
                 watch = true;
             }
@@ -188,18 +228,31 @@ class Listener {
     }
 
     // public API implementation
-    add(regexStr, event, fn) {
+    add(regexStr, event, fn, classNames, filter) {
         const regex = new RegExp(regexStr);
+        if (classNames !== undefined && !Array.isArray(classNames)) {
+            throw new Error(`Invalid arguments: classNames must be an array of strings, got ${classNames}`);
+        }
+        if (classNames && classNames.length === 0) {
+            // An empty list is taken to mean all classes.
+            classNames = undefined;
+        }
 
+        let callback;
+        const filtered = filter !== undefined;
         if (typeof fn === 'function') {
-            this.callbacks.push(new FunctionListener(regex, regexStr, event, fn));
+            callback = new FunctionListener(regex, regexStr, event, fn, classNames, filtered);
         }
         else if (event instanceof Worker) {
-            this.callbacks.push(new OutOfProcListener(regex, regexStr, event));
+            callback = new OutOfProcListener(regex, regexStr, event, classNames, filtered);
         }
         else {
             throw new Error(`Invalid arguments: must supply either event name and callback function or a Worker, got (${event}, ${fn})`);
         }
+        // Each listener's filter is evaluated natively on its own, so one
+        // listener's filter never hides Realms from the others.
+        callback.filterId = this.notifier._filters.add(filter);
+        this.callbacks.push(callback);
 
         const promise = new Promise((resolve, reject) => {
             this.initPromises.push([resolve, reject]);
@@ -212,6 +265,7 @@ class Listener {
     remove(regex, event, callback) {
         for (let i = 0; i < this.callbacks.length; ++i) {
             if (this.callbacks[i].matches(regex, event, callback)) {
+                this.notifier._filters.remove(this.callbacks[i].filterId);
                 const ret = this.callbacks[i].stop();
                 this.callbacks.splice(i, 1);
                 return ret;
@@ -221,6 +275,9 @@ class Listener {
     }
 
     removeAll() {
+        for (const callback of this.callbacks) {
+            this.notifier._filters.remove(callback.filterId);
+        }
         let ret = Promise.all(this.callbacks.map(c => c.stop()));
         this.callbacks = [];
         return ret;
@@ -231,6 +288,19 @@ class Listener {
     }
 
     // helpers
+
+    // The classes changes are reported for, or undefined if a callback wants all of them.
+    _classNames() {
+        const classNames = new Set();
+        for (const callback of this.callbacks) {
+            if (!callback.classNames) {
+                return undefined;
+            }
+            callback.classNames.forEach((name) => classNames.add(name));
+        }
+        return Array.from(classNames);
+    }
+
     _notifyDownloadComplete() {
         if (!this.initComplete) {
             return;
@@ -276,7 +346,7 @@ function addListener(server, user, regex, event, callback) {
     if (!listener) {
         listener = new Listener(this, _config);
     }
-    return listener.add(_config.filterRegex, _event, _callback);
+    return listener.add(_config.filterRegex, _event, _callback, _config.classNames, _config.filter);
 }
 
 function removeListener(regex, event, callback) {
@@ -26,6 +26,8 @@ import com.facebook.react.bridge.ReactApplicationContext;
 import com.facebook.react.bridge.ReactContextBaseJavaModule;
 import com.facebook.soloader.SoLoader;
 
+import java.io.ByteArrayInputStream;
+import java.io.DataInputStream;
 import java.io.IOException;
 import java.net.InetAddress;
 import java.net.NetworkInterface;
@@ -42,6 +44,7 @@ import fi.iki.elonen.NanoHTTPD;
 
 class RealmReactModule extends ReactContextBaseJavaModule {
     private static final int DEFAULT_PORT = 8083;
+    private static final String MSGPACK_CONTENT_TYPE = "application/x-msgpack";
     private static boolean sentAnalytics = false;
 
     private AndroidWebServer webServer;
@@ -197,6 +200,33 @@ class RealmReactModule extends ReactContextBaseJavaModule {
         @Override
         public Response serve(IHTTPSession session) {
             final String cmdUri = session.getUri();
+
+            // MessagePack requests aren't "simple" cross-origin requests, so the debugger sends a preflight first.
+            if (session.getMethod() == Method.OPTIONS) {
+                Response response = newFixedLengthResponse("");
+                response.addHeader("Access-Control-Allow-Origin", "http://localhost:8081");
+                response.addHeader("Access-Control-Allow-Methods", "POST");
+                response.addHeader("Access-Control-Allow-Headers", "Content-Type");
+                response.addHeader("Access-Control-Max-Age", "86400");
+                return response;
+            }
+
+            // Clients which negotiated MessagePack send binary bodies, which must not be decoded as text.
+            final String contentType = session.getHeaders().get("content-type");
+            if (contentType != null && contentType.startsWith(MSGPACK_CONTENT_TYPE)) {
+                byte[] responseBody;
+                try {
+                    responseBody = processChromeDebugCommandBinary(cmdUri, readBody(session));
+                } catch (IOException e) {
+                    e.printStackTrace();
+                    responseBody = new byte[0];
+                }
+                Response response = newFixedLengthResponse(Response.Status.OK, MSGPACK_CONTENT_TYPE,
+                        new ByteArrayInputStream(responseBody), responseBody.length);
+                response.addHeader("Access-Control-Allow-Origin", "http://localhost:8081");
+                return response;
+            }
+
             final HashMap<String, String> map = new HashMap<String, String>();
             try {
                 session.parseBody(map);
@@ -217,6 +247,13 @@ class RealmReactModule extends ReactContextBaseJavaModule {
             response.addHeader("Access-Control-Allow-Origin", "http://localhost:8081");
             return response;
         }
+
+        private byte[] readBody(IHTTPSession session) throws IOException {
+            final String contentLength = session.getHeaders().get("content-length");
+            byte[] body = new byte[contentLength == null ? 0 : Integer.parseInt(contentLength)];
+            new DataInputStream(session.getInputStream()).readFully(body);
+            return body;
+        }
     }
 
     // return true if the Realm API was injected (return false when running in Chrome Debug)
@@ -234,6 +271,9 @@ class RealmReactModule extends ReactContextBaseJavaModule {
     // this receives one command from Chrome debug then return the processing we should post back
     private native String processChromeDebugCommand(String cmd, String args);
 
+    // same as processChromeDebugCommand, for commands encoded as MessagePack
+    private native byte[] processChromeDebugCommandBinary(String cmd, byte[] args);
+
     // this receives one command from Chrome debug then return the processing we should post back
     private native boolean tryRunTask();
 }
@@ -39,8 +39,10 @@
 #import "GCDWebServerDataResponse.h"
 #import "GCDWebServerErrorResponse.h"
 #import "rpc.hpp"
+#import "rpc_websocket.hpp"
 
 #define WEB_SERVER_PORT 8083
+#define WEB_SOCKET_PORT 8084
 
 using namespace realm::rpc;
 #endif
@@ -91,6 +93,7 @@ extern "C" JSGlobalContextRef RealmReactGetJSGlobalContextForExecutor(id executo
 #if DEBUG
     GCDWebServer *_webServer;
     std::unique_ptr<RPCServer> _rpcServer;
+    std::unique_ptr<RPCWebSocketServer> _webSocketServer;
 #endif
 }
 
@@ -230,18 +233,21 @@ RCT_REMAP_METHOD(emit, emitEvent:(NSString *)eventName withObject:(id)object) {
         try {
             NSData *responseData;
 
+            // Clients which negotiated MessagePack send binary bodies and expect binary responses.
+            RPCEncoding encoding = RPCServer::encoding_for_content_type(request.contentType ? request.contentType.UTF8String : "");
             if (rpcServer) {
-                json args = json::parse([[(GCDWebServerDataRequest *)request text] UTF8String]);
-                std::string responseText = rpcServer->perform_request(request.path.UTF8String, std::move(args)).dump();
+                NSData *requestData = [(GCDWebServerDataRequest *)request data];
+                std::string body((const char *)requestData.bytes, requestData.length);
+                std::string responseBody = rpcServer->perform_request(request.path.UTF8String, body, encoding);
 
-                responseData = [NSData dataWithBytes:responseText.c_str() length:responseText.length()];
+                responseData = [NSData dataWithBytes:responseBody.data() length:responseBody.length()];
             }
             else {
                 // we have been deallocated
                 responseData = [NSData data];
             }
 
-            response = [[GCDWebServerDataResponse alloc] initWithData:responseData contentType:@"application/json"];
+            response = [[GCDWebServerDataResponse alloc] initWithData:responseData contentType:@(RPCServer::content_type(encoding))];
         }
         catch(std::exception &ex) {
             NSLog(@"Invalid RPC request - %@", [(GCDWebServerDataRequest *)request text]);
@@ -254,7 +260,27 @@ RCT_REMAP_METHOD(emit, emitEvent:(NSString *)eventName withObject:(id)object) {
         return response;
     }];
 
+    // MessagePack requests aren't "simple" cross-origin requests, so the debugger sends a preflight first
+    [_webServer addDefaultHandlerForMethod:@"OPTIONS"
+                              requestClass:[GCDWebServerRequest class]
+                              processBlock:^GCDWebServerResponse *(GCDWebServerRequest* request) {
+        GCDWebServerResponse *response = [GCDWebServerResponse response];
+        [response setValue:@"http://localhost:8081" forAdditionalHeader:@"Access-Control-Allow-Origin"];
+        [response setValue:@"POST" forAdditionalHeader:@"Access-Control-Allow-Methods"];
+        [response setValue:@"Content-Type" forAdditionalHeader:@"Access-Control-Allow-Headers"];
+        [response setValue:@"86400" forAdditionalHeader:@"Access-Control-Max-Age"];
+        return response;
+    }];
+
     [_webServer startWithPort:WEB_SERVER_PORT bonjourName:nil];
+
+    // The debugger falls back to polling over HTTP if it can't connect to the WebSocket server
+    try {
+        _webSocketServer = std::make_unique<RPCWebSocketServer>(*_rpcServer, WEB_SOCKET_PORT);
+    }
+    catch (std::exception &ex) {
+        NSLog(@"Failed to start the RPC WebSocket server - %s", ex.what());
+    }
     return;
 }
 
@@ -262,6 +288,7 @@ RCT_REMAP_METHOD(emit, emitEvent:(NSString *)eventName withObject:(id)object) {
     [_webServer stop];
     [_webServer removeAllHandlers];
     _webServer = nil;
+    _webSocketServer.reset();
     _rpcServer.reset();
 }
 #endif
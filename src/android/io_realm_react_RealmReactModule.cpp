@@ -22,6 +22,7 @@
 
 #include "io_realm_react_RealmReactModule.h"
 #include "rpc.hpp"
+#include "rpc_websocket.hpp"
 #include "platform.hpp"
 #include "jni_utils.hpp"
 #include "hack.hpp"
@@ -30,6 +31,8 @@ using namespace realm::rpc;
 using namespace realm::jni_util;
 
 static RPCServer *s_rpc_server;
+static RPCWebSocketServer *s_websocket_server;
+static const uint16_t s_websocket_port = 8084;
 extern bool realmContextInjected;
 jclass ssl_helper_class;
 
@@ -94,10 +97,20 @@ JNIEXPORT jlong JNICALL Java_io_realm_react_RealmReactModule_setupChromeDebugMod
   (JNIEnv *, jclass)
 {
     __android_log_print(ANDROID_LOG_VERBOSE, "JSRealm", "setupChromeDebugModeRealmJsContext");
+    delete s_websocket_server;
+    s_websocket_server = nullptr;
     if (s_rpc_server) {
         delete s_rpc_server;
     }
     s_rpc_server = new RPCServer();
+
+    // The debugger falls back to polling over HTTP if it can't connect to the WebSocket server
+    try {
+        s_websocket_server = new RPCWebSocketServer(*s_rpc_server, s_websocket_port);
+    }
+    catch (std::exception& e) {
+        __android_log_print(ANDROID_LOG_ERROR, "JSRealm", "Failed to start the RPC WebSocket server: %s", e.what());
+    }
     return (jlong)s_rpc_server;
 }
 
@@ -112,6 +125,20 @@ JNIEXPORT jstring JNICALL Java_io_realm_react_RealmReactModule_processChromeDebu
     return env->NewStringUTF(response.dump().c_str());
 }
 
+JNIEXPORT jbyteArray JNICALL Java_io_realm_react_RealmReactModule_processChromeDebugCommandBinary
+  (JNIEnv *env, jclass, jstring chrome_cmd, jbyteArray chrome_args)
+{
+    const char* cmd = env->GetStringUTFChars(chrome_cmd, NULL);
+    std::string args(env->GetArrayLength(chrome_args), '\0');
+    env->GetByteArrayRegion(chrome_args, 0, jsize(args.size()), reinterpret_cast<jbyte*>(&args[0]));
+    std::string response = s_rpc_server->perform_request(cmd, args, RPCEncoding::MessagePack);
+    env->ReleaseStringUTFChars(chrome_cmd, cmd);
+
+    jbyteArray result = env->NewByteArray(jsize(response.size()));
+    env->SetByteArrayRegion(result, 0, jsize(response.size()), reinterpret_cast<const jbyte*>(response.data()));
+    return result;
+}
+
 JNIEXPORT jboolean JNICALL Java_io_realm_react_RealmReactModule_tryRunTask
 (JNIEnv *env, jclass)
 {
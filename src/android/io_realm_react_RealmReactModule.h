@@ -29,6 +29,13 @@ JNIEXPORT jlong JNICALL Java_io_realm_react_RealmReactModule_setupChromeDebugMod
 JNIEXPORT jstring JNICALL Java_io_realm_react_RealmReactModule_processChromeDebugCommand
   (JNIEnv *, jclass, jstring, jstring);
 
+/*
+ * Class:     io_realm_react_RealmReactModule
+ * Method:    processChromeDebugCommandBinary
+ */
+JNIEXPORT jbyteArray JNICALL Java_io_realm_react_RealmReactModule_processChromeDebugCommandBinary
+  (JNIEnv *, jclass, jstring, jbyteArray);
+
 /*
  * Class:     io_realm_react_RealmReactModule
  * Method:    tryRunTask
@@ -17,9 +17,12 @@
 ////////////////////////////////////////////////////////////////////////////
 
 #include <string>
+#include <thread>
 #include <stdlib.h>
 #include <unistd.h>
 #include <cstdio>
+#include <fcntl.h>
+#include <sys/sendfile.h>
 #include <android/asset_manager.h>
 
 #include "../platform.hpp"
@@ -38,6 +41,48 @@ static inline bool is_realm_file(const char* str)
 static AAssetManager* s_asset_manager;
 static std::string s_default_realm_directory;
 
+// Assets which are stored uncompressed can be read straight out of the APK,
+// so they're copied by the kernel rather than through a buffer.
+enum class AssetCopy { Copied, Unsupported, Failed };
+
+static AssetCopy copy_uncompressed_asset(AAsset* asset, int out)
+{
+    off_t start = 0, length = 0;
+    int in = AAsset_openFileDescriptor(asset, &start, &length);
+    if (in < 0) {
+        return AssetCopy::Unsupported;
+    }
+
+    off_t offset = start;
+    off_t end = start + length;
+    AssetCopy result = AssetCopy::Copied;
+    while (offset < end) {
+        if (sendfile(out, in, &offset, end - offset) <= 0) {
+            // Nothing has been written if the kernel can't do this at all.
+            result = offset == start ? AssetCopy::Unsupported : AssetCopy::Failed;
+            break;
+        }
+    }
+    close(in);
+    return result;
+}
+
+static bool copy_streamed_asset(AAsset* asset, int out)
+{
+    char buf[64 * 1024];
+    int nb_read = 0;
+    while ((nb_read = AAsset_read(asset, buf, sizeof(buf))) > 0) {
+        for (int written = 0; written < nb_read;) {
+            ssize_t count = write(out, buf + written, nb_read - written);
+            if (count < 0) {
+                return false;
+            }
+            written += count;
+        }
+    }
+    return nb_read == 0;
+}
+
 namespace realm {
 
     void set_default_realm_file_directory(std::string dir)
@@ -67,21 +112,34 @@ namespace realm {
 
         while ((filename = AAssetDir_getNextFileName(assetDir)) != nullptr) {
             if (is_realm_file(filename)) {
-                AAsset* asset = AAssetManager_open(s_asset_manager, filename, AASSET_MODE_STREAMING);
-
-                char buf[BUFSIZ];
-                int nb_read = 0;
-
-                const char* dest_filename = (s_default_realm_directory + '/' + filename).c_str();
-                if (access(dest_filename, F_OK ) == -1) {
-                    // file doesn't exist, copy
-                    FILE* out = fopen(dest_filename, "w");
-                    while ((nb_read = AAsset_read(asset, buf, BUFSIZ)) > 0) {
-                        fwrite(buf, nb_read, 1, out);
-                    }
-                    fclose(out);
+                std::string dest_filename = s_default_realm_directory + '/' + filename;
+                if (access(dest_filename.c_str(), F_OK) != -1) {
+                    continue;
+                }
+
+                // The file is written next to its destination and renamed
+                // into place, so that an interrupted copy isn't mistaken
+                // for a bundled Realm on the next launch.
+                std::string temp_filename = dest_filename + ".copy";
+                int out = open(temp_filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+                if (out < 0) {
+                    continue;
+                }
+
+                bool copied = false;
+                if (AAsset* asset = AAssetManager_open(s_asset_manager, filename, AASSET_MODE_STREAMING)) {
+                    AssetCopy result = copy_uncompressed_asset(asset, out);
+                    copied = result == AssetCopy::Copied ||
+                             (result == AssetCopy::Unsupported && copy_streamed_asset(asset, out));
+                    AAsset_close(asset);
+                }
+
+                if (close(out) == 0 && copied) {
+                    rename(temp_filename.c_str(), dest_filename.c_str());
+                }
+                else {
+                    unlink(temp_filename.c_str());
                 }
-                AAsset_close(asset);
             }
         }
         AAssetDir_close(assetDir);
@@ -108,4 +166,9 @@ namespace realm {
         std::string cmd = "rm " + path;
         system(cmd.c_str());
     }
+
+    void run_file_work(std::function<void()> work)
+    {
+        std::thread(std::move(work)).detach();
+    }
 }
@@ -0,0 +1,212 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2020 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// Counts the calls from JS into the binding, and the time spent in them, per
+// method and accessor. Counting is off until enabled, which leaves a single
+// branch in each call, and building with REALM_JS_BOUNDARY_STATS=0 removes
+// even that.
+#ifndef REALM_JS_BOUNDARY_STATS
+#define REALM_JS_BOUNDARY_STATS 1
+#endif
+
+#if REALM_JS_BOUNDARY_STATS
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace realm {
+namespace js {
+
+struct BoundaryCounter {
+    std::atomic<uint64_t> calls{0};
+    std::atomic<uint64_t> nanoseconds{0};
+    std::atomic<bool> registered{false};
+};
+
+// Defined through a template so that the flag can be defined in this header,
+// and is initialized before any call can read it.
+template<typename = void>
+struct BoundaryStatsFlag {
+    static std::atomic<bool> enabled;
+};
+
+template<typename T>
+std::atomic<bool> BoundaryStatsFlag<T>::enabled{false};
+
+class BoundaryStats {
+  public:
+    struct Entry {
+        std::string name;
+        uint64_t calls;
+        uint64_t nanoseconds;
+    };
+
+    static BoundaryStats& shared() {
+        static BoundaryStats stats;
+        return stats;
+    }
+
+    static bool is_enabled() {
+        return BoundaryStatsFlag<>::enabled.load(std::memory_order_relaxed);
+    }
+
+    static void set_enabled(bool enabled) {
+        BoundaryStatsFlag<>::enabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    // The wrappers are named when the classes they belong to are set up,
+    // and their counters are registered the first time they are called
+    // while counting.
+    void set_name(const void* wrapper, std::string name) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_names[wrapper] = std::move(name);
+    }
+
+    void add_counter(const void* wrapper, BoundaryCounter& counter) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!counter.registered.exchange(true)) {
+            m_counters.emplace_back(wrapper, &counter);
+        }
+    }
+
+    // Returns the counters which have been called, along with the names of
+    // their wrappers.
+    std::vector<Entry> read() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::vector<Entry> entries;
+        entries.reserve(m_counters.size());
+        for (auto const& pair : m_counters) {
+            uint64_t calls = pair.second->calls.load(std::memory_order_relaxed);
+            if (!calls) {
+                continue;
+            }
+            auto name = m_names.find(pair.first);
+            entries.push_back({name == m_names.end() ? std::string("<unnamed>") : name->second, calls,
+                               pair.second->nanoseconds.load(std::memory_order_relaxed)});
+        }
+        return entries;
+    }
+
+    void reset() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto const& pair : m_counters) {
+            pair.second->calls.store(0, std::memory_order_relaxed);
+            pair.second->nanoseconds.store(0, std::memory_order_relaxed);
+        }
+    }
+
+  private:
+    std::mutex m_mutex;
+    std::unordered_map<const void*, std::string> m_names;
+    std::vector<std::pair<const void*, BoundaryCounter*>> m_counters;
+};
+
+// There is one counter per wrapper, which is initialized along with the
+// program rather than on first use, so that no guard is checked per call.
+template<typename WrapperType, WrapperType Wrapper>
+struct BoundaryCounterFor {
+    static BoundaryCounter counter;
+};
+
+template<typename WrapperType, WrapperType Wrapper>
+BoundaryCounter BoundaryCounterFor<WrapperType, Wrapper>::counter;
+
+class BoundaryTimer {
+  public:
+    BoundaryTimer(const void* wrapper, BoundaryCounter& counter)
+    : m_counter(counter), m_start(std::chrono::steady_clock::now()) {
+        if (!counter.registered.load(std::memory_order_relaxed)) {
+            BoundaryStats::shared().add_counter(wrapper, counter);
+        }
+    }
+
+    ~BoundaryTimer() {
+        auto elapsed = std::chrono::steady_clock::now() - m_start;
+        m_counter.calls.fetch_add(1, std::memory_order_relaxed);
+        m_counter.nanoseconds.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(),
+                                        std::memory_order_relaxed);
+    }
+
+  private:
+    BoundaryCounter& m_counter;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+template<typename WrapperType, WrapperType Wrapper, typename Call>
+inline void count_boundary_call(Call&& call) {
+    if (BoundaryStats::is_enabled()) {
+        BoundaryTimer timer(reinterpret_cast<const void*>(Wrapper), BoundaryCounterFor<WrapperType, Wrapper>::counter);
+        call();
+    }
+    else {
+        call();
+    }
+}
+
+template<typename Function>
+inline void name_boundary_wrapper(Function function, std::string name) {
+    if (function) {
+        BoundaryStats::shared().set_name(reinterpret_cast<const void*>(function), std::move(name));
+    }
+}
+
+// Names the wrappers of a class definition after the class, and the method
+// or accessor they are for.
+template<typename ClassType>
+inline void name_boundary_wrappers(ClassType const& definition) {
+    for (auto const& pair : definition.static_methods) {
+        name_boundary_wrapper(pair.second, definition.name + "." + pair.first);
+    }
+    for (auto const& pair : definition.static_properties) {
+        name_boundary_wrapper(pair.second.getter, definition.name + "." + pair.first);
+        name_boundary_wrapper(pair.second.setter, definition.name + "." + pair.first + "=");
+    }
+    for (auto const& pair : definition.methods) {
+        name_boundary_wrapper(pair.second, definition.name + "#" + pair.first);
+    }
+    for (auto const& pair : definition.properties) {
+        name_boundary_wrapper(pair.second.getter, definition.name + "#" + pair.first);
+        name_boundary_wrapper(pair.second.setter, definition.name + "#" + pair.first + "=");
+    }
+    name_boundary_wrapper(definition.index_accessor.getter, definition.name + "#get_index");
+    name_boundary_wrapper(definition.index_accessor.setter, definition.name + "#set_index");
+    name_boundary_wrapper(definition.string_accessor.getter, definition.name + "#get_property");
+    name_boundary_wrapper(definition.string_accessor.setter, definition.name + "#set_property");
+    name_boundary_wrapper(definition.string_accessor.enumerator, definition.name + "#get_property_names");
+}
+
+} // js
+} // realm
+
+// Runs the statement, counting it against the wrapper it is called from.
+#define REALM_JS_COUNT_BOUNDARY_CALL(WrapperType, wrapper, ...) \
+    ::realm::js::count_boundary_call<WrapperType, wrapper>([&] { __VA_ARGS__; })
+
+#else
+
+#define REALM_JS_COUNT_BOUNDARY_CALL(WrapperType, wrapper, ...) __VA_ARGS__
+
+#endif
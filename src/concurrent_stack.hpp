@@ -0,0 +1,171 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2020 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#elif defined(__APPLE__)
+#include <dispatch/dispatch.h>
+#else
+#include <condition_variable>
+#include <mutex>
+#endif
+
+#include <realm/util/optional.hpp>
+
+namespace realm {
+
+// Wakes up a thread waiting for items to be pushed. Wakeups are counted, so a
+// signal sent before the wait started is not lost. Waiters re-check their
+// condition afterwards, so spurious wakeups are harmless.
+class Wakeup {
+public:
+#if defined(__linux__)
+    Wakeup() : m_fd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) {}
+    ~Wakeup() { close(m_fd); }
+
+    void signal() {
+        uint64_t value = 1;
+        (void)write(m_fd, &value, sizeof(value));
+    }
+
+    void wait_for(std::chrono::milliseconds timeout) {
+        pollfd fd = {m_fd, POLLIN, 0};
+        if (poll(&fd, 1, int(timeout.count())) > 0) {
+            uint64_t value;
+            (void)read(m_fd, &value, sizeof(value));
+        }
+    }
+
+private:
+    int m_fd;
+#elif defined(__APPLE__)
+    Wakeup() : m_semaphore(dispatch_semaphore_create(0)) {}
+    ~Wakeup() { dispatch_release(m_semaphore); }
+
+    void signal() {
+        dispatch_semaphore_signal(m_semaphore);
+    }
+
+    void wait_for(std::chrono::milliseconds timeout) {
+        dispatch_semaphore_wait(m_semaphore, dispatch_time(DISPATCH_TIME_NOW, std::chrono::nanoseconds(timeout).count()));
+    }
+
+private:
+    dispatch_semaphore_t m_semaphore;
+#else
+    void signal() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_signals;
+        m_condition.notify_one();
+    }
+
+    void wait_for(std::chrono::milliseconds timeout) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_condition.wait_for(lock, timeout, [this] { return m_signals > 0; });
+        m_signals = 0;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    size_t m_signals = 0;
+#endif
+
+    Wakeup(const Wakeup&) = delete;
+    Wakeup& operator=(const Wakeup&) = delete;
+};
+
+// A lock-free stack which any number of threads can push to, and a single
+// thread at a time can pop from. Popping the most recently pushed item first
+// lets a task pushed while another one is running be handled before returning
+// to the outer one.
+//
+// As only one thread pops, a node can't be freed and reused while another
+// thread is reading its `next` pointer, so a plain compare-and-swap is safe.
+template <typename T>
+class ConcurrentStack {
+public:
+    ConcurrentStack() = default;
+    ConcurrentStack(const ConcurrentStack&) = delete;
+    ConcurrentStack& operator=(const ConcurrentStack&) = delete;
+
+    ~ConcurrentStack() {
+        Node* node = m_head.exchange(nullptr, std::memory_order_acquire);
+        while (node) {
+            Node* next = node->next;
+            delete node;
+            node = next;
+        }
+    }
+
+    void push(T&& item) {
+        Node* node = new Node{std::move(item), m_head.load(std::memory_order_relaxed)};
+        while (!m_head.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+        m_wakeup.signal();
+    }
+
+    util::Optional<T> try_pop() {
+        Node* node = m_head.load(std::memory_order_acquire);
+        while (node && !m_head.compare_exchange_weak(node, node->next, std::memory_order_acquire, std::memory_order_acquire)) {
+        }
+        if (!node) {
+            return util::none;
+        }
+
+        util::Optional<T> item(std::move(node->item));
+        delete node;
+        return item;
+    }
+
+    util::Optional<T> try_pop(std::chrono::milliseconds timeout) {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (true) {
+            if (auto item = try_pop()) {
+                return item;
+            }
+            auto now = std::chrono::steady_clock::now();
+            if (now >= deadline) {
+                return util::none;
+            }
+            m_wakeup.wait_for(std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now) + std::chrono::milliseconds(1));
+        }
+    }
+
+    bool empty() const {
+        return m_head.load(std::memory_order_acquire) == nullptr;
+    }
+
+private:
+    struct Node {
+        T item;
+        Node* next;
+    };
+
+    std::atomic<Node*> m_head{nullptr};
+    Wakeup m_wakeup;
+};
+
+} // realm
@@ -0,0 +1,139 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2020 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "impl/realm_coordinator.hpp"
+
+#include <realm/util/file.hpp>
+
+#include <cstring>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace realm {
+namespace js {
+
+// What removing the files of many Realms did, path by path.
+struct FileRemovalReport {
+    std::vector<std::string> removed;
+    // The Realms which were skipped because they are still open.
+    std::vector<std::string> skipped;
+    // The paths which couldn't be removed, with the reason why.
+    std::vector<std::pair<std::string, std::string>> failed;
+};
+
+// Removes the files of Realms which aren't open, on whichever thread calls
+// it. A Realm counts as open for as long as its coordinator is alive, which
+// it is until every instance of it has been closed. Failing to remove one
+// file doesn't stop the others from being removed.
+class FileRemover {
+  public:
+    // Removes the file of the Realm at `path` and the files next to it.
+    static void remove_realm(std::string const& path, FileRemovalReport& report) {
+        if (_impl::RealmCoordinator::get_existing_coordinator(path)) {
+            report.skipped.push_back(path);
+            return;
+        }
+        for (auto const& suffix : {"", ".lock", ".note"}) {
+            std::string file_path = path + suffix;
+            try {
+                if (util::File::try_remove(file_path)) {
+                    report.removed.push_back(file_path);
+                }
+            }
+            catch (std::exception const& e) {
+                report.failed.push_back({file_path, e.what()});
+            }
+        }
+        std::string management_path = path + ".management";
+        try {
+            if (util::try_remove_dir_recursive(management_path)) {
+                report.removed.push_back(management_path);
+            }
+        }
+        catch (std::exception const& e) {
+            report.failed.push_back({management_path, e.what()});
+        }
+    }
+
+    // Removes the files of every Realm in `directory`, and then the directory
+    // itself if nothing else is left in it. A missing directory is ignored.
+    static void remove_directory(std::string const& directory, FileRemovalReport& report) {
+        std::set<std::string> realm_paths;
+        try {
+            util::DirScanner scanner(directory, true);
+            std::string name;
+            while (scanner.next(name)) {
+                // Files left behind by a Realm which is gone are removed along
+                // with the Realm's own file.
+                for (auto const& suffix : {".realm", ".realm.lock", ".realm.note", ".realm.management"}) {
+                    if (ends_with(name, suffix)) {
+                        realm_paths.insert(join(directory, name.substr(0, name.size() - strlen(suffix)) + ".realm"));
+                        break;
+                    }
+                }
+            }
+        }
+        catch (std::exception const& e) {
+            report.failed.push_back({directory, e.what()});
+            return;
+        }
+
+        size_t skipped = report.skipped.size();
+        for (auto const& path : realm_paths) {
+            remove_realm(path, report);
+        }
+        if (report.skipped.size() != skipped) {
+            return;
+        }
+        try {
+            if (util::File::is_dir(directory) && is_empty(directory) && util::try_remove_dir(directory)) {
+                report.removed.push_back(directory);
+            }
+        }
+        catch (std::exception const& e) {
+            report.failed.push_back({directory, e.what()});
+        }
+    }
+
+  private:
+    static bool ends_with(std::string const& string, const char* suffix) {
+        size_t length = strlen(suffix);
+        return string.size() > length && string.compare(string.size() - length, length, suffix) == 0;
+    }
+
+    static std::string join(std::string const& directory, std::string const& name) {
+#if defined(WIN32) && WIN32
+        return directory + '\\' + name;
+#else
+        return directory + '/' + name;
+#endif
+    }
+
+    static bool is_empty(std::string const& directory) {
+        util::DirScanner scanner(directory, true);
+        std::string name;
+        return !scanner.next(name);
+    }
+};
+
+} // js
+} // realm
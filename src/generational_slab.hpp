@@ -0,0 +1,139 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2020 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace realm {
+
+// Stores values in a vector of slots, reusing the slots of erased values, and
+// hands out ids which combine the slot's index with a generation counter that
+// is bumped every time the slot is freed. Lookups are a bounds and generation
+// check, and an id which outlived its value never finds the value which
+// reused its slot.
+//
+// Ids are never 0 and stay below 2^53, so they can be passed to JavaScript
+// as numbers. T must be default constructible; erased slots are reset to T()
+// so that whatever they held is released right away.
+template <typename T>
+class GenerationalSlab {
+public:
+    using Id = uint64_t;
+
+    Id insert(T&& value) {
+        uint32_t index;
+        if (!m_free.empty()) {
+            index = m_free.back();
+            m_free.pop_back();
+        }
+        else {
+            index = static_cast<uint32_t>(m_slots.size());
+            m_slots.emplace_back();
+        }
+
+        Slot& slot = m_slots[index];
+        slot.value = std::move(value);
+        slot.occupied = true;
+        ++m_size;
+        return make_id(index, slot.generation);
+    }
+
+    T* get(Id id) {
+        Slot* slot = find(id);
+        return slot ? &slot->value : nullptr;
+    }
+
+    const T* get(Id id) const {
+        return const_cast<GenerationalSlab*>(this)->get(id);
+    }
+
+    bool erase(Id id) {
+        Slot* slot = find(id);
+        if (!slot) {
+            return false;
+        }
+        free(*slot, index_of(id));
+        return true;
+    }
+
+    // Erases the values for which `predicate(id, value)` returns true.
+    template <typename Predicate>
+    void erase_if(Predicate&& predicate) {
+        for (uint32_t index = 0; index < m_slots.size(); ++index) {
+            Slot& slot = m_slots[index];
+            if (slot.occupied && predicate(make_id(index, slot.generation), slot.value)) {
+                free(slot, index);
+            }
+        }
+    }
+
+    void clear() {
+        m_slots.clear();
+        m_free.clear();
+        m_size = 0;
+    }
+
+    size_t size() const {
+        return m_size;
+    }
+
+private:
+    // 21 bits of generation above 32 bits of index keep ids below 2^53.
+    static constexpr uint32_t max_generation = (1u << 21) - 1;
+
+    struct Slot {
+        T value;
+        uint32_t generation = 1;
+        bool occupied = false;
+    };
+
+    std::vector<Slot> m_slots;
+    std::vector<uint32_t> m_free;
+    size_t m_size = 0;
+
+    static Id make_id(uint32_t index, uint32_t generation) {
+        return (Id(generation) << 32) | index;
+    }
+
+    static uint32_t index_of(Id id) {
+        return static_cast<uint32_t>(id & 0xffffffff);
+    }
+
+    Slot* find(Id id) {
+        uint32_t index = index_of(id);
+        if (index >= m_slots.size()) {
+            return nullptr;
+        }
+        Slot& slot = m_slots[index];
+        return slot.occupied && slot.generation == (id >> 32) ? &slot : nullptr;
+    }
+
+    void free(Slot& slot, uint32_t index) {
+        slot.value = T();
+        slot.occupied = false;
+        slot.generation = slot.generation == max_generation ? 1 : slot.generation + 1;
+        m_free.push_back(index);
+        --m_size;
+    }
+};
+
+} // realm
@@ -0,0 +1,246 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2020 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "js_migration.hpp"
+
+#include "object_store.hpp"
+#include "shared_realm.hpp"
+
+#include <realm/group.hpp>
+#include <realm/group_shared.hpp>
+#include <realm/history.hpp>
+#include <realm/link_view.hpp>
+#include <realm/util/file.hpp>
+#include <realm/util/optional.hpp>
+#include <realm/util/scope_exit.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace realm {
+namespace js {
+
+// Writes snapshots of an in-memory Realm to a file, on a thread of its own
+// which reads the Realm through a SharedGroup of its own. Each snapshot is
+// written from the version that thread reads, so writers are never blocked,
+// and goes to a temporary file first, which then replaces the snapshot
+// before it. A snapshot is only written if the Realm changed since the one
+// before it, and once more when the writer is stopped.
+class InMemorySnapshotWriter {
+  public:
+    InMemorySnapshotWriter(Realm::Config const& config, std::string path, std::chrono::milliseconds interval)
+    : m_path(std::move(path))
+    , m_interval(interval)
+    , m_encryption_key(config.encryption_key)
+    , m_history(realm::make_in_realm_history(config.path))
+    , m_shared_group(*m_history, options(m_encryption_key)) {
+        m_thread = std::thread([this] { run(); });
+    }
+
+    ~InMemorySnapshotWriter() {
+        stop();
+    }
+
+    InMemorySnapshotWriter(InMemorySnapshotWriter const&) = delete;
+    InMemorySnapshotWriter& operator=(InMemorySnapshotWriter const&) = delete;
+
+    std::string const& path() const {
+        return m_path;
+    }
+
+    // The error of the last snapshot, if it failed.
+    util::Optional<std::string> last_error() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_last_error;
+    }
+
+    // Writes a last snapshot if the Realm changed, and waits for it.
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+            m_condition.notify_all();
+        }
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+    }
+
+  private:
+    std::string m_path;
+    std::chrono::milliseconds m_interval;
+    std::vector<char> m_encryption_key;
+    std::unique_ptr<Replication> m_history;
+    SharedGroup m_shared_group;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_stopping = false;
+    util::Optional<std::string> m_last_error;
+    bool m_written = false;
+    uint_fast64_t m_version = 0;
+    std::thread m_thread;
+
+    static SharedGroupOptions options(std::vector<char> const& encryption_key) {
+        SharedGroupOptions options;
+        options.durability = SharedGroupOptions::Durability::MemOnly;
+        options.encryption_key = encryption_key.empty() ? nullptr : encryption_key.data();
+        return options;
+    }
+
+    void run() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true) {
+            bool stopping = m_condition.wait_for(lock, m_interval, [&] { return m_stopping; });
+            lock.unlock();
+            write_if_changed();
+            lock.lock();
+            if (stopping) {
+                return;
+            }
+        }
+    }
+
+    // A snapshot which fails is tried again at the next interval, and the one
+    // before it is kept. Its error is kept until a snapshot succeeds.
+    void write_if_changed() {
+        try {
+            Group const& group = m_shared_group.begin_read();
+            auto end_read = util::make_scope_exit([&]() noexcept { m_shared_group.end_read(); });
+            uint_fast64_t version = m_shared_group.get_version_of_current_transaction().version;
+            if (m_written && version == m_version) {
+                return;
+            }
+
+            std::string temporary_path = m_path + ".snapshot";
+            util::File::try_remove(temporary_path);
+            group.write(temporary_path, m_encryption_key.empty() ? nullptr : m_encryption_key.data());
+            util::File::move(temporary_path, m_path);
+            m_version = version;
+            m_written = true;
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_last_error = util::none;
+        }
+        catch (std::exception const& e) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_last_error = std::string(e.what());
+        }
+    }
+};
+
+// Copies a snapshot into a Realm which is still empty, table by table and
+// column by column rather than object by object, for the object types and
+// properties the snapshot and the schema of the Realm have in common. The
+// snapshot is mapped into memory rather than read. Returns whether there
+// was a snapshot to copy.
+inline bool hydrate_from_snapshot(SharedRealm const& realm, std::string const& path) {
+    if (!util::File::exists(path) || !ObjectStore::is_empty(realm->read_group())) {
+        return false;
+    }
+    auto const& encryption_key = realm->config().encryption_key;
+    Group snapshot(path, encryption_key.empty() ? nullptr : encryption_key.data(), Group::mode_ReadOnly);
+
+    realm->begin_transaction();
+    try {
+        Group& group = realm->read_group();
+        std::vector<std::pair<ObjectSchema const*, std::pair<TableRef, TableRef>>> tables;
+        for (auto const& object_schema : realm->schema()) {
+            auto source = ObjectStore::table_for_object_type(snapshot, object_schema.name);
+            auto target = ObjectStore::table_for_object_type(group, object_schema.name);
+            if (source && target) {
+                // Every row is added before any link to it is.
+                target->add_empty_row(source->size());
+                tables.push_back({&object_schema, {source, target}});
+            }
+        }
+
+        for (auto const& entry : tables) {
+            Table& source = *entry.second.first;
+            Table& target = *entry.second.second;
+            for (auto const& property : entry.first->persisted_properties) {
+                size_t column = source.get_column_index(property.name);
+                size_t target_column = property.table_column;
+                if (column == realm::npos || source.get_column_type(column) != target.get_column_type(target_column) ||
+                    source.is_nullable(column) != target.is_nullable(target_column)) {
+                    continue;
+                }
+
+                DataType type = source.get_column_type(column);
+                if ((type == type_Link || type == type_LinkList) &&
+                    source.get_link_target(column)->get_name() != target.get_link_target(target_column)->get_name()) {
+                    continue;
+                }
+
+                Property source_property = property;
+                source_property.table_column = column;
+                for (size_t row = 0; row < source.size(); ++row) {
+                    if (type == type_Link) {
+                        if (!source.is_null_link(column, row)) {
+                            target.set_link(target_column, row, source.get_link(column, row));
+                        }
+                    }
+                    else if (type == type_LinkList) {
+                        auto links = source.get_linklist(column, row);
+                        if (links->size()) {
+                            auto target_links = target.get_linklist(target_column, row);
+                            for (size_t i = 0; i < links->size(); ++i) {
+                                target_links->add(links->get_target_row(i));
+                            }
+                        }
+                    }
+                    else if (type == type_Table) {
+                        // Lists of primitives are subtables of a single column.
+                        auto values = source.get_subtable(column, row);
+                        auto target_values = target.get_subtable(target_column, row);
+                        if (values->size() == 0 || values->is_nullable(0) != target_values->is_nullable(0)) {
+                            continue;
+                        }
+                        Property element = property;
+                        element.type = property.type & ~realm::PropertyType::Array;
+                        element.table_column = 0;
+                        target_values->add_empty_row(values->size());
+                        for (size_t i = 0; i < values->size(); ++i) {
+                            migration::write(*target_values, element, i, migration::read(*values, element, i));
+                        }
+                    }
+                    else {
+                        migration::write(target, property, row, migration::read(source, source_property, row));
+                    }
+                }
+            }
+        }
+        realm->commit_transaction();
+    }
+    catch (...) {
+        realm->cancel_transaction();
+        throw;
+    }
+    return true;
+}
+
+} // js
+} // realm
@@ -22,6 +22,8 @@
 
 #include <string>
 
+#include <sys/clonefile.h>
+
 #import <Foundation/Foundation.h>
 
 static NSString *error_description(NSError *error) {
@@ -98,8 +100,15 @@ void copy_bundled_realm_files()
                     continue;
                 }
 
+                // On APFS the file is cloned, which shares its blocks with the
+                // bundled file until either is written to, rather than copied.
+                NSString *bundledPath = [resourcePath stringByAppendingPathComponent:path];
+                if (clonefile(bundledPath.fileSystemRepresentation, docsPath.fileSystemRepresentation, 0) == 0) {
+                    continue;
+                }
+
                 NSError *error = nil;
-                if (![manager copyItemAtPath:[resourcePath stringByAppendingPathComponent:path] toPath:docsPath error:&error]) {
+                if (![manager copyItemAtPath:bundledPath toPath:docsPath error:&error]) {
                     throw std::runtime_error(util::format("Failed to copy file from \"%1\" to \"%2\": %3",
                                                           path.UTF8String, docsPath.UTF8String, error_description(error).UTF8String));
                 }
@@ -147,4 +156,11 @@ void remove_directory(const std::string &path)
     remove_file(path); // works for directories too
 }
 
+void run_file_work(std::function<void()> work)
+{
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        work();
+    });
+}
+
 }
@@ -0,0 +1,270 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2020 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "js_collection.hpp"
+#include "js_realm.hpp"
+#include "js_results.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace realm {
+namespace js {
+namespace benchmarks {
+
+// Allocations are only counted by drivers which replace the global operator
+// new, and only those made by the binding and core, as the engines allocate
+// their own heaps.
+inline std::atomic<uint64_t>& allocation_count() {
+    static std::atomic<uint64_t> count{0};
+    return count;
+}
+
+inline void count_allocation() {
+    allocation_count().fetch_add(1, std::memory_order_relaxed);
+}
+
+struct Result {
+    std::string name;
+    double ns_per_op;
+    double allocations_per_op;
+};
+
+struct NoHandleScope {
+    NoHandleScope() {}
+};
+
+// Runs the hot paths of the binding against an in-memory Realm, calling each
+// one directly rather than from JS so that only the cost of the binding and
+// core is measured. `HandleScope` is entered around each batch of calls, for
+// engines which need the values created by them to be released. The JS
+// objects which are called are held as plain values rather than protected,
+// so that the calls aren't measured along with unprotecting them, which means
+// that the runner has to be kept on the stack, and in the scope it was
+// created in.
+template<typename T, typename HandleScope = NoHandleScope>
+class Runner {
+    using ContextType = typename T::Context;
+    using ObjectType = typename T::Object;
+    using ValueType = typename T::Value;
+    using String = js::String<T>;
+    using Object = js::Object<T>;
+    using Value = js::Value<T>;
+    using ReturnValue = js::ReturnValue<T>;
+    using Arguments = js::Arguments<T>;
+    using NativeAccessor = js::NativeAccessor<T>;
+
+    static const size_t batch_size = 1000;
+    static const size_t object_count = 1000;
+
+  public:
+    // `return_value` is only used to call the methods which take one, and is
+    // left holding whatever the last of them returned.
+    Runner(ContextType ctx, std::string const& path, ReturnValue& return_value)
+    : m_ctx(ctx), m_return_value(return_value) {
+        realm::Realm::Config config;
+        config.path = path;
+        config.in_memory = true;
+        config.schema_version = 0;
+        config.schema = realm::Schema{
+            {"TestObject", {
+                {"int", realm::PropertyType::Int},
+                {"double", realm::PropertyType::Double},
+                {"string", realm::PropertyType::String},
+            }},
+        };
+        m_realm = RealmClass<T>::create_shared_realm(ctx, config, true, {}, {});
+        m_object_schema = &*m_realm->schema().find("TestObject");
+
+        m_properties = Object::create_empty(ctx);
+        Object::set_property(ctx, m_properties, "int", Value::from_number(ctx, 1));
+        Object::set_property(ctx, m_properties, "double", Value::from_number(ctx, 1.5));
+        Object::set_property(ctx, m_properties, "string", Value::from_string(ctx, "string"));
+
+        NativeAccessor accessor(ctx, m_realm, *m_object_schema);
+        std::vector<realm::Object> objects;
+        m_realm->begin_transaction();
+        for (size_t i = 0; i < object_count; ++i) {
+            objects.push_back(realm::Object::create<ValueType>(accessor, m_realm, *m_object_schema, ValueType(m_properties),
+                                                               realm::CreatePolicy::ForceCreate));
+        }
+        m_realm->commit_transaction();
+
+        m_js_realm = create_object<T, RealmClass<T>>(ctx, new SharedRealm(m_realm));
+        m_results = ResultsClass<T>::create_instance(ctx, m_realm, "TestObject");
+        m_object = RealmObjectClass<T>::create_instance(ctx, std::move(objects.front()));
+    }
+
+    ~Runner() {
+        if (m_realm->is_in_transaction()) {
+            m_realm->cancel_transaction();
+        }
+        m_realm->close();
+    }
+
+    // Runs those of the benchmarks whose names contain `filter`, each for
+    // `iterations` calls.
+    std::vector<Result> run(std::string const& filter, size_t iterations) {
+        ContextType ctx = m_ctx;
+        NativeAccessor accessor(ctx, m_realm, *m_object_schema);
+        ValueType number = Value::from_number(ctx, 42);
+        ValueType string = Value::from_string(ctx, "a string of some length");
+        const String int_name = "int";
+        const String string_name = "string";
+
+        std::vector<Benchmark> benchmarks = {
+            {"NativeAccessor::box(int64_t)", [&] { accessor.box(int64_t(42)); }},
+            {"NativeAccessor::box(StringData)", [&] { accessor.box(StringData("a string of some length")); }},
+            {"NativeAccessor::unbox<int64_t>", [&] { accessor.template unbox<int64_t>(number); }},
+            {"NativeAccessor::unbox<StringData>", [&] { accessor.template unbox<StringData>(string); }},
+            {"RealmObjectClass::get_property(int)", [&] {
+                RealmObjectClass<T>::get_property(ctx, m_object, int_name, m_return_value);
+            }},
+            {"RealmObjectClass::get_property(string)", [&] {
+                RealmObjectClass<T>::get_property(ctx, m_object, string_name, m_return_value);
+            }},
+            {"RealmObjectClass::set_property(int)", [&] {
+                RealmObjectClass<T>::set_property(ctx, m_object, int_name, number);
+            }, true},
+            {"RealmObjectClass::set_property(string)", [&] {
+                RealmObjectClass<T>::set_property(ctx, m_object, string_name, string);
+            }, true},
+            {"RealmClass::create", [&] {
+                ValueType arguments[] = {Value::from_string(ctx, "TestObject"), m_properties};
+                Arguments args{ctx, 2, arguments};
+                RealmClass<T>::create(ctx, m_js_realm, args, m_return_value);
+            }, true},
+            {"ResultsClass::get_index", [&] {
+                ResultsClass<T>::get_index(ctx, m_results, uint32_t(m_index++ % object_count), m_return_value);
+            }},
+            {"CollectionClass::create_collection_change_set", [&] {
+                CollectionClass<T>::create_collection_change_set(ctx, m_change_set);
+            }},
+        };
+
+        m_change_set.deletions = IndexSet{1, 5, 6, 7};
+        m_change_set.insertions = IndexSet{2, 3, 10};
+        m_change_set.modifications = IndexSet{0, 4, 8, 9};
+        m_change_set.modifications_new = IndexSet{0, 5, 9, 11};
+
+        std::vector<Result> results;
+        for (auto const& benchmark : benchmarks) {
+            if (benchmark.name.find(filter) == std::string::npos) {
+                continue;
+            }
+            results.push_back(measure(benchmark, iterations));
+        }
+        return results;
+    }
+
+  private:
+    struct Benchmark {
+        std::string name;
+        std::function<void()> call;
+        bool in_write = false;
+    };
+
+    ContextType m_ctx;
+    ReturnValue& m_return_value;
+    SharedRealm m_realm;
+    const ObjectSchema* m_object_schema;
+    ObjectType m_properties;
+    ObjectType m_js_realm;
+    ObjectType m_results;
+    ObjectType m_object;
+    CollectionChangeSet m_change_set;
+    size_t m_index = 0;
+
+    Result measure(Benchmark const& benchmark, size_t iterations) {
+        // The objects created by `RealmClass::create` are rolled back along
+        // with the transaction, so that each run starts with the same Realm.
+        if (benchmark.in_write) {
+            m_realm->begin_transaction();
+        }
+
+        auto allocations = allocation_count().load();
+        auto start = std::chrono::steady_clock::now();
+        for (size_t done = 0; done < iterations; done += batch_size) {
+            HandleScope scope;
+            for (size_t i = done, end = std::min(iterations, done + size_t(batch_size)); i < end; ++i) {
+                benchmark.call();
+            }
+        }
+        auto duration = std::chrono::steady_clock::now() - start;
+        allocations = allocation_count().load() - allocations;
+
+        if (benchmark.in_write) {
+            m_realm->cancel_transaction();
+        }
+
+        double ops = double(iterations ? iterations : 1);
+        return {benchmark.name, std::chrono::duration<double, std::nano>(duration).count() / ops,
+                double(allocations) / ops};
+    }
+};
+
+// The function which the drivers export: `run(path, [filter], [iterations])`
+// returns an array of `{name, nsPerOp, allocationsPerOp}` objects.
+template<typename T, typename HandleScope = NoHandleScope>
+void run(typename T::Context ctx, typename T::Object, js::Arguments<T>& args, js::ReturnValue<T>& return_value) {
+    using Object = js::Object<T>;
+    using Value = js::Value<T>;
+
+    args.validate_between(1, 3);
+    std::string path = Value::validated_to_string(ctx, args[0], "path");
+    std::string filter;
+    if (args.count > 1 && !Value::is_undefined(ctx, args[1])) {
+        filter = Value::validated_to_string(ctx, args[1], "filter");
+    }
+    size_t iterations = 100000;
+    if (args.count > 2 && !Value::is_undefined(ctx, args[2])) {
+        double value = Value::validated_to_number(ctx, args[2], "iterations");
+        if (value < 1) {
+            throw std::invalid_argument("'iterations' must be at least 1.");
+        }
+        iterations = size_t(value);
+    }
+
+    std::vector<Result> results;
+    {
+        Runner<T, HandleScope> runner(ctx, path, return_value);
+        results = runner.run(filter, iterations);
+    }
+
+    std::vector<typename T::Value> values;
+    values.reserve(results.size());
+    for (auto const& result : results) {
+        auto object = Object::create_empty(ctx);
+        Object::set_property(ctx, object, "name", Value::from_string(ctx, result.name));
+        Object::set_property(ctx, object, "nsPerOp", Value::from_number(ctx, result.ns_per_op));
+        Object::set_property(ctx, object, "allocationsPerOp", Value::from_number(ctx, result.allocations_per_op));
+        values.push_back(object);
+    }
+    return_value.set(Object::create_array(ctx, values));
+}
+
+} // benchmarks
+} // js
+} // realm
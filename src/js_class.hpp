@@ -46,6 +46,12 @@ struct Arguments {
         }
     }
 
+    void validate_minimum(size_t min) const {
+        if (count < min) {
+            throw std::invalid_argument(util::format("Invalid arguments: at least %1 expected, but %2 supplied.", min, count));
+        }
+    }
+
     void validate_count(size_t expected) const {
         if (count != expected) {
             throw std::invalid_argument(util::format("Invalid arguments: %1 expected, but %2 supplied.", expected, count));
@@ -33,47 +33,253 @@ namespace js {
 // Empty class that merely serves as useful type for now.
 class Collection {};
 
+// How the index lists of a collection change set are presented to JavaScript.
+enum class ChangeSetFormat {
+    Array,      // An array of indices.
+    Int32Array, // An Int32Array of indices.
+    Ranges,     // An array of [start, length] pairs, one per run of consecutive indices.
+};
+
+template<typename T>
+struct ChangeSet {
+    using ValueType = typename T::Value;
+
+    ChangeSet(CollectionChangeSet change_set, ChangeSetFormat format)
+        : change_set(std::move(change_set)), format(format) {}
+
+    CollectionChangeSet change_set;
+    ChangeSetFormat format;
+
+    // The index lists which have been read so far, so that each is only
+    // converted once.
+    util::Optional<Protected<ValueType>> deletions;
+    util::Optional<Protected<ValueType>> insertions;
+    util::Optional<Protected<ValueType>> modifications;
+    util::Optional<Protected<ValueType>> new_modifications;
+};
+
+// A change set whose index lists are converted when they are first read, as
+// most listeners only look at some of them. The lists are exposed as
+// enumerable own properties so that Object.keys() and JSON.stringify() see
+// them as they did when change sets were plain objects.
+template<typename T>
+class CollectionChangeSetClass : public ClassDefinition<T, ChangeSet<T>> {
+    using ContextType = typename T::Context;
+    using ValueType = typename T::Value;
+    using ObjectType = typename T::Object;
+    using String = js::String<T>;
+    using Object = js::Object<T>;
+    using Value = js::Value<T>;
+    using ReturnValue = js::ReturnValue<T>;
+    using Arguments = js::Arguments<T>;
+
+public:
+    std::string const name = "CollectionChangeSet";
+
+    static ObjectType create_instance(ContextType, const CollectionChangeSet &, ChangeSetFormat);
+
+    static void get_property(ContextType, ObjectType, const String &, ReturnValue &);
+    static bool set_property(ContextType, ObjectType, const String &, ValueType);
+    static std::vector<String> get_property_names(ContextType, ObjectType);
+    static void to_json(ContextType, ObjectType, Arguments &, ReturnValue &);
+
+    static ValueType create_indices(ContextType, const realm::IndexSet &, ChangeSetFormat);
+
+    const StringPropertyType<T> string_accessor = {
+        wrap<get_property>,
+        wrap<set_property>,
+        wrap<get_property_names>,
+    };
+
+    MethodMap<T> const methods = {
+        {"toJSON", wrap<to_json>},
+    };
+
+private:
+    using CachedIndices = util::Optional<Protected<ValueType>> ChangeSet<T>::*;
+    using IndexList = realm::IndexSet CollectionChangeSet::*;
+
+    static bool index_list_for_name(const std::string &, CachedIndices &, IndexList &);
+    static ValueType get_indices(ContextType, ObjectType, CachedIndices, IndexList);
+};
+
+template<typename T>
+typename T::Object CollectionChangeSetClass<T>::create_instance(ContextType ctx, const CollectionChangeSet &change_set, ChangeSetFormat format) {
+    return create_object<T, CollectionChangeSetClass<T>>(ctx, new ChangeSet<T>(change_set, format));
+}
+
+template<typename T>
+typename T::Value CollectionChangeSetClass<T>::create_indices(ContextType ctx, const realm::IndexSet &index_set, ChangeSetFormat format) {
+    switch (format) {
+        case ChangeSetFormat::Int32Array: {
+            std::vector<int32_t> indices;
+            indices.reserve(index_set.count());
+            for (auto index : index_set.as_indexes()) {
+                indices.push_back((int32_t)index);
+            }
+            return Object::create_int32_array(ctx, indices);
+        }
+        case ChangeSetFormat::Ranges: {
+            std::vector<ValueType> ranges;
+            for (auto& range : index_set) {
+                ranges.push_back(Object::create_array(ctx, {
+                    Value::from_number(ctx, range.first),
+                    Value::from_number(ctx, range.second - range.first),
+                }));
+            }
+            return Object::create_array(ctx, ranges);
+        }
+        case ChangeSetFormat::Array:
+        default: {
+            std::vector<ValueType> indices;
+            indices.reserve(index_set.count());
+            for (auto index : index_set.as_indexes()) {
+                indices.push_back(Value::from_number(ctx, index));
+            }
+            return Object::create_array(ctx, indices);
+        }
+    }
+}
+
+// The names of the index lists, in the order they are enumerated.
+static const char* const collection_change_set_names[] = {
+    "insertions", "deletions", "modifications", "oldModifications", "newModifications",
+};
+
+template<typename T>
+bool CollectionChangeSetClass<T>::index_list_for_name(const std::string &name, CachedIndices &cached, IndexList &index_set) {
+    if (name == "insertions") {
+        cached = &ChangeSet<T>::insertions;
+        index_set = &CollectionChangeSet::insertions;
+    }
+    else if (name == "deletions") {
+        cached = &ChangeSet<T>::deletions;
+        index_set = &CollectionChangeSet::deletions;
+    }
+    else if (name == "modifications" || name == "oldModifications") {
+        cached = &ChangeSet<T>::modifications;
+        index_set = &CollectionChangeSet::modifications;
+    }
+    else if (name == "newModifications") {
+        cached = &ChangeSet<T>::new_modifications;
+        index_set = &CollectionChangeSet::modifications_new;
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
+template<typename T>
+typename T::Value CollectionChangeSetClass<T>::get_indices(ContextType ctx, ObjectType object, CachedIndices cached, IndexList index_set) {
+    auto change_set = get_internal<T, CollectionChangeSetClass<T>>(object);
+    auto& value = (*change_set).*cached;
+    if (!value) {
+        auto& indices = change_set->change_set.*index_set;
+        if (cached == &ChangeSet<T>::deletions && indices.count() == std::numeric_limits<size_t>::max()) {
+            value.emplace(ctx, Object::create_array(ctx, {Value::from_null(ctx)}));
+        }
+        else {
+            value.emplace(ctx, create_indices(ctx, indices, change_set->format));
+        }
+    }
+    return static_cast<ValueType>(*value);
+}
+
+template<typename T>
+void CollectionChangeSetClass<T>::get_property(ContextType ctx, ObjectType object, const String &property, ReturnValue &return_value) {
+    CachedIndices cached;
+    IndexList index_set;
+    if (index_list_for_name(property, cached, index_set)) {
+        return_value.set(get_indices(ctx, object, cached, index_set));
+    }
+}
+
+template<typename T>
+bool CollectionChangeSetClass<T>::set_property(ContextType ctx, ObjectType object, const String &property, ValueType value) {
+    CachedIndices cached;
+    IndexList index_set;
+    std::string name = property;
+    if (index_list_for_name(name, cached, index_set)) {
+        throw std::runtime_error("Cannot assign to read only property '" + name + "'");
+    }
+    return false;
+}
+
+template<typename T>
+std::vector<String<T>> CollectionChangeSetClass<T>::get_property_names(ContextType ctx, ObjectType object) {
+    std::vector<String> names;
+    for (auto name : collection_change_set_names) {
+        names.push_back(String::intern(name));
+    }
+    return names;
+}
+
+template<typename T>
+void CollectionChangeSetClass<T>::to_json(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    ObjectType object = Object::create_empty(ctx);
+    for (auto name : collection_change_set_names) {
+        CachedIndices cached;
+        IndexList index_set;
+        index_list_for_name(name, cached, index_set);
+        Object::set_property(ctx, object, name, get_indices(ctx, this_object, cached, index_set));
+    }
+    return_value.set(object);
+}
+
 template<typename T>
 struct CollectionClass : ClassDefinition<T, Collection, ObservableClass<T>> {
     using ContextType = typename T::Context;
     using ValueType = typename T::Value;
     using ObjectType = typename T::Object;
+    using String = js::String<T>;
     using Object = js::Object<T>;
     using Value = js::Value<T>;
 
     std::string const name = "Collection";
 
-    static inline ValueType create_collection_change_set(ContextType ctx, const CollectionChangeSet &change_set);
+    static inline ValueType create_collection_change_set(ContextType ctx, const CollectionChangeSet &change_set,
+                                                         ChangeSetFormat format = ChangeSetFormat::Array);
+    static ChangeSetFormat validated_change_set_format(ContextType ctx, const ValueType &value);
 };
 
 template<typename T>
-typename T::Value CollectionClass<T>::create_collection_change_set(ContextType ctx, const CollectionChangeSet &change_set)
+typename T::Value CollectionClass<T>::create_collection_change_set(ContextType ctx, const CollectionChangeSet &change_set, ChangeSetFormat format)
 {
-    ObjectType object = Object::create_empty(ctx);
-    std::vector<ValueType> scratch;
-    auto make_array = [&](realm::IndexSet const& index_set) {
-        scratch.clear();
-        scratch.reserve(index_set.count());
-        for (auto index : index_set.as_indexes()) {
-            scratch.push_back(Value::from_number(ctx, index));
-        }
-        return Object::create_array(ctx, scratch);
-    };
+    return CollectionChangeSetClass<T>::create_instance(ctx, change_set, format);
+}
 
-    if (change_set.deletions.count() == std::numeric_limits<size_t>::max()) {
-        Object::set_property(ctx, object, "deletions", Object::create_array(ctx, {Value::from_null(ctx)}));
+template<typename T>
+ChangeSetFormat CollectionClass<T>::validated_change_set_format(ContextType ctx, const ValueType &value) {
+    if (Value::is_undefined(ctx, value)) {
+        return ChangeSetFormat::Array;
     }
-    else {
-        Object::set_property(ctx, object, "deletions", make_array(change_set.deletions));
+
+    std::string format = Value::validated_to_string(ctx, value, "changeSetFormat");
+    if (format == "array") {
+        return ChangeSetFormat::Array;
     }
-    Object::set_property(ctx, object, "insertions", make_array(change_set.insertions));
-    Object::set_property(ctx, object, "newModifications", make_array(change_set.modifications_new));
+    if (format == "int32Array") {
+        return ChangeSetFormat::Int32Array;
+    }
+    if (format == "ranges") {
+        return ChangeSetFormat::Ranges;
+    }
+    throw std::invalid_argument(util::format("Unknown change set format '%1'. Expected 'array', 'int32Array' or 'ranges'.", format));
+}
 
-    auto old_modifications = make_array(change_set.modifications);
-    Object::set_property(ctx, object, "modifications", old_modifications);
-    Object::set_property(ctx, object, "oldModifications", old_modifications);
+// Listeners are throttled by the wrappers of the listener methods in
+// lib/listener-throttle.js, which take out the throttling options. Engines
+// whose native methods can't be wrapped pass them through instead.
+template<typename T>
+void validate_unthrottled_listener(typename T::Context ctx, typename T::Object options) {
+    static const String<T> min_interval_string = "minInterval";
+    static const String<T> max_delay_string = "maxDelay";
 
-    return object;
+    if (!Value<T>::is_undefined(ctx, Object<T>::get_property(ctx, options, min_interval_string)) ||
+        !Value<T>::is_undefined(ctx, Object<T>::get_property(ctx, options, max_delay_string))) {
+        throw std::invalid_argument("The 'minInterval' and 'maxDelay' listener options are not supported with JavaScriptCore.");
+    }
 }
 
 } // js
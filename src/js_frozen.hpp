@@ -0,0 +1,469 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2020 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "js_class.hpp"
+#include "js_plain.hpp"
+#include "js_types.hpp"
+
+#include "object_store.hpp"
+#include "results.hpp"
+#include "schema.hpp"
+#include "shared_realm.hpp"
+
+#include <realm/group_shared.hpp>
+#include <realm/history.hpp>
+
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace realm {
+namespace js {
+
+// A version of a Realm file which is kept, by a read transaction of its own,
+// for as long as anything refers to it. It may be released on any thread.
+class FrozenVersion {
+  public:
+    static void validate(Realm const& realm) {
+        auto const& config = realm.config();
+        if (config.immutable()) {
+            throw std::logic_error("Cannot freeze a read-only Realm.");
+        }
+#if REALM_ENABLE_SYNC
+        if (config.sync_config) {
+            throw std::logic_error("Cannot freeze a synchronized Realm.");
+        }
+#endif
+        if (realm.is_in_transaction()) {
+            throw std::logic_error("Cannot freeze a Realm in a write transaction.");
+        }
+    }
+
+    // Freezes the version the Realm is reading, along with its schema. Only
+    // what is needed to read the file is kept of the configuration, as its
+    // callbacks belong to the thread of the Realm.
+    FrozenVersion(SharedRealm const& realm)
+    : m_path(realm->config().path)
+    , m_encryption_key(realm->config().encryption_key)
+    , m_in_memory(realm->config().in_memory)
+    , m_schema(realm->schema())
+    , m_history(realm::make_in_realm_history(m_path))
+    , m_shared_group(*m_history, options()) {
+        realm->read_group();
+        m_version = _impl::RealmFriend::get_shared_group(*realm).get_version_of_current_transaction();
+        m_shared_group.begin_read(m_version);
+
+        std::lock_guard<std::mutex> lock(counts_mutex());
+        ++counts()[m_path];
+    }
+
+    ~FrozenVersion() {
+        m_shared_group.end_read();
+
+        std::lock_guard<std::mutex> lock(counts_mutex());
+        auto it = counts().find(m_path);
+        if (it != counts().end() && --it->second == 0) {
+            counts().erase(it);
+        }
+    }
+
+    FrozenVersion(FrozenVersion const&) = delete;
+    FrozenVersion& operator=(FrozenVersion const&) = delete;
+
+    std::string const& path() const {
+        return m_path;
+    }
+
+    Schema const& schema() const {
+        return m_schema;
+    }
+
+    SharedGroup::VersionID version() const {
+        return m_version;
+    }
+
+    SharedGroupOptions options() const {
+        SharedGroupOptions options;
+        if (m_in_memory) {
+            options.durability = SharedGroupOptions::Durability::MemOnly;
+        }
+        options.encryption_key = m_encryption_key.empty() ? nullptr : m_encryption_key.data();
+        return options;
+    }
+
+    // The number of frozen versions of the Realm file at `path`.
+    static size_t count(std::string const& path) {
+        std::lock_guard<std::mutex> lock(counts_mutex());
+        auto it = counts().find(path);
+        return it == counts().end() ? 0 : it->second;
+    }
+
+  private:
+    std::string m_path;
+    std::vector<char> m_encryption_key;
+    bool m_in_memory;
+    Schema m_schema;
+    std::unique_ptr<Replication> m_history;
+    SharedGroup m_shared_group;
+    SharedGroup::VersionID m_version;
+
+    static std::mutex& counts_mutex() {
+        static std::mutex s_mutex;
+        return s_mutex;
+    }
+
+    static std::unordered_map<std::string, size_t>& counts() {
+        static std::unordered_map<std::string, size_t> s_counts;
+        return s_counts;
+    }
+};
+
+// What a frozen handle shows of its version: every object, or the rows a
+// collection of objects of one type had in it.
+struct FrozenView {
+    std::shared_ptr<FrozenVersion> version;
+    // Empty for a whole Realm.
+    std::string object_type;
+    // Every row of the type if not set. Rows of objects which had been deleted
+    // from a snapshot are npos.
+    util::Optional<std::vector<size_t>> rows;
+    uint64_t id = 0;
+};
+
+// The views handed to JavaScript by id, which can be posted to any other
+// thread and resolved there for as long as a handle to the view is alive.
+// Only sharing and resolving take the lock, reading doesn't.
+class FrozenViews {
+  public:
+    static std::shared_ptr<FrozenView> add(FrozenView view) {
+        auto shared = std::make_shared<FrozenView>(std::move(view));
+        auto& views = instance();
+        std::lock_guard<std::mutex> lock(views.m_mutex);
+        for (auto it = views.m_views.begin(); it != views.m_views.end();) {
+            it = it->second.expired() ? views.m_views.erase(it) : std::next(it);
+        }
+        shared->id = ++views.m_last_id;
+        views.m_views.emplace(shared->id, shared);
+        return shared;
+    }
+
+    static std::shared_ptr<FrozenView> find(uint64_t id) {
+        auto& views = instance();
+        std::lock_guard<std::mutex> lock(views.m_mutex);
+        auto it = views.m_views.find(id);
+        std::shared_ptr<FrozenView> view = it == views.m_views.end() ? nullptr : it->second.lock();
+        if (!view) {
+            throw std::runtime_error("Frozen handle does not exist or has been released.");
+        }
+        return view;
+    }
+
+  private:
+    std::mutex m_mutex;
+    uint64_t m_last_id = 0;
+    std::unordered_map<uint64_t, std::weak_ptr<FrozenView>> m_views;
+
+    static FrozenViews& instance() {
+        static FrozenViews s_views;
+        return s_views;
+    }
+};
+
+// Reads a frozen version on one thread through a SharedGroup of its own, so
+// that readers on different threads never wait for one another.
+class FrozenReader {
+  public:
+    FrozenReader(std::shared_ptr<FrozenVersion> version)
+    : m_version(std::move(version))
+    , m_history(realm::make_in_realm_history(m_version->path()))
+    , m_shared_group(*m_history, m_version->options())
+    , m_group(&const_cast<Group&>(m_shared_group.begin_read(m_version->version()))) {}
+
+    ~FrozenReader() {
+        m_shared_group.end_read();
+    }
+
+    FrozenReader(FrozenReader const&) = delete;
+    FrozenReader& operator=(FrozenReader const&) = delete;
+
+    Table& table(std::string const& object_type) {
+        auto table = ObjectStore::table_for_object_type(*m_group, object_type);
+        if (!table) {
+            throw std::runtime_error("Table does not exist. Object type: " + object_type);
+        }
+        return *table;
+    }
+
+  private:
+    std::shared_ptr<FrozenVersion> m_version;
+    std::unique_ptr<Replication> m_history;
+    SharedGroup m_shared_group;
+    Group* m_group;
+};
+
+// The internal object of a frozen handle, which belongs to the thread it was
+// created on. Handles created from one another share their reader.
+struct FrozenHandle {
+    std::shared_ptr<FrozenView> view;
+    std::shared_ptr<FrozenReader> reader;
+
+    FrozenView const& validated_view() const {
+        if (!view) {
+            throw std::logic_error("Cannot read from a frozen handle which has been closed.");
+        }
+        return *view;
+    }
+
+    FrozenReader& validated_reader() {
+        validated_view();
+        if (!reader) {
+            reader = std::make_shared<FrozenReader>(view->version);
+        }
+        return *reader;
+    }
+
+    ObjectSchema const& object_schema(std::string const& object_type) const {
+        auto const& schema = validated_view().version->schema();
+        auto it = schema.find(object_type);
+        if (it == schema.end()) {
+            throw std::runtime_error("Object type '" + object_type + "' not found in schema.");
+        }
+        return *it;
+    }
+
+    size_t size() {
+        auto const& view = validated_view();
+        return view.rows ? view.rows->size() : validated_reader().table(view.object_type).size();
+    }
+
+    void close() {
+        reader.reset();
+        view.reset();
+    }
+};
+
+template<typename T>
+class FrozenResultsClass : public ClassDefinition<T, FrozenHandle> {
+    using ContextType = typename T::Context;
+    using FunctionType = typename T::Function;
+    using ObjectType = typename T::Object;
+    using ValueType = typename T::Value;
+    using Object = js::Object<T>;
+    using Value = js::Value<T>;
+    using ReturnValue = js::ReturnValue<T>;
+    using Arguments = js::Arguments<T>;
+
+public:
+    std::string const name = "FrozenResults";
+
+    static FunctionType create_constructor(ContextType ctx) {
+        return ObjectWrap<T, FrozenResultsClass<T>>::create_constructor(ctx);
+    }
+
+    // Freezes the rows the collection has at the version its Realm is reading.
+    static ObjectType create_instance(ContextType ctx, realm::Results results) {
+        if (results.get_type() != realm::PropertyType::Object) {
+            throw std::invalid_argument("Only collections of objects can be frozen.");
+        }
+        auto const& realm = results.get_realm();
+        FrozenVersion::validate(*realm);
+
+        FrozenView view;
+        view.object_type = results.get_object_schema().name;
+        view.rows = std::vector<size_t>();
+        size_t size = results.size();
+        view.rows->reserve(size);
+        for (size_t i = 0; i < size; ++i) {
+            auto row = results.get(i);
+            view.rows->push_back(row.is_attached() ? row.get_index() : realm::npos);
+        }
+        view.version = std::make_shared<FrozenVersion>(realm);
+        return create_instance(ctx, FrozenViews::add(std::move(view)), nullptr);
+    }
+
+    static ObjectType create_instance(ContextType ctx, std::shared_ptr<FrozenView> view, std::shared_ptr<FrozenReader> reader) {
+        return create_object<T, FrozenResultsClass<T>>(ctx, new FrozenHandle{std::move(view), std::move(reader)});
+    }
+
+    static void get(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+        args.validate_between(1, 2);
+        auto& handle = *get_internal<T, FrozenResultsClass<T>>(this_object);
+        double index = Value::validated_to_number(ctx, args[0], "index");
+        if (!(index >= 0) || index >= double(handle.size())) {
+            return_value.set_undefined();
+            return;
+        }
+        auto options = PlainObjectBuilder<T>::validated_options(ctx, args.count == 2 ? args[1] : Value::from_undefined(ctx));
+        PlainObjectBuilder<T> builder(ctx, handle.view->version->schema(), std::move(options));
+        return_value.set(read(ctx, handle, builder, size_t(index)));
+    }
+
+    static void to_plain(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+        auto& handle = *get_internal<T, FrozenResultsClass<T>>(this_object);
+        auto options = PlainObjectBuilder<T>::validated_options(ctx, args);
+        size_t size = handle.size();
+        PlainObjectBuilder<T> builder(ctx, handle.view->version->schema(), std::move(options));
+        std::vector<ValueType> values;
+        values.reserve(size);
+        for (size_t i = 0; i < size; ++i) {
+            values.push_back(read(ctx, handle, builder, i));
+        }
+        return_value.set(Object::create_array(ctx, values));
+    }
+
+    static void close(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+        args.validate_maximum(0);
+        get_internal<T, FrozenResultsClass<T>>(this_object)->close();
+    }
+
+    static void get_length(ContextType ctx, ObjectType this_object, ReturnValue &return_value) {
+        return_value.set((uint32_t)get_internal<T, FrozenResultsClass<T>>(this_object)->size());
+    }
+
+    static void get_object_type(ContextType ctx, ObjectType this_object, ReturnValue &return_value) {
+        return_value.set(get_internal<T, FrozenResultsClass<T>>(this_object)->validated_view().object_type);
+    }
+
+    static void get_id(ContextType ctx, ObjectType this_object, ReturnValue &return_value) {
+        return_value.set(double(get_internal<T, FrozenResultsClass<T>>(this_object)->validated_view().id));
+    }
+
+    static void get_version(ContextType ctx, ObjectType this_object, ReturnValue &return_value) {
+        return_value.set(double(get_internal<T, FrozenResultsClass<T>>(this_object)->validated_view().version->version().version));
+    }
+
+    static void get_is_closed(ContextType ctx, ObjectType this_object, ReturnValue &return_value) {
+        return_value.set(!get_internal<T, FrozenResultsClass<T>>(this_object)->view);
+    }
+
+    MethodMap<T> const methods = {
+        {"get", wrap<get>},
+        {"toPlain", wrap<to_plain>},
+        {"close", wrap<close>},
+    };
+
+    PropertyMap<T> const properties = {
+        {"length", {wrap<get_length>, nullptr}},
+        {"objectType", {wrap<get_object_type>, nullptr}},
+        {"id", {wrap<get_id>, nullptr}},
+        {"version", {wrap<get_version>, nullptr}},
+        {"isClosed", {wrap<get_is_closed>, nullptr}},
+    };
+
+private:
+    static ValueType read(ContextType ctx, FrozenHandle& handle, PlainObjectBuilder<T>& builder, size_t index) {
+        auto const& view = *handle.view;
+        size_t row = view.rows ? (*view.rows)[index] : index;
+        if (row == realm::npos) {
+            return Value::from_null(ctx);
+        }
+        return builder.row(handle.validated_reader().table(view.object_type), row, handle.object_schema(view.object_type));
+    }
+};
+
+template<typename T>
+class FrozenRealmClass : public ClassDefinition<T, FrozenHandle> {
+    using ContextType = typename T::Context;
+    using FunctionType = typename T::Function;
+    using ObjectType = typename T::Object;
+    using ValueType = typename T::Value;
+    using Object = js::Object<T>;
+    using Value = js::Value<T>;
+    using ReturnValue = js::ReturnValue<T>;
+    using Arguments = js::Arguments<T>;
+
+public:
+    std::string const name = "FrozenRealm";
+
+    static FunctionType create_constructor(ContextType ctx) {
+        return ObjectWrap<T, FrozenRealmClass<T>>::create_constructor(ctx);
+    }
+
+    static ObjectType create_instance(ContextType ctx, SharedRealm const& realm) {
+        FrozenVersion::validate(*realm);
+        FrozenView view;
+        view.version = std::make_shared<FrozenVersion>(realm);
+        return create_instance(ctx, FrozenViews::add(std::move(view)));
+    }
+
+    static ObjectType create_instance(ContextType ctx, std::shared_ptr<FrozenView> view) {
+        return create_object<T, FrozenRealmClass<T>>(ctx, new FrozenHandle{std::move(view), nullptr});
+    }
+
+    // Shares the version and the reader of this handle, and so is read on
+    // the same thread.
+    static void objects(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+        args.validate_count(1);
+        auto& handle = *get_internal<T, FrozenRealmClass<T>>(this_object);
+        std::string object_type = Value::validated_to_string(ctx, args[0], "objectType");
+        handle.object_schema(object_type);
+
+        FrozenView view;
+        view.version = handle.validated_view().version;
+        view.object_type = std::move(object_type);
+        handle.validated_reader();
+        return_value.set(FrozenResultsClass<T>::create_instance(ctx, FrozenViews::add(std::move(view)), handle.reader));
+    }
+
+    static void close(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+        args.validate_maximum(0);
+        get_internal<T, FrozenRealmClass<T>>(this_object)->close();
+    }
+
+    static void get_id(ContextType ctx, ObjectType this_object, ReturnValue &return_value) {
+        return_value.set(double(get_internal<T, FrozenRealmClass<T>>(this_object)->validated_view().id));
+    }
+
+    static void get_version(ContextType ctx, ObjectType this_object, ReturnValue &return_value) {
+        return_value.set(double(get_internal<T, FrozenRealmClass<T>>(this_object)->validated_view().version->version().version));
+    }
+
+    static void get_is_closed(ContextType ctx, ObjectType this_object, ReturnValue &return_value) {
+        return_value.set(!get_internal<T, FrozenRealmClass<T>>(this_object)->view);
+    }
+
+    MethodMap<T> const methods = {
+        {"objects", wrap<objects>},
+        {"close", wrap<close>},
+    };
+
+    PropertyMap<T> const properties = {
+        {"id", {wrap<get_id>, nullptr}},
+        {"version", {wrap<get_version>, nullptr}},
+        {"isClosed", {wrap<get_is_closed>, nullptr}},
+    };
+};
+
+// Resolves a handle shared by id on the thread which calls it, with a reader
+// of its own.
+template<typename T>
+typename T::Object resolve_frozen(typename T::Context ctx, uint64_t id) {
+    auto view = FrozenViews::find(id);
+    if (view->object_type.empty()) {
+        return FrozenRealmClass<T>::create_instance(ctx, std::move(view));
+    }
+    return FrozenResultsClass<T>::create_instance(ctx, std::move(view), nullptr);
+}
+
+} // js
+} // realm
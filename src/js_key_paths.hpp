@@ -0,0 +1,423 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2020 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "js_types.hpp"
+
+#include "collection_notifications.hpp"
+#include "object_schema.hpp"
+#include "property.hpp"
+#include "schema.hpp"
+
+#include <realm/row.hpp>
+#include <realm/util/optional.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace realm {
+namespace js {
+
+// Restricts the notifications of a listener to changes of the properties
+// along a set of key paths, such as "name" or "owner.avatar".
+//
+// The notifiers do not know about key paths, so change sets are filtered as
+// they are delivered and before anything is created for them in JavaScript.
+// Collections keep the key path values of each of their objects, which are
+// compared with the current values of the objects reported as modified, so
+// that only inserted and modified objects are read for a change set.
+//
+// Object notifiers only report changes to the object's own columns. Key paths
+// of a single property are filtered through those columns, while the values
+// along each key path through links are compared whenever the Realm changes,
+// through nested_changes().
+//
+// Links are kept as row accessors, which core moves along with the objects
+// they point to, so that only a change of the linked object tells a link
+// apart. Key paths are held by column index and resolved through the link
+// targets of the tables as they are walked, so no schema objects are
+// referenced.
+class KeyPathFilter {
+public:
+    KeyPathFilter(const realm::Schema& schema, const ObjectSchema& object_schema, const std::vector<std::string>& key_paths) {
+        m_paths.reserve(key_paths.size());
+        for (auto& key_path : key_paths) {
+            m_paths.push_back(resolve(schema, object_schema, key_path));
+        }
+    }
+
+    bool has_nested_paths() const {
+        return std::any_of(m_paths.begin(), m_paths.end(), [](auto& path) { return path.steps.size() > 1; });
+    }
+
+    // Returns whether an object change set should be delivered.
+    bool filter_object_changes(const CollectionChangeSet& change_set) const {
+        // The initial notification has no modifications.
+        if (!change_set.deletions.empty() || change_set.modifications.empty()) {
+            return true;
+        }
+        for (auto& path : m_paths) {
+            if (path.steps.size() > 1) {
+                continue;
+            }
+            size_t column = path.steps.front().column;
+            if (column < change_set.columns.size() && !change_set.columns[column].empty()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Records the values along the key paths through links of an object.
+    template<typename Row>
+    void observe(Row&& row) {
+        m_nested_values.clear();
+        for (auto& path : m_paths) {
+            Values values;
+            if (path.steps.size() > 1) {
+                read_path(*row.get_table(), row.get_index(), path.steps, 0, values);
+            }
+            m_nested_values.push_back(std::move(values));
+        }
+    }
+
+    // Returns the names of the properties of an object whose key paths
+    // through links have changed since they were last observed.
+    template<typename Row>
+    std::vector<std::string> nested_changes(Row&& row) {
+        std::vector<std::string> names;
+        for (size_t i = 0; i < m_paths.size() && i < m_nested_values.size(); ++i) {
+            auto& path = m_paths[i];
+            if (path.steps.size() == 1) {
+                continue;
+            }
+            Values values;
+            read_path(*row.get_table(), row.get_index(), path.steps, 0, values);
+            if (values == m_nested_values[i]) {
+                continue;
+            }
+            m_nested_values[i] = std::move(values);
+            if (std::find(names.begin(), names.end(), path.name) == names.end()) {
+                names.push_back(path.name);
+            }
+        }
+        return names;
+    }
+
+    // Removes the modifications which did not change any of the key paths
+    // from a collection change set, and returns whether it should still be
+    // delivered.
+    template<typename Collection>
+    bool filter_collection_changes(Collection& collection, CollectionChangeSet& change_set) {
+        if (!collection.is_valid()) {
+            m_rows.clear();
+            return true;
+        }
+
+        size_t size = collection.size();
+        if (!m_initialized) {
+            m_initialized = true;
+            m_rows.reserve(size);
+            for (size_t i = 0; i < size; ++i) {
+                m_rows.push_back(read_row(collection.get(i)));
+            }
+            return true;
+        }
+
+        // Moved objects are reported as a deletion and an insertion, and
+        // keep the values they had before they moved.
+        std::unordered_map<size_t, size_t> moved_from;
+        for (auto& move : change_set.moves) {
+            moved_from[move.to] = move.from;
+        }
+
+        if (!change_set.deletions.empty() || !change_set.insertions.empty()) {
+            auto insertions = change_set.insertions.as_indexes();
+            auto deletions = change_set.deletions.as_indexes();
+            auto next_insertion = insertions.begin();
+            auto next_deletion = deletions.begin();
+
+            std::vector<std::unique_ptr<Values>> rows;
+            rows.reserve(size);
+            size_t old_index = 0;
+            for (size_t i = 0; i < size; ++i) {
+                if (next_insertion != insertions.end() && *next_insertion == i) {
+                    ++next_insertion;
+                    auto move = moved_from.find(i);
+                    if (move != moved_from.end() && move->second < m_rows.size() && m_rows[move->second]) {
+                        rows.push_back(std::move(m_rows[move->second]));
+                    }
+                    else {
+                        rows.push_back(read_row(collection.get(i)));
+                    }
+                    continue;
+                }
+                while (next_deletion != deletions.end() && *next_deletion == old_index) {
+                    ++next_deletion;
+                    ++old_index;
+                }
+                if (old_index < m_rows.size() && m_rows[old_index]) {
+                    rows.push_back(std::move(m_rows[old_index]));
+                }
+                else {
+                    rows.push_back(read_row(collection.get(i)));
+                }
+                ++old_index;
+            }
+            m_rows = std::move(rows);
+        }
+
+        IndexSet modifications;
+        IndexSet modifications_new;
+        for (auto index : change_set.modifications_new.as_indexes()) {
+            if (index >= m_rows.size()) {
+                continue;
+            }
+            auto values = read_row(collection.get(index));
+            if (*values == *m_rows[index]) {
+                continue;
+            }
+            m_rows[index] = std::move(values);
+            modifications_new.add(index);
+
+            auto move = moved_from.find(index);
+            if (move != moved_from.end()) {
+                modifications.add(move->second);
+            }
+            else {
+                modifications.add(change_set.deletions.shift(change_set.insertions.unshift(index)));
+            }
+        }
+        change_set.modifications = std::move(modifications);
+        change_set.modifications_new = std::move(modifications_new);
+
+        return change_set.collection_was_cleared || !change_set.deletions.empty() ||
+               !change_set.insertions.empty() || !change_set.modifications_new.empty();
+    }
+
+private:
+    struct KeyPathStep {
+        size_t column;
+        realm::PropertyType type;
+    };
+    using KeyPathSteps = std::vector<KeyPathStep>;
+    struct KeyPath {
+        // The name of the object's own property the key path starts with.
+        std::string name;
+        KeyPathSteps steps;
+    };
+
+    // The values read along key paths. Values are written to a buffer, each
+    // preceded by a tag, while the objects at the end of links are kept as
+    // row accessors in the order they were met.
+    struct Values {
+        std::string buffer;
+        std::vector<realm::Row> links;
+
+        bool operator==(const Values& other) const {
+            if (buffer != other.buffer || links.size() != other.links.size()) {
+                return false;
+            }
+            for (size_t i = 0; i < links.size(); ++i) {
+                // The accessor of a deleted object is detached.
+                if (!links[i].is_attached() || !other.links[i].is_attached() ||
+                    links[i].get_index() != other.links[i].get_index()) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+
+    std::vector<KeyPath> m_paths;
+    std::vector<std::unique_ptr<Values>> m_rows;
+    std::vector<Values> m_nested_values;
+    bool m_initialized = false;
+
+    static KeyPath resolve(const realm::Schema& schema, const ObjectSchema& object_schema, const std::string& key_path) {
+        KeyPath path;
+        const Property* last = nullptr;
+        const ObjectSchema* current = &object_schema;
+        size_t start = 0;
+        while (true) {
+            size_t end = key_path.find('.', start);
+            std::string name = key_path.substr(start, end == std::string::npos ? end : end - start);
+            if (!current) {
+                throw std::invalid_argument(util::format("Key path '%1' continues past '%2', which is not a link.", key_path, last->name));
+            }
+
+            auto prop = current->property_for_public_name(name);
+            if (!prop) {
+                throw std::invalid_argument(util::format("Key path '%1' refers to '%2', which is not a property of '%3'.", key_path, name, current->name));
+            }
+            if (prop->type == PropertyType::LinkingObjects) {
+                throw std::invalid_argument(util::format("Key path '%1' refers to the linking objects property '%2', which is not supported.", key_path, name));
+            }
+            if (path.steps.empty()) {
+                path.name = prop->name;
+            }
+            path.steps.push_back({prop->table_column, prop->type});
+            last = prop;
+
+            current = nullptr;
+            if ((prop->type & ~PropertyType::Flags) == PropertyType::Object) {
+                current = &*schema.find(prop->object_type);
+            }
+
+            if (end == std::string::npos) {
+                return path;
+            }
+            start = end + 1;
+        }
+    }
+
+    template<typename V>
+    static void append(std::string& buffer, V value) {
+        buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    static void append_bytes(std::string& buffer, const char* data, size_t size) {
+        append(buffer, size);
+        buffer.append(data, size);
+    }
+
+    template<typename Row>
+    std::unique_ptr<Values> read_row(Row&& row) const {
+        auto values = std::make_unique<Values>();
+        for (auto& path : m_paths) {
+            read_path(*row.get_table(), row.get_index(), path.steps, 0, *values);
+        }
+        return values;
+    }
+
+    static void read_path(Table& table, size_t row, const KeyPathSteps& path, size_t depth, Values& values) {
+        auto& step = path[depth];
+        size_t column = step.column;
+        bool last = depth + 1 == path.size();
+        bool is_link = (step.type & ~PropertyType::Flags) == PropertyType::Object;
+
+        if (is_array(step.type)) {
+            if (is_link) {
+                auto links = table.get_linklist(column, row);
+                append(values.buffer, links->size());
+                for (size_t i = 0; i < links->size(); ++i) {
+                    if (last) {
+                        values.links.emplace_back(links->get(i));
+                    }
+                    else {
+                        read_path(links->get_target_table(), links->get(i).get_index(), path, depth + 1, values);
+                    }
+                }
+            }
+            else {
+                auto list = table.get_subtable(column, row);
+                append(values.buffer, list->size());
+                for (size_t i = 0; i < list->size(); ++i) {
+                    read_value(*list, 0, i, step.type & ~PropertyType::Array, values.buffer);
+                }
+            }
+            return;
+        }
+
+        if (is_link) {
+            if (table.is_null_link(column, row)) {
+                values.buffer += 'n';
+                return;
+            }
+            values.buffer += 'l';
+            auto target_table = table.get_link_target(column);
+            size_t target = table.get_link(column, row);
+            if (last) {
+                values.links.emplace_back(target_table->get(target));
+            }
+            else {
+                read_path(*target_table, target, path, depth + 1, values);
+            }
+            return;
+        }
+        read_value(table, column, row, step.type, values.buffer);
+    }
+
+    static void read_value(Table& table, size_t column, size_t row, PropertyType type, std::string& buffer) {
+        if (is_nullable(type) && table.is_null(column, row)) {
+            buffer += 'n';
+            return;
+        }
+        buffer += 'v';
+        switch (type & ~PropertyType::Flags) {
+            case PropertyType::Bool:
+                buffer += table.get_bool(column, row) ? '1' : '0';
+                break;
+            case PropertyType::Int:
+                append(buffer, table.get_int(column, row));
+                break;
+            case PropertyType::Float:
+                append(buffer, table.get_float(column, row));
+                break;
+            case PropertyType::Double:
+                append(buffer, table.get_double(column, row));
+                break;
+            case PropertyType::String: {
+                auto string = table.get_string(column, row);
+                append_bytes(buffer, string.data(), string.size());
+                break;
+            }
+            case PropertyType::Data: {
+                auto data = table.get_binary(column, row);
+                append_bytes(buffer, data.data(), data.size());
+                break;
+            }
+            case PropertyType::Date: {
+                auto timestamp = table.get_timestamp(column, row);
+                append(buffer, timestamp.get_seconds());
+                append(buffer, timestamp.get_nanoseconds());
+                break;
+            }
+            default:
+                break;
+        }
+    }
+};
+
+// Reads the `keyPaths` listener option, if given.
+template<typename T>
+util::Optional<std::vector<std::string>> validated_key_paths(typename T::Context ctx, typename T::Object options) {
+    static const String<T> key_paths_string = "keyPaths";
+
+    auto value = Object<T>::get_property(ctx, options, key_paths_string);
+    if (Value<T>::is_undefined(ctx, value)) {
+        return util::none;
+    }
+
+    auto array = Value<T>::validated_to_array(ctx, value, "keyPaths");
+    size_t count = Object<T>::validated_get_length(ctx, array);
+    std::vector<std::string> key_paths;
+    key_paths.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        key_paths.push_back(Object<T>::validated_get_string(ctx, array, i));
+    }
+    return key_paths;
+}
+
+} // js
+} // realm
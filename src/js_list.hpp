@@ -24,6 +24,7 @@
 #include "js_results.hpp"
 #include "js_types.hpp"
 #include "js_util.hpp"
+#include "list_diff.hpp"
 
 #include "shared_realm.hpp"
 #include "list.hpp"
@@ -41,6 +42,11 @@ class List : public realm::List {
     List(const realm::List &l) : realm::List(l) {}
 
     std::vector<std::pair<Protected<typename T::Function>, NotificationToken>> m_notification_tokens;
+    LiveWrapper<&LiveWrapperCounts::lists> m_live{live_wrapper_counts<T>(get_realm())};
+
+    void listeners_changed() {
+        m_live.set_listeners(m_notification_tokens.size());
+    }
 };
 
 template<typename T>
@@ -70,15 +76,28 @@ struct ListClass : ClassDefinition<T, realm::js::List<T>, CollectionClass<T>> {
     static void unshift(ContextType, ObjectType, Arguments &, ReturnValue &);
     static void shift(ContextType, ObjectType, Arguments &, ReturnValue &);
     static void splice(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void assign(ContextType, ObjectType, Arguments &, ReturnValue &);
     static void snapshot(ContextType, ObjectType, Arguments &, ReturnValue &);
     static void filtered(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void filtered_prepared(ContextType, ObjectType, Arguments &, ReturnValue &);
     static void sorted(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void limit(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void cursor(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void iterate(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void freeze(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void linking_objects(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void linking_objects_counts(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void to_plain(ContextType, ObjectType, Arguments &, ReturnValue &);
     static void is_valid(ContextType, ObjectType, Arguments &, ReturnValue &);
     static void is_empty(ContextType, ObjectType, Arguments &, ReturnValue &);
     static void index_of(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void slice(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void to_typed_array(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void set_from_typed_array(ContextType, ObjectType, Arguments &, ReturnValue &);
 
     // observable
     static void add_listener(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void observe_aggregate(ContextType, ObjectType, Arguments &, ReturnValue &);
     static void remove_listener(ContextType, ObjectType, Arguments &, ReturnValue &);
     static void remove_all_listeners(ContextType, ObjectType, Arguments &, ReturnValue &);
 
@@ -90,19 +109,32 @@ struct ListClass : ClassDefinition<T, realm::js::List<T>, CollectionClass<T>> {
         {"unshift", wrap<unshift>},
         {"shift", wrap<shift>},
         {"splice", wrap<splice>},
+        {"assign", wrap<assign>},
         {"snapshot", wrap<snapshot>},
         {"filtered", wrap<filtered>},
+        {"filteredPrepared", wrap<filtered_prepared>},
         {"sorted", wrap<sorted>},
+        {"limit", wrap<limit>},
+        {"cursor", wrap<cursor>},
+        {"linkingObjects", wrap<linking_objects>},
+        {"linkingObjectsCounts", wrap<linking_objects_counts>},
+        {"toPlain", wrap<to_plain>},
         {"isValid", wrap<is_valid>},
         {"isEmpty", wrap<is_empty>},
         {"indexOf", wrap<index_of>},
+        {"slice", wrap<slice>},
+        {"toTypedArray", wrap<to_typed_array>},
+        {"setFromTypedArray", wrap<set_from_typed_array>},
         {"min", wrap<compute_aggregate_on_collection<ListClass<T>, AggregateFunc::Min>>},
         {"max", wrap<compute_aggregate_on_collection<ListClass<T>, AggregateFunc::Max>>},
         {"sum", wrap<compute_aggregate_on_collection<ListClass<T>, AggregateFunc::Sum>>},
         {"avg", wrap<compute_aggregate_on_collection<ListClass<T>, AggregateFunc::Avg>>},
         {"addListener", wrap<add_listener>},
+        {"observeAggregate", wrap<observe_aggregate>},
         {"removeListener", wrap<remove_listener>},
         {"removeAllListeners", wrap<remove_all_listeners>},
+        {"_iterate", wrap<iterate>},
+        {"freeze", wrap<freeze>},
     };
 
     PropertyMap<T> const properties = {
@@ -115,6 +147,9 @@ struct ListClass : ClassDefinition<T, realm::js::List<T>, CollectionClass<T>> {
 
 private:
     static void validate_value(ContextType, realm::List&, ValueType);
+    static std::string value_key(ContextType, NativeAccessor<T>&, realm::PropertyType, ValueType);
+    template<typename Number>
+    static void assign_numbers(realm::List&, std::vector<double> const&);
 };
 
 template<typename T>
@@ -250,6 +285,174 @@ void ListClass<T>::splice(ContextType ctx, ObjectType this_object, Arguments &ar
     return_value.set(Object::create_array(ctx, removed_objects));
 }
 
+template<typename T>
+void ListClass<T>::assign(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    args.validate_between(1, 2);
+    static const String key_string = "key";
+
+    auto list = get_internal<T, ListClass<T>>(this_object);
+    list->verify_in_transaction();
+
+    ObjectType items = Value::validated_to_array(ctx, args[0], "items");
+    uint32_t count = Object::validated_get_length(ctx, items);
+    std::vector<ValueType> values;
+    values.reserve(count);
+    for (uint32_t i = 0; i < count; i++) {
+        values.push_back(Object::get_property(ctx, items, i));
+        validate_value(ctx, *list, values.back());
+    }
+
+    std::string key_name;
+    if (args.count == 2 && !Value::is_undefined(ctx, args[1])) {
+        ObjectType options = Value::validated_to_object(ctx, args[1], "options");
+        ValueType key_value = Object::get_property(ctx, options, key_string);
+        if (!Value::is_undefined(ctx, key_value)) {
+            key_name = Value::validated_to_string(ctx, key_value, "key");
+        }
+    }
+
+    // Each element is given a key which is equal for the elements which are
+    // the same: the row of an object, the value of its key property, or the
+    // value of a primitive.
+    NativeAccessor<T> accessor(ctx, *list);
+    size_t size = list->size();
+    std::vector<std::string> old_keys, new_keys;
+    old_keys.reserve(size);
+    new_keys.reserve(count);
+    std::vector<size_t> new_rows;
+
+    auto type = list->get_type();
+    if (type == realm::PropertyType::Object) {
+        auto const& realm = list->get_realm();
+        auto const& object_schema = list->get_object_schema();
+        const Property* key_property = nullptr;
+        if (!key_name.empty()) {
+            key_property = object_schema.property_for_public_name(key_name);
+            if (!key_property) {
+                throw std::invalid_argument(util::format("Property '%1' does not exist on object '%2'", key_name, object_schema.name));
+            }
+            auto key_type = key_property->type & ~realm::PropertyType::Flags;
+            if (is_array(key_property->type) || key_type == realm::PropertyType::Object || key_type == realm::PropertyType::LinkingObjects) {
+                throw std::invalid_argument(util::format("Property '%1' cannot be used as a key, as it is not a primitive.", key_name));
+            }
+        }
+        auto row_key = [&](RowExpr row) {
+            if (!key_property) {
+                return std::to_string(row.get_index());
+            }
+            realm::Object object(realm, object_schema, row);
+            return value_key(ctx, accessor, key_property->type, object.template get_property_value<ValueType>(accessor, key_property->name));
+        };
+
+        std::unordered_map<std::string, size_t> indices_by_key;
+        for (size_t i = 0; i < size; i++) {
+            old_keys.push_back(row_key(list->get(i)));
+            if (key_property) {
+                indices_by_key.emplace(old_keys.back(), i);
+            }
+        }
+
+        new_rows.reserve(count);
+        for (auto& value : values) {
+            ObjectType object = Value::to_object(ctx, value);
+            bool is_realm_object = Object::template is_instance<RealmObjectClass<T>>(ctx, object);
+            if (key_property && !is_realm_object) {
+                auto key_value = Object::get_property(ctx, object, key_property->public_name.empty() ? key_property->name : key_property->public_name);
+                new_keys.push_back(value_key(ctx, accessor, key_property->type, key_value));
+                auto existing = indices_by_key.find(new_keys.back());
+                if (existing != indices_by_key.end()) {
+                    // The object already in the list is kept, with the other
+                    // properties of the item written to it.
+                    RowExpr row = list->get(existing->second);
+                    realm::Object realm_object(realm, object_schema, row);
+                    for (auto& prop : object_schema.persisted_properties) {
+                        if (&prop == key_property || prop.is_primary) {
+                            continue;
+                        }
+                        auto prop_value = Object::get_property(ctx, object, prop.public_name.empty() ? prop.name : prop.public_name);
+                        if (!Value::is_undefined(ctx, prop_value)) {
+                            realm_object.set_property_value(accessor, prop.name, prop_value, realm::CreatePolicy::UpdateModified);
+                        }
+                    }
+                    new_rows.push_back(row.get_index());
+                    continue;
+                }
+            }
+            RowExpr row = accessor.template unbox<RowExpr>(value, realm::CreatePolicy::UpdateModified);
+            new_rows.push_back(row.get_index());
+            if (!key_property || is_realm_object) {
+                new_keys.push_back(row_key(row));
+            }
+        }
+    }
+    else {
+        if (!key_name.empty()) {
+            throw std::invalid_argument("A key can only be given for lists of objects.");
+        }
+        for (size_t i = 0; i < size; i++) {
+            old_keys.push_back(value_key(ctx, accessor, type, list->get(accessor, i)));
+        }
+        for (auto& value : values) {
+            new_keys.push_back(value_key(ctx, accessor, type, value));
+        }
+    }
+
+    ListDiff diff = diff_lists(old_keys, new_keys);
+    for (size_t index : diff.deletions) {
+        list->remove(index);
+    }
+    for (auto& move : diff.moves) {
+        list->move(move.first, move.second);
+    }
+    for (size_t index : diff.insertions) {
+        if (type == realm::PropertyType::Object) {
+            list->insert(index, new_rows[index]);
+        }
+        else {
+            list->insert(accessor, index, values[index]);
+        }
+    }
+
+    ObjectType result = Object::create_empty(ctx);
+    Object::set_property(ctx, result, "deletions", Value::from_number(ctx, double(diff.deletions.size())));
+    Object::set_property(ctx, result, "insertions", Value::from_number(ctx, double(diff.insertions.size())));
+    Object::set_property(ctx, result, "moves", Value::from_number(ctx, double(diff.moves.size())));
+    return_value.set(result);
+}
+
+template<typename T>
+std::string ListClass<T>::value_key(ContextType ctx, NativeAccessor<T>& accessor, realm::PropertyType type, ValueType value) {
+    auto bytes = [](char tag, auto v) {
+        return std::string(1, tag) + std::string(reinterpret_cast<const char*>(&v), sizeof(v));
+    };
+
+    if (is_nullable(type) && (Value::is_null(ctx, value) || Value::is_undefined(ctx, value))) {
+        return "n";
+    }
+    switch (type & ~realm::PropertyType::Flags) {
+        case realm::PropertyType::Bool:
+            return bytes('b', accessor.template unbox<bool>(value));
+        case realm::PropertyType::Int:
+            return bytes('i', accessor.template unbox<int64_t>(value));
+        case realm::PropertyType::Float:
+            return bytes('f', accessor.template unbox<float>(value));
+        case realm::PropertyType::Double:
+            return bytes('d', accessor.template unbox<double>(value));
+        case realm::PropertyType::String:
+            return "s" + std::string(accessor.template unbox<StringData>(value));
+        case realm::PropertyType::Data: {
+            BinaryData data = accessor.template unbox<BinaryData>(value);
+            return "x" + std::string(data.data(), data.size());
+        }
+        case realm::PropertyType::Date: {
+            Timestamp timestamp = accessor.template unbox<Timestamp>(value);
+            return bytes('t', timestamp.get_seconds()) + bytes('t', timestamp.get_nanoseconds());
+        }
+        default:
+            throw std::invalid_argument(util::format("Values of type '%1' cannot be compared.", string_for_property_type(type)));
+    }
+}
+
 template<typename T>
 void ListClass<T>::snapshot(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
     args.validate_maximum(0);
@@ -263,6 +466,57 @@ void ListClass<T>::filtered(ContextType ctx, ObjectType this_object, Arguments &
     return_value.set(ResultsClass<T>::create_filtered(ctx, *list, args));
 }
 
+template<typename T>
+void ListClass<T>::filtered_prepared(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    auto list = get_internal<T, ListClass<T>>(this_object);
+    return_value.set(ResultsClass<T>::create_filtered_prepared(ctx, *list, args));
+}
+
+template<typename T>
+void ListClass<T>::limit(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    auto list = get_internal<T, ListClass<T>>(this_object);
+    return_value.set(ResultsClass<T>::create_limited(ctx, list->as_results(), args));
+}
+
+template<typename T>
+void ListClass<T>::cursor(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    args.validate_maximum(1);
+    auto list = get_internal<T, ListClass<T>>(this_object);
+    return_value.set(ResultsCursorClass<T>::create_instance(ctx, list->as_results(), args.count ? args[0] : Value::from_undefined(ctx)));
+}
+
+template<typename T>
+void ListClass<T>::iterate(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    args.validate_maximum(1);
+    auto list = get_internal<T, ListClass<T>>(this_object);
+    return_value.set(CollectionIteratorClass<T>::create_instance(ctx, list->as_results(), args.count ? args[0] : Value::from_undefined(ctx)));
+}
+
+template<typename T>
+void ListClass<T>::freeze(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    args.validate_maximum(0);
+    auto list = get_internal<T, ListClass<T>>(this_object);
+    return_value.set(FrozenResultsClass<T>::create_instance(ctx, list->as_results()));
+}
+
+template<typename T>
+void ListClass<T>::linking_objects(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    auto list = get_internal<T, ListClass<T>>(this_object);
+    return_value.set(ResultsClass<T>::create_linking_objects(ctx, list->as_results(), args));
+}
+
+template<typename T>
+void ListClass<T>::linking_objects_counts(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    auto list = get_internal<T, ListClass<T>>(this_object);
+    return_value.set(ResultsClass<T>::create_linking_objects_counts(ctx, list->as_results(), args));
+}
+
+template<typename T>
+void ListClass<T>::to_plain(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    auto list = get_internal<T, ListClass<T>>(this_object);
+    return_value.set(ResultsClass<T>::create_plain(ctx, list->as_results(), args));
+}
+
 template<typename T>
 void ListClass<T>::sorted(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
     auto list = get_internal<T, ListClass<T>>(this_object);
@@ -289,12 +543,106 @@ void ListClass<T>::index_of(ContextType ctx, ObjectType this_object, Arguments &
     ResultsClass<T>::index_of(ctx, fn, args, return_value);
 }
 
+template<typename T>
+void ListClass<T>::slice(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    auto list = get_internal<T, ListClass<T>>(this_object);
+    ResultsClass<T>::slice(ctx, *list, args, return_value);
+}
+
+template<typename T>
+void ListClass<T>::to_typed_array(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    auto list = get_internal<T, ListClass<T>>(this_object);
+    ResultsClass<T>::to_typed_array(ctx, *list, args, return_value);
+}
+
+template<typename T>
+void ListClass<T>::set_from_typed_array(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    args.validate_count(1);
+    auto list = get_internal<T, ListClass<T>>(this_object);
+    list->verify_in_transaction();
+
+    TypedArrayType array_type;
+    if (!Value::get_typed_array_type(ctx, args[0], array_type)) {
+        throw TypeErrorException("array", "typed array", Value::to_string(ctx, args[0]));
+    }
+    BinaryData bytes;
+    OwnedBinaryData copy;
+    if (!Value::to_binary_view(ctx, args[0], bytes)) {
+        copy = Value::to_binary(ctx, args[0]);
+        bytes = copy.get();
+    }
+    std::vector<double> numbers = decode_typed_array(array_type, bytes);
+
+    auto type = list->get_type() & ~realm::PropertyType::Flags;
+    switch (type) {
+        case realm::PropertyType::Bool:
+            assign_numbers<bool>(*list, numbers);
+            break;
+        case realm::PropertyType::Int:
+            for (size_t i = 0; i < numbers.size(); ++i) {
+                double number = numbers[i];
+                if (std::trunc(number) != number || number < -9223372036854775808.0 || number >= 9223372036854775808.0) {
+                    throw std::invalid_argument(util::format("The value at index %1 can't be stored in a list of 'int'.", i));
+                }
+            }
+            assign_numbers<int64_t>(*list, numbers);
+            break;
+        case realm::PropertyType::Float:
+            assign_numbers<float>(*list, numbers);
+            break;
+        case realm::PropertyType::Double:
+            assign_numbers<double>(*list, numbers);
+            break;
+        default:
+            throw std::invalid_argument(util::format("A list of '%1' can't be set from a typed array.", string_for_property_type(type)));
+    }
+}
+
+// Elements are overwritten in place and only the difference in length is
+// added or removed, so elements which keep their value aren't reported as
+// modified.
+template<typename T>
+template<typename Number>
+void ListClass<T>::assign_numbers(realm::List& list, std::vector<double> const& numbers) {
+    bool nullable = is_nullable(list.get_type());
+    size_t size = list.size();
+    for (size_t i = 0; i < size && i < numbers.size(); ++i) {
+        Number number = Number(numbers[i]);
+        if (nullable) {
+            auto current = list.get<util::Optional<Number>>(i);
+            if (!current || *current != number) {
+                list.set(i, util::Optional<Number>(number));
+            }
+        }
+        else if (list.get<Number>(i) != number) {
+            list.set(i, number);
+        }
+    }
+    for (size_t i = size; i > numbers.size(); --i) {
+        list.remove(i - 1);
+    }
+    for (size_t i = size; i < numbers.size(); ++i) {
+        if (nullable) {
+            list.add(util::Optional<Number>(Number(numbers[i])));
+        }
+        else {
+            list.add(Number(numbers[i]));
+        }
+    }
+}
+
 template<typename T>
 void ListClass<T>::add_listener(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
     auto list = get_internal<T, ListClass<T>>(this_object);
     ResultsClass<T>::add_listener(ctx, *list, this_object, args);
 }
 
+template<typename T>
+void ListClass<T>::observe_aggregate(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    auto list = get_internal<T, ListClass<T>>(this_object);
+    ResultsClass<T>::observe_aggregate(ctx, *list, this_object, args);
+}
+
 template<typename T>
 void ListClass<T>::remove_listener(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
     auto list = get_internal<T, ListClass<T>>(this_object);
@@ -306,6 +654,7 @@ void ListClass<T>::remove_all_listeners(ContextType ctx, ObjectType this_object,
     args.validate_maximum(0);
     auto list = get_internal<T, ListClass<T>>(this_object);
     list->m_notification_tokens.clear();
+    list->listeners_changed();
 }
 
 template<typename T>
@@ -315,7 +664,8 @@ void ListClass<T>::validate_value(ContextType ctx, realm::List& list, ValueType
     if (type == realm::PropertyType::Object) {
         object_type = list.get_object_schema().name;
     }
-    if (!Value::is_valid_for_property_type(ctx, value, type, object_type)) {
+    auto delegate = get_delegate<T>(list.get_realm().get());
+    if (!Value::is_valid_for_property_type(ctx, value, type, object_type, delegate && delegate->m_dates_as_numbers)) {
         throw TypeErrorException("Property", object_type ? object_type : string_for_property_type(type), Value::to_string(ctx, value));
     }
 }
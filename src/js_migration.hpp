@@ -0,0 +1,673 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2020 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "js_class.hpp"
+#include "js_object_accessor.hpp"
+#include "js_results.hpp"
+#include "js_schema.hpp"
+
+#include "object_store.hpp"
+#include "shared_realm.hpp"
+
+#include <realm/table.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace realm {
+namespace js {
+
+// The built-in conversions of Migration#copyProperty().
+enum class MigrationTransform {
+    None,
+    ToString,
+    ToNumber,
+    Default,
+};
+
+// A value of a column, read from one table and written to another. Strings
+// and binaries point into the version of the Realm they were read from,
+// unless they were converted or were unboxed from JS, in which case they are
+// owned by the value.
+struct MigrationValue {
+    realm::PropertyType type = realm::PropertyType::Int;
+    bool null = false;
+    int64_t integer = 0;
+    double number = 0;
+    StringData string;
+    BinaryData binary;
+    Timestamp timestamp;
+    bool owned = false;
+    std::string owned_bytes;
+
+    StringData string_value() const {
+        return owned ? StringData(owned_bytes) : string;
+    }
+    BinaryData binary_value() const {
+        return owned ? BinaryData(owned_bytes.data(), owned_bytes.size()) : binary;
+    }
+    void set_owned(std::string bytes) {
+        owned_bytes = std::move(bytes);
+        owned = true;
+    }
+};
+
+// The column-level passes of the migration operations, which read and write
+// the tables directly rather than through objects.
+namespace migration {
+
+inline realm::PropertyType base_type(realm::PropertyType type) {
+    return type & ~realm::PropertyType::Flags;
+}
+
+inline bool is_numeric(realm::PropertyType type) {
+    return type == realm::PropertyType::Int || type == realm::PropertyType::Float || type == realm::PropertyType::Double;
+}
+
+inline bool is_copyable(Property const& property) {
+    if (is_array(property.type)) {
+        return false;
+    }
+    switch (base_type(property.type)) {
+        case realm::PropertyType::Int:
+        case realm::PropertyType::Bool:
+        case realm::PropertyType::Float:
+        case realm::PropertyType::Double:
+        case realm::PropertyType::String:
+        case realm::PropertyType::Data:
+        case realm::PropertyType::Date:
+            return true;
+        default:
+            return false;
+    }
+}
+
+inline MigrationValue read(Table const& table, Property const& property, size_t row) {
+    MigrationValue value;
+    value.type = base_type(property.type);
+    size_t column = property.table_column;
+    if (is_nullable(property.type) && table.is_null(column, row)) {
+        value.null = true;
+        return value;
+    }
+    switch (value.type) {
+        case realm::PropertyType::Int:
+            value.integer = table.get_int(column, row);
+            break;
+        case realm::PropertyType::Bool:
+            value.integer = table.get_bool(column, row);
+            break;
+        case realm::PropertyType::Float:
+            value.number = table.get_float(column, row);
+            break;
+        case realm::PropertyType::Double:
+            value.number = table.get_double(column, row);
+            break;
+        case realm::PropertyType::String:
+            value.string = table.get_string(column, row);
+            break;
+        case realm::PropertyType::Data:
+            value.binary = table.get_binary(column, row);
+            break;
+        case realm::PropertyType::Date:
+            value.timestamp = table.get_timestamp(column, row);
+            break;
+        default:
+            REALM_UNREACHABLE();
+    }
+    return value;
+}
+
+inline void write(Table& table, Property const& property, size_t row, MigrationValue const& value) {
+    size_t column = property.table_column;
+    if (value.null) {
+        table.set_null(column, row);
+        return;
+    }
+    switch (base_type(property.type)) {
+        case realm::PropertyType::Int:
+            table.set_int(column, row, value.integer);
+            break;
+        case realm::PropertyType::Bool:
+            table.set_bool(column, row, value.integer != 0);
+            break;
+        case realm::PropertyType::Float:
+            table.set_float(column, row, float(value.number));
+            break;
+        case realm::PropertyType::Double:
+            table.set_double(column, row, value.number);
+            break;
+        case realm::PropertyType::String:
+            table.set_string(column, row, value.string_value());
+            break;
+        case realm::PropertyType::Data:
+            table.set_binary(column, row, value.binary_value());
+            break;
+        case realm::PropertyType::Date:
+            table.set_timestamp(column, row, value.timestamp);
+            break;
+        default:
+            REALM_UNREACHABLE();
+    }
+}
+
+// Formats numbers the way String() does for the values most columns hold,
+// with the fewest digits which read back as the same double.
+inline std::string number_to_string(double number) {
+    if (std::isnan(number)) {
+        return "NaN";
+    }
+    if (std::isinf(number)) {
+        return number < 0 ? "-Infinity" : "Infinity";
+    }
+    char buffer[32];
+    for (int precision = 15; precision <= 17; ++precision) {
+        snprintf(buffer, sizeof(buffer), "%.*g", precision, number);
+        if (strtod(buffer, nullptr) == number) {
+            break;
+        }
+    }
+    return buffer;
+}
+
+// Parses strings the way Number() does: surrounding whitespace is ignored,
+// an empty string is 0, and anything else which isn't a number is NaN.
+inline double string_to_number(StringData string) {
+    std::string trimmed(string.data(), string.size());
+    size_t begin = trimmed.find_first_not_of(" \t\n\r\f\v");
+    if (begin == std::string::npos) {
+        return 0;
+    }
+    trimmed = trimmed.substr(begin, trimmed.find_last_not_of(" \t\n\r\f\v") - begin + 1);
+    if (trimmed == "Infinity" || trimmed == "+Infinity") {
+        return HUGE_VAL;
+    }
+    if (trimmed == "-Infinity") {
+        return -HUGE_VAL;
+    }
+    char* end = nullptr;
+    double number = strtod(trimmed.c_str(), &end);
+    if (end != trimmed.c_str() + trimmed.size() || std::isinf(number) || std::isnan(number)) {
+        return NAN;
+    }
+    return number;
+}
+
+// Throws unless the values of `from` can be written to `to` with the
+// transform, before any value is.
+inline void validate_types(std::string const& object_type, Property const& from, Property const& to, MigrationTransform transform) {
+    if (!is_copyable(from) || !is_copyable(to)) {
+        throw std::invalid_argument("Only properties of primitive types can be copied.");
+    }
+    realm::PropertyType from_type = base_type(from.type), to_type = base_type(to.type);
+    bool valid;
+    switch (transform) {
+        case MigrationTransform::ToString:
+            valid = to_type == realm::PropertyType::String &&
+                    (from_type == realm::PropertyType::Bool || from_type == realm::PropertyType::String || is_numeric(from_type));
+            break;
+        case MigrationTransform::ToNumber:
+            valid = is_numeric(to_type) &&
+                    (from_type == realm::PropertyType::Bool || from_type == realm::PropertyType::String || is_numeric(from_type));
+            break;
+        default:
+            valid = from_type == to_type || (is_numeric(from_type) && is_numeric(to_type));
+            break;
+    }
+    if (!valid) {
+        throw std::invalid_argument(util::format("Cannot copy '%1.%2' of type '%3' to '%4' of type '%5'.", object_type, from.name,
+                                                 string_for_property_type(from_type), to.name, string_for_property_type(to_type)));
+    }
+}
+
+// Converts a non-null value to the type of the property it is written to,
+// which validate_types() allowed.
+inline void convert(MigrationValue& value, std::string const& object_type, Property const& to) {
+    realm::PropertyType to_type = base_type(to.type);
+    if (value.type == to_type) {
+        return;
+    }
+    double number = 0;
+    switch (value.type) {
+        case realm::PropertyType::Int:
+        case realm::PropertyType::Bool:
+            number = double(value.integer);
+            break;
+        case realm::PropertyType::Float:
+        case realm::PropertyType::Double:
+            number = value.number;
+            break;
+        case realm::PropertyType::String:
+            number = string_to_number(value.string_value());
+            break;
+        default:
+            REALM_UNREACHABLE();
+    }
+
+    if (to_type == realm::PropertyType::String) {
+        if (value.type == realm::PropertyType::Bool) {
+            value.set_owned(value.integer ? "true" : "false");
+        }
+        else if (value.type == realm::PropertyType::Int) {
+            value.set_owned(std::to_string(value.integer));
+        }
+        else {
+            value.set_owned(number_to_string(number));
+        }
+    }
+    else if (to_type == realm::PropertyType::Int) {
+        if (value.type == realm::PropertyType::Int || value.type == realm::PropertyType::Bool) {
+            // Already an integer, which mustn't go through a double.
+        }
+        else if (std::isnan(number) || std::isinf(number)) {
+            throw std::invalid_argument(util::format("Cannot convert '%1' to an integer for '%2.%3'.",
+                                                     value.type == realm::PropertyType::String ? std::string(value.string_value()) : number_to_string(number),
+                                                     object_type, to.name));
+        }
+        else {
+            value.integer = int64_t(std::trunc(number));
+        }
+    }
+    else {
+        value.number = number;
+    }
+    value.type = to_type;
+}
+
+} // migration
+
+// The operations of the migration function on the Realm it migrates, which
+// are only valid during the function.
+template<typename T>
+struct Migration {
+    using ObjectDefaultsMap = typename Schema<T>::ObjectDefaultsMap;
+
+    Migration(SharedRealm old_realm, SharedRealm realm, realm::Schema& schema, ObjectDefaultsMap defaults)
+    : old_realm(std::move(old_realm)), realm(std::move(realm)), schema(&schema), defaults(std::move(defaults)) {}
+
+    SharedRealm old_realm;
+    SharedRealm realm;
+    realm::Schema* schema;
+    ObjectDefaultsMap defaults;
+    util::Optional<Protected<typename T::Function>> progress;
+
+    void end() {
+        old_realm.reset();
+        realm.reset();
+        schema = nullptr;
+        progress = util::none;
+    }
+};
+
+template<typename T>
+class MigrationClass : public ClassDefinition<T, Migration<T>> {
+    using ContextType = typename T::Context;
+    using FunctionType = typename T::Function;
+    using ObjectType = typename T::Object;
+    using ValueType = typename T::Value;
+    using String = js::String<T>;
+    using Object = js::Object<T>;
+    using Value = js::Value<T>;
+    using Function = js::Function<T>;
+    using ReturnValue = js::ReturnValue<T>;
+    using Arguments = js::Arguments<T>;
+
+public:
+    std::string const name = "Migration";
+
+    // Progress is reported every this many objects of each operation.
+    static constexpr size_t progress_interval = 65536;
+
+    static ObjectType create_instance(ContextType ctx, Migration<T>* migration) {
+        return create_object<T, MigrationClass<T>>(ctx, migration);
+    }
+
+    static void rename_property(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void copy_property(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void fill_default(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void delete_where(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void set_progress_callback(ContextType, ObjectType, Arguments &, ReturnValue &);
+
+    MethodMap<T> const methods = {
+        {"renameProperty", wrap<rename_property>},
+        {"copyProperty", wrap<copy_property>},
+        {"fillDefault", wrap<fill_default>},
+        {"deleteWhere", wrap<delete_where>},
+        {"setProgressCallback", wrap<set_progress_callback>},
+    };
+
+private:
+    static Migration<T>& validated_get(ObjectType object) {
+        auto migration = get_internal<T, MigrationClass<T>>(object);
+        if (!migration || !migration->realm) {
+            throw std::logic_error("Migration operations can only be used within the migration function.");
+        }
+        return *migration;
+    }
+
+    static ObjectSchema const& validated_object_schema(SharedRealm const& realm, std::string const& object_type) {
+        auto object_schema = realm->schema().find(object_type);
+        if (object_schema == realm->schema().end()) {
+            throw std::logic_error(util::format("Could not find schema for type '%1'", object_type));
+        }
+        return *object_schema;
+    }
+
+    static Property const& validated_property(ObjectSchema const& object_schema, std::string const& property_name) {
+        auto property = object_schema.property_for_name(property_name);
+        if (!property) {
+            throw std::invalid_argument(util::format("Property '%1' does not exist on object '%2'", property_name, object_schema.name));
+        }
+        return *property;
+    }
+
+    static MigrationValue value_from_js(ContextType, Migration<T>&, ObjectSchema const&, Property const&, ValueType);
+    static ValueType value_to_js(ContextType, NativeAccessor<T>&, MigrationValue const&);
+    static void report_progress(ContextType, Migration<T>&, const char* operation, std::string const& object_type, size_t done, size_t total);
+};
+
+template<typename T>
+MigrationValue MigrationClass<T>::value_from_js(ContextType ctx, Migration<T>& migration, ObjectSchema const& object_schema,
+                                                Property const& property, ValueType value) {
+    MigrationValue result;
+    result.type = migration::base_type(property.type);
+    if (Value::is_null(ctx, value) || Value::is_undefined(ctx, value)) {
+        if (!is_nullable(property.type)) {
+            throw std::invalid_argument(util::format("'%1.%2' must be of type '%3', got (%4)", object_schema.name, property.name,
+                                                     string_for_property_type(result.type), Value::is_null(ctx, value) ? "null" : "undefined"));
+        }
+        result.null = true;
+        return result;
+    }
+
+    NativeAccessor<T> accessor(ctx, migration.realm, object_schema);
+    switch (result.type) {
+        case realm::PropertyType::Int:
+            result.integer = accessor.template unbox<int64_t>(value);
+            break;
+        case realm::PropertyType::Bool:
+            result.integer = accessor.template unbox<bool>(value);
+            break;
+        case realm::PropertyType::Float:
+            result.number = accessor.template unbox<float>(value);
+            break;
+        case realm::PropertyType::Double:
+            result.number = accessor.template unbox<double>(value);
+            break;
+        case realm::PropertyType::String:
+            result.set_owned(std::string(accessor.template unbox<StringData>(value)));
+            break;
+        case realm::PropertyType::Data: {
+            BinaryData binary = accessor.template unbox<BinaryData>(value);
+            result.set_owned(std::string(binary.data(), binary.size()));
+            break;
+        }
+        case realm::PropertyType::Date:
+            result.timestamp = accessor.template unbox<Timestamp>(value);
+            break;
+        default:
+            REALM_UNREACHABLE();
+    }
+    return result;
+}
+
+template<typename T>
+typename T::Value MigrationClass<T>::value_to_js(ContextType ctx, NativeAccessor<T>& accessor, MigrationValue const& value) {
+    if (value.null) {
+        return Value::from_null(ctx);
+    }
+    switch (value.type) {
+        case realm::PropertyType::Int:
+            return accessor.box(value.integer);
+        case realm::PropertyType::Bool:
+            return accessor.box(value.integer != 0);
+        case realm::PropertyType::Float:
+        case realm::PropertyType::Double:
+            return accessor.box(value.number);
+        case realm::PropertyType::String:
+            return accessor.box(value.string_value());
+        case realm::PropertyType::Data:
+            return accessor.box(value.binary_value());
+        case realm::PropertyType::Date:
+            return accessor.box(value.timestamp);
+        default:
+            REALM_UNREACHABLE();
+    }
+}
+
+template<typename T>
+void MigrationClass<T>::report_progress(ContextType ctx, Migration<T>& migration, const char* operation,
+                                        std::string const& object_type, size_t done, size_t total) {
+    if (!migration.progress) {
+        return;
+    }
+    ValueType arguments[] = {
+        Value::from_string(ctx, operation),
+        Value::from_string(ctx, object_type),
+        Value::from_number(ctx, double(done)),
+        Value::from_number(ctx, double(total)),
+    };
+    Function::call(ctx, *migration.progress, 4, arguments);
+}
+
+template<typename T>
+void MigrationClass<T>::rename_property(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    args.validate_count(3);
+    auto& migration = validated_get(this_object);
+    std::string object_type = Value::validated_to_string(ctx, args[0], "objectType");
+    std::string old_name = Value::validated_to_string(ctx, args[1], "oldName");
+    std::string new_name = Value::validated_to_string(ctx, args[2], "newName");
+
+    ObjectStore::rename_property(migration.realm->read_group(), *migration.schema, object_type, old_name, new_name);
+}
+
+// Copies the values of a property of the old Realm to a property of the new
+// one, matching the objects by their position in the table. The objects of
+// the type therefore mustn't have been created or deleted before, which the
+// table's size and the deletions noted by the delegate tell.
+template<typename T>
+void MigrationClass<T>::copy_property(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    args.validate_between(3, 4);
+    auto& migration = validated_get(this_object);
+    std::string object_type = Value::validated_to_string(ctx, args[0], "objectType");
+    std::string from_name = Value::validated_to_string(ctx, args[1], "from");
+    std::string to_name = Value::validated_to_string(ctx, args[2], "to");
+
+    auto const& old_object_schema = validated_object_schema(migration.old_realm, object_type);
+    auto const& object_schema = validated_object_schema(migration.realm, object_type);
+    auto const& from = validated_property(old_object_schema, from_name);
+    auto const& to = validated_property(object_schema, to_name);
+
+    MigrationTransform transform = MigrationTransform::None;
+    util::Optional<FunctionType> transform_function;
+    if (args.count == 4 && !Value::is_undefined(ctx, args[3])) {
+        if (Value::is_function(ctx, args[3])) {
+            transform_function = Value::to_function(ctx, args[3]);
+        }
+        else {
+            std::string name = Value::validated_to_string(ctx, args[3], "transform");
+            if (name == "toString") {
+                transform = MigrationTransform::ToString;
+            }
+            else if (name == "toNumber") {
+                transform = MigrationTransform::ToNumber;
+            }
+            else if (name == "default") {
+                transform = MigrationTransform::Default;
+            }
+            else {
+                throw std::invalid_argument(util::format("Unknown transform '%1', expected 'toString', 'toNumber', 'default' or a function.", name));
+            }
+        }
+    }
+    if (transform_function) {
+        if (!migration::is_copyable(from) || !migration::is_copyable(to)) {
+            throw std::invalid_argument("Only properties of primitive types can be copied.");
+        }
+    }
+    else {
+        migration::validate_types(object_type, from, to, transform);
+    }
+
+    auto old_table = ObjectStore::table_for_object_type(migration.old_realm->read_group(), object_type);
+    auto table = ObjectStore::table_for_object_type(migration.realm->read_group(), object_type);
+    size_t count = table->size();
+    if (old_table->size() != count || get_delegate<T>(migration.realm.get())->objects_deleted_in_migration(table.get())) {
+        throw std::logic_error(util::format("Properties of '%1' can only be copied before its objects are created or deleted.", object_type));
+    }
+
+    util::Optional<MigrationValue> default_value;
+    if (transform == MigrationTransform::Default) {
+        auto object_defaults = migration.defaults.find(object_type);
+        util::Optional<ValueType> value;
+        if (object_defaults != migration.defaults.end()) {
+            auto it = object_defaults->second.find(to_name);
+            if (it != object_defaults->second.end()) {
+                value = ValueType(it->second);
+            }
+        }
+        default_value = value_from_js(ctx, migration, object_schema, to, value ? *value : Value::from_null(ctx));
+    }
+
+    util::Optional<NativeAccessor<T>> old_accessor;
+    if (transform_function) {
+        old_accessor.emplace(ctx, migration.old_realm, old_object_schema);
+    }
+
+    for (size_t row = 0; row < count; ++row) {
+        if (row && row % progress_interval == 0) {
+            report_progress(ctx, migration, "copyProperty", object_type, row, count);
+        }
+
+        MigrationValue value = migration::read(*old_table, from, row);
+        if (transform_function) {
+            // The values of each call are released before the next one.
+            HANDLESCOPE
+            ValueType argument = value_to_js(ctx, *old_accessor, value);
+            ValueType result = Function::call(ctx, *transform_function, 1, &argument);
+            migration::write(*table, to, row, value_from_js(ctx, migration, object_schema, to, result));
+            continue;
+        }
+        if (value.null) {
+            if (default_value) {
+                migration::write(*table, to, row, *default_value);
+                continue;
+            }
+            if (!is_nullable(to.type)) {
+                throw std::invalid_argument(util::format("Cannot copy null to the required property '%1.%2'. The 'default' transform writes its default value instead.",
+                                                         object_type, to_name));
+            }
+        }
+        else {
+            migration::convert(value, object_type, to);
+        }
+        migration::write(*table, to, row, value);
+    }
+    report_progress(ctx, migration, "copyProperty", object_type, count, count);
+}
+
+// Writes the default value of the schema, or the value given, to the property
+// of every object of the type.
+template<typename T>
+void MigrationClass<T>::fill_default(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    args.validate_between(2, 3);
+    auto& migration = validated_get(this_object);
+    std::string object_type = Value::validated_to_string(ctx, args[0], "objectType");
+    std::string property_name = Value::validated_to_string(ctx, args[1], "property");
+
+    auto const& object_schema = validated_object_schema(migration.realm, object_type);
+    auto const& property = validated_property(object_schema, property_name);
+    if (!migration::is_copyable(property)) {
+        throw std::invalid_argument("Only properties of primitive types can be filled.");
+    }
+
+    ValueType value;
+    if (args.count == 3) {
+        value = args[2];
+    }
+    else {
+        auto object_defaults = migration.defaults.find(object_type);
+        bool found = false;
+        if (object_defaults != migration.defaults.end()) {
+            auto it = object_defaults->second.find(property_name);
+            if (it != object_defaults->second.end()) {
+                value = it->second;
+                found = true;
+            }
+        }
+        if (!found) {
+            if (!is_nullable(property.type)) {
+                throw std::invalid_argument(util::format("Property '%1.%2' has no default value.", object_type, property_name));
+            }
+            value = Value::from_null(ctx);
+        }
+    }
+    MigrationValue default_value = value_from_js(ctx, migration, object_schema, property, value);
+
+    auto table = ObjectStore::table_for_object_type(migration.realm->read_group(), object_type);
+    size_t count = table->size();
+    for (size_t row = 0; row < count; ++row) {
+        if (row && row % progress_interval == 0) {
+            report_progress(ctx, migration, "fillDefault", object_type, row, count);
+        }
+        migration::write(*table, property, row, default_value);
+    }
+    report_progress(ctx, migration, "fillDefault", object_type, count, count);
+}
+
+// Deletes the objects of the new Realm matching the query, and returns how
+// many there were.
+template<typename T>
+void MigrationClass<T>::delete_where(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    args.validate_minimum(2);
+    auto& migration = validated_get(this_object);
+    std::string object_type = Value::validated_to_string(ctx, args[0], "objectType");
+    std::string query_string = Value::validated_to_string(ctx, args[1], "query");
+
+    validated_object_schema(migration.realm, object_type);
+    auto table = ObjectStore::table_for_object_type(migration.realm->read_group(), object_type);
+    auto parsed = ResultsClass<T>::parse_query(query_string);
+    ObjectType filtered = ResultsClass<T>::create_filtered(ctx, realm::Results(migration.realm, *table), *parsed,
+                                                           &args.value[2], args.count - 2);
+
+    auto& results = *get_internal<T, ResultsClass<T>>(filtered);
+    size_t count = results.size();
+    results.clear();
+    get_delegate<T>(migration.realm.get())->objects_deleted(table.get());
+    report_progress(ctx, migration, "deleteWhere", object_type, count, count);
+    return_value.set((double)count);
+}
+
+template<typename T>
+void MigrationClass<T>::set_progress_callback(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    args.validate_count(1);
+    auto& migration = validated_get(this_object);
+    if (Value::is_null(ctx, args[0])) {
+        migration.progress = util::none;
+        return;
+    }
+    auto callback = Value::validated_to_function(ctx, args[0], "callback");
+    migration.progress = Protected<FunctionType>(ctx, callback);
+}
+
+} // js
+} // realm
@@ -71,20 +71,48 @@ public:
 		}
 	}
 
-    OptionalValue value_for_property(ValueType dict, Property const& prop, size_t) {
+    // Lets an accessor which is kept between calls be used with the context
+    // of the current call.
+    void set_context(ContextType ctx) {
+        m_ctx = ctx;
+    }
+
+    // Set by callers which create many objects with one accessor, once for
+    // each of them, so that whether an object gives its property values as
+    // an array is checked once rather than for every property. Nested
+    // objects are created through accessors of their own.
+    void set_property_array(ValueType object, bool is_array) {
+        m_property_array = std::make_pair(object, is_array);
+    }
+
+    OptionalValue value_for_property(ValueType dict, Property const& prop, size_t prop_index) {
         ObjectType object = Value::validated_to_object(m_ctx, dict);
-        ValueType value = Object::get_property(m_ctx, object, !prop.public_name.empty() ? prop.public_name : prop.name);
+        ValueType value;
+        bool is_array = m_property_array && m_property_array->first == dict ? m_property_array->second : Value::is_array(m_ctx, object);
+        if (is_array) {
+            // Property values given as an array are in the order of the persisted properties.
+            value = Object::get_property(m_ctx, object, (uint32_t)prop_index);
+        }
+        else if (auto slot = creation_slot(m_object_schema, prop)) {
+            value = Object::get_property(m_ctx, object, slot->key);
+        }
+        else {
+            value = Object::get_property(m_ctx, object, String<JSEngine>::intern(!prop.public_name.empty() ? prop.public_name : prop.name));
+        }
         if (Value::is_undefined(m_ctx, value)) {
             return util::none;
         }
-        if (!Value::is_valid_for_property(m_ctx, value, prop)) {
+        if (!Value::is_valid_for_property(m_ctx, value, prop, dates_as_numbers())) {
             throw TypeErrorException(*this, m_object_schema->name, prop, value);
         }
         return value;
     }
 
     OptionalValue default_value_for_property(const ObjectSchema &object_schema, const Property &prop) {
-        auto defaults = get_delegate<JSEngine>(m_realm.get())->m_defaults[object_schema.name];
+        if (auto slot = creation_slot(&object_schema, prop)) {
+            return slot->has_default ? util::make_optional(ValueType(slot->default_value)) : util::none;
+        }
+        auto& defaults = get_delegate<JSEngine>(m_realm.get())->m_defaults[object_schema.name];
         auto it = defaults.find(prop.name);
         return it != defaults.end() ? util::make_optional(ValueType(it->second)) : util::none;
     }
@@ -104,7 +132,7 @@ public:
     ValueType box(int64_t number)    { return Value::from_number(m_ctx, number); }
     ValueType box(float number)      { return Value::from_number(m_ctx, number); }
     ValueType box(double number)     { return Value::from_number(m_ctx, number); }
-    ValueType box(StringData string) { return Value::from_string(m_ctx, string.data()); }
+    ValueType box(StringData string) { return Value::from_string(m_ctx, string); }
     ValueType box(BinaryData data)   { return Value::from_binary(m_ctx, data); }
     ValueType box(Mixed)             { throw std::runtime_error("'Any' type is unsupported"); }
 
@@ -112,7 +140,17 @@ public:
         if (ts.is_null()) {
             return null_value();
         }
-        return Object::create_date(m_ctx, ts.get_seconds() * 1000 + ts.get_nanoseconds() / 1000000);
+        double milliseconds = ts.get_seconds() * 1000 + ts.get_nanoseconds() / 1000000;
+        if (dates_as_numbers()) {
+            return Value::from_number(m_ctx, milliseconds);
+        }
+        return Object::create_date(m_ctx, milliseconds);
+    }
+
+    // Whether the Realm reads dates as numbers, and so also accepts them.
+    bool dates_as_numbers() const {
+        auto delegate = get_delegate<JSEngine>(m_realm.get());
+        return delegate && delegate->m_dates_as_numbers;
     }
     ValueType box(realm::Object realm_object) {
         return RealmObjectClass<JSEngine>::create_instance(m_ctx, std::move(realm_object));
@@ -168,6 +206,35 @@ private:
     const ObjectSchema* m_object_schema;
     std::string m_string_buffer;
     OwnedBinaryData m_owned_binary_data;
+    util::Optional<std::pair<ValueType, bool>> m_property_array;
+
+    using CreationPlan = typename RealmDelegate<JSEngine>::CreationPlan;
+    using CreationSlot = typename RealmDelegate<JSEngine>::CreationSlot;
+
+    // The plan for the object schema the last slot was looked up for, as
+    // creating an object looks up a slot for each of its properties in turn.
+    const ObjectSchema* m_plan_schema = nullptr;
+    const CreationPlan* m_plan = nullptr;
+
+    // Returns the creation plan's slot for one of the object schema's
+    // persisted properties, or null if it has none.
+    const CreationSlot* creation_slot(const ObjectSchema* object_schema, const Property& prop) {
+        if (!object_schema) {
+            return nullptr;
+        }
+        if (object_schema != m_plan_schema) {
+            auto delegate = get_delegate<JSEngine>(m_realm.get());
+            m_plan = delegate ? delegate->creation_plan(*object_schema) : nullptr;
+            m_plan_schema = object_schema;
+        }
+
+        auto& properties = object_schema->persisted_properties;
+        if (!m_plan || properties.empty() || &prop < &properties.front() || &prop > &properties.back()) {
+            return nullptr;
+        }
+        size_t index = &prop - &properties.front();
+        return index < m_plan->size() ? &(*m_plan)[index] : nullptr;
+    }
 
     template<typename, typename>
     friend struct _impl::Unbox;
@@ -263,6 +330,12 @@ struct Unbox<JSEngine, BinaryData> {
         }
 #endif
 
+        // The value outlives the write, so its contents can be used in place.
+        BinaryData view;
+        if (js::Value<JSEngine>::to_binary_view(ctx->m_ctx, value, view)) {
+            return view;
+        }
+
         ctx->m_owned_binary_data = js::Value<JSEngine>::validated_to_binary(ctx->m_ctx, value);
         return ctx->m_owned_binary_data.get();
     }
@@ -281,6 +354,11 @@ struct Unbox<JSEngine, Timestamp> {
         if (ctx->is_null(value)) {
             return Timestamp();
         }
+        // Milliseconds since the epoch, as dates are read as numbers.
+        if (ctx->dates_as_numbers() && js::Value<JSEngine>::is_number(ctx->m_ctx, value)) {
+            double milliseconds = js::Value<JSEngine>::to_number(ctx->m_ctx, value);
+            return Timestamp(int64_t(milliseconds / 1000), int32_t(((int64_t)milliseconds % 1000) * 1000000));
+        }
         typename JSEngine::Value date;
         if (js::Value<JSEngine>::is_string(ctx->m_ctx, value)) {
             // the incoming value might be a date string, so let the Date constructor have at it
@@ -316,8 +394,10 @@ struct Unbox<JSEngine, RowExpr> {
             throw NonRealmObjectException();
         }
 
-        if (Value::is_array(ctx->m_ctx, object)) {
-            object = Schema<JSEngine>::dict_for_property_array(ctx->m_ctx, *ctx->m_object_schema, object);
+        // Arrays of property values are read by value_for_property() in schema order.
+        if (Value::is_array(ctx->m_ctx, object) &&
+            js::Object<JSEngine>::validated_get_length(ctx->m_ctx, object) != ctx->m_object_schema->persisted_properties.size()) {
+            throw std::runtime_error("Array must contain values for all object properties");
         }
 
         auto child = realm::Object::create<ValueType>(*ctx, ctx->m_realm, *ctx->m_object_schema,
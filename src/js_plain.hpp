@@ -0,0 +1,569 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2020 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "js_types.hpp"
+
+#include "object.hpp"
+#include "object_schema.hpp"
+#include "property.hpp"
+#include "results.hpp"
+#include "shared_realm.hpp"
+
+#include <realm/link_view.hpp>
+#include <realm/table.hpp>
+#include <realm/util/base64.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace realm {
+namespace js {
+
+// Copies objects and collections into plain JS objects and arrays, or into a
+// JSON string, reading the rows directly rather than through the accessors of
+// each object. Links are followed up to the given depth, below which they are
+// null, and computed properties are left out.
+template<typename T>
+class PlainObjectBuilder {
+  public:
+    using ContextType = typename T::Context;
+    using ObjectType = typename T::Object;
+    using ValueType = typename T::Value;
+    using Object = js::Object<T>;
+    using Value = js::Value<T>;
+    using String = js::String<T>;
+
+    struct Options {
+        size_t depth = std::numeric_limits<size_t>::max();
+        // The properties of the objects at the top, all of them if none.
+        util::Optional<std::vector<std::string>> properties;
+        bool json = false;
+    };
+
+    static Options validated_options(ContextType ctx, Arguments<T> &args) {
+        args.validate_maximum(1);
+        return validated_options(ctx, args.count ? args[0] : Value::from_undefined(ctx));
+    }
+
+    static Options validated_options(ContextType ctx, ValueType value) {
+        static const String depth_string = "depth";
+        static const String properties_string = "properties";
+        static const String json_string = "json";
+
+        Options options;
+        if (Value::is_undefined(ctx, value)) {
+            return options;
+        }
+
+        ObjectType object = Value::validated_to_object(ctx, value, "options");
+        ValueType depth = Object::get_property(ctx, object, depth_string);
+        if (!Value::is_undefined(ctx, depth)) {
+            double number = Value::validated_to_number(ctx, depth, "depth");
+            if (!(number >= 0)) {
+                throw std::invalid_argument("The depth must be 0 or more.");
+            }
+            options.depth = number < double(std::numeric_limits<size_t>::max()) ? size_t(number) : std::numeric_limits<size_t>::max();
+        }
+        ValueType properties = Object::get_property(ctx, object, properties_string);
+        if (!Value::is_undefined(ctx, properties)) {
+            ObjectType array = Value::validated_to_array(ctx, properties, "properties");
+            uint32_t count = Object::validated_get_length(ctx, array);
+            options.properties = std::vector<std::string>();
+            options.properties->reserve(count);
+            for (uint32_t i = 0; i < count; ++i) {
+                options.properties->push_back(Object::validated_get_string(ctx, array, i));
+            }
+        }
+        ValueType json = Object::get_property(ctx, object, json_string);
+        if (!Value::is_undefined(ctx, json)) {
+            options.json = Value::validated_to_boolean(ctx, json, "json");
+        }
+        return options;
+    }
+
+    PlainObjectBuilder(ContextType ctx, SharedRealm realm, Options options)
+    : m_ctx(ctx), m_realm(std::move(realm)), m_schema(&m_realm->schema()), m_options(std::move(options)) {}
+
+    // Reads rows which aren't part of an open Realm, such as those of a frozen
+    // version, which then has to outlive the builder along with the schema.
+    PlainObjectBuilder(ContextType ctx, Schema const &schema, Options options)
+    : m_ctx(ctx), m_schema(&schema), m_options(std::move(options)) {}
+
+    ValueType object(realm::Object &object) {
+        return row(*object.row().get_table(), object.row().get_index(), object.get_object_schema());
+    }
+
+    ValueType row(Table &table, size_t row_index, ObjectSchema const &object_schema) {
+        if (m_options.json) {
+            std::string json;
+            append_object(json, table, row_index, object_schema, 0);
+            return Value::from_string(m_ctx, json);
+        }
+        return plain_object(table, row_index, object_schema, 0);
+    }
+
+    static void validate_collection(realm::Results const &results, Options const &options) {
+        if (options.properties && results.get_type() != PropertyType::Object) {
+            throw std::runtime_error("Property projection is only supported for collections of objects.");
+        }
+    }
+
+    ValueType collection(realm::Results &results) {
+        validate_collection(results, m_options);
+        bool objects = results.get_type() == PropertyType::Object;
+
+        size_t size = results.size();
+        if (m_options.json) {
+            std::string json = "[";
+            for (size_t i = 0; i < size; ++i) {
+                if (i > 0) {
+                    json += ',';
+                }
+                if (objects) {
+                    append_row(json, results.get(i), results.get_object_schema());
+                }
+                else {
+                    visit_value(results.get_type(), [&](auto tag) {
+                        return results.template get<typename decltype(tag)::type>(i);
+                    }, [&](auto value) { append(json, value); });
+                }
+            }
+            json += ']';
+            return Value::from_string(m_ctx, json);
+        }
+
+        ObjectType array = Object::create_array(m_ctx);
+        for (size_t i = 0; i < size; ++i) {
+            Object::set_property(m_ctx, array, uint32_t(i), element(results, i));
+        }
+        return array;
+    }
+
+    // Copies a single element of a collection, which validate_collection()
+    // has accepted, into a plain value, or into a JSON string of its own.
+    ValueType element(realm::Results &results, size_t index) {
+        if (results.get_type() == PropertyType::Object) {
+            auto row = results.get(index);
+            if (m_options.json) {
+                std::string json;
+                append_row(json, row, results.get_object_schema());
+                return Value::from_string(m_ctx, json);
+            }
+            return row.is_attached() ? plain_object(*row.get_table(), row.get_index(), results.get_object_schema(), 0)
+                                     : Value::from_null(m_ctx);
+        }
+        if (m_options.json) {
+            std::string json;
+            visit_value(results.get_type(), [&](auto tag) {
+                return results.template get<typename decltype(tag)::type>(index);
+            }, [&](auto value) { append(json, value); });
+            return Value::from_string(m_ctx, json);
+        }
+        return visit_value(results.get_type(), [&](auto tag) {
+            return results.template get<typename decltype(tag)::type>(index);
+        }, [&](auto value) { return box(value); });
+    }
+
+  private:
+    template<typename U>
+    struct TypeTag {
+        using type = U;
+    };
+
+    // The names of the properties of an object schema, both as JS strings
+    // and as JSON keys, so that each is only converted once per call.
+    struct Fields {
+        std::vector<const Property*> properties;
+        std::vector<String> names;
+        std::vector<std::string> keys;
+    };
+
+    // Rows are identified by their table and index, so that an object reached
+    // through several links is only copied once. Since links below the depth
+    // are null, copies are only shared by the rows reached with the same depth
+    // remaining.
+    using RowKey = std::pair<const Table*, size_t>;
+    using CopyKey = std::pair<RowKey, size_t>;
+
+    ContextType m_ctx;
+    SharedRealm m_realm;
+    Schema const *m_schema;
+    Options m_options;
+    std::unordered_map<const ObjectSchema*, Fields> m_fields;
+    util::Optional<Fields> m_top_fields;
+    std::map<CopyKey, ObjectType> m_objects;
+    std::set<RowKey> m_path;
+
+    Fields const& fields(ObjectSchema const& object_schema, size_t level) {
+        if (level == 0 && m_options.properties) {
+            if (!m_top_fields) {
+                m_top_fields = Fields();
+                for (auto &name : *m_options.properties) {
+                    auto property = object_schema.property_for_public_name(name);
+                    if (!property || property->type == PropertyType::LinkingObjects) {
+                        throw std::invalid_argument(util::format("Property '%1' does not exist on object '%2'", name, object_schema.name));
+                    }
+                    add_field(*m_top_fields, *property);
+                }
+            }
+            return *m_top_fields;
+        }
+
+        auto it = m_fields.find(&object_schema);
+        if (it == m_fields.end()) {
+            Fields fields;
+            for (auto &property : object_schema.persisted_properties) {
+                add_field(fields, property);
+            }
+            it = m_fields.emplace(&object_schema, std::move(fields)).first;
+        }
+        return it->second;
+    }
+
+    void add_field(Fields &fields, Property const& property) {
+        auto &name = !property.public_name.empty() ? property.public_name : property.name;
+        fields.properties.push_back(&property);
+        if (m_options.json) {
+            std::string key;
+            append(key, StringData(name));
+            key += ':';
+            fields.keys.push_back(std::move(key));
+        }
+        else {
+            fields.names.push_back(String::intern(name));
+        }
+    }
+
+    ObjectSchema const& linked_schema(Property const& property) {
+        return *m_schema->find(property.object_type);
+    }
+
+    // Calls `sink` with the value `get` reads for a property or collection of
+    // the type, as the type core stores it.
+    template<typename Get, typename Sink>
+    static auto visit_value(PropertyType type, Get &&get, Sink &&sink) {
+        bool nullable = is_nullable(type);
+        switch (type & ~PropertyType::Flags) {
+            case PropertyType::Bool:
+                return nullable ? sink(get(TypeTag<util::Optional<bool>>())) : sink(util::Optional<bool>(get(TypeTag<bool>())));
+            case PropertyType::Int:
+                return nullable ? sink(get(TypeTag<util::Optional<int64_t>>())) : sink(util::Optional<int64_t>(get(TypeTag<int64_t>())));
+            case PropertyType::Float:
+                return nullable ? sink(get(TypeTag<util::Optional<float>>())) : sink(util::Optional<float>(get(TypeTag<float>())));
+            case PropertyType::Double:
+                return nullable ? sink(get(TypeTag<util::Optional<double>>())) : sink(util::Optional<double>(get(TypeTag<double>())));
+            case PropertyType::String:
+                return sink(get(TypeTag<StringData>()));
+            case PropertyType::Data:
+                return sink(get(TypeTag<BinaryData>()));
+            case PropertyType::Date:
+                return sink(get(TypeTag<Timestamp>()));
+            default:
+                throw std::runtime_error(util::format("Properties of type '%1' can't be copied.", string_for_property_type(type & ~PropertyType::Flags)));
+        }
+    }
+
+    template<typename Sink>
+    static auto visit_value(Table &table, size_t column, size_t row, PropertyType type, Sink &&sink) {
+        return visit_value(type, [&](auto tag) {
+            return table.template get<typename decltype(tag)::type>(column, row);
+        }, std::forward<Sink>(sink));
+    }
+
+    // Plain JS values.
+
+    ValueType plain_object(Table &table, size_t row, ObjectSchema const& object_schema, size_t level) {
+        // The objects at the top only have the projected properties, so
+        // they aren't shared with the links.
+        bool shared = level > 0 || !m_options.properties;
+        size_t remaining = m_options.depth == std::numeric_limits<size_t>::max() ? m_options.depth : m_options.depth - level;
+        CopyKey key(RowKey(&table, row), remaining);
+        if (shared) {
+            auto it = m_objects.find(key);
+            if (it != m_objects.end()) {
+                return it->second;
+            }
+        }
+
+        ObjectType object = Object::create_empty(m_ctx);
+        if (shared) {
+            m_objects.emplace(key, object);
+        }
+        auto &fields = this->fields(object_schema, level);
+        for (size_t i = 0; i < fields.properties.size(); ++i) {
+            Object::set_property(m_ctx, object, fields.names[i], plain_value(table, row, *fields.properties[i], level));
+        }
+        return object;
+    }
+
+    ValueType plain_value(Table &table, size_t row, Property const& property, size_t level) {
+        size_t column = property.table_column;
+        bool link = (property.type & ~PropertyType::Flags) == PropertyType::Object;
+        if (link && level >= m_options.depth) {
+            return Value::from_null(m_ctx);
+        }
+
+        if (is_array(property.type)) {
+            ObjectType array = Object::create_array(m_ctx);
+            if (link) {
+                auto links = table.get_linklist(column, row);
+                auto &target = links->get_target_table();
+                auto &target_schema = linked_schema(property);
+                for (size_t i = 0, size = links->size(); i < size; ++i) {
+                    Object::set_property(m_ctx, array, uint32_t(i), plain_object(target, links->get_target_row(i), target_schema, level + 1));
+                }
+            }
+            else {
+                // Lists of values are kept in the first column of a subtable.
+                auto values = table.get_subtable(column, row);
+                auto type = property.type & ~PropertyType::Array;
+                for (size_t i = 0, size = values->size(); i < size; ++i) {
+                    Object::set_property(m_ctx, array, uint32_t(i), visit_value(*values, 0, i, type, [&](auto value) { return box(value); }));
+                }
+            }
+            return array;
+        }
+
+        if (link) {
+            if (table.is_null_link(column, row)) {
+                return Value::from_null(m_ctx);
+            }
+            return plain_object(*table.get_link_target(column), table.get_link(column, row), linked_schema(property), level + 1);
+        }
+        return visit_value(table, column, row, property.type, [&](auto value) { return box(value); });
+    }
+
+    template<typename U>
+    ValueType box(util::Optional<U> value) {
+        return value ? Value::from_number(m_ctx, double(*value)) : Value::from_null(m_ctx);
+    }
+    ValueType box(util::Optional<bool> value) {
+        return value ? Value::from_boolean(m_ctx, *value) : Value::from_null(m_ctx);
+    }
+    ValueType box(StringData string) {
+        return Value::from_string(m_ctx, string);
+    }
+    ValueType box(BinaryData data) {
+        // Copied, so that the plain object doesn't refer to the file.
+        return Value::from_binary(m_ctx, data);
+    }
+    ValueType box(Timestamp timestamp) {
+        return timestamp.is_null() ? Value::from_null(m_ctx) : Value::from_timestamp(m_ctx, timestamp);
+    }
+
+    // JSON.
+
+    void append_row(std::string &json, RowExpr row, ObjectSchema const& object_schema) {
+        if (!row.is_attached()) {
+            json += "null";
+            return;
+        }
+        append_object(json, *row.get_table(), row.get_index(), object_schema, 0);
+    }
+
+    void append_object(std::string &json, Table &table, size_t row, ObjectSchema const& object_schema, size_t level) {
+        // Unlike plain objects, JSON can't refer back to an object.
+        RowKey key(&table, row);
+        if (!m_path.insert(key).second) {
+            throw std::logic_error(util::format("Cannot write a cycle of links between '%1' objects as JSON. "
+                                                "A depth can be given to stop before it.", object_schema.name));
+        }
+
+        auto &fields = this->fields(object_schema, level);
+        json += '{';
+        for (size_t i = 0; i < fields.properties.size(); ++i) {
+            if (i > 0) {
+                json += ',';
+            }
+            json += fields.keys[i];
+            append_value(json, table, row, *fields.properties[i], level);
+        }
+        json += '}';
+        m_path.erase(key);
+    }
+
+    void append_value(std::string &json, Table &table, size_t row, Property const& property, size_t level) {
+        size_t column = property.table_column;
+        bool link = (property.type & ~PropertyType::Flags) == PropertyType::Object;
+        if (link && level >= m_options.depth) {
+            json += "null";
+            return;
+        }
+
+        if (is_array(property.type)) {
+            json += '[';
+            if (link) {
+                auto links = table.get_linklist(column, row);
+                auto &target = links->get_target_table();
+                auto &target_schema = linked_schema(property);
+                for (size_t i = 0, size = links->size(); i < size; ++i) {
+                    if (i > 0) {
+                        json += ',';
+                    }
+                    append_object(json, target, links->get_target_row(i), target_schema, level + 1);
+                }
+            }
+            else {
+                auto values = table.get_subtable(column, row);
+                auto type = property.type & ~PropertyType::Array;
+                for (size_t i = 0, size = values->size(); i < size; ++i) {
+                    if (i > 0) {
+                        json += ',';
+                    }
+                    visit_value(*values, 0, i, type, [&](auto value) { append(json, value); });
+                }
+            }
+            json += ']';
+            return;
+        }
+
+        if (link) {
+            if (table.is_null_link(column, row)) {
+                json += "null";
+                return;
+            }
+            append_object(json, *table.get_link_target(column), table.get_link(column, row), linked_schema(property), level + 1);
+            return;
+        }
+        visit_value(table, column, row, property.type, [&](auto value) { append(json, value); });
+    }
+
+    template<typename U>
+    static void append(std::string &json, util::Optional<U> value) {
+        if (value) {
+            append(json, *value);
+        }
+        else {
+            json += "null";
+        }
+    }
+
+    static void append(std::string &json, bool value) {
+        json += value ? "true" : "false";
+    }
+
+    static void append(std::string &json, int64_t value) {
+        json += std::to_string(value);
+    }
+
+    static void append(std::string &json, float value) {
+        append(json, double(value));
+    }
+
+    // As JSON.stringify() does, with the shortest of the precisions which
+    // read back as the same number.
+    static void append(std::string &json, double value) {
+        if (!std::isfinite(value)) {
+            json += "null";
+            return;
+        }
+        char number[32];
+        snprintf(number, sizeof(number), "%.15g", value);
+        if (strtod(number, nullptr) != value) {
+            snprintf(number, sizeof(number), "%.17g", value);
+        }
+        json += number;
+    }
+
+    static void append(std::string &json, StringData string) {
+        if (string.is_null()) {
+            json += "null";
+            return;
+        }
+        json += '"';
+        for (size_t i = 0; i < string.size(); ++i) {
+            char c = string.data()[i];
+            switch (c) {
+                case '"': json += "\\\""; break;
+                case '\\': json += "\\\\"; break;
+                case '\b': json += "\\b"; break;
+                case '\f': json += "\\f"; break;
+                case '\n': json += "\\n"; break;
+                case '\r': json += "\\r"; break;
+                case '\t': json += "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        char escaped[8];
+                        snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                        json += escaped;
+                    }
+                    else {
+                        json += c;
+                    }
+            }
+        }
+        json += '"';
+    }
+
+    // Binary data is written in base64, which is also what a Realm with sync
+    // reads back into a data property.
+    static void append(std::string &json, BinaryData data) {
+        if (data.is_null()) {
+            json += "null";
+            return;
+        }
+        std::vector<char> encoded(util::base64_encoded_size(data.size()));
+        size_t size = util::base64_encode(data.data(), data.size(), encoded.data(), encoded.size());
+        json += '"';
+        json.append(encoded.data(), size);
+        json += '"';
+    }
+
+    // As Date.prototype.toJSON() does, in UTC with milliseconds.
+    static void append(std::string &json, Timestamp timestamp) {
+        if (timestamp.is_null()) {
+            json += "null";
+            return;
+        }
+        static const int64_t ms_per_day = 86400000;
+        int64_t ms = timestamp.get_seconds() * 1000 + timestamp.get_nanoseconds() / 1000000;
+        int64_t days = ms / ms_per_day - (ms % ms_per_day < 0 ? 1 : 0);
+        int64_t ms_of_day = ms - days * ms_per_day;
+
+        // The civil date of the days since 1970-01-01, in the proleptic
+        // Gregorian calendar.
+        days += 719468;
+        int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+        int64_t day_of_era = days - era * 146097;
+        int64_t year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+        int64_t day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+        int64_t month_index = (5 * day_of_year + 2) / 153;
+        int64_t day = day_of_year - (153 * month_index + 2) / 5 + 1;
+        int64_t month = month_index < 10 ? month_index + 3 : month_index - 9;
+        int64_t year = year_of_era + era * 400 + (month <= 2 ? 1 : 0);
+
+        char date[40];
+        snprintf(date, sizeof(date), "\"%04lld-%02d-%02dT%02d:%02d:%02d.%03dZ\"", (long long)year, int(month), int(day),
+                 int(ms_of_day / 3600000), int(ms_of_day / 60000 % 60), int(ms_of_day / 1000 % 60), int(ms_of_day % 1000));
+        json += date;
+    }
+};
+
+} // js
+} // realm
@@ -23,10 +23,18 @@
 #include "js_util.hpp"
 #include "js_realm_object.hpp"
 #include "js_list.hpp"
+#include "js_migration.hpp"
+#include "js_frozen.hpp"
 #include "js_results.hpp"
 #include "js_schema.hpp"
 #include "js_observable.hpp"
+#include "js_thread_safe_references.hpp"
+#include "boundary_stats.hpp"
+#include "file_maintenance.hpp"
+#include "in_memory_snapshot.hpp"
+#include "trace_events.hpp"
 #include "platform.hpp"
+#include "write_copy_task.hpp"
 
 #if REALM_ENABLE_SYNC
 #include "js_sync.hpp"
@@ -40,14 +48,27 @@
 #include "results.hpp"
 #include "shared_realm.hpp"
 #include "thread_safe_reference.hpp"
+#include "util/event_loop_dispatcher.hpp"
 
 #include <realm/disable_sync_to_disk.hpp>
+#include <realm/group_shared.hpp>
+#include <realm/history.hpp>
 #include <realm/util/file.hpp>
+#include <realm/util/file_mapper.hpp>
 #include <realm/util/scope_exit.hpp>
 
+#include <algorithm>
+#include <atomic>
 #include <cctype>
-#include <list>
+#include <chrono>
+#include <functional>
+#include <future>
 #include <map>
+#include <memory>
+#include <ostream>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace realm {
 namespace js {
@@ -68,19 +89,26 @@ static std::string normalize_realm_path(std::string path) {
 
 template<typename T> class RealmClass;
 template<typename T> class AsyncOpenTaskClass;
+template<typename T> class WriteCopyTaskClass;
+template<typename T> struct RealmObjectClass;
 
 template<typename T>
 class RealmDelegate : public BindingContext {
 private:
     void did_change(std::vector<ObserverState> const&, std::vector<void*> const&, bool) override {
+        TraceScope trace("notification", "Realm change listeners");
         HANDLESCOPE
+        update_object_cache();
+        run_change_callbacks();
         notify(m_notifications, "change");
+        did_advance();
     }
 
     void schema_did_change(realm::Schema const& schema) override {
+        build_property_slots(schema);
+
         HANDLESCOPE
-        ObjectType schema_object = Schema<T>::object_for_schema(m_context, schema);
-        notify(m_schema_notifications, "schema", schema_object);
+        notify(m_schema_notifications, "schema", schema_object(schema));
     }
 
     void before_notify() override {
@@ -89,24 +117,42 @@ private:
     }
 
 public:
+    using ContextType = typename T::Context;
     using GlobalContextType = typename T::GlobalContext;
     using FunctionType = typename T::Function;
     using ObjectType = typename T::Object;
     using ValueType = typename T::Value;
     using Value = js::Value<T>;
+    using Object = js::Object<T>;
+    using String = js::String<T>;
 
     using ObjectDefaultsMap = typename Schema<T>::ObjectDefaultsMap;
     using ConstructorMap = typename Schema<T>::ConstructorMap;
 
-    RealmDelegate(std::weak_ptr<realm::Realm> realm, GlobalContextType ctx) : m_context(ctx), m_realm(realm) {}
+    RealmDelegate(std::weak_ptr<realm::Realm> realm, GlobalContextType ctx) : m_context(ctx), m_realm(realm) {
+        delegates().insert(this);
+    }
 
     ~RealmDelegate() {
-        // All protected values need to be unprotected while the context is retained.
-        m_defaults.clear();
-        m_constructors.clear();
-        m_notifications.clear();
-        m_schema_notifications.clear();
-        m_before_notify_notifications.clear();
+        delegates().erase(this);
+        release();
+    }
+
+    // Closes the Realms opened on this thread, which releases everything
+    // their delegates keep alive in the context.
+    static void close_all() {
+        auto open = delegates();
+        for (auto delegate : open) {
+            if (!delegates().count(delegate)) {
+                continue;
+            }
+            if (auto realm = delegate->m_realm.lock()) {
+                realm->close();
+            }
+            if (delegates().count(delegate)) {
+                delegate->release();
+            }
+        }
     }
 
     void add_notification(FunctionType notification) {
@@ -118,7 +164,7 @@ public:
     }
 
     void remove_all_notifications() {
-        m_notifications.clear();
+        m_notifications.reset();
     }
 
     void add_schema_notification(FunctionType notification) {
@@ -133,7 +179,7 @@ public:
     }
 
     void remove_all_schema_notifications() {
-        m_schema_notifications.clear();
+        m_schema_notifications.reset();
     }
 
     void add_before_notify_notification(FunctionType notification) {
@@ -145,37 +191,509 @@ public:
     }
 
     void remove_all_before_notify_notification() {
-        m_before_notify_notifications.clear();
+        m_before_notify_notifications.reset();
+    }
+
+    std::shared_ptr<LiveWrapperCounts> const& live_wrapper_counts() const {
+        return m_live_counts;
+    }
+
+    // How long the Realm has been reading the version it is at.
+    double read_version_age_ms() const {
+        std::chrono::duration<double, std::milli> age = std::chrono::steady_clock::now() - m_read_since;
+        return age.count();
+    }
+
+    // The age of the oldest version read by the Realms of this thread which
+    // have the file at `path` open.
+    static double oldest_read_version_age_ms(std::string const& path) {
+        double oldest = 0;
+        for (auto delegate : delegates()) {
+            auto realm = delegate->m_realm.lock();
+            if (realm && !realm->is_closed() && realm->config().path == path) {
+                oldest = std::max(oldest, delegate->read_version_age_ms());
+            }
+        }
+        return oldest;
+    }
+
+    // Calls `callback` with the Realm and the number of versions of its file
+    // each time the number goes above `threshold`.
+    void set_pinned_versions_warning(ContextType ctx, uint64_t threshold, util::Optional<FunctionType> callback) {
+        if (callback) {
+            m_versions_watcher = std::make_unique<PinnedVersionsWatcher>(threshold);
+            m_versions_warning = Protected<FunctionType>(ctx, *callback);
+            check_pinned_versions();
+        }
+        else {
+            m_versions_watcher.reset();
+            m_versions_warning.reset();
+        }
+    }
+
+    // Called when the Realm has moved to a newer version, either by
+    // refreshing or by committing a write.
+    void did_advance() {
+        m_read_since = std::chrono::steady_clock::now();
+        check_pinned_versions();
+    }
+
+    // Registers a callback run whenever the Realm changes, for listeners
+    // whose changes the notifiers do not report. It is dropped once the
+    // callback is destroyed.
+    void add_change_callback(std::weak_ptr<std::function<void()>> callback) {
+        m_change_callbacks.push_back(std::move(callback));
+    }
+
+    // Registers a callback run once when the Realm is closed through close(),
+    // for work which waits on notifications a closed Realm never delivers.
+    void add_close_callback(std::weak_ptr<std::function<void()>> callback) {
+        auto& callbacks = m_close_callbacks;
+        callbacks.erase(std::remove_if(callbacks.begin(), callbacks.end(), [](auto& callback) {
+            return callback.expired();
+        }), callbacks.end());
+        callbacks.push_back(std::move(callback));
+    }
+
+    // Called before the Realm is closed.
+    void will_close() {
+        auto callbacks = std::move(m_close_callbacks);
+        m_close_callbacks.clear();
+        for (auto& weak : callbacks) {
+            if (auto callback = weak.lock()) {
+                (*callback)();
+            }
+        }
+    }
+
+    // Calls `hook` with the event name, the listener and the milliseconds it
+    // took after each listener is called.
+    void set_dispatch_hook(ContextType ctx, util::Optional<FunctionType> hook) {
+        if (hook) {
+            m_dispatch_hook = Protected<FunctionType>(ctx, *hook);
+        }
+        else {
+            m_dispatch_hook.reset();
+        }
+    }
+
+    // Resolves a public property name through the slot table built for the
+    // Realm's current schema, falling back to a scan of the object schema for
+    // object schemas which are not part of it. The property found last is
+    // compared first, as the same property tends to be read over and over.
+    const Property* property_for_public_name(const ObjectSchema& object_schema, StringData name) const {
+        if (m_last_slot.object_schema == &object_schema && m_last_slot.name == name) {
+            return m_last_slot.property;
+        }
+        auto slots = m_property_slots.find(&object_schema);
+        if (slots == m_property_slots.end()) {
+            return object_schema.property_for_public_name(name);
+        }
+        auto it = slots->second.find(name);
+        if (it == slots->second.end()) {
+            return nullptr;
+        }
+        m_last_slot = {&object_schema, it->first, it->second};
+        return it->second;
+    }
+
+    // What creating an object of a type needs for each of its persisted
+    // properties, in the order of the object schema's persisted properties.
+    struct CreationSlot {
+        String key;
+        Protected<ValueType> default_value;
+        bool has_default;
+    };
+    using CreationPlan = std::vector<CreationSlot>;
+
+    // Returns the plan built for the Realm's current schema, or null for
+    // object schemas which are not part of it.
+    const CreationPlan* creation_plan(const ObjectSchema& object_schema) const {
+        auto it = m_creation_plans.find(&object_schema);
+        return it != m_creation_plans.end() ? &it->second : nullptr;
+    }
+
+    // The Realm's schema as frozen JS objects, built on first use and
+    // dropped when the schema changes.
+    ObjectType schema_object(realm::Schema const& schema) {
+        if (!m_schema_object) {
+            ObjectType array = Object::create_array(m_context);
+            uint32_t count = 0;
+            for (auto& object_schema : schema) {
+                Object::set_property(m_context, array, count++, object_schema_object(object_schema));
+            }
+            freeze(array);
+            m_schema_object = Protected<ObjectType>(m_context, array);
+        }
+        return *m_schema_object;
+    }
+
+    // Object schemas which are not part of the current schema get a new
+    // object each time.
+    ObjectType object_schema_object(ObjectSchema const& object_schema) {
+        auto it = m_object_schema_objects.find(&object_schema);
+        if (it != m_object_schema_objects.end()) {
+            return it->second;
+        }
+
+        ObjectType object = Schema<T>::object_for_object_schema(m_context, object_schema);
+        if (!m_property_slots.count(&object_schema)) {
+            return object;
+        }
+        static const String properties_string = "properties";
+        ObjectType properties = Object::validated_get_object(m_context, object, properties_string);
+        auto freeze_property = [&](const Property& prop) {
+            auto& name = prop.public_name.empty() ? prop.name : prop.public_name;
+            freeze(Object::validated_get_object(m_context, properties, name));
+        };
+        for (auto& prop : object_schema.persisted_properties) {
+            freeze_property(prop);
+        }
+        for (auto& prop : object_schema.computed_properties) {
+            freeze_property(prop);
+        }
+        freeze(properties);
+        freeze(object);
+
+        m_object_schema_objects.emplace(&object_schema, Protected<ObjectType>(m_context, object));
+        return object;
+    }
+
+    // The key paths queries on the Realm's current schema are parsed with,
+    // built on first use.
+    parser::KeyPathMapping const& keypath_mapping(realm::Realm& realm) {
+        if (!m_keypath_mapping) {
+            m_keypath_mapping.emplace();
+            realm::populate_keypath_mapping(*m_keypath_mapping, realm);
+        }
+        return *m_keypath_mapping;
+    }
+
+    void build_property_slots(realm::Schema const& schema) {
+        m_property_slots.clear();
+        m_last_slot = {};
+        m_creation_plans.clear();
+        m_schema_object.reset();
+        m_object_schema_objects.clear();
+        m_keypath_mapping.reset();
+        for (auto& object_schema : schema) {
+            auto defaults = m_defaults.find(object_schema.name);
+            auto& plan = m_creation_plans[&object_schema];
+            plan.reserve(object_schema.persisted_properties.size());
+            for (auto& prop : object_schema.persisted_properties) {
+                auto key = String::intern(prop.public_name.empty() ? prop.name : prop.public_name);
+                if (defaults != m_defaults.end()) {
+                    auto value = defaults->second.find(prop.name);
+                    if (value != defaults->second.end()) {
+                        plan.push_back({key, value->second, true});
+                        continue;
+                    }
+                }
+                plan.push_back({key, {}, false});
+            }
+
+            auto& slots = m_property_slots[&object_schema];
+            auto add_slot = [&](const Property& prop) {
+                auto& name = prop.public_name.empty() ? prop.name : prop.public_name;
+                slots.emplace(name, &prop);
+                // Interning the name lets engines recognize it when it is
+                // used as a property key without converting it.
+                String::intern(name);
+            };
+            for (auto& prop : object_schema.persisted_properties) {
+                add_slot(prop);
+            }
+            for (auto& prop : object_schema.computed_properties) {
+                add_slot(prop);
+            }
+        }
+    }
+
+    // Returns the wrapper previously created for the row, if it is still alive
+    // and still refers to that row.
+    bool get_cached_object(ContextType ctx, const Row& row, ObjectType& object) {
+        auto table = m_object_cache.find(row.get_table());
+        if (table == m_object_cache.end()) {
+            return false;
+        }
+        auto it = table->second.find(row.get_index());
+        if (it == table->second.end()) {
+            return false;
+        }
+        if (it->second.row.is_attached() && it->second.row.get_index() == row.get_index() &&
+            it->second.object.get(ctx, object)) {
+            return true;
+        }
+        table->second.erase(it);
+        return false;
+    }
+
+    // The internal of the wrapper identifies the entry, as the wrapper itself
+    // may be collected before it is finalized.
+    void cache_object(ContextType ctx, const Row& row, const ObjectType& object, const void* internal) {
+        auto& rows = m_object_cache[row.get_table()];
+        rows.erase(row.get_index());
+        rows.emplace(row.get_index(), CachedObject{row, Weak<ObjectType>(ctx, object), internal});
+    }
+
+    // Drops the entry of a wrapper which is finalized, unless the row was
+    // cached again for another wrapper since.
+    void uncache_object(const Row& row, const void* internal) {
+        if (!row.is_attached()) {
+            return;
+        }
+        auto table = m_object_cache.find(row.get_table());
+        if (table == m_object_cache.end()) {
+            return;
+        }
+        auto it = table->second.find(row.get_index());
+        if (it != table->second.end() && it->second.internal == internal) {
+            table->second.erase(it);
+            if (table->second.empty()) {
+                m_object_cache.erase(table);
+            }
+        }
+    }
+
+    // Notes the table objects were deleted from during a migration, or null
+    // if they may have been deleted from any of them. Creating objects only
+    // adds rows, so together with the table's size this tells whether its
+    // objects are still where they were in the old Realm.
+    void objects_deleted(const Table* table = nullptr) {
+        auto realm = m_realm.lock();
+        if (realm && realm->is_in_migration()) {
+            m_migration_deletions.insert(table);
+        }
+    }
+
+    bool objects_deleted_in_migration(const Table* table) const {
+        return m_migration_deletions.count(table) || m_migration_deletions.count(nullptr);
+    }
+
+    void migration_began() {
+        m_migration_deletions.clear();
+    }
+
+    // Rows are moved when other rows are deleted. Each entry holds a row
+    // accessor that core keeps pointing at its row, so only the entries whose
+    // row was deleted or moved, or whose wrapper was collected, are dropped or
+    // rekeyed, without reading the wrappers themselves.
+    void update_object_cache(const Table* changed_table = nullptr) {
+        for (auto table = m_object_cache.begin(); table != m_object_cache.end();) {
+            if (changed_table && table->first != changed_table) {
+                ++table;
+                continue;
+            }
+
+            auto& rows = table->second;
+            std::vector<CachedObject> moved;
+            for (auto it = rows.begin(); it != rows.end();) {
+                bool alive = it->second.row.is_attached() && !it->second.object.expired();
+                if (alive && it->second.row.get_index() == it->first) {
+                    ++it;
+                    continue;
+                }
+                if (alive) {
+                    moved.push_back(std::move(it->second));
+                }
+                it = rows.erase(it);
+            }
+            for (auto& entry : moved) {
+                size_t index = entry.row.get_index();
+                rows.erase(index);
+                rows.emplace(index, std::move(entry));
+            }
+
+            if (rows.empty()) {
+                table = m_object_cache.erase(table);
+            }
+            else {
+                ++table;
+            }
+        }
     }
 
     ObjectDefaultsMap m_defaults;
     ConstructorMap m_constructors;
 
+    // Create objects from per-schema templates with an accessor for each
+    // property rather than resolving every access through the interceptor.
+    bool m_accessor_templates = false;
+
+    // Hand out the same wrapper for a row for as long as it is alive, rather
+    // than creating a new one each time the row is reached.
+    bool m_cache_objects = false;
+
+    // Read Date properties as milliseconds since the epoch rather than as
+    // Date objects.
+    bool m_dates_as_numbers = false;
+
+    // Snapshots an in-memory Realm opened with `inMemory: {persistTo}`.
+    std::unique_ptr<InMemorySnapshotWriter> m_snapshot_writer;
+
   private:
+    struct CachedObject {
+        Row row;
+        Weak<ObjectType> object;
+        const void* internal;
+    };
+    using ObjectCache = std::unordered_map<const Table*, std::unordered_map<size_t, CachedObject>>;
+
+    ObjectCache m_object_cache;
+    std::vector<std::weak_ptr<std::function<void()>>> m_change_callbacks;
+    std::vector<std::weak_ptr<std::function<void()>>> m_close_callbacks;
+    struct StringDataHash {
+        size_t operator()(StringData value) const noexcept {
+            // FNV-1a, which is cheap for the short names of properties.
+            size_t hash = 2166136261u;
+            for (size_t i = 0; i < value.size(); ++i) {
+                hash = (hash ^ static_cast<unsigned char>(value[i])) * 16777619u;
+            }
+            return hash;
+        }
+    };
+    struct SlotHit {
+        const ObjectSchema* object_schema = nullptr;
+        StringData name;
+        const Property* property = nullptr;
+    };
+
+    // The names are those of the properties of the current schema, which is
+    // kept for as long as the table is.
+    std::unordered_map<const ObjectSchema*, std::unordered_map<StringData, const Property*, StringDataHash>> m_property_slots;
+    mutable SlotHit m_last_slot;
+    std::unordered_map<const ObjectSchema*, CreationPlan> m_creation_plans;
+    util::Optional<Protected<ObjectType>> m_schema_object;
+    std::unordered_map<const ObjectSchema*, Protected<ObjectType>> m_object_schema_objects;
+    util::Optional<parser::KeyPathMapping> m_keypath_mapping;
     Protected<GlobalContextType> m_context;
-    std::list<Protected<FunctionType>> m_notifications;
-    std::list<Protected<FunctionType>> m_schema_notifications;
-    std::list<Protected<FunctionType>> m_before_notify_notifications;
+    // Listeners are shared with the dispatch in progress, if any, and only
+    // copied when they are changed while it holds them.
+    using Notifications = std::shared_ptr<std::vector<Protected<FunctionType>>>;
+
+    Notifications m_notifications;
+    Notifications m_schema_notifications;
+    Notifications m_before_notify_notifications;
+    util::Optional<Protected<FunctionType>> m_dispatch_hook;
     std::weak_ptr<realm::Realm> m_realm;
 
-    void add(std::list<Protected<FunctionType>>& notifications, FunctionType fn) {
-        if (std::find(notifications.begin(), notifications.end(), fn) != notifications.end()) {
+    // The Realm object passed to listeners, reused while it is alive.
+    util::Optional<Weak<ObjectType>> m_realm_object;
+
+    std::shared_ptr<LiveWrapperCounts> m_live_counts = std::make_shared<LiveWrapperCounts>();
+    std::chrono::steady_clock::time_point m_read_since = std::chrono::steady_clock::now();
+    std::unique_ptr<PinnedVersionsWatcher> m_versions_watcher;
+    std::unordered_set<const Table*> m_migration_deletions;
+    util::Optional<Protected<FunctionType>> m_versions_warning;
+
+    void check_pinned_versions() {
+        if (!m_versions_watcher) {
+            return;
+        }
+        auto realm = m_realm.lock();
+        uint64_t versions = 0;
+        if (!realm || realm->is_closed() || !m_versions_watcher->check(*realm, versions)) {
+            return;
+        }
+        HANDLESCOPE
+        Protected<FunctionType> callback = *m_versions_warning;
+        ObjectType object = realm_object(realm);
+        ValueType arguments[] = {object, Value::from_number(m_context, double(versions))};
+        Function<T>::callback(m_context, callback, object, 2, arguments);
+    }
+
+    // All protected values need to be unprotected while the context is retained.
+    void release() {
+        m_defaults.clear();
+        m_constructors.clear();
+        m_notifications.reset();
+        m_schema_notifications.reset();
+        m_before_notify_notifications.reset();
+        m_dispatch_hook.reset();
+        m_versions_warning.reset();
+        m_versions_watcher.reset();
+        m_realm_object.reset();
+        m_object_cache.clear();
+        m_change_callbacks.clear();
+        m_close_callbacks.clear();
+        m_creation_plans.clear();
+        m_schema_object.reset();
+        m_object_schema_objects.clear();
+    }
+
+    void freeze(ObjectType object) {
+        static const String object_string = "Object";
+        ValueType argument = object;
+        ObjectType object_constructor = Value::validated_to_object(m_context, Object::get_global(m_context, object_string));
+        Object::call_method(m_context, object_constructor, "freeze", 1, &argument);
+    }
+
+    // The delegates of the Realms on this thread. Realms are confined to the
+    // thread, and so the context, they were opened in.
+    static std::unordered_set<RealmDelegate*>& delegates() {
+        static thread_local std::unordered_set<RealmDelegate*> s_delegates;
+        return s_delegates;
+    }
+
+    void run_change_callbacks() {
+        auto& callbacks = m_change_callbacks;
+        callbacks.erase(std::remove_if(callbacks.begin(), callbacks.end(), [](auto& callback) {
+            return callback.expired();
+        }), callbacks.end());
+
+        // Callbacks may add or remove listeners while they run.
+        auto snapshot = callbacks;
+        for (auto& weak : snapshot) {
+            if (auto callback = weak.lock()) {
+                (*callback)();
+            }
+        }
+    }
+
+    void add(Notifications& notifications, FunctionType fn) {
+        if (notifications && std::find(notifications->begin(), notifications->end(), fn) != notifications->end()) {
             return;
         }
-        notifications.emplace_back(m_context, std::move(fn));
+        writable(notifications).emplace_back(m_context, std::move(fn));
     }
 
-    void remove(std::list<Protected<FunctionType>>& notifications, FunctionType fn) {
+    void remove(Notifications& notifications, FunctionType fn) {
+        if (!notifications || std::find(notifications->begin(), notifications->end(), fn) == notifications->end()) {
+            return;
+        }
         // This doesn't just call remove() because that would create a new Protected<FunctionType>
-        notifications.remove_if([&](auto& notification) { return notification == fn; });
+        auto& list = writable(notifications);
+        list.erase(std::remove_if(list.begin(), list.end(), [&](auto& notification) { return notification == fn; }), list.end());
+    }
+
+    // Copies the listeners if a dispatch is iterating over them, so that the
+    // listeners added or removed from inside a handler take effect from the
+    // next notification.
+    std::vector<Protected<FunctionType>>& writable(Notifications& notifications) {
+        if (!notifications) {
+            notifications = std::make_shared<std::vector<Protected<FunctionType>>>();
+        }
+        else if (notifications.use_count() > 1) {
+            notifications = std::make_shared<std::vector<Protected<FunctionType>>>(*notifications);
+        }
+        return *notifications;
+    }
+
+    ObjectType realm_object(const SharedRealm& realm) {
+        ObjectType object;
+        if (m_realm_object && m_realm_object->get(m_context, object)) {
+            return object;
+        }
+        object = create_object<T, RealmClass<T>>(m_context, new SharedRealm(realm));
+        if (Weak<ObjectType>::supported) {
+            m_realm_object = Weak<ObjectType>(m_context, object);
+        }
+        return object;
     }
 
-    // Note that this intentionally copies the `notifications` argument as we
-    // want to iterate over a copy in case the user adds/removes notifications
-    // from inside the handler
     template<typename... Args>
-    void notify(std::list<Protected<FunctionType>> notifications, const char *name, Args&&... args) {
-        if (notifications.empty()) {
+    void notify(const Notifications& notifications, const char *name, Args&&... args) {
+        if (!notifications || notifications->empty()) {
             return;
         }
 
@@ -184,12 +702,28 @@ public:
             throw std::runtime_error("Realm no longer exists");
         }
 
-        ObjectType realm_object = create_object<T, RealmClass<T>>(m_context, new SharedRealm(realm));
-        ValueType arguments[] = {realm_object, Value::from_string(m_context, name), args...};
+        // Hold on to the listeners as they were when the notification started.
+        Notifications snapshot = notifications;
+
+        ObjectType object = realm_object(realm);
+        ValueType arguments[] = {object, Value::from_string(m_context, name), args...};
         auto argc = std::distance(std::begin(arguments), std::end(arguments));
 
-        for (auto &callback : notifications) {
-            Function<T>::callback(m_context, callback, realm_object, argc, arguments);
+        for (auto &callback : *snapshot) {
+            if (!m_dispatch_hook) {
+                Function<T>::callback(m_context, callback, object, argc, arguments);
+                continue;
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            Function<T>::callback(m_context, callback, object, argc, arguments);
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+            if (m_dispatch_hook) {
+                Protected<FunctionType> hook = *m_dispatch_hook;
+                ValueType hook_arguments[] = {arguments[1], FunctionType(callback), Value::from_number(m_context, elapsed.count())};
+                Function<T>::callback(m_context, hook, object, 3, hook_arguments);
+            }
         }
     }
 
@@ -229,8 +763,13 @@ public:
     // methods
     static void objects(ContextType, ObjectType, Arguments &, ReturnValue &);
     static void object_for_primary_key(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void objects_for_primary_keys(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void set_links(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void prepare_query(ContextType, ObjectType, Arguments &, ReturnValue &);
     static void create(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void create_many(ContextType, ObjectType, Arguments &, ReturnValue &);
     static void delete_one(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void delete_by_primary_keys(ContextType, ObjectType, Arguments &, ReturnValue &);
     static void delete_all(ContextType, ObjectType, Arguments &, ReturnValue &);
     static void write(ContextType, ObjectType, Arguments &, ReturnValue &);
     static void begin_transaction(ContextType, ObjectType, Arguments &, ReturnValue&);
@@ -240,11 +779,21 @@ public:
     static void wait_for_download_completion(ContextType, ObjectType, Arguments &, ReturnValue &);
     static void remove_listener(ContextType, ObjectType, Arguments &, ReturnValue &);
     static void remove_all_listeners(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void set_listener_dispatch_hook(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void create_thread_safe_reference(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void freeze(ContextType, ObjectType, Arguments &, ReturnValue &);
     static void close(ContextType, ObjectType, Arguments &, ReturnValue &);
     static void compact(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void compact_async(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void file_stats(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void memory_stats(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void set_pinned_versions_warning(ContextType, ObjectType, Arguments &, ReturnValue &);
     static void writeCopyTo(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void write_copy_to_async(ContextType, ObjectType, Arguments &, ReturnValue &);
     static void delete_model(ContextType, ObjectType, Arguments &, ReturnValue &);
     static void object_for_object_id(ContextType, ObjectType, Arguments &, ReturnValue&);
+    static void objects_for_object_ids(ContextType, ObjectType, Arguments &, ReturnValue&);
+    static void subscribe_all(ContextType, ObjectType, Arguments &, ReturnValue&);
     static void privileges(ContextType, ObjectType, Arguments &, ReturnValue&);
     static void get_schema_name_from_object(ContextType, ObjectType, Arguments &, ReturnValue&);
     static void update_schema(ContextType, ObjectType, Arguments &, ReturnValue&);
@@ -270,21 +819,35 @@ public:
     // static methods
     static void constructor(ContextType, ObjectType, Arguments &);
     static SharedRealm create_shared_realm(ContextType, realm::Realm::Config, bool, ObjectDefaultsMap &&, ConstructorMap &&);
+    static SharedRealm open_reused_realm(ContextType, realm::Realm::Config, bool, ObjectDefaultsMap &&, ConstructorMap &&);
     static bool get_realm_config(ContextType ctx, size_t argc, const ValueType arguments[], realm::Realm::Config &, ObjectDefaultsMap &, ConstructorMap &);
+    static bool validated_in_memory(ContextType, ValueType, std::string &persist_path, std::chrono::milliseconds &interval);
     static void set_binding_context(ContextType ctx, std::shared_ptr<Realm> const& realm, bool schema_updated, ObjectDefaultsMap&& defaults, ConstructorMap&& constructors);
 
     static void schema_version(ContextType, ObjectType, Arguments &, ReturnValue &);
     static void clear_test_state(ContextType, ObjectType, Arguments &, ReturnValue &);
     static void copy_bundled_realm_files(ContextType, ObjectType, Arguments &, ReturnValue &);
     static void delete_file(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void delete_files_async(ContextType, ObjectType, Arguments &, ReturnValue &);
     static void realm_file_exists(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void start_tracing(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void stop_tracing(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void resolve_thread_safe_reference(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void resolve_frozen(ContextType, ObjectType, Arguments &, ReturnValue &);
 
     static void create_user_agent_description(ContextType, ObjectType, Arguments &, ReturnValue &);
     static void extend_query_based_schema(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void reuse_open_stats(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void boundary_stats(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void enable_boundary_stats(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void startup_stats(ContextType, ObjectType, Arguments &, ReturnValue &);
 
     // static properties
     static void get_default_path(ContextType, ObjectType, ReturnValue &);
     static void set_default_path(ContextType, ObjectType, ValueType value);
+#if REALM_ENABLE_SYNC
+    static void get_sync(ContextType, ObjectType, ReturnValue &);
+#endif
 
     std::string const name = "Realm";
 
@@ -294,8 +857,17 @@ public:
         {"copyBundledRealmFiles", wrap<copy_bundled_realm_files>},
         {"deleteFile", wrap<delete_file>},
         {"exists", wrap<realm_file_exists>},
+        {"startTracing", wrap<start_tracing>},
+        {"stopTracing", wrap<stop_tracing>},
+        {"resolveThreadSafeReference", wrap<resolve_thread_safe_reference>},
+        {"resolveFrozen", wrap<resolve_frozen>},
         {"_createUserAgentDescription", wrap<create_user_agent_description>},
         {"_extendQueryBasedSchema", wrap<extend_query_based_schema>},
+        {"_reuseOpenStats", wrap<reuse_open_stats>},
+        {"_boundaryStats", wrap<boundary_stats>},
+        {"_deleteFilesAsync", wrap<delete_files_async>},
+        {"_enableBoundaryStats", wrap<enable_boundary_stats>},
+        {"_startupStats", wrap<startup_stats>},
 #if REALM_ENABLE_SYNC
         {"_asyncOpen", wrap<async_open_realm>},
 #endif
@@ -303,13 +875,20 @@ public:
 
     PropertyMap<T> const static_properties = {
         {"defaultPath", {wrap<get_default_path>, wrap<set_default_path>}},
+#if REALM_ENABLE_SYNC
+        {"Sync", {wrap<get_sync>, nullptr}},
+#endif
     };
 
     MethodMap<T> const methods = {
         {"objects", wrap<objects>},
         {"objectForPrimaryKey", wrap<object_for_primary_key>},
+        {"objectsForPrimaryKeys", wrap<objects_for_primary_keys>},
+        {"prepareQuery", wrap<prepare_query>},
         {"create", wrap<create>},
+        {"createMany", wrap<create_many>},
         {"delete", wrap<delete_one>},
+        {"deleteByPrimaryKeys", wrap<delete_by_primary_keys>},
         {"deleteAll", wrap<delete_all>},
         {"write", wrap<write>},
         {"beginTransaction", wrap<begin_transaction>},
@@ -318,13 +897,24 @@ public:
         {"addListener", wrap<add_listener>},
         {"removeListener", wrap<remove_listener>},
         {"removeAllListeners", wrap<remove_all_listeners>},
+        {"_setListenerDispatchHook", wrap<set_listener_dispatch_hook>},
+        {"createThreadSafeReference", wrap<create_thread_safe_reference>},
+        {"freeze", wrap<freeze>},
         {"close", wrap<close>},
         {"compact", wrap<compact>},
+        {"_compactAsync", wrap<compact_async>},
+        {"fileStats", wrap<file_stats>},
+        {"memoryStats", wrap<memory_stats>},
+        {"setPinnedVersionsWarning", wrap<set_pinned_versions_warning>},
         {"writeCopyTo", wrap<writeCopyTo>},
+        {"_writeCopyToAsync", wrap<write_copy_to_async>},
         {"deleteModel", wrap<delete_model>},
         {"privileges", wrap<privileges>},
         {"_updateSchema", wrap<update_schema>},
         {"_objectForObjectId", wrap<object_for_object_id>},
+        {"_objectsForObjectIds", wrap<objects_for_object_ids>},
+        {"_subscribeAll", wrap<subscribe_all>},
+        {"_setLinks", wrap<set_links>},
         {"_schemaName", wrap<get_schema_name_from_object>},
     };
 
@@ -344,6 +934,217 @@ public:
     };
 
   private:
+    // A Realm opened with `_reuseOpen`, which later opens with a matching
+    // configuration on the same thread return instead of opening it again.
+    struct ReusedRealm {
+        std::weak_ptr<realm::Realm> realm;
+        realm::Realm::Config config;
+        ObjectDefaultsMap defaults;
+        ConstructorMap constructors;
+        // The handles which haven't been closed or collected yet.
+        size_t handles = 0;
+    };
+
+    // The deleter of each handle on a reused Realm, so that close() can find
+    // the handle's entry and the entry knows when its last handle is gone.
+    // The Realm itself is kept alive until the handle is collected, as a
+    // closed handle can still be asked whether it's closed.
+    struct ReusedRealmHandle {
+        std::shared_ptr<ReusedRealm> entry;
+        SharedRealm realm;
+
+        void operator()(realm::Realm*) {
+            release();
+            realm.reset();
+        }
+
+        // Whether this handle was closed, even if others keep the Realm open.
+        bool is_closed() const {
+            return !entry;
+        }
+
+        // Returns whether this was the last open handle on the Realm.
+        bool release() {
+            if (!entry) {
+                return false;
+            }
+            bool last = --entry->handles == 0;
+            entry.reset();
+            return last;
+        }
+    };
+
+    // Returns the Realm of a Realm object, throwing as a closed Realm would if
+    // the object is a handle which was closed while others keep it open.
+    static SharedRealm& validated_realm(ObjectType object) {
+        SharedRealm& realm = *get_internal<T, RealmClass<T>>(object);
+        auto handle = std::get_deleter<ReusedRealmHandle>(realm);
+        if (handle && handle->is_closed()) {
+            throw std::logic_error("Cannot access realm that has been closed.");
+        }
+        return realm;
+    }
+
+    struct ReuseOpenStats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+    };
+
+    // The entries hold the defaults and constructors they were opened with,
+    // which are released along with the context.
+    static std::map<std::string, std::shared_ptr<ReusedRealm>>& reused_realms() {
+        static thread_local std::map<std::string, std::shared_ptr<ReusedRealm>> s_realms;
+        static thread_local bool s_registered = false;
+        if (!s_registered) {
+            s_registered = true;
+            Context<T>::add_cleanup([] {
+                // Handles which haven't been collected yet share the entries.
+                for (auto& pair : s_realms) {
+                    pair.second->defaults.clear();
+                    pair.second->constructors.clear();
+                }
+                s_realms.clear();
+                s_registered = false;
+            });
+        }
+        return s_realms;
+    }
+
+    static ReuseOpenStats& reuse_open_stats() {
+        static thread_local ReuseOpenStats s_stats;
+        return s_stats;
+    }
+
+    // How long creating each of the constructors took, in milliseconds, in
+    // the order they were created.
+    static std::vector<std::pair<std::string, double>>& startup_timings() {
+        static thread_local std::vector<std::pair<std::string, double>> s_timings;
+        return s_timings;
+    }
+
+    template<typename Create>
+    static FunctionType timed_constructor(const char* name, Create create) {
+        auto start = std::chrono::steady_clock::now();
+        FunctionType constructor = create();
+        startup_timings().emplace_back(name, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        return constructor;
+    }
+
+    // The configuration a worker thread opens its own instance of a Realm
+    // with. It isn't bound to this thread's event loop, and leaves out every
+    // callback, as they belong to this thread's context.
+    static realm::Realm::Config config_for_worker(realm::Realm::Config const& config) {
+        realm::Realm::Config worker_config = config;
+        worker_config.cache = false;
+        worker_config.execution_context = util::none;
+        worker_config.automatic_change_notifications = false;
+        worker_config.migration_function = nullptr;
+        worker_config.initialization_function = nullptr;
+        worker_config.should_compact_on_launch_function = nullptr;
+#if REALM_ENABLE_SYNC
+        // The session's handlers call into JavaScript, so the file is opened
+        // with its sync history but without a session.
+        if (worker_config.sync_config) {
+            worker_config.sync_config = nullptr;
+            worker_config.force_sync_history = true;
+            worker_config.schema_mode = SchemaMode::Additive;
+        }
+#endif
+        return worker_config;
+    }
+
+    // Runs `work(worker_config, used_bytes)` on a thread of its own, with the
+    // configuration from config_for_worker(). `used_bytes` is how much of the
+    // file is in use, which is the size a compacted copy is expected to have.
+    // It is read up front where the file's history allows it, and is
+    // otherwise set if the worker's instance is the first to open the file.
+    template<typename Work>
+    static void run_file_worker(realm::Realm::Config const& config, Work work) {
+        std::thread([worker_config = config_for_worker(config), work = std::move(work)]() mutable {
+            std::atomic<uint64_t> used_bytes(used_file_bytes(worker_config));
+            worker_config.should_compact_on_launch_function = [&](uint64_t, uint64_t used) {
+                used_bytes = used;
+                return false;
+            };
+            work(worker_config, used_bytes);
+        }).detach();
+    }
+
+    static uint64_t used_file_bytes(realm::Realm::Config const& config) {
+#if REALM_ENABLE_SYNC
+        if (config.force_sync_history) {
+            return 0;
+        }
+#endif
+        try {
+            auto history = realm::make_in_realm_history(config.path);
+            SharedGroupOptions options;
+            options.encryption_key = config.encryption_key.empty() ? nullptr : config.encryption_key.data();
+            SharedGroup shared_group(*history, options);
+            size_t free_bytes = 0, used_bytes = 0;
+            shared_group.get_stats(free_bytes, used_bytes);
+            return used_bytes;
+        }
+        catch (std::exception const&) {
+            return 0;
+        }
+    }
+
+    // Change notifications wouldn't reach a Realm opened off the main event
+    // loop, such as in a worker thread, which is refreshed with refresh()
+    // instead.
+    static void disable_notifications_if_undelivered(realm::Realm::Config& config) {
+        if (!Context<T>::delivers_notifications()) {
+            config.automatic_change_notifications = false;
+        }
+    }
+
+    static bool is_reusable_config(realm::Realm::Config const& config) {
+        // Callbacks can't be compared, so configurations with them are never matched.
+        return !config.migration_function && !config.should_compact_on_launch_function
+#if REALM_ENABLE_SYNC
+            && !config.sync_config
+#endif
+            ;
+    }
+
+    static bool matches_reused_config(ReusedRealm const& entry, realm::Realm::Config const& config,
+                                      ObjectDefaultsMap const& defaults, ConstructorMap const& constructors) {
+        auto const& other = entry.config;
+        if (config.encryption_key != other.encryption_key || config.in_memory != other.in_memory ||
+            config.schema_mode != other.schema_mode || config.schema_version != other.schema_version ||
+            config.disable_format_upgrade != other.disable_format_upgrade ||
+            config.fifo_files_fallback_path != other.fifo_files_fallback_path ||
+            config.automatic_change_notifications != other.automatic_change_notifications ||
+            bool(config.schema) != bool(other.schema) || (config.schema && !(*config.schema == *other.schema))) {
+            return false;
+        }
+
+        typename Protected<ValueType>::Comparator same_value;
+        if (defaults.size() != entry.defaults.size() || constructors.size() != entry.constructors.size()) {
+            return false;
+        }
+        for (auto const& pair : constructors) {
+            auto it = entry.constructors.find(pair.first);
+            if (it == entry.constructors.end() || !(FunctionType(it->second) == FunctionType(pair.second))) {
+                return false;
+            }
+        }
+        for (auto const& pair : defaults) {
+            auto it = entry.defaults.find(pair.first);
+            if (it == entry.defaults.end() || it->second.size() != pair.second.size()) {
+                return false;
+            }
+            for (auto const& value : pair.second) {
+                auto other_value = it->second.find(value.first);
+                if (other_value == it->second.end() || !same_value(other_value->second, value.second)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
     static void handleRealmFileException(ContextType ctx, realm::Realm::Config const& config, const RealmFileException& ex) {
         switch (ex.kind()) {
             case RealmFileException::Kind::IncompatibleSyncedRealm: {
@@ -364,6 +1165,13 @@ public:
         }
     }
 
+    static realm::CreatePolicy validated_update_mode(ContextType, ValueType);
+    static void validate_property_array(ContextType, const ObjectSchema &, ObjectType);
+    static size_t delete_rows(Table &, std::vector<size_t> &);
+    static size_t row_for_primary_key(NativeAccessor &, Table &, const Property &primary_key, ValueType key);
+    static std::vector<size_t> rows_for_primary_keys(ContextType, const SharedRealm &, const ObjectSchema &, ObjectType keys);
+    static ObjectType create_objects_for_rows(ContextType, const SharedRealm &, const ObjectSchema &, Table &, const std::vector<size_t> &);
+
     static const ObjectSchema& validated_object_schema_for_value(ContextType ctx, const SharedRealm &realm, const ValueType &value) {
         std::string object_type;
 
@@ -437,13 +1245,18 @@ public:
     }
 };
 
+// The classes the JS library extends as it loads are created along with the
+// Realm constructor. Realm.Sync and the classes under it are only created the
+// first time Realm.Sync is read, as are the classes of the objects which are
+// only ever returned, such as cursors, when the first one is.
 template<typename T>
 inline typename T::Function RealmClass<T>::create_constructor(ContextType ctx) {
-    FunctionType realm_constructor = ObjectWrap<T, RealmClass<T>>::create_constructor(ctx);
-    FunctionType collection_constructor = ObjectWrap<T, CollectionClass<T>>::create_constructor(ctx);
-    FunctionType list_constructor = ObjectWrap<T, ListClass<T>>::create_constructor(ctx);
-    FunctionType results_constructor = ObjectWrap<T, ResultsClass<T>>::create_constructor(ctx);
-    FunctionType realm_object_constructor = ObjectWrap<T, RealmObjectClass<T>>::create_constructor(ctx);
+    startup_timings().clear();
+    FunctionType realm_constructor = timed_constructor("Realm", [&] { return ObjectWrap<T, RealmClass<T>>::create_constructor(ctx); });
+    FunctionType collection_constructor = timed_constructor("Collection", [&] { return ObjectWrap<T, CollectionClass<T>>::create_constructor(ctx); });
+    FunctionType list_constructor = timed_constructor("List", [&] { return ObjectWrap<T, ListClass<T>>::create_constructor(ctx); });
+    FunctionType results_constructor = timed_constructor("Results", [&] { return ObjectWrap<T, ResultsClass<T>>::create_constructor(ctx); });
+    FunctionType realm_object_constructor = timed_constructor("Object", [&] { return ObjectWrap<T, RealmObjectClass<T>>::create_constructor(ctx); });
 
     PropertyAttributes attributes = ReadOnly | DontEnum | DontDelete;
     Object::set_property(ctx, realm_constructor, "Collection", collection_constructor, attributes);
@@ -451,11 +1264,6 @@ inline typename T::Function RealmClass<T>::create_constructor(ContextType ctx) {
     Object::set_property(ctx, realm_constructor, "Results", results_constructor, attributes);
     Object::set_property(ctx, realm_constructor, "Object", realm_object_constructor, attributes);
 
-#if REALM_ENABLE_SYNC
-    FunctionType sync_constructor = SyncClass<T>::create_constructor(ctx);
-    Object::set_property(ctx, realm_constructor, "Sync", sync_constructor, attributes);
-#endif
-
     if (getenv("REALM_DISABLE_SYNC_TO_DISK")) {
         realm::disable_sync_to_disk();
     }
@@ -538,8 +1346,13 @@ bool RealmClass<T>::get_realm_config(ContextType ctx, size_t argc, const ValueTy
 
             static const String in_memory_string = "inMemory";
             ValueType in_memory_value = Object::get_property(ctx, object, in_memory_string);
-            if (!Value::is_undefined(ctx, in_memory_value) && Value::validated_to_boolean(ctx, in_memory_value, "inMemory")) {
+            std::string persist_path;
+            std::chrono::milliseconds interval{0};
+            if (validated_in_memory(ctx, in_memory_value, persist_path, interval)) {
                 config.in_memory = true;
+                if (persist_path == normalize_realm_path(config.path)) {
+                    throw std::invalid_argument("'persistTo' must be a different path than the path of the Realm.");
+                }
             }
 
             static const String read_only_string = "readOnly";
@@ -570,7 +1383,7 @@ bool RealmClass<T>::get_realm_config(ContextType ctx, size_t argc, const ValueTy
                     Object::call_method(ctx, realm_constructor, "_extendQueryBasedSchema", 1, &schema_value);
                 }
 #endif
-                config.schema.emplace(Schema<T>::parse_schema(ctx, schema_object, defaults, constructors));
+                config.schema.emplace(Schema<T>::parse_schema_cached(ctx, schema_object, defaults, constructors));
                 schema_updated = true;
             }
 
@@ -611,32 +1424,39 @@ bool RealmClass<T>::get_realm_config(ContextType ctx, size_t argc, const ValueTy
                     throw std::invalid_argument("Cannot include 'migration' when 'deleteRealmIfMigrationNeeded' is set.");
                 }
 
-                config.migration_function = [=](SharedRealm old_realm, SharedRealm realm, realm::Schema&) {
+                config.migration_function = [=](SharedRealm old_realm, SharedRealm realm, realm::Schema& schema) {
                     // the migration function called early so the binding context might not be set
                     if (!realm->m_binding_context) {
                         realm->m_binding_context.reset(new RealmDelegate<T>(realm, Context<T>::get_global_context(ctx)));
                     }
+                    get_delegate<T>(realm.get())->migration_began();
 
                     auto old_realm_ptr = new SharedRealm(old_realm);
                     auto realm_ptr = new SharedRealm(realm);
-                    ValueType arguments[2] = {
+                    // The operations of the third argument work on the tables
+                    // of the Realm directly, with the defaults of the schema.
+                    auto migration = new Migration<T>(old_realm, realm, schema, defaults);
+                    ValueType arguments[3] = {
                         create_object<T, RealmClass<T>>(ctx, old_realm_ptr),
-                        create_object<T, RealmClass<T>>(ctx, realm_ptr)
+                        create_object<T, RealmClass<T>>(ctx, realm_ptr),
+                        MigrationClass<T>::create_instance(ctx, migration)
                     };
 
                     try {
-                        Function<T>::call(ctx, migration_function, 2, arguments);
+                        Function<T>::call(ctx, migration_function, 3, arguments);
                     }
                     catch (...) {
                         old_realm->close();
                         old_realm_ptr->reset();
                         realm_ptr->reset();
+                        migration->end();
                         throw;
                     }
 
                     old_realm->close();
                     old_realm_ptr->reset();
                     realm_ptr->reset();
+                    migration->end();
                 };
             }
 
@@ -672,7 +1492,59 @@ void RealmClass<T>::constructor(ContextType ctx, ObjectType this_object, Argumen
     ObjectDefaultsMap defaults;
     ConstructorMap constructors;
     bool schema_updated = get_realm_config(ctx, args.count, args.value, config, defaults, constructors);
-    auto realm = create_shared_realm(ctx, config, schema_updated, std::move(defaults), std::move(constructors));
+
+    bool reuse_open = false;
+    if (args.count == 1 && Value::is_object(ctx, args[0])) {
+        static const String reuse_open_string = "_reuseOpen";
+        ValueType reuse_open_value = Object::get_property(ctx, Value::to_object(ctx, args[0]), reuse_open_string);
+        if (!Value::is_undefined(ctx, reuse_open_value)) {
+            reuse_open = Value::validated_to_boolean(ctx, reuse_open_value, "_reuseOpen");
+        }
+    }
+
+    SharedRealm realm;
+    if (reuse_open) {
+        realm = open_reused_realm(ctx, config, schema_updated, std::move(defaults), std::move(constructors));
+    }
+    else {
+        realm = create_shared_realm(ctx, config, schema_updated, std::move(defaults), std::move(constructors));
+    }
+
+    if (args.count == 1 && Value::is_object(ctx, args[0])) {
+        static const String accessor_templates_string = "_accessorTemplates";
+        ValueType accessor_templates_value = Object::get_property(ctx, Value::to_object(ctx, args[0]), accessor_templates_string);
+        if (!Value::is_undefined(ctx, accessor_templates_value)) {
+            get_delegate<T>(realm.get())->m_accessor_templates = Value::validated_to_boolean(ctx, accessor_templates_value, "_accessorTemplates");
+        }
+
+        static const String cache_objects_string = "_cacheObjects";
+        ValueType cache_objects_value = Object::get_property(ctx, Value::to_object(ctx, args[0]), cache_objects_string);
+        if (!Value::is_undefined(ctx, cache_objects_value)) {
+            bool cache_objects = Value::validated_to_boolean(ctx, cache_objects_value, "_cacheObjects");
+            get_delegate<T>(realm.get())->m_cache_objects = cache_objects && Weak<ObjectType>::supported;
+        }
+
+        static const String dates_as_numbers_string = "_datesAsNumbers";
+        ValueType dates_as_numbers_value = Object::get_property(ctx, Value::to_object(ctx, args[0]), dates_as_numbers_string);
+        if (!Value::is_undefined(ctx, dates_as_numbers_value)) {
+            get_delegate<T>(realm.get())->m_dates_as_numbers = Value::validated_to_boolean(ctx, dates_as_numbers_value, "_datesAsNumbers");
+        }
+
+        // An in-memory Realm which is persisted starts from its last snapshot,
+        // unless it was already open.
+        static const String in_memory_string = "inMemory";
+        ValueType in_memory_value = Object::get_property(ctx, Value::to_object(ctx, args[0]), in_memory_string);
+        std::string persist_path;
+        std::chrono::milliseconds interval{0};
+        if (validated_in_memory(ctx, in_memory_value, persist_path, interval) && !persist_path.empty()) {
+            auto delegate = get_delegate<T>(realm.get());
+            if (!delegate->m_snapshot_writer || delegate->m_snapshot_writer->path() != persist_path) {
+                delegate->m_snapshot_writer.reset();
+                hydrate_from_snapshot(realm, persist_path);
+                delegate->m_snapshot_writer.reset(new InMemorySnapshotWriter(realm->config(), persist_path, interval));
+            }
+        }
+    }
 
     // Fix for datetime -> timestamp conversion
     convert_outdated_datetime_columns(realm);
@@ -680,10 +1552,44 @@ void RealmClass<T>::constructor(ContextType ctx, ObjectType this_object, Argumen
     set_internal<T, RealmClass<T>>(this_object, new SharedRealm(realm));
 }
 
+// `inMemory` is either a boolean, or an object with the path its snapshots
+// are written to and how often. Returns whether the Realm is in memory.
+template<typename T>
+bool RealmClass<T>::validated_in_memory(ContextType ctx, ValueType value, std::string &persist_path, std::chrono::milliseconds &interval) {
+    static const String persist_to_string = "persistTo";
+    static const String interval_ms_string = "intervalMs";
+    static const double default_interval_ms = 5000;
+
+    persist_path.clear();
+    if (Value::is_undefined(ctx, value)) {
+        return false;
+    }
+    if (!Value::is_object(ctx, value)) {
+        return Value::validated_to_boolean(ctx, value, "inMemory");
+    }
+
+    ObjectType options = Value::to_object(ctx, value);
+    persist_path = normalize_realm_path(Value::validated_to_string(ctx, Object::get_property(ctx, options, persist_to_string), "persistTo"));
+    if (persist_path.empty()) {
+        throw std::invalid_argument("'persistTo' must not be empty.");
+    }
+    double interval_ms = default_interval_ms;
+    ValueType interval_value = Object::get_property(ctx, options, interval_ms_string);
+    if (!Value::is_undefined(ctx, interval_value)) {
+        interval_ms = Value::validated_to_number(ctx, interval_value, "intervalMs");
+        if (!(interval_ms >= 1)) {
+            throw std::invalid_argument("'intervalMs' must be at least 1.");
+        }
+    }
+    interval = std::chrono::milliseconds(int64_t(interval_ms));
+    return true;
+}
+
 template<typename T>
 SharedRealm RealmClass<T>::create_shared_realm(ContextType ctx, realm::Realm::Config config, bool schema_updated,
                                                ObjectDefaultsMap&& defaults, ConstructorMap&& constructors) {
     config.execution_context = Context<T>::get_execution_context_id(ctx);
+    disable_notifications_if_undelivered(config);
 
     SharedRealm realm;
     try {
@@ -698,34 +1604,130 @@ SharedRealm RealmClass<T>::create_shared_realm(ContextType ctx, realm::Realm::Co
 }
 
 template<typename T>
-void RealmClass<T>::set_binding_context(ContextType ctx, std::shared_ptr<Realm> const& realm, bool schema_updated,
-                                        ObjectDefaultsMap&& defaults, ConstructorMap&& constructors) {
-    GlobalContextType global_context = Context<T>::get_global_context(ctx);
-    if (!realm->m_binding_context) {
-        realm->m_binding_context.reset(new RealmDelegate<T>(realm, global_context));
+SharedRealm RealmClass<T>::open_reused_realm(ContextType ctx, realm::Realm::Config config, bool schema_updated,
+                                             ObjectDefaultsMap&& defaults, ConstructorMap&& constructors) {
+    auto& stats = reuse_open_stats();
+    auto& realms = reused_realms();
+    bool reusable = is_reusable_config(config);
+
+    std::shared_ptr<ReusedRealm> entry;
+    SharedRealm realm;
+    auto it = realms.find(config.path);
+    if (reusable && it != realms.end()) {
+        realm = it->second->realm.lock();
+        if (realm && !realm->is_closed() && matches_reused_config(*it->second, config, defaults, constructors)) {
+            entry = it->second;
+        }
     }
 
-    RealmDelegate<T> *js_binding_context = dynamic_cast<RealmDelegate<T> *>(realm->m_binding_context.get());
-    REALM_ASSERT(js_binding_context);
-    REALM_ASSERT(js_binding_context->m_context == global_context);
+    if (entry) {
+        ++stats.hits;
+    }
+    else {
+        ++stats.misses;
+        if (!reusable) {
+            return create_shared_realm(ctx, std::move(config), schema_updated, std::move(defaults), std::move(constructors));
+        }
 
-    // If a new schema was provided, then use its defaults and constructors.
-    if (schema_updated) {
-        js_binding_context->m_defaults = std::move(defaults);
-        js_binding_context->m_constructors = std::move(constructors);
+        entry = std::make_shared<ReusedRealm>();
+        entry->config = config;
+        entry->defaults = defaults;
+        entry->constructors = constructors;
+        realm = create_shared_realm(ctx, std::move(config), schema_updated, std::move(defaults), std::move(constructors));
+        entry->realm = realm;
+        realms[entry->config.path] = entry;
     }
-#if REALM_ENABLE_SYNC
-    // For query-based Realms we need to register the constructors for the
-    // permissions types even if a schema isn't specified
-    else if (realm->is_partial() && js_binding_context->m_constructors.empty()) {
-        ValueType schema_value = Object::create_array(ctx);
-        auto realm_constructor = Value::validated_to_object(ctx, Object::get_global(ctx, "Realm"));
+
+    ++entry->handles;
+    return SharedRealm(realm.get(), ReusedRealmHandle{entry, realm});
+}
+
+template<typename T>
+void RealmClass<T>::reuse_open_stats(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    args.validate_maximum(1);
+
+    auto& stats = reuse_open_stats();
+    uint64_t total = stats.hits + stats.misses;
+
+    ObjectType object = Object::create_empty(ctx);
+    Object::set_property(ctx, object, "hits", Value::from_number(ctx, double(stats.hits)));
+    Object::set_property(ctx, object, "misses", Value::from_number(ctx, double(stats.misses)));
+    Object::set_property(ctx, object, "hitRate", Value::from_number(ctx, total ? double(stats.hits) / total : 0));
+    return_value.set(object);
+
+    if (args.count == 1 && Value::validated_to_boolean(ctx, args[0], "reset")) {
+        stats = ReuseOpenStats();
+    }
+}
+
+template<typename T>
+void RealmClass<T>::boundary_stats(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    args.validate_maximum(1);
+
+    ObjectType object = Object::create_empty(ctx);
+#if REALM_JS_BOUNDARY_STATS
+    auto& stats = BoundaryStats::shared();
+    for (auto const& entry : stats.read()) {
+        ObjectType counter = Object::create_empty(ctx);
+        Object::set_property(ctx, counter, "calls", Value::from_number(ctx, double(entry.calls)));
+        Object::set_property(ctx, counter, "totalMs", Value::from_number(ctx, entry.nanoseconds / 1e6));
+        Object::set_property(ctx, object, entry.name, counter);
+    }
+    return_value.set(object);
+
+    if (args.count == 1 && Value::validated_to_boolean(ctx, args[0], "reset")) {
+        stats.reset();
+    }
+#else
+    return_value.set(object);
+#endif
+}
+
+template<typename T>
+void RealmClass<T>::enable_boundary_stats(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    args.validate_count(1);
+
+    bool enabled = Value::validated_to_boolean(ctx, args[0], "enabled");
+#if REALM_JS_BOUNDARY_STATS
+    BoundaryStats::set_enabled(enabled);
+#else
+    if (enabled) {
+        throw std::logic_error("Boundary stats were compiled out with REALM_JS_BOUNDARY_STATS=0");
+    }
+#endif
+}
+
+template<typename T>
+void RealmClass<T>::set_binding_context(ContextType ctx, std::shared_ptr<Realm> const& realm, bool schema_updated,
+                                        ObjectDefaultsMap&& defaults, ConstructorMap&& constructors) {
+    GlobalContextType global_context = Context<T>::get_global_context(ctx);
+    if (!realm->m_binding_context) {
+        realm->m_binding_context.reset(new RealmDelegate<T>(realm, global_context));
+    }
+
+    RealmDelegate<T> *js_binding_context = dynamic_cast<RealmDelegate<T> *>(realm->m_binding_context.get());
+    REALM_ASSERT(js_binding_context);
+    REALM_ASSERT(js_binding_context->m_context == global_context);
+
+    // If a new schema was provided, then use its defaults and constructors.
+    if (schema_updated) {
+        js_binding_context->m_defaults = std::move(defaults);
+        js_binding_context->m_constructors = std::move(constructors);
+    }
+#if REALM_ENABLE_SYNC
+    // For query-based Realms we need to register the constructors for the
+    // permissions types even if a schema isn't specified
+    else if (realm->is_partial() && js_binding_context->m_constructors.empty()) {
+        ValueType schema_value = Object::create_array(ctx);
+        auto realm_constructor = Value::validated_to_object(ctx, Object::get_global(ctx, "Realm"));
         Object::call_method(ctx, realm_constructor, "_extendQueryBasedSchema", 1, &schema_value);
         Schema<T>::parse_schema(ctx, Value::to_object(ctx, schema_value), defaults, constructors);
         js_binding_context->m_defaults = std::move(defaults);
         js_binding_context->m_constructors = std::move(constructors);
     }
 #endif
+
+    js_binding_context->build_property_slots(realm->schema());
 }
 
 template<typename T>
@@ -772,6 +1774,70 @@ void RealmClass<T>::delete_file(ContextType ctx, ObjectType this_object, Argumen
     realm::remove_directory(realm_file_path + ".management");
 }
 
+template<typename T>
+void RealmClass<T>::delete_files_async(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    args.validate_count(3);
+
+    std::vector<std::string> realm_paths;
+    ObjectType configs = Value::validated_to_array(ctx, args[0], "configs");
+    uint32_t length = Object::validated_get_length(ctx, configs);
+    for (uint32_t i = 0; i < length; i++) {
+        realm_paths.push_back(validate_and_normalize_config(ctx, Object::get_property(ctx, configs, i)).path);
+    }
+
+    std::vector<std::string> directories;
+    ObjectType directory_values = Value::validated_to_array(ctx, args[1], "directories");
+    length = Object::validated_get_length(ctx, directory_values);
+    for (uint32_t i = 0; i < length; i++) {
+        std::string directory = Value::validated_to_string(ctx, Object::get_property(ctx, directory_values, i), "directory");
+        if (directory.empty()) {
+            throw std::invalid_argument("A directory must not be empty.");
+        }
+        directories.push_back(normalize_realm_path(directory));
+    }
+
+    Protected<FunctionType> protected_done(ctx, Value::validated_to_function(ctx, args[2]));
+    Protected<typename T::GlobalContext> protected_ctx(Context<T>::get_global_context(ctx));
+
+    EventLoopDispatcher<void(FileRemovalReport)> done_handler([=](FileRemovalReport report) mutable {
+        HANDLESCOPE
+        auto to_array = [&](std::vector<std::string> const& paths) {
+            std::vector<ValueType> values;
+            for (auto const& path : paths) {
+                values.push_back(Value::from_string(protected_ctx, path));
+            }
+            return Object::create_array(protected_ctx, values);
+        };
+        std::vector<ValueType> failed;
+        for (auto const& failure : report.failed) {
+            ObjectType object = Object::create_empty(protected_ctx);
+            Object::set_property(protected_ctx, object, "path", Value::from_string(protected_ctx, failure.first));
+            Object::set_property(protected_ctx, object, "message", Value::from_string(protected_ctx, failure.second));
+            failed.push_back(object);
+        }
+
+        ObjectType result = Object::create_empty(protected_ctx);
+        Object::set_property(protected_ctx, result, "removed", to_array(report.removed));
+        Object::set_property(protected_ctx, result, "skipped", to_array(report.skipped));
+        Object::set_property(protected_ctx, result, "failed", Object::create_array(protected_ctx, failed));
+        ValueType callback_arguments[1] = {result};
+        Function<T>::callback(protected_ctx, protected_done, typename T::Object(), 1, callback_arguments);
+    });
+
+    // All of the paths are removed by a single piece of work, so that purging
+    // many Realms takes one thread rather than one per Realm.
+    realm::run_file_work([=]() mutable {
+        FileRemovalReport report;
+        for (auto const& path : realm_paths) {
+            FileRemover::remove_realm(path, report);
+        }
+        for (auto const& directory : directories) {
+            FileRemover::remove_directory(directory, report);
+        }
+        done_handler(std::move(report));
+    });
+}
+
 template<typename T>
 void RealmClass<T>::realm_file_exists(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
     args.validate_maximum(1);
@@ -780,12 +1846,43 @@ void RealmClass<T>::realm_file_exists(ContextType ctx, ObjectType this_object, A
     return_value.set(File::exists(realm_file_path));
 }
 
+template<typename T>
+void RealmClass<T>::start_tracing(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    args.validate_maximum(1);
+
+    size_t buffer_size = TraceEvents::default_buffer_size;
+    if (args.count == 1 && !Value::is_undefined(ctx, args[0])) {
+        ObjectType options = Value::validated_to_object(ctx, args[0], "options");
+        ValueType value = Object::get_property(ctx, options, "bufferSize");
+        if (!Value::is_undefined(ctx, value)) {
+            double size = Value::validated_to_number(ctx, value, "bufferSize");
+            if (!(size >= 1)) {
+                throw std::invalid_argument("'bufferSize' must be a positive number.");
+            }
+            buffer_size = size_t(size);
+        }
+    }
+
+    auto& trace = TraceEvents::shared();
+    trace.start(buffer_size);
+    trace.name_current_thread("JavaScript");
+#if REALM_ENABLE_SYNC
+    SyncClass<T>::trace_sessions(ctx);
+#endif
+}
+
+template<typename T>
+void RealmClass<T>::stop_tracing(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    args.validate_maximum(0);
+    return_value.set(TraceEvents::shared().stop());
+}
+
 template<typename T>
 void RealmClass<T>::delete_model(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
     args.validate_maximum(1);
     ValueType value = args[0];
 
-    SharedRealm& realm = *get_internal<T, RealmClass<T>>(this_object);
+    SharedRealm& realm = validated_realm(this_object);
 
     auto& config = realm->config();
     if (config.schema_mode == SchemaMode::Immutable || config.schema_mode == SchemaMode::Additive || config.schema_mode == SchemaMode::ReadOnlyAlternative) {
@@ -821,9 +1918,49 @@ void RealmClass<T>::set_default_path(ContextType ctx, ObjectType object, ValueTy
     js::set_default_path(Value::validated_to_string(ctx, value, "defaultPath"));
 }
 
+#if REALM_ENABLE_SYNC
+template<typename T>
+void RealmClass<T>::get_sync(ContextType ctx, ObjectType object, ReturnValue &return_value) {
+    static const String sync_string = "_Sync";
+    static const String setup_sync_string = "_setupSync";
+
+    // The classes are kept on the Realm constructor of the context, whichever
+    // class the property is read through.
+    ObjectType realm_constructor = Value::validated_to_object(ctx, Object::get_global(ctx, "Realm"));
+    ValueType cached = Object::get_property(ctx, realm_constructor, sync_string);
+    if (!Value::is_undefined(ctx, cached)) {
+        return_value.set(cached);
+        return;
+    }
+
+    FunctionType sync_constructor = timed_constructor("Sync", [&] { return SyncClass<T>::create_constructor(ctx); });
+    Object::set_property(ctx, realm_constructor, sync_string, sync_constructor, ReadOnly | DontEnum | DontDelete);
+
+    // The library sets up the classes once they are cached, so that it can
+    // read Realm.Sync as it does.
+    ValueType setup = Object::get_property(ctx, realm_constructor, setup_sync_string);
+    if (Value::is_function(ctx, setup)) {
+        ValueType arguments[] = {sync_constructor};
+        Function<T>::call(ctx, Value::to_function(ctx, setup), realm_constructor, 1, arguments);
+    }
+    return_value.set(sync_constructor);
+}
+#endif
+
+template<typename T>
+void RealmClass<T>::startup_stats(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    args.validate_maximum(0);
+
+    ObjectType object = Object::create_empty(ctx);
+    for (auto const& entry : startup_timings()) {
+        Object::set_property(ctx, object, entry.first, Value::from_number(ctx, entry.second));
+    }
+    return_value.set(object);
+}
+
 template<typename T>
 void RealmClass<T>::get_empty(ContextType ctx, ObjectType object, ReturnValue &return_value) {
-    SharedRealm& realm = *get_internal<T, RealmClass<T>>(object);
+    SharedRealm& realm = validated_realm(object);
     bool is_empty = ObjectStore::is_empty(realm->read_group());
     return_value.set(is_empty);
 }
@@ -842,9 +1979,12 @@ void RealmClass<T>::get_schema_version(ContextType ctx, ObjectType object, Retur
 
 template<typename T>
 void RealmClass<T>::get_schema(ContextType ctx, ObjectType object, ReturnValue &return_value) {
-    auto& schema = get_internal<T, RealmClass<T>>(object)->get()->schema();
-    ObjectType schema_object = Schema<T>::object_for_schema(ctx, schema);
-    return_value.set(schema_object);
+    SharedRealm realm = validated_realm(object);
+    if (auto delegate = get_delegate<T>(realm.get())) {
+        return_value.set(delegate->schema_object(realm->schema()));
+        return;
+    }
+    return_value.set(Schema<T>::object_for_schema(ctx, realm->schema()));
 }
 
 template<typename T>
@@ -859,18 +1999,22 @@ void RealmClass<T>::get_read_only(ContextType ctx, ObjectType object, ReturnValu
 
 template<typename T>
 void RealmClass<T>::get_is_in_transaction(ContextType ctx, ObjectType object, ReturnValue &return_value) {
-    return_value.set(get_internal<T, RealmClass<T>>(object)->get()->is_in_transaction());
+    SharedRealm realm = *get_internal<T, RealmClass<T>>(object);
+    auto handle = std::get_deleter<ReusedRealmHandle>(realm);
+    return_value.set(!(handle && handle->is_closed()) && realm->is_in_transaction());
 }
 
 template<typename T>
 void RealmClass<T>::get_is_closed(ContextType ctx, ObjectType object, ReturnValue &return_value) {
-    return_value.set(get_internal<T, RealmClass<T>>(object)->get()->is_closed());
+    SharedRealm realm = *get_internal<T, RealmClass<T>>(object);
+    auto handle = std::get_deleter<ReusedRealmHandle>(realm);
+    return_value.set(realm->is_closed() || (handle && handle->is_closed()));
 }
 
 #if REALM_ENABLE_SYNC
 template<typename T>
 void RealmClass<T>::get_sync_session(ContextType ctx, ObjectType object, ReturnValue &return_value) {
-    auto realm = *get_internal<T, RealmClass<T>>(object);
+    auto realm = validated_realm(object);
     if (std::shared_ptr<SyncSession> session = SyncManager::shared().get_existing_active_session(realm->config().path)) {
         return_value.set(create_object<T, SessionClass<T>>(ctx, new WeakSession(session)));
     } else {
@@ -881,7 +2025,7 @@ void RealmClass<T>::get_sync_session(ContextType ctx, ObjectType object, ReturnV
 
 template<typename T>
 void RealmClass<T>::get_is_partial_realm(ContextType ctx, ObjectType object, ReturnValue &return_value) {
-    auto realm = *get_internal<T, RealmClass<T>>(object);
+    auto realm = validated_realm(object);
     auto config = realm->config();
     return_value.set(config.sync_config && config.sync_config->is_partial);
 }
@@ -897,6 +2041,7 @@ void RealmClass<T>::async_open_realm(ContextType ctx, ObjectType this_object, Ar
     ObjectDefaultsMap defaults;
     ConstructorMap constructors;
     bool schema_updated = get_realm_config(ctx, args.count - 1, args.value, config, defaults, constructors);
+    disable_notifications_if_undelivered(config);
 
     if (!config.sync_config) {
         throw std::logic_error("_asyncOpen can only be used on a synchronized Realm.");
@@ -964,16 +2109,26 @@ template<typename T>
 void RealmClass<T>::objects(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
     args.validate_maximum(1);
 
-    SharedRealm realm = *get_internal<T, RealmClass<T>>(this_object);
+    SharedRealm realm = validated_realm(this_object);
     auto& object_schema = validated_object_schema_for_value(ctx, realm, args[0]);
     return_value.set(ResultsClass<T>::create_instance(ctx, realm, object_schema.name));
 }
 
+template<typename T>
+void RealmClass<T>::prepare_query(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    args.validate_count(2);
+
+    SharedRealm realm = validated_realm(this_object);
+    auto& object_schema = validated_object_schema_for_value(ctx, realm, args[0]);
+    auto query_string = Value::validated_to_string(ctx, args[1], "predicate");
+    return_value.set(PreparedQueryClass<T>::create_instance(ctx, realm, object_schema.name, query_string));
+}
+
 template<typename T>
 void RealmClass<T>::object_for_primary_key(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
     args.validate_maximum(2);
 
-    SharedRealm realm = *get_internal<T, RealmClass<T>>(this_object);
+    SharedRealm realm = validated_realm(this_object);
     std::string object_type;
     auto &object_schema = validated_object_schema_for_value(ctx, realm, args[0]);
     NativeAccessor accessor(ctx, realm, object_schema);
@@ -988,58 +2143,232 @@ void RealmClass<T>::object_for_primary_key(ContextType ctx, ObjectType this_obje
 }
 
 template<typename T>
-void RealmClass<T>::create(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
-    args.validate_maximum(3);
-    realm::CreatePolicy policy = realm::CreatePolicy::ForceCreate;
-    if (args.count == 3) {
-        if (Value::is_boolean(ctx, args[2])) {
-            // Deprecated API
-            if (Value::validated_to_boolean(ctx, args[2])) {
-                policy = realm::CreatePolicy::UpdateAll;
-            }
-            else {
-                policy = realm::CreatePolicy::ForceCreate;
-            }
+void RealmClass<T>::objects_for_primary_keys(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    args.validate_count(2);
+
+    SharedRealm realm = validated_realm(this_object);
+    realm->verify_open();
+    auto &object_schema = validated_object_schema_for_value(ctx, realm, args[0]);
+    if (!object_schema.primary_key_property()) {
+        throw std::invalid_argument(util::format("'%1' does not have a primary key defined", object_schema.name));
+    }
+
+    ObjectType keys = Value::validated_to_array(ctx, args[1], "keys");
+    std::vector<size_t> rows = rows_for_primary_keys(ctx, realm, object_schema, keys);
+    realm::TableRef table = ObjectStore::table_for_object_type(realm->read_group(), object_schema.name);
+    return_value.set(create_objects_for_rows(ctx, realm, object_schema, *table, rows));
+}
+
+template<typename T>
+std::vector<size_t> RealmClass<T>::rows_for_primary_keys(ContextType ctx, const SharedRealm &realm, const ObjectSchema &object_schema,
+                                                         ObjectType keys) {
+    // The table and primary key column are looked up once for all of the
+    // keys, each of which is then found through the primary key's index.
+    auto primary_key = object_schema.primary_key_property();
+    realm::TableRef table = ObjectStore::table_for_object_type(realm->read_group(), object_schema.name);
+    size_t column = primary_key->table_column;
+
+    NativeAccessor accessor(ctx, realm, object_schema);
+    uint32_t length = Object::validated_get_length(ctx, keys);
+    std::vector<size_t> rows;
+    rows.reserve(length);
+    for (uint32_t i = 0; i < length; i++) {
+        rows.push_back(row_for_primary_key(accessor, *table, *primary_key, Object::get_property(ctx, keys, i)));
+    }
+    return rows;
+}
+
+template<typename T>
+size_t RealmClass<T>::row_for_primary_key(NativeAccessor &accessor, Table &table, const Property &primary_key, ValueType key) {
+    if ((primary_key.type & ~realm::PropertyType::Flags) == realm::PropertyType::String) {
+        return table.find_first(primary_key.table_column, accessor.template unbox<StringData>(key));
+    }
+    if (is_nullable(primary_key.type)) {
+        return table.find_first(primary_key.table_column, accessor.template unbox<util::Optional<int64_t>>(key));
+    }
+    return table.find_first(primary_key.table_column, accessor.template unbox<int64_t>(key));
+}
+
+template<typename T>
+void RealmClass<T>::set_links(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    static const String missing_sources_string = "missingSources";
+    static const String missing_targets_string = "missingTargets";
+
+    args.validate_count(3);
+
+    SharedRealm realm = validated_realm(this_object);
+    realm->verify_in_write();
+
+    auto &object_schema = validated_object_schema_for_value(ctx, realm, args[0]);
+    auto primary_key = object_schema.primary_key_property();
+    if (!primary_key) {
+        throw std::invalid_argument(util::format("'%1' does not have a primary key defined", object_schema.name));
+    }
+    std::string property_name = Value::validated_to_string(ctx, args[1], "property");
+    const Property* prop = object_schema.property_for_name(property_name);
+    if (!prop) {
+        throw std::invalid_argument(util::format("No such property: %1", property_name));
+    }
+    if (prop->type != realm::PropertyType::Object) {
+        throw std::invalid_argument(util::format("Property '%1.%2' is not a link to an object.", object_schema.name, property_name));
+    }
+    auto &linked_schema = *realm->schema().find(prop->object_type);
+    auto linked_primary_key = linked_schema.primary_key_property();
+    if (!linked_primary_key) {
+        throw std::invalid_argument("Linked object type must have a primary key.");
+    }
+
+    // Both tables and key columns are looked up once for the whole batch,
+    // and each object is then found through its primary key's index.
+    realm::TableRef table = ObjectStore::table_for_object_type(realm->read_group(), object_schema.name);
+    realm::TableRef linked_table = table->get_link_target(prop->table_column);
+    NativeAccessor accessor(ctx, realm, object_schema);
+
+    ObjectType links = Value::validated_to_array(ctx, args[2], "links");
+    uint32_t length = Object::validated_get_length(ctx, links);
+    std::vector<ValueType> missing_sources, missing_targets;
+    for (uint32_t i = 0; i < length; i++) {
+        ObjectType link = Object::validated_get_object(ctx, links, i, "links");
+        if (Object::validated_get_length(ctx, link) != 2) {
+            throw std::invalid_argument("Each link must be a [sourceKey, targetKey] pair.");
         }
-        else if (Value::is_string(ctx, args[2])) {
-            // New API accepting an updateMode parameter
-            std::string mode = Value::validated_to_string(ctx, args[2]);
-            if (mode == "never") {
-                policy = realm::CreatePolicy::ForceCreate;
-            }
-            else if (mode == "modified") {
-                policy = realm::CreatePolicy::UpdateModified;
-            }
-            else if (mode == "all") {
-                policy = realm::CreatePolicy::UpdateAll;
-            } else {
-                throw std::runtime_error("Unsupported 'updateMode'. Only 'never', 'modified' or 'all' is supported.");
-            }
+        size_t row = row_for_primary_key(accessor, *table, *primary_key, Object::get_property(ctx, link, 0));
+        if (row == realm::not_found) {
+            missing_sources.push_back(Value::from_number(ctx, i));
+            continue;
+        }
+        // As with _setLink(), a missing target clears the link.
+        size_t target = row_for_primary_key(accessor, *linked_table, *linked_primary_key, Object::get_property(ctx, link, 1));
+        if (target == realm::not_found) {
+            missing_targets.push_back(Value::from_number(ctx, i));
+        }
+        if (table->get_link(prop->table_column, row) == target) {
+            continue;
+        }
+        if (target == realm::not_found) {
+            table->nullify_link(prop->table_column, row);
         }
         else {
-            throw std::runtime_error("Unsupported 'updateMode'. Only the strings 'never', 'modified' or 'all' is supported.");
+            table->set_link(prop->table_column, row, target);
         }
     }
 
-    SharedRealm realm = *get_internal<T, RealmClass<T>>(this_object);
+    ObjectType result = Object::create_empty(ctx);
+    Object::set_property(ctx, result, missing_sources_string, Object::create_array(ctx, missing_sources));
+    Object::set_property(ctx, result, missing_targets_string, Object::create_array(ctx, missing_targets));
+    return_value.set(result);
+}
+
+template<typename T>
+typename T::Object RealmClass<T>::create_objects_for_rows(ContextType ctx, const SharedRealm &realm, const ObjectSchema &object_schema,
+                                                          Table &table, const std::vector<size_t> &rows) {
+    std::vector<ValueType> objects;
+    objects.reserve(rows.size());
+    for (size_t row : rows) {
+        if (row == realm::not_found) {
+            objects.push_back(Value::from_null(ctx));
+        }
+        else {
+            objects.push_back(RealmObjectClass<T>::create_instance(ctx, realm::Object(realm, object_schema, table.get(row))));
+        }
+    }
+    return Object::create_array(ctx, objects);
+}
+
+template<typename T>
+realm::CreatePolicy RealmClass<T>::validated_update_mode(ContextType ctx, ValueType value) {
+    if (Value::is_boolean(ctx, value)) {
+        // Deprecated API
+        if (Value::validated_to_boolean(ctx, value)) {
+            return realm::CreatePolicy::UpdateAll;
+        }
+        else {
+            return realm::CreatePolicy::ForceCreate;
+        }
+    }
+    else if (Value::is_string(ctx, value)) {
+        // New API accepting an updateMode parameter
+        std::string mode = Value::validated_to_string(ctx, value);
+        if (mode == "never") {
+            return realm::CreatePolicy::ForceCreate;
+        }
+        else if (mode == "modified") {
+            return realm::CreatePolicy::UpdateModified;
+        }
+        else if (mode == "all") {
+            return realm::CreatePolicy::UpdateAll;
+        } else {
+            throw std::runtime_error("Unsupported 'updateMode'. Only 'never', 'modified' or 'all' is supported.");
+        }
+    }
+    else {
+        throw std::runtime_error("Unsupported 'updateMode'. Only the strings 'never', 'modified' or 'all' is supported.");
+    }
+}
+
+template<typename T>
+void RealmClass<T>::validate_property_array(ContextType ctx, const ObjectSchema &object_schema, ObjectType object) {
+    if (Value::is_array(ctx, object) && Object::validated_get_length(ctx, object) != object_schema.persisted_properties.size()) {
+        throw std::runtime_error("Array must contain values for all object properties");
+    }
+}
+
+template<typename T>
+void RealmClass<T>::create(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    args.validate_maximum(3);
+    realm::CreatePolicy policy = realm::CreatePolicy::ForceCreate;
+    if (args.count == 3) {
+        policy = validated_update_mode(ctx, args[2]);
+    }
+
+    SharedRealm realm = validated_realm(this_object);
     realm->verify_open();
     auto &object_schema = validated_object_schema_for_value(ctx, realm, args[0]);
 
+    // Arrays of property values are read by the accessor in schema order.
     ObjectType object = Value::validated_to_object(ctx, args[1], "properties");
-    if (Value::is_array(ctx, args[1])) {
-        object = Schema<T>::dict_for_property_array(ctx, object_schema, object);
-    }
+    validate_property_array(ctx, object_schema, object);
 
     NativeAccessor accessor(ctx, realm, object_schema);
     auto realm_object = realm::Object::create<ValueType>(accessor, realm, object_schema, object, policy);
     return_value.set(RealmObjectClass<T>::create_instance(ctx, std::move(realm_object)));
 }
 
+template<typename T>
+void RealmClass<T>::create_many(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    args.validate_between(2, 3);
+    realm::CreatePolicy policy = realm::CreatePolicy::ForceCreate;
+    if (args.count == 3) {
+        policy = validated_update_mode(ctx, args[2]);
+    }
+
+    SharedRealm realm = validated_realm(this_object);
+    realm->verify_open();
+    realm->verify_in_write();
+    auto &object_schema = validated_object_schema_for_value(ctx, realm, args[0]);
+
+    ObjectType objects = Value::validated_to_array(ctx, args[1], "objects");
+    uint32_t length = Object::validated_get_length(ctx, objects);
+
+    // The schema, accessor and update policy are resolved once for the whole
+    // batch, and no wrapper objects are created for the new rows.
+    NativeAccessor accessor(ctx, realm, object_schema);
+    for (uint32_t i = 0; i < length; i++) {
+        ObjectType object = Object::validated_get_object(ctx, objects, i);
+        bool is_array = Value::is_array(ctx, object);
+        if (is_array && Object::validated_get_length(ctx, object) != object_schema.persisted_properties.size()) {
+            throw std::runtime_error("Array must contain values for all object properties");
+        }
+        accessor.set_property_array(object, is_array);
+        realm::Object::create<ValueType>(accessor, realm, object_schema, object, policy);
+    }
+}
+
 template<typename T>
 void RealmClass<T>::delete_one(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
     args.validate_maximum(1);
 
-    SharedRealm realm = *get_internal<T, RealmClass<T>>(this_object);
+    SharedRealm realm = validated_realm(this_object);
     realm->verify_open();
     if (!realm->is_in_transaction()) {
         throw std::runtime_error("Can only delete objects within a transaction.");
@@ -1055,10 +2384,14 @@ void RealmClass<T>::delete_one(ContextType ctx, ObjectType this_object, Argument
 
         realm::TableRef table = ObjectStore::table_for_object_type(realm->read_group(), object->get_object_schema().name);
         table->move_last_over(object->row().get_index());
+        get_delegate<T>(realm.get())->objects_deleted(table.get());
+        get_delegate<T>(realm.get())->update_object_cache(table.get());
     }
     else if (Value::is_array(ctx, arg)) {
+        // Rows are grouped by table so that each table is only visited once.
+        std::map<Table*, std::vector<size_t>> rows_by_table;
         uint32_t length = Object::validated_get_length(ctx, arg);
-        for (uint32_t i = length; i--;) {
+        for (uint32_t i = 0; i < length; i++) {
             ObjectType object = Object::validated_get_object(ctx, arg, i);
 
             if (!Object::template is_instance<RealmObjectClass<T>>(ctx, object)) {
@@ -1066,34 +2399,85 @@ void RealmClass<T>::delete_one(ContextType ctx, ObjectType this_object, Argument
             }
 
             auto realm_object = get_internal<T, RealmObjectClass<T>>(object);
-            realm::TableRef table = ObjectStore::table_for_object_type(realm->read_group(), realm_object->get_object_schema().name);
-            table->move_last_over(realm_object->row().get_index());
+            if (!realm_object->is_valid()) {
+                throw std::runtime_error("Object is invalid. Either it has been previously deleted or the Realm it belongs to has been closed.");
+            }
+            rows_by_table[realm_object->row().get_table()].push_back(realm_object->row().get_index());
+        }
+
+        for (auto& pair : rows_by_table) {
+            delete_rows(*pair.first, pair.second);
+            get_delegate<T>(realm.get())->objects_deleted(pair.first);
+            get_delegate<T>(realm.get())->update_object_cache(pair.first);
         }
     }
     else if (Object::template is_instance<ResultsClass<T>>(ctx, arg)) {
         auto results = get_internal<T, ResultsClass<T>>(arg);
         results->clear();
+        get_delegate<T>(realm.get())->objects_deleted();
+        get_delegate<T>(realm.get())->update_object_cache();
     }
     else if (Object::template is_instance<ListClass<T>>(ctx, arg)) {
         auto list = get_internal<T, ListClass<T>>(arg);
         list->delete_all();
+        get_delegate<T>(realm.get())->objects_deleted();
+        get_delegate<T>(realm.get())->update_object_cache();
     }
     else {
         throw std::runtime_error("Argument to 'delete' must be a Realm object or a collection of Realm objects.");
     }
 }
 
+template<typename T>
+void RealmClass<T>::delete_by_primary_keys(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    args.validate_count(2);
+
+    SharedRealm realm = validated_realm(this_object);
+    realm->verify_open();
+    if (!realm->is_in_transaction()) {
+        throw std::runtime_error("Can only delete objects within a transaction.");
+    }
+
+    auto &object_schema = validated_object_schema_for_value(ctx, realm, args[0]);
+    if (!object_schema.primary_key_property()) {
+        throw std::invalid_argument(util::format("'%1' does not have a primary key defined", object_schema.name));
+    }
+
+    ObjectType keys = Value::validated_to_array(ctx, args[1], "keys");
+    std::vector<size_t> rows = rows_for_primary_keys(ctx, realm, object_schema, keys);
+    rows.erase(std::remove(rows.begin(), rows.end(), realm::not_found), rows.end());
+
+    realm::TableRef table = ObjectStore::table_for_object_type(realm->read_group(), object_schema.name);
+    return_value.set((uint32_t)delete_rows(*table, rows));
+    get_delegate<T>(realm.get())->objects_deleted(table.get());
+    get_delegate<T>(realm.get())->update_object_cache(table.get());
+}
+
+template<typename T>
+size_t RealmClass<T>::delete_rows(Table& table, std::vector<size_t>& rows) {
+    // Removing the rows from the highest index down means that the row moved
+    // into each removed slot is never one that still has to be removed, so
+    // every index stays valid for the whole pass.
+    std::sort(rows.begin(), rows.end(), std::greater<size_t>());
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+    for (auto row : rows) {
+        table.move_last_over(row);
+    }
+    return rows.size();
+}
+
 template<typename T>
 void RealmClass<T>::delete_all(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
     args.validate_maximum(0);
 
-    SharedRealm realm = *get_internal<T, RealmClass<T>>(this_object);
+    SharedRealm realm = validated_realm(this_object);
     realm->verify_open();
 
     if (!realm->is_in_transaction()) {
         throw std::runtime_error("Can only delete objects within a transaction.");
     }
 
+    get_delegate<T>(realm.get())->objects_deleted();
     for (auto objectSchema : realm->schema()) {
         auto table = ObjectStore::table_for_object_type(realm->read_group(), objectSchema.name);
         if (realm->is_partial()) {
@@ -1109,10 +2493,14 @@ template<typename T>
 void RealmClass<T>::write(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
     args.validate_maximum(1);
 
-    SharedRealm realm = *get_internal<T, RealmClass<T>>(this_object);
+    SharedRealm realm = validated_realm(this_object);
     FunctionType callback = Value::validated_to_function(ctx, args[0]);
 
-    realm->begin_transaction();
+    TraceScope trace("transaction", "write");
+    {
+        TraceScope trace("transaction", "beginTransaction");
+        realm->begin_transaction();
+    }
 
     try {
         Function<T>::call(ctx, callback, this_object, 0, nullptr);
@@ -1122,14 +2510,19 @@ void RealmClass<T>::write(ContextType ctx, ObjectType this_object, Arguments &ar
         throw;
     }
 
-    realm->commit_transaction();
+    {
+        TraceScope commit_trace("transaction", "commitTransaction");
+        realm->commit_transaction();
+    }
+    get_delegate<T>(realm.get())->did_advance();
 }
 
 template<typename T>
 void RealmClass<T>::begin_transaction(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
     args.validate_maximum(0);
 
-    SharedRealm realm = *get_internal<T, RealmClass<T>>(this_object);
+    TraceScope trace("transaction", "beginTransaction");
+    SharedRealm realm = validated_realm(this_object);
     realm->begin_transaction();
 }
 
@@ -1137,27 +2530,38 @@ template<typename T>
 void RealmClass<T>::commit_transaction(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
     args.validate_maximum(0);
 
-    SharedRealm realm = *get_internal<T, RealmClass<T>>(this_object);
-    realm->commit_transaction();
+    SharedRealm realm = validated_realm(this_object);
+    {
+        TraceScope trace("transaction", "commitTransaction");
+        realm->commit_transaction();
+    }
+    get_delegate<T>(realm.get())->did_advance();
 }
 
 template<typename T>
 void RealmClass<T>::cancel_transaction(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
     args.validate_maximum(0);
 
-    SharedRealm realm = *get_internal<T, RealmClass<T>>(this_object);
+    TraceScope trace("transaction", "cancelTransaction");
+    SharedRealm realm = validated_realm(this_object);
     realm->cancel_transaction();
 }
 
 template<typename T>
 void RealmClass<T>::add_listener(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
-    args.validate_maximum(2);
+    args.validate_maximum(3);
 
     std::string name = Value::validated_to_string(ctx, args[0], "notification name");
     auto callback = Value::validated_to_function(ctx, args[1]);
+    if (args.count == 3 && !Value::is_undefined(ctx, args[2])) {
+        validate_unthrottled_listener<T>(ctx, Value::validated_to_object(ctx, args[2], "options"));
+    }
 
-    SharedRealm realm = *get_internal<T, RealmClass<T>>(this_object);
+    SharedRealm realm = validated_realm(this_object);
     realm->verify_open();
+    if (!Context<T>::delivers_notifications()) {
+        throw std::logic_error("Listeners can only be added to Realms opened on the main thread. Realms opened in a worker thread see changes made elsewhere after refresh().");
+    }
     if (name == "change") {
         get_delegate<T>(realm.get())->add_notification(callback);
     }
@@ -1179,7 +2583,7 @@ void RealmClass<T>::remove_listener(ContextType ctx, ObjectType this_object, Arg
     std::string name = Value::validated_to_string(ctx, args[0], "notification name");
     auto callback = Value::validated_to_function(ctx, args[1]);
 
-    SharedRealm realm = *get_internal<T, RealmClass<T>>(this_object);
+    SharedRealm realm = validated_realm(this_object);
     realm->verify_open();
     if (name == "change") {
         get_delegate<T>(realm.get())->remove_notification(callback);
@@ -1203,7 +2607,7 @@ void RealmClass<T>::remove_all_listeners(ContextType ctx, ObjectType this_object
         name = Value::validated_to_string(ctx, args[0], "notification name");
     }
 
-    SharedRealm realm = *get_internal<T, RealmClass<T>>(this_object);
+    SharedRealm realm = validated_realm(this_object);
     realm->verify_open();
     if (name == "change") {
         get_delegate<T>(realm.get())->remove_all_notifications();
@@ -1219,11 +2623,130 @@ void RealmClass<T>::remove_all_listeners(ContextType ctx, ObjectType this_object
     }
 }
 
+template<typename T>
+void RealmClass<T>::set_listener_dispatch_hook(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    args.validate_count(1);
+
+    util::Optional<FunctionType> hook;
+    if (!Value::is_null(ctx, args[0]) && !Value::is_undefined(ctx, args[0])) {
+        hook = Value::validated_to_function(ctx, args[0], "hook");
+    }
+
+    SharedRealm realm = validated_realm(this_object);
+    realm->verify_open();
+    get_delegate<T>(realm.get())->set_dispatch_hook(ctx, hook);
+}
+
+template<typename T>
+void RealmClass<T>::create_thread_safe_reference(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    args.validate_maximum(1);
+
+    static const String id_string = "id";
+    static const String type_string = "type";
+    static const String path_string = "path";
+
+    SharedRealm realm = validated_realm(this_object);
+    realm->verify_open();
+
+    ThreadSafeReferences::Entry entry;
+    entry.config = ThreadSafeReferences::portable_config(realm->config());
+    if (args.count == 1 && !Value::is_undefined(ctx, args[0])) {
+        ObjectType value = Value::validated_to_object(ctx, args[0], "value");
+        if (Object::template is_instance<RealmObjectClass<T>>(ctx, value)) {
+            auto object = get_internal<T, RealmObjectClass<T>>(value);
+            if (object->realm() != realm) {
+                throw std::invalid_argument("The object belongs to another Realm.");
+            }
+            entry.type = ThreadSafeReferences::Type::Object;
+            entry.object.reset(new ThreadSafeReference<realm::Object>(realm->obtain_thread_safe_reference(*object)));
+        }
+        else if (Object::template is_instance<ResultsClass<T>>(ctx, value)) {
+            auto results = get_internal<T, ResultsClass<T>>(value);
+            if (results->get_realm() != realm) {
+                throw std::invalid_argument("The results belong to another Realm.");
+            }
+            entry.type = ThreadSafeReferences::Type::Results;
+            entry.results.reset(new ThreadSafeReference<realm::Results>(realm->obtain_thread_safe_reference(*results)));
+        }
+        else if (Object::template is_instance<ListClass<T>>(ctx, value)) {
+            auto list = get_internal<T, ListClass<T>>(value);
+            if (list->get_realm() != realm) {
+                throw std::invalid_argument("The list belongs to another Realm.");
+            }
+            entry.type = ThreadSafeReferences::Type::List;
+            entry.list.reset(new ThreadSafeReference<realm::List>(realm->obtain_thread_safe_reference(*list)));
+        }
+        else {
+            throw std::invalid_argument("Only Realm objects, Results and Lists can be referenced from another thread.");
+        }
+    }
+
+    ObjectType reference = Object::create_empty(ctx);
+    Object::set_property(ctx, reference, type_string, Value::from_string(ctx, ThreadSafeReferences::type_name(entry.type)));
+    Object::set_property(ctx, reference, path_string, Value::from_string(ctx, entry.config.path));
+    Object::set_property(ctx, reference, id_string, Value::from_number(ctx, (double)ThreadSafeReferences::add(std::move(entry))));
+    return_value.set(reference);
+}
+
+template<typename T>
+void RealmClass<T>::resolve_thread_safe_reference(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    args.validate_count(1);
+
+    static const String id_string = "id";
+
+    ObjectType reference = Value::validated_to_object(ctx, args[0], "reference");
+    auto id = Value::validated_to_number(ctx, Object::get_property(ctx, reference, id_string), "id");
+    auto entry = ThreadSafeReferences::take(static_cast<uint64_t>(id));
+
+    // This opens the Realm on this thread, or finds the one already open.
+    SharedRealm realm = create_shared_realm(ctx, std::move(entry.config), false, ObjectDefaultsMap(), ConstructorMap());
+    switch (entry.type) {
+        case ThreadSafeReferences::Type::Realm:
+            return_value.set(create_object<T, RealmClass<T>>(ctx, new SharedRealm(realm)));
+            break;
+        case ThreadSafeReferences::Type::Object:
+            return_value.set(RealmObjectClass<T>::create_instance(ctx, realm->resolve_thread_safe_reference(std::move(*entry.object))));
+            break;
+        case ThreadSafeReferences::Type::Results:
+            return_value.set(ResultsClass<T>::create_instance(ctx, realm->resolve_thread_safe_reference(std::move(*entry.results))));
+            break;
+        case ThreadSafeReferences::Type::List:
+            return_value.set(ListClass<T>::create_instance(ctx, realm->resolve_thread_safe_reference(std::move(*entry.list))));
+            break;
+    }
+}
+
+template<typename T>
+void RealmClass<T>::freeze(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    args.validate_maximum(0);
+
+    SharedRealm realm = validated_realm(this_object);
+    realm->verify_open();
+    return_value.set(FrozenRealmClass<T>::create_instance(ctx, realm));
+}
+
+template<typename T>
+void RealmClass<T>::resolve_frozen(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    args.validate_count(1);
+
+    double id = Value::validated_to_number(ctx, args[0], "id");
+    return_value.set(js::resolve_frozen<T>(ctx, static_cast<uint64_t>(id)));
+}
+
 template<typename T>
 void RealmClass<T>::close(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
     args.validate_maximum(0);
 
     SharedRealm realm = *get_internal<T, RealmClass<T>>(this_object);
+    // A Realm opened with _reuseOpen stays open until its last handle is closed.
+    if (auto handle = std::get_deleter<ReusedRealmHandle>(realm)) {
+        if (!handle->release()) {
+            return;
+        }
+    }
+    if (auto delegate = get_delegate<T>(realm.get())) {
+        delegate->will_close();
+    }
     realm->close();
 }
 
@@ -1231,7 +2754,7 @@ template<typename T>
 void RealmClass<T>::compact(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
     args.validate_maximum(0);
 
-    SharedRealm realm = *get_internal<T, RealmClass<T>>(this_object);
+    SharedRealm realm = validated_realm(this_object);
     if (realm->is_in_transaction()) {
         throw std::runtime_error("Cannot compact a Realm within a transaction.");
     }
@@ -1239,6 +2762,267 @@ void RealmClass<T>::compact(ContextType ctx, ObjectType this_object, Arguments &
     return_value.set(realm->compact());
 }
 
+template<typename T>
+void RealmClass<T>::compact_async(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    args.validate_between(1, 2);
+    auto callback_function = Value::validated_to_function(ctx, args[0]);
+    util::Optional<Protected<FunctionType>> protected_progress;
+    if (!Value::is_undefined(ctx, args[1])) {
+        protected_progress = Protected<FunctionType>(ctx, Value::validated_to_function(ctx, args[1], "progress"));
+    }
+
+    SharedRealm realm = validated_realm(this_object);
+    if (realm->is_in_transaction()) {
+        throw std::runtime_error("Cannot compact a Realm within a transaction.");
+    }
+    if (realm->config().immutable()) {
+        throw std::logic_error("Cannot compact a read-only Realm.");
+    }
+    if (realm->config().in_memory) {
+        throw std::logic_error("Cannot compact an in-memory Realm.");
+    }
+
+    // The Realm is closed while it is compacted and reopened with the same
+    // schema defaults, constructors and options once the file is in place.
+    realm::Realm::Config config = realm->config();
+    ObjectDefaultsMap defaults;
+    ConstructorMap constructors;
+    bool accessor_templates = false, cache_objects = false, dates_as_numbers = false;
+    if (auto delegate = get_delegate<T>(realm.get())) {
+        defaults = delegate->m_defaults;
+        constructors = delegate->m_constructors;
+        accessor_templates = delegate->m_accessor_templates;
+        cache_objects = delegate->m_cache_objects;
+        dates_as_numbers = delegate->m_dates_as_numbers;
+    }
+    // Only this handle is closed if other handles opened with _reuseOpen
+    // share the instance, and the file is then only compacted if nothing
+    // else keeps it open by the time the worker gets to it.
+    bool last_handle = true;
+    if (auto handle = std::get_deleter<ReusedRealmHandle>(realm)) {
+        last_handle = handle->release();
+    }
+    if (last_handle) {
+        if (auto delegate = get_delegate<T>(realm.get())) {
+            delegate->will_close();
+        }
+        realm->close();
+    }
+    realm.reset();
+
+    Protected<FunctionType> protected_callback(ctx, callback_function);
+    Protected<ObjectType> protected_this(ctx, this_object);
+    Protected<typename T::GlobalContext> protected_ctx(Context<T>::get_global_context(ctx));
+
+    EventLoopDispatcher<void(uint64_t, uint64_t)> progress_handler([=](uint64_t written_bytes, uint64_t total_bytes) mutable {
+        HANDLESCOPE
+        ValueType callback_arguments[2];
+        callback_arguments[0] = Value::from_number(protected_ctx, double(written_bytes));
+        callback_arguments[1] = Value::from_number(protected_ctx, double(total_bytes));
+        Function<T>::callback(protected_ctx, *protected_progress, typename T::Object(), 2, callback_arguments);
+    });
+
+    EventLoopDispatcher<void(bool, std::string)> done_handler([=](bool compacted, std::string error) mutable {
+        HANDLESCOPE
+        ValueType callback_arguments[2];
+        try {
+            SharedRealm reopened = create_shared_realm(protected_ctx, config, true, std::move(defaults), std::move(constructors));
+            auto delegate = get_delegate<T>(reopened.get());
+            delegate->m_accessor_templates = accessor_templates;
+            delegate->m_cache_objects = cache_objects;
+            delegate->m_dates_as_numbers = dates_as_numbers;
+            set_internal<T, RealmClass<T>>(protected_this, new SharedRealm(reopened));
+        }
+        catch (std::exception const& e) {
+            if (error.empty()) {
+                error = e.what();
+            }
+        }
+
+        if (error.empty()) {
+            callback_arguments[0] = Value::from_null(protected_ctx);
+        }
+        else {
+            ObjectType object = Object::create_empty(protected_ctx);
+            Object::set_property(protected_ctx, object, "message", Value::from_string(protected_ctx, error));
+            callback_arguments[0] = object;
+        }
+        callback_arguments[1] = Value::from_boolean(protected_ctx, compacted);
+        Function<T>::callback(protected_ctx, protected_callback, protected_this, 2, callback_arguments);
+    });
+
+    // The worker mustn't run a migration or the compact-on-launch check of
+    // the original.
+    bool report_progress = bool(protected_progress);
+    run_file_worker(config, [=](realm::Realm::Config& worker_config, std::atomic<uint64_t>& used_bytes) mutable {
+        bool compacted = false;
+        std::string error;
+
+        // Core writes the compacted copy next to the Realm file before moving
+        // it into place, so its size is how far along the compaction is.
+        auto task = std::async(std::launch::async, [&] {
+            auto worker_realm = realm::Realm::get_shared_realm(worker_config);
+            return worker_realm->compact();
+        });
+
+        std::string compaction_path = worker_config.path + ".tmp_compaction_space";
+        uint64_t reported_bytes = 0;
+        while (task.wait_for(std::chrono::milliseconds(50)) != std::future_status::ready) {
+            if (!report_progress || used_bytes == 0) {
+                continue;
+            }
+            try {
+                uint64_t written_bytes = std::min<uint64_t>(util::File(compaction_path, util::File::mode_Read).get_size(), used_bytes);
+                if (written_bytes != reported_bytes) {
+                    reported_bytes = written_bytes;
+                    progress_handler(written_bytes, used_bytes);
+                }
+            }
+            catch (util::File::AccessError const&) {
+                // The copy hasn't been created yet, or has just been moved.
+            }
+        }
+
+        try {
+            compacted = task.get();
+        }
+        catch (std::exception const& e) {
+            error = e.what();
+        }
+        if (report_progress && compacted) {
+            progress_handler(used_bytes, used_bytes);
+        }
+        done_handler(compacted, std::move(error));
+    });
+}
+
+template<typename T>
+void RealmClass<T>::file_stats(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    args.validate_maximum(0);
+
+    SharedRealm realm = validated_realm(this_object);
+    auto const& config = realm->config();
+    if (config.in_memory) {
+        throw std::logic_error("Cannot read the file statistics of an in-memory Realm.");
+    }
+    if (config.immutable()) {
+        throw std::logic_error("Cannot read the file statistics of a read-only Realm.");
+    }
+#if REALM_ENABLE_SYNC
+    if (config.sync_config) {
+        throw std::logic_error("Cannot read the file statistics of a synchronized Realm.");
+    }
+#endif
+
+    // A second SharedGroup on the file sees the free list and the versions
+    // held by every reader, without advancing this Realm.
+    auto history = realm::make_in_realm_history(config.path);
+    SharedGroupOptions options;
+    options.encryption_key = config.encryption_key.empty() ? nullptr : config.encryption_key.data();
+    SharedGroup shared_group(*history, options);
+
+    size_t free_bytes = 0, used_bytes = 0;
+    shared_group.get_stats(free_bytes, used_bytes);
+    uint64_t versions = shared_group.get_number_of_versions();
+
+    ObjectType object = Object::create_empty(ctx);
+    Object::set_property(ctx, object, "fileSize", Value::from_number(ctx, double(free_bytes + used_bytes)));
+    Object::set_property(ctx, object, "usedSize", Value::from_number(ctx, double(used_bytes)));
+    Object::set_property(ctx, object, "freeSize", Value::from_number(ctx, double(free_bytes)));
+    Object::set_property(ctx, object, "activeVersions", Value::from_number(ctx, double(versions)));
+
+    // Core decrypts the file a page at a time into memory of its own, which
+    // is shared by every encrypted Realm of the process, and only counts the
+    // pages which are decrypted there.
+    if (!config.encryption_key.empty()) {
+        static const size_t encryption_page_size = 4096;
+        ObjectType encryption = Object::create_empty(ctx);
+        Object::set_property(ctx, encryption, "pageSize", Value::from_number(ctx, double(encryption_page_size)));
+        Object::set_property(ctx, encryption, "filePages",
+                             Value::from_number(ctx, double((free_bytes + used_bytes + encryption_page_size - 1) / encryption_page_size)));
+        Object::set_property(ctx, encryption, "usedPages",
+                             Value::from_number(ctx, double((used_bytes + encryption_page_size - 1) / encryption_page_size)));
+#if REALM_ENABLE_ENCRYPTION
+        Object::set_property(ctx, encryption, "decryptedPages", Value::from_number(ctx, double(util::get_num_decrypted_pages())));
+#else
+        Object::set_property(ctx, encryption, "decryptedPages", Value::from_null(ctx));
+#endif
+        Object::set_property(ctx, object, "encryption", encryption);
+    }
+    else {
+        Object::set_property(ctx, object, "encryption", Value::from_null(ctx));
+    }
+    return_value.set(object);
+}
+
+template<typename T>
+void RealmClass<T>::memory_stats(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    args.validate_maximum(0);
+
+    SharedRealm realm = validated_realm(this_object);
+    if (realm->is_closed()) {
+        throw std::logic_error("Cannot read the memory statistics of a closed Realm.");
+    }
+    auto const& config = realm->config();
+    auto delegate = get_delegate<T>(realm.get());
+    auto const& counts = *delegate->live_wrapper_counts();
+
+    ObjectType object = Object::create_empty(ctx);
+    if (!config.in_memory) {
+        double file_size = 0;
+        try {
+            file_size = double(util::File(config.path, util::File::mode_Read).get_size());
+        }
+        catch (util::File::AccessError const&) {
+        }
+        Object::set_property(ctx, object, "fileSize", Value::from_number(ctx, file_size));
+    }
+    else {
+        Object::set_property(ctx, object, "fileSize", Value::from_null(ctx));
+    }
+    if (PinnedVersionsWatcher::can_watch(config)) {
+        Object::set_property(ctx, object, "pinnedVersions", Value::from_number(ctx, double(PinnedVersionsWatcher::versions(*realm))));
+    }
+    else {
+        Object::set_property(ctx, object, "pinnedVersions", Value::from_null(ctx));
+    }
+    Object::set_property(ctx, object, "readVersionAgeMs", Value::from_number(ctx, delegate->read_version_age_ms()));
+    Object::set_property(ctx, object, "oldestReadVersionAgeMs",
+                         Value::from_number(ctx, RealmDelegate<T>::oldest_read_version_age_ms(config.path)));
+    Object::set_property(ctx, object, "liveResults", Value::from_number(ctx, double(counts.results.load())));
+    Object::set_property(ctx, object, "liveLists", Value::from_number(ctx, double(counts.lists.load())));
+    Object::set_property(ctx, object, "liveObjects", Value::from_number(ctx, double(counts.objects.load())));
+    Object::set_property(ctx, object, "listeners", Value::from_number(ctx, double(counts.listeners.load())));
+    Object::set_property(ctx, object, "frozenVersions", Value::from_number(ctx, double(FrozenVersion::count(config.path))));
+    util::Optional<std::string> snapshot_error;
+    if (delegate->m_snapshot_writer) {
+        snapshot_error = delegate->m_snapshot_writer->last_error();
+    }
+    Object::set_property(ctx, object, "snapshotError",
+                         snapshot_error ? Value::from_string(ctx, *snapshot_error) : Value::from_null(ctx));
+    return_value.set(object);
+}
+
+template<typename T>
+void RealmClass<T>::set_pinned_versions_warning(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    args.validate_count(2);
+
+    SharedRealm realm = validated_realm(this_object);
+    if (realm->is_closed()) {
+        throw std::logic_error("Cannot watch the versions of a closed Realm.");
+    }
+    double threshold = Value::validated_to_number(ctx, args[0], "threshold");
+    if (threshold < 1) {
+        throw std::invalid_argument("The threshold must be at least 1.");
+    }
+    util::Optional<FunctionType> callback;
+    if (!Value::is_null(ctx, args[1]) && !Value::is_undefined(ctx, args[1])) {
+        callback = Value::validated_to_function(ctx, args[1], "callback");
+        PinnedVersionsWatcher::validate(realm->config());
+    }
+    get_delegate<T>(realm.get())->set_pinned_versions_warning(ctx, uint64_t(threshold), callback);
+}
+
 template<typename T>
 void RealmClass<T>::writeCopyTo(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
     args.validate_maximum(2);
@@ -1247,7 +3031,7 @@ void RealmClass<T>::writeCopyTo(ContextType ctx, ObjectType this_object, Argumen
         throw std::runtime_error("At least path has to be provided for 'writeCopyTo'");
     }
 
-    SharedRealm realm = *get_internal<T, RealmClass<T>>(this_object);
+    SharedRealm realm = validated_realm(this_object);
 
     ValueType pathValue = args[0];
     if (!Value::is_string(ctx, pathValue)) {
@@ -1275,12 +3059,149 @@ void RealmClass<T>::writeCopyTo(ContextType ctx, ObjectType this_object, Argumen
     realm->write_copy(path, encryption_key.get());
 }
 
+template<typename T>
+void RealmClass<T>::write_copy_to_async(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    args.validate_between(4, 6);
+
+    SharedRealm realm = validated_realm(this_object);
+
+    bool to_sink = Value::is_null(ctx, args[0]);
+    std::string path;
+    if (!to_sink) {
+        path = Value::validated_to_string(ctx, args[0], "path");
+    }
+
+    std::string encryption_key;
+    if (!Value::is_null(ctx, args[1])) {
+        if (!Value::is_binary(ctx, args[1])) {
+            throw std::runtime_error("Encryption key for 'writeCopyToAsync' must be a Binary.");
+        }
+        auto key = Value::validated_to_binary(ctx, args[1]);
+        encryption_key.assign(key.data(), key.size());
+    }
+
+    double bytes_per_second = Value::validated_to_number(ctx, args[2], "bytesPerSecond");
+    if (bytes_per_second < 0) {
+        throw std::invalid_argument("'bytesPerSecond' must not be negative.");
+    }
+    // The core encrypts a copy as it writes it to a file, in a single call.
+    if (!encryption_key.empty() && (to_sink || bytes_per_second > 0)) {
+        throw std::invalid_argument("An encrypted copy can only be written to a path, without a 'bytesPerSecond' limit.");
+    }
+
+    auto done_function = Value::validated_to_function(ctx, args[3]);
+    util::Optional<Protected<FunctionType>> protected_progress;
+    if (!Value::is_undefined(ctx, args[4])) {
+        protected_progress = Protected<FunctionType>(ctx, Value::validated_to_function(ctx, args[4], "progress"));
+    }
+    util::Optional<Protected<FunctionType>> protected_chunk;
+    if (to_sink) {
+        protected_chunk = Protected<FunctionType>(ctx, Value::validated_to_function(ctx, args[5], "sink"));
+    }
+
+    Protected<FunctionType> protected_done(ctx, done_function);
+    Protected<ObjectType> protected_this(ctx, this_object);
+    Protected<typename T::GlobalContext> protected_ctx(Context<T>::get_global_context(ctx));
+
+    EventLoopDispatcher<void(uint64_t, uint64_t)> progress_handler([=](uint64_t written_bytes, uint64_t total_bytes) mutable {
+        HANDLESCOPE
+        ValueType callback_arguments[2];
+        callback_arguments[0] = Value::from_number(protected_ctx, double(written_bytes));
+        callback_arguments[1] = Value::from_number(protected_ctx, double(total_bytes));
+        Function<T>::callback(protected_ctx, *protected_progress, typename T::Object(), 2, callback_arguments);
+    });
+
+    // The worker waits for the sink to take each chunk before writing the next.
+    EventLoopDispatcher<void(std::string)> chunk_handler([=](std::string chunk) mutable {
+        HANDLESCOPE
+        ValueType callback_arguments[1];
+        callback_arguments[0] = Value::from_binary(protected_ctx, BinaryData(chunk.data(), chunk.size()));
+        Function<T>::callback(protected_ctx, *protected_chunk, typename T::Object(), 1, callback_arguments);
+    });
+
+    EventLoopDispatcher<void(std::string, uint64_t)> done_handler([=](std::string error, uint64_t written_bytes) mutable {
+        HANDLESCOPE
+        ValueType callback_arguments[2];
+        if (error.empty()) {
+            callback_arguments[0] = Value::from_null(protected_ctx);
+        }
+        else {
+            ObjectType object = Object::create_empty(protected_ctx);
+            Object::set_property(protected_ctx, object, "message", Value::from_string(protected_ctx, error));
+            callback_arguments[0] = object;
+        }
+        callback_arguments[1] = Value::from_number(protected_ctx, double(written_bytes));
+        Function<T>::callback(protected_ctx, protected_done, protected_this, 2, callback_arguments);
+    });
+
+    // The worker reads the latest version through its own instance, and holds
+    // on to it until the copy is written. The copy is written compacted, so
+    // the bytes in use in the file are the size it is expected to have.
+    auto task = std::make_shared<WriteCopyTask>(bytes_per_second);
+    bool report_progress = bool(protected_progress);
+    run_file_worker(realm->config(), [=](realm::Realm::Config& worker_config, std::atomic<uint64_t>& used_bytes) mutable {
+        std::string error;
+        bool created = false;
+        try {
+            auto worker_realm = realm::Realm::get_shared_realm(worker_config);
+
+            if (!encryption_key.empty()) {
+                worker_realm->write_copy(path, BinaryData(encryption_key.data(), encryption_key.size()));
+                created = true;
+                uint64_t size = util::File(path, util::File::mode_Read).get_size();
+                task->did_write(size);
+                if (report_progress) {
+                    progress_handler(size, size);
+                }
+            }
+            else {
+                util::File file;
+                if (!to_sink) {
+                    if (util::File::exists(path)) {
+                        throw std::runtime_error(util::format("The file '%1' already exists.", path));
+                    }
+                    file.open(path, util::File::mode_Write);
+                    created = true;
+                }
+
+                WriteCopyStreamBuffer buffer(*task, [&](const char* data, size_t size) {
+                    if (to_sink) {
+                        task->pause();
+                        chunk_handler(std::string(data, size));
+                        task->wait_until_resumed();
+                    }
+                    else {
+                        file.write(data, size);
+                    }
+                    if (report_progress) {
+                        uint64_t written_bytes = task->written() + size;
+                        progress_handler(written_bytes, std::max<uint64_t>(used_bytes, written_bytes));
+                    }
+                });
+                std::ostream out(&buffer);
+                out.exceptions(std::ios::badbit);
+                worker_realm->read_group().write(out);
+                out.flush();
+            }
+        }
+        catch (std::exception const& e) {
+            error = e.what();
+            if (created) {
+                util::File::try_remove(path);
+            }
+        }
+        done_handler(std::move(error), task->written());
+    });
+
+    return_value.set(create_object<T, WriteCopyTaskClass<T>>(ctx, new std::shared_ptr<WriteCopyTask>(task)));
+}
+
 template<typename T>
 void RealmClass<T>::object_for_object_id(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue& return_value) {
     args.validate_count(2);
 
 #if REALM_ENABLE_SYNC
-    SharedRealm realm = *get_internal<T, RealmClass<T>>(this_object);
+    SharedRealm realm = validated_realm(this_object);
     if (!sync::has_object_ids(realm->read_group()))
         throw std::logic_error("Realm._objectForObjectId() can only be used with synced Realms.");
 
@@ -1298,13 +3219,119 @@ void RealmClass<T>::object_for_object_id(ContextType ctx, ObjectType this_object
 #endif // REALM_ENABLE_SYNC
 }
 
+template<typename T>
+void RealmClass<T>::objects_for_object_ids(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue& return_value) {
+    args.validate_count(2);
+
+#if REALM_ENABLE_SYNC
+    SharedRealm realm = validated_realm(this_object);
+    if (!sync::has_object_ids(realm->read_group()))
+        throw std::logic_error("Realm._objectsForObjectIds() can only be used with synced Realms.");
+
+    auto& object_schema = validated_object_schema_for_value(ctx, realm, args[0]);
+    ObjectType ids = Value::validated_to_array(ctx, args[1], "ids");
+    uint32_t length = Object::validated_get_length(ctx, ids);
+
+    Group& group = realm->read_group();
+    realm::TableRef table = ObjectStore::table_for_object_type(group, object_schema.name);
+    std::vector<size_t> rows;
+    rows.reserve(length);
+    for (uint32_t i = 0; i < length; i++) {
+        auto object_id = sync::ObjectID::from_string(Object::validated_get_string(ctx, ids, i));
+        rows.push_back(sync::row_for_object_id(group, *table, object_id));
+    }
+    return_value.set(create_objects_for_rows(ctx, realm, object_schema, *table, rows));
+#else
+    throw std::logic_error("Realm._objectsForObjectIds() can only be used with synced Realms.");
+#endif // REALM_ENABLE_SYNC
+}
+
+template<typename T>
+void RealmClass<T>::subscribe_all(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue& return_value) {
+    args.validate_count(1);
+
+#if REALM_ENABLE_SYNC
+    static const String results_string = "results";
+    static const String options_string = "options";
+
+    SharedRealm realm = validated_realm(this_object);
+    realm->verify_open();
+
+    // All of the options are read before anything is written, so that an
+    // invalid one doesn't leave some of the subscriptions behind. The key
+    // path mapping for includeLinkingObjects is built at most once.
+    ObjectType entries = Value::validated_to_array(ctx, args[0], "subscriptions");
+    uint32_t length = Object::validated_get_length(ctx, entries);
+    std::vector<realm::Results> results;
+    std::vector<partial_sync::SubscriptionOptions> options;
+    util::Optional<parser::KeyPathMapping> mapping;
+    for (uint32_t i = 0; i < length; i++) {
+        ObjectType entry = Object::validated_get_object(ctx, entries, i, "subscriptions");
+        ValueType results_value = Object::get_property(ctx, entry, results_string);
+        if (!Value::is_object(ctx, results_value) ||
+            !Object::template is_instance<ResultsClass<T>>(ctx, Value::to_object(ctx, results_value))) {
+            throw std::invalid_argument("Each subscription must have 'results' which are Realm.Results.");
+        }
+        auto &entry_results = *get_internal<T, ResultsClass<T>>(Value::to_object(ctx, results_value));
+        if (entry_results.get_realm() != realm) {
+            throw std::invalid_argument("The results of each subscription must belong to this Realm.");
+        }
+        options.push_back(ResultsClass<T>::validated_subscription_options(ctx, entry_results, Object::get_property(ctx, entry, options_string), mapping));
+        results.push_back(entry_results);
+    }
+
+    // The subscriptions are written in one transaction, so that they reach
+    // the server together in a single changeset. Each is then tracked through
+    // the row which was written for it, rather than registered again.
+    std::vector<std::string> names;
+    names.reserve(results.size());
+    bool commit = !realm->is_in_transaction();
+    if (commit) {
+        realm->begin_transaction();
+    }
+    try {
+        for (size_t i = 0; i < results.size(); i++) {
+            auto subscribed = results[i];
+            if (options[i].inclusions.is_valid()) {
+                DescriptorOrdering ordering;
+                ordering.append_include(options[i].inclusions);
+                subscribed = subscribed.apply_ordering(std::move(ordering));
+            }
+            auto row = partial_sync::subscribe_blocking(subscribed, options[i].user_provided_name, options[i].time_to_live_ms, options[i].update);
+            names.push_back(std::string(row.get_string(row.get_table()->get_column_index("name"))));
+        }
+        if (commit) {
+            realm->commit_transaction();
+        }
+    }
+    catch (...) {
+        if (commit) {
+            realm->cancel_transaction();
+        }
+        throw;
+    }
+
+    realm::TableRef result_sets = ObjectStore::table_for_object_type(realm->read_group(), "__ResultSets");
+    size_t name_col = result_sets->get_column_index("name");
+    std::vector<ValueType> subscriptions;
+    subscriptions.reserve(results.size());
+    for (size_t i = 0; i < results.size(); i++) {
+        realm::Results result_set(realm, result_sets->where().equal(name_col, names[i]));
+        subscriptions.push_back(SubscriptionClass<T>::create_instance(ctx, std::move(result_set), options[i].user_provided_name));
+    }
+    return_value.set(Object::create_array(ctx, subscriptions));
+#else
+    throw std::logic_error("Realm.subscribeAll() can only be used with synced Realms.");
+#endif // REALM_ENABLE_SYNC
+}
+
 template<typename T>
 void RealmClass<T>::get_schema_name_from_object(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue& return_value) {
     args.validate_count(1);
 
     // Try to map the input to the internal schema name for the given input. This should work for managed objects and
     // schema objects. Pure strings and functions are expected to return a correct value.
-    SharedRealm realm = *get_internal<T, RealmClass<T>>(this_object);
+    SharedRealm realm = validated_realm(this_object);
     auto &object_schema = validated_object_schema_for_value(ctx, realm, args[0]);
     return_value.set(object_schema.name);
 }
@@ -1319,7 +3346,7 @@ void RealmClass<T>::privileges(ContextType ctx, ObjectType this_object, Argument
         return (static_cast<int>(actual) & static_cast<int>(expected)) == static_cast<int>(expected);
     };
 
-    SharedRealm realm = *get_internal<T, RealmClass<T>>(this_object);
+    SharedRealm realm = validated_realm(this_object);
     auto config = realm->config();
     if (!(config.sync_config && config.sync_config->is_partial)) {
         throw std::runtime_error("Wrong Realm type. 'privileges()' is only available for Query-based Realms.");
@@ -1382,7 +3409,7 @@ void RealmClass<T>::update_schema(ContextType ctx, ObjectType this_object, Argum
     realm::Schema parsed_schema = Schema<T>::parse_schema(ctx, schema, defaults, constructors);
 
     // Get a handle to the Realms group
-    SharedRealm realm = *get_internal<T, RealmClass<T>>(this_object);
+    SharedRealm realm = validated_realm(this_object);
     if (!realm->is_in_transaction()) {
         throw std::runtime_error("Can only create object schema within a transaction.");
     }
@@ -1408,6 +3435,45 @@ void RealmClass<T>::extend_query_based_schema(ContextType, ObjectType, Arguments
     // don't need to do anything
 }
 
+template<typename T>
+class WriteCopyTaskClass : public ClassDefinition<T, std::shared_ptr<WriteCopyTask>> {
+    using ContextType = typename T::Context;
+    using FunctionType = typename T::Function;
+    using ObjectType = typename T::Object;
+    using ReturnValue = js::ReturnValue<T>;
+    using Arguments = js::Arguments<T>;
+
+public:
+    std::string const name = "WriteCopyTask";
+
+    static FunctionType create_constructor(ContextType);
+
+    static void cancel(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void resume(ContextType, ObjectType, Arguments &, ReturnValue &);
+
+    MethodMap<T> const methods = {
+        {"cancel", wrap<cancel>},
+        {"_resume", wrap<resume>},
+    };
+};
+
+template<typename T>
+typename T::Function WriteCopyTaskClass<T>::create_constructor(ContextType ctx) {
+    return ObjectWrap<T, WriteCopyTaskClass<T>>::create_constructor(ctx);
+}
+
+template<typename T>
+void WriteCopyTaskClass<T>::cancel(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    args.validate_maximum(0);
+    (*get_internal<T, WriteCopyTaskClass<T>>(this_object))->cancel();
+}
+
+template<typename T>
+void WriteCopyTaskClass<T>::resume(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    args.validate_maximum(0);
+    (*get_internal<T, WriteCopyTaskClass<T>>(this_object))->resume();
+}
+
 #if REALM_ENABLE_SYNC
 template<typename T>
 class AsyncOpenTaskClass : public ClassDefinition<T, std::shared_ptr<AsyncOpenTask>> {
@@ -28,6 +28,8 @@ namespace js {
 #include "object_store.hpp"
 
 #include "js_class.hpp"
+#include "js_key_paths.hpp"
+#include "js_plain.hpp"
 #include "js_types.hpp"
 #include "js_util.hpp"
 #include "js_realm.hpp"
@@ -47,7 +49,38 @@ public:
     RealmObject& operator=(RealmObject&&) = default;
     RealmObject& operator=(RealmObject const&) = default;
 
+    // Evicts the wrapper this is the internal of from the object cache.
+    ~RealmObject() {
+        if (m_cached && realm()) {
+            if (auto delegate = get_delegate<T>(realm().get())) {
+                delegate->uncache_object(row(), this);
+            }
+        }
+    }
+
     std::vector<std::pair<Protected<typename T::Function>, NotificationToken>> m_notification_tokens;
+    LiveWrapper<&LiveWrapperCounts::objects> m_live{live_wrapper_counts<T>(realm())};
+    // Whether the wrapper is in the object cache of its Realm.
+    bool m_cached = false;
+
+    void listeners_changed() {
+        m_live.set_listeners(m_notification_tokens.size());
+    }
+
+    // The accessor the properties of this object are read and written with,
+    // which is kept rather than built for every call.
+    NativeAccessor<T>& accessor(typename T::Context ctx) {
+        if (!m_accessor) {
+            m_accessor.emplace(ctx, realm(), get_object_schema());
+        }
+        else {
+            m_accessor->set_context(ctx);
+        }
+        return *m_accessor;
+    }
+
+private:
+    util::Optional<NativeAccessor<T>> m_accessor;
 };
 
 template<typename T>
@@ -68,11 +101,22 @@ struct RealmObjectClass : ClassDefinition<T, realm::js::RealmObject<T>> {
     static void get_property(ContextType, ObjectType, const String &, ReturnValue &);
     static bool set_property(ContextType, ObjectType, const String &, ValueType);
     static std::vector<String> get_property_names(ContextType, ObjectType);
+    static const Property* property_for_public_name(realm::Object&, const String &);
+
+    // Used by engines which install an accessor per property of the object
+    // schema. The slot indexes the persisted properties followed by the
+    // computed properties of the object schema.
+    static void get_schema_property(ContextType, ObjectType, size_t, ReturnValue &);
+    static void set_schema_property(ContextType, ObjectType, size_t, ValueType);
+    static const Property& property_for_slot(realm::Object&, size_t);
+    static void get_property_value(ContextType, realm::js::RealmObject<T>&, const Property&, ReturnValue &);
+    static void set_property_value(ContextType, realm::js::RealmObject<T>&, const Property&, ValueType);
 
     static void is_valid(ContextType, ObjectType, Arguments &, ReturnValue &);
     static void get_object_schema(ContextType, ObjectType, Arguments &, ReturnValue &);
     static void linking_objects(ContextType, ObjectType, Arguments &, ReturnValue &);
     static void linking_objects_count(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void to_plain(ContextType, ObjectType, Arguments &, ReturnValue &);
     static void get_object_id(ContextType, ObjectType, Arguments &, ReturnValue &);
     static void is_same_object(ContextType, ObjectType, Arguments &, ReturnValue &);
     static void set_link(ContextType, ObjectType, Arguments &, ReturnValue &);
@@ -95,6 +139,7 @@ struct RealmObjectClass : ClassDefinition<T, realm::js::RealmObject<T>> {
         {"objectSchema", wrap<get_object_schema>},
         {"linkingObjects", wrap<linking_objects>},
         {"linkingObjectsCount", wrap<linking_objects_count>},
+        {"toPlain", wrap<to_plain>},
         {"_objectId", wrap<get_object_id>},
         {"_isSameObject", wrap<is_same_object>},
         {"_setLink", wrap<set_link>},
@@ -116,6 +161,10 @@ void RealmObjectClass<T>::is_valid(ContextType, ObjectType this_object, Argument
 template<typename T>
 void RealmObjectClass<T>::get_object_schema(ContextType ctx, ObjectType this_object, Arguments &, ReturnValue &return_value) {
     auto object = get_internal<T, RealmObjectClass<T>>(this_object);
+    if (auto delegate = get_delegate<T>(object->realm().get())) {
+        return_value.set(delegate->object_schema_object(object->get_object_schema()));
+        return;
+    }
     return_value.set(Schema<T>::object_for_object_schema(ctx, object->get_object_schema()));
 }
 
@@ -124,53 +173,107 @@ typename T::Object RealmObjectClass<T>::create_instance(ContextType ctx, realm::
     static String prototype_string = "prototype";
 
     auto delegate = get_delegate<T>(realm_object.realm().get());
-    auto name = realm_object.get_object_schema().name;
-    auto object = create_object<T, RealmObjectClass<T>>(ctx, new realm::js::RealmObject<T>(std::move(realm_object)));
-
-    if (!delegate || !delegate->m_constructors.count(name)) {
+    bool cache_object = delegate && delegate->m_cache_objects && realm_object.is_valid();
+    ObjectType object;
+    if (cache_object && delegate->get_cached_object(ctx, realm_object.row(), object)) {
         return object;
     }
 
-    FunctionType constructor = delegate->m_constructors.at(name);
-    ObjectType prototype = Object::validated_get_object(ctx, constructor, prototype_string);
-    Object::set_prototype(ctx, object, prototype);
+    auto& object_schema = realm_object.get_object_schema();
+    auto name = object_schema.name;
+    if (delegate && delegate->m_accessor_templates) {
+        object = Object::template create_instance_by_schema<RealmObjectClass<T>>(ctx, object_schema, new realm::js::RealmObject<T>(std::move(realm_object)));
+    }
+    else {
+        object = create_object<T, RealmObjectClass<T>>(ctx, new realm::js::RealmObject<T>(std::move(realm_object)));
+    }
+
+    if (delegate && delegate->m_constructors.count(name)) {
+        FunctionType constructor = delegate->m_constructors.at(name);
+        ObjectType prototype = Object::validated_get_object(ctx, constructor, prototype_string);
+        Object::set_prototype(ctx, object, prototype);
 
-    ValueType result = Function::call(ctx, constructor, object, 0, NULL);
-    if (result != object && !Value::is_null(ctx, result) && !Value::is_undefined(ctx, result)) {
-        throw std::runtime_error("Realm object constructor must not return another value");
+        ValueType result = Function::call(ctx, constructor, object, 0, NULL);
+        if (result != object && !Value::is_null(ctx, result) && !Value::is_undefined(ctx, result)) {
+            throw std::runtime_error("Realm object constructor must not return another value");
+        }
+    }
+
+    if (cache_object) {
+        auto internal = get_internal<T, RealmObjectClass<T>>(object);
+        internal->m_cached = true;
+        delegate->cache_object(ctx, internal->row(), object, internal);
     }
 
     return object;
 }
 
+template<typename T>
+const Property* RealmObjectClass<T>::property_for_public_name(realm::Object& realm_object, const String &property_name) {
+    if (auto delegate = get_delegate<T>(realm_object.realm().get())) {
+        return delegate->property_for_public_name(realm_object.get_object_schema(), property_name.data());
+    }
+    return realm_object.get_object_schema().property_for_public_name(property_name.data());
+}
+
 template<typename T>
 void RealmObjectClass<T>::get_property(ContextType ctx, ObjectType object, const String &property_name, ReturnValue &return_value) {
     auto realm_object = get_internal<T, RealmObjectClass<T>>(object);
-    std::string prop_name = property_name;
-    const Property* prop = realm_object->get_object_schema().property_for_public_name(prop_name);
+    const Property* prop = property_for_public_name(*realm_object, property_name);
     if (prop) {
-        NativeAccessor<T> accessor(ctx, realm_object->realm(), realm_object->get_object_schema());
-        auto result = realm_object->template get_property_value<ValueType>(accessor, *prop);
-        return_value.set(result);
+        get_property_value(ctx, *realm_object, *prop, return_value);
     }
 }
 
 template<typename T>
 bool RealmObjectClass<T>::set_property(ContextType ctx, ObjectType object, const String &property_name, ValueType value) {
     auto realm_object = get_internal<T, RealmObjectClass<T>>(object);
-    std::string prop_name = property_name;
-    const Property* prop = realm_object->get_object_schema().property_for_public_name(prop_name);
+    const Property* prop = property_for_public_name(*realm_object, property_name);
     if (!prop) {
         return false;
     }
 
-    NativeAccessor<T> accessor(ctx, realm_object->realm(), realm_object->get_object_schema());
-    if (!Value::is_valid_for_property(ctx, value, *prop)) {
-        throw TypeErrorException(accessor, realm_object->get_object_schema().name, *prop, value);
+    set_property_value(ctx, *realm_object, *prop, value);
+    return true;
+}
+
+template<typename T>
+const Property& RealmObjectClass<T>::property_for_slot(realm::Object& realm_object, size_t slot) {
+    auto& object_schema = realm_object.get_object_schema();
+    auto& persisted_properties = object_schema.persisted_properties;
+    if (slot < persisted_properties.size()) {
+        return persisted_properties[slot];
     }
+    return object_schema.computed_properties.at(slot - persisted_properties.size());
+}
 
-    realm_object->set_property_value(accessor, prop->name, value, realm::CreatePolicy::UpdateAll);
-    return true;
+template<typename T>
+void RealmObjectClass<T>::get_schema_property(ContextType ctx, ObjectType object, size_t slot, ReturnValue &return_value) {
+    auto realm_object = get_internal<T, RealmObjectClass<T>>(object);
+    get_property_value(ctx, *realm_object, property_for_slot(*realm_object, slot), return_value);
+}
+
+template<typename T>
+void RealmObjectClass<T>::set_schema_property(ContextType ctx, ObjectType object, size_t slot, ValueType value) {
+    auto realm_object = get_internal<T, RealmObjectClass<T>>(object);
+    set_property_value(ctx, *realm_object, property_for_slot(*realm_object, slot), value);
+}
+
+template<typename T>
+void RealmObjectClass<T>::get_property_value(ContextType ctx, realm::js::RealmObject<T>& realm_object, const Property& prop, ReturnValue &return_value) {
+    auto& accessor = realm_object.accessor(ctx);
+    auto result = realm_object.template get_property_value<ValueType>(accessor, prop);
+    return_value.set(result);
+}
+
+template<typename T>
+void RealmObjectClass<T>::set_property_value(ContextType ctx, realm::js::RealmObject<T>& realm_object, const Property& prop, ValueType value) {
+    auto& accessor = realm_object.accessor(ctx);
+    if (!Value::is_valid_for_property(ctx, value, prop, accessor.dates_as_numbers())) {
+        throw TypeErrorException(accessor, realm_object.get_object_schema().name, prop, value);
+    }
+
+    realm_object.set_property_value(accessor, prop.name, value, realm::CreatePolicy::UpdateAll);
 }
 
 template<typename T>
@@ -239,10 +342,10 @@ std::vector<String<T>> RealmObjectClass<T>::get_property_names(ContextType ctx,
     names.reserve(object_schema.persisted_properties.size() + object_schema.computed_properties.size());
 
     for (auto &prop : object_schema.persisted_properties) {
-        names.push_back(!prop.public_name.empty() ? prop.public_name : prop.name);
+        names.push_back(String::intern(!prop.public_name.empty() ? prop.public_name : prop.name));
     }
     for (auto &prop : object_schema.computed_properties) {
-        names.push_back(!prop.public_name.empty() ? prop.public_name : prop.name);
+        names.push_back(String::intern(!prop.public_name.empty() ? prop.public_name : prop.name));
     }
 
     return names;
@@ -301,48 +404,108 @@ void RealmObjectClass<T>::linking_objects_count(ContextType, ObjectType object,
     return_value.set((uint32_t)row.get_backlink_count());
 }
 
+template<typename T>
+void RealmObjectClass<T>::to_plain(ContextType ctx, ObjectType object, Arguments &args, ReturnValue &return_value) {
+    auto realm_object = get_internal<T, RealmObjectClass<T>>(object);
+    auto options = PlainObjectBuilder<T>::validated_options(ctx, args);
+    realm_object->realm()->verify_thread();
+    if (!realm_object->is_valid()) {
+        throw std::logic_error(util::format("Accessing object of type %1 which has been invalidated or deleted",
+                                            realm_object->get_object_schema().name));
+    }
+
+    PlainObjectBuilder<T> builder(ctx, realm_object->realm(), std::move(options));
+    return_value.set(builder.object(*realm_object));
+}
+
 
 template<typename T>
 void RealmObjectClass<T>::add_listener(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue& return_value) {
-    args.validate_maximum(1);
+    args.validate_maximum(2);
 
     auto realm_object = get_internal<T, RealmObjectClass<T>>(this_object);
 
     auto callback = Value::validated_to_function(ctx, args[0]);
+    std::shared_ptr<KeyPathFilter> filter;
+    if (args.count == 2 && !Value::is_undefined(ctx, args[1])) {
+        ObjectType options = Value::validated_to_object(ctx, args[1], "options");
+        if (auto key_paths = validated_key_paths<T>(ctx, options)) {
+            filter = std::make_shared<KeyPathFilter>(realm_object->realm()->schema(), realm_object->get_object_schema(), *key_paths);
+        }
+    }
+
     Protected<FunctionType> protected_callback(ctx, callback);
     Protected<ObjectType> protected_this(ctx, this_object);
     Protected<typename T::GlobalContext> protected_ctx(Context<T>::get_global_context(ctx));
 
-    auto token = realm_object->add_notification_callback([=](CollectionChangeSet const& change_set, std::exception_ptr exception) {
-            HANDLESCOPE
+    auto deliver = [=](bool deleted, const std::vector<std::string>& changed_properties) {
+        HANDLESCOPE
+
+        // Interned through the table of this thread on every call, as a
+        // static would hold the entry of whichever thread came first.
+        const String deleted_string = String::intern("deleted");
+        const String changed_properties_string = String::intern("changedProperties");
+
+        std::vector<ValueType> scratch;
+        scratch.reserve(changed_properties.size());
+        for (auto& name : changed_properties) {
+            scratch.push_back(Value::from_nonnull_string(protected_ctx, String::intern(name)));
+        }
+
+        ObjectType object = Object::create_empty(protected_ctx);
+        Object::set_property(protected_ctx, object, deleted_string, Value::from_boolean(protected_ctx, deleted));
+        Object::set_property(protected_ctx, object, changed_properties_string, Object::create_array(protected_ctx, scratch));
+
+        ValueType arguments[] {
+            static_cast<ObjectType>(protected_this),
+            object
+        };
+        Function::callback(protected_ctx, protected_callback, protected_this, 2, arguments);
+    };
 
-            bool deleted = false;
-            std::vector<ValueType> scratch;
+    // Changes along key paths through links are not reported by the object
+    // notifier, so they are looked for whenever the Realm changes. The
+    // callback lives as long as the notification token.
+    std::shared_ptr<std::function<void()>> nested_changes;
+    if (filter && filter->has_nested_paths() && realm_object->is_valid()) {
+        filter->observe(realm_object->row());
+        nested_changes = std::make_shared<std::function<void()>>([=] {
+            // Deletions are reported by the notifier.
+            if (!realm_object->is_valid()) {
+                return;
+            }
+            auto changed_properties = filter->nested_changes(realm_object->row());
+            if (!changed_properties.empty()) {
+                deliver(false, changed_properties);
+            }
+        });
+        if (auto delegate = get_delegate<T>(realm_object->realm().get())) {
+            delegate->add_change_callback(nested_changes);
+        }
+    }
 
-            if (!change_set.deletions.empty()) {
-                deleted = true;
+    auto token = realm_object->add_notification_callback([=](CollectionChangeSet const& change_set, std::exception_ptr exception) {
+            if (filter && !filter->filter_object_changes(change_set)) {
+                return;
             }
-            else {
+
+            std::vector<std::string> changed_properties;
+            bool deleted = !change_set.deletions.empty();
+            if (!deleted) {
                 auto table = realm_object->row().get_table();
                 for (size_t i = 0; i < change_set.columns.size(); ++i) {
-                    if (change_set.columns[i].empty()) {
-                        continue;
+                    if (!change_set.columns[i].empty()) {
+                        changed_properties.push_back(table->get_column_name(i));
                     }
-                    scratch.push_back(Value::from_string(protected_ctx, std::string(table->get_column_name(i))));
                 }
             }
+            deliver(deleted, changed_properties);
 
-            ObjectType object = Object::create_empty(protected_ctx);
-            Object::set_property(protected_ctx, object, "deleted", Value::from_boolean(protected_ctx, deleted));
-            Object::set_property(protected_ctx, object, "changedProperties", Object::create_array(protected_ctx, scratch));
-
-            ValueType arguments[] {
-                static_cast<ObjectType>(protected_this),
-                object
-            };
-            Function::callback(protected_ctx, protected_callback, protected_this, 2, arguments);
+            // Held here so that it is destroyed with the token.
+            static_cast<void>(nested_changes);
         });
     realm_object->m_notification_tokens.emplace_back(protected_callback, std::move(token));
+    realm_object->listeners_changed();
 }
 
 template<typename T>
@@ -359,6 +522,7 @@ void RealmObjectClass<T>::remove_listener(ContextType ctx, ObjectType this_objec
         return typename Protected<FunctionType>::Comparator()(token.first, protected_function);
     };
     tokens.erase(std::remove_if(tokens.begin(), tokens.end(), compare), tokens.end());
+    realm_object->listeners_changed();
 }
 
 template<typename T>
@@ -367,6 +531,7 @@ void RealmObjectClass<T>::remove_all_listeners(ContextType ctx, ObjectType this_
 
     auto realm_object = get_internal<T, RealmObjectClass<T>>(this_object);
     realm_object->m_notification_tokens.clear();
+    realm_object->listeners_changed();
 }
 
 
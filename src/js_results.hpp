@@ -19,8 +19,14 @@
 #pragma once
 
 #include "js_collection.hpp"
+#include "js_frozen.hpp"
+#include "js_key_paths.hpp"
+#include "js_plain.hpp"
 #include "js_realm_object.hpp"
 #include "js_util.hpp"
+#include "live_aggregate.hpp"
+#include "results_cursor.hpp"
+#include "trace_events.hpp"
 
 #include "keypath_helpers.hpp"
 #include "list.hpp"
@@ -30,6 +36,17 @@
 #include <realm/parser/parser.hpp>
 #include <realm/parser/query_builder.hpp>
 #include <realm/util/optional.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <list>
+#include <map>
+#include <memory>
+#include <unordered_map>
+
 #ifdef REALM_ENABLE_SYNC
 #include "js_sync.hpp"
 #include "sync/partial_sync.hpp"
@@ -41,6 +58,15 @@ namespace js {
 template<typename>
 class NativeAccessor;
 
+template<typename>
+class PreparedQueryClass;
+
+template<typename>
+class ResultsCursorClass;
+
+template<typename>
+class CollectionIteratorClass;
+
 struct NonRealmObjectException : public std::logic_error {
     NonRealmObjectException() : std::logic_error("Object is not a Realm object") { }
 };
@@ -57,6 +83,38 @@ class Results : public realm::Results {
     using realm::Results::Results;
 
     std::vector<std::pair<Protected<typename T::Function>, NotificationToken>> m_notification_tokens;
+    // Rejects the evaluations of evaluate_async() which wait on one of the
+    // tokens, for when the listeners are removed.
+    std::vector<std::weak_ptr<std::function<void()>>> m_pending_evaluations;
+    LiveWrapper<&LiveWrapperCounts::results> m_live{live_wrapper_counts<T>(get_realm())};
+
+    void listeners_changed() {
+        m_live.set_listeners(m_notification_tokens.size());
+    }
+};
+
+// A query parsed once, to be run against a Realm's objects of one type with
+// different arguments each time.
+struct PreparedQuery {
+    SharedRealm realm;
+    std::string object_type;
+    std::shared_ptr<const parser::ParserResult> parsed;
+};
+
+// The collection a cursor pages through, which is queried again for each page.
+struct ResultsCursorState {
+    realm::Results results;
+    ResultsCursor cursor;
+};
+
+// The snapshot an iterator reads in chunks, and how far it has got.
+template<typename T>
+struct CollectionIteratorState {
+    realm::Results results;
+    size_t chunk_size;
+    // Elements are read as plain values if set, and as Realm objects if not.
+    util::Optional<typename PlainObjectBuilder<T>::Options> plain;
+    size_t index = 0;
 };
 
 template<typename T>
@@ -76,6 +134,23 @@ struct ResultsClass : ClassDefinition<T, realm::js::Results<T>, CollectionClass<
 
     template<typename U>
     static ObjectType create_filtered(ContextType, const U &, Arguments &);
+    template<typename U>
+    static ObjectType create_filtered(ContextType, const U &, const parser::ParserResult &, const ValueType *, size_t);
+    template<typename U>
+    static ObjectType create_filtered_prepared(ContextType, const U &, Arguments &);
+    static ObjectType create_limited(ContextType, realm::Results, Arguments &);
+    static ObjectType create_linking_objects(ContextType, realm::Results, Arguments &);
+    static ObjectType create_linking_objects_counts(ContextType, realm::Results, Arguments &);
+    static ValueType create_plain(ContextType, realm::Results, Arguments &);
+    static const Property &validated_linking_property(ContextType, realm::Results &, Arguments &, realm::TableRef &origin_table);
+
+    // Parsing depends on nothing but the query string, so the most recently
+    // used queries are kept parsed for the thread's Realms to share.
+    static constexpr size_t max_cached_queries = 64;
+    static std::shared_ptr<const parser::ParserResult> parse_query(const std::string &);
+
+    static ObjectType explain_query(ContextType, realm::Results &);
+    static void explain_predicate(ContextType, const ObjectSchema &, const parser::Predicate &, ObjectType conditions, uint32_t &count);
 
     static std::vector<std::pair<std::string, bool>> get_keypaths(ContextType, Arguments &);
 
@@ -85,13 +160,28 @@ struct ResultsClass : ClassDefinition<T, realm::js::Results<T>, CollectionClass<
     static void get_index(ContextType, ObjectType, uint32_t, ReturnValue &);
 
     static void description(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void explain(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void profile(ContextType, ObjectType, Arguments &, ReturnValue &);
     static void snapshot(ContextType, ObjectType, Arguments &, ReturnValue &);
     static void filtered(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void filtered_prepared(ContextType, ObjectType, Arguments &, ReturnValue &);
     static void sorted(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void limit(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void cursor(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void iterate(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void freeze(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void linking_objects(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void linking_objects_counts(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void to_plain(ContextType, ObjectType, Arguments &, ReturnValue &);
     static void is_valid(ContextType, ObjectType, Arguments &, ReturnValue &);
     static void is_empty(ContextType, ObjectType, Arguments &, ReturnValue &);
 #if REALM_ENABLE_SYNC
     static void subscribe(ContextType, ObjectType, Arguments &, ReturnValue &);
+    // Reads the name or the options given to subscribe(). The key path
+    // mapping is only built if it is needed, and then kept in `mapping` for
+    // the subscriptions which follow.
+    static partial_sync::SubscriptionOptions validated_subscription_options(ContextType, realm::Results &, ValueType,
+                                                                            util::Optional<parser::KeyPathMapping> &mapping);
 #endif
 
     static void index_of(ContextType, ObjectType, Arguments &, ReturnValue &);
@@ -99,25 +189,52 @@ struct ResultsClass : ClassDefinition<T, realm::js::Results<T>, CollectionClass<
     template<typename Fn>
     static void index_of(ContextType, Fn&, Arguments &, ReturnValue &);
 
+    static void slice(ContextType, ObjectType, Arguments &, ReturnValue &);
+    template<typename U>
+    static void slice(ContextType, U&, Arguments &, ReturnValue &);
+
+    static void to_typed_array(ContextType, ObjectType, Arguments &, ReturnValue &);
+    template<typename U>
+    static void to_typed_array(ContextType, U&, Arguments &, ReturnValue &);
+    template<typename Number, typename U>
+    static void read_numbers(U&, std::vector<double> &);
+
     static void update(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void evaluate_async(ContextType, ObjectType, Arguments &, ReturnValue &);
+    // Validates and unboxes the value of a property, and returns the function
+    // which writes it to every row.
+    static std::function<void()> prepare_update(ContextType, NativeAccessor<T> &, realm::Results &, const Property &, ValueType);
+    static void validate_primary_key_update(NativeAccessor<T> &, realm::Results &, const Property &, ValueType);
 
     // observable
     static void add_listener(ContextType, ObjectType, Arguments &, ReturnValue &);
     static void remove_listener(ContextType, ObjectType, Arguments &, ReturnValue &);
     static void remove_all_listeners(ContextType, ObjectType, Arguments &, ReturnValue &);
 
+    static void observe_aggregate(ContextType, ObjectType, Arguments &, ReturnValue &);
+
     template<typename U>
     static void add_listener(ContextType, U&, ObjectType, Arguments &);
     template<typename U>
+    static void observe_aggregate(ContextType, U&, ObjectType, Arguments &);
+    template<typename U>
     static void remove_listener(ContextType, U&, ObjectType, Arguments &);
 
     std::string const name = "Results";
 
     MethodMap<T> const methods = {
         {"description", wrap<description>},
+        {"explain", wrap<explain>},
+        {"profile", wrap<profile>},
         {"snapshot", wrap<snapshot>},
         {"filtered", wrap<filtered>},
+        {"filteredPrepared", wrap<filtered_prepared>},
         {"sorted", wrap<sorted>},
+        {"limit", wrap<limit>},
+        {"cursor", wrap<cursor>},
+        {"linkingObjects", wrap<linking_objects>},
+        {"linkingObjectsCounts", wrap<linking_objects_counts>},
+        {"toPlain", wrap<to_plain>},
         {"isValid", wrap<is_valid>},
         {"isEmpty", wrap<is_empty>},
 #if REALM_ENABLE_SYNC
@@ -130,8 +247,14 @@ struct ResultsClass : ClassDefinition<T, realm::js::Results<T>, CollectionClass<
         {"addListener", wrap<add_listener>},
         {"removeListener", wrap<remove_listener>},
         {"removeAllListeners", wrap<remove_all_listeners>},
+        {"observeAggregate", wrap<observe_aggregate>},
         {"indexOf", wrap<index_of>},
+        {"slice", wrap<slice>},
+        {"toTypedArray", wrap<to_typed_array>},
         {"update", wrap<update>},
+        {"_evaluateAsync", wrap<evaluate_async>},
+        {"_iterate", wrap<iterate>},
+        {"freeze", wrap<freeze>},
     };
 
     PropertyMap<T> const properties = {
@@ -165,22 +288,168 @@ typename T::Object ResultsClass<T>::create_filtered(ContextType ctx, const U &co
     }
 
     auto query_string = Value::validated_to_string(ctx, args[0], "predicate");
+    auto parsed = parse_query(query_string);
+    return create_filtered(ctx, collection, *parsed, &args.value[1], args.count - 1);
+}
+
+template<typename T>
+template<typename U>
+typename T::Object ResultsClass<T>::create_filtered(ContextType ctx, const U &collection, const parser::ParserResult &parsed,
+                                                    const ValueType *arguments, size_t count) {
     auto query = collection.get_query();
     auto const &realm = collection.get_realm();
     auto const &object_schema = collection.get_object_schema();
     DescriptorOrdering ordering;
-    parser::KeyPathMapping mapping;
-    realm::populate_keypath_mapping(mapping, *realm);
 
-    parser::ParserResult result = parser::parse(query_string);
+    parser::KeyPathMapping local_mapping;
+    const parser::KeyPathMapping* mapping = &local_mapping;
+    if (auto delegate = get_delegate<T>(realm.get())) {
+        mapping = &delegate->keypath_mapping(*realm);
+    }
+    else {
+        realm::populate_keypath_mapping(local_mapping, *realm);
+    }
+
     NativeAccessor<T> accessor(ctx, realm, object_schema);
-    query_builder::ArgumentConverter<ValueType, NativeAccessor<T>> converter(accessor, &args.value[1], args.count - 1);
-    query_builder::apply_predicate(query, result.predicate, converter, mapping);
-    query_builder::apply_ordering(ordering, query.get_table(), result.ordering, mapping);
+    query_builder::ArgumentConverter<ValueType, NativeAccessor<T>> converter(accessor, arguments, count);
+    query_builder::apply_predicate(query, parsed.predicate, converter, *mapping);
+    query_builder::apply_ordering(ordering, query.get_table(), parsed.ordering, *mapping);
 
     return create_instance(ctx, collection.filter(std::move(query)).apply_ordering(std::move(ordering)));
 }
 
+template<typename T>
+typename T::Object ResultsClass<T>::create_limited(ContextType ctx, realm::Results results, Arguments &args) {
+    args.validate_count(1);
+
+    double count = Value::validated_to_number(ctx, args[0], "count");
+    if (!(count >= 0) || count != std::trunc(count)) {
+        throw std::invalid_argument("The count must be a non-negative integer.");
+    }
+
+    // The limit is applied by core after any sorting and distinct, as it is
+    // for LIMIT() in a query.
+    DescriptorOrdering ordering;
+    ordering.append_limit(LimitDescriptor(size_t(count)));
+    return create_instance(ctx, results.apply_ordering(std::move(ordering)));
+}
+
+template<typename T>
+const Property &ResultsClass<T>::validated_linking_property(ContextType ctx, realm::Results &results, Arguments &args,
+                                                            realm::TableRef &origin_table) {
+    args.validate_count(2);
+
+    std::string object_type = Value::validated_to_string(ctx, args[0], "objectType");
+    std::string property_name = Value::validated_to_string(ctx, args[1], "property");
+    if (results.get_type() != realm::PropertyType::Object) {
+        throw std::logic_error("Only collections of objects have linking objects.");
+    }
+
+    auto realm = results.get_realm();
+    auto origin_object_schema = realm->schema().find(object_type);
+    if (origin_object_schema == realm->schema().end()) {
+        throw std::logic_error(util::format("Could not find schema for type '%1'", object_type));
+    }
+    auto link_property = origin_object_schema->property_for_name(property_name);
+    if (!link_property) {
+        throw std::logic_error(util::format("Type '%1' does not contain property '%2'", object_type, property_name));
+    }
+    if (link_property->object_type != results.get_object_schema().name) {
+        throw std::logic_error(util::format("'%1.%2' is not a relationship to '%3'", object_type, property_name, results.get_object_schema().name));
+    }
+
+    origin_table = ObjectStore::table_for_object_type(realm->read_group(), object_type);
+    return *link_property;
+}
+
+// The objects linking to any object of the collection are found in a single
+// pass over the link column, rather than through a backlink view per object.
+// The objects linked to are the ones in the collection now, while the
+// objects linking to them are kept up to date.
+template<typename T>
+typename T::Object ResultsClass<T>::create_linking_objects(ContextType ctx, realm::Results results, Arguments &args) {
+    realm::TableRef origin_table;
+    auto &link_property = validated_linking_property(ctx, results, args, origin_table);
+
+    size_t size = results.size();
+    std::vector<ConstRow> targets;
+    targets.reserve(size);
+    for (size_t i = 0; i < size; i++) {
+        targets.push_back(results.get(i));
+    }
+    Query query = origin_table->where().links_to(link_property.table_column, targets);
+    return create_instance(ctx, realm::Results(results.get_realm(), std::move(query)));
+}
+
+template<typename T>
+typename T::Object ResultsClass<T>::create_linking_objects_counts(ContextType ctx, realm::Results results, Arguments &args) {
+    realm::TableRef origin_table;
+    auto &link_property = validated_linking_property(ctx, results, args, origin_table);
+
+    size_t size = results.size();
+    std::vector<int32_t> counts;
+    counts.reserve(size);
+    for (size_t i = 0; i < size; i++) {
+        RowExpr row = results.get(i);
+        counts.push_back(int32_t(row.get_table()->get_backlink_count(row.get_index(), *origin_table, link_property.table_column)));
+    }
+    return Object::create_int32_array(ctx, counts);
+}
+
+template<typename T>
+typename T::Value ResultsClass<T>::create_plain(ContextType ctx, realm::Results results, Arguments &args) {
+    auto options = PlainObjectBuilder<T>::validated_options(ctx, args);
+    PlainObjectBuilder<T> builder(ctx, results.get_realm(), std::move(options));
+    return builder.collection(results);
+}
+
+template<typename T>
+template<typename U>
+typename T::Object ResultsClass<T>::create_filtered_prepared(ContextType ctx, const U &collection, Arguments &args) {
+    if (args.count == 0) {
+        throw std::invalid_argument("Invalid arguments: a prepared query is required.");
+    }
+    if (collection.get_type() != realm::PropertyType::Object) {
+        throw std::runtime_error("Filtering non-object Lists and Results is not yet implemented.");
+    }
+
+    ObjectType prepared_object = Value::validated_to_object(ctx, args[0], "prepared query");
+    if (!Object::template is_instance<PreparedQueryClass<T>>(ctx, prepared_object)) {
+        throw std::invalid_argument("Invalid arguments: the first argument must be a prepared query.");
+    }
+    auto& prepared = *get_internal<T, PreparedQueryClass<T>>(prepared_object);
+    if (prepared.realm.get() != collection.get_realm().get()) {
+        throw std::logic_error("The query was prepared for a different Realm.");
+    }
+    if (prepared.object_type != collection.get_object_schema().name) {
+        throw std::logic_error(util::format("The query was prepared for objects of type '%1', not '%2'.",
+                                            prepared.object_type, collection.get_object_schema().name));
+    }
+    return create_filtered(ctx, collection, *prepared.parsed, &args.value[1], args.count - 1);
+}
+
+template<typename T>
+std::shared_ptr<const parser::ParserResult> ResultsClass<T>::parse_query(const std::string &query_string) {
+    using Entry = std::pair<std::string, std::shared_ptr<const parser::ParserResult>>;
+    static thread_local std::list<Entry> s_queries;
+    static thread_local std::unordered_map<std::string, typename std::list<Entry>::iterator> s_index;
+
+    auto it = s_index.find(query_string);
+    if (it != s_index.end()) {
+        s_queries.splice(s_queries.begin(), s_queries, it->second);
+        return it->second->second;
+    }
+
+    auto parsed = std::make_shared<const parser::ParserResult>(parser::parse(query_string));
+    s_queries.emplace_front(query_string, parsed);
+    s_index.emplace(query_string, s_queries.begin());
+    if (s_queries.size() > max_cached_queries) {
+        s_index.erase(s_queries.back().first);
+        s_queries.pop_back();
+    }
+    return parsed;
+}
+
 template<typename T>
 std::vector<std::pair<std::string, bool>>
 ResultsClass<T>::get_keypaths(ContextType ctx, Arguments &args) {
@@ -226,6 +495,8 @@ ResultsClass<T>::get_keypaths(ContextType ctx, Arguments &args) {
 template<typename T>
 void ResultsClass<T>::get_length(ContextType ctx, ObjectType object, ReturnValue &return_value) {
     auto results = get_internal<T, ResultsClass<T>>(object);
+    // Counting the results is what runs their query, if it hasn't run yet.
+    TraceScope trace("query", "evaluate");
     return_value.set((uint32_t)results->size());
 }
 
@@ -258,6 +529,128 @@ void ResultsClass<T>::description(ContextType ctx, ObjectType this_object, Argum
     return_value.set(Value::from_string(ctx, serialized_query));
 }
 
+template<typename T>
+void ResultsClass<T>::explain(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    args.validate_maximum(0);
+    auto results = get_internal<T, ResultsClass<T>>(this_object);
+    return_value.set(explain_query(ctx, *results));
+}
+
+template<typename T>
+void ResultsClass<T>::profile(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    args.validate_maximum(0);
+    using Clock = std::chrono::steady_clock;
+    auto millis = [](Clock::duration duration) {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    };
+
+    auto results = get_internal<T, ResultsClass<T>>(this_object);
+    ObjectType object = explain_query(ctx, *results);
+
+    auto query = results->get_query();
+    auto ordering = results->get_descriptor_ordering();
+    size_t table_size = query.get_table() ? query.get_table()->size() : 0;
+
+    // Parsing and building the query again from its description is what an
+    // uncached filtered() call costs.
+    auto start = Clock::now();
+    if (results->get_type() == realm::PropertyType::Object) {
+        parser::KeyPathMapping mapping;
+        realm::populate_keypath_mapping(mapping, *results->get_realm());
+        parser::ParserResult parsed = parser::parse(query.get_description());
+        auto rebuilt = query.get_table()->where();
+        query_builder::NoArguments no_arguments;
+        query_builder::apply_predicate(rebuilt, parsed.predicate, no_arguments, mapping);
+    }
+    auto parsed = Clock::now();
+    auto table_view = query.find_all();
+    auto evaluated = Clock::now();
+    size_t matched = table_view.size();
+    table_view.apply_descriptor_ordering(ordering);
+    auto ordered = Clock::now();
+
+    Object::set_property(ctx, object, "parseMillis", Value::from_number(ctx, millis(parsed - start)));
+    Object::set_property(ctx, object, "evaluateMillis", Value::from_number(ctx, millis(evaluated - parsed)));
+    Object::set_property(ctx, object, "orderMillis", Value::from_number(ctx, millis(ordered - evaluated)));
+    Object::set_property(ctx, object, "rowsExamined", Value::from_number(ctx, double(table_size)));
+    Object::set_property(ctx, object, "rowsMatched", Value::from_number(ctx, double(matched)));
+    Object::set_property(ctx, object, "rowsReturned", Value::from_number(ctx, double(table_view.size())));
+    return_value.set(object);
+}
+
+template<typename T>
+typename T::Object ResultsClass<T>::explain_query(ContextType ctx, realm::Results &results) {
+    auto query = results.get_query();
+    auto ordering = results.get_descriptor_ordering();
+    std::string description = query.get_description();
+
+    ObjectType object = Object::create_empty(ctx);
+    Object::set_property(ctx, object, "query", Value::from_string(ctx, description));
+    Object::set_property(ctx, object, "ordering", Value::from_string(ctx, query.get_table() ? ordering.get_description(query.get_table()) : ""));
+
+    // The description is in the query language, so parsing it gives the
+    // conditions the query was built from, with their arguments filled in.
+    ObjectType conditions = Object::create_array(ctx);
+    if (results.get_type() == realm::PropertyType::Object) {
+        Object::set_property(ctx, object, "objectType", Value::from_string(ctx, results.get_object_schema().name));
+        uint32_t count = 0;
+        try {
+            parser::ParserResult parsed = parser::parse(description);
+            explain_predicate(ctx, results.get_object_schema(), parsed.predicate, conditions, count);
+        }
+        catch (std::exception const&) {
+            // Not every description can be parsed again, in which case the
+            // conditions are left out.
+        }
+    }
+    Object::set_property(ctx, object, "conditions", conditions);
+    return object;
+}
+
+template<typename T>
+void ResultsClass<T>::explain_predicate(ContextType ctx, const ObjectSchema &object_schema, const parser::Predicate &predicate,
+                                        ObjectType conditions, uint32_t &count) {
+    using Predicate = parser::Predicate;
+    if (predicate.type == Predicate::Type::And || predicate.type == Predicate::Type::Or) {
+        for (auto& sub_predicate : predicate.cpnd.sub_predicates) {
+            explain_predicate(ctx, object_schema, sub_predicate, conditions, count);
+        }
+        return;
+    }
+    if (predicate.type != Predicate::Type::Comparison) {
+        return;
+    }
+
+    auto& comparison = predicate.cmpr;
+    const parser::Expression* key_path = nullptr;
+    for (auto& expression : comparison.expr) {
+        if (expression.type == parser::Expression::Type::KeyPath) {
+            key_path = &expression;
+            break;
+        }
+    }
+    if (!key_path) {
+        return;
+    }
+
+    // The core only searches an index for case-sensitive equality on a
+    // property of the objects themselves.
+    const Property* property = nullptr;
+    if (key_path->s.find('.') == std::string::npos) {
+        property = object_schema.property_for_name(key_path->s);
+    }
+    bool uses_index = property && property->is_indexed && !predicate.negate
+        && comparison.op == Predicate::Operator::Equal
+        && comparison.option != Predicate::OperatorOption::CaseInsensitive
+        && comparison.compare_type == Predicate::ComparisonType::Unspecified;
+
+    ObjectType condition = Object::create_empty(ctx);
+    Object::set_property(ctx, condition, "keyPath", Value::from_string(ctx, key_path->s));
+    Object::set_property(ctx, condition, "indexed", Value::from_boolean(ctx, property && property->is_indexed));
+    Object::set_property(ctx, condition, "usesIndex", Value::from_boolean(ctx, uses_index));
+    Object::set_property(ctx, conditions, count++, condition);
+}
+
 template<typename T>
 void ResultsClass<T>::snapshot(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
     args.validate_maximum(0);
@@ -267,16 +660,70 @@ void ResultsClass<T>::snapshot(ContextType ctx, ObjectType this_object, Argument
 
 template<typename T>
 void ResultsClass<T>::filtered(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    TraceScope trace("query", "filtered");
     auto results = get_internal<T, ResultsClass<T>>(this_object);
     return_value.set(create_filtered(ctx, *results, args));
 }
 
+template<typename T>
+void ResultsClass<T>::filtered_prepared(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    TraceScope trace("query", "filtered");
+    auto results = get_internal<T, ResultsClass<T>>(this_object);
+    return_value.set(create_filtered_prepared(ctx, *results, args));
+}
+
 template<typename T>
 void ResultsClass<T>::sorted(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    TraceScope trace("query", "sorted");
     auto results = get_internal<T, ResultsClass<T>>(this_object);
     return_value.set(ResultsClass<T>::create_instance(ctx, results->sort(ResultsClass<T>::get_keypaths(ctx, args))));
 }
 
+template<typename T>
+void ResultsClass<T>::limit(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    auto results = get_internal<T, ResultsClass<T>>(this_object);
+    return_value.set(create_limited(ctx, *results, args));
+}
+
+template<typename T>
+void ResultsClass<T>::linking_objects(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    auto results = get_internal<T, ResultsClass<T>>(this_object);
+    return_value.set(create_linking_objects(ctx, *results, args));
+}
+
+template<typename T>
+void ResultsClass<T>::linking_objects_counts(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    auto results = get_internal<T, ResultsClass<T>>(this_object);
+    return_value.set(create_linking_objects_counts(ctx, *results, args));
+}
+
+template<typename T>
+void ResultsClass<T>::to_plain(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    auto results = get_internal<T, ResultsClass<T>>(this_object);
+    return_value.set(create_plain(ctx, *results, args));
+}
+
+template<typename T>
+void ResultsClass<T>::cursor(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    args.validate_maximum(1);
+    auto results = get_internal<T, ResultsClass<T>>(this_object);
+    return_value.set(ResultsCursorClass<T>::create_instance(ctx, *results, args.count ? args[0] : Value::from_undefined(ctx)));
+}
+
+template<typename T>
+void ResultsClass<T>::iterate(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    args.validate_maximum(1);
+    auto results = get_internal<T, ResultsClass<T>>(this_object);
+    return_value.set(CollectionIteratorClass<T>::create_instance(ctx, *results, args.count ? args[0] : Value::from_undefined(ctx)));
+}
+
+template<typename T>
+void ResultsClass<T>::freeze(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    args.validate_maximum(0);
+    auto results = get_internal<T, ResultsClass<T>>(this_object);
+    return_value.set(FrozenResultsClass<T>::create_instance(ctx, *results));
+}
+
 template<typename T>
 void ResultsClass<T>::is_valid(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
     return_value.set(get_internal<T, ResultsClass<T>>(this_object)->is_valid());
@@ -293,78 +740,74 @@ void ResultsClass<T>::subscribe(ContextType ctx, ObjectType this_object, Argumen
     args.validate_maximum(1);
 
     auto results = get_internal<T, ResultsClass<T>>(this_object);
-    auto realm = results->get_realm();
-    auto object_schema = results->get_object_schema();
-    auto sync_config = realm->config().sync_config;
-    IncludeDescriptor inclusion_paths;
-
-    util::Optional<std::string> subscription_name;
-    bool update = false;
-    util::Optional<int64_t> ttl = util::none;
-    if (args.count == 1) {
-        if (Value::is_string(ctx, args[0])) {
-            subscription_name = util::Optional<std::string>(Value::validated_to_string(ctx, args[0]));
-        } else {
-            ObjectType options_object = Value::validated_to_object(ctx, args[0]);
-
-            std::vector<const char*> available_options = {"name", "update", "timeToLive", "includeLinkingObjects"};
-            enum SubscriptionOptions { NAME, UPDATE, TTL, INCLUSIONS };
-            auto prop_names = Object::get_property_names(ctx, options_object);
-            for (size_t i = 0; i < prop_names.size(); ++i) {
-                std::string prop = prop_names[i];
-                if (std::find(available_options.begin(), available_options.end(), prop) == available_options.end()) {
-                    throw std::logic_error("Unexpected property in subscription options: '" + prop + "'.");
-                }
-            }
+    util::Optional<parser::KeyPathMapping> mapping;
+    auto options = validated_subscription_options(ctx, *results, args.count == 1 ? args[0] : Value::from_undefined(ctx), mapping);
+    auto subscription = partial_sync::subscribe(*results, options);
 
-            ValueType name_value = Object::get_property(ctx, options_object, available_options[NAME]);
-            if (!Value::is_undefined(ctx, name_value)) {
-                subscription_name = util::Optional<std::string>(Value::validated_to_string(ctx, name_value, available_options[NAME]));
-            }
+    return_value.set(SubscriptionClass<T>::create_instance(ctx, std::move(subscription), options.user_provided_name));
+}
 
-            ValueType update_value = Object::get_property(ctx, options_object, available_options[UPDATE]);
-            if (!Value::is_undefined(ctx, update_value))
-                update = Value::validated_to_boolean(ctx, update_value, available_options[UPDATE]);
-
-            ValueType ttl_value = Object::get_property(ctx, options_object, available_options[TTL]);
-            if (!Value::is_undefined(ctx, ttl_value))
-                ttl = util::Optional<int64_t>(Value::validated_to_number(ctx, ttl_value, available_options[TTL]));
-
-            ValueType user_includes = Object::get_property(ctx, options_object, available_options[INCLUSIONS]);
-            if (!Value::is_undefined(ctx, user_includes)) {
-                ObjectType property_paths = Value::validated_to_array(ctx, user_includes, available_options[INCLUSIONS]);
-
-                parser::KeyPathMapping mapping;
-                realm::populate_keypath_mapping(mapping, *realm); // this enables user defined linkingObjects property names to be parsed
-                DescriptorOrdering combined_orderings;
-
-                size_t prop_count = Object::validated_get_length(ctx, property_paths);
-                for (unsigned int i = 0; i < prop_count; i++) {
-                    std::string path = Object::validated_get_string(ctx, property_paths, i);
-                    DescriptorOrdering ordering;
-                    // the parser provides a special function just for this
-                    parser::DescriptorOrderingState ordering_state = parser::parse_include_path(path); // throws
-                    query_builder::apply_ordering(ordering, results->get_query().get_table(), ordering_state, mapping);
-                    combined_orderings.append_include(ordering.compile_included_backlinks());
-                }
-                if (combined_orderings.will_apply_include()) {
-                    inclusion_paths = combined_orderings.compile_included_backlinks();
-                }
-            }
+template<typename T>
+partial_sync::SubscriptionOptions ResultsClass<T>::validated_subscription_options(ContextType ctx, realm::Results &results, ValueType value,
+                                                                                  util::Optional<parser::KeyPathMapping> &mapping) {
+    partial_sync::SubscriptionOptions options;
+    if (Value::is_undefined(ctx, value)) {
+        return options;
+    }
+    if (Value::is_string(ctx, value)) {
+        options.user_provided_name = util::Optional<std::string>(Value::validated_to_string(ctx, value));
+        return options;
+    }
+
+    ObjectType options_object = Value::validated_to_object(ctx, value);
+
+    std::vector<const char*> available_options = {"name", "update", "timeToLive", "includeLinkingObjects"};
+    enum SubscriptionOptions { NAME, UPDATE, TTL, INCLUSIONS };
+    auto prop_names = Object::get_property_names(ctx, options_object);
+    for (size_t i = 0; i < prop_names.size(); ++i) {
+        std::string prop = prop_names[i];
+        if (std::find(available_options.begin(), available_options.end(), prop) == available_options.end()) {
+            throw std::logic_error("Unexpected property in subscription options: '" + prop + "'.");
         }
     }
-    else {
-        subscription_name = util::none;
+
+    ValueType name_value = Object::get_property(ctx, options_object, available_options[NAME]);
+    if (!Value::is_undefined(ctx, name_value)) {
+        options.user_provided_name = util::Optional<std::string>(Value::validated_to_string(ctx, name_value, available_options[NAME]));
     }
 
-    partial_sync::SubscriptionOptions options;
-    options.user_provided_name = subscription_name;
-    options.inclusions = inclusion_paths;
-    options.time_to_live_ms = ttl;
-    options.update = update;
-    auto subscription = partial_sync::subscribe(*results, options);
+    ValueType update_value = Object::get_property(ctx, options_object, available_options[UPDATE]);
+    if (!Value::is_undefined(ctx, update_value))
+        options.update = Value::validated_to_boolean(ctx, update_value, available_options[UPDATE]);
+
+    ValueType ttl_value = Object::get_property(ctx, options_object, available_options[TTL]);
+    if (!Value::is_undefined(ctx, ttl_value))
+        options.time_to_live_ms = util::Optional<int64_t>(Value::validated_to_number(ctx, ttl_value, available_options[TTL]));
+
+    ValueType user_includes = Object::get_property(ctx, options_object, available_options[INCLUSIONS]);
+    if (!Value::is_undefined(ctx, user_includes)) {
+        ObjectType property_paths = Value::validated_to_array(ctx, user_includes, available_options[INCLUSIONS]);
 
-    return_value.set(SubscriptionClass<T>::create_instance(ctx, std::move(subscription), subscription_name));
+        if (!mapping) {
+            mapping.emplace();
+            realm::populate_keypath_mapping(*mapping, *results.get_realm()); // this enables user defined linkingObjects property names to be parsed
+        }
+        DescriptorOrdering combined_orderings;
+
+        size_t prop_count = Object::validated_get_length(ctx, property_paths);
+        for (unsigned int i = 0; i < prop_count; i++) {
+            std::string path = Object::validated_get_string(ctx, property_paths, i);
+            DescriptorOrdering ordering;
+            // the parser provides a special function just for this
+            parser::DescriptorOrderingState ordering_state = parser::parse_include_path(path); // throws
+            query_builder::apply_ordering(ordering, results.get_query().get_table(), ordering_state, *mapping);
+            combined_orderings.append_include(ordering.compile_included_backlinks());
+        }
+        if (combined_orderings.will_apply_include()) {
+            options.inclusions = combined_orderings.compile_included_backlinks();
+        }
+    }
+    return options;
 }
 #endif
 
@@ -394,14 +837,32 @@ void ResultsClass<T>::index_of(ContextType ctx, Fn& fn, Arguments &args, ReturnV
 
 template<typename T>
 void ResultsClass<T>::update(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
-    args.validate_maximum(2);
+    args.validate_between(1, 2);
 
-    std::string property = Value::validated_to_string(ctx, args[0], "property");
     auto results = get_internal<T, ResultsClass<T>>(this_object);
+    auto& object_schema = results->get_object_schema();
 
-    auto schema = results->get_object_schema();
-    if (!schema.property_for_name(StringData(property))) {
-        throw std::invalid_argument(util::format("No such property: %1", property));
+    auto validated_property = [&](const std::string& name) -> const Property& {
+        auto prop = object_schema.property_for_name(name);
+        if (!prop) {
+            prop = object_schema.property_for_public_name(name);
+        }
+        if (!prop) {
+            throw std::invalid_argument(util::format("No such property: %1", name));
+        }
+        return *prop;
+    };
+
+    std::vector<std::pair<const Property*, ValueType>> updates;
+    if (args.count == 2) {
+        std::string property = Value::validated_to_string(ctx, args[0], "property");
+        updates.emplace_back(&validated_property(property), args[1]);
+    }
+    else {
+        ObjectType values = Value::validated_to_object(ctx, args[0], "values");
+        for (auto& name : Object::get_property_names(ctx, values)) {
+            updates.emplace_back(&validated_property(name), Object::get_property(ctx, values, name));
+        }
     }
 
     auto realm = results->get_realm();
@@ -409,12 +870,147 @@ void ResultsClass<T>::update(ContextType ctx, ObjectType this_object, Arguments
         throw std::runtime_error("Can only 'update' objects within a transaction.");
     }
 
-    // TODO: This approach just moves the for-loop from JS to C++
-    // Ideally, we'd implement this in OS or Core in an optimized fashion
-    for (auto i = results->size(); i > 0; i--) {
-        auto realm_object = realm::Object(realm, schema, results->get(i - 1));
-        auto obj = RealmObjectClass<T>::create_instance(ctx, realm_object);
-        RealmObjectClass<T>::set_property(ctx, obj, property, args[1]);
+    // Each value is validated and unboxed once and then written to every
+    // object, without creating a Realm.Object for each one. Every value is
+    // validated before the first one is written, so that a bad value doesn't
+    // leave the objects partly updated. The snapshot keeps the objects stable
+    // while updating properties that the results may be filtered on.
+    auto snapshot = results->snapshot();
+    NativeAccessor<T> accessor(ctx, realm, object_schema);
+    for (auto& update : updates) {
+        if (!Value::is_valid_for_property(ctx, update.second, *update.first, accessor.dates_as_numbers())) {
+            throw TypeErrorException(accessor, object_schema.name, *update.first, update.second);
+        }
+        if (update.first->is_primary) {
+            validate_primary_key_update(accessor, snapshot, *update.first, update.second);
+        }
+    }
+
+    // Links go first, as they may create the objects they link to, which can
+    // still fail on the values of those objects.
+    std::stable_sort(updates.begin(), updates.end(), [](auto const& a, auto const& b) {
+        return a.first->type == realm::PropertyType::Object && b.first->type != realm::PropertyType::Object;
+    });
+
+    std::vector<std::function<void()>> writes;
+    writes.reserve(updates.size());
+    for (auto& update : updates) {
+        writes.push_back(prepare_update(ctx, accessor, snapshot, *update.first, update.second));
+    }
+    for (auto& write : writes) {
+        write();
+    }
+}
+
+template<typename T>
+void ResultsClass<T>::validate_primary_key_update(NativeAccessor<T> &accessor, realm::Results &rows, const Property &prop, ValueType value) {
+    if (rows.size() > 1) {
+        throw std::runtime_error(util::format("Cannot set the primary key '%1' of more than one object to the same value.", prop.name));
+    }
+    if (rows.size() == 0) {
+        return;
+    }
+
+    auto realm = rows.get_realm();
+    TableRef table = ObjectStore::table_for_object_type(realm->read_group(), rows.get_object_schema().name);
+    size_t row = rows.get(0).get_index();
+    size_t existing = realm::not_found;
+    if (accessor.is_null(value)) {
+        existing = table->find_first_null(prop.table_column);
+    }
+    else if ((prop.type & ~realm::PropertyType::Flags) == realm::PropertyType::String) {
+        existing = table->find_first_string(prop.table_column, accessor.template unbox<StringData>(value));
+    }
+    else {
+        existing = table->find_first_int(prop.table_column, accessor.template unbox<int64_t>(value));
+    }
+    if (existing != realm::not_found && existing != row) {
+        throw std::logic_error(util::format("Attempting to create an object of type '%1' with an existing primary key value '%2'.",
+                                            rows.get_object_schema().name, accessor.print(value)));
+    }
+}
+
+template<typename T>
+std::function<void()> ResultsClass<T>::prepare_update(ContextType ctx, NativeAccessor<T> &accessor, realm::Results &rows, const Property &prop, ValueType value) {
+    using realm::PropertyType;
+
+    auto realm = rows.get_realm();
+    auto& object_schema = rows.get_object_schema();
+
+    // Primary keys, lists and linking objects go through the object store,
+    // which enforces their rules.
+    if (prop.is_primary || is_array(prop.type) || prop.type == PropertyType::LinkingObjects) {
+        return [=, &accessor, &rows, &prop, &object_schema] {
+            for (size_t i = 0, count = rows.size(); i < count; ++i) {
+                realm::Object realm_object(realm, object_schema, rows.get(i));
+                realm_object.set_property_value(accessor, prop.name, value, realm::CreatePolicy::UpdateAll);
+            }
+        };
+    }
+
+    TableRef table = ObjectStore::table_for_object_type(realm->read_group(), object_schema.name);
+    size_t column = prop.table_column;
+    // The values are unboxed now and kept by the returned function, as the
+    // strings and binaries the accessor unboxes only live until the next one.
+    auto set_all = [table, &rows](auto set) -> std::function<void()> {
+        return [table, &rows, set] {
+            for (size_t i = 0, count = rows.size(); i < count; ++i) {
+                set(*table, rows.get(i).get_index());
+            }
+        };
+    };
+
+    if (accessor.is_null(value)) {
+        if (prop.type == PropertyType::Object) {
+            return set_all([column](Table& table, size_t row) { table.nullify_link(column, row); });
+        }
+        return set_all([column](Table& table, size_t row) { table.set_null(column, row); });
+    }
+
+    switch (prop.type & ~PropertyType::Flags) {
+        case PropertyType::Bool: {
+            bool v = accessor.template unbox<bool>(value);
+            return set_all([column, v](Table& table, size_t row) { table.set_bool(column, row, v); });
+        }
+        case PropertyType::Int: {
+            int64_t v = accessor.template unbox<int64_t>(value);
+            return set_all([column, v](Table& table, size_t row) { table.set_int(column, row, v); });
+        }
+        case PropertyType::Float: {
+            float v = accessor.template unbox<float>(value);
+            return set_all([column, v](Table& table, size_t row) { table.set_float(column, row, v); });
+        }
+        case PropertyType::Double: {
+            double v = accessor.template unbox<double>(value);
+            return set_all([column, v](Table& table, size_t row) { table.set_double(column, row, v); });
+        }
+        case PropertyType::String: {
+            StringData unboxed = accessor.template unbox<StringData>(value);
+            auto v = std::make_shared<std::string>(unboxed.data(), unboxed.size());
+            return set_all([column, v](Table& table, size_t row) { table.set_string(column, row, StringData(*v)); });
+        }
+        case PropertyType::Data: {
+            BinaryData unboxed = accessor.template unbox<BinaryData>(value);
+            auto v = std::make_shared<std::string>(unboxed.data(), unboxed.size());
+            return set_all([column, v](Table& table, size_t row) { table.set_binary(column, row, BinaryData(v->data(), v->size())); });
+        }
+        case PropertyType::Date: {
+            Timestamp v = accessor.template unbox<Timestamp>(value);
+            return set_all([column, v](Table& table, size_t row) { table.set_timestamp(column, row, v); });
+        }
+        case PropertyType::Object: {
+            // The linked object is found or created when the updates are
+            // written, as creating it is a write of its own.
+            return [=, &accessor, &rows, &prop] {
+                NativeAccessor<T> child_accessor(accessor, prop);
+                size_t target = child_accessor.template unbox<RowExpr>(value, realm::CreatePolicy::UpdateAll).get_index();
+                for (size_t i = 0, count = rows.size(); i < count; ++i) {
+                    table->set_link(column, rows.get(i).get_index(), target);
+                }
+            };
+        }
+        default:
+            throw std::runtime_error(util::format("Cannot update property '%1' of type '%2'", prop.name, string_for_property_type(prop.type)));
     }
 }
 
@@ -429,25 +1025,203 @@ void ResultsClass<T>::index_of(ContextType ctx, ObjectType this_object,
     index_of(ctx, fn, args, return_value);
 }
 
+template<typename T>
+void ResultsClass<T>::slice(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    auto results = get_internal<T, ResultsClass<T>>(this_object);
+    slice(ctx, *results, args, return_value);
+}
+
 template<typename T>
 template<typename U>
-void ResultsClass<T>::add_listener(ContextType ctx, U& collection, ObjectType this_object, Arguments &args) {
+void ResultsClass<T>::slice(ContextType ctx, U& collection, Arguments &args, ReturnValue &return_value) {
+    args.validate_maximum(3);
+
+    // Follows Array.prototype.slice: negative indices count from the end and both ends are clamped.
+    size_t size = collection.size();
+    auto relative_index = [&](size_t arg, size_t fallback) -> size_t {
+        if (args.count <= arg || Value::is_undefined(ctx, args[arg])) {
+            return fallback;
+        }
+        double index = std::trunc(Value::validated_to_number(ctx, args[arg], arg == 0 ? "start" : "end"));
+        if (std::isnan(index)) {
+            return 0;
+        }
+        if (index < 0) {
+            return index + size > 0 ? size_t(index + size) : 0;
+        }
+        return index < size ? size_t(index) : size;
+    };
+    size_t start = relative_index(0, 0);
+    size_t end = relative_index(1, size);
+
+    // An empty projection gives empty plain objects, like any other projection.
+    bool project = false;
+    std::vector<const Property*> projection;
+    std::vector<String> projection_keys;
+    if (args.count == 3 && !Value::is_undefined(ctx, args[2])) {
+        static const String properties_string = "properties";
+
+        ObjectType options = Value::validated_to_object(ctx, args[2], "options");
+        ValueType properties_value = Object::get_property(ctx, options, properties_string);
+        if (!Value::is_undefined(ctx, properties_value)) {
+            if (collection.get_type() != realm::PropertyType::Object) {
+                throw std::runtime_error("Property projection is only supported for collections of objects.");
+            }
+
+            auto const &object_schema = collection.get_object_schema();
+            ObjectType properties = Value::validated_to_array(ctx, properties_value, "properties");
+            project = true;
+            size_t count = Object::validated_get_length(ctx, properties);
+            projection.reserve(count);
+            projection_keys.reserve(count);
+            for (size_t i = 0; i < count; i++) {
+                std::string name = Object::validated_get_string(ctx, properties, (uint32_t)i);
+                const Property* prop = object_schema.property_for_public_name(name);
+                if (!prop) {
+                    throw std::invalid_argument(util::format("Property '%1' does not exist on object '%2'", name, object_schema.name));
+                }
+                projection.push_back(prop);
+                projection_keys.push_back(String::intern(name));
+            }
+        }
+    }
+
+    NativeAccessor<T> accessor(ctx, collection);
+    std::vector<ValueType> values;
+    values.reserve(end > start ? end - start : 0);
+    for (size_t i = start; i < end; i++) {
+        if (!project) {
+            values.push_back(collection.get(accessor, i));
+            continue;
+        }
+
+        auto row = collection.get(i);
+        if (!row.is_attached()) {
+            values.push_back(Value::from_null(ctx));
+            continue;
+        }
+
+        realm::Object realm_object(collection.get_realm(), collection.get_object_schema(), row);
+        ObjectType plain_object = Object::create_empty(ctx);
+        for (size_t j = 0; j < projection.size(); j++) {
+            Object::set_property(ctx, plain_object, projection_keys[j],
+                                 realm_object.template get_property_value<ValueType>(accessor, *projection[j]));
+        }
+        values.push_back(plain_object);
+    }
+
+    return_value.set(Object::create_array(ctx, values));
+}
+
+template<typename T>
+void ResultsClass<T>::to_typed_array(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    auto results = get_internal<T, ResultsClass<T>>(this_object);
+    to_typed_array(ctx, *results, args, return_value);
+}
+
+template<typename T>
+template<typename U>
+void ResultsClass<T>::to_typed_array(ContextType ctx, U& collection, Arguments &args, ReturnValue &return_value) {
     args.validate_maximum(1);
 
+    // Each type defaults to the typed array which holds all of its values.
+    auto type = collection.get_type() & ~realm::PropertyType::Flags;
+    TypedArrayType array_type;
+    std::vector<double> numbers;
+    switch (type) {
+        case realm::PropertyType::Bool:
+            array_type = TypedArrayType::Uint8;
+            read_numbers<bool>(collection, numbers);
+            break;
+        case realm::PropertyType::Int:
+            array_type = TypedArrayType::Float64;
+            read_numbers<int64_t>(collection, numbers);
+            break;
+        case realm::PropertyType::Float:
+            array_type = TypedArrayType::Float32;
+            read_numbers<float>(collection, numbers);
+            break;
+        case realm::PropertyType::Double:
+            array_type = TypedArrayType::Float64;
+            read_numbers<double>(collection, numbers);
+            break;
+        default:
+            throw std::invalid_argument(util::format("A collection of '%1' can't be copied into a typed array.", string_for_property_type(type)));
+    }
+    if (args.count == 1 && !Value::is_undefined(ctx, args[0])) {
+        array_type = typed_array_type_for_name(Value::validated_to_string(ctx, args[0], "type"));
+    }
+
+    std::vector<char> bytes = encode_typed_array(array_type, numbers);
+    return_value.set(Object::create_typed_array(ctx, array_type, BinaryData(bytes.data(), bytes.size())));
+}
+
+// Nulls are read as NaN, which only floating point typed arrays can hold.
+template<typename T>
+template<typename Number, typename U>
+void ResultsClass<T>::read_numbers(U& collection, std::vector<double> &numbers) {
+    size_t size = collection.size();
+    numbers.reserve(size);
+    if (is_nullable(collection.get_type())) {
+        for (size_t i = 0; i < size; ++i) {
+            auto value = collection.template get<util::Optional<Number>>(i);
+            numbers.push_back(value ? double(*value) : std::numeric_limits<double>::quiet_NaN());
+        }
+    }
+    else {
+        for (size_t i = 0; i < size; ++i) {
+            numbers.push_back(double(collection.template get<Number>(i)));
+        }
+    }
+}
+
+template<typename T>
+template<typename U>
+void ResultsClass<T>::add_listener(ContextType ctx, U& collection, ObjectType this_object, Arguments &args) {
+    args.validate_maximum(2);
+
     auto callback = Value::validated_to_function(ctx, args[0]);
+    auto format = ChangeSetFormat::Array;
+    std::shared_ptr<KeyPathFilter> filter;
+    if (args.count == 2 && !Value::is_undefined(ctx, args[1])) {
+        static const String change_set_format_string = "changeSetFormat";
+        ObjectType options = Value::validated_to_object(ctx, args[1], "options");
+        validate_unthrottled_listener<T>(ctx, options);
+        format = CollectionClass<T>::validated_change_set_format(ctx, Object::get_property(ctx, options, change_set_format_string));
+
+        if (auto key_paths = validated_key_paths<T>(ctx, options)) {
+            if (collection.get_type() != realm::PropertyType::Object) {
+                throw std::invalid_argument("Key paths can only be given for collections of objects.");
+            }
+            filter = std::make_shared<KeyPathFilter>(collection.get_realm()->schema(), collection.get_object_schema(), *key_paths);
+        }
+    }
+
     Protected<FunctionType> protected_callback(ctx, callback);
     Protected<ObjectType> protected_this(ctx, this_object);
     Protected<typename T::GlobalContext> protected_ctx(Context<T>::get_global_context(ctx));
 
+    // The token is owned by the collection, so the callback never outlives it.
+    U* observed = &collection;
     auto token = collection.add_notification_callback([=](CollectionChangeSet const& change_set, std::exception_ptr exception) {
+            util::Optional<CollectionChangeSet> filtered;
+            if (filter) {
+                filtered = change_set;
+                if (!filter->filter_collection_changes(*observed, *filtered)) {
+                    return;
+                }
+            }
+
+            TraceScope trace("notification", "collection listener");
             HANDLESCOPE
             ValueType arguments[] {
                 static_cast<ObjectType>(protected_this),
-                CollectionClass<T>::create_collection_change_set(protected_ctx, change_set)
+                CollectionClass<T>::create_collection_change_set(protected_ctx, filtered ? *filtered : change_set, format)
             };
             Function<T>::callback(protected_ctx, protected_callback, protected_this, 2, arguments);
         });
     collection.m_notification_tokens.emplace_back(protected_callback, std::move(token));
+    collection.listeners_changed();
 }
 
 template<typename T>
@@ -456,6 +1230,105 @@ void ResultsClass<T>::add_listener(ContextType ctx, ObjectType this_object, Argu
     add_listener(ctx, *results, this_object, args);
 }
 
+template<typename T>
+template<typename U>
+void ResultsClass<T>::observe_aggregate(ContextType ctx, U& collection, ObjectType this_object, Arguments &args) {
+    args.validate_count(3);
+
+    static const std::map<std::string, AggregateFunc> functions = {
+        {"min", AggregateFunc::Min},
+        {"max", AggregateFunc::Max},
+        {"sum", AggregateFunc::Sum},
+        {"avg", AggregateFunc::Avg},
+    };
+    std::string function_name = Value::validated_to_string(ctx, args[0], "aggregate");
+    auto function = functions.find(function_name);
+    if (function == functions.end()) {
+        throw std::invalid_argument(util::format("Unknown aggregate '%1'. Expected 'min', 'max', 'sum' or 'avg'.", function_name));
+    }
+
+    if (collection.get_type() != realm::PropertyType::Object) {
+        throw std::invalid_argument("Aggregates can only be observed on collections of objects.");
+    }
+    const ObjectSchema& object_schema = collection.get_object_schema();
+    std::string property_name = Value::validated_to_string(ctx, args[1], "property");
+    const Property* property = object_schema.property_for_name(property_name);
+    if (!property) {
+        throw std::invalid_argument(util::format("Property '%1' does not exist on object '%2'",
+                                                 property_name, object_schema.name));
+    }
+    auto type = property->type & ~realm::PropertyType::Flags;
+    if (is_array(property->type) || (type != realm::PropertyType::Int && type != realm::PropertyType::Float && type != realm::PropertyType::Double)) {
+        throw std::invalid_argument(util::format("Property '%1' must be of type 'int', 'float' or 'double' to observe an aggregate of it.",
+                                                 property_name));
+    }
+
+    auto callback = Value::validated_to_function(ctx, args[2]);
+    Protected<FunctionType> protected_callback(ctx, callback);
+    Protected<ObjectType> protected_this(ctx, this_object);
+    Protected<typename T::GlobalContext> protected_ctx(Context<T>::get_global_context(ctx));
+
+    U* observed = &collection;
+    size_t column = property->table_column;
+    LiveAggregate::Reader read = [=](size_t index) -> LiveAggregate::Value {
+        auto row = observed->get(index);
+        if (row.is_null(column)) {
+            return util::none;
+        }
+        switch (type) {
+            case realm::PropertyType::Float:
+                return double(row.get_float(column));
+            case realm::PropertyType::Double:
+                return row.get_double(column);
+            default:
+                return double(row.get_int(column));
+        }
+    };
+
+    auto aggregate = std::make_shared<LiveAggregate>(function->second);
+    auto token = collection.add_notification_callback([=](CollectionChangeSet const& change_set, std::exception_ptr exception) {
+            if (exception) {
+                return;
+            }
+
+            bool initial = !aggregate->is_initialized();
+            auto previous = aggregate->value();
+            bool rescanned = true;
+            if (initial) {
+                aggregate->reset(observed->size(), read);
+            }
+            else {
+                rescanned = aggregate->apply(change_set, observed->size(), read);
+            }
+            auto value = aggregate->value();
+            if (!initial && value == previous) {
+                return;
+            }
+
+            HANDLESCOPE
+            auto to_value = [&](LiveAggregate::Value const& aggregate_value) {
+                return aggregate_value ? Value::from_number(protected_ctx, *aggregate_value) : Value::from_undefined(protected_ctx);
+            };
+            ObjectType details = Object::create_empty(protected_ctx);
+            Object::set_property(protected_ctx, details, "previousValue", to_value(initial ? LiveAggregate::Value() : previous));
+            Object::set_property(protected_ctx, details, "insertions", Value::from_number(protected_ctx, double(change_set.insertions.count())));
+            Object::set_property(protected_ctx, details, "deletions", Value::from_number(protected_ctx, double(change_set.deletions.count())));
+            Object::set_property(protected_ctx, details, "modifications", Value::from_number(protected_ctx, double(change_set.modifications_new.count())));
+            Object::set_property(protected_ctx, details, "rescanned", Value::from_boolean(protected_ctx, rescanned));
+
+            ValueType arguments[] {to_value(value), details};
+            Function<T>::callback(protected_ctx, protected_callback, protected_this, 2, arguments);
+        });
+    collection.m_notification_tokens.emplace_back(protected_callback, std::move(token));
+    collection.listeners_changed();
+}
+
+template<typename T>
+void ResultsClass<T>::observe_aggregate(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    auto results = get_internal<T, ResultsClass<T>>(this_object);
+    observe_aggregate(ctx, *results, this_object, args);
+}
+
 template<typename T>
 template<typename U>
 void ResultsClass<T>::remove_listener(ContextType ctx, U& collection, ObjectType this_object, Arguments &args) {
@@ -469,6 +1342,7 @@ void ResultsClass<T>::remove_listener(ContextType ctx, U& collection, ObjectType
         return typename Protected<FunctionType>::Comparator()(token.first, protected_function);
     };
     tokens.erase(std::remove_if(tokens.begin(), tokens.end(), compare), tokens.end());
+    collection.listeners_changed();
 }
 
 template<typename T>
@@ -477,12 +1351,443 @@ void ResultsClass<T>::remove_listener(ContextType ctx, ObjectType this_object, A
     remove_listener(ctx, *results, this_object, args);
 }
 
+// Calls back once the results have been evaluated on the notification
+// thread. The evaluated table view is handed over with the notification, so
+// reading the results at that version needs no further evaluation.
+template<typename T>
+void ResultsClass<T>::evaluate_async(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    args.validate_count(1);
+
+    auto callback = Value::validated_to_function(ctx, args[0]);
+    auto results = get_internal<T, ResultsClass<T>>(this_object);
+    auto realm = results->get_realm();
+
+    // A closed Realm or an invalidated collection never delivers the
+    // notification the evaluation waits for.
+    const char* invalid_message = nullptr;
+    if (realm->is_closed()) {
+        invalid_message = "Cannot evaluate a collection of a closed Realm.";
+    }
+    else if (!results->is_valid()) {
+        invalid_message = "Cannot evaluate a collection which is no longer valid.";
+    }
+    if (invalid_message) {
+        ValueType arguments[] {this_object, Value::from_string(ctx, invalid_message)};
+        Function<T>::callback(ctx, callback, this_object, 2, arguments);
+        return;
+    }
+
+    // Asynchronous queries cannot be created inside write transactions, and
+    // the results would not be frozen at a version there either.
+    if (realm->is_in_transaction()) {
+        ValueType arguments[] {this_object, Value::from_null(ctx)};
+        Function<T>::callback(ctx, callback, this_object, 2, arguments);
+        return;
+    }
+
+    Protected<FunctionType> protected_callback(ctx, callback);
+    Protected<ObjectType> protected_this(ctx, this_object);
+    Protected<typename T::GlobalContext> protected_ctx(Context<T>::get_global_context(ctx));
+
+    // Only the first notification, or the Realm being closed, is wanted.
+    // Whichever comes first removes the token and calls the callback.
+    auto settled = std::make_shared<bool>(false);
+    auto finish = [=](util::Optional<std::string> error_message) {
+        if (*settled) {
+            return;
+        }
+        *settled = true;
+
+        HANDLESCOPE
+        Protected<FunctionType> function = protected_callback;
+        Protected<ObjectType> object = protected_this;
+        if (auto evaluated = get_internal<T, ResultsClass<T>>(object)) {
+            auto& tokens = evaluated->m_notification_tokens;
+            tokens.erase(std::remove_if(tokens.begin(), tokens.end(), [&](auto&& token) {
+                return typename Protected<FunctionType>::Comparator()(token.first, function);
+            }), tokens.end());
+            evaluated->listeners_changed();
+        }
+
+        ValueType error = error_message ? Value::from_string(protected_ctx, *error_message) : Value::from_null(protected_ctx);
+        ValueType arguments[] {static_cast<ObjectType>(object), error};
+        Function<T>::callback(protected_ctx, function, object, 2, arguments);
+    };
+
+    auto on_close = std::make_shared<std::function<void()>>([=] {
+        finish(std::string("The Realm was closed before the collection was evaluated."));
+    });
+    if (auto delegate = get_delegate<T>(realm.get())) {
+        delegate->add_close_callback(on_close);
+    }
+    auto on_removed = std::make_shared<std::function<void()>>([=] {
+        finish(std::string("The listeners of the collection were removed before it was evaluated."));
+    });
+    auto& pending = results->m_pending_evaluations;
+    pending.erase(std::remove_if(pending.begin(), pending.end(), [](auto& evaluation) {
+        return evaluation.expired();
+    }), pending.end());
+    pending.push_back(on_removed);
+
+    auto token = results->add_notification_callback([=](CollectionChangeSet const&, std::exception_ptr exception) {
+            // Keep the callback on the stack as removing the token releases
+            // this lambda.
+            auto settle = finish;
+            std::shared_ptr<std::function<void()>> keep_alive = on_close;
+            std::shared_ptr<std::function<void()>> keep_removed = on_removed;
+
+            util::Optional<std::string> error_message;
+            if (exception) {
+                try {
+                    std::rethrow_exception(exception);
+                }
+                catch (std::exception const& e) {
+                    error_message = std::string(e.what());
+                }
+            }
+            else {
+                auto evaluated = get_internal<T, ResultsClass<T>>(protected_this);
+                if (!evaluated || !evaluated->is_valid()) {
+                    error_message = std::string("The collection was invalidated before it was evaluated.");
+                }
+            }
+            settle(std::move(error_message));
+        });
+    results->m_notification_tokens.emplace_back(protected_callback, std::move(token));
+    results->listeners_changed();
+}
+
 template<typename T>
 void ResultsClass<T>::remove_all_listeners(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
     args.validate_maximum(0);
 
     auto results = get_internal<T, ResultsClass<T>>(this_object);
+
+    // The tokens hold the only references to the pending evaluations.
+    std::vector<std::shared_ptr<std::function<void()>>> pending;
+    for (auto& weak : results->m_pending_evaluations) {
+        if (auto evaluation = weak.lock()) {
+            pending.push_back(std::move(evaluation));
+        }
+    }
+    results->m_pending_evaluations.clear();
     results->m_notification_tokens.clear();
+    results->listeners_changed();
+
+    for (auto& evaluation : pending) {
+        (*evaluation)();
+    }
+}
+
+template<typename T>
+class PreparedQueryClass : public ClassDefinition<T, PreparedQuery> {
+    using ContextType = typename T::Context;
+    using FunctionType = typename T::Function;
+    using ObjectType = typename T::Object;
+    using Value = js::Value<T>;
+    using ReturnValue = js::ReturnValue<T>;
+    using Arguments = js::Arguments<T>;
+
+public:
+    std::string const name = "PreparedQuery";
+
+    static FunctionType create_constructor(ContextType);
+    static ObjectType create_instance(ContextType, SharedRealm, const std::string &object_type, const std::string &query_string);
+
+    static void run(ContextType, ObjectType, Arguments &, ReturnValue &);
+
+    MethodMap<T> const methods = {
+        {"run", wrap<run>},
+    };
+};
+
+template<typename T>
+typename T::Function PreparedQueryClass<T>::create_constructor(ContextType ctx) {
+    return ObjectWrap<T, PreparedQueryClass<T>>::create_constructor(ctx);
+}
+
+template<typename T>
+typename T::Object PreparedQueryClass<T>::create_instance(ContextType ctx, SharedRealm realm, const std::string &object_type,
+                                                          const std::string &query_string) {
+    auto parsed = ResultsClass<T>::parse_query(query_string);
+    return create_object<T, PreparedQueryClass<T>>(ctx, new PreparedQuery{std::move(realm), object_type, std::move(parsed)});
+}
+
+template<typename T>
+void PreparedQueryClass<T>::run(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    auto& prepared = *get_internal<T, PreparedQueryClass<T>>(this_object);
+    auto table = ObjectStore::table_for_object_type(prepared.realm->read_group(), prepared.object_type);
+    if (!table) {
+        throw std::runtime_error("Table does not exist. Object type: " + prepared.object_type);
+    }
+    realm::Results results(prepared.realm, *table);
+    return_value.set(ResultsClass<T>::create_filtered(ctx, results, *prepared.parsed, args.value, args.count));
+}
+
+template<typename T>
+class ResultsCursorClass : public ClassDefinition<T, ResultsCursorState> {
+    using ContextType = typename T::Context;
+    using FunctionType = typename T::Function;
+    using ObjectType = typename T::Object;
+    using ValueType = typename T::Value;
+    using Object = js::Object<T>;
+    using Value = js::Value<T>;
+    using ReturnValue = js::ReturnValue<T>;
+    using Arguments = js::Arguments<T>;
+
+public:
+    std::string const name = "ResultsCursor";
+
+    static constexpr size_t default_page_size = 100;
+
+    static FunctionType create_constructor(ContextType);
+    static ObjectType create_instance(ContextType, realm::Results, ValueType options);
+
+    static void next(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void get_done(ContextType, ObjectType, ReturnValue &);
+
+    MethodMap<T> const methods = {
+        {"next", wrap<next>},
+    };
+
+    PropertyMap<T> const properties = {
+        {"done", {wrap<get_done>, nullptr}},
+    };
+};
+
+template<typename T>
+typename T::Function ResultsCursorClass<T>::create_constructor(ContextType ctx) {
+    return ObjectWrap<T, ResultsCursorClass<T>>::create_constructor(ctx);
+}
+
+template<typename T>
+typename T::Object ResultsCursorClass<T>::create_instance(ContextType ctx, realm::Results results, ValueType options) {
+    static const String after_string = "after";
+    static const String page_size_string = "pageSize";
+    static const String sort_by_string = "sortBy";
+
+    if (results.get_type() != realm::PropertyType::Object) {
+        throw std::invalid_argument("Cursors can only page through collections of objects.");
+    }
+    auto const &object_schema = results.get_object_schema();
+    auto table = ObjectStore::table_for_object_type(results.get_realm()->read_group(), object_schema.name);
+
+    size_t page_size = default_page_size;
+    std::vector<std::pair<std::string, bool>> sort_by;
+    ValueType after = Value::from_undefined(ctx);
+    if (!Value::is_undefined(ctx, options)) {
+        ObjectType options_object = Value::validated_to_object(ctx, options, "options");
+
+        ValueType page_size_value = Object::get_property(ctx, options_object, page_size_string);
+        if (!Value::is_undefined(ctx, page_size_value)) {
+            double value = Value::validated_to_number(ctx, page_size_value, "pageSize");
+            if (!(value >= 1) || value != std::trunc(value)) {
+                throw std::invalid_argument("'pageSize' must be a positive integer.");
+            }
+            page_size = size_t(value);
+        }
+
+        ValueType sort_by_value = Object::get_property(ctx, options_object, sort_by_string);
+        if (Value::is_array(ctx, sort_by_value)) {
+            ObjectType sort_by_array = Value::to_array(ctx, sort_by_value);
+            uint32_t count = Object::validated_get_length(ctx, sort_by_array);
+            for (uint32_t i = 0; i < count; i++) {
+                ValueType value = Object::validated_get_property(ctx, sort_by_array, i);
+                if (Value::is_array(ctx, value)) {
+                    ObjectType pair = Value::to_array(ctx, value);
+                    sort_by.emplace_back(Object::validated_get_string(ctx, pair, 0),
+                                         !Object::validated_get_boolean(ctx, pair, 1));
+                }
+                else {
+                    sort_by.emplace_back(Value::validated_to_string(ctx, value, "sortBy"), true);
+                }
+            }
+        }
+        else if (!Value::is_undefined(ctx, sort_by_value)) {
+            sort_by.emplace_back(Value::validated_to_string(ctx, sort_by_value, "sortBy"), true);
+        }
+
+        after = Object::get_property(ctx, options_object, after_string);
+    }
+
+    // Objects with the same values are told apart by their primary key, as
+    // their order in the table changes when objects are deleted.
+    const Property* primary_key = object_schema.primary_key_property();
+    if (!primary_key) {
+        throw std::invalid_argument(util::format("Cursors can only page through objects with a primary key, which '%1' does not have.",
+                                                 object_schema.name));
+    }
+
+    std::vector<ResultsCursor::SortColumn> columns;
+    bool unique = false;
+    for (auto const& entry : sort_by) {
+        const Property* property = object_schema.property_for_public_name(entry.first);
+        if (!property) {
+            throw std::invalid_argument(util::format("Property '%1' does not exist on object '%2'", entry.first, object_schema.name));
+        }
+        DataType type = table->get_column_type(property->table_column);
+        if (is_array(property->type) || (type != type_Int && type != type_Bool && type != type_Float && type != type_Double
+                                         && type != type_String && type != type_Timestamp)) {
+            throw std::invalid_argument(util::format("Cannot page through objects by property '%1', as it is not a boolean, number, string or date.",
+                                                     entry.first));
+        }
+        columns.push_back({property->table_column, type, entry.second});
+        unique = unique || property == primary_key;
+    }
+    if (!unique) {
+        columns.push_back({primary_key->table_column, table->get_column_type(primary_key->table_column), true});
+    }
+
+    ResultsCursor cursor(std::move(columns), page_size);
+    if (!Value::is_undefined(ctx, after) && !Value::is_null(ctx, after)) {
+        ObjectType after_object = Value::validated_to_object(ctx, after, "after");
+        if (!Object::template is_instance<RealmObjectClass<T>>(ctx, after_object)) {
+            throw std::invalid_argument("'after' must be a Realm object.");
+        }
+        auto realm_object = get_internal<T, RealmObjectClass<T>>(after_object);
+        if (!realm_object->is_valid() || realm_object->row().get_table() != table.get()) {
+            throw std::invalid_argument(util::format("'after' must be a valid object of type '%1'.", object_schema.name));
+        }
+        cursor.start_after(*table, realm_object->row().get_index());
+    }
+    return create_object<T, ResultsCursorClass<T>>(ctx, new ResultsCursorState{std::move(results), std::move(cursor)});
+}
+
+template<typename T>
+void ResultsCursorClass<T>::next(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    args.validate_maximum(0);
+
+    auto& state = *get_internal<T, ResultsCursorClass<T>>(this_object);
+    if (!state.results.is_valid()) {
+        throw std::runtime_error("Cannot page through a collection which is no longer valid.");
+    }
+
+    auto query = state.results.get_query();
+    auto rows = state.cursor.next_page(query);
+    auto const &realm = state.results.get_realm();
+    auto const &object_schema = state.results.get_object_schema();
+    std::vector<ValueType> objects;
+    objects.reserve(rows.size());
+    for (size_t row : rows) {
+        objects.push_back(RealmObjectClass<T>::create_instance(ctx, realm::Object(realm, object_schema, query.get_table()->get(row))));
+    }
+    return_value.set(Object::create_array(ctx, objects));
+}
+
+template<typename T>
+void ResultsCursorClass<T>::get_done(ContextType, ObjectType this_object, ReturnValue &return_value) {
+    return_value.set(get_internal<T, ResultsCursorClass<T>>(this_object)->cursor.done());
+}
+
+// Reads the elements of a snapshot of a collection a chunk at a time, so that
+// iterating over it crosses into the binding once per chunk rather than once
+// per element, and only checks the collection once per chunk.
+template<typename T>
+class CollectionIteratorClass : public ClassDefinition<T, CollectionIteratorState<T>> {
+    using ContextType = typename T::Context;
+    using FunctionType = typename T::Function;
+    using ObjectType = typename T::Object;
+    using ValueType = typename T::Value;
+    using Object = js::Object<T>;
+    using Value = js::Value<T>;
+    using ReturnValue = js::ReturnValue<T>;
+    using Arguments = js::Arguments<T>;
+
+public:
+    std::string const name = "CollectionIterator";
+
+    static constexpr size_t default_chunk_size = 64;
+
+    static FunctionType create_constructor(ContextType);
+    static ObjectType create_instance(ContextType, realm::Results, ValueType options);
+
+    static void next(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void get_done(ContextType, ObjectType, ReturnValue &);
+
+    MethodMap<T> const methods = {
+        {"next", wrap<next>},
+    };
+
+    PropertyMap<T> const properties = {
+        {"done", {wrap<get_done>, nullptr}},
+    };
+};
+
+template<typename T>
+typename T::Function CollectionIteratorClass<T>::create_constructor(ContextType ctx) {
+    return ObjectWrap<T, CollectionIteratorClass<T>>::create_constructor(ctx);
+}
+
+template<typename T>
+typename T::Object CollectionIteratorClass<T>::create_instance(ContextType ctx, realm::Results results, ValueType options) {
+    static const String chunk_size_string = "chunkSize";
+    static const String plain_string = "plain";
+
+    size_t chunk_size = default_chunk_size;
+    util::Optional<typename PlainObjectBuilder<T>::Options> plain;
+    if (!Value::is_undefined(ctx, options)) {
+        ObjectType options_object = Value::validated_to_object(ctx, options, "options");
+
+        ValueType chunk_size_value = Object::get_property(ctx, options_object, chunk_size_string);
+        if (!Value::is_undefined(ctx, chunk_size_value)) {
+            double value = Value::validated_to_number(ctx, chunk_size_value, "chunkSize");
+            if (!(value >= 1) || value != std::trunc(value)) {
+                throw std::invalid_argument("'chunkSize' must be a positive integer.");
+            }
+            chunk_size = size_t(value);
+        }
+
+        ValueType plain_value = Object::get_property(ctx, options_object, plain_string);
+        if (Value::is_boolean(ctx, plain_value)) {
+            if (Value::to_boolean(ctx, plain_value)) {
+                plain = typename PlainObjectBuilder<T>::Options();
+            }
+        }
+        else if (!Value::is_undefined(ctx, plain_value)) {
+            plain = PlainObjectBuilder<T>::validated_options(ctx, plain_value);
+        }
+        if (plain) {
+            PlainObjectBuilder<T>::validate_collection(results, *plain);
+        }
+    }
+
+    // The snapshot pins the elements the iteration started with, which are
+    // then read without evaluating the collection again.
+    return create_object<T, CollectionIteratorClass<T>>(ctx, new CollectionIteratorState<T>{results.snapshot(), chunk_size, std::move(plain)});
+}
+
+template<typename T>
+void CollectionIteratorClass<T>::next(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    args.validate_maximum(0);
+
+    auto& state = *get_internal<T, CollectionIteratorClass<T>>(this_object);
+    if (!state.results.is_valid()) {
+        throw std::runtime_error("Cannot iterate over a collection which is no longer valid.");
+    }
+
+    size_t size = state.results.size();
+    size_t end = std::min(size, state.index + state.chunk_size);
+    std::vector<ValueType> values;
+    values.reserve(end > state.index ? end - state.index : 0);
+    if (state.plain) {
+        PlainObjectBuilder<T> builder(ctx, state.results.get_realm(), *state.plain);
+        for (; state.index < end; ++state.index) {
+            values.push_back(builder.element(state.results, state.index));
+        }
+    }
+    else {
+        NativeAccessor<T> accessor(ctx, state.results);
+        for (; state.index < end; ++state.index) {
+            values.push_back(state.results.get(accessor, state.index));
+        }
+    }
+    return_value.set(Object::create_array(ctx, values));
+}
+
+template<typename T>
+void CollectionIteratorClass<T>::get_done(ContextType, ObjectType this_object, ReturnValue &return_value) {
+    auto& state = *get_internal<T, CollectionIteratorClass<T>>(this_object);
+    return_value.set(!state.results.is_valid() || state.index >= state.results.size());
 }
 
 } // js
@@ -18,7 +18,9 @@
 
 #pragma once
 
+#include <algorithm>
 #include <map>
+#include <vector>
 
 #include "js_types.hpp"
 #include "schema.hpp"
@@ -44,10 +46,45 @@ struct Schema {
     static Property parse_property(ContextType, ValueType, StringData, std::string, ObjectDefaults &);
     static ObjectSchema parse_object_schema(ContextType, ObjectType, ObjectDefaultsMap &, ConstructorMap &);
     static realm::Schema parse_schema(ContextType, ObjectType, ObjectDefaultsMap &, ConstructorMap &);
+    // Same as parse_schema(), but reuses the result of parsing the same
+    // schema array before when the engine can tell that it's still alive.
+    static realm::Schema parse_schema_cached(ContextType, ObjectType, ObjectDefaultsMap &, ConstructorMap &);
 
     static ObjectType object_for_schema(ContextType, const realm::Schema &);
     static ObjectType object_for_object_schema(ContextType, const ObjectSchema &);
     static ObjectType object_for_property(ContextType, const Property &);
+
+  private:
+    // A parsed schema array. The array is recognised by its identity along
+    // with the identity of each of its elements, so replacing or adding an
+    // object schema is noticed, while changing one in place isn't.
+    struct CachedSchema {
+        Weak<ObjectType> array;
+        std::vector<Weak<ObjectType>> elements;
+        realm::Schema schema;
+        ObjectDefaultsMap defaults;
+        ConstructorMap constructors;
+    };
+    static constexpr size_t max_cached_schemas = 8;
+
+    // The most recently used schema comes first. Schemas belong to the
+    // context, and so to the thread, they were parsed in, and are released
+    // along with it.
+    static std::vector<CachedSchema>& cached_schemas() {
+        static thread_local std::vector<CachedSchema> s_schemas;
+        static thread_local bool s_registered = false;
+        if (!s_registered) {
+            s_registered = true;
+            Context<T>::add_cleanup([] {
+                s_schemas.clear();
+                s_registered = false;
+            });
+        }
+        return s_schemas;
+    }
+
+    static bool is_same_object(ContextType, const ObjectType &, const ObjectType &);
+    static bool matches(ContextType, const CachedSchema &, ObjectType, uint32_t length);
 };
 
 template<typename T>
@@ -322,6 +359,73 @@ realm::Schema Schema<T>::parse_schema(ContextType ctx, ObjectType schema_object,
     return realm::Schema(schema);
 }
 
+template<typename T>
+bool Schema<T>::is_same_object(ContextType ctx, const ObjectType &a, const ObjectType &b) {
+    return typename Protected<ObjectType>::Comparator()(Protected<ObjectType>(ctx, a), Protected<ObjectType>(ctx, b));
+}
+
+template<typename T>
+bool Schema<T>::matches(ContextType ctx, const CachedSchema &cached, ObjectType schema_object, uint32_t length) {
+    ObjectType array;
+    if (!cached.array.get(ctx, array) || !is_same_object(ctx, array, schema_object)) {
+        return false;
+    }
+    if (cached.elements.size() != length) {
+        return false;
+    }
+    for (uint32_t i = 0; i < length; i++) {
+        ObjectType element;
+        if (!cached.elements[i].get(ctx, element) ||
+            !is_same_object(ctx, element, Object::validated_get_object(ctx, schema_object, i, "ObjectSchema"))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<typename T>
+realm::Schema Schema<T>::parse_schema_cached(ContextType ctx, ObjectType schema_object,
+                                             ObjectDefaultsMap &defaults, ConstructorMap &constructors) {
+    if (!Weak<ObjectType>::supported) {
+        return parse_schema(ctx, schema_object, defaults, constructors);
+    }
+
+    auto& schemas = cached_schemas();
+    uint32_t length = Object::validated_get_length(ctx, schema_object);
+    for (auto it = schemas.begin(); it != schemas.end(); ++it) {
+        if (matches(ctx, *it, schema_object, length)) {
+            std::rotate(schemas.begin(), it, it + 1);
+            defaults = schemas.front().defaults;
+            constructors = schemas.front().constructors;
+            return schemas.front().schema;
+        }
+    }
+
+    ObjectDefaultsMap parsed_defaults;
+    ConstructorMap parsed_constructors;
+    realm::Schema schema = parse_schema(ctx, schema_object, parsed_defaults, parsed_constructors);
+
+    CachedSchema cached{Weak<ObjectType>(ctx, schema_object), {}, schema, parsed_defaults, parsed_constructors};
+    cached.elements.reserve(length);
+    for (uint32_t i = 0; i < length; i++) {
+        cached.elements.emplace_back(ctx, Object::validated_get_object(ctx, schema_object, i, "ObjectSchema"));
+    }
+
+    // Entries for arrays which have been collected are dropped along with the oldest ones.
+    schemas.erase(std::remove_if(schemas.begin(), schemas.end(), [&](auto const& entry) {
+        ObjectType array;
+        return !entry.array.get(ctx, array);
+    }), schemas.end());
+    if (schemas.size() >= max_cached_schemas) {
+        schemas.pop_back();
+    }
+    schemas.insert(schemas.begin(), std::move(cached));
+
+    defaults = std::move(parsed_defaults);
+    constructors = std::move(parsed_constructors);
+    return schema;
+}
+
 template<typename T>
 typename T::Object Schema<T>::object_for_schema(ContextType ctx, const realm::Schema &schema) {
     ObjectType object = Object::create_array(ctx);
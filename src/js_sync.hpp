@@ -21,6 +21,10 @@
 #include "js_class.hpp"
 #include "js_collection.hpp"
 #include "platform.hpp"
+#include "progress_throttle.hpp"
+#include "ssl_verification_cache.hpp"
+#include "sync_stats.hpp"
+#include "trace_events.hpp"
 #include "sync/partial_sync.hpp"
 #include "sync/sync_config.hpp"
 #include "sync/sync_manager.hpp"
@@ -95,12 +99,14 @@ public:
     static void constructor(ContextType, ObjectType, Arguments &);
 
     static void current(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void current_chunks(ContextType, ObjectType, Arguments &, ReturnValue &);
     static void advance(ContextType, ObjectType, Arguments &, ReturnValue &);
     static void realm_at_path(ContextType, ObjectType, Arguments &, ReturnValue &);
     static void close(ContextType, ObjectType, Arguments &, ReturnValue &);
 
     MethodMap<T> const methods = {
         {"current", wrap<current>},
+        {"_currentChunks", wrap<current_chunks>},
         {"advance", wrap<advance>},
         {"realmAtPath", wrap<realm_at_path>},
         {"close", wrap<close>},
@@ -161,10 +167,14 @@ public:
 
     static void logout(ContextType, ObjectType, Arguments &, ReturnValue &);
     static void session_for_on_disk_path(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void add_progress_notification(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void remove_progress_notification(ContextType, ObjectType, Arguments &, ReturnValue &);
 
     MethodMap<T> const methods = {
         {"_logout", wrap<logout>},
-        {"_sessionForOnDiskPath", wrap<session_for_on_disk_path>}
+        {"_sessionForOnDiskPath", wrap<session_for_on_disk_path>},
+        {"addProgressNotification", wrap<add_progress_notification>},
+        {"removeProgressNotification", wrap<remove_progress_notification>},
     };
 };
 
@@ -292,6 +302,13 @@ public:
     static void wait_for_download_completion(ContextType, ObjectType, Arguments &, ReturnValue &);
     static void wait_for_upload_completion(ContextType, ObjectType, Arguments &, ReturnValue &);
 
+    // Shared with User.addProgressNotification(), which registers one
+    // handler per session.
+    static void validate_progress_arguments(ContextType, Arguments &, SyncSession::NotifierType &, bool &is_streaming);
+    static std::shared_ptr<ProgressThrottle> validated_progress_throttle(ContextType, ValueType options, size_t sources);
+    static std::function<ProgressHandler> create_progress_handler(ContextType, FunctionType callback,
+                                                                  std::shared_ptr<ProgressThrottle>, size_t source);
+
 
     PropertyMap<T> const properties = {
         {"config", {wrap<get_config>, nullptr}},
@@ -373,15 +390,20 @@ private:
 // An object of type SSLVerifyCallbackSyncThreadFunctor is registered with the sync client in order
 // to verify SSL certificates. The SSLVerifyCallbackSyncThreadFunctor object's operator() is called
 // on the sync client's event loop thread.
+// If a cache duration is given, the answers of the callback are remembered for that long,
+// for every session which uses the same callback function.
 template <typename T>
 class SSLVerifyCallbackSyncThreadFunctor {
 public:
-    SSLVerifyCallbackSyncThreadFunctor(typename T::Context ctx, typename T::Function ssl_verify_func)
+    SSLVerifyCallbackSyncThreadFunctor(typename T::Context ctx, typename T::Function ssl_verify_func,
+                                       SSLVerificationCache::Clock::duration cache_duration = {}, uint64_t callback_id = 0)
     : m_ctx(Context<T>::get_global_context(ctx))
     , m_func(ctx, ssl_verify_func)
     , m_event_loop_dispatcher {SSLVerifyCallbackSyncThreadFunctor<T>::main_loop_handler}
     , m_mutex{new std::mutex}
     , m_cond_var{new std::condition_variable}
+    , m_cache_duration(cache_duration)
+    , m_callback_id(callback_id)
     {
     }
 
@@ -389,6 +411,15 @@ public:
     bool operator ()(const std::string& server_address, sync::Session::port_type server_port, const char* pem_data, size_t pem_size, int preverify_ok, int depth)
     {
         const std::string pem_certificate {pem_data, pem_size};
+        bool use_cache = m_cache_duration > SSLVerificationCache::Clock::duration::zero();
+        SSLVerificationCache::Key cache_key;
+        if (use_cache) {
+            cache_key = {m_callback_id, server_address, uint16_t(server_port), pem_certificate, preverify_ok != 0, depth};
+            bool cached_answer;
+            if (SSLVerificationCache::shared().find(cache_key, cached_answer)) {
+                return cached_answer;
+            }
+        }
         {
             std::lock_guard<std::mutex> lock {*m_mutex};
             m_ssl_certificate_callback_done = false;
@@ -406,6 +437,9 @@ public:
             ssl_certificate_accepted = m_ssl_certificate_accepted;
         }
 
+        if (use_cache) {
+            SSLVerificationCache::shared().insert(std::move(cache_key), ssl_certificate_accepted, m_cache_duration);
+        }
         return ssl_certificate_accepted;
     }
 
@@ -458,6 +492,8 @@ private:
     bool m_ssl_certificate_accepted = false;
     std::shared_ptr<std::mutex> m_mutex;
     std::shared_ptr<std::condition_variable> m_cond_var;
+    SSLVerificationCache::Clock::duration m_cache_duration;
+    uint64_t m_callback_id;
 };
 
 template<typename T>
@@ -471,6 +507,59 @@ void UserClass<T>::session_for_on_disk_path(ContextType ctx, ObjectType this_obj
     }
 }
 
+// The progress of all of the user's sessions which are open now is added up
+// and reported as one. Ticks from the sessions are always coalesced, so that
+// each callback is given the combined progress.
+template<typename T>
+void UserClass<T>::add_progress_notification(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    args.validate_between(3, 4);
+    auto user = *get_internal<T, UserClass<T>>(this_object);
+
+    SyncSession::NotifierType notifier_type;
+    bool is_streaming;
+    SessionClass<T>::validate_progress_arguments(ctx, args, notifier_type, is_streaming);
+    auto callback_function = Value::validated_to_function(ctx, args[2], "callback");
+
+    auto sessions = user->all_sessions();
+    auto throttle = args.count == 4 ? SessionClass<T>::validated_progress_throttle(ctx, args[3], sessions.size()) : nullptr;
+    if (!throttle) {
+        throttle = std::make_shared<ProgressThrottle>(sessions.size(), ProgressThrottle::Clock::duration::zero(), 0);
+    }
+
+    std::vector<ValueType> registrations;
+    for (size_t i = 0; i < sessions.size(); i++) {
+        auto token = sessions[i]->register_progress_notifier(SessionClass<T>::create_progress_handler(ctx, callback_function, throttle, i),
+                                                             notifier_type, is_streaming);
+        std::vector<ValueType> registration = {
+            create_object<T, SessionClass<T>>(ctx, new WeakSession(sessions[i])),
+            Value::from_number(ctx, token),
+        };
+        registrations.push_back(Object::create_array(ctx, registration));
+    }
+    PropertyAttributes attributes = ReadOnly | DontEnum | DontDelete;
+    Object::set_property(ctx, callback_function, "_progressRegistrations", Object::create_array(ctx, registrations), attributes);
+}
+
+template<typename T>
+void UserClass<T>::remove_progress_notification(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    args.validate_count(1);
+    auto callback_function = Value::validated_to_function(ctx, args[0], "callback");
+    auto registrations_value = Object::get_property(ctx, callback_function, "_progressRegistrations");
+    if (Value::is_undefined(ctx, registrations_value) || Value::is_null(ctx, registrations_value)) {
+        return;
+    }
+
+    ObjectType registrations = Value::validated_to_array(ctx, registrations_value);
+    uint32_t length = Object::validated_get_length(ctx, registrations);
+    for (uint32_t i = 0; i < length; i++) {
+        ObjectType registration = Object::validated_get_array(ctx, registrations, i);
+        ObjectType session_object = Object::validated_get_object(ctx, registration, 0);
+        if (auto session = get_internal<T, SessionClass<T>>(session_object)->lock()) {
+            session->unregister_progress_notifier(Object::validated_get_number(ctx, registration, 1));
+        }
+    }
+}
+
 template<typename T>
 void SessionClass<T>::get_config(ContextType ctx, ObjectType object, ReturnValue &return_value) {
     if (auto session = get_internal<T, SessionClass<T>>(object)->lock()) {
@@ -567,6 +656,7 @@ void SessionClass<T>::refresh_access_token(ContextType ctx, ObjectType this_obje
 
     if (auto session = get_internal<T, SessionClass<T>>(this_object)->lock()) {
         std::string sync_label = Value::validated_to_string(ctx, args[2], "syncLabel");
+        SyncStats::shared().set_multiplex_identifier(*session, sync_label);
         session->set_multiplex_identifier(std::move(sync_label));
 
         if (args.count == 4 && !Value::is_undefined(ctx, args[3])) {
@@ -581,58 +671,106 @@ void SessionClass<T>::refresh_access_token(ContextType ctx, ObjectType this_obje
 }
 
 template<typename T>
-void SessionClass<T>::add_progress_notification(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
-    args.validate_count(3);
+void SessionClass<T>::validate_progress_arguments(ContextType ctx, Arguments &args, SyncSession::NotifierType &notifier_type, bool &is_streaming) {
+    std::string direction = Value::validated_to_string(ctx, args[0], "direction");
+    std::string mode = Value::validated_to_string(ctx, args[1], "mode");
+    if (direction == "download") {
+        notifier_type = SyncSession::NotifierType::download;
+    }
+    else if (direction == "upload") {
+        notifier_type = SyncSession::NotifierType::upload;
+    }
+    else {
+        throw std::invalid_argument("Invalid argument 'direction'. Only 'download' and 'upload' progress notification directions are supported");
+    }
 
-    if (auto session = get_internal<T, SessionClass<T>>(this_object)->lock()) {
+    if (mode == "reportIndefinitely") {
+        is_streaming = true;
+    }
+    else if (mode == "forCurrentlyOutstandingWork") {
+        is_streaming = false;
+    }
+    else {
+        throw std::invalid_argument("Invalid argument 'mode'. Only 'reportIndefinitely' and 'forCurrentlyOutstandingWork' progress notification modes are supported");
+    }
+}
 
-        std::string direction = Value::validated_to_string(ctx, args[0], "direction");
-        std::string mode = Value::validated_to_string(ctx, args[1], "mode");
-        SyncSession::NotifierType notifierType;
-        if (direction == "download") {
-            notifierType = SyncSession::NotifierType::download;
-        }
-        else if (direction == "upload") {
-            notifierType = SyncSession::NotifierType::upload;
-        }
-        else {
-            throw std::invalid_argument("Invalid argument 'direction'. Only 'download' and 'upload' progress notification directions are supported");
-        }
+template<typename T>
+std::shared_ptr<ProgressThrottle> SessionClass<T>::validated_progress_throttle(ContextType ctx, ValueType value, size_t sources) {
+    static const String min_interval_string = "minIntervalMs";
+    static const String min_delta_string = "minDeltaBytes";
 
-        bool is_streaming = false;
-        if (mode == "reportIndefinitely") {
-            is_streaming = true;
-        }
-        else if (mode == "forCurrentlyOutstandingWork") {
-            is_streaming = false;
+    if (Value::is_undefined(ctx, value)) {
+        return nullptr;
+    }
+    ObjectType options = Value::validated_to_object(ctx, value, "options");
+    auto validated_minimum = [&](const String &name) {
+        ValueType minimum_value = Object::get_property(ctx, options, name);
+        if (Value::is_undefined(ctx, minimum_value)) {
+            return 0.0;
         }
-        else {
-            throw std::invalid_argument("Invalid argument 'mode'. Only 'reportIndefinitely' and 'forCurrentlyOutstandingWork' progress notification modes are supported");
+        double minimum = Value::validated_to_number(ctx, minimum_value, std::string(name).c_str());
+        if (!(minimum >= 0)) {
+            throw std::invalid_argument(util::format("Invalid option '%1'. It must be a non-negative number.", std::string(name)));
         }
+        return minimum;
+    };
+    auto min_interval = std::chrono::duration<double, std::milli>(validated_minimum(min_interval_string));
+    uint64_t min_delta_bytes = uint64_t(validated_minimum(min_delta_string));
+    return std::make_shared<ProgressThrottle>(sources, std::chrono::duration_cast<ProgressThrottle::Clock::duration>(min_interval),
+                                              min_delta_bytes);
+}
 
-        auto callback_function = Value::validated_to_function(ctx, args[2], "callback");
+template<typename T>
+std::function<typename SessionClass<T>::ProgressHandler> SessionClass<T>::create_progress_handler(ContextType ctx, FunctionType callback,
+                                                                                                  std::shared_ptr<ProgressThrottle> throttle,
+                                                                                                  size_t source) {
+    Protected<FunctionType> protected_callback(ctx, callback);
+    Protected<typename T::GlobalContext> protected_ctx(Context<T>::get_global_context(ctx));
+    auto deliver = [=](uint64_t transferred_bytes, uint64_t transferrable_bytes) {
+        HANDLESCOPE
+        ValueType callback_arguments[2];
+        callback_arguments[0] = Value::from_number(protected_ctx, transferred_bytes);
+        callback_arguments[1] = Value::from_number(protected_ctx, transferrable_bytes);
 
-        Protected<FunctionType> protected_callback(ctx, callback_function);
-        Protected<ObjectType> protected_this(ctx, this_object);
-        Protected<typename T::GlobalContext> protected_ctx(Context<T>::get_global_context(ctx));
-        std::function<ProgressHandler> progressFunc;
+        Function<T>::callback(protected_ctx, protected_callback, typename T::Object(), 2, callback_arguments);
+    };
+    if (!throttle) {
+        return util::EventLoopDispatcher<ProgressHandler>(deliver);
+    }
 
-        util::EventLoopDispatcher<ProgressHandler> progress_handler([=](uint64_t transferred_bytes, uint64_t transferrable_bytes) {
-            HANDLESCOPE
-            ValueType callback_arguments[2];
-            callback_arguments[0] = Value::from_number(protected_ctx, transferred_bytes);
-            callback_arguments[1] = Value::from_number(protected_ctx, transferrable_bytes);
+    // Ticks are recorded on the sync client's thread, and only schedule a
+    // callback on the JS thread when the throttle lets them through.
+    util::EventLoopDispatcher<void()> dispatch_latest([=] {
+        uint64_t transferred_bytes, transferrable_bytes;
+        if (throttle->take(transferred_bytes, transferrable_bytes)) {
+            deliver(transferred_bytes, transferrable_bytes);
+        }
+    });
+    return [=](uint64_t transferred_bytes, uint64_t transferrable_bytes) mutable {
+        if (throttle->update(source, transferred_bytes, transferrable_bytes)) {
+            dispatch_latest();
+        }
+    };
+}
 
-            Function<T>::callback(protected_ctx, protected_callback, typename T::Object(), 2, callback_arguments);
-        });
+template<typename T>
+void SessionClass<T>::add_progress_notification(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
+    args.validate_between(3, 4);
 
-        progressFunc = std::move(progress_handler);
+    if (auto session = get_internal<T, SessionClass<T>>(this_object)->lock()) {
+        SyncSession::NotifierType notifier_type;
+        bool is_streaming;
+        validate_progress_arguments(ctx, args, notifier_type, is_streaming);
+        auto callback_function = Value::validated_to_function(ctx, args[2], "callback");
+        auto throttle = args.count == 4 ? validated_progress_throttle(ctx, args[3], 1) : nullptr;
 
-        auto registrationToken = session->register_progress_notifier(std::move(progressFunc), notifierType, is_streaming);
+        auto registrationToken = session->register_progress_notifier(create_progress_handler(ctx, callback_function, throttle, 0),
+                                                                     notifier_type, is_streaming);
         auto syncSession = create_object<T, SessionClass<T>>(ctx, new WeakSession(session));
         PropertyAttributes attributes = ReadOnly | DontEnum | DontDelete;
         Object::set_property(ctx, callback_function, "_syncSession", syncSession, attributes);
-        Object::set_property(ctx, callback_function, "_registrationToken", Value::from_number(protected_ctx, registrationToken), attributes);
+        Object::set_property(ctx, callback_function, "_registrationToken", Value::from_number(ctx, registrationToken), attributes);
     }
 }
 
@@ -796,16 +934,117 @@ void SessionClass<T>::wait_for_download_completion(ContextType ctx, ObjectType t
     wait_for_completion(Direction::Download, ctx, this_object, args);
 }
 
+// Either a subscription which is being registered by partial_sync::subscribe(),
+// or one whose __ResultSets row has already been written, which is then
+// tracked through that row.
 template<typename T>
-class Subscription : public partial_sync::Subscription {
+class Subscription {
+    using FunctionType = typename T::Function;
+
 public:
-    Subscription(partial_sync::Subscription s, util::Optional<std::string> name) : partial_sync::Subscription(std::move(s)), m_name(name) {}
+    Subscription(partial_sync::Subscription s, util::Optional<std::string> name) : m_subscription(std::move(s)), m_name(name) {}
+    Subscription(Results result_set, util::Optional<std::string> name) : m_result_set(std::move(result_set)), m_name(name) {}
     Subscription(Subscription &&) = default;
 
+    partial_sync::SubscriptionState state() const;
+    std::exception_ptr error() const;
+    void unsubscribe();
+    void add_listener(Protected<FunctionType>, std::function<void()>);
+    void remove_listener(Protected<FunctionType> const&);
+    void remove_all_listeners();
+
     util::Optional<std::string> m_name;
-    std::vector<std::pair<Protected<typename T::Function>, partial_sync::SubscriptionNotificationToken>> m_notification_tokens;
+
+private:
+    util::Optional<partial_sync::Subscription> m_subscription;
+    mutable util::Optional<Results> m_result_set;
+    std::vector<std::pair<Protected<FunctionType>, partial_sync::SubscriptionNotificationToken>> m_notification_tokens;
+    std::vector<std::pair<Protected<FunctionType>, NotificationToken>> m_result_set_tokens;
+
+    Table const& result_sets_table() const {
+        return *m_result_set->get_query().get_table();
+    }
 };
 
+template<typename T>
+partial_sync::SubscriptionState Subscription<T>::state() const {
+    if (m_subscription) {
+        return m_subscription->state();
+    }
+    if (m_result_set->size() == 0) {
+        return partial_sync::SubscriptionState::Invalidated;
+    }
+    size_t status_col = result_sets_table().get_column_index("status");
+    return static_cast<partial_sync::SubscriptionState>(m_result_set->get(0).get_int(status_col));
+}
+
+template<typename T>
+std::exception_ptr Subscription<T>::error() const {
+    if (m_subscription) {
+        return m_subscription->error();
+    }
+    if (state() != partial_sync::SubscriptionState::Error) {
+        return nullptr;
+    }
+    size_t error_col = result_sets_table().get_column_index("error_message");
+    return std::make_exception_ptr(std::runtime_error(std::string(m_result_set->get(0).get_string(error_col))));
+}
+
+template<typename T>
+void Subscription<T>::unsubscribe() {
+    if (m_subscription) {
+        partial_sync::unsubscribe(*m_subscription);
+        return;
+    }
+
+    // Like Realm.unsubscribe(), this removes the row in a write transaction
+    // of its own unless one is already open.
+    auto realm = m_result_set->get_realm();
+    bool commit = !realm->is_in_transaction();
+    if (commit) {
+        realm->begin_transaction();
+    }
+    try {
+        m_result_set->clear();
+        if (commit) {
+            realm->commit_transaction();
+        }
+    }
+    catch (...) {
+        if (commit) {
+            realm->cancel_transaction();
+        }
+        throw;
+    }
+}
+
+template<typename T>
+void Subscription<T>::add_listener(Protected<FunctionType> callback, std::function<void()> notify) {
+    if (m_subscription) {
+        m_notification_tokens.emplace_back(std::move(callback), m_subscription->add_notification_callback(std::move(notify)));
+        return;
+    }
+    auto token = m_result_set->add_notification_callback([=](CollectionChangeSet const&, std::exception_ptr) {
+        notify();
+    });
+    m_result_set_tokens.emplace_back(std::move(callback), std::move(token));
+}
+
+template<typename T>
+void Subscription<T>::remove_listener(Protected<FunctionType> const& callback) {
+    auto compare = [&](auto&& token) {
+        return typename Protected<FunctionType>::Comparator()(token.first, callback);
+    };
+    m_notification_tokens.erase(std::remove_if(m_notification_tokens.begin(), m_notification_tokens.end(), compare), m_notification_tokens.end());
+    m_result_set_tokens.erase(std::remove_if(m_result_set_tokens.begin(), m_result_set_tokens.end(), compare), m_result_set_tokens.end());
+}
+
+template<typename T>
+void Subscription<T>::remove_all_listeners() {
+    m_notification_tokens.clear();
+    m_result_set_tokens.clear();
+}
+
 template<typename T>
 class SubscriptionClass : public ClassDefinition<T, Subscription<T>> {
     using GlobalContextType = typename T::GlobalContext;
@@ -825,6 +1064,7 @@ public:
 
     static FunctionType create_constructor(ContextType);
     static ObjectType create_instance(ContextType, partial_sync::Subscription, util::Optional<std::string>);
+    static ObjectType create_instance(ContextType, Results, util::Optional<std::string>);
 
     static void get_state(ContextType, ObjectType, ReturnValue &);
     static void get_error(ContextType, ObjectType, ReturnValue &);
@@ -854,6 +1094,11 @@ typename T::Object SubscriptionClass<T>::create_instance(ContextType ctx, partia
     return create_object<T, SubscriptionClass<T>>(ctx, new Subscription<T>(std::move(subscription), name));
 }
 
+template<typename T>
+typename T::Object SubscriptionClass<T>::create_instance(ContextType ctx, Results result_set, util::Optional<std::string> name) {
+    return create_object<T, SubscriptionClass<T>>(ctx, new Subscription<T>(std::move(result_set), name));
+}
+
 template<typename T>
 void SubscriptionClass<T>::get_state(ContextType ctx, ObjectType object, ReturnValue &return_value) {
     auto subscription = get_internal<T, SubscriptionClass<T>>(object);
@@ -892,7 +1137,7 @@ template<typename T>
 void SubscriptionClass<T>::unsubscribe(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
     args.validate_maximum(0);
     auto subscription = get_internal<T, SubscriptionClass<T>>(this_object);
-    partial_sync::unsubscribe(*subscription);
+    subscription->unsubscribe();
     return_value.set_undefined();
 }
 
@@ -906,7 +1151,7 @@ void SubscriptionClass<T>::add_listener(ContextType ctx, ObjectType this_object,
     Protected<ObjectType> protected_this(ctx, this_object);
     Protected<typename T::GlobalContext> protected_ctx(Context<T>::get_global_context(ctx));
 
-    auto token = subscription->add_notification_callback([=]() {
+    subscription->add_listener(protected_callback, [=]() {
         HANDLESCOPE
 
         ValueType arguments[2];
@@ -914,8 +1159,6 @@ void SubscriptionClass<T>::add_listener(ContextType ctx, ObjectType this_object,
         arguments[1] = Value::from_number(protected_ctx, static_cast<double>(subscription->state()));
         Function::callback(protected_ctx, protected_callback, protected_this, 2, arguments);
     });
-
-    subscription->m_notification_tokens.emplace_back(protected_callback, std::move(token));
 }
 
 template<typename T>
@@ -924,20 +1167,14 @@ void SubscriptionClass<T>::remove_listener(ContextType ctx, ObjectType this_obje
     auto subscription = get_internal<T, SubscriptionClass<T>>(this_object);
 
     auto callback = Value::validated_to_function(ctx, args[0]);
-    auto protected_function = Protected<FunctionType>(ctx, callback);
-
-    auto& tokens = subscription->m_notification_tokens;
-    auto compare = [&](auto&& token) {
-        return typename Protected<FunctionType>::Comparator()(token.first, protected_function);
-    };
-    tokens.erase(std::remove_if(tokens.begin(), tokens.end(), compare), tokens.end());
+    subscription->remove_listener(Protected<FunctionType>(ctx, callback));
 }
 
 template<typename T>
 void SubscriptionClass<T>::remove_all_listeners(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
     args.validate_maximum(0);
     auto subscription = get_internal<T, SubscriptionClass<T>>(this_object);
-    subscription->m_notification_tokens.clear();
+    subscription->remove_all_listeners();
 }
 
 template<typename T>
@@ -970,12 +1207,14 @@ public:
     static void create_global_notifier(ContextType, ObjectType, Arguments &, ReturnValue &);
     static void local_listener_realms(ContextType, ObjectType, Arguments&, ReturnValue &);
     static void enable_multiplexing(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void get_stats(ContextType, ObjectType, Arguments &, ReturnValue &);
     static void deserialize_change_set(ContextType, ObjectType, Arguments &, ReturnValue &);
 
     // private
     static std::function<SyncBindSessionHandler> session_bind_callback(ContextType ctx, ObjectType sync_constructor);
     static void populate_sync_config(ContextType, ObjectType realm_constructor, ObjectType config_object, Realm::Config&);
     static void populate_sync_config_for_ssl(ContextType, ObjectType config_object, SyncConfig&);
+    static void trace_sessions(ContextType);
 
     MethodMap<T> const static_methods = {
         {"_hasExistingSessions", {wrap<has_existing_sessions>}},
@@ -983,6 +1222,7 @@ public:
         {"reconnect", wrap<reconnect>},
         {"setLogLevel", wrap<set_sync_log_level>},
         {"enableSessionMultiplexing", wrap<enable_multiplexing>},
+        {"getStats", wrap<get_stats>},
         {"setUserAgent", wrap<set_sync_user_agent>},
         {"_initializeSyncManager", wrap<initialize_sync_manager>},
 
@@ -1049,9 +1289,63 @@ void SyncClass<T>::set_sync_log_level(ContextType ctx, ObjectType this_object, A
 #if REALM_PLATFORM_NODE
 template<typename T>
 void SyncClass<T>::set_sync_logger(ContextType ctx, ObjectType this_object, Arguments &args, ReturnValue &return_value) {
-    args.validate_count(1);
+    args.validate_between(1, 2);
     auto callback_fn = Value::validated_to_function(ctx, args[0], "logger_callback");
-    syncManagerShared<T>(ctx).set_logger_factory(*new realm::node::SyncLoggerFactory(ctx, callback_fn));
+
+    realm::node::SyncLoggerOptions options;
+    if (!Value::is_undefined(ctx, args[1])) {
+        static const String batch_string = "batch";
+        static const String buffer_size_string = "bufferSize";
+        static const String filter_string = "filter";
+        static const String ignore_case_string = "ignoreCase";
+
+        auto options_object = Value::validated_to_object(ctx, args[1], "options");
+
+        auto batch_value = Object::get_property(ctx, options_object, batch_string);
+        if (!Value::is_undefined(ctx, batch_value)) {
+            options.batch = Value::validated_to_boolean(ctx, batch_value, "batch");
+        }
+
+        auto buffer_size_value = Object::get_property(ctx, options_object, buffer_size_string);
+        if (!Value::is_undefined(ctx, buffer_size_value)) {
+            double buffer_size = Value::validated_to_number(ctx, buffer_size_value, "bufferSize");
+            if (buffer_size < 0) {
+                throw std::invalid_argument("'bufferSize' must not be negative.");
+            }
+            options.buffer_size = static_cast<size_t>(buffer_size);
+        }
+
+        auto ignore_case_value = Object::get_property(ctx, options_object, ignore_case_string);
+        if (!Value::is_undefined(ctx, ignore_case_value)) {
+            options.ignore_case = Value::validated_to_boolean(ctx, ignore_case_value, "ignoreCase");
+        }
+
+        // Either a substring or an array of substrings, which are searched
+        // for in every message on the sync thread, so no regular expression
+        // is run there.
+        auto filter_value = Object::get_property(ctx, options_object, filter_string);
+        if (!Value::is_undefined(ctx, filter_value)) {
+            if (Value::is_array(ctx, filter_value)) {
+                auto array = Value::to_array(ctx, filter_value);
+                uint32_t length = Object::validated_get_length(ctx, array);
+                for (uint32_t i = 0; i < length; ++i) {
+                    options.filter.push_back(Object::validated_get_string(ctx, array, i, "filter"));
+                }
+            }
+            else {
+                options.filter.push_back(Value::validated_to_string(ctx, filter_value, "filter"));
+            }
+            if (options.ignore_case) {
+                for (auto& substring : options.filter) {
+                    std::transform(substring.begin(), substring.end(), substring.begin(), [](char c) {
+                        return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+                    });
+                }
+            }
+        }
+    }
+
+    syncManagerShared<T>(ctx).set_logger_factory(*new realm::node::SyncLoggerFactory(ctx, callback_fn, std::move(options)));
 }
 #endif
 
@@ -1301,7 +1595,31 @@ void SyncClass<T>::populate_sync_config_for_ssl(ContextType ctx, ObjectType conf
 
     ValueType validate_callback = Object::get_property(ctx, config_object, "validateCallback");
     if (Value::is_function(ctx, validate_callback)) {
-        config.ssl_verify_callback = SSLVerifyCallbackSyncThreadFunctor<T> { ctx, Value::to_function(ctx, validate_callback) };
+        FunctionType callback_function = Value::to_function(ctx, validate_callback);
+
+        // Answers are shared by the sessions using the same callback, which
+        // is given an id the first time it is cached for.
+        SSLVerificationCache::Clock::duration cache_duration{};
+        uint64_t callback_id = 0;
+        ValueType cache_value = Object::get_property(ctx, config_object, "validateCallbackCacheMs");
+        if (!Value::is_undefined(ctx, cache_value)) {
+            double cache_ms = Value::validated_to_number(ctx, cache_value, "validateCallbackCacheMs");
+            if (!(cache_ms >= 0)) {
+                throw std::invalid_argument("'validateCallbackCacheMs' must not be negative.");
+            }
+            cache_duration = std::chrono::duration_cast<SSLVerificationCache::Clock::duration>(std::chrono::duration<double, std::milli>(cache_ms));
+
+            static const String callback_id_string = "_sslVerificationCacheId";
+            ValueType id_value = Object::get_property(ctx, callback_function, callback_id_string);
+            if (Value::is_number(ctx, id_value)) {
+                callback_id = uint64_t(Value::to_number(ctx, id_value));
+            }
+            else {
+                callback_id = SSLVerificationCache::shared().next_callback_id();
+                Object::set_property(ctx, callback_function, callback_id_string, Value::from_number(ctx, double(callback_id)), ReadOnly | DontEnum | DontDelete);
+            }
+        }
+        config.ssl_verify_callback = SSLVerifyCallbackSyncThreadFunctor<T> { ctx, callback_function, cache_duration, callback_id };
     }
 }
 
@@ -1309,6 +1627,131 @@ template<typename T>
 void SyncClass<T>::enable_multiplexing(ContextType ctx, ObjectType this_object, Arguments& arguments, ReturnValue &return_value) {
     arguments.validate_count(0);
     SyncManager::shared().enable_session_multiplexing();
+    SyncStats::shared().set_multiplexing_enabled();
+}
+
+template<typename T>
+void SyncClass<T>::get_stats(ContextType ctx, ObjectType this_object, Arguments& arguments, ReturnValue &return_value) {
+    arguments.validate_count(0);
+
+    struct Connection {
+        std::string server_url;
+        std::string multiplex_identifier;
+        SyncSession::ConnectionState state = SyncSession::ConnectionState::Disconnected;
+        uint32_t sessions = 0;
+        uint64_t uploaded = 0, uploadable = 0, downloaded = 0, downloadable = 0, reconnects = 0;
+    };
+
+    std::vector<std::shared_ptr<SyncSession>> sessions;
+    for (auto& user : syncManagerShared<T>(ctx).all_logged_in_users()) {
+        auto user_sessions = user->all_sessions();
+        sessions.insert(sessions.end(), user_sessions.begin(), user_sessions.end());
+    }
+    auto& stats = SyncStats::shared();
+    bool multiplexing = stats.multiplexing_enabled();
+
+    std::vector<Connection> connections;
+    std::unordered_map<std::string, uint32_t> connection_indices;
+    std::vector<ValueType> session_values;
+    session_values.reserve(sessions.size());
+    for (auto& session_stats : stats.read(sessions)) {
+        auto& session = *session_stats.session;
+        auto& counters = *session_stats.counters;
+        uint64_t reconnects = counters.connects > 1 ? counters.connects - 1 : 0;
+
+        // Multiplexed sessions share a connection per server and multiplex
+        // identifier, and otherwise each session has its own.
+        util::Uri uri(session.config().realm_url());
+        std::string server_url = uri.get_scheme() + uri.get_auth();
+        std::string key = multiplexing ? server_url + "#" + session_stats.multiplex_identifier : session.path();
+        auto inserted = connection_indices.emplace(key, uint32_t(connections.size()));
+        if (inserted.second) {
+            connections.emplace_back();
+            connections.back().server_url = server_url;
+            connections.back().multiplex_identifier = session_stats.multiplex_identifier;
+        }
+        auto& connection = connections[inserted.first->second];
+        // A connection is as connected as the most connected of its sessions.
+        if (session.connection_state() == SyncSession::ConnectionState::Connected ||
+            connection.state == SyncSession::ConnectionState::Disconnected) {
+            connection.state = session.connection_state();
+        }
+        ++connection.sessions;
+        connection.uploaded += counters.uploaded;
+        connection.uploadable += counters.uploadable;
+        connection.downloaded += counters.downloaded;
+        connection.downloadable += counters.downloadable;
+        connection.reconnects = std::max(connection.reconnects, reconnects);
+
+        ObjectType value = Object::create_empty(ctx);
+        Object::set_property(ctx, value, "path", Value::from_string(ctx, session.path()));
+        Object::set_property(ctx, value, "state", Value::from_string(ctx, session.state() == SyncSession::PublicState::Inactive ? "inactive" : "active"));
+        Object::set_property(ctx, value, "connectionState", Value::from_string(ctx, SessionClass<T>::get_connection_state_value(session.connection_state())));
+        Object::set_property(ctx, value, "connection", Value::from_number(ctx, inserted.first->second));
+        Object::set_property(ctx, value, "uploadedBytes", Value::from_number(ctx, double(counters.uploaded)));
+        Object::set_property(ctx, value, "uploadableBytes", Value::from_number(ctx, double(counters.uploadable)));
+        Object::set_property(ctx, value, "downloadedBytes", Value::from_number(ctx, double(counters.downloaded)));
+        Object::set_property(ctx, value, "downloadableBytes", Value::from_number(ctx, double(counters.downloadable)));
+        Object::set_property(ctx, value, "reconnects", Value::from_number(ctx, double(reconnects)));
+        session_values.push_back(value);
+    }
+
+    std::vector<ValueType> connection_values;
+    connection_values.reserve(connections.size());
+    for (auto& connection : connections) {
+        ObjectType value = Object::create_empty(ctx);
+        Object::set_property(ctx, value, "serverUrl", Value::from_string(ctx, connection.server_url));
+        Object::set_property(ctx, value, "multiplexIdentifier", Value::from_string(ctx, connection.multiplex_identifier));
+        Object::set_property(ctx, value, "state", Value::from_string(ctx, SessionClass<T>::get_connection_state_value(connection.state)));
+        Object::set_property(ctx, value, "sessions", Value::from_number(ctx, connection.sessions));
+        Object::set_property(ctx, value, "uploadedBytes", Value::from_number(ctx, double(connection.uploaded)));
+        Object::set_property(ctx, value, "uploadableBytes", Value::from_number(ctx, double(connection.uploadable)));
+        Object::set_property(ctx, value, "downloadedBytes", Value::from_number(ctx, double(connection.downloaded)));
+        Object::set_property(ctx, value, "downloadableBytes", Value::from_number(ctx, double(connection.downloadable)));
+        Object::set_property(ctx, value, "reconnects", Value::from_number(ctx, double(connection.reconnects)));
+        connection_values.push_back(value);
+    }
+
+    ObjectType result = Object::create_empty(ctx);
+    Object::set_property(ctx, result, "multiplexing", Value::from_boolean(ctx, multiplexing));
+    Object::set_property(ctx, result, "connections", Object::create_array(ctx, connection_values));
+    Object::set_property(ctx, result, "sessions", Object::create_array(ctx, session_values));
+    return_value.set(result);
+}
+
+// Records the progress and connection changes of the sessions which are
+// open when tracing starts, as they're reported on the sync client's thread.
+template<typename T>
+void SyncClass<T>::trace_sessions(ContextType ctx) {
+    auto& trace = TraceEvents::shared();
+    for (auto& user : syncManagerShared<T>(ctx).all_logged_in_users()) {
+        for (auto& session : user->all_sessions()) {
+            auto progress_notifier = [&trace](const char* name) {
+                return [&trace, name](uint64_t transferred, uint64_t) {
+                    trace.name_current_thread("Sync client");
+                    trace.counter("sync", name, int64_t(transferred));
+                };
+            };
+            auto download = session->register_progress_notifier(progress_notifier(trace.intern("download " + session->path())),
+                                                                SyncSession::NotifierType::download, true);
+            auto upload = session->register_progress_notifier(progress_notifier(trace.intern("upload " + session->path())),
+                                                              SyncSession::NotifierType::upload, true);
+            auto connection = session->register_connection_change_callback([&trace](SyncSession::ConnectionState, SyncSession::ConnectionState new_state) {
+                trace.name_current_thread("Sync client");
+                trace.instant("sync", new_state == SyncSession::ConnectionState::Connected ? "connected" :
+                                      new_state == SyncSession::ConnectionState::Connecting ? "connecting" : "disconnected");
+            });
+
+            std::weak_ptr<SyncSession> weak_session = session;
+            trace.on_stop([=] {
+                if (auto session = weak_session.lock()) {
+                    session->unregister_progress_notifier(download);
+                    session->unregister_progress_notifier(upload);
+                    session->unregister_connection_change_callback(connection);
+                }
+            });
+        }
+    }
 }
 
 #if REALM_PLATFORM_NODE
@@ -1351,11 +1794,19 @@ void SyncClass<T>::create_global_notifier(ContextType ctx, ObjectType this_objec
 
     sync_config_template.bind_session_handler = SyncClass<T>::session_bind_callback(ctx, this_object);
 
-    auto notifier = std::make_unique<GlobalNotifier>(std::make_unique<GlobalNotifierCallback<T>>(ctx, Protected<FunctionType>{ctx, std::move(user_callback)}),
+    // Each listener registers its own filter through `_filters`.
+    auto filters = std::make_shared<ListenerFilters>();
+    auto notifier = std::make_unique<GlobalNotifier>(std::make_unique<GlobalNotifierCallback<T>>(ctx, Protected<FunctionType>{ctx, std::move(user_callback)}, filters),
                                                      std::move(local_root_dir),
                                                      std::move(sync_config_template)); // Throws
-    return_value.set(create_object<T, GlobalNotifierClass<T>>(ctx, notifier.get()));
+    ObjectType notifier_object = create_object<T, GlobalNotifierClass<T>>(ctx, notifier.get());
     notifier.release();
+
+    PropertyAttributes attributes = ReadOnly | DontEnum | DontDelete;
+    Object::set_property(ctx, notifier_object, "_filters",
+                         create_object<T, ListenerFiltersClass<T>>(ctx, new std::shared_ptr<ListenerFilters>(std::move(filters))),
+                         attributes);
+    return_value.set(notifier_object);
 }
 
 template <typename T>
@@ -1420,8 +1871,23 @@ void SyncClass<T>::local_listener_realms(ContextType ctx, ObjectType this_object
 
 template<typename T>
 void SyncClass<T>::deserialize_change_set(ContextType ctx, ObjectType this_object, Arguments& args, ReturnValue &return_value) {
-    std::string serialized = Value::validated_to_string(ctx, args[0], "serialized");
-    return_value.set(create_object<T, ChangeObject<T>>(ctx, new GlobalNotifier::ChangeNotification(serialized)));
+    args.validate_count(1);
+    if (Value::is_string(ctx, args[0])) {
+        std::string serialized = Value::validated_to_string(ctx, args[0], "serialized");
+        return_value.set(create_object<T, ChangeObject<T>>(ctx, new ChangeNotification<T>(serialized, util::none)));
+        return;
+    }
+
+    // The binary form is read where it is, rather than being copied first.
+    BinaryData bytes;
+    OwnedBinaryData copy;
+    if (!Value::to_binary_view(ctx, args[0], bytes)) {
+        copy = Value::validated_to_binary(ctx, args[0], "serialized");
+        bytes = copy.get();
+    }
+    util::Optional<change_set_codec::ChangeSets> changes;
+    std::string serialized = change_set_codec::decode(bytes, changes);
+    return_value.set(create_object<T, ChangeObject<T>>(ctx, new ChangeNotification<T>(serialized, std::move(changes))));
 }
 #endif
 
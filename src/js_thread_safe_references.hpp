@@ -0,0 +1,139 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2020 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "list.hpp"
+#include "object.hpp"
+#include "results.hpp"
+#include "shared_realm.hpp"
+#include "thread_safe_reference.hpp"
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace realm {
+namespace js {
+
+// Thread safe references handed to JavaScript by id. The id can be posted to
+// another thread, such as a Node.js worker with an isolate of its own, and
+// resolved there against a Realm opened with the same configuration. Each
+// reference can be resolved once.
+//
+// A reference keeps the version it was created at in the file, so references
+// which are not resolved within `lifetime()` are dropped when references are
+// next added or resolved.
+class ThreadSafeReferences {
+  public:
+    enum class Type {
+        Realm,
+        Object,
+        Results,
+        List,
+    };
+
+    struct Entry {
+        Type type = Type::Realm;
+        Realm::Config config;
+        std::unique_ptr<ThreadSafeReference<realm::Object>> object;
+        std::unique_ptr<ThreadSafeReference<realm::Results>> results;
+        std::unique_ptr<ThreadSafeReference<realm::List>> list;
+        std::chrono::steady_clock::time_point expires;
+    };
+
+    static std::chrono::minutes lifetime() {
+        return std::chrono::minutes(5);
+    }
+
+    // The configuration without the callbacks, which belong to the context
+    // the Realm was opened in. The schema has already been migrated.
+    static Realm::Config portable_config(const Realm::Config& config) {
+        Realm::Config portable = config;
+        portable.migration_function = nullptr;
+        portable.initialization_function = nullptr;
+        portable.should_compact_on_launch_function = nullptr;
+        portable.cache = true;
+        return portable;
+    }
+
+    static uint64_t add(Entry entry) {
+        auto& references = instance();
+        std::vector<Entry> expired;
+        std::lock_guard<std::mutex> lock(references.m_mutex);
+        references.take_expired(expired);
+        uint64_t id = ++references.m_last_id;
+        entry.expires = std::chrono::steady_clock::now() + lifetime();
+        references.m_entries.emplace(id, std::move(entry));
+        return id;
+    }
+
+    static Entry take(uint64_t id) {
+        auto& references = instance();
+        std::vector<Entry> expired;
+        std::lock_guard<std::mutex> lock(references.m_mutex);
+        references.take_expired(expired);
+        auto it = references.m_entries.find(id);
+        if (it == references.m_entries.end()) {
+            throw std::runtime_error("Thread safe reference does not exist, has already been resolved or has expired.");
+        }
+        Entry entry = std::move(it->second);
+        references.m_entries.erase(it);
+        return entry;
+    }
+
+    static const char* type_name(Type type) {
+        switch (type) {
+            case Type::Realm: return "Realm";
+            case Type::Object: return "Object";
+            case Type::Results: return "Results";
+            case Type::List: return "List";
+        }
+        return "";
+    }
+
+  private:
+    std::mutex m_mutex;
+    uint64_t m_last_id = 0;
+    std::unordered_map<uint64_t, Entry> m_entries;
+
+    // Moves the expired entries out, so that they are destroyed after the
+    // lock is released, as that unpins their versions.
+    void take_expired(std::vector<Entry>& expired) {
+        auto now = std::chrono::steady_clock::now();
+        for (auto it = m_entries.begin(); it != m_entries.end();) {
+            if (it->second.expires > now) {
+                ++it;
+                continue;
+            }
+            expired.push_back(std::move(it->second));
+            it = m_entries.erase(it);
+        }
+    }
+
+    static ThreadSafeReferences& instance() {
+        static ThreadSafeReferences s_references;
+        return s_references;
+    }
+};
+
+} // js
+} // realm
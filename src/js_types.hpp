@@ -20,7 +20,11 @@
 
 #include "execution_context_id.hpp"
 #include "property.hpp"
+#include "typed_array.hpp"
 
+#include <cstdint>
+#include <cstring>
+#include <functional>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -40,6 +44,8 @@
 #endif
 
 namespace realm {
+class ObjectSchema;
+
 namespace js {
 
 template<typename>
@@ -58,6 +64,25 @@ inline PropertyAttributes operator|(PropertyAttributes a, PropertyAttributes b)
     return PropertyAttributes(static_cast<unsigned>(a) | static_cast<unsigned>(b));
 }
 
+// Whether the UTF-8 string is only ASCII, which engines can take as it is
+// rather than decoding it. Checked a word at a time.
+inline bool is_ascii(const char *data, size_t size) {
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, data + i, sizeof(word));
+        if (word & 0x8080808080808080ULL) {
+            return false;
+        }
+    }
+    for (; i < size; ++i) {
+        if (static_cast<unsigned char>(data[i]) & 0x80) {
+            return false;
+        }
+    }
+    return true;
+}
+
 template<typename T>
 struct String {
     using StringType = typename T::String;
@@ -68,8 +93,17 @@ struct String {
     String(StringType &&);
     String(StringData);
 
+    // Returns a string which is converted to an engine string only once.
+    // Meant for names which repeatedly cross the boundary, such as property
+    // names and option keys, not for arbitrary values.
+    static String intern(const std::string &);
+
     operator StringType() const;
     operator std::string() const;
+
+    // The UTF-8 form of the string without copying it, valid for as long as
+    // the string is.
+    StringData data() const;
 };
 
 template<typename T>
@@ -79,6 +113,14 @@ struct Context {
 
     static GlobalContextType get_global_context(ContextType);
     static AbstractExecutionContextID get_execution_context_id(ContextType);
+
+    // Registers a function which releases values the current thread keeps
+    // for its context, run before the engine tears the context down.
+    static void add_cleanup(std::function<void()>);
+
+    // Whether object-store's change notifications reach the calling thread,
+    // which they only do on the thread of the main event loop.
+    static bool delivers_notifications();
 };
 
 class TypeErrorException : public std::invalid_argument {
@@ -124,17 +166,20 @@ struct Value {
     static bool is_binary(ContextType, const ValueType &);
     static bool is_valid(const ValueType &);
 
-    static bool is_valid_for_property(ContextType, const ValueType&, const Property&);
-    static bool is_valid_for_property_type(ContextType, const ValueType&, realm::PropertyType type, StringData object_type);
+    // Numbers are only valid dates for Realms which read dates as numbers.
+    static bool is_valid_for_property(ContextType, const ValueType&, const Property&, bool dates_as_numbers = false);
+    static bool is_valid_for_property_type(ContextType, const ValueType&, realm::PropertyType type, StringData object_type, bool dates_as_numbers = false);
 
     static ValueType from_boolean(ContextType, bool);
     static ValueType from_null(ContextType);
     static ValueType from_number(ContextType, double);
     static ValueType from_string(ContextType ctx, const char *s) { return s ? from_nonnull_string(ctx, s) : from_null(ctx); }
-    static ValueType from_string(ContextType ctx, StringData s) { return s ? from_nonnull_string(ctx, s) : from_null(ctx); }
+    static ValueType from_string(ContextType ctx, StringData s) { return s ? from_nonnull_string_data(ctx, s) : from_null(ctx); }
     static ValueType from_string(ContextType ctx, const std::string& s) { return from_nonnull_string(ctx, s.c_str()); }
     static ValueType from_binary(ContextType ctx, BinaryData b) { return b ? from_nonnull_binary(ctx, b) : from_null(ctx); }
     static ValueType from_nonnull_string(ContextType, const String<T>&);
+    // Creates the string from its known size, rather than measuring it again.
+    static ValueType from_nonnull_string_data(ContextType, StringData);
     static ValueType from_nonnull_binary(ContextType, BinaryData);
     static ValueType from_undefined(ContextType);
     static ValueType from_timestamp(ContextType, Timestamp);
@@ -149,6 +194,13 @@ struct Value {
     static ObjectType to_object(ContextType, const ValueType &);
     static String<T> to_string(ContextType, const ValueType &);
     static OwnedBinaryData to_binary(ContextType, ValueType);
+    // Points `data` at the backing store of an ArrayBuffer, typed array or
+    // Buffer without copying it, if the engine allows. The view is only valid
+    // while `value` is alive and unchanged.
+    static bool to_binary_view(ContextType, const ValueType &, BinaryData &data);
+    // Sets `type` to the element type of a typed array, or returns false if
+    // `value` isn't one.
+    static bool get_typed_array_type(ContextType, const ValueType &, TypedArrayType &type);
 
 
 #define VALIDATED(return_t, type) \
@@ -283,11 +335,22 @@ struct Object {
         return create_array(ctx, 0, nullptr);
     }
 
+    static ObjectType create_int32_array(ContextType, const std::vector<int32_t> &);
+    // Creates a typed array whose contents are a copy of `bytes`, which are
+    // laid out as its elements.
+    static ObjectType create_typed_array(ContextType, TypedArrayType, BinaryData bytes);
+
     static ObjectType create_date(ContextType, double);
 
     template<typename ClassType>
     static ObjectType create_instance(ContextType, typename ClassType::Internal*);
 
+    // Creates an instance whose properties are described by the given object
+    // schema. Engines which can't specialize instances per schema fall back
+    // to create_instance().
+    template<typename ClassType>
+    static ObjectType create_instance_by_schema(ContextType, const ObjectSchema&, typename ClassType::Internal*);
+
     template<typename ClassType>
     static bool is_instance(ContextType, const ObjectType &);
 
@@ -311,6 +374,20 @@ class Protected {
     };
 };
 
+// A reference to an object which does not keep it alive. get() fails once the
+// object has been collected. Engines which cannot observe this safely declare
+// `supported` as false and get() then always fails.
+template<typename ValueType>
+class Weak {
+    static const bool supported;
+
+    template<typename ContextType>
+    Weak(ContextType, const ValueType &);
+
+    template<typename ContextType>
+    bool get(ContextType, ValueType &) const;
+};
+
 template<typename T>
 struct Exception : public std::runtime_error {
     using ContextType = typename T::Context;
@@ -367,13 +444,13 @@ REALM_JS_INLINE void set_internal(const typename T::Object &object, typename Cla
 }
 
 template<typename T>
-inline bool Value<T>::is_valid_for_property(ContextType context, const ValueType &value, const Property& prop)
+inline bool Value<T>::is_valid_for_property(ContextType context, const ValueType &value, const Property& prop, bool dates_as_numbers)
 {
-    return is_valid_for_property_type(context, value, prop.type, prop.object_type);
+    return is_valid_for_property_type(context, value, prop.type, prop.object_type, dates_as_numbers);
 }
 
 template<typename T>
-inline bool Value<T>::is_valid_for_property_type(ContextType context, const ValueType &value, realm::PropertyType type, StringData object_type) {
+inline bool Value<T>::is_valid_for_property_type(ContextType context, const ValueType &value, realm::PropertyType type, StringData object_type, bool dates_as_numbers) {
     using realm::PropertyType;
 
     auto check_value = [&](auto&& value) {
@@ -392,7 +469,7 @@ inline bool Value<T>::is_valid_for_property_type(ContextType context, const Valu
             case PropertyType::Data:
                 return is_binary(context, value) || is_string(context, value);
             case PropertyType::Date:
-                return is_date(context, value) || is_string(context, value);
+                return is_date(context, value) || is_string(context, value) || (dates_as_numbers && is_number(context, value));
             case PropertyType::Object:
                 return true;
             case PropertyType::Any:
@@ -22,6 +22,7 @@
 #include <sstream>
 #include <stdexcept>
 
+#include "memory_stats.hpp"
 #include "object_schema.hpp"
 #include "shared_realm.hpp"
 
@@ -43,6 +44,13 @@ static inline RealmDelegate<T> *get_delegate(realm::Realm *realm) {
     return static_cast<RealmDelegate<T> *>(realm->m_binding_context.get());
 }
 
+// The live wrapper counts of the Realm, unless it has been closed.
+template<typename T>
+static inline std::shared_ptr<LiveWrapperCounts> live_wrapper_counts(std::shared_ptr<realm::Realm> const& realm) {
+    auto delegate = realm ? get_delegate<T>(realm.get()) : nullptr;
+    return delegate ? delegate->live_wrapper_counts() : nullptr;
+}
+
 template<typename T>
 static inline T stot(const std::string &s) {
     std::istringstream iss(s);
@@ -0,0 +1,45 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2020 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "jsc_init.h"
+#include "jsc_init.hpp"
+
+#include "js_benchmarks.hpp"
+
+extern "C" {
+
+using namespace realm;
+using namespace realm::jsc;
+
+void RJSInitializeBenchmarksInContext(JSContextRef ctx) {
+    static const jsc::String benchmarks_string = "RealmBenchmarks";
+    static const jsc::String run_string = "run";
+
+    JSObjectRef benchmarks = jsc::Object::create_empty(ctx);
+    JSObjectRef run = JSObjectMakeFunctionWithCallback(ctx, run_string, js::wrap<js::benchmarks::run<Types>>);
+    jsc::Object::set_property(ctx, benchmarks, run_string, run, js::ReadOnly | js::DontDelete);
+
+    JSObjectRef global_object = JSContextGetGlobalObject(ctx);
+    jsc::Object::set_property(ctx, global_object, benchmarks_string, benchmarks, js::ReadOnly | js::DontEnum | js::DontDelete);
+}
+
+void RJSBenchmarksCountAllocation(void) {
+    js::benchmarks::count_allocation();
+}
+
+} // extern "C"
@@ -20,6 +20,7 @@
 
 #include "jsc_types.hpp"
 
+#include "boundary_stats.hpp"
 #include "js_class.hpp"
 #include "js_util.hpp"
 
@@ -132,6 +133,10 @@ inline JSClassRef ObjectWrap<ClassType>::create_class() {
     definition.className = s_class.name.c_str();
     definition.finalize = finalize;
 
+#if REALM_JS_BOUNDARY_STATS
+    js::name_boundary_wrappers(s_class);
+#endif
+
     if (!s_class.methods.empty()) {
         methods = get_methods(s_class.methods);
         definition.staticFunctions = methods.data();
@@ -387,7 +392,7 @@ JSValueRef wrap(JSContextRef ctx, JSObjectRef, JSObjectRef this_object, size_t a
     jsc::Arguments args{ctx, argc, arguments};
     jsc::ReturnValue return_value(ctx);
     try {
-        F(ctx, this_object, args, return_value);
+        REALM_JS_COUNT_BOUNDARY_CALL(jsc::Types::FunctionCallback, wrap<F>, F(ctx, this_object, args, return_value));
         return return_value;
     }
     catch (std::exception &e) {
@@ -400,7 +405,7 @@ template<jsc::PropertyType::GetterType F>
 JSValueRef wrap(JSContextRef ctx, JSObjectRef object, JSStringRef property, JSValueRef* exception) {
     jsc::ReturnValue return_value(ctx);
     try {
-        F(ctx, object, return_value);
+        REALM_JS_COUNT_BOUNDARY_CALL(jsc::Types::PropertyGetterCallback, wrap<F>, F(ctx, object, return_value));
         return return_value;
     }
     catch (std::exception &e) {
@@ -412,7 +417,7 @@ JSValueRef wrap(JSContextRef ctx, JSObjectRef object, JSStringRef property, JSVa
 template<jsc::PropertyType::SetterType F>
 bool wrap(JSContextRef ctx, JSObjectRef object, JSStringRef property, JSValueRef value, JSValueRef* exception) {
     try {
-        F(ctx, object, value);
+        REALM_JS_COUNT_BOUNDARY_CALL(jsc::Types::PropertySetterCallback, wrap<F>, F(ctx, object, value));
         return true;
     }
     catch (std::exception &e) {
@@ -425,7 +430,7 @@ template<jsc::IndexPropertyType::GetterType F>
 JSValueRef wrap(JSContextRef ctx, JSObjectRef object, uint32_t index, JSValueRef* exception) {
     jsc::ReturnValue return_value(ctx);
     try {
-        F(ctx, object, index, return_value);
+        REALM_JS_COUNT_BOUNDARY_CALL(jsc::Types::IndexPropertyGetterCallback, wrap<F>, F(ctx, object, index, return_value));
         return return_value;
     }
     catch (std::out_of_range &) {
@@ -441,7 +446,9 @@ JSValueRef wrap(JSContextRef ctx, JSObjectRef object, uint32_t index, JSValueRef
 template<jsc::IndexPropertyType::SetterType F>
 bool wrap(JSContextRef ctx, JSObjectRef object, uint32_t index, JSValueRef value, JSValueRef* exception) {
     try {
-        return F(ctx, object, index, value);
+        bool intercepted = false;
+        REALM_JS_COUNT_BOUNDARY_CALL(jsc::Types::IndexPropertySetterCallback, wrap<F>, intercepted = F(ctx, object, index, value));
+        return intercepted;
     }
     catch (std::exception &e) {
         *exception = jsc::Exception::value(ctx, e);
@@ -451,9 +458,11 @@ bool wrap(JSContextRef ctx, JSObjectRef object, uint32_t index, JSValueRef value
 
 template<jsc::StringPropertyType::GetterType F>
 JSValueRef wrap(JSContextRef ctx, JSObjectRef object, JSStringRef property, JSValueRef* exception) {
+    static thread_local jsc::PropertyNameCache names;
     jsc::ReturnValue return_value(ctx);
     try {
-        F(ctx, object, property, return_value);
+        jsc::String name(property, names.get(property));
+        REALM_JS_COUNT_BOUNDARY_CALL(jsc::Types::StringPropertyGetterCallback, wrap<F>, F(ctx, object, name, return_value));
         return return_value;
     }
     catch (std::exception &e) {
@@ -464,8 +473,12 @@ JSValueRef wrap(JSContextRef ctx, JSObjectRef object, JSStringRef property, JSVa
 
 template<jsc::StringPropertyType::SetterType F>
 bool wrap(JSContextRef ctx, JSObjectRef object, JSStringRef property, JSValueRef value, JSValueRef* exception) {
+    static thread_local jsc::PropertyNameCache names;
     try {
-        return F(ctx, object, property, value);
+        jsc::String name(property, names.get(property));
+        bool intercepted = false;
+        REALM_JS_COUNT_BOUNDARY_CALL(jsc::Types::StringPropertySetterCallback, wrap<F>, intercepted = F(ctx, object, name, value));
+        return intercepted;
     }
     catch (std::exception &e) {
         *exception = jsc::Exception::value(ctx, e);
@@ -475,7 +488,8 @@ bool wrap(JSContextRef ctx, JSObjectRef object, JSStringRef property, JSValueRef
 
 template<jsc::StringPropertyType::EnumeratorType F>
 void wrap(JSContextRef ctx, JSObjectRef object, JSPropertyNameAccumulatorRef accumulator) {
-    auto names = F(ctx, object);
+    std::vector<jsc::String> names;
+    REALM_JS_COUNT_BOUNDARY_CALL(jsc::Types::StringPropertyEnumeratorCallback, wrap<F>, names = F(ctx, object));
     for (auto &name : names) {
         JSPropertyNameAccumulatorAddName(accumulator, name);
     }
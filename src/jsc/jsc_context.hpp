@@ -34,5 +34,16 @@ inline AbstractExecutionContextID jsc::Context::get_execution_context_id(JSConte
     return reinterpret_cast<AbstractExecutionContextID>(get_global_context(ctx));
 }
 
+template<>
+inline void jsc::Context::add_cleanup(std::function<void()>) {
+    // Protected values keep their context alive, so it's never torn down
+    // underneath them.
+}
+
+template<>
+inline bool jsc::Context::delivers_notifications() {
+    return true;
+}
+
 } // js
 } // realm
@@ -27,6 +27,13 @@ extern "C" {
 JSObjectRef RJSConstructorCreate(JSContextRef ctx);
 void RJSInitializeInContext(JSContextRef ctx);
 
+// Defines `RealmBenchmarks.run(path, [filter], [iterations])`, which runs the
+// micro-benchmarks of src/js_benchmarks.hpp. Allocations are only counted if
+// the global operator new is replaced with one that calls
+// RJSBenchmarksCountAllocation().
+void RJSInitializeBenchmarksInContext(JSContextRef ctx);
+void RJSBenchmarksCountAllocation(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -107,6 +107,38 @@ inline JSObjectRef jsc::Object::create_array(JSContextRef ctx, uint32_t length,
     return array;
 }
 
+template<>
+inline JSObjectRef jsc::Object::create_int32_array(JSContextRef ctx, const std::vector<int32_t> &values) {
+    static jsc::String s_int32_array = "Int32Array";
+
+    JSObjectRef constructor = validated_get_constructor(ctx, JSContextGetGlobalObject(ctx), s_int32_array);
+    JSValueRef length = jsc::Value::from_number(ctx, values.size());
+    JSValueRef exception = nullptr;
+    JSObjectRef array = JSObjectCallAsConstructor(ctx, constructor, 1, &length, &exception);
+    if (exception) {
+        throw jsc::Exception(ctx, exception);
+    }
+
+    for (uint32_t i = 0; i < values.size(); i++) {
+        set_property(ctx, array, i, jsc::Value::from_number(ctx, values[i]));
+    }
+    return array;
+}
+
+// The contents are copied into an ArrayBuffer byte by byte, which the typed
+// array is then constructed over.
+template<>
+inline JSObjectRef jsc::Object::create_typed_array(JSContextRef ctx, TypedArrayType type, BinaryData bytes) {
+    JSObjectRef constructor = validated_get_constructor(ctx, JSContextGetGlobalObject(ctx), jsc::String(typed_array_name(type)));
+    JSValueRef buffer = jsc::Value::from_nonnull_binary(ctx, bytes);
+    JSValueRef exception = nullptr;
+    JSObjectRef array = JSObjectCallAsConstructor(ctx, constructor, 1, &buffer, &exception);
+    if (exception) {
+        throw jsc::Exception(ctx, exception);
+    }
+    return array;
+}
+
 template<>
 inline JSObjectRef jsc::Object::create_date(JSContextRef ctx, double time) {
     JSValueRef number = jsc::Value::from_number(ctx, time);
@@ -119,6 +151,12 @@ inline JSObjectRef jsc::Object::create_instance(JSContextRef ctx, typename Class
     return jsc::ObjectWrap<ClassType>::create_instance(ctx, internal);
 }
 
+template<>
+template<typename ClassType>
+inline JSObjectRef jsc::Object::create_instance_by_schema(JSContextRef ctx, const ObjectSchema&, typename ClassType::Internal* internal) {
+    return jsc::ObjectWrap<ClassType>::create_instance(ctx, internal);
+}
+
 template<>
 template<typename ClassType>
 inline bool jsc::Object::is_instance(JSContextRef ctx, const JSObjectRef &object) {
@@ -82,6 +82,12 @@ class Protected<JSValueRef> {
     operator bool() const {
         return m_value != nullptr;
     }
+    bool operator==(const Protected<JSValueRef> &other) const {
+        return m_value == other.m_value;
+    }
+    bool operator!=(const Protected<JSValueRef> &other) const {
+        return m_value != other.m_value;
+    }
     
     struct Comparator {
         bool operator() (const Protected<JSValueRef>& a, const Protected<JSValueRef>& b) const {
@@ -119,5 +125,23 @@ class Protected<JSObjectRef> : public Protected<JSValueRef> {
     }
 };
 
+// The public JavaScriptCore API has no weak references, and an object may be
+// unreachable well before its finalizer runs, so it can't be tracked safely.
+template<>
+class Weak<JSObjectRef> {
+  public:
+    static constexpr bool supported = false;
+
+    Weak(JSContextRef, JSObjectRef) {}
+
+    bool get(JSContextRef, JSObjectRef &) const {
+        return false;
+    }
+
+    bool expired() const {
+        return true;
+    }
+};
+
 } // js
 } // realm
@@ -20,6 +20,10 @@
 
 #include "jsc_types.hpp"
 
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+
 namespace realm {
 namespace js {
 
@@ -28,14 +32,18 @@ class String<jsc::Types> {
     using StringType = String<jsc::Types>;
 
     JSStringRef m_str;
+    // Set when the UTF-8 form of the string was already known, or once it
+    // has been asked for.
+    mutable util::Optional<std::string> m_utf8;
 
   public:
     String(const char *s) : m_str(JSStringCreateWithUTF8CString(s)) {}
     String(const JSStringRef &s) : m_str(JSStringRetain(s)) {}
+    String(const JSStringRef &s, std::string utf8) : m_str(JSStringRetain(s)), m_utf8(std::move(utf8)) {}
     String(StringData str) : String(str.data()) {}
     String(const std::string& str) : String(str.c_str()) {}
-    String(const StringType &o) : String(o.m_str) {}
-    String(StringType &&o) : m_str(o.m_str) {
+    String(const StringType &o) : m_str(JSStringRetain(o.m_str)), m_utf8(o.m_utf8) {}
+    String(StringType &&o) : m_str(o.m_str), m_utf8(std::move(o.m_utf8)) {
         o.m_str = nullptr;
     }
     ~String() {
@@ -44,17 +52,100 @@ class String<jsc::Types> {
         }
     }
 
+    // Interned strings share a JSStringRef which is created once and kept
+    // for the lifetime of the process.
+    static StringType intern(const std::string& str) {
+        static std::mutex s_mutex;
+        static std::unordered_map<std::string, JSStringRef> s_strings;
+
+        std::lock_guard<std::mutex> lock(s_mutex);
+        auto& interned = s_strings[str];
+        if (!interned) {
+            interned = JSStringCreateWithUTF8CString(str.c_str());
+        }
+        return StringType(interned);
+    }
+
     operator JSStringRef() const {
         return m_str;
     }
     operator std::string() const {
+        if (m_utf8) {
+            return *m_utf8;
+        }
         size_t max_size = JSStringGetMaximumUTF8CStringSize(m_str);
         std::string string;
         string.resize(max_size);
         string.resize(JSStringGetUTF8CString(m_str, &string[0], max_size) - 1);
         return string;
     }
+    StringData data() const {
+        if (!m_utf8) {
+            m_utf8 = static_cast<std::string>(*this);
+        }
+        return StringData(m_utf8->data(), m_utf8->size());
+    }
 };
-    
+
 } // js
+
+namespace jsc {
+
+// Remembers the UTF-8 form of the property names recently passed to a
+// property callback, so that reading the same property again doesn't convert
+// its name from UTF-16. JSC may or may not hand the same JSStringRef for the
+// same name, so entries are found by the name's characters, and the string
+// of an entry is retained so that its pointer can't be reused by another.
+class PropertyNameCache {
+  public:
+    PropertyNameCache() = default;
+    PropertyNameCache(PropertyNameCache const&) = delete;
+    PropertyNameCache& operator=(PropertyNameCache const&) = delete;
+
+    ~PropertyNameCache() {
+        for (auto& entry : m_entries) {
+            if (entry.string) {
+                JSStringRelease(entry.string);
+            }
+        }
+    }
+
+    std::string const& get(JSStringRef property) {
+        size_t length = JSStringGetLength(property);
+        const JSChar* characters = JSStringGetCharactersPtr(property);
+
+        // FNV-1a over the UTF-16 code units.
+        size_t hash = 2166136261u;
+        for (size_t i = 0; i < length; ++i) {
+            hash = (hash ^ characters[i]) * 16777619u;
+        }
+
+        Entry& entry = m_entries[hash % size];
+        if (entry.string == property) {
+            return entry.name;
+        }
+        if (!entry.string || JSStringGetLength(entry.string) != length ||
+            std::memcmp(JSStringGetCharactersPtr(entry.string), characters, length * sizeof(JSChar)) != 0) {
+            entry.name = js::String<Types>(property);
+        }
+        JSStringRetain(property);
+        if (entry.string) {
+            JSStringRelease(entry.string);
+        }
+        entry.string = property;
+        return entry.name;
+    }
+
+  private:
+    static constexpr size_t size = 64;
+
+    struct Entry {
+        JSStringRef string = nullptr;
+        std::string name;
+    };
+
+    Entry m_entries[size];
+};
+
+} // jsc
 } // realm
@@ -46,6 +46,24 @@ bool jsc::Value::is_binary(JSContextRef ctx, const JSValueRef &value)
     return false;
 }
 
+template<>
+bool jsc::Value::get_typed_array_type(JSContextRef ctx, const JSValueRef &value, TypedArrayType &type)
+{
+    if (!JSValueIsObject(ctx, value)) {
+        return false;
+    }
+    JSObjectRef global_object = JSContextGetGlobalObject(ctx);
+    for (auto candidate : {TypedArrayType::Int8, TypedArrayType::Uint8, TypedArrayType::Int16, TypedArrayType::Uint16,
+                           TypedArrayType::Int32, TypedArrayType::Uint32, TypedArrayType::Float32, TypedArrayType::Float64}) {
+        JSObjectRef constructor = jsc::Object::validated_get_constructor(ctx, global_object, jsc::String(typed_array_name(candidate)));
+        if (JSValueIsInstanceOfConstructor(ctx, value, constructor, nullptr)) {
+            type = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
 template<>
 JSValueRef jsc::Value::from_nonnull_binary(JSContextRef ctx, BinaryData data)
 {
@@ -22,6 +22,8 @@
 #include "jsc_types.hpp"
 #include "jsc_string.hpp"
 
+#include <realm/util/utf8.hpp>
+
 namespace realm {
 namespace js {
 
@@ -143,6 +145,30 @@ inline JSValueRef jsc::Value::from_nonnull_string(JSContextRef ctx, const jsc::S
     return JSValueMakeString(ctx, string);
 }
 
+// ASCII is widened to UTF-16 directly, and other strings are decoded from
+// their known size rather than measured again as C strings.
+template<>
+inline JSValueRef jsc::Value::from_nonnull_string_data(JSContextRef ctx, StringData string) {
+    std::vector<JSChar> characters;
+    if (is_ascii(string.data(), string.size())) {
+        characters.assign(string.data(), string.data() + string.size());
+    }
+    else {
+        // UTF-16 never takes more code units than UTF-8 takes bytes.
+        std::vector<char16_t> utf16(string.size());
+        const char* in = string.data();
+        char16_t* out = utf16.data();
+        if (!util::Utf8x16<char16_t>::to_utf16(in, string.data() + string.size(), out, out + utf16.size())) {
+            throw std::runtime_error("Invalid UTF-8 string.");
+        }
+        characters.assign(utf16.data(), out);
+    }
+    JSStringRef chars = JSStringCreateWithCharacters(characters.data(), characters.size());
+    JSValueRef value = JSValueMakeString(ctx, chars);
+    JSStringRelease(chars);
+    return value;
+}
+
 template<>
 inline JSValueRef jsc::Value::from_undefined(JSContextRef ctx) {
     return JSValueMakeUndefined(ctx);
@@ -226,5 +252,14 @@ inline JSObjectRef jsc::Value::to_function(JSContextRef ctx, const JSValueRef &v
 template<>
 OwnedBinaryData jsc::Value::to_binary(JSContextRef ctx, JSValueRef value);
 
+template<>
+bool jsc::Value::get_typed_array_type(JSContextRef ctx, const JSValueRef &value, TypedArrayType &type);
+
+template<>
+inline bool jsc::Value::to_binary_view(JSContextRef, const JSValueRef &, BinaryData &) {
+    // Typed array contents can't be referenced directly through the public API.
+    return false;
+}
+
 } // js
 } // realm
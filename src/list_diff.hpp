@@ -0,0 +1,176 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2020 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <realm/utilities.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace realm {
+namespace js {
+
+// The edits which turn one list into another, keeping as many of its
+// elements in place as possible. They are applied in order: the deletions,
+// then the moves, then the insertions.
+struct ListDiff {
+    // Indices in the old list, from the highest down.
+    std::vector<size_t> deletions;
+    // Pairs of indices to move an element from and to, each taking the
+    // moves before it into account, as List::move() does.
+    std::vector<std::pair<size_t, size_t>> moves;
+    // Indices in the new list, from the lowest up.
+    std::vector<size_t> insertions;
+    // For each index in the new list, the index of the element of the old
+    // list it is, or npos if it is inserted.
+    std::vector<size_t> matches;
+};
+
+// Elements with the same key are the same element. When a key appears more
+// than once, its elements are paired up in the order they appear in.
+template<typename Key, typename Hash = std::hash<Key>>
+ListDiff diff_lists(std::vector<Key> const& from, std::vector<Key> const& to) {
+    ListDiff diff;
+
+    std::unordered_map<Key, std::deque<size_t>, Hash> unmatched;
+    for (size_t i = 0; i < from.size(); ++i) {
+        unmatched[from[i]].push_back(i);
+    }
+    std::vector<bool> kept(from.size(), false);
+    diff.matches.resize(to.size(), npos);
+    for (size_t i = 0; i < to.size(); ++i) {
+        auto it = unmatched.find(to[i]);
+        if (it == unmatched.end() || it->second.empty()) {
+            diff.insertions.push_back(i);
+            continue;
+        }
+        diff.matches[i] = it->second.front();
+        kept[it->second.front()] = true;
+        it->second.pop_front();
+    }
+    for (size_t i = from.size(); i > 0; --i) {
+        if (!kept[i - 1]) {
+            diff.deletions.push_back(i - 1);
+        }
+    }
+
+    // The elements left after the deletions, in the order of the new list.
+    std::vector<size_t> order;
+    for (size_t match : diff.matches) {
+        if (match != npos) {
+            order.push_back(match);
+        }
+    }
+
+    // The longest run of them which is already in order stays where it is,
+    // and every other one is moved once.
+    std::vector<size_t> tails, previous(order.size(), npos);
+    for (size_t i = 0; i < order.size(); ++i) {
+        auto tail = std::lower_bound(tails.begin(), tails.end(), i, [&](size_t a, size_t b) {
+            return order[a] < order[b];
+        });
+        if (tail != tails.begin()) {
+            previous[i] = *(tail - 1);
+        }
+        if (tail == tails.end()) {
+            tails.push_back(i);
+        }
+        else {
+            *tail = i;
+        }
+    }
+    std::vector<bool> in_place(order.size(), false);
+    for (size_t i = tails.empty() ? npos : tails.back(); i != npos; i = previous[i]) {
+        in_place[i] = true;
+    }
+
+    // Each element which isn't in place is moved to just after the one
+    // which comes before it in the new list, which by then is where it
+    // belongs relative to the others which have been placed. The elements
+    // between two which stay in place therefore end up in a run after the
+    // first of them, so the slot each element is in before and after its
+    // move is known up front. The slots are the run at the front, then each
+    // element of the old list followed by the run after it, and the indices
+    // of the moves are counted over them with a Fenwick tree.
+    std::vector<size_t> anchor(order.size()), run_index(order.size());
+    // The length of the run at the front, then of the run after each element.
+    std::vector<size_t> run_length(from.size() + 1, 0);
+    size_t current_anchor = 0, run = 0;
+    for (size_t i = 0; i < order.size(); ++i) {
+        if (in_place[i]) {
+            current_anchor = order[i] + 1;
+            run = 0;
+            continue;
+        }
+        anchor[i] = current_anchor;
+        run_index[i] = run++;
+        run_length[current_anchor] = run;
+    }
+
+    std::vector<size_t> own_slot(from.size()), run_start(from.size() + 1);
+    size_t slot_count = run_length[0];
+    for (size_t i = 0; i < from.size(); ++i) {
+        own_slot[i] = slot_count++;
+        run_start[i + 1] = slot_count;
+        slot_count += run_length[i + 1];
+    }
+
+    std::vector<size_t> tree(slot_count + 1, 0);
+    auto add = [&](size_t slot, int delta) {
+        for (size_t i = slot + 1; i < tree.size(); i += i & (~i + 1)) {
+            tree[i] += delta;
+        }
+    };
+    // The number of occupied slots before the given one.
+    auto count_before = [&](size_t slot) {
+        size_t count = 0;
+        for (size_t i = slot; i > 0; i -= i & (~i + 1)) {
+            count += tree[i];
+        }
+        return count;
+    };
+    for (size_t i = 0; i < from.size(); ++i) {
+        if (kept[i]) {
+            add(own_slot[i], 1);
+        }
+    }
+
+    for (size_t i = 0; i < order.size(); ++i) {
+        if (in_place[i]) {
+            continue;
+        }
+        size_t source = count_before(own_slot[order[i]]);
+        add(own_slot[order[i]], -1);
+        size_t slot = run_start[anchor[i]] + run_index[i];
+        size_t destination = count_before(slot);
+        add(slot, 1);
+        if (source != destination) {
+            diff.moves.emplace_back(source, destination);
+        }
+    }
+    return diff;
+}
+
+} // js
+} // realm
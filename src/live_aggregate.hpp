@@ -0,0 +1,218 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2020 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "js_util.hpp"
+
+#include "collection_notifications.hpp"
+
+#include <realm/util/optional.hpp>
+
+#include <functional>
+#include <vector>
+
+namespace realm {
+namespace js {
+
+// An aggregate over a property of a live collection, kept up to date from the
+// collection's change sets instead of being computed over the whole
+// collection again. The value of each row is kept, so that deleted and
+// modified rows can be taken out of the aggregate.
+class LiveAggregate {
+  public:
+    using Value = util::Optional<double>;
+    // Reads the property of the row at an index of the collection.
+    using Reader = std::function<Value(size_t)>;
+
+    explicit LiveAggregate(AggregateFunc func) : m_func(func) {}
+
+    bool is_initialized() const {
+        return m_initialized;
+    }
+
+    Value value() const {
+        switch (m_func) {
+            case AggregateFunc::Sum:
+                return m_sum;
+            case AggregateFunc::Avg:
+                return m_count ? Value(m_sum / m_count) : util::none;
+            case AggregateFunc::Min:
+            case AggregateFunc::Max:
+                return m_extreme;
+        }
+        return util::none;
+    }
+
+    // Reads the value of every row.
+    void reset(size_t size, Reader const& read) {
+        m_values.clear();
+        m_values.reserve(size);
+        for (size_t i = 0; i < size; ++i) {
+            m_values.push_back(read(i));
+        }
+        recompute();
+        m_initialized = true;
+    }
+
+    // Returns true if the change set couldn't be applied incrementally, and
+    // the aggregate had to be computed over every row again.
+    bool apply(CollectionChangeSet const& changes, size_t size, Reader const& read) {
+        // Deletions and modifications are given as indices before the
+        // change, and insertions as indices after it. Moved rows are both
+        // deleted and inserted.
+        if (!changes.deletions.empty()) {
+            auto deleted = changes.deletions.as_indexes();
+            auto next = deleted.begin();
+            size_t kept = 0;
+            for (size_t i = 0; i < m_values.size(); ++i) {
+                if (next != deleted.end() && *next == i) {
+                    remove(m_values[i]);
+                    ++next;
+                    continue;
+                }
+                m_values[kept++] = m_values[i];
+            }
+            if (next != deleted.end()) {
+                reset(size, read);
+                return true;
+            }
+            m_values.resize(kept);
+        }
+
+        if (!changes.insertions.empty()) {
+            auto inserted = changes.insertions.as_indexes();
+            if (*inserted.begin() >= m_values.size()) {
+                // Rows added at the end don't move the others.
+                for (auto index : inserted) {
+                    if (index != m_values.size()) {
+                        reset(size, read);
+                        return true;
+                    }
+                    m_values.push_back(read(index));
+                    add(m_values.back());
+                }
+            }
+            else {
+                std::vector<Value> merged;
+                merged.reserve(m_values.size() + changes.insertions.count());
+                size_t from = 0;
+                for (auto index : inserted) {
+                    while (merged.size() < index && from < m_values.size()) {
+                        merged.push_back(m_values[from++]);
+                    }
+                    if (merged.size() != index) {
+                        reset(size, read);
+                        return true;
+                    }
+                    merged.push_back(read(index));
+                    add(merged.back());
+                }
+                merged.insert(merged.end(), m_values.begin() + from, m_values.end());
+                m_values.swap(merged);
+            }
+        }
+
+        for (auto index : changes.modifications_new.as_indexes()) {
+            if (index >= m_values.size()) {
+                reset(size, read);
+                return true;
+            }
+            replace(m_values[index], read(index));
+        }
+
+        if (m_values.size() != size) {
+            reset(size, read);
+            return true;
+        }
+        // The current minimum or maximum was taken out, and the next one can
+        // only be found among all of the rows.
+        if (m_extreme_lost) {
+            recompute();
+            return true;
+        }
+        return false;
+    }
+
+  private:
+    const AggregateFunc m_func;
+    std::vector<Value> m_values;
+    double m_sum = 0;
+    size_t m_count = 0;
+    Value m_extreme;
+    bool m_extreme_lost = false;
+    bool m_initialized = false;
+
+    bool is_extreme() const {
+        return m_func == AggregateFunc::Min || m_func == AggregateFunc::Max;
+    }
+
+    bool is_better(double value, double than) const {
+        return m_func == AggregateFunc::Min ? value < than : value > than;
+    }
+
+    void add(Value value) {
+        if (!value) {
+            return;
+        }
+        m_sum += *value;
+        ++m_count;
+        if (is_extreme() && !m_extreme_lost && (!m_extreme || is_better(*value, *m_extreme))) {
+            m_extreme = value;
+        }
+    }
+
+    void remove(Value value) {
+        if (!value) {
+            return;
+        }
+        m_sum -= *value;
+        --m_count;
+        if (is_extreme() && m_extreme && *value == *m_extreme) {
+            m_extreme_lost = true;
+        }
+    }
+
+    void replace(Value& old_value, Value new_value) {
+        // A minimum or maximum which is changed to a value at least as good
+        // is still the minimum or maximum.
+        if (is_extreme() && old_value && new_value && m_extreme && *old_value == *m_extreme
+            && !is_better(*m_extreme, *new_value)) {
+            m_sum += *new_value - *old_value;
+            m_extreme = new_value;
+        }
+        else {
+            remove(old_value);
+            add(new_value);
+        }
+        old_value = new_value;
+    }
+
+    void recompute() {
+        m_sum = 0;
+        m_count = 0;
+        m_extreme = util::none;
+        m_extreme_lost = false;
+        for (auto& value : m_values) {
+            add(value);
+        }
+    }
+};
+
+} // js
+} // realm
@@ -0,0 +1,141 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2020 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "shared_realm.hpp"
+
+#include <realm/group_shared.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+
+namespace realm {
+namespace js {
+
+// The wrappers of a Realm's results, lists and objects which are alive, and
+// the listeners registered on them. The counts are shared with the wrappers,
+// which may outlive the Realm's binding context.
+struct LiveWrapperCounts {
+    std::atomic<size_t> results{0};
+    std::atomic<size_t> lists{0};
+    std::atomic<size_t> objects{0};
+    std::atomic<size_t> listeners{0};
+};
+
+// A member of the internal object of each wrapper, which counts the wrapper
+// for as long as it lives. The owner reports the number of its listeners
+// whenever it changes them.
+template<std::atomic<size_t> LiveWrapperCounts::*Counter>
+class LiveWrapper {
+  public:
+    LiveWrapper(std::shared_ptr<LiveWrapperCounts> counts) : m_counts(std::move(counts)) {
+        if (m_counts) {
+            ++((*m_counts).*Counter);
+        }
+    }
+    // The listeners aren't copied along with their owner, but are moved.
+    LiveWrapper(LiveWrapper const& other) : LiveWrapper(other.m_counts) {}
+    LiveWrapper(LiveWrapper&& other) : LiveWrapper(other.m_counts) {
+        set_listeners(other.m_listeners);
+        other.set_listeners(0);
+    }
+    LiveWrapper& operator=(LiveWrapper const&) {
+        return *this;
+    }
+    LiveWrapper& operator=(LiveWrapper&& other) {
+        size_t listeners = other.m_listeners;
+        other.set_listeners(0);
+        set_listeners(listeners);
+        return *this;
+    }
+    ~LiveWrapper() {
+        set_listeners(0);
+        if (m_counts) {
+            --((*m_counts).*Counter);
+        }
+    }
+
+    void set_listeners(size_t listeners) {
+        if (m_counts) {
+            m_counts->listeners += listeners;
+            m_counts->listeners -= m_listeners;
+        }
+        m_listeners = listeners;
+    }
+
+  private:
+    std::shared_ptr<LiveWrapperCounts> m_counts;
+    size_t m_listeners = 0;
+};
+
+// Reads how many versions of a Realm file are kept for its readers, from the
+// Realm's own SharedGroup. Reading the number doesn't begin a transaction, so
+// the Realm isn't advanced and no other SharedGroup holds the file open, which
+// would keep compact() from doing anything. Only local Realms on disk can be
+// watched.
+class PinnedVersionsWatcher {
+  public:
+    PinnedVersionsWatcher(uint64_t threshold = 0) : m_threshold(threshold) {}
+
+    static void validate(Realm::Config const& config) {
+        if (config.in_memory) {
+            throw std::logic_error("Cannot read the versions of an in-memory Realm.");
+        }
+        if (config.immutable()) {
+            throw std::logic_error("Cannot read the versions of a read-only Realm.");
+        }
+#if REALM_ENABLE_SYNC
+        if (config.sync_config) {
+            throw std::logic_error("Cannot read the versions of a synchronized Realm.");
+        }
+#endif
+    }
+
+    static bool can_watch(Realm::Config const& config) {
+#if REALM_ENABLE_SYNC
+        if (config.sync_config) {
+            return false;
+        }
+#endif
+        return !config.in_memory && !config.immutable();
+    }
+
+    static uint64_t versions(Realm& realm) {
+        return _impl::RealmFriend::get_shared_group(realm).get_number_of_versions();
+    }
+
+    // Returns true if the number of versions went above the threshold since
+    // the previous check.
+    bool check(Realm& realm, uint64_t& versions) {
+        versions = PinnedVersionsWatcher::versions(realm);
+        bool above = versions > m_threshold;
+        bool crossed = above && !m_above;
+        m_above = above;
+        return crossed;
+    }
+
+  private:
+    uint64_t m_threshold;
+    bool m_above = false;
+};
+
+} // js
+} // realm
@@ -0,0 +1,179 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2020 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "collection_notifications.hpp"
+
+#include <realm/binary_data.hpp>
+#include <realm/util/optional.hpp>
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace realm {
+namespace js {
+
+// The binary form of a serialized change notification: the notification as
+// the global notifier serializes it, optionally followed by the change sets
+// of its tables. Each index set is written as its ranges, each one as the
+// distance from the end of the one before it and its length, so that runs of
+// indices take a few bytes however long they are. All numbers are varints.
+namespace change_set_codec {
+
+using ChangeSets = std::unordered_map<std::string, CollectionChangeSet>;
+
+constexpr uint8_t format_version = 1;
+
+inline void write_varint(std::vector<char>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(char(uint8_t(value) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(char(uint8_t(value)));
+}
+
+inline void write_string(std::vector<char>& out, std::string const& value) {
+    write_varint(out, value.size());
+    out.insert(out.end(), value.begin(), value.end());
+}
+
+inline void write_index_set(std::vector<char>& out, IndexSet const& indices) {
+    size_t ranges = 0;
+    for (auto it = indices.begin(); it != indices.end(); ++it) {
+        ++ranges;
+    }
+    write_varint(out, ranges);
+    size_t previous_end = 0;
+    for (auto range : indices) {
+        write_varint(out, range.first - previous_end);
+        write_varint(out, range.second - range.first);
+        previous_end = range.second;
+    }
+}
+
+// Reads from a serialized notification in place.
+class Reader {
+  public:
+    explicit Reader(BinaryData data) : m_position(data.data()), m_end(data.data() + data.size()) {}
+
+    bool at_end() const {
+        return m_position == m_end;
+    }
+
+    uint8_t read_byte() {
+        if (m_position == m_end) {
+            throw std::invalid_argument("The serialized change set is truncated.");
+        }
+        return uint8_t(*m_position++);
+    }
+
+    uint64_t read_varint() {
+        uint64_t value = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            uint8_t byte = read_byte();
+            value |= uint64_t(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) {
+                return value;
+            }
+        }
+        throw std::invalid_argument("The serialized change set is corrupt.");
+    }
+
+    std::string read_string() {
+        uint64_t size = read_varint();
+        if (size > uint64_t(m_end - m_position)) {
+            throw std::invalid_argument("The serialized change set is truncated.");
+        }
+        std::string value(m_position, size_t(size));
+        m_position += size;
+        return value;
+    }
+
+    IndexSet read_index_set() {
+        IndexSet indices;
+        uint64_t ranges = read_varint();
+        size_t end = 0;
+        for (uint64_t i = 0; i < ranges; ++i) {
+            size_t begin = end + size_t(read_varint());
+            size_t length = size_t(read_varint());
+            if (begin < end || begin + length < begin) {
+                throw std::invalid_argument("The serialized change set is corrupt.");
+            }
+            // The ranges are in order, so inserting each one at its position
+            // doesn't shift any of those before it.
+            indices.insert_at(begin, length);
+            end = begin + length;
+        }
+        return indices;
+    }
+
+  private:
+    const char* m_position;
+    const char* m_end;
+};
+
+inline std::vector<char> encode(std::string const& notification, ChangeSets const* changes) {
+    std::vector<char> out;
+    out.push_back(char(format_version));
+    write_string(out, notification);
+    out.push_back(char(changes ? 1 : 0));
+    if (changes) {
+        write_varint(out, changes->size());
+        for (auto const& pair : *changes) {
+            write_string(out, pair.first);
+            write_index_set(out, pair.second.deletions);
+            write_index_set(out, pair.second.insertions);
+            write_index_set(out, pair.second.modifications);
+            write_index_set(out, pair.second.modifications_new);
+        }
+    }
+    return out;
+}
+
+// Returns the notification as the global notifier serialized it, and sets
+// `changes` if they were written along with it.
+inline std::string decode(BinaryData data, util::Optional<ChangeSets>& changes) {
+    Reader reader(data);
+    if (reader.read_byte() != format_version) {
+        throw std::invalid_argument("Unsupported serialized change set format.");
+    }
+    std::string notification = reader.read_string();
+    if (reader.read_byte()) {
+        changes.emplace();
+        uint64_t count = reader.read_varint();
+        for (uint64_t i = 0; i < count; ++i) {
+            auto& change_set = (*changes)[reader.read_string()];
+            change_set.deletions = reader.read_index_set();
+            change_set.insertions = reader.read_index_set();
+            change_set.modifications = reader.read_index_set();
+            change_set.modifications_new = reader.read_index_set();
+        }
+    }
+    if (!reader.at_end()) {
+        throw std::invalid_argument("The serialized change set is corrupt.");
+    }
+    return notification;
+}
+
+} // namespace change_set_codec
+} // js
+} // realm
@@ -0,0 +1,148 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2020 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace realm {
+namespace js {
+
+// Splits the json array which the adapter encodes a changeset as into chunks
+// of at most a given number of instructions, each of which is a json array
+// of its own. Only the nesting of the json is scanned, so that each chunk can
+// be converted to JS objects separately, and those of the chunks before it
+// collected meanwhile.
+class ChangesetChunker {
+  public:
+    explicit ChangesetChunker(std::vector<char> json) : m_json(std::move(json)) {
+        m_position = skip_whitespace(0);
+        if (m_position == m_json.size() || m_json[m_position] != '[') {
+            throw std::runtime_error("Expected the changeset to be a json array.");
+        }
+        m_position = skip_whitespace(m_position + 1);
+        if (m_position < m_json.size() && m_json[m_position] == ']') {
+            m_position = m_json.size();
+        }
+    }
+
+    bool done() const {
+        return m_position >= m_json.size();
+    }
+
+    // Returns the next chunk as a json array, or an empty string once every
+    // instruction has been returned.
+    std::string next(size_t max_instructions) {
+        if (done()) {
+            return {};
+        }
+        size_t start = m_position;
+        size_t end = start;
+        for (size_t count = 0; count < max_instructions && !done(); ++count) {
+            end = skip_value(m_position);
+            m_position = skip_whitespace(end);
+            if (m_position == m_json.size()) {
+                throw std::runtime_error("Unexpected end of the changeset json.");
+            }
+            if (m_json[m_position] == ']') {
+                m_position = m_json.size();
+            }
+            else if (m_json[m_position] == ',') {
+                m_position = skip_whitespace(m_position + 1);
+            }
+            else {
+                throw std::runtime_error("Unexpected character in the changeset json.");
+            }
+        }
+
+        std::string chunk;
+        chunk.reserve(end - start + 2);
+        chunk += '[';
+        chunk.append(m_json.data() + start, end - start);
+        chunk += ']';
+        return chunk;
+    }
+
+  private:
+    std::vector<char> m_json;
+    size_t m_position;
+
+    size_t skip_whitespace(size_t position) const {
+        while (position < m_json.size() && (m_json[position] == ' ' || m_json[position] == '\n' ||
+                                            m_json[position] == '\r' || m_json[position] == '\t')) {
+            ++position;
+        }
+        return position;
+    }
+
+    // Returns the position just past the value which starts at `position`.
+    size_t skip_value(size_t position) const {
+        size_t depth = 0;
+        bool in_string = false;
+        for (; position < m_json.size(); ++position) {
+            char c = m_json[position];
+            if (in_string) {
+                if (c == '\\') {
+                    ++position;
+                }
+                else if (c == '"') {
+                    in_string = false;
+                    if (depth == 0) {
+                        return position + 1;
+                    }
+                }
+                continue;
+            }
+            switch (c) {
+                case '"':
+                    in_string = true;
+                    break;
+                case '{':
+                case '[':
+                    ++depth;
+                    break;
+                case '}':
+                case ']':
+                    if (depth == 0) {
+                        return position;
+                    }
+                    if (--depth == 0) {
+                        return position + 1;
+                    }
+                    break;
+                case ',':
+                    if (depth == 0) {
+                        return position;
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+        if (depth != 0 || in_string) {
+            throw std::runtime_error("Unexpected end of the changeset json.");
+        }
+        return position;
+    }
+};
+
+} // js
+} // realm
@@ -20,8 +20,10 @@
 
 #include "server/adapter.hpp"
 
+#include "changeset_chunker.hpp"
 #include "js_class.hpp"
 #include "js_sync.hpp"
+#include "js_realm_path_filter.hpp"
 
 #include <json.hpp>
 #include <future>
@@ -82,18 +84,35 @@ void AdapterClass<T>::constructor(ContextType ctx, ObjectType this_object, Argum
         throw std::runtime_error("User needs to be an admin.");
     }
 
-    std::function<bool(const std::string&)> predicate;
+    // Declarative filters are evaluated on the sync thread. A predicate
+    // function has to wait for the event loop, so it is only called for paths
+    // the declarative part of the filter didn't accept, once per path.
+    std::shared_ptr<RealmPathFilter> filter;
     if (Value::is_string(ctx, arguments[3])) {
-        std::string regex_string = Value::to_string(ctx, arguments[3]);
-        predicate = [regex = std::regex(regex_string)](const std::string& realm_path) {
-            return std::regex_match(realm_path, regex);
-        };
+        filter = std::make_shared<RealmPathFilter>(RealmPathFilter::with_full_match(Value::to_string(ctx, arguments[3])));
     } else if (Value::is_function(ctx, arguments[3])) {
         Protected<FunctionType> js_predicate(ctx, Value::to_function(ctx, arguments[3]));
-        predicate = JSPredicateFunctor<T>(protected_ctx, protected_this, js_predicate);
+        filter = std::make_shared<RealmPathFilter>();
+        filter->set_predicate(JSPredicateFunctor<T>(protected_ctx, protected_this, js_predicate));
+    } else if (Value::is_object(ctx, arguments[3])) {
+        static const String predicate_string = "predicate";
+
+        ObjectType filter_object = Value::to_object(ctx, arguments[3]);
+        filter = std::make_shared<RealmPathFilter>(validated_realm_path_filter<T>(ctx, filter_object));
+        auto predicate_value = Object::get_property(ctx, filter_object, predicate_string);
+        if (!Value::is_undefined(ctx, predicate_value)) {
+            Protected<FunctionType> js_predicate(ctx, Value::validated_to_function(ctx, predicate_value, "predicate"));
+            filter->set_predicate(JSPredicateFunctor<T>(protected_ctx, protected_this, js_predicate));
+        }
+        else if (!filter->is_declarative()) {
+            throw std::runtime_error("Expected filter to specify a regex, prefixes, glob or a predicate function.");
+        }
     } else {
-        throw std::runtime_error("Expected filter to be a regular expression string or a predicate function.");
+        throw std::runtime_error("Expected filter to be a regular expression string, a declarative filter or a predicate function.");
     }
+    std::function<bool(const std::string&)> predicate = [filter](const std::string& realm_path) {
+        return (*filter)(realm_path);
+    };
 
     Protected<FunctionType> user_callback(ctx, Value::validated_to_function(ctx, arguments[4], "callback"));
 
@@ -270,28 +289,118 @@ private:
                                                            : Value::from_number(m_ctx, val));
     }
 };
+
+template<typename T>
+typename T::Object convert_changeset_to_js(typename T::Context ctx, const char* begin, const char* end) {
+    ConvertToJS<T> sax_handler(ctx);
+    nlohmann::json::sax_parse(begin, end, &sax_handler);
+    return sax_handler.result_array();
+}
 } // anonymous namespace
 
+// The instructions of a changeset which haven't been converted yet. It owns
+// a copy of the changeset, so advancing the adapter doesn't affect it.
+struct ChangesetChunks {
+    ChangesetChunker chunker;
+    size_t chunk_size;
+};
+
+template<typename T>
+class ChangesetChunksClass : public ClassDefinition<T, ChangesetChunks> {
+    using ContextType = typename T::Context;
+    using ObjectType = typename T::Object;
+    using Object = js::Object<T>;
+    using ReturnValue = js::ReturnValue<T>;
+    using Arguments = js::Arguments<T>;
+
+public:
+    std::string const name = "ChangesetChunks";
+
+    static ObjectType create_instance(ContextType ctx, ChangesetChunks* chunks) {
+        return create_object<T, ChangesetChunksClass<T>>(ctx, chunks);
+    }
+
+    // Returns the next array of instructions, or undefined once they have
+    // all been returned.
+    static void next(ContextType ctx, ObjectType this_object, Arguments& arguments, ReturnValue &ret) {
+        arguments.validate_count(0);
+        auto chunks = get_internal<T, ChangesetChunksClass<T>>(this_object);
+        std::string chunk = chunks->chunker.next(chunks->chunk_size);
+        if (chunk.empty()) {
+            ret.set_undefined();
+            return;
+        }
+        ret.set(convert_changeset_to_js<T>(ctx, chunk.data(), chunk.data() + chunk.size()));
+    }
+
+    MethodMap<T> const methods = {
+        {"next", wrap<next>},
+    };
+};
+
 template<typename T>
 void AdapterClass<T>::current(ContextType ctx, ObjectType this_object, Arguments& arguments, ReturnValue &ret) {
-    arguments.validate_count(1);
+    static const String raw_string = "raw";
+
+    arguments.validate_between(1, 2);
     auto adapter = get_internal<T, AdapterClass<T>>(this_object);
     auto change_set = adapter->current(Value::validated_to_string(ctx, arguments[0]));
+
+    bool raw = false;
+    if (arguments.count == 2 && !Value::is_undefined(ctx, arguments[1])) {
+        ObjectType options = Value::validated_to_object(ctx, arguments[1], "options");
+        ValueType raw_value = Object::get_property(ctx, options, raw_string);
+        raw = !Value::is_undefined(ctx, raw_value) && Value::validated_to_boolean(ctx, raw_value, "raw");
+    }
+
     if (!change_set) {
         ret.set_undefined();
         return;
     }
+    if (raw) {
+        ret.set(Value::from_binary(ctx, BinaryData(change_set->data(), change_set->size())));
+        return;
+    }
+    ret.set(convert_changeset_to_js<T>(ctx, change_set->data(), change_set->data() + change_set->size()));
+}
 
-    ConvertToJS<T> sax_handler(ctx);
-    nlohmann::json::sax_parse(change_set->data(), change_set->data() + change_set->size(), &sax_handler);
-    ret.set(sax_handler.result_array());
+template<typename T>
+void AdapterClass<T>::current_chunks(ContextType ctx, ObjectType this_object, Arguments& arguments, ReturnValue &ret) {
+    arguments.validate_count(2);
+    auto adapter = get_internal<T, AdapterClass<T>>(this_object);
+    auto change_set = adapter->current(Value::validated_to_string(ctx, arguments[0]));
+    double chunk_size = Value::validated_to_number(ctx, arguments[1], "chunkSize");
+    if (!(chunk_size >= 1) || chunk_size != size_t(chunk_size)) {
+        throw std::invalid_argument("The chunk size must be a positive integer.");
+    }
+    if (!change_set) {
+        ret.set_undefined();
+        return;
+    }
+
+    std::vector<char> json(change_set->data(), change_set->data() + change_set->size());
+    auto chunks = new ChangesetChunks{ChangesetChunker(std::move(json)), size_t(chunk_size)};
+    ret.set(ChangesetChunksClass<T>::create_instance(ctx, chunks));
 }
 
 template<typename T>
 void AdapterClass<T>::advance(ContextType ctx, ObjectType this_object, Arguments& arguments, ReturnValue &ret) {
-    arguments.validate_count(1);
+    arguments.validate_between(1, 2);
     auto adapter = get_internal<T, AdapterClass<T>>(this_object);
-    adapter->advance(Value::validated_to_string(ctx, arguments[0]));
+    auto path = Value::validated_to_string(ctx, arguments[0]);
+
+    size_t count = 1;
+    if (arguments.count == 2) {
+        double value = Value::validated_to_number(ctx, arguments[1], "count");
+        if (!(value >= 1) || value != size_t(value)) {
+            throw std::invalid_argument("The number of changesets to advance by must be a positive integer.");
+        }
+        count = size_t(value);
+    }
+    // Advancing when there is no changeset left does nothing.
+    for (size_t i = 0; i < count; ++i) {
+        adapter->advance(path);
+    }
 }
 
 template<typename T>
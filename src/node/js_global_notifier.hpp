@@ -20,21 +20,193 @@
 
 #include "server/global_notifier.hpp"
 
+#include "change_set_codec.hpp"
 #include "js_class.hpp"
+#include "js_realm_path_filter.hpp"
 
 #include <json.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
 namespace realm {
 namespace js {
 
+// A fixed set of threads, started on first use and reused for every batch,
+// which compute change sets next to the JavaScript thread.
+class ChangeWorkerPool {
+  public:
+    static ChangeWorkerPool& shared() {
+        static ChangeWorkerPool s_pool(std::min(7u, std::max(1u, std::thread::hardware_concurrency()) - 1));
+        return s_pool;
+    }
+
+    ~ChangeWorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_task_ready.notify_all();
+        for (auto& thread : m_threads) {
+            thread.join();
+        }
+    }
+
+    size_t size() const {
+        return m_threads.size();
+    }
+
+    // Runs `work` on the calling thread and on `count` of the pool's threads,
+    // and returns once all of them are done, rethrowing the first exception.
+    void run(size_t count, const std::function<void()>& work) {
+        std::mutex done_mutex;
+        std::condition_variable done;
+        size_t remaining = count;
+        std::exception_ptr error;
+
+        auto task = [&] {
+            std::exception_ptr task_error;
+            try {
+                work();
+            }
+            catch (...) {
+                task_error = std::current_exception();
+            }
+            std::lock_guard<std::mutex> lock(done_mutex);
+            if (task_error && !error) {
+                error = task_error;
+            }
+            if (--remaining == 0) {
+                done.notify_all();
+            }
+        };
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (size_t i = 0; i < count; ++i) {
+                m_tasks.push_back(task);
+            }
+        }
+        m_task_ready.notify_all();
+
+        std::exception_ptr caller_error;
+        try {
+            work();
+        }
+        catch (...) {
+            caller_error = std::current_exception();
+        }
+
+        std::unique_lock<std::mutex> lock(done_mutex);
+        done.wait(lock, [&] { return remaining == 0; });
+        if (caller_error) {
+            std::rethrow_exception(caller_error);
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+  private:
+    std::mutex m_mutex;
+    std::condition_variable m_task_ready;
+    std::deque<std::function<void()>> m_tasks;
+    bool m_stopping = false;
+    std::vector<std::thread> m_threads;
+
+    explicit ChangeWorkerPool(size_t thread_count) {
+        m_threads.reserve(thread_count);
+        for (size_t i = 0; i < thread_count; ++i) {
+            m_threads.emplace_back([this] { run_tasks(); });
+        }
+    }
+
+    void run_tasks() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_task_ready.wait(lock, [&] { return m_stopping || !m_tasks.empty(); });
+                if (m_stopping) {
+                    return;
+                }
+                task = std::move(m_tasks.front());
+                m_tasks.pop_front();
+            }
+            task();
+        }
+    }
+};
+
 template<typename T>
 class RealmClass;
 
+// A change notification which may have been deserialized together with its
+// changes, which then aren't computed again. The Realms it is for are wrapped
+// the first time they are read, and the same wrappers are returned after.
 template<typename T>
-class ChangeObject : public ClassDefinition<T, GlobalNotifier::ChangeNotification> {
+struct ChangeNotification : GlobalNotifier::ChangeNotification {
+    explicit ChangeNotification(GlobalNotifier::ChangeNotification&& notification)
+    : GlobalNotifier::ChangeNotification(std::move(notification)) {}
+
+    ChangeNotification(std::string const& serialized, util::Optional<change_set_codec::ChangeSets> changes)
+    : GlobalNotifier::ChangeNotification(serialized), m_decoded_changes(std::move(changes)) {}
+
+    change_set_codec::ChangeSets const& changes() {
+        return m_decoded_changes ? *m_decoded_changes : get_changes();
+    }
+
+    typename T::Object realm(typename T::Context ctx) {
+        return wrap_realm(ctx, m_realm, [this] { return get_new_realm(); });
+    }
+
+    typename T::Object old_realm(typename T::Context ctx) {
+        return wrap_realm(ctx, m_old_realm, [this] { return m_old_shared_realm = get_old_realm(); });
+    }
+
+    // Closes the old version of the Realm if it was opened, so that it isn't
+    // kept by a wrapper which outlives the notification.
+    void close() {
+        if (m_old_shared_realm) {
+            m_old_shared_realm->close();
+            m_old_shared_realm.reset();
+        }
+        m_old_realm = util::none;
+    }
+
+  private:
+    util::Optional<change_set_codec::ChangeSets> m_decoded_changes;
+    util::Optional<Protected<typename T::Object>> m_realm;
+    util::Optional<Protected<typename T::Object>> m_old_realm;
+    SharedRealm m_old_shared_realm;
+
+    template<typename Open>
+    typename T::Object wrap_realm(typename T::Context ctx, util::Optional<Protected<typename T::Object>>& wrapper, Open&& open) {
+        if (!wrapper) {
+            SharedRealm realm = open();
+            realm->m_binding_context.reset(new RealmDelegate<T>(realm, Context<T>::get_global_context(ctx)));
+            wrapper = Protected<typename T::Object>(ctx, create_object<T, RealmClass<T>>(ctx, new SharedRealm(realm)));
+        }
+        return *wrapper;
+    }
+};
+
+template<typename T>
+class ChangeObject : public ClassDefinition<T, ChangeNotification<T>> {
     using ContextType = typename T::Context;
     using ObjectType = typename T::Object;
+    using ValueType = typename T::Value;
+    using String = js::String<T>;
     using Object = js::Object<T>;
+    using Value = js::Value<T>;
     using ReturnValue = js::ReturnValue<T>;
     using Arguments = js::Arguments<T>;
 
@@ -51,7 +223,7 @@ public:
     static void close(ContextType, ObjectType, Arguments &, ReturnValue &);
     static void serialize(ContextType, ObjectType, Arguments &, ReturnValue &);
 
-    static GlobalNotifier::ChangeNotification& validated_get(ObjectType object);
+    static ChangeNotification<T>& validated_get(ObjectType object);
 
     PropertyMap<T> const properties = {
         {"path", {wrap<get_path>, nullptr}},
@@ -69,7 +241,7 @@ public:
 };
 
 template<typename T>
-GlobalNotifier::ChangeNotification& ChangeObject<T>::validated_get(ObjectType object) {
+ChangeNotification<T>& ChangeObject<T>::validated_get(ObjectType object) {
     auto changes = get_internal<T, ChangeObject<T>>(object);
     if (!changes) {
         throw std::runtime_error("Can only access notification changesets within a notification callback");
@@ -89,22 +261,17 @@ void ChangeObject<T>::get_event(ContextType ctx, ObjectType object, ReturnValue
 
 template<typename T>
 void ChangeObject<T>::get_realm(ContextType ctx, ObjectType object, ReturnValue &return_value) {
-    auto realm = validated_get(object).get_new_realm();
-    realm->m_binding_context.reset(new RealmDelegate<T>(realm, Context<T>::get_global_context(ctx)));
-    return_value.set(create_object<T, RealmClass<T>>(ctx, new SharedRealm(realm)));
+    return_value.set(validated_get(object).realm(ctx));
 }
 
 template<typename T>
 void ChangeObject<T>::get_old_realm(ContextType ctx, ObjectType object, ReturnValue &return_value) {
-    auto realm = validated_get(object).get_old_realm();
-    realm->m_binding_context.reset(new RealmDelegate<T>(realm, Context<T>::get_global_context(ctx)));
-    return_value.set(create_object<T, RealmClass<T>>(ctx, new SharedRealm(realm)));
+    return_value.set(validated_get(object).old_realm(ctx));
 }
 
 template<typename T>
 void ChangeObject<T>::get_changes(ContextType ctx, ObjectType object, ReturnValue &return_value) {
-    auto& changes = validated_get(object);
-    auto& change_set = changes.get_changes();
+    auto& change_set = validated_get(object).changes();
     ObjectType change_object = Object::create_empty(ctx);
     for (auto& pair : change_set) {
         Object::set_property(ctx, change_object, pair.first, CollectionClass<T>::create_collection_change_set(ctx, pair.second));
@@ -114,17 +281,47 @@ void ChangeObject<T>::get_changes(ContextType ctx, ObjectType object, ReturnValu
 
 template<typename T>
 void ChangeObject<T>::get_empty(ContextType ctx, ObjectType object, ReturnValue &return_value) {
-    return_value.set(validated_get(object).get_changes().empty());
+    return_value.set(validated_get(object).changes().empty());
 }
 
 template<typename T>
 void ChangeObject<T>::close(ContextType, ObjectType object, Arguments &, ReturnValue &) {
+    if (auto notification = get_internal<T, ChangeObject<T>>(object)) {
+        notification->close();
+    }
     set_internal<T, ChangeObject<T>>(object, nullptr);
 }
 
 template<typename T>
-void ChangeObject<T>::serialize(ContextType, ObjectType object, Arguments &, ReturnValue &return_value) {
-    return_value.set(validated_get(object).serialize());
+void ChangeObject<T>::serialize(ContextType ctx, ObjectType object, Arguments &args, ReturnValue &return_value) {
+    static const String binary_string = "binary";
+    static const String include_changes_string = "includeChanges";
+
+    args.validate_maximum(1);
+    auto& notification = validated_get(object);
+
+    bool binary = false;
+    bool include_changes = false;
+    if (args.count == 1 && !Value::is_undefined(ctx, args[0])) {
+        ObjectType options = Value::validated_to_object(ctx, args[0], "options");
+        ValueType binary_value = Object::get_property(ctx, options, binary_string);
+        binary = !Value::is_undefined(ctx, binary_value) && Value::validated_to_boolean(ctx, binary_value, "binary");
+        ValueType include_changes_value = Object::get_property(ctx, options, include_changes_string);
+        include_changes = !Value::is_undefined(ctx, include_changes_value) &&
+                          Value::validated_to_boolean(ctx, include_changes_value, "includeChanges");
+        if (include_changes && !binary) {
+            throw std::invalid_argument("Changes can only be included in the binary form.");
+        }
+    }
+
+    if (!binary) {
+        return_value.set(notification.serialize());
+        return;
+    }
+    // Deletions have no changes to include.
+    bool has_changes = include_changes && notification.type == GlobalNotifier::ChangeNotification::Type::Change;
+    auto bytes = change_set_codec::encode(notification.serialize(), has_changes ? &notification.changes() : nullptr);
+    return_value.set(Value::from_binary(ctx, BinaryData(bytes.data(), bytes.size())));
 }
 
 template<typename T>
@@ -139,8 +336,8 @@ class GlobalNotifierCallback : public realm::GlobalNotifier::Callback {
     using Function = js::Function<T>;
 
 public:
-    GlobalNotifierCallback(ContextType ctx, Protected<FunctionType> callback)
-    : m_ctx(Context<T>::get_global_context(ctx)), m_callback(callback) {}
+    GlobalNotifierCallback(ContextType ctx, Protected<FunctionType> callback, std::shared_ptr<ListenerFilters> filters)
+    : m_ctx(Context<T>::get_global_context(ctx)), m_callback(callback), m_filters(std::move(filters)) {}
 
     void download_complete() override;
     void error(std::exception_ptr) override;
@@ -151,6 +348,7 @@ public:
 private:
     Protected<GlobalContextType> m_ctx;
     Protected<FunctionType> m_callback;
+    std::shared_ptr<ListenerFilters> m_filters;
 };
 
 template<typename T>
@@ -163,14 +361,28 @@ void GlobalNotifierCallback<T>::realm_changed(GlobalNotifier* notifier) {
 
 template<typename T>
 bool GlobalNotifierCallback<T>::realm_available(StringData id, StringData virtual_path) {
+    // Realms the filters of all listeners reject are never reported to
+    // JavaScript, and the others are reported to the accepting listeners.
+    auto listener_ids = m_filters->accepting(virtual_path);
+    if (listener_ids.empty()) {
+        return false;
+    }
+
     HANDLESCOPE
 
+    std::vector<ValueType> ids;
+    ids.reserve(listener_ids.size());
+    for (auto listener_id : listener_ids) {
+        ids.push_back(Value::from_number(m_ctx, listener_id));
+    }
+
     ValueType arguments[] = {
         Value::from_string(m_ctx, "available"),
         Value::from_string(m_ctx, virtual_path.data()),
-        Value::from_string(m_ctx, id.data())
+        Value::from_string(m_ctx, id.data()),
+        Object::create_array(m_ctx, ids)
     };
-    ValueType ret = Function::callback(m_ctx, m_callback, Object::create_empty(m_ctx), 3, arguments);
+    ValueType ret = Function::callback(m_ctx, m_callback, Object::create_empty(m_ctx), 4, arguments);
     return Value::to_boolean(m_ctx, ret);
 }
 
@@ -193,6 +405,50 @@ void GlobalNotifierCallback<T>::error(std::exception_ptr err) {
     }
 }
 
+// The filters of the listeners of a global notifier, registered by the
+// listeners as they are added. Only declarative filters are supported, as
+// the notifier reports available Realms on the JavaScript thread.
+template<typename T>
+class ListenerFiltersClass : public ClassDefinition<T, std::shared_ptr<ListenerFilters>> {
+    using ContextType = typename T::Context;
+    using ObjectType = typename T::Object;
+    using Value = js::Value<T>;
+    using ReturnValue = js::ReturnValue<T>;
+    using Arguments = js::Arguments<T>;
+
+public:
+    std::string const name = "ListenerFilters";
+
+    static void add(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void remove(ContextType, ObjectType, Arguments &, ReturnValue &);
+
+    MethodMap<T> const methods = {
+        {"add", wrap<add>},
+        {"remove", wrap<remove>},
+    };
+};
+
+template<typename T>
+void ListenerFiltersClass<T>::add(ContextType ctx, ObjectType object, Arguments &args, ReturnValue &return_value) {
+    args.validate_maximum(1);
+    std::shared_ptr<RealmPathFilter> filter;
+    if (!Value::is_undefined(ctx, args[0])) {
+        filter = std::make_shared<RealmPathFilter>(validated_realm_path_filter<T>(ctx, Value::validated_to_object(ctx, args[0], "filter")));
+        if (!filter->is_declarative()) {
+            throw std::runtime_error("Expected filter to specify a regex, prefixes or glob.");
+        }
+    }
+    auto filters = *get_internal<T, ListenerFiltersClass<T>>(object);
+    return_value.set((double)filters->add(std::move(filter)));
+}
+
+template<typename T>
+void ListenerFiltersClass<T>::remove(ContextType ctx, ObjectType object, Arguments &args, ReturnValue &) {
+    args.validate_count(1);
+    auto filters = *get_internal<T, ListenerFiltersClass<T>>(object);
+    filters->remove((uint64_t)Value::validated_to_number(ctx, args[0], "id"));
+}
+
 template<typename T>
 class GlobalNotifierClass : public ClassDefinition<T, GlobalNotifier> {
     using ContextType = typename T::Context;
@@ -208,13 +464,18 @@ public:
 
     static void start(ContextType, ObjectType, Arguments &, ReturnValue &);
     static void next(ContextType, ObjectType, Arguments &, ReturnValue &);
+    static void next_batch(ContextType, ObjectType, Arguments &, ReturnValue &);
     static void close(ContextType, ObjectType, Arguments &, ReturnValue &);
 
     MethodMap<T> const methods = {
         {"start", wrap<start>},
         {"next", wrap<next>},
+        {"nextBatch", wrap<next_batch>},
         {"close", wrap<close>},
     };
+
+    // private
+    static void calculate_changes(const std::vector<GlobalNotifier::ChangeNotification*>&);
 };
 
 template<typename T>
@@ -229,8 +490,100 @@ void GlobalNotifierClass<T>::next(ContextType ctx, ObjectType object, Arguments
         return;
     }
     if (auto next = self->next_changed_realm()) {
-        return_value.set(create_object<T, ChangeObject<T>>(ctx, new GlobalNotifier::ChangeNotification(std::move(*next))));
+        return_value.set(create_object<T, ChangeObject<T>>(ctx, new ChangeNotification<T>(std::move(*next))));
+    }
+}
+
+template<typename T>
+void GlobalNotifierClass<T>::next_batch(ContextType ctx, ObjectType object, Arguments &args, ReturnValue &return_value) {
+    args.validate_between(1, 2);
+    auto self = get_internal<T, GlobalNotifierClass<T>>(object);
+    if (!self) {
+        return;
+    }
+
+    double max_count = Value<T>::validated_to_number(ctx, args[0], "maxCount");
+    if (max_count < 1) {
+        throw std::invalid_argument("'maxCount' must be at least 1.");
+    }
+
+    // Changes to any class are wanted if no or an empty list of class names
+    // is given.
+    std::unordered_set<std::string> class_names;
+    if (!Value<T>::is_undefined(ctx, args[1])) {
+        auto array = Value<T>::validated_to_array(ctx, args[1], "classNames");
+        uint32_t count = Object::validated_get_length(ctx, array);
+        for (uint32_t i = 0; i < count; ++i) {
+            class_names.insert(std::string(Object::validated_get_string(ctx, array, i)));
+        }
+    }
+    bool filtered = !class_names.empty();
+
+    std::vector<std::unique_ptr<ChangeNotification<T>>> notifications;
+    while (notifications.size() < max_count) {
+        auto next = self->next_changed_realm();
+        if (!next) {
+            break;
+        }
+        notifications.emplace_back(new ChangeNotification<T>(std::move(*next)));
+    }
+
+    std::vector<GlobalNotifier::ChangeNotification*> changed;
+    for (auto& notification : notifications) {
+        if (notification->type == GlobalNotifier::ChangeNotification::Type::Change) {
+            changed.push_back(notification.get());
+        }
+    }
+    calculate_changes(changed);
+
+    std::vector<typename T::Value> values;
+    values.reserve(notifications.size());
+    for (auto& notification : notifications) {
+        if (filtered && notification->type == GlobalNotifier::ChangeNotification::Type::Change) {
+            auto& change_set = notification->get_changes();
+            bool relevant = std::any_of(change_set.begin(), change_set.end(), [&](auto& pair) {
+                return class_names.count(pair.first) != 0;
+            });
+            if (!relevant) {
+                continue;
+            }
+        }
+        values.push_back(create_object<T, ChangeObject<T>>(ctx, notification.release()));
+    }
+    return_value.set(Object::create_array(ctx, values));
+}
+
+// Computes the change sets of a batch of notifications on the threads of the
+// shared pool, so that the JavaScript thread only waits for the slowest Realm
+// rather than for all of them in turn. Notifications for the same Realm are
+// computed in order on one thread.
+template<typename T>
+void GlobalNotifierClass<T>::calculate_changes(const std::vector<GlobalNotifier::ChangeNotification*>& notifications) {
+    std::vector<std::vector<GlobalNotifier::ChangeNotification*>> groups;
+    std::unordered_map<std::string, size_t> group_for_path;
+    for (auto notification : notifications) {
+        auto it = group_for_path.emplace(notification->realm_path, groups.size()).first;
+        if (it->second == groups.size()) {
+            groups.emplace_back();
+        }
+        groups[it->second].push_back(notification);
+    }
+
+    std::atomic<size_t> next_group{0};
+    auto work = [&] {
+        for (size_t i = next_group++; i < groups.size(); i = next_group++) {
+            for (auto notification : groups[i]) {
+                notification->get_changes();
+            }
+        }
+    };
+
+    if (groups.size() <= 1) {
+        work();
+        return;
     }
+    auto& pool = ChangeWorkerPool::shared();
+    pool.run(std::min(groups.size() - 1, pool.size()), work);
 }
 
 template<typename T>
@@ -0,0 +1,278 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2020 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "js_types.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <regex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace realm {
+namespace js {
+
+// Decides which Realm paths are observed by an Adapter or the global
+// notifier. The declarative criteria (a regular expression, path prefixes and
+// glob patterns) are evaluated natively on whichever thread asks, and a path
+// is accepted if it matches any of them. The predicate is only consulted for
+// paths none of them accepted. Results are memoized per path, for up to
+// `max_results` paths at a time.
+//
+// Globs match `*` and `?` within one path component and `**` across
+// components, so `/~/*/settings` matches `/~/123/settings` only.
+class RealmPathFilter {
+public:
+    using Predicate = std::function<bool(const std::string&)>;
+
+    // Matches the whole path against a regular expression string, which is
+    // how a filter string has always been interpreted by the Adapter.
+    static RealmPathFilter with_full_match(const std::string& regex) {
+        RealmPathFilter filter;
+        filter.set_regex(regex, std::regex::ECMAScript, true);
+        return filter;
+    }
+
+    RealmPathFilter() = default;
+    RealmPathFilter(RealmPathFilter&& other)
+    : m_regex(std::move(other.m_regex))
+    , m_full_match(other.m_full_match)
+    , m_prefixes(std::move(other.m_prefixes))
+    , m_globs(std::move(other.m_globs))
+    , m_predicate(std::move(other.m_predicate))
+    {
+    }
+
+    bool operator()(const std::string& path) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_results.find(path);
+            if (it != m_results.end()) {
+                return it->second;
+            }
+        }
+
+        // The predicate may call into JavaScript, so the lock isn't held.
+        bool result = matches(path);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_results.size() >= max_results) {
+            // Paths which are filtered again are rare once a server has
+            // been scanned, so the memo starts over rather than tracking use.
+            m_results.clear();
+        }
+        m_results.emplace(path, result);
+        return result;
+    }
+
+    bool is_declarative() const {
+        return m_regex || !m_prefixes.empty() || !m_globs.empty();
+    }
+
+    void set_regex(const std::string& regex, std::regex::flag_type flags, bool full_match) {
+        try {
+            m_regex = std::regex(regex, flags | std::regex::optimize);
+        }
+        catch (std::regex_error const& e) {
+            throw std::invalid_argument(util::format("Invalid Realm path filter '%1': %2", regex, e.what()));
+        }
+        m_full_match = full_match;
+    }
+
+    void add_prefix(std::string prefix) {
+        m_prefixes.push_back(std::move(prefix));
+    }
+
+    void add_glob(std::string glob) {
+        m_globs.push_back(std::move(glob));
+    }
+
+    void set_predicate(Predicate predicate) {
+        m_predicate = std::move(predicate);
+    }
+
+    static bool glob_match(const char* pattern, const char* path) {
+        while (*pattern) {
+            if (pattern[0] == '*' && pattern[1] == '*') {
+                pattern += 2;
+                for (const char* rest = path; ; ++rest) {
+                    if (glob_match(pattern, rest)) {
+                        return true;
+                    }
+                    if (!*rest) {
+                        return false;
+                    }
+                }
+            }
+            if (*pattern == '*') {
+                ++pattern;
+                for (const char* rest = path; ; ++rest) {
+                    if (glob_match(pattern, rest)) {
+                        return true;
+                    }
+                    if (!*rest || *rest == '/') {
+                        return false;
+                    }
+                }
+            }
+            if (!*path || (*pattern == '?' ? *path == '/' : *pattern != *path)) {
+                return false;
+            }
+            ++pattern;
+            ++path;
+        }
+        return !*path;
+    }
+
+private:
+    static constexpr size_t max_results = 4096;
+
+    util::Optional<std::regex> m_regex;
+    bool m_full_match = false;
+    std::vector<std::string> m_prefixes;
+    std::vector<std::string> m_globs;
+    Predicate m_predicate;
+
+    std::mutex m_mutex;
+    std::unordered_map<std::string, bool> m_results;
+
+    bool matches(const std::string& path) const {
+        if (m_regex && (m_full_match ? std::regex_match(path, *m_regex) : std::regex_search(path, *m_regex))) {
+            return true;
+        }
+        for (auto& prefix : m_prefixes) {
+            if (path.compare(0, prefix.size(), prefix) == 0) {
+                return true;
+            }
+        }
+        for (auto& glob : m_globs) {
+            if (glob_match(glob.c_str(), path.c_str())) {
+                return true;
+            }
+        }
+        return m_predicate && m_predicate(path);
+    }
+};
+
+// The filters of the listeners sharing a global notifier. A Realm is reported
+// if the filter of any listener accepts it, together with the ids of those
+// listeners, so that each listener only sees the Realms its own filter
+// accepts. A listener without a filter accepts every Realm.
+class ListenerFilters {
+public:
+    uint64_t add(std::shared_ptr<RealmPathFilter> filter) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_filters.emplace_back(++m_last_id, std::move(filter));
+        return m_last_id;
+    }
+
+    void remove(uint64_t id) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_filters.erase(std::remove_if(m_filters.begin(), m_filters.end(), [&](auto& entry) {
+            return entry.first == id;
+        }), m_filters.end());
+    }
+
+    // The ids of the listeners whose filters accept `path`.
+    std::vector<uint64_t> accepting(const std::string& path) {
+        decltype(m_filters) filters;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            filters = m_filters;
+        }
+        std::vector<uint64_t> ids;
+        for (auto& entry : filters) {
+            if (!entry.second || (*entry.second)(path)) {
+                ids.push_back(entry.first);
+            }
+        }
+        return ids;
+    }
+
+private:
+    std::mutex m_mutex;
+    uint64_t m_last_id = 0;
+    std::vector<std::pair<uint64_t, std::shared_ptr<RealmPathFilter>>> m_filters;
+};
+
+// Reads a declarative filter: a RegExp, or an object with any of `regex` (a
+// string or RegExp), `prefixes` and `glob` (a string or an array of them).
+// A `predicate` property is left for the caller to handle.
+template<typename T>
+RealmPathFilter validated_realm_path_filter(typename T::Context ctx, typename T::Object object) {
+    using Object = js::Object<T>;
+    using Value = js::Value<T>;
+
+    static const String<T> source_string = "source";
+    static const String<T> ignore_case_string = "ignoreCase";
+    static const String<T> regex_string = "regex";
+    static const String<T> prefixes_string = "prefixes";
+    static const String<T> glob_string = "glob";
+
+    RealmPathFilter filter;
+
+    auto set_regex = [&](typename T::Value value) {
+        if (Value::is_string(ctx, value)) {
+            filter.set_regex(Value::to_string(ctx, value), std::regex::ECMAScript, false);
+            return;
+        }
+        auto regexp = Value::validated_to_object(ctx, value, "regex");
+        auto flags = std::regex::ECMAScript;
+        if (Value::to_boolean(ctx, Object::get_property(ctx, regexp, ignore_case_string))) {
+            flags |= std::regex::icase;
+        }
+        filter.set_regex(Object::validated_get_string(ctx, regexp, source_string, "regex"), flags, false);
+    };
+
+    auto for_each_string = [&](const String<T>& name, const char* description, auto&& add) {
+        auto value = Object::get_property(ctx, object, name);
+        if (Value::is_undefined(ctx, value)) {
+            return;
+        }
+        if (Value::is_string(ctx, value)) {
+            add(Value::to_string(ctx, value));
+            return;
+        }
+        auto array = Value::validated_to_array(ctx, value, description);
+        uint32_t count = Object::validated_get_length(ctx, array);
+        for (uint32_t i = 0; i < count; ++i) {
+            add(Object::validated_get_string(ctx, array, i, description));
+        }
+    };
+
+    if (Value::is_string(ctx, Object::get_property(ctx, object, source_string))) {
+        set_regex(object);
+        return filter;
+    }
+
+    auto regex_value = Object::get_property(ctx, object, regex_string);
+    if (!Value::is_undefined(ctx, regex_value)) {
+        set_regex(regex_value);
+    }
+    for_each_string(prefixes_string, "prefixes", [&](std::string prefix) { filter.add_prefix(std::move(prefix)); });
+    for_each_string(glob_string, "glob", [&](std::string glob) { filter.add_glob(std::move(glob)); });
+    return filter;
+}
+
+} // js
+} // realm
@@ -0,0 +1,54 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2020 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "node_init.hpp"
+
+#include "js_benchmarks.hpp"
+#if REALM_ENABLE_SYNC
+#include "js_adapter.hpp"
+#endif
+
+#include <cstdlib>
+#include <new>
+
+// The module is linked so that these are the operators which the binding and
+// core call, while node and V8 keep their own.
+void* operator new(size_t size) {
+    realm::js::benchmarks::count_allocation();
+    if (void* pointer = std::malloc(size ? size : 1)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+namespace realm {
+namespace node {
+
+static void init(v8::Local<v8::Object> exports, v8::Local<v8::Value> module,
+                 v8::Local<v8::Context> context) {
+    Nan::SetMethod(exports, "run", js::wrap<js::benchmarks::run<Types, Nan::HandleScope>>);
+}
+
+} // node
+} // realm
+
+NODE_MODULE_CONTEXT_AWARE(RealmBenchmarks, realm::node::init);
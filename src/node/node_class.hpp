@@ -20,9 +20,15 @@
 
 #include "node_types.hpp"
 
+#include "boundary_stats.hpp"
 #include "js_class.hpp"
 #include "js_util.hpp"
 
+#include "object_schema.hpp"
+
+#include <memory>
+#include <unordered_map>
+
 namespace realm {
 namespace node {
 
@@ -44,10 +50,16 @@ class ObjectWrap : public Nan::ObjectWrap {
   public:
     static v8::Local<v8::Function> create_constructor(v8::Isolate*);
     static v8::Local<v8::Object> create_instance(v8::Isolate*, Internal* = nullptr);
+    static v8::Local<v8::Object> create_instance_by_schema(v8::Isolate*, const ObjectSchema&, Internal* = nullptr);
 
     static v8::Local<v8::FunctionTemplate> get_template() {
-        static Nan::Persistent<v8::FunctionTemplate> js_template(create_template());
-        return Nan::New(js_template);
+        // Templates belong to the isolate they were created in.
+        static thread_local std::unique_ptr<Nan::Persistent<v8::FunctionTemplate>> js_template;
+        if (!js_template) {
+            js_template.reset(new Nan::Persistent<v8::FunctionTemplate>(create_template()));
+            IsolateCleanup::add([] { js_template.reset(); });
+        }
+        return Nan::New(*js_template);
     }
 
     static void construct(const Nan::FunctionCallbackInfo<v8::Value>&);
@@ -75,6 +87,8 @@ class ObjectWrap : public Nan::ObjectWrap {
     ObjectWrap(Internal* object = nullptr) : m_object(object) {}
 
     static v8::Local<v8::FunctionTemplate> create_template();
+    static v8::Local<v8::FunctionTemplate> get_schema_template(const ObjectSchema&);
+    static v8::Local<v8::FunctionTemplate> create_schema_template(const ObjectSchema&);
 
     static void setup_method(v8::Local<v8::FunctionTemplate>, const std::string &, Nan::FunctionCallback);
     static void setup_static_method(v8::Local<v8::FunctionTemplate>, const std::string &, Nan::FunctionCallback);
@@ -85,6 +99,11 @@ class ObjectWrap : public Nan::ObjectWrap {
     static void get_indexes(const Nan::PropertyCallbackInfo<v8::Array>&);
     static void set_property(v8::Local<v8::String>, v8::Local<v8::Value>, const v8::PropertyCallbackInfo<v8::Value>&);
 
+    static void get_schema_accessor(v8::Local<v8::String>, const Nan::PropertyCallbackInfo<v8::Value>&);
+    static void set_schema_accessor(v8::Local<v8::String>, v8::Local<v8::Value>, const Nan::PropertyCallbackInfo<void>&);
+    static void get_fallback_property(v8::Local<v8::Name>, const v8::PropertyCallbackInfo<v8::Value>&);
+    static void set_fallback_property(v8::Local<v8::Name>, v8::Local<v8::Value>, const v8::PropertyCallbackInfo<v8::Value>&);
+
     static void set_readonly_property(v8::Local<v8::String> property, v8::Local<v8::Value> value, const Nan::PropertyCallbackInfo<void>& info) {
         std::string message = std::string("Cannot assign to read only property '") + std::string(String(property)) + "'";
         Nan::ThrowError(message.c_str());
@@ -154,6 +173,86 @@ inline v8::Local<v8::Object> ObjectWrap<ClassType>::create_instance(v8::Isolate*
     return scope.Escape(instance);
 }
 
+template<typename ClassType>
+inline v8::Local<v8::Object> ObjectWrap<ClassType>::create_instance_by_schema(v8::Isolate* isolate, const ObjectSchema& object_schema, Internal* internal) {
+    Nan::EscapableHandleScope scope;
+
+    v8::Local<v8::FunctionTemplate> tpl = get_schema_template(object_schema);
+    v8::Local<v8::Object> instance = Nan::NewInstance(tpl->InstanceTemplate()).ToLocalChecked();
+
+    auto wrap = new ObjectWrap<ClassType>(internal);
+    wrap->Wrap(instance);
+
+    return scope.Escape(instance);
+}
+
+template<typename ClassType>
+inline v8::Local<v8::FunctionTemplate> ObjectWrap<ClassType>::get_schema_template(const ObjectSchema& object_schema) {
+    // Object schemas with the same name may have different properties in
+    // different Realms, and the accessors are bound to the position of the
+    // property in the schema, so the template is keyed on both.
+    std::string key = object_schema.name;
+    for (auto &prop : object_schema.persisted_properties) {
+        key += '\0';
+        key += prop.public_name.empty() ? prop.name : prop.public_name;
+    }
+    key += '\1';
+    for (auto &prop : object_schema.computed_properties) {
+        key += '\0';
+        key += prop.public_name.empty() ? prop.name : prop.public_name;
+    }
+
+    static thread_local std::unordered_map<std::string, std::unique_ptr<Nan::Persistent<v8::FunctionTemplate>>> s_schema_templates;
+    if (s_schema_templates.empty()) {
+        IsolateCleanup::add([] { s_schema_templates.clear(); });
+    }
+    auto &js_template = s_schema_templates[key];
+    if (!js_template) {
+        js_template.reset(new Nan::Persistent<v8::FunctionTemplate>(create_schema_template(object_schema)));
+    }
+    return Nan::New(*js_template);
+}
+
+template<typename ClassType>
+inline v8::Local<v8::FunctionTemplate> ObjectWrap<ClassType>::create_schema_template(const ObjectSchema& object_schema) {
+    Nan::EscapableHandleScope scope;
+
+    v8::Local<v8::FunctionTemplate> tpl = Nan::New<v8::FunctionTemplate>(construct);
+    v8::Local<v8::ObjectTemplate> instance_tpl = tpl->InstanceTemplate();
+
+    tpl->SetClassName(Nan::New(object_schema.name).ToLocalChecked());
+    tpl->Inherit(get_template());
+    instance_tpl->SetInternalFieldCount(1);
+
+    // One accessor per property gives every object of this schema the same
+    // hidden class, which lets V8 inline cache the property loads.
+    uint32_t slot = 0;
+    auto add_accessor = [&](const Property &prop) {
+        v8::Local<v8::String> prop_name = Nan::New(prop.public_name.empty() ? prop.name : prop.public_name).ToLocalChecked();
+        Nan::SetAccessor(instance_tpl, prop_name, get_schema_accessor, set_schema_accessor, Nan::New<v8::Integer>(slot++), v8::DEFAULT, v8::DontDelete);
+    };
+    for (auto &prop : object_schema.persisted_properties) {
+        add_accessor(prop);
+    }
+    for (auto &prop : object_schema.computed_properties) {
+        add_accessor(prop);
+    }
+
+#if REALM_JS_BOUNDARY_STATS
+    js::name_boundary_wrapper(&get_schema_accessor, s_class.name + "#get_schema_property");
+    js::name_boundary_wrapper(&set_schema_accessor, s_class.name + "#set_schema_property");
+#endif
+
+    // The interceptor stays as a fallback for any name not covered by the
+    // accessors above. Being non-masking it is only consulted for those.
+    if (s_class.string_accessor.getter) {
+        instance_tpl->SetHandler(v8::NamedPropertyHandlerConfiguration(get_fallback_property, set_fallback_property, nullptr, nullptr, nullptr,
+                                                                      v8::Local<v8::Value>(), v8::PropertyHandlerFlags::kNonMasking));
+    }
+
+    return scope.Escape(tpl);
+}
+
 template<typename ClassType>
 inline v8::Local<v8::FunctionTemplate> ObjectWrap<ClassType>::create_template() {
     Nan::EscapableHandleScope scope;
@@ -165,6 +264,10 @@ inline v8::Local<v8::FunctionTemplate> ObjectWrap<ClassType>::create_template()
     tpl->SetClassName(name);
     instance_tpl->SetInternalFieldCount(1);
 
+#if REALM_JS_BOUNDARY_STATS
+    js::name_boundary_wrappers(s_class);
+#endif
+
     v8::Local<v8::FunctionTemplate> super_tpl = ObjectWrap<ParentClassType>::get_template();
     if (!super_tpl.IsEmpty()) {
         tpl->Inherit(super_tpl);
@@ -289,6 +392,45 @@ inline void ObjectWrap<ClassType>::set_property(v8::Local<v8::String> property,
     }
 }
 
+template<typename ClassType>
+inline void ObjectWrap<ClassType>::get_schema_accessor(v8::Local<v8::String> property, const Nan::PropertyCallbackInfo<v8::Value>& info) {
+    v8::Isolate* isolate = info.GetIsolate();
+    node::ReturnValue return_value(info.GetReturnValue());
+    try {
+        REALM_JS_COUNT_BOUNDARY_CALL(Nan::GetterCallback, get_schema_accessor,
+            ClassType::get_schema_property(isolate, info.This(), Nan::To<uint32_t>(info.Data()).FromJust(), return_value));
+    }
+    catch (std::exception &e) {
+        Nan::ThrowError(node::Exception::value(isolate, e));
+    }
+}
+
+template<typename ClassType>
+inline void ObjectWrap<ClassType>::set_schema_accessor(v8::Local<v8::String> property, v8::Local<v8::Value> value, const Nan::PropertyCallbackInfo<void>& info) {
+    v8::Isolate* isolate = info.GetIsolate();
+    try {
+        REALM_JS_COUNT_BOUNDARY_CALL(Nan::SetterCallback, set_schema_accessor,
+            ClassType::set_schema_property(isolate, info.This(), Nan::To<uint32_t>(info.Data()).FromJust(), value));
+    }
+    catch (std::exception &e) {
+        Nan::ThrowError(node::Exception::value(isolate, e));
+    }
+}
+
+template<typename ClassType>
+inline void ObjectWrap<ClassType>::get_fallback_property(v8::Local<v8::Name> property, const v8::PropertyCallbackInfo<v8::Value>& info) {
+    if (property->IsString()) {
+        s_class.string_accessor.getter(property.As<v8::String>(), info);
+    }
+}
+
+template<typename ClassType>
+inline void ObjectWrap<ClassType>::set_fallback_property(v8::Local<v8::Name> property, v8::Local<v8::Value> value, const v8::PropertyCallbackInfo<v8::Value>& info) {
+    if (property->IsString()) {
+        set_property(property.As<v8::String>(), value, info);
+    }
+}
+
 } // node
 
 namespace js {
@@ -304,7 +446,7 @@ void wrap(const Nan::FunctionCallbackInfo<v8::Value>& info) {
     node::ReturnValue return_value(info.GetReturnValue());
 
     try {
-        F(isolate, info.This(), args, return_value);
+        REALM_JS_COUNT_BOUNDARY_CALL(node::Types::FunctionCallback, wrap<F>, F(isolate, info.This(), args, return_value));
     }
     catch (std::exception &e) {
         Nan::ThrowError(node::Exception::value(isolate, e));
@@ -317,7 +459,7 @@ void wrap(v8::Local<v8::String> property, const Nan::PropertyCallbackInfo<v8::Va
     v8::Isolate* isolate = info.GetIsolate();
     node::ReturnValue return_value(info.GetReturnValue());
     try {
-        F(isolate, info.This(), return_value);
+        REALM_JS_COUNT_BOUNDARY_CALL(node::Types::PropertyGetterCallback, wrap<F>, F(isolate, info.This(), return_value));
     }
     catch (std::exception &e) {
         Nan::ThrowError(node::Exception::value(isolate, e));
@@ -328,7 +470,7 @@ template<node::PropertyType::SetterType F>
 void wrap(v8::Local<v8::String> property, v8::Local<v8::Value> value, const Nan::PropertyCallbackInfo<void>& info) {
     v8::Isolate* isolate = info.GetIsolate();
     try {
-        F(isolate, info.This(), value);
+        REALM_JS_COUNT_BOUNDARY_CALL(node::Types::PropertySetterCallback, wrap<F>, F(isolate, info.This(), value));
     }
     catch (std::exception &e) {
         Nan::ThrowError(node::Exception::value(isolate, e));
@@ -340,7 +482,7 @@ void wrap(uint32_t index, const Nan::PropertyCallbackInfo<v8::Value>& info) {
     v8::Isolate* isolate = info.GetIsolate();
     node::ReturnValue return_value(info.GetReturnValue());
     try {
-        F(isolate, info.This(), index, return_value);
+        REALM_JS_COUNT_BOUNDARY_CALL(node::Types::IndexPropertyGetterCallback, wrap<F>, F(isolate, info.This(), index, return_value));
     }
     catch (std::out_of_range &) {
         // Out-of-bounds index getters should just return undefined in JS.
@@ -355,7 +497,9 @@ template<node::IndexPropertyType::SetterType F>
 void wrap(uint32_t index, v8::Local<v8::Value> value, const Nan::PropertyCallbackInfo<v8::Value>& info) {
     v8::Isolate* isolate = info.GetIsolate();
     try {
-        if (F(isolate, info.This(), index, value)) {
+        bool intercepted = false;
+        REALM_JS_COUNT_BOUNDARY_CALL(node::Types::IndexPropertySetterCallback, wrap<F>, intercepted = F(isolate, info.This(), index, value));
+        if (intercepted) {
             // Indicate that the property was intercepted.
             info.GetReturnValue().Set(value);
         }
@@ -370,7 +514,8 @@ void wrap(v8::Local<v8::String> property, const v8::PropertyCallbackInfo<v8::Val
     v8::Isolate* isolate = info.GetIsolate();
     node::ReturnValue return_value(info.GetReturnValue());
     try {
-        F(isolate, info.This(), property, return_value);
+        REALM_JS_COUNT_BOUNDARY_CALL(node::Types::StringPropertyGetterCallback, wrap<F>,
+            F(isolate, info.This(), node::String::from_property_name(property), return_value));
     }
     catch (std::exception &e) {
         Nan::ThrowError(node::Exception::value(isolate, e));
@@ -381,7 +526,10 @@ template<node::StringPropertyType::SetterType F>
 void wrap(v8::Local<v8::String> property, v8::Local<v8::Value> value, const v8::PropertyCallbackInfo<v8::Value>& info) {
     v8::Isolate* isolate = info.GetIsolate();
     try {
-        if (F(isolate, info.This(), property, value)) {
+        bool intercepted = false;
+        REALM_JS_COUNT_BOUNDARY_CALL(node::Types::StringPropertySetterCallback, wrap<F>,
+            intercepted = F(isolate, info.This(), node::String::from_property_name(property), value));
+        if (intercepted) {
             // Indicate that the property was intercepted.
             info.GetReturnValue().Set(value);
         }
@@ -393,7 +541,8 @@ void wrap(v8::Local<v8::String> property, v8::Local<v8::Value> value, const v8::
 
 template<node::StringPropertyType::EnumeratorType F>
 void wrap(const v8::PropertyCallbackInfo<v8::Array>& info) {
-    auto names = F(info.GetIsolate(), info.This());
+    std::vector<node::String> names;
+    REALM_JS_COUNT_BOUNDARY_CALL(node::Types::StringPropertyEnumeratorCallback, wrap<F>, names = F(info.GetIsolate(), info.This()));
     int count = (int)names.size();
     v8::Local<v8::Array> array = Nan::New<v8::Array>(count);
 
@@ -34,5 +34,16 @@ inline AbstractExecutionContextID node::Context::get_execution_context_id(v8::Is
     return reinterpret_cast<AbstractExecutionContextID>(isolate);
 }
 
+template<>
+inline void node::Context::add_cleanup(std::function<void()> cleanup) {
+    IsolateCleanup::add(std::move(cleanup));
+}
+
+template<>
+inline bool node::Context::delivers_notifications() {
+    // object-store signals the default loop, which worker threads don't run.
+    return Nan::GetCurrentEventLoop() == uv_default_loop();
+}
+
 } // js
 } // realm
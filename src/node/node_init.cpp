@@ -26,12 +26,28 @@
 namespace realm {
 namespace node {
 
+#if NODE_MAJOR_VERSION >= 11
+// Worker threads each load the module into an isolate of their own. Whatever
+// was kept for the isolate is released when its environment shuts down, and
+// the Realms opened in it are closed, as the isolate is gone by the time the
+// thread exits.
+static void cleanup(void*) {
+    Nan::HandleScope scope;
+    js::RealmDelegate<Types>::close_all();
+    IsolateCleanup::run();
+}
+#endif
+
 static void init(v8::Local<v8::Object> exports, v8::Local<v8::Value> module,
                  v8::Local<v8::Context> context) {
     v8::Isolate* isolate = context->GetIsolate();
     v8::Local<v8::Function> realm_constructor = js::RealmClass<Types>::create_constructor(isolate);
 
     Nan::Set(exports, realm_constructor->GetName(), realm_constructor);
+
+#if NODE_MAJOR_VERSION >= 11
+    ::node::AddEnvironmentCleanupHook(isolate, cleanup, nullptr);
+#endif
 }
 
 } // node
@@ -135,6 +135,36 @@ inline v8::Local<v8::Object> node::Object::create_array(v8::Isolate* isolate, ui
     return array;
 }
 
+template<>
+inline v8::Local<v8::Object> node::Object::create_int32_array(v8::Isolate* isolate, const std::vector<int32_t> &values) {
+    size_t byte_length = values.size() * sizeof(int32_t);
+    v8::Local<v8::ArrayBuffer> buffer = v8::ArrayBuffer::New(isolate, byte_length);
+    if (byte_length) {
+        memcpy(buffer->GetContents().Data(), values.data(), byte_length);
+    }
+    return v8::Int32Array::New(buffer, 0, values.size());
+}
+
+template<>
+inline v8::Local<v8::Object> node::Object::create_typed_array(v8::Isolate* isolate, TypedArrayType type, BinaryData bytes) {
+    v8::Local<v8::ArrayBuffer> buffer = v8::ArrayBuffer::New(isolate, bytes.size());
+    if (bytes.size()) {
+        memcpy(buffer->GetContents().Data(), bytes.data(), bytes.size());
+    }
+    size_t length = bytes.size() / typed_array_element_size(type);
+    switch (type) {
+        case TypedArrayType::Int8: return v8::Int8Array::New(buffer, 0, length);
+        case TypedArrayType::Uint8: return v8::Uint8Array::New(buffer, 0, length);
+        case TypedArrayType::Int16: return v8::Int16Array::New(buffer, 0, length);
+        case TypedArrayType::Uint16: return v8::Uint16Array::New(buffer, 0, length);
+        case TypedArrayType::Int32: return v8::Int32Array::New(buffer, 0, length);
+        case TypedArrayType::Uint32: return v8::Uint32Array::New(buffer, 0, length);
+        case TypedArrayType::Float32: return v8::Float32Array::New(buffer, 0, length);
+        case TypedArrayType::Float64: return v8::Float64Array::New(buffer, 0, length);
+    }
+    return v8::Float64Array::New(buffer, 0, length);
+}
+
 template<>
 inline v8::Local<v8::Object> node::Object::create_date(v8::Isolate* isolate, double time) {
     return Nan::New<v8::Date>(time).ToLocalChecked();
@@ -146,6 +176,12 @@ inline v8::Local<v8::Object> node::Object::create_instance(v8::Isolate* isolate,
     return node::ObjectWrap<ClassType>::create_instance(isolate, internal);
 }
 
+template<>
+template<typename ClassType>
+inline v8::Local<v8::Object> node::Object::create_instance_by_schema(v8::Isolate* isolate, const ObjectSchema& object_schema, typename ClassType::Internal* internal) {
+    return node::ObjectWrap<ClassType>::create_instance_by_schema(isolate, object_schema, internal);
+}
+
 template<>
 template<typename ClassType>
 inline bool node::Object::is_instance(v8::Isolate* isolate, const v8::Local<v8::Object> &object) {
@@ -23,6 +23,9 @@
 namespace realm {
 namespace node {
 
+// Each protected value holds its own persistent handle. Values are read far
+// more often than they are protected, and reading a handle needs no property
+// lookup, which the slots of a shared persistent array would.
 template<typename MemberType>
 class Protected {
     // TODO: Figure out why Nan::CopyablePersistentTraits causes a build failure.
@@ -36,7 +39,7 @@ class Protected {
         return Nan::New(m_value);
     }
     explicit operator bool() const {
-        return m_value.isEmpty();
+        return !m_value.IsEmpty();
     }
     bool operator==(const v8::Local<MemberType> &other) const {
         return m_value == other;
@@ -94,6 +97,30 @@ class Protected<node::Types::Function> : public node::Protected<v8::Function> {
     Protected(v8::Isolate* isolate, v8::Local<v8::Function> object) : node::Protected<v8::Function>(object) {}
 };
 
+template<>
+class Weak<node::Types::Object> {
+    v8::Global<v8::Object> m_value;
+
+  public:
+    static constexpr bool supported = true;
+
+    Weak(v8::Isolate* isolate, v8::Local<v8::Object> object) : m_value(isolate, object) {
+        m_value.SetWeak();
+    }
+
+    bool get(v8::Isolate* isolate, v8::Local<v8::Object> &object) const {
+        if (m_value.IsEmpty()) {
+            return false;
+        }
+        object = m_value.Get(isolate);
+        return true;
+    }
+
+    bool expired() const {
+        return m_value.IsEmpty();
+    }
+};
+
 template<typename T>
 struct GlobalCopyablePersistentTraits {
     typedef v8::Persistent<T, GlobalCopyablePersistentTraits<T>> CopyablePersistent;
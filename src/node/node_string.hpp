@@ -20,12 +20,97 @@
 
 #include "node_types.hpp"
 
+#include <memory>
+#include <unordered_map>
+
 namespace realm {
+namespace node {
+
+// `owner` is the table of the thread which interned the string. It is set
+// once and never changed, so other threads can compare it without locking.
+struct InternedString {
+    const void* owner;
+    std::string value;
+    Nan::Persistent<v8::String> handle;
+};
+
+// Schema property names and option keys cross the boundary over and over, so
+// they are kept as internalized V8 strings for each isolate. Strings coming
+// from V8 which have been interned are recognized by identity rather than
+// being re-encoded as UTF-8. Isolates never share a thread, so the tables
+// are thread local.
+//
+// Interned `String`s belong to the thread which interned them, so they are
+// interned for each call rather than kept in statics. Entries and tables are
+// never freed, as such a `String` may outlive its isolate. When the isolate
+// goes away only their handles are released, and the thread gets a new table
+// if it interns strings again, so entries of the old one are no longer owned
+// by any thread.
+class StringCache {
+    struct Table {
+        std::unordered_map<std::string, std::unique_ptr<InternedString>> by_value;
+        std::unordered_multimap<int, const InternedString*> by_hash;
+    };
+
+    static Table& table() {
+        static thread_local Table* s_table = nullptr;
+        if (!s_table) {
+            s_table = new Table;
+            IsolateCleanup::add([] {
+                for (auto& entry : s_table->by_value) {
+                    entry.second->handle.Reset();
+                }
+                s_table->by_hash.clear();
+                s_table = nullptr;
+            });
+        }
+        return *s_table;
+    }
+
+  public:
+    static const InternedString& intern(v8::Isolate* isolate, const std::string& value) {
+        auto& table = StringCache::table();
+        auto& interned = table.by_value[value];
+        if (!interned) {
+            v8::HandleScope scope(isolate);
+            auto handle = v8::String::NewFromUtf8(isolate, value.data(), v8::NewStringType::kInternalized, (int)value.size()).ToLocalChecked();
+            interned.reset(new InternedString{&table, value, {}});
+            interned->handle.Reset(handle);
+            table.by_hash.emplace(handle->GetIdentityHash(), interned.get());
+        }
+        return *interned;
+    }
+
+    // Whether the handle of `interned` belongs to the calling thread.
+    static bool owns(const InternedString& interned) {
+        return interned.owner == &table();
+    }
+
+    static const InternedString* find(v8::Local<v8::String> value) {
+        auto& table = StringCache::table();
+        if (table.by_hash.empty()) {
+            return nullptr;
+        }
+        auto range = table.by_hash.equal_range(value->GetIdentityHash());
+        for (auto it = range.first; it != range.second; ++it) {
+            if (Nan::New(it->second->handle)->StrictEquals(value)) {
+                return it->second;
+            }
+        }
+        return nullptr;
+    }
+};
+
+} // node
+
 namespace js {
 
 template<>
 class String<node::Types> {
     std::string m_str;
+    const node::InternedString* m_interned = nullptr;
+
+    String(const node::InternedString* interned) : m_interned(interned) {}
 
   public:
     String(const char* s) : m_str(s) {}
@@ -33,13 +118,38 @@ class String<node::Types> {
     String(const v8::Local<v8::String> &s);
     String(v8::Local<v8::String> &&s) : String(s) {}
 
+    // Interned strings convert to the same V8 string every time.
+    static String intern(const std::string &s) {
+        return String(&node::StringCache::intern(v8::Isolate::GetCurrent(), s));
+    }
+
+    // Property names are checked against the interned strings first, which
+    // avoids the UTF-8 conversion for the names of schema properties.
+    static String from_property_name(const v8::Local<v8::String> &s) {
+        if (auto interned = node::StringCache::find(s)) {
+            return String(interned);
+        }
+        return String(s);
+    }
+
+    StringData data() const {
+        auto& str = m_interned ? m_interned->value : m_str;
+        return StringData(str.data(), str.size());
+    }
+
     operator std::string() const& {
-        return m_str;
+        return m_interned ? m_interned->value : m_str;
     }
     operator std::string() && {
-        return std::move(m_str);
+        return m_interned ? m_interned->value : std::move(m_str);
     }
     operator v8::Local<v8::String>() const {
+        if (m_interned) {
+            if (node::StringCache::owns(*m_interned)) {
+                return Nan::New(m_interned->handle);
+            }
+            return Nan::New(node::StringCache::intern(v8::Isolate::GetCurrent(), m_interned->value).handle);
+        }
         return Nan::New(m_str).ToLocalChecked();
     }
 };
@@ -22,6 +22,7 @@
 #include <functional>
 #include <map>
 #include <string>
+#include <vector>
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wundef"
@@ -65,5 +66,30 @@ using Object = js::Object<Types>;
 using Exception = js::Exception<Types>;
 using ReturnValue = js::ReturnValue<Types>;
 
+// Templates and strings which are kept for the lifetime of an isolate are
+// held in thread local storage, as every worker thread has an isolate of its
+// own. Their handles have to be released while the isolate is still alive,
+// which is when its environment is cleaned up rather than when the thread
+// exits.
+class IsolateCleanup {
+    static std::vector<std::function<void()>>& callbacks() {
+        static thread_local std::vector<std::function<void()>> s_callbacks;
+        return s_callbacks;
+    }
+
+  public:
+    static void add(std::function<void()> callback) {
+        callbacks().push_back(std::move(callback));
+    }
+
+    static void run() {
+        auto pending = std::move(callbacks());
+        callbacks().clear();
+        for (auto it = pending.rbegin(); it != pending.rend(); ++it) {
+            (*it)();
+        }
+    }
+};
+
 } // node
 } // realm
@@ -125,6 +125,40 @@ inline v8::Local<v8::Value> node::Value::from_nonnull_string(v8::Isolate* isolat
     return v8::Local<v8::String>(string);
 }
 
+// Long strings are copied out of the Realm file into memory of their own,
+// which the V8 heap refers to rather than copying them again.
+class ExternalOneByteString : public v8::String::ExternalOneByteStringResource {
+  public:
+    static constexpr size_t min_size = 1024;
+
+    ExternalOneByteString(const char *data, size_t size) : m_data(data, size) {}
+
+    const char *data() const override {
+        return m_data.data();
+    }
+    size_t length() const override {
+        return m_data.size();
+    }
+
+  private:
+    std::string m_data;
+};
+
+template<>
+inline v8::Local<v8::Value> node::Value::from_nonnull_string_data(v8::Isolate* isolate, StringData string) {
+    if (string.size() > size_t(v8::String::kMaxLength)) {
+        throw std::length_error("The string is too long to be read into JavaScript.");
+    }
+    int length = int(string.size());
+    if (!is_ascii(string.data(), string.size())) {
+        return v8::String::NewFromUtf8(isolate, string.data(), v8::NewStringType::kNormal, length).ToLocalChecked();
+    }
+    if (string.size() >= ExternalOneByteString::min_size) {
+        return v8::String::NewExternalOneByte(isolate, new ExternalOneByteString(string.data(), string.size())).ToLocalChecked();
+    }
+    return v8::String::NewFromOneByte(isolate, reinterpret_cast<const uint8_t*>(string.data()), v8::NewStringType::kNormal, length).ToLocalChecked();
+}
+
 template<>
 inline v8::Local<v8::Value> node::Value::from_nonnull_binary(v8::Isolate* isolate, BinaryData data) {
     v8::Local<v8::ArrayBuffer> buffer = v8::ArrayBuffer::New(isolate, data.size());
@@ -194,6 +228,41 @@ inline OwnedBinaryData node::Value::to_binary(v8::Isolate* isolate, v8::Local<v8
     }
 }
 
+template<>
+inline bool node::Value::to_binary_view(v8::Isolate* isolate, const v8::Local<v8::Value> &value, BinaryData &data) {
+    // BinaryData with a null pointer is a null value, so empty views point here.
+    static const char empty = 0;
+    auto make_view = [&](const char* bytes, size_t length) {
+        data = BinaryData(length ? bytes : &empty, length);
+        return true;
+    };
+
+    if (value->IsArrayBuffer()) {
+        v8::ArrayBuffer::Contents contents = value.As<v8::ArrayBuffer>()->GetContents();
+        return make_view(static_cast<const char*>(contents.Data()), contents.ByteLength());
+    }
+    if (value->IsArrayBufferView()) {
+        v8::Local<v8::ArrayBufferView> view = value.As<v8::ArrayBufferView>();
+        v8::ArrayBuffer::Contents contents = view->Buffer()->GetContents();
+        return make_view(static_cast<const char*>(contents.Data()) + view->ByteOffset(), view->ByteLength());
+    }
+    return false;
+}
+
+template<>
+inline bool node::Value::get_typed_array_type(v8::Isolate* isolate, const v8::Local<v8::Value> &value, TypedArrayType &type) {
+    if (value->IsInt8Array()) type = TypedArrayType::Int8;
+    else if (value->IsUint8Array()) type = TypedArrayType::Uint8;
+    else if (value->IsInt16Array()) type = TypedArrayType::Int16;
+    else if (value->IsUint16Array()) type = TypedArrayType::Uint16;
+    else if (value->IsInt32Array()) type = TypedArrayType::Int32;
+    else if (value->IsUint32Array()) type = TypedArrayType::Uint32;
+    else if (value->IsFloat32Array()) type = TypedArrayType::Float32;
+    else if (value->IsFloat64Array()) type = TypedArrayType::Float64;
+    else return false;
+    return true;
+}
+
 template<>
 inline v8::Local<v8::Object> node::Value::to_object(v8::Isolate* isolate, const v8::Local<v8::Value> &value) {
     return Nan::To<v8::Object>(value).FromMaybe(v8::Local<v8::Object>());
@@ -19,6 +19,7 @@
 #include <stdexcept>
 #include <vector>
 #include <uv.h>
+#include <nan.h>
 
 #include "../platform.hpp"
 
@@ -40,6 +41,10 @@ struct FileSystemRequest : uv_fs_t {
     }
 };
 
+struct FileWorkRequest : uv_work_t {
+    std::function<void()> work;
+};
+
 // taken from Node.js: function Cwd in node.cc
 std::string default_realm_file_directory()
 {
@@ -185,4 +190,22 @@ void remove_file(const std::string &path)
     }
 }
 
+// runs on the libuv threadpool, and so shares its threads with Node's own fs calls.
+// The work is queued on the loop of the calling isolate, which may be a worker's,
+// and is destroyed back on that loop's thread.
+void run_file_work(std::function<void()> work)
+{
+    auto request = new FileWorkRequest;
+    request->work = std::move(work);
+    int err = uv_queue_work(Nan::GetCurrentEventLoop(), request, [](uv_work_t* req) {
+        static_cast<FileWorkRequest*>(req)->work();
+    }, [](uv_work_t* req, int) {
+        delete static_cast<FileWorkRequest*>(req);
+    });
+    if (err) {
+        delete request;
+        throw UVException(static_cast<uv_errno_t>(err));
+    }
+}
+
 } // realm
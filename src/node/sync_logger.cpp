@@ -21,13 +21,14 @@
 #include "util/event_loop_signal.hpp"
 
 #include <realm/util/logger.hpp>
+#include <realm/util/to_string.hpp>
 
+#include <algorithm>
+#include <deque>
 #include <mutex>
 #include <stdexcept>
 #include <string>
 #include <utility>
-#include <set>
-#include <queue>
 
 using namespace realm;
 using namespace realm::node;
@@ -40,8 +41,9 @@ struct SyncLoggerMessage {
 
 class SyncLoggerQueue {
 public:
-    SyncLoggerQueue(v8::Isolate* v8_isolate, v8::Local<v8::Function> callback)
+    SyncLoggerQueue(v8::Isolate* v8_isolate, v8::Local<v8::Function> callback, SyncLoggerOptions options)
         : m_log_uv_async([this] { log_uv_callback(); }) // Throws
+        , m_options(std::move(options))
         , m_v8_isolate(v8_isolate)
         , m_callback(v8_isolate, callback)
     {
@@ -49,19 +51,24 @@ public:
 
 protected:
     void log_uv_callback();
-    std::queue<SyncLoggerMessage> m_log_queue;
+    void push(SyncLoggerMessage&&);
+    std::deque<SyncLoggerMessage> m_log_queue;
+    size_t m_dropped = 0;
     std::mutex m_mutex;
     EventLoopSignal<std::function<void()>> m_log_uv_async;
+    const SyncLoggerOptions m_options;
 
 private:
     v8::Isolate* m_v8_isolate;
     v8::Persistent<v8::Function> m_callback;
+
+    v8::Local<v8::String> make_string(const std::string&);
 };
 
 class SyncLogger : public realm::util::RootLogger, public SyncLoggerQueue {
 public:
-    SyncLogger(v8::Isolate* v8_isolate, v8::Local<v8::Function> callback)
-        : SyncLoggerQueue(v8_isolate, callback)
+    SyncLogger(v8::Isolate* v8_isolate, v8::Local<v8::Function> callback, SyncLoggerOptions options)
+        : SyncLoggerQueue(v8_isolate, callback, std::move(options))
     {
     }
 
@@ -69,43 +76,109 @@ protected:
     void do_log(realm::util::Logger::Level, std::string) override final;
 };
 
+v8::Local<v8::String> SyncLoggerQueue::make_string(const std::string& string)
+{
+    return v8::String::NewFromUtf8(m_v8_isolate, string.data(), v8::NewStringType::kNormal,
+                                   static_cast<int>(string.size())).ToLocalChecked();
+}
+
 void SyncLoggerQueue::log_uv_callback()
 {
     // This function is always executed by the Node.js event loop
     // thread.
     v8::HandleScope scope(m_v8_isolate);
+    v8::Local<v8::Context> context = m_v8_isolate->GetCurrentContext();
     v8::Local<v8::Function> callback = v8::Local<v8::Function>::New(m_v8_isolate, m_callback);
 
-    std::queue<SyncLoggerMessage> popped;
+    std::deque<SyncLoggerMessage> popped;
+    size_t dropped;
     {
         std::lock_guard<std::mutex> lock(m_mutex); // Throws
         popped.swap(m_log_queue);
+        dropped = m_dropped;
+        m_dropped = 0;
     }
 
-    while (!popped.empty()) {
-        v8::Local<v8::Value> argv[] = {v8::Integer::New(m_v8_isolate, static_cast<int>(popped.front().m_level)),
-                                       v8::String::NewFromUtf8(m_v8_isolate, popped.front().m_message.c_str())};
+    if (m_options.batch) {
+        if (popped.empty() && dropped == 0) {
+            return;
+        }
+
+        int count = static_cast<int>(popped.size());
+        v8::Local<v8::Array> levels = v8::Array::New(m_v8_isolate, count);
+        v8::Local<v8::Array> messages = v8::Array::New(m_v8_isolate, count);
+        for (int i = 0; i < count; ++i) {
+            (void)levels->Set(context, i, v8::Integer::New(m_v8_isolate, static_cast<int>(popped[i].m_level)));
+            (void)messages->Set(context, i, make_string(popped[i].m_message));
+        }
+
+        v8::Local<v8::Value> argv[] = {levels, messages, v8::Number::New(m_v8_isolate, static_cast<double>(dropped))};
+        callback->Call(context, v8::Null(m_v8_isolate), 3, argv);
+        return;
+    }
 
-        callback->Call(m_v8_isolate->GetCurrentContext(), v8::Null(m_v8_isolate), 2, argv);
+    if (dropped > 0) {
+        popped.push_front({util::format("%1 sync log messages were dropped.", dropped), util::Logger::Level::warn});
+    }
 
-        popped.pop();
+    for (auto& message : popped) {
+        v8::Local<v8::Value> argv[] = {v8::Integer::New(m_v8_isolate, static_cast<int>(message.m_level)),
+                                       make_string(message.m_message)};
+
+        callback->Call(context, v8::Null(m_v8_isolate), 2, argv);
     }
 }
 
-void SyncLogger::do_log(realm::util::Logger::Level level, std::string message)
+void SyncLoggerQueue::push(SyncLoggerMessage&& message)
 {
-    std::lock_guard<std::mutex> lock(m_mutex); // Throws
-    m_log_queue.push({std::move(message), level});
+    // Filter on the calling sync thread, before anything is queued.
+    if (!m_options.matches(message.m_message)) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex); // Throws
+        if (m_options.buffer_size && m_log_queue.size() == m_options.buffer_size) {
+            m_log_queue.pop_front();
+            ++m_dropped;
+        }
+        m_log_queue.push_back(std::move(message));
+    }
     m_log_uv_async.notify();
 }
 
+void SyncLogger::do_log(realm::util::Logger::Level level, std::string message)
+{
+    push({std::move(message), level});
+}
+
 } // anonymous namespace
 
+bool realm::node::SyncLoggerOptions::matches(const std::string& message) const
+{
+    if (filter.empty()) {
+        return true;
+    }
+    auto fold = [](char c) {
+        return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+    };
+    for (auto& substring : filter) {
+        auto found = ignore_case
+            ? std::search(message.begin(), message.end(), substring.begin(), substring.end(),
+                          [&](char a, char b) { return fold(a) == b; })
+            : std::search(message.begin(), message.end(), substring.begin(), substring.end());
+        if (found != message.end() || substring.empty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
 std::unique_ptr<util::Logger> realm::node::SyncLoggerFactory::make_logger(util::Logger::Level level)
 {
     v8::Local<v8::Function> callback = v8::Local<v8::Function>::New(m_v8_isolate, m_callback);
 
-    auto logger = std::make_unique<SyncLogger>(m_v8_isolate, callback); // Throws
+    auto logger = std::make_unique<SyncLogger>(m_v8_isolate, callback, m_options); // Throws
     logger->set_level_threshold(level);
     return std::unique_ptr<util::Logger>(logger.release());
 }
@@ -25,14 +25,35 @@
 
 #include "sync/sync_manager.hpp"
 
+#include <memory>
+#include <string>
+#include <vector>
+
 namespace realm {
 namespace node {
 
+struct SyncLoggerOptions {
+    // Deliver the messages queued since the last wakeup of the event loop
+    // in one call, as arrays of levels and messages.
+    bool batch = false;
+    // The number of messages kept while waiting for the event loop. Older
+    // messages are dropped once it is reached. Zero means unbounded.
+    size_t buffer_size = 0;
+    // Only messages containing one of these are queued, if any are given.
+    // They are lower case when `ignore_case` is set, and matched against the
+    // messages with ASCII letters folded to lower case.
+    std::vector<std::string> filter;
+    bool ignore_case = false;
+
+    bool matches(const std::string& message) const;
+};
+
 class SyncLoggerFactory : public realm::SyncLoggerFactory {
 public:
-    SyncLoggerFactory(v8::Isolate* v8_isolate, v8::Local<v8::Function> callback)
+    SyncLoggerFactory(v8::Isolate* v8_isolate, v8::Local<v8::Function> callback, SyncLoggerOptions options = {})
         : m_v8_isolate(v8_isolate)
         , m_callback(v8_isolate, callback)
+        , m_options(std::move(options))
     {
     }
 
@@ -41,6 +62,7 @@ public:
 private:
     v8::Isolate* m_v8_isolate;
     v8::Persistent<v8::Function> m_callback;
+    SyncLoggerOptions m_options;
 };
 
 } // namespace node
@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <functional>
 #include <string>
 
 namespace realm {
@@ -47,4 +48,10 @@ void remove_file(const std::string &path);
 // remove directory at the given path
 void remove_directory(const std::string &path);
 
+// run work which blocks on the file system on a thread other than the calling one.
+// On Node.js the work is destroyed on the calling thread, but on Android and iOS it
+// is destroyed on the thread which ran it, so it must not capture Protected values.
+// Results are passed back through an EventLoopDispatcher instead.
+void run_file_work(std::function<void()> work);
+
 }
@@ -0,0 +1,114 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2020 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace realm {
+namespace js {
+
+// Coalesces the progress reported by the sync client for one or more
+// sessions, so that JS is called back at a bounded rate rather than for
+// every tick. Progress is recorded on the sync client's thread, and taken on
+// the JS thread by at most one pending callback at a time, which then gets
+// the latest values rather than the ones it was scheduled for. Progress
+// which completes the outstanding work is always delivered.
+class ProgressThrottle {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    ProgressThrottle(size_t sources, Clock::duration min_interval, uint64_t min_delta_bytes)
+    : m_sources(sources), m_min_interval(min_interval), m_min_delta_bytes(min_delta_bytes) {}
+
+    // Records the progress of one source. Returns true if a callback should
+    // be scheduled to take it.
+    bool update(size_t source, uint64_t transferred, uint64_t transferrable) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_sources[source] = {transferred, transferrable};
+        m_latest = {0, 0};
+        for (auto const& progress : m_sources) {
+            m_latest.transferred += progress.transferred;
+            m_latest.transferrable += progress.transferrable;
+        }
+
+        if (m_scheduled || (m_delivered && m_latest == m_last)) {
+            return false;
+        }
+        if (m_delivered && !m_latest.is_complete()) {
+            if (Clock::now() - m_last_time < m_min_interval) {
+                return false;
+            }
+            if (delta(m_latest.transferred, m_last.transferred) < m_min_delta_bytes &&
+                delta(m_latest.transferrable, m_last.transferrable) < m_min_delta_bytes) {
+                return false;
+            }
+        }
+        m_scheduled = true;
+        return true;
+    }
+
+    // Takes the latest progress for a scheduled callback. Returns false if
+    // it has already been delivered.
+    bool take(uint64_t& transferred, uint64_t& transferrable) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_scheduled = false;
+        if (m_delivered && m_latest == m_last) {
+            return false;
+        }
+        m_last = m_latest;
+        m_last_time = Clock::now();
+        m_delivered = true;
+        transferred = m_last.transferred;
+        transferrable = m_last.transferrable;
+        return true;
+    }
+
+  private:
+    struct Progress {
+        uint64_t transferred;
+        uint64_t transferrable;
+
+        bool operator==(Progress const& other) const {
+            return transferred == other.transferred && transferrable == other.transferrable;
+        }
+        bool is_complete() const {
+            return transferred >= transferrable;
+        }
+    };
+
+    static uint64_t delta(uint64_t a, uint64_t b) {
+        return a > b ? a - b : b - a;
+    }
+
+    std::mutex m_mutex;
+    std::vector<Progress> m_sources;
+    const Clock::duration m_min_interval;
+    const uint64_t m_min_delta_bytes;
+    Progress m_latest = {0, 0};
+    Progress m_last = {0, 0};
+    Clock::time_point m_last_time;
+    bool m_delivered = false;
+    bool m_scheduled = false;
+};
+
+} // js
+} // realm
@@ -0,0 +1,237 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2020 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <realm/query.hpp>
+#include <realm/table.hpp>
+#include <realm/table_view.hpp>
+#include <realm/unicode.hpp>
+#include <realm/util/optional.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <queue>
+#include <string>
+#include <vector>
+
+namespace realm {
+namespace js {
+
+// Pages through the rows matching a query in the order of a set of columns,
+// starting each page after the sort key of the last row of the one before it
+// rather than at an offset. Rows added or removed before that key therefore
+// don't shift the pages which follow. Each page is picked with a heap bounded
+// by the page size, so the rows matching the query are never sorted as a
+// whole. The columns must tell every row apart, such as by ending with the
+// primary key, as a row's index changes when rows before it are removed.
+class ResultsCursor {
+  public:
+    struct SortColumn {
+        size_t column;
+        DataType type;
+        bool ascending;
+    };
+
+    ResultsCursor(std::vector<SortColumn> columns, size_t page_size)
+    : m_columns(std::move(columns)), m_page_size(page_size) {
+        m_after.resize(m_columns.size());
+        m_after_strings.resize(m_columns.size());
+    }
+
+    // Makes the next page start after the given row of the table.
+    void start_after(Table const& table, size_t row) {
+        for (size_t i = 0; i < m_columns.size(); ++i) {
+            m_after[i] = read(table, row, m_columns[i]);
+            if (!m_after[i].null && m_columns[i].type == type_String) {
+                m_after_strings[i] = std::string(m_after[i].string);
+                m_after[i].string = m_after_strings[i];
+            }
+        }
+        m_has_after = true;
+    }
+
+    bool done() const {
+        return m_done;
+    }
+
+    // Returns the rows of the next page, in order, and moves the cursor past
+    // them. A page shorter than the page size is the last one.
+    std::vector<size_t> next_page(Query& query) {
+        std::vector<size_t> rows;
+        if (m_done) {
+            return rows;
+        }
+
+        Table const& table = *query.get_table();
+        auto less = [&](size_t a, size_t b) {
+            return compare(table, a, b) < 0;
+        };
+        // The greatest of the rows kept so far is on top, and is the one to
+        // make room for a lesser one.
+        std::priority_queue<size_t, std::vector<size_t>, decltype(less)> heap(less);
+
+        // The rows matching the query are kept between pages, and the query
+        // only runs again if the table has changed since.
+        if (!m_view || !m_view->is_attached()) {
+            m_view = query.find_all();
+        }
+        else {
+            m_view->sync_if_needed();
+        }
+        TableView& table_view = *m_view;
+        for (size_t i = 0; i < table_view.size(); ++i) {
+            if (!table_view.is_row_attached(i)) {
+                continue;
+            }
+            size_t row = table_view.get_source_ndx(i);
+            if (m_has_after && compare_to_after(table, row) <= 0) {
+                continue;
+            }
+            if (heap.size() < m_page_size) {
+                heap.push(row);
+            }
+            else if (less(row, heap.top())) {
+                heap.pop();
+                heap.push(row);
+            }
+        }
+
+        rows.resize(heap.size());
+        for (size_t i = rows.size(); i > 0; --i) {
+            rows[i - 1] = heap.top();
+            heap.pop();
+        }
+
+        if (rows.size() < m_page_size) {
+            m_done = true;
+        }
+        if (!rows.empty()) {
+            start_after(table, rows.back());
+        }
+        return rows;
+    }
+
+  private:
+    struct Value {
+        bool null = false;
+        int64_t integer = 0;
+        double number = 0;
+        StringData string;
+        Timestamp timestamp;
+    };
+
+    std::vector<SortColumn> m_columns;
+    size_t m_page_size;
+    std::vector<Value> m_after;
+    // Owns the strings of the key the next page starts after, which would
+    // otherwise point into a version of the Realm which may be gone.
+    std::vector<std::string> m_after_strings;
+    bool m_has_after = false;
+    bool m_done = false;
+    util::Optional<TableView> m_view;
+
+    static Value read(Table const& table, size_t row, SortColumn const& column) {
+        Value value;
+        if (table.is_null(column.column, row)) {
+            value.null = true;
+            return value;
+        }
+        switch (column.type) {
+            case type_Bool:
+                value.integer = table.get_bool(column.column, row);
+                break;
+            case type_Float:
+                value.number = table.get_float(column.column, row);
+                break;
+            case type_Double:
+                value.number = table.get_double(column.column, row);
+                break;
+            case type_String:
+                value.string = table.get_string(column.column, row);
+                break;
+            case type_Timestamp:
+                value.timestamp = table.get_timestamp(column.column, row);
+                break;
+            default:
+                value.integer = table.get_int(column.column, row);
+                break;
+        }
+        return value;
+    }
+
+    template<typename V>
+    static int three_way(V const& a, V const& b) {
+        return a < b ? -1 : (b < a ? 1 : 0);
+    }
+
+    // Strings are ordered the way core sorts them rather than by their bytes.
+    static int three_way(StringData const& a, StringData const& b) {
+        if (a == b) {
+            return 0;
+        }
+        return utf8_compare(a, b) ? -1 : 1;
+    }
+
+    // Nulls come first, as they do when core sorts the same column.
+    static int compare(SortColumn const& column, Value const& a, Value const& b) {
+        int result;
+        if (a.null || b.null) {
+            result = int(b.null) - int(a.null);
+        }
+        else {
+            switch (column.type) {
+                case type_Float:
+                case type_Double:
+                    result = three_way(a.number, b.number);
+                    break;
+                case type_String:
+                    result = three_way(a.string, b.string);
+                    break;
+                case type_Timestamp:
+                    result = three_way(a.timestamp, b.timestamp);
+                    break;
+                default:
+                    result = three_way(a.integer, b.integer);
+                    break;
+            }
+        }
+        return column.ascending ? result : -result;
+    }
+
+    int compare(Table const& table, size_t a, size_t b) const {
+        for (auto const& column : m_columns) {
+            if (int result = compare(column, read(table, a, column), read(table, b, column))) {
+                return result;
+            }
+        }
+        return 0;
+    }
+
+    int compare_to_after(Table const& table, size_t row) const {
+        for (size_t i = 0; i < m_columns.size(); ++i) {
+            if (int result = compare(m_columns[i], read(table, row, m_columns[i]), m_after[i])) {
+                return result;
+            }
+        }
+        return 0;
+    }
+};
+
+} // js
+} // realm
@@ -16,12 +16,20 @@
 //
 ////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <cstring>
 #include <dlfcn.h>
+#include <limits>
 #include <map>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 #include "rpc.hpp"
+#include "rpc_msgpack.hpp"
+#include "trace_events.hpp"
 #include "jsc_init.hpp"
 
 #include "base64.hpp"
@@ -48,6 +56,9 @@ static const char * const RealmObjectTypesSession = "session";
 static const char * const RealmObjectTypesSubscription = "subscription";
 static const char * const RealmObjectTypesAsyncOpenTask = "asyncopentask";
 static const char * const RealmObjectTypesUndefined = "undefined";
+static const char * const RealmObjectTypesBatchResult = "batchresult";
+
+static const char * const MessagePackContentType = "application/x-msgpack";
 
 json serialize_object_schema(const realm::ObjectSchema &object_schema) {
     std::vector<std::string> properties;
@@ -116,22 +127,27 @@ template<typename Fn>
 json RPCWorker::add_task(Fn&& fn) {
     std::promise<json> p;
     auto future = p.get_future();
-    m_promises.push_back(std::move(p));
-    m_tasks.push_back([this, fn = std::move(fn)] {
+    m_promises.push(std::move(p));
+    m_tasks.push([this, fn = std::move(fn)] {
         auto result = fn();
-        m_promises.pop_back().set_value(std::move(result));
+        // The promise for this task is pushed right before it, unless a
+        // callback invoked from within the task has already taken it, in
+        // which case no one is waiting for this result anymore.
+        if (auto promise = m_promises.try_pop()) {
+            promise->set_value(std::move(result));
+        }
     });
     return future.get();
 }
 
 void RPCWorker::invoke_callback(json callback) {
-    m_tasks.push_back([=, callback = std::move(callback)]() mutable {
+    m_tasks.push([=, callback = std::move(callback)]() mutable {
         if (m_depth == 1) {
             // The callback was invoked directly from the event loop. Push it
             // onto the queue of callbacks to be processed by /callbacks_poll
-            m_callbacks.push_back(std::move(callback));
+            push_callback(std::move(callback));
         }
-        else if (auto promise = m_promises.try_pop_back(0)) {
+        else if (auto promise = m_promises.try_pop()) {
             // The callback was invoked from within a call to something else,
             // and there's someone waiting for its result.
             promise->set_value(std::move(callback));
@@ -139,20 +155,52 @@ void RPCWorker::invoke_callback(json callback) {
         else {
             // The callback was invoked from within a call to something else,
             // but there's no one waiting for the result. Shouldn't be possible?
-            m_callbacks.push_back(std::move(callback));
+            push_callback(std::move(callback));
         }
     });
 }
 
+void RPCWorker::push_callback(json&& callback) {
+    m_callbacks.push(std::move(callback));
+    notify_callback_listener();
+}
+
+void RPCWorker::push_async_callback(json&& callback) {
+    {
+        std::lock_guard<std::mutex> lock(m_async_callbacks_mutex);
+        m_async_callbacks.push_back(std::move(callback));
+    }
+    notify_callback_listener();
+}
+
+json RPCWorker::take_async_callbacks() {
+    std::lock_guard<std::mutex> lock(m_async_callbacks_mutex);
+    json callbacks = std::move(m_async_callbacks);
+    m_async_callbacks = json::array();
+    return callbacks;
+}
+
+void RPCWorker::notify_callback_listener() {
+    std::lock_guard<std::mutex> lock(m_callback_listener_mutex);
+    if (m_callback_listener) {
+        m_callback_listener();
+    }
+}
+
+void RPCWorker::set_callback_listener(std::function<void()> listener) {
+    std::lock_guard<std::mutex> lock(m_callback_listener_mutex);
+    m_callback_listener = std::move(listener);
+}
+
 std::future<json> RPCWorker::add_promise() {
     std::promise<json> p;
     auto future = p.get_future();
-    m_promises.push_back(std::move(p));
+    m_promises.push(std::move(p));
     return future;
 }
 
 json RPCWorker::try_pop_callback() {
-    auto cb = m_callbacks.try_pop_back(0);
+    auto cb = m_callbacks.try_pop();
     return cb ? *cb : json::object();
 }
 
@@ -162,7 +210,7 @@ bool RPCWorker::try_run_task() {
     }
 
     // Use a 10 millisecond timeout to keep this thread unblocked.
-    if (auto task = m_tasks.try_pop_back(10)) {
+    if (auto task = m_tasks.try_pop(std::chrono::milliseconds(10))) {
         ++m_depth;
         (*task)();
         --m_depth;
@@ -185,7 +233,20 @@ void RPCWorker::stop() {
     }
 }
 
-static json read_object_properties(Object& object) {
+static json serialize_timestamp(Timestamp ts, bool binary) {
+    if (binary) {
+        return {
+            {"type", RealmObjectTypesDate},
+            {"timestamp", {ts.get_seconds(), ts.get_nanoseconds()}},
+        };
+    }
+    return {
+        {"type", RealmObjectTypesDate},
+        {"value", ts.get_seconds() * 1000.0 + ts.get_nanoseconds() / 1000000.0},
+    };
+}
+
+static json read_object_properties(Object& object, bool binary, size_t max_string_size) {
     json cache;
     if (!object.is_valid()) {
         return cache;
@@ -211,19 +272,14 @@ static json read_object_properties(Object& object) {
             case PropertyType::Int:    cache_value(row.get_int(property.table_column)); break;
             case PropertyType::Float:  cache_value(row.get_float(property.table_column)); break;
             case PropertyType::Double: cache_value(row.get_double(property.table_column)); break;
-            case PropertyType::Date: {
-                auto ts = row.get_timestamp(property.table_column);
-                cache[property.name] = {
-                    {"type", RealmObjectTypesDate},
-                    {"value", ts.get_seconds() * 1000.0 + ts.get_nanoseconds() / 1000000.0},
-                };
+            case PropertyType::Date:
+                cache[property.name] = serialize_timestamp(row.get_timestamp(property.table_column), binary);
                 break;
-            }
             break;
             case PropertyType::String: {
                 auto str = row.get_string(property.table_column);
-                // A completely abitrary upper limit on how big of a string we'll pre-cache
-                if (str.size() < 100) {
+                // An upper limit on how big of a string we'll pre-cache, set by the client
+                if (str.size() < max_string_size) {
                     cache_value(str);
                 }
                 break;
@@ -237,6 +293,39 @@ static json read_object_properties(Object& object) {
     return cache;
 }
 
+// Replaces the references to results of earlier requests in a batch, which
+// look like {"type": "batchresult", "index": 2, "field": "id"}, with those
+// results (or the given field of them).
+static void resolve_batch_results(json& value, json const& results) {
+    if (!value.is_object() && !value.is_array()) {
+        return;
+    }
+
+    auto type = value.find("type");
+    if (value.is_object() && type != value.end() && *type == RealmObjectTypesBatchResult) {
+        size_t index = value["index"].get<size_t>();
+        if (index >= results.size()) {
+            throw std::invalid_argument("Batched requests can only refer to the results of earlier requests");
+        }
+
+        json result = results[index];
+        auto field = value.find("field");
+        if (field != value.end()) {
+            std::string field_name = field->get<std::string>();
+            if (!result.is_object() || !result.count(field_name)) {
+                throw std::invalid_argument("The result of batched request " + std::to_string(index) + " has no '" + field_name + "'");
+            }
+            result = result[field_name];
+        }
+        value = std::move(result);
+        return;
+    }
+
+    for (auto& element : value) {
+        resolve_batch_results(element, results);
+    }
+}
+
 RPCServer::RPCServer() {
     m_context = JSGlobalContextCreate(NULL);
     get_rpc_server(m_context) = this;
@@ -261,7 +350,24 @@ RPCServer::RPCServer() {
         jsc::Object::set_property(m_context, user_constructor, "_refreshAccessToken", refreshAccessTokenCallback);
 
         m_session_id = store_object(realm_constructor);
-        return (json){{"result", m_session_id}};
+        set_prefetch_options(dict.value("prefetch", json::object()));
+
+        // Clients which list the encodings they support get the chosen one
+        // along with the session id, and keep using JSON if none of them are
+        // supported. Older clients only get the session id.
+        auto encodings = dict.find("encodings");
+        if (encodings == dict.end() || !encodings->is_array()) {
+            m_session_encoding = RPCEncoding::JSON;
+            return (json){{"result", m_session_id.load()}};
+        }
+        bool msgpack = std::find(encodings->begin(), encodings->end(), "msgpack") != encodings->end();
+        m_session_encoding = msgpack ? RPCEncoding::MessagePack : RPCEncoding::JSON;
+
+        json result = {{"sessionId", m_session_id.load()}, {"encoding", msgpack ? "msgpack" : "json"}};
+        if (m_websocket_port) {
+            result["webSocketPort"] = m_websocket_port;
+        }
+        return (json){{"result", result}};
     };
     m_requests["/create_realm"] = [this](const json dict) {
         JSObjectRef realm_constructor = get_realm_constructor();
@@ -399,7 +505,7 @@ RPCServer::RPCServer() {
         json result;
         if (jsc::Object::is_instance<js::RealmObjectClass<jsc::Types>>(m_context, object)) {
             auto obj = jsc::Object::get_internal<js::RealmObjectClass<jsc::Types>>(object);
-            result = read_object_properties(*obj);
+            result = read_object_properties(*obj, m_binary, m_max_cached_string_size);
         }
         if (result.find(name) == result.end()) {
             if (name.is_number()) {
@@ -446,11 +552,33 @@ RPCServer::RPCServer() {
 
         return json::object();
     };
+    m_requests["/get_range"] = [this](const json dict) -> json {
+        RPCObjectID oid = dict["id"].get<RPCObjectID>();
+        JSObjectRef object = get_object(oid);
+        if (!object) {
+            return {{"result", nullptr}};
+        }
+        return {{"result", serialize_range(object, dict["start"].get<size_t>(), dict["count"].get<size_t>())}};
+    };
+    m_requests["/set_prefetch_options"] = [this](const json dict) {
+        set_prefetch_options(dict["options"]);
+        return json::object();
+    };
     m_requests["/dispose_object"] = [this](const json dict) {
         RPCObjectID oid = dict["id"].get<RPCObjectID>();
         m_objects.erase(oid);
         return json::object();
     };
+    m_requests["/release_objects"] = [this](const json dict) {
+        for (auto& id : dict["ids"]) {
+            RPCObjectID oid = id.get<RPCObjectID>();
+            // The session ID points to the Realm constructor object, which should remain.
+            if (oid != m_session_id) {
+                m_objects.erase(oid);
+            }
+        }
+        return json::object();
+    };
     m_requests["/get_all_users"] = [this](const json dict) {
         JSObjectRef realm_constructor = get_realm_constructor();
 
@@ -462,21 +590,20 @@ RPCServer::RPCServer() {
     };
     m_requests["/clear_test_state"] = [this](const json dict) {
         // The session ID points to the Realm constructor object, which should remain.
-        auto realm_constructor = m_objects[m_session_id];
-        m_objects.clear();
-
-        if (realm_constructor) {
-            m_objects.emplace(m_session_id, realm_constructor);
-        }
+        m_objects.erase_if([&](RPCObjectID oid, auto&) {
+            return oid != m_session_id;
+        });
 
         // The JS side of things only gives us the refreshAccessToken callback
         // when creating a session so we need to hold onto it.
         auto refresh_access_token = m_callbacks[0];
 
         m_callbacks.clear();
+        m_async_callbacks.clear();
         m_callback_ids.clear();
         m_callbacks[0] = refresh_access_token;
         m_callback_ids[refresh_access_token] = 0;
+        m_worker.take_async_callbacks();
         ++m_reset_counter;
         JSGarbageCollect(m_context);
         js::clear_test_state();
@@ -491,6 +618,7 @@ RPCServer::~RPCServer() {
     // The protected values should be unprotected before releasing the context.
     m_objects.clear();
     m_callbacks.clear();
+    m_async_callbacks.clear();
 
     get_rpc_server(m_context) = nullptr;
     JSGlobalContextRelease(m_context);
@@ -568,9 +696,103 @@ JSValueRef RPCServer::run_callback(JSContextRef ctx, JSObjectRef function, JSObj
     return server->deserialize_json_value(results["result"]);
 }
 
-json RPCServer::perform_request(std::string const& name, json&& args) {
+JSValueRef RPCServer::run_async_callback(JSContextRef ctx, JSObjectRef function, JSObjectRef this_object,
+                                         size_t argc, const JSValueRef arguments[], JSValueRef* exception) {
+    RPCServer* server = get_rpc_server(JSContextGetGlobalContext(ctx));
+    if (!server) {
+        return JSValueMakeUndefined(ctx);
+    }
+
+    auto it = server->m_callback_ids.find(function);
+    if (it == server->m_callback_ids.end()) {
+        return JSValueMakeUndefined(ctx);
+    }
+
+    // The arguments are serialized now, as they may have changed by the time the client gets them.
+    JSObjectRef arguments_array = jsc::Object::create_array(ctx, uint32_t(argc), arguments);
+    server->m_worker.push_async_callback({
+        {"callback", it->second},
+        {"this", server->serialize_json_value(this_object)},
+        {"arguments", server->serialize_json_value(arguments_array)},
+    });
+    return JSValueMakeUndefined(ctx);
+}
+
+RPCEncoding RPCServer::encoding_for_content_type(std::string const& content_type) {
+    return content_type.compare(0, strlen(MessagePackContentType), MessagePackContentType) == 0 ? RPCEncoding::MessagePack : RPCEncoding::JSON;
+}
+
+const char* RPCServer::content_type(RPCEncoding encoding) {
+    return encoding == RPCEncoding::MessagePack ? MessagePackContentType : "application/json";
+}
+
+std::string RPCServer::perform_request(std::string const& name, std::string const& body, RPCEncoding encoding) {
+    RPCRequestTiming timing;
+    timing.bytes_in = body.size();
+
+    auto start = RPCClock::now();
+    json args = encoding == RPCEncoding::MessagePack ? msgpack::decode(body) : json::parse(body);
+    timing.deserialize = RPCClock::now() - start;
+
+    json response = perform_request(name, std::move(args), encoding, timing);
+
+    start = RPCClock::now();
+    std::string response_body = encoding == RPCEncoding::MessagePack ? msgpack::encode(response) : response.dump();
+    timing.serialize = RPCClock::now() - start;
+    timing.bytes_out = response_body.size();
+
+    m_stats.record(name, timing);
+    return response_body;
+}
+
+json RPCServer::perform_request(std::string const& name, json&& args, RPCEncoding encoding) {
+    RPCRequestTiming timing;
+    json response = perform_request(name, std::move(args), encoding, timing);
+    m_stats.record(name, timing);
+    return response;
+}
+
+json RPCServer::perform_request(std::string const& name, json&& args, RPCEncoding encoding, RPCRequestTiming& timing) {
+    js::TraceScope trace("rpc", name);
+    // Answered without waiting for the request being performed or going
+    // through the worker, as RPCStats has its own lock, so that it can be
+    // asked for while a request is stuck.
+    if (name == "/stats") {
+        if (m_session_id != args["sessionId"].get<RPCObjectID>()) {
+            return {{"error", "Invalid session ID"}};
+        }
+        return perform_stats_request(args);
+    }
+
     std::lock_guard<std::mutex> lock(m_request_mutex);
+    m_binary = encoding == RPCEncoding::MessagePack;
+
+    json response = handle_request(name, std::move(args), timing);
+    timing.error = response.is_object() && response.count("error");
+
+    // Asynchronous callbacks are delivered with the next response of any kind.
+    json callbacks = m_worker.take_async_callbacks();
+    if (!callbacks.empty() && response.is_object()) {
+        response["callbacks"] = std::move(callbacks);
+    }
+    return response;
+}
+
+template<typename Fn>
+json RPCServer::run_timed_task(RPCRequestTiming& timing, Fn&& fn) {
+    auto queued = RPCClock::now();
+    // The task is done by the time add_task() returns, so it can write to `timing`.
+    return m_worker.add_task([&timing, queued, fn = std::move(fn)]() mutable {
+        js::TraceScope trace("rpc", "execute");
+        auto start = RPCClock::now();
+        timing.queue_wait = start - queued;
+        json result = fn();
+        timing.execute = RPCClock::now() - start;
+        return result;
+    });
+}
 
+json RPCServer::handle_request(std::string const& name, json&& args, RPCRequestTiming& timing) {
     // Only create_session is allowed without the correct session id (since it creates the session id).
     if (name != "/create_session" && m_session_id != args["sessionId"].get<RPCObjectID>()) {
         return {{"error", "Invalid session ID"}};
@@ -601,44 +823,149 @@ json RPCServer::perform_request(std::string const& name, json&& args) {
         return m_worker.try_pop_callback();
     }
 
+    if (name == "/batch") {
+        return perform_batch(std::move(args["requests"]), timing);
+    }
     RPCRequest *action = &m_requests[name];
     REALM_ASSERT_RELEASE(action && *action);
 
-    return m_worker.add_task([=] {
-        try {
-            return (*action)(args);
+    return run_timed_task(timing, [=] {
+        return run_request(*action, args);
+    });
+}
+
+json RPCServer::perform_stats_request(json const& args) {
+    if (args.count("slowRequestThreshold")) {
+        double threshold_ms = args["slowRequestThreshold"].get<double>();
+        if (threshold_ms < 0) {
+            return {{"error", "slowRequestThreshold must not be negative"}};
         }
-        catch (jsc::Exception const& ex) {
-            json exceptionAsJson = nullptr;
+        m_stats.set_slow_threshold(std::chrono::duration_cast<RPCClock::duration>(
+            std::chrono::duration<double, std::milli>(threshold_ms)));
+    }
+
+    json stats = m_stats.to_json();
+    if (args.value("reset", false)) {
+        m_stats.reset();
+    }
+    return {{"result", std::move(stats)}};
+}
+
+json RPCServer::perform_batch(json&& requests, RPCRequestTiming& timing) {
+    if (!requests.is_array()) {
+        return {{"error", "Batch requests must be an array"}};
+    }
+
+    // Look up every request before running any of them, so that a batch
+    // either runs until one of its requests fails or not at all.
+    std::vector<RPCRequest*> actions;
+    for (auto& request : requests) {
+        auto name = "/" + request.value("request", std::string());
+        auto it = m_requests.find(name);
+        if (it == m_requests.end() || name == "/create_session") {
+            return {{"error", "Invalid batched request: " + name}};
+        }
+        actions.push_back(&it->second);
+    }
+
+    // The whole batch runs as a single task, so callbacks invoked by any of
+    // its requests get to the client the same way as for a single request.
+    return run_timed_task(timing, [=, requests = std::move(requests)]() mutable {
+        json results = json::array();
+        for (size_t i = 0; i < requests.size(); ++i) {
+            json response;
             try {
-                exceptionAsJson = serialize_json_value(ex);
+                resolve_batch_results(requests[i], results);
+                response = run_request(*actions[i], requests[i]);
             }
-            catch (...) {
-                exceptionAsJson = {{"error", "An exception occured while processing the request. Could not serialize the exception as JSON"}};
+            catch (std::exception const& exception) {
+                response = {{"error", exception.what()}};
             }
-            return (json){{"error", exceptionAsJson}, {"message", ex.what()}};
-        }
-        catch (std::exception const& exception) {
-            return (json){{"error", exception.what()}};
+
+            // Later requests may depend on the failed one, so they're skipped.
+            if (response.count("error")) {
+                response["index"] = i;
+                return response;
+            }
+            results.push_back(response.value("result", json()));
         }
+        return (json){{"result", std::move(results)}};
     });
 }
 
+json RPCServer::run_request(RPCRequest const& action, json const& args) {
+    try {
+        return action(args);
+    }
+    catch (jsc::Exception const& ex) {
+        json exceptionAsJson = nullptr;
+        try {
+            exceptionAsJson = serialize_json_value(ex);
+        }
+        catch (...) {
+            exceptionAsJson = {{"error", "An exception occured while processing the request. Could not serialize the exception as JSON"}};
+        }
+        return (json){{"error", exceptionAsJson}, {"message", ex.what()}};
+    }
+    catch (std::exception const& exception) {
+        return (json){{"error", exception.what()}};
+    }
+}
+
 bool RPCServer::try_run_task() {
     return m_worker.try_run_task();
 }
 
-RPCObjectID RPCServer::store_object(JSObjectRef object) {
-    static RPCObjectID s_next_id = 1;
+void RPCServer::set_callback_listener(std::function<void()> listener) {
+    m_worker.set_callback_listener(std::move(listener));
+}
+
+json RPCServer::pop_callback() {
+    std::lock_guard<std::mutex> lock(m_request_mutex);
+    json callback = m_worker.try_pop_callback();
+    json callbacks = m_worker.take_async_callbacks();
+    if (!callbacks.empty()) {
+        callback["callbacks"] = std::move(callbacks);
+    }
+    return callback;
+}
+
+RPCEncoding RPCServer::session_encoding() {
+    // Written by /create_session while a request is being performed.
+    std::lock_guard<std::mutex> lock(m_request_mutex);
+    return m_session_encoding;
+}
+
+void RPCServer::set_prefetch_options(json const& options) {
+    if (!options.is_object()) {
+        return;
+    }
+    m_prefetch_window = options.value("window", m_prefetch_window);
+    m_max_cached_string_size = options.value("maxStringSize", m_max_cached_string_size);
+}
+
+json RPCServer::serialize_range(JSObjectRef collection, size_t start, size_t count) {
+    size_t length = jsc::Object::validated_get_length(m_context, collection);
+    size_t end = std::min(length, start + std::min(count, length));
+
+    json values = json::array();
+    for (size_t i = start; i < end; ++i) {
+        values.push_back(serialize_json_value(jsc::Object::get_property(m_context, collection, static_cast<unsigned int>(i))));
+    }
+    return {
+        {"length", length},
+        {"start", start},
+        {"values", std::move(values)},
+    };
+}
 
-    RPCObjectID next_id = s_next_id++;
-    m_objects.emplace(next_id, js::Protected<JSObjectRef>(m_context, object));
-    return next_id;
+RPCObjectID RPCServer::store_object(JSObjectRef object) {
+    return m_objects.insert(js::Protected<JSObjectRef>(m_context, object));
 }
 
 JSObjectRef RPCServer::get_object(RPCObjectID oid) const {
-    auto it = m_objects.find(oid);
-    return it == m_objects.end() ? nullptr : static_cast<JSObjectRef>(it->second);
+    auto object = m_objects.get(oid);
+    return object ? static_cast<JSObjectRef>(*object) : nullptr;
 }
 
 JSObjectRef RPCServer::get_realm_constructor() const {
@@ -678,26 +1005,34 @@ json RPCServer::serialize_json_value(JSValueRef js_value) {
             {"type", RealmObjectTypesObject},
             {"id", store_object(js_object)},
             {"schema", serialize_object_schema(object->get_object_schema())},
-            {"cache", read_object_properties(*object)}
+            {"cache", read_object_properties(*object, m_binary, m_max_cached_string_size)}
         };
     }
     else if (jsc::Object::is_instance<js::ListClass<jsc::Types>>(m_context, js_object)) {
         auto list = jsc::Object::get_internal<js::ListClass<jsc::Types>>(js_object);
-        return {
+        json result = {
             {"type", RealmObjectTypesList},
             {"id", store_object(js_object)},
             {"dataType", string_for_property_type(list->get_type() & ~realm::PropertyType::Flags)},
             {"optional", is_nullable(list->get_type())},
-         };
+        };
+        if (m_prefetch_window) {
+            result["prefetch"] = serialize_range(js_object, 0, m_prefetch_window);
+        }
+        return result;
     }
     else if (jsc::Object::is_instance<js::ResultsClass<jsc::Types>>(m_context, js_object)) {
         auto results = jsc::Object::get_internal<js::ResultsClass<jsc::Types>>(js_object);
-        return {
+        json result = {
             {"type", RealmObjectTypesResults},
             {"id", store_object(js_object)},
             {"dataType", string_for_property_type(results->get_type() & ~realm::PropertyType::Flags)},
             {"optional", is_nullable(results->get_type())},
         };
+        if (m_prefetch_window) {
+            result["prefetch"] = serialize_range(js_object, 0, m_prefetch_window);
+        }
+        return result;
     }
     else if (jsc::Object::is_instance<js::RealmClass<jsc::Types>>(m_context, js_object)) {
         auto realm = jsc::Object::get_internal<js::RealmClass<jsc::Types>>(js_object);
@@ -757,6 +1092,31 @@ json RPCServer::serialize_json_value(JSValueRef js_value) {
             {"id", store_object(js_object)},
         };
     }
+    else if (jsc::Object::is_instance<js::CollectionChangeSetClass<jsc::Types>>(m_context, js_object)) {
+        // Typed arrays would arrive as plain binary data, so Int32Array change
+        // sets are sent as arrays of indices.
+        auto change_set = jsc::Object::get_internal<js::CollectionChangeSetClass<jsc::Types>>(js_object);
+        auto format = change_set->format == js::ChangeSetFormat::Ranges ? js::ChangeSetFormat::Ranges : js::ChangeSetFormat::Array;
+        auto indices = [&](const IndexSet& index_set) {
+            return serialize_json_value(js::CollectionChangeSetClass<jsc::Types>::create_indices(m_context, index_set, format));
+        };
+        auto& changes = change_set->change_set;
+        json deletions = changes.deletions.count() == std::numeric_limits<size_t>::max()
+            ? serialize_json_value(jsc::Object::get_property(m_context, js_object, "deletions"))
+            : indices(changes.deletions);
+        json modifications = indices(changes.modifications);
+        return {
+            {"type", RealmObjectTypesDictionary},
+            {"keys", {"deletions", "insertions", "modifications", "oldModifications", "newModifications"}},
+            {"values", {
+                deletions,
+                indices(changes.insertions),
+                modifications,
+                modifications,
+                indices(changes.modifications_new),
+            }},
+        };
+    }
     else if (jsc::Value::is_array(m_context, js_object)) {
         uint32_t length = jsc::Object::validated_get_length(m_context, js_object);
         std::vector<json> array;
@@ -767,15 +1127,29 @@ json RPCServer::serialize_json_value(JSValueRef js_value) {
     }
     else if (jsc::Value::is_binary(m_context, js_object)) {
         auto data = jsc::Value::to_binary(m_context, js_object);
+        if (m_binary) {
+            return {
+                {"type", RealmObjectTypesData},
+                {"bytes", std::string(data.data(), data.size())},
+            };
+        }
         return {
             {"type", RealmObjectTypesData},
             {"value", base64_encode((unsigned char *)data.data(), data.size())},
         };
     }
     else if (jsc::Value::is_date(m_context, js_object)) {
+        double milliseconds = jsc::Value::to_number(m_context, js_object);
+        if (m_binary) {
+            double seconds = std::floor(milliseconds / 1000);
+            return {
+                {"type", RealmObjectTypesDate},
+                {"timestamp", {int64_t(seconds), uint32_t((milliseconds - seconds * 1000) * 1000000)}},
+            };
+        }
         return {
             {"type", RealmObjectTypesDate},
-            {"value", jsc::Value::to_number(m_context, js_object)},
+            {"value", milliseconds},
         };
     }
     else if (jsc::Value::is_function(m_context, js_object)) {
@@ -813,7 +1187,7 @@ json RPCServer::serialize_json_value(JSValueRef js_value) {
 JSValueRef RPCServer::deserialize_json_value(const json dict) {
     json oid = dict.value("id", json());
     if (oid.is_number()) {
-        return m_objects[oid.get<RPCObjectID>()];
+        return get_object(oid.get<RPCObjectID>());
     }
 
     json value = dict.value("value", json());
@@ -825,6 +1199,15 @@ JSValueRef RPCServer::deserialize_json_value(const json dict) {
         if (type_string == RealmObjectTypesFunction) {
             RPCObjectID callback_id = value.get<RPCObjectID>();
 
+            if (dict.value("async", false)) {
+                if (!m_async_callbacks.count(callback_id)) {
+                    JSObjectRef callback = JSObjectMakeFunctionWithCallback(m_context, nullptr, run_async_callback);
+                    m_async_callbacks.emplace(callback_id, js::Protected<JSObjectRef>(m_context, callback));
+                    m_callback_ids.emplace(callback, callback_id);
+                }
+                return m_async_callbacks.at(callback_id);
+            }
+
             if (!m_callbacks.count(callback_id)) {
                 JSObjectRef callback = JSObjectMakeFunctionWithCallback(m_context, nullptr, run_callback);
                 m_callbacks.emplace(callback_id, js::Protected<JSObjectRef>(m_context, callback));
@@ -848,6 +1231,11 @@ JSValueRef RPCServer::deserialize_json_value(const json dict) {
             return js_object;
         }
         else if (type_string == RealmObjectTypesData) {
+            auto raw_bytes = dict.find("bytes");
+            if (raw_bytes != dict.end()) {
+                auto& bytes = raw_bytes->get_ref<const std::string&>();
+                return jsc::Value::from_binary(m_context, realm::BinaryData(bytes.data(), bytes.size()));
+            }
             std::string bytes;
             if (!base64_decode(value.get<std::string>(), &bytes)) {
                 throw std::runtime_error("Failed to decode base64 encoded data");
@@ -855,6 +1243,10 @@ JSValueRef RPCServer::deserialize_json_value(const json dict) {
             return jsc::Value::from_binary(m_context, realm::BinaryData(bytes.data(), bytes.size()));
         }
         else if (type_string == RealmObjectTypesDate) {
+            auto timestamp = dict.find("timestamp");
+            if (timestamp != dict.end()) {
+                return jsc::Object::create_date(m_context, (*timestamp)[0].get<int64_t>() * 1000.0 + (*timestamp)[1].get<uint32_t>() / 1000000.0);
+            }
             return jsc::Object::create_date(m_context, value.get<double>());
         }
         else if (type_string == RealmObjectTypesUndefined) {
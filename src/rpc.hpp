@@ -18,12 +18,16 @@
 
 #pragma once
 
+#include <atomic>
 #include <functional>
 #include <future>
 #include <thread>
+#include <unordered_map>
 
-#include "concurrent_deque.hpp"
+#include "concurrent_stack.hpp"
+#include "generational_slab.hpp"
 #include "json.hpp"
+#include "rpc_stats.hpp"
 #include "jsc/jsc_types.hpp"
 #include "jsc/jsc_protected.hpp"
 
@@ -53,51 +57,128 @@ class RPCWorker {
     void stop();
     json try_pop_callback();
     bool should_stop();
+    // Called on the worker thread whenever a callback is queued for the client
+    // to pick up, so that a transport which can push messages doesn't need
+    // to wait to be polled.
+    void set_callback_listener(std::function<void()>);
+
+    // Calls to callbacks whose results aren't needed, which are sent to the
+    // client in batches along with whatever it receives next.
+    void push_async_callback(json&& callback);
+    json take_async_callbacks();
 
   private:
     bool m_stop = false;
     int m_depth = 0;
+    std::mutex m_callback_listener_mutex;
+    std::function<void()> m_callback_listener;
+    std::mutex m_async_callbacks_mutex;
+    json m_async_callbacks = json::array();
 #if __APPLE__
     std::thread m_thread;
     CFRunLoopRef m_loop;
 #endif
-    ConcurrentDeque<std::function<void()>> m_tasks;
-    ConcurrentDeque<std::promise<json>> m_promises;
-    ConcurrentDeque<json> m_callbacks;
+    ConcurrentStack<std::function<void()>> m_tasks;
+    ConcurrentStack<std::promise<json>> m_promises;
+    ConcurrentStack<json> m_callbacks;
+
+    void push_callback(json&& callback);
+    void notify_callback_listener();
+};
+
+enum class RPCEncoding {
+    JSON,
+    MessagePack,
 };
 
 class RPCServer {
   public:
     RPCServer();
     ~RPCServer();
-    json perform_request(std::string const& name, json&& args);
+    json perform_request(std::string const& name, json&& args, RPCEncoding encoding = RPCEncoding::JSON);
+    // Decodes a request body and encodes the response in the given encoding.
+    std::string perform_request(std::string const& name, std::string const& body, RPCEncoding encoding);
     bool try_run_task();
 
+    static RPCEncoding encoding_for_content_type(std::string const& content_type);
+    static const char* content_type(RPCEncoding encoding);
+
+    // Used by transports other than plain HTTP requests, which push the
+    // callbacks invoked from the event loop instead of waiting for
+    // /callbacks_poll.
+    void set_callback_listener(std::function<void()> listener);
+    json pop_callback();
+    RPCEncoding session_encoding();
+    // Sent to the client with its session so that it can connect.
+    void set_websocket_port(uint16_t port) { m_websocket_port = port; }
+    // Used by transports which decode and encode messages themselves, so
+    // that the time spent doing that is counted too.
+    json perform_request(std::string const& name, json&& args, RPCEncoding encoding, RPCRequestTiming& timing);
+    void record_request(std::string const& name, RPCRequestTiming const& timing) { m_stats.record(name, timing); }
 
   private:
     JSGlobalContextRef m_context;
     std::mutex m_request_mutex;
     std::map<std::string, RPCRequest> m_requests;
-    std::map<RPCObjectID, js::Protected<JSObjectRef>> m_objects;
-    std::map<RPCObjectID, js::Protected<JSObjectRef>> m_callbacks;
+    // Objects are kept alive until the client releases them or the session is reset.
+    GenerationalSlab<js::Protected<JSObjectRef>> m_objects;
+    // Callback ids are chosen by the client, so they're looked up by hash instead.
+    std::unordered_map<RPCObjectID, js::Protected<JSObjectRef>> m_callbacks;
+    // The functions for callbacks which the client marked as asynchronous,
+    // which return right away instead of waiting for the client's result.
+    std::unordered_map<RPCObjectID, js::Protected<JSObjectRef>> m_async_callbacks;
     // The key here is the same as the value in m_callbacks. We use the raw pointer as a key here,
     // because protecting the value in m_callbacks pins the function object and prevents it from being moved
     // by the garbage collector upon compaction.
-    std::map<JSObjectRef, RPCObjectID> m_callback_ids;
-    RPCObjectID m_session_id;
+    std::unordered_map<JSObjectRef, RPCObjectID> m_callback_ids;
+    // Atomic so that /stats can check it without waiting for m_request_mutex.
+    std::atomic<RPCObjectID> m_session_id{0};
+    RPCEncoding m_session_encoding = RPCEncoding::JSON;
+    uint16_t m_websocket_port = 0;
+    // Whether the request being performed came in as MessagePack, so that
+    // binary data and dates can be sent without converting them to text.
+    bool m_binary = false;
+    // How many rows of a Results or List are sent along with it, and how long
+    // a string property can be to be sent along with its object.
+    size_t m_prefetch_window = 0;
+    size_t m_max_cached_string_size = 100;
     RPCWorker m_worker;
+    RPCStats m_stats;
     u_int64_t m_callback_call_counter;
     uint64_t m_reset_counter = 0;
 
+    struct PendingCallbackHash {
+        size_t operator()(const std::pair<uint64_t, uint64_t>& key) const {
+            return std::hash<uint64_t>()(key.first) ^ (std::hash<uint64_t>()(key.second) * 0x9e3779b97f4a7c15);
+        }
+    };
+
     std::mutex m_pending_callbacks_mutex;
-    std::map<std::pair<uint64_t, uint64_t>, std::promise<json>> m_pending_callbacks;
+    std::unordered_map<std::pair<uint64_t, uint64_t>, std::promise<json>, PendingCallbackHash> m_pending_callbacks;
+
+    // Runs an ordered array of requests as one task. Requests can use the
+    // results of earlier ones in the same batch, so that the client doesn't
+    // need a round trip for each of them.
+    json perform_batch(json&& requests, RPCRequestTiming& timing);
+    json run_request(RPCRequest const& action, json const& args);
+    json handle_request(std::string const& name, json&& args, RPCRequestTiming& timing);
+    // Runs `fn` on the worker, timing how long it waited and how long it ran.
+    template<typename Fn>
+    json run_timed_task(RPCRequestTiming& timing, Fn&& fn);
+    json perform_stats_request(json const& args);
 
     static JSValueRef run_callback(JSContextRef, JSObjectRef, JSObjectRef, size_t, const JSValueRef[], JSValueRef *exception);
+    static JSValueRef run_async_callback(JSContextRef, JSObjectRef, JSObjectRef, size_t, const JSValueRef[], JSValueRef *exception);
 
     RPCObjectID store_object(JSObjectRef object);
     JSObjectRef get_object(RPCObjectID) const;
     JSObjectRef get_realm_constructor() const;
 
+    void set_prefetch_options(json const& options);
+    // Serializes up to `count` elements of a Results or List from `start`,
+    // along with its length.
+    json serialize_range(JSObjectRef collection, size_t start, size_t count);
+
     json serialize_json_value(JSValueRef value);
     JSValueRef deserialize_json_value(const json dict);
 };
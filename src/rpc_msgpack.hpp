@@ -0,0 +1,398 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2020 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "json.hpp"
+
+namespace realm {
+namespace rpc {
+namespace msgpack {
+
+using json = nlohmann::json;
+
+// MessagePack encoding of RPC messages.
+//
+// Messages are built as json trees like the JSON encoding, with two
+// exceptions which let binary data and dates skip the text conversions:
+// a `{"type": "data"}` value carries its raw bytes in a `"bytes"` string,
+// which is sent as a MessagePack bin, and a `{"type": "date"}` value carries
+// `"timestamp": [seconds, nanoseconds]`, which is sent as a MessagePack
+// timestamp extension. Decoding turns bins and timestamps back into those.
+
+namespace detail {
+
+inline void write_big_endian(std::string& out, uint64_t value, size_t size) {
+    for (size_t i = size; i > 0; --i) {
+        out.push_back(static_cast<char>((value >> ((i - 1) * 8)) & 0xff));
+    }
+}
+
+inline void write_header(std::string& out, size_t size, uint8_t fix_tag, size_t fix_limit, uint8_t tag16) {
+    if (size < fix_limit) {
+        out.push_back(static_cast<char>(fix_tag | size));
+    }
+    else if (size <= 0xffff) {
+        out.push_back(static_cast<char>(tag16));
+        write_big_endian(out, size, 2);
+    }
+    else {
+        out.push_back(static_cast<char>(tag16 + 1));
+        write_big_endian(out, size, 4);
+    }
+}
+
+inline void write_string(std::string& out, const std::string& string) {
+    size_t size = string.size();
+    if (size < 32) {
+        out.push_back(static_cast<char>(0xa0 | size));
+    }
+    else if (size <= 0xff) {
+        out.push_back(static_cast<char>(0xd9));
+        write_big_endian(out, size, 1);
+    }
+    else if (size <= 0xffff) {
+        out.push_back(static_cast<char>(0xda));
+        write_big_endian(out, size, 2);
+    }
+    else {
+        out.push_back(static_cast<char>(0xdb));
+        write_big_endian(out, size, 4);
+    }
+    out.append(string);
+}
+
+inline void write_bin(std::string& out, const std::string& bytes) {
+    size_t size = bytes.size();
+    if (size <= 0xff) {
+        out.push_back(static_cast<char>(0xc4));
+        write_big_endian(out, size, 1);
+    }
+    else if (size <= 0xffff) {
+        out.push_back(static_cast<char>(0xc5));
+        write_big_endian(out, size, 2);
+    }
+    else {
+        out.push_back(static_cast<char>(0xc6));
+        write_big_endian(out, size, 4);
+    }
+    out.append(bytes);
+}
+
+inline void write_timestamp(std::string& out, int64_t seconds, int64_t nanoseconds) {
+    // Timestamps before the epoch have negative nanoseconds, as in core's
+    // Timestamp, while MessagePack's are always positive.
+    seconds += nanoseconds / 1000000000;
+    nanoseconds %= 1000000000;
+    if (nanoseconds < 0) {
+        nanoseconds += 1000000000;
+        --seconds;
+    }
+
+    // timestamp 96
+    out.push_back(static_cast<char>(0xc7));
+    out.push_back(12);
+    out.push_back(-1);
+    write_big_endian(out, nanoseconds, 4);
+    write_big_endian(out, static_cast<uint64_t>(seconds), 8);
+}
+
+inline void write_unsigned(std::string& out, uint64_t value) {
+    if (value < 0x80) {
+        out.push_back(static_cast<char>(value));
+    }
+    else if (value <= 0xff) {
+        out.push_back(static_cast<char>(0xcc));
+        write_big_endian(out, value, 1);
+    }
+    else if (value <= 0xffff) {
+        out.push_back(static_cast<char>(0xcd));
+        write_big_endian(out, value, 2);
+    }
+    else if (value <= 0xffffffff) {
+        out.push_back(static_cast<char>(0xce));
+        write_big_endian(out, value, 4);
+    }
+    else {
+        out.push_back(static_cast<char>(0xcf));
+        write_big_endian(out, value, 8);
+    }
+}
+
+inline void write_integer(std::string& out, int64_t value) {
+    if (value >= 0) {
+        write_unsigned(out, static_cast<uint64_t>(value));
+    }
+    else if (value >= -32) {
+        out.push_back(static_cast<char>(value));
+    }
+    else {
+        out.push_back(static_cast<char>(0xd3));
+        write_big_endian(out, static_cast<uint64_t>(value), 8);
+    }
+}
+
+inline void write_double(std::string& out, double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    out.push_back(static_cast<char>(0xcb));
+    write_big_endian(out, bits, 8);
+}
+
+inline void write(std::string& out, const json& value) {
+    switch (value.type()) {
+        case json::value_t::boolean:
+            out.push_back(static_cast<char>(value.get<bool>() ? 0xc3 : 0xc2));
+            return;
+        case json::value_t::number_integer:
+            write_integer(out, value.get<int64_t>());
+            return;
+        case json::value_t::number_unsigned:
+            write_unsigned(out, value.get<uint64_t>());
+            return;
+        case json::value_t::number_float:
+            write_double(out, value.get<double>());
+            return;
+        case json::value_t::string:
+            write_string(out, value.get_ref<const std::string&>());
+            return;
+        case json::value_t::array:
+            write_header(out, value.size(), 0x90, 16, 0xdc);
+            for (auto& element : value) {
+                write(out, element);
+            }
+            return;
+        case json::value_t::object: {
+            auto type = value.find("type");
+            bool is_data = type != value.end() && *type == "data";
+            bool is_date = type != value.end() && *type == "date";
+
+            write_header(out, value.size(), 0x80, 16, 0xde);
+            for (auto it = value.begin(); it != value.end(); ++it) {
+                write_string(out, it.key());
+                if (is_data && it.key() == "bytes" && it->is_string()) {
+                    write_bin(out, it->get_ref<const std::string&>());
+                }
+                else if (is_date && it.key() == "timestamp" && it->is_array() && it->size() == 2) {
+                    write_timestamp(out, (*it)[0].get<int64_t>(), (*it)[1].get<int64_t>());
+                }
+                else {
+                    write(out, *it);
+                }
+            }
+            return;
+        }
+        default:
+            out.push_back(static_cast<char>(0xc0));
+            return;
+    }
+}
+
+class Reader {
+public:
+    Reader(const char* data, size_t size) : m_data(reinterpret_cast<const uint8_t*>(data)), m_end(m_data + size) {}
+
+    json read() {
+        uint8_t tag = byte();
+        if (tag < 0x80) {
+            return static_cast<uint64_t>(tag);
+        }
+        if (tag >= 0xe0) {
+            return static_cast<int64_t>(static_cast<int8_t>(tag));
+        }
+        if ((tag & 0xf0) == 0x80) {
+            return read_object(tag & 0x0f);
+        }
+        if ((tag & 0xf0) == 0x90) {
+            return read_array(tag & 0x0f);
+        }
+        if ((tag & 0xe0) == 0xa0) {
+            return take(tag & 0x1f);
+        }
+
+        switch (tag) {
+            case 0xc0: return nullptr;
+            case 0xc2: return false;
+            case 0xc3: return true;
+            case 0xc4: return take(number(1));
+            case 0xc5: return take(number(2));
+            case 0xc6: return take(number(4));
+            case 0xc7: return read_ext(number(1));
+            case 0xc8: return read_ext(number(2));
+            case 0xc9: return read_ext(number(4));
+            case 0xca: {
+                uint32_t bits = static_cast<uint32_t>(number(4));
+                float value;
+                std::memcpy(&value, &bits, sizeof(value));
+                return static_cast<double>(value);
+            }
+            case 0xcb: {
+                uint64_t bits = number(8);
+                double value;
+                std::memcpy(&value, &bits, sizeof(value));
+                return value;
+            }
+            case 0xcc: return number(1);
+            case 0xcd: return number(2);
+            case 0xce: return number(4);
+            case 0xcf: return number(8);
+            case 0xd0: return static_cast<int64_t>(static_cast<int8_t>(number(1)));
+            case 0xd1: return static_cast<int64_t>(static_cast<int16_t>(number(2)));
+            case 0xd2: return static_cast<int64_t>(static_cast<int32_t>(number(4)));
+            case 0xd3: return static_cast<int64_t>(number(8));
+            case 0xd4: return read_ext(1);
+            case 0xd5: return read_ext(2);
+            case 0xd6: return read_ext(4);
+            case 0xd7: return read_ext(8);
+            case 0xd8: return read_ext(16);
+            case 0xd9: return take(number(1));
+            case 0xda: return take(number(2));
+            case 0xdb: return take(number(4));
+            case 0xdc: return read_array(number(2));
+            case 0xdd: return read_array(number(4));
+            case 0xde: return read_object(number(2));
+            case 0xdf: return read_object(number(4));
+        }
+        throw std::runtime_error("Invalid MessagePack data");
+    }
+
+    bool done() const {
+        return m_data == m_end;
+    }
+
+private:
+    // Arrays and maps nested deeper than this are rejected rather than
+    // letting a malformed message exhaust the stack.
+    static constexpr size_t max_depth = 512;
+
+    const uint8_t* m_data;
+    const uint8_t* m_end;
+    size_t m_depth = 0;
+
+    struct Nesting {
+        Nesting(size_t& depth) : m_depth(depth) {
+            if (++m_depth > max_depth) {
+                --m_depth;
+                throw std::runtime_error("MessagePack data is nested too deeply");
+            }
+        }
+        ~Nesting() {
+            --m_depth;
+        }
+
+        size_t& m_depth;
+    };
+
+    uint8_t byte() {
+        if (m_data == m_end) {
+            throw std::runtime_error("Unexpected end of MessagePack data");
+        }
+        return *m_data++;
+    }
+
+    uint64_t number(size_t size) {
+        uint64_t value = 0;
+        for (size_t i = 0; i < size; ++i) {
+            value = (value << 8) | byte();
+        }
+        return value;
+    }
+
+    std::string take(size_t size) {
+        if (size_t(m_end - m_data) < size) {
+            throw std::runtime_error("Unexpected end of MessagePack data");
+        }
+        std::string string(reinterpret_cast<const char*>(m_data), size);
+        m_data += size;
+        return string;
+    }
+
+    json read_array(size_t size) {
+        Nesting nesting(m_depth);
+        json array = json::array();
+        for (size_t i = 0; i < size; ++i) {
+            array.push_back(read());
+        }
+        return array;
+    }
+
+    json read_object(size_t size) {
+        Nesting nesting(m_depth);
+        json object = json::object();
+        for (size_t i = 0; i < size; ++i) {
+            json key = read();
+            if (!key.is_string()) {
+                throw std::runtime_error("MessagePack map keys must be strings");
+            }
+            object[key.get<std::string>()] = read();
+        }
+        return object;
+    }
+
+    json read_ext(size_t size) {
+        int8_t type = static_cast<int8_t>(byte());
+        std::string payload = take(size);
+        if (type != -1) {
+            throw std::runtime_error("Unsupported MessagePack extension type");
+        }
+
+        Reader reader(payload.data(), payload.size());
+        switch (size) {
+            case 4:
+                return json::array({static_cast<int64_t>(reader.number(4)), 0});
+            case 8: {
+                uint64_t value = reader.number(8);
+                return json::array({static_cast<int64_t>(value & 0x3ffffffff), static_cast<uint32_t>(value >> 34)});
+            }
+            case 12: {
+                uint32_t nanoseconds = static_cast<uint32_t>(reader.number(4));
+                return json::array({static_cast<int64_t>(reader.number(8)), nanoseconds});
+            }
+        }
+        throw std::runtime_error("Invalid MessagePack timestamp");
+    }
+};
+
+} // namespace detail
+
+inline std::string encode(const json& value) {
+    std::string out;
+    detail::write(out, value);
+    return out;
+}
+
+inline json decode(const char* data, size_t size) {
+    detail::Reader reader(data, size);
+    json value = reader.read();
+    if (!reader.done()) {
+        throw std::runtime_error("Unexpected data after MessagePack value");
+    }
+    return value;
+}
+
+inline json decode(const std::string& data) {
+    return decode(data.data(), data.size());
+}
+
+} // namespace msgpack
+} // namespace rpc
+} // namespace realm
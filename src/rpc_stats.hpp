@@ -0,0 +1,214 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2020 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "json.hpp"
+
+namespace realm {
+namespace rpc {
+
+using RPCClock = std::chrono::steady_clock;
+
+// How long each stage of a request took, filled in as it's performed.
+struct RPCRequestTiming {
+    // Decoding the request body from JSON or MessagePack.
+    RPCClock::duration deserialize{};
+    // Waiting for the worker to pick the request up.
+    RPCClock::duration queue_wait{};
+    // Running the request on the worker, including converting its arguments
+    // and result to and from JS values.
+    RPCClock::duration execute{};
+    // Encoding the response.
+    RPCClock::duration serialize{};
+    size_t bytes_in = 0;
+    size_t bytes_out = 0;
+    bool error = false;
+
+    RPCClock::duration total() const {
+        return deserialize + queue_wait + execute + serialize;
+    }
+};
+
+// Counts durations in power-of-two buckets of microseconds, so that it stays
+// small however many requests it has seen. Bucket i holds the durations of
+// less than 2^i microseconds which didn't fit in bucket i - 1.
+class RPCHistogram {
+  public:
+    static constexpr size_t bucket_count = 32;
+
+    void add(RPCClock::duration duration) {
+        uint64_t us = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+        size_t bucket = 0;
+        while (bucket + 1 < bucket_count && (uint64_t(1) << bucket) <= us) {
+            ++bucket;
+        }
+        ++m_buckets[bucket];
+        ++m_count;
+        m_total_us += us;
+        if (us > m_max_us) {
+            m_max_us = us;
+        }
+    }
+
+    nlohmann::json to_json() const {
+        // Trailing empty buckets are left out.
+        size_t used = bucket_count;
+        while (used > 0 && m_buckets[used - 1] == 0) {
+            --used;
+        }
+        nlohmann::json buckets = nlohmann::json::array();
+        for (size_t i = 0; i < used; ++i) {
+            buckets.push_back(m_buckets[i]);
+        }
+        return {
+            {"count", m_count},
+            {"totalMicros", m_total_us},
+            {"maxMicros", m_max_us},
+            {"buckets", std::move(buckets)},
+        };
+    }
+
+  private:
+    uint64_t m_buckets[bucket_count] = {};
+    uint64_t m_count = 0;
+    uint64_t m_total_us = 0;
+    uint64_t m_max_us = 0;
+};
+
+// Per-request counters and latency histograms for the RPC server, along with
+// a log of the most recent requests which took longer than a threshold.
+class RPCStats {
+  public:
+    static constexpr size_t max_slow_requests = 100;
+
+    void record(std::string const& name, RPCRequestTiming const& timing) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Endpoint& endpoint = m_endpoints[name];
+        ++endpoint.count;
+        if (timing.error) {
+            ++endpoint.errors;
+        }
+        endpoint.bytes_in += timing.bytes_in;
+        endpoint.bytes_out += timing.bytes_out;
+        endpoint.deserialize.add(timing.deserialize);
+        endpoint.queue_wait.add(timing.queue_wait);
+        endpoint.execute.add(timing.execute);
+        endpoint.serialize.add(timing.serialize);
+        endpoint.total.add(timing.total());
+
+        if (m_slow_threshold != RPCClock::duration::zero() && timing.total() >= m_slow_threshold) {
+            m_slow_requests.push_back({name, timing, std::chrono::system_clock::now()});
+            if (m_slow_requests.size() > max_slow_requests) {
+                m_slow_requests.pop_front();
+            }
+        }
+    }
+
+    // A threshold of zero turns the slow request log off.
+    void set_slow_threshold(RPCClock::duration threshold) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_slow_threshold = threshold;
+    }
+
+    void reset() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_endpoints.clear();
+        m_slow_requests.clear();
+    }
+
+    nlohmann::json to_json() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        nlohmann::json endpoints = nlohmann::json::object();
+        for (auto const& entry : m_endpoints) {
+            Endpoint const& endpoint = entry.second;
+            endpoints[entry.first] = {
+                {"count", endpoint.count},
+                {"errors", endpoint.errors},
+                {"bytesIn", endpoint.bytes_in},
+                {"bytesOut", endpoint.bytes_out},
+                {"deserialize", endpoint.deserialize.to_json()},
+                {"queueWait", endpoint.queue_wait.to_json()},
+                {"execute", endpoint.execute.to_json()},
+                {"serialize", endpoint.serialize.to_json()},
+                {"total", endpoint.total.to_json()},
+            };
+        }
+
+        nlohmann::json slow_requests = nlohmann::json::array();
+        for (auto const& request : m_slow_requests) {
+            slow_requests.push_back({
+                {"request", request.name},
+                {"time", std::chrono::duration_cast<std::chrono::milliseconds>(request.time.time_since_epoch()).count()},
+                {"deserializeMicros", micros(request.timing.deserialize)},
+                {"queueWaitMicros", micros(request.timing.queue_wait)},
+                {"executeMicros", micros(request.timing.execute)},
+                {"serializeMicros", micros(request.timing.serialize)},
+                {"totalMicros", micros(request.timing.total())},
+                {"bytesIn", request.timing.bytes_in},
+                {"bytesOut", request.timing.bytes_out},
+                {"error", request.timing.error},
+            });
+        }
+
+        return {
+            {"endpoints", std::move(endpoints)},
+            {"slowRequestThreshold", micros(m_slow_threshold) / 1000.0},
+            {"slowRequests", std::move(slow_requests)},
+        };
+    }
+
+  private:
+    struct Endpoint {
+        uint64_t count = 0;
+        uint64_t errors = 0;
+        uint64_t bytes_in = 0;
+        uint64_t bytes_out = 0;
+        RPCHistogram deserialize;
+        RPCHistogram queue_wait;
+        RPCHistogram execute;
+        RPCHistogram serialize;
+        RPCHistogram total;
+    };
+
+    struct SlowRequest {
+        std::string name;
+        RPCRequestTiming timing;
+        std::chrono::system_clock::time_point time;
+    };
+
+    mutable std::mutex m_mutex;
+    std::map<std::string, Endpoint> m_endpoints;
+    std::deque<SlowRequest> m_slow_requests;
+    RPCClock::duration m_slow_threshold{};
+
+    static uint64_t micros(RPCClock::duration duration) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    }
+};
+
+} // rpc
+} // realm
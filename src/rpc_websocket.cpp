@@ -0,0 +1,473 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2020 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "rpc_websocket.hpp"
+#include "rpc_msgpack.hpp"
+
+#include "base64.hpp"
+
+using namespace realm;
+using namespace realm::rpc;
+
+namespace {
+static const char * const WebSocketGUID = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+// The origin of the debugger's web worker, which is also the only origin
+// allowed to make requests to the HTTP server.
+static const char * const DebuggerOrigin = "http://localhost:8081";
+static const uint64_t MaxMessageSize = 256 * 1024 * 1024;
+
+enum Opcode : uint8_t {
+    Continuation = 0x0,
+    Text = 0x1,
+    Binary = 0x2,
+    Close = 0x8,
+    Ping = 0x9,
+    Pong = 0xa,
+};
+
+// SHA-1 is only used for the Sec-WebSocket-Accept header of the handshake.
+std::string sha1(std::string const& input) {
+    uint32_t h[5] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0};
+    auto rotate = [](uint32_t value, int bits) { return (value << bits) | (value >> (32 - bits)); };
+
+    std::string message = input;
+    uint64_t bit_length = uint64_t(input.size()) * 8;
+    message.push_back(char(0x80));
+    while (message.size() % 64 != 56) {
+        message.push_back(0);
+    }
+    for (int i = 7; i >= 0; --i) {
+        message.push_back(char((bit_length >> (i * 8)) & 0xff));
+    }
+
+    for (size_t chunk = 0; chunk < message.size(); chunk += 64) {
+        uint32_t w[80];
+        for (int i = 0; i < 16; ++i) {
+            auto byte = [&](int j) { return uint32_t(uint8_t(message[chunk + i * 4 + j])); };
+            w[i] = (byte(0) << 24) | (byte(1) << 16) | (byte(2) << 8) | byte(3);
+        }
+        for (int i = 16; i < 80; ++i) {
+            w[i] = rotate(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+        }
+
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+        for (int i = 0; i < 80; ++i) {
+            uint32_t f, k;
+            if (i < 20) {
+                f = (b & c) | (~b & d);
+                k = 0x5a827999;
+            }
+            else if (i < 40) {
+                f = b ^ c ^ d;
+                k = 0x6ed9eba1;
+            }
+            else if (i < 60) {
+                f = (b & c) | (b & d) | (c & d);
+                k = 0x8f1bbcdc;
+            }
+            else {
+                f = b ^ c ^ d;
+                k = 0xca62c1d6;
+            }
+            uint32_t temp = rotate(a, 5) + f + e + k + w[i];
+            e = d;
+            d = c;
+            c = rotate(b, 30);
+            b = a;
+            a = temp;
+        }
+        h[0] += a;
+        h[1] += b;
+        h[2] += c;
+        h[3] += d;
+        h[4] += e;
+    }
+
+    std::string digest;
+    for (uint32_t value : h) {
+        for (int i = 3; i >= 0; --i) {
+            digest.push_back(char((value >> (i * 8)) & 0xff));
+        }
+    }
+    return digest;
+}
+
+// Returns the trimmed value of an HTTP header, matching its name case-insensitively.
+std::string header_value(std::string const& request, std::string name) {
+    std::string lowercase = request;
+    std::transform(lowercase.begin(), lowercase.end(), lowercase.begin(), ::tolower);
+    std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+
+    size_t start = lowercase.find("\r\n" + name + ":");
+    if (start == std::string::npos) {
+        return {};
+    }
+    start += name.size() + 3;
+    size_t end = request.find("\r\n", start);
+    std::string value = request.substr(start, end - start);
+
+    size_t first = value.find_first_not_of(" \t");
+    size_t last = value.find_last_not_of(" \t");
+    return first == std::string::npos ? std::string() : value.substr(first, last - first + 1);
+}
+
+void set_nonblocking(int fd) {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+}
+}
+
+RPCWebSocketServer::RPCWebSocketServer(RPCServer& server, uint16_t port) : m_server(server) {
+    m_listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (m_listen_fd < 0) {
+        throw std::runtime_error(std::string("Failed to create the RPC WebSocket: ") + strerror(errno));
+    }
+
+    int reuse = 1;
+    setsockopt(m_listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    // Only the debugger on this machine, or forwarded to it, may connect.
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+    if (bind(m_listen_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || listen(m_listen_fd, 1) < 0) {
+        int error = errno;
+        close(m_listen_fd);
+        throw std::runtime_error(std::string("Failed to listen for RPC WebSocket connections: ") + strerror(error));
+    }
+
+    if (pipe(m_wakeup_fds) < 0) {
+        int error = errno;
+        close(m_listen_fd);
+        throw std::runtime_error(std::string("Failed to create the RPC WebSocket: ") + strerror(error));
+    }
+    set_nonblocking(m_wakeup_fds[0]);
+    set_nonblocking(m_wakeup_fds[1]);
+
+    m_server.set_callback_listener([fd = m_wakeup_fds[1]] {
+        char byte = 0;
+        (void)write(fd, &byte, 1);
+    });
+    m_server.set_websocket_port(port);
+
+    m_thread = std::thread([this] { run(); });
+}
+
+RPCWebSocketServer::~RPCWebSocketServer() {
+    m_server.set_callback_listener(nullptr);
+    m_server.set_websocket_port(0);
+
+    m_stop = true;
+    char byte = 0;
+    (void)write(m_wakeup_fds[1], &byte, 1);
+    m_thread.join();
+
+    close(m_listen_fd);
+    close(m_wakeup_fds[0]);
+    close(m_wakeup_fds[1]);
+}
+
+void RPCWebSocketServer::run() {
+    while (!m_stop) {
+        pollfd fds[3] = {
+            {m_wakeup_fds[0], POLLIN, 0},
+            {m_listen_fd, POLLIN, 0},
+            {m_client_fd, POLLIN, 0},
+        };
+        nfds_t count = m_client_fd < 0 ? 2 : 3;
+        if (poll(fds, count, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+
+        if (fds[0].revents & POLLIN) {
+            char buffer[64];
+            while (read(m_wakeup_fds[0], buffer, sizeof(buffer)) > 0) {
+            }
+            if (m_stop) {
+                break;
+            }
+            push_callbacks();
+        }
+        if (count == 3 && fds[2].revents && !read_client()) {
+            close_client();
+        }
+        if (fds[1].revents & POLLIN) {
+            accept_client();
+        }
+    }
+    close_client();
+}
+
+void RPCWebSocketServer::accept_client() {
+    int fd = accept(m_listen_fd, nullptr, nullptr);
+    if (fd < 0) {
+        return;
+    }
+#ifdef SO_NOSIGPIPE
+    int no_sigpipe = 1;
+    setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &no_sigpipe, sizeof(no_sigpipe));
+#endif
+
+    // A new debugger session replaces the previous one.
+    close_client();
+    m_client_fd = fd;
+}
+
+void RPCWebSocketServer::close_client() {
+    if (m_client_fd >= 0) {
+        close(m_client_fd);
+    }
+    m_client_fd = -1;
+    m_open = false;
+    m_input.clear();
+    m_message.clear();
+}
+
+bool RPCWebSocketServer::read_client() {
+    char buffer[16 * 1024];
+    ssize_t size = recv(m_client_fd, buffer, sizeof(buffer), 0);
+    if (size <= 0) {
+        return size < 0 && errno == EINTR;
+    }
+    m_input.append(buffer, size_t(size));
+
+    if (!m_open) {
+        size_t end = m_input.find("\r\n\r\n");
+        if (end == std::string::npos) {
+            return m_input.size() < 64 * 1024;
+        }
+        std::string request = m_input.substr(0, end + 2);
+        m_input.erase(0, end + 4);
+        if (!handshake(request)) {
+            return false;
+        }
+        // Callbacks may have been queued before the client connected.
+        push_callbacks();
+    }
+    return read_frames();
+}
+
+bool RPCWebSocketServer::handshake(std::string const& request) {
+    std::string key = header_value(request, "Sec-WebSocket-Key");
+    std::string origin = header_value(request, "Origin");
+    // Browsers always send an Origin, so requests without one aren't from
+    // the debugger's web worker.
+    if (key.empty() || origin != DebuggerOrigin) {
+        send_frame(0, "HTTP/1.1 403 Forbidden\r\nContent-Length: 0\r\n\r\n");
+        return false;
+    }
+
+    std::string digest = sha1(key + WebSocketGUID);
+    std::string accept = base64_encode(reinterpret_cast<const unsigned char*>(digest.data()), digest.size());
+    send_frame(0, "HTTP/1.1 101 Switching Protocols\r\n"
+                  "Upgrade: websocket\r\n"
+                  "Connection: Upgrade\r\n"
+                  "Sec-WebSocket-Accept: " + accept + "\r\n\r\n");
+    m_open = true;
+    return true;
+}
+
+bool RPCWebSocketServer::read_frames() {
+    while (m_input.size() >= 2) {
+        auto byte = [&](size_t i) { return uint8_t(m_input[i]); };
+        bool fin = byte(0) & 0x80;
+        uint8_t opcode = byte(0) & 0x0f;
+        bool masked = byte(1) & 0x80;
+        uint64_t length = byte(1) & 0x7f;
+
+        size_t offset = 2;
+        if (length >= 126) {
+            size_t size = length == 126 ? 2 : 8;
+            if (m_input.size() < offset + size) {
+                return true;
+            }
+            length = 0;
+            for (size_t i = 0; i < size; ++i) {
+                length = (length << 8) | byte(offset + i);
+            }
+            offset += size;
+        }
+
+        // Clients must mask their frames.
+        if (!masked || length > MaxMessageSize) {
+            return false;
+        }
+        if (m_input.size() < offset + 4 + length) {
+            return true;
+        }
+
+        const char* mask = m_input.data() + offset;
+        offset += 4;
+        std::string payload = m_input.substr(offset, size_t(length));
+        for (size_t i = 0; i < payload.size(); ++i) {
+            payload[i] ^= mask[i % 4];
+        }
+        m_input.erase(0, offset + size_t(length));
+
+        switch (opcode) {
+            case Continuation:
+                m_message += payload;
+                break;
+            case Text:
+            case Binary:
+                m_message = std::move(payload);
+                m_message_binary = opcode == Binary;
+                break;
+            case Close:
+                send_frame(Close, payload.substr(0, 2));
+                return false;
+            case Ping:
+                send_frame(Pong, payload);
+                continue;
+            case Pong:
+                continue;
+            default:
+                return false;
+        }
+
+        if (m_message.size() > MaxMessageSize) {
+            return false;
+        }
+        if (fin) {
+            std::string message = std::move(m_message);
+            m_message.clear();
+            if (!handle_message(message, m_message_binary)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool RPCWebSocketServer::handle_message(std::string const& payload, bool binary) {
+    RPCEncoding encoding = binary ? RPCEncoding::MessagePack : RPCEncoding::JSON;
+    RPCRequestTiming timing;
+    timing.bytes_in = payload.size();
+
+    json message;
+    auto start = RPCClock::now();
+    try {
+        message = binary ? msgpack::decode(payload) : json::parse(payload);
+    }
+    catch (std::exception const&) {
+        return false;
+    }
+    timing.deserialize = RPCClock::now() - start;
+    if (!message.is_object() || !message["request"].is_string()) {
+        return false;
+    }
+
+    std::string name = message["request"].get<std::string>();
+    json response;
+    try {
+        response = m_server.perform_request(name, std::move(message["body"]), encoding, timing);
+    }
+    catch (std::exception const& exception) {
+        response = {{"error", exception.what()}};
+        timing.error = true;
+    }
+
+    start = RPCClock::now();
+    json reply = {{"id", message["id"]}, {"response", std::move(response)}};
+    std::string reply_payload = binary ? msgpack::encode(reply) : reply.dump();
+    timing.serialize = RPCClock::now() - start;
+    timing.bytes_out = reply_payload.size();
+
+    send_frame(binary ? Binary : Text, reply_payload);
+    m_server.record_request(name, timing);
+    return true;
+}
+
+void RPCWebSocketServer::push_callbacks() {
+    while (m_open) {
+        json callback = m_server.pop_callback();
+        if (callback.empty()) {
+            return;
+        }
+        send_message({{"push", std::move(callback)}}, m_server.session_encoding());
+    }
+}
+
+void RPCWebSocketServer::send_message(json const& message, RPCEncoding encoding) {
+    if (encoding == RPCEncoding::MessagePack) {
+        send_frame(Binary, msgpack::encode(message));
+    }
+    else {
+        send_frame(Text, message.dump());
+    }
+}
+
+// Writes a frame with the given opcode, or the raw data if the opcode is 0.
+void RPCWebSocketServer::send_frame(uint8_t opcode, std::string const& payload) {
+    if (m_client_fd < 0) {
+        return;
+    }
+
+    std::string frame;
+    if (opcode) {
+        frame.push_back(char(0x80 | opcode));
+        size_t size = payload.size();
+        if (size < 126) {
+            frame.push_back(char(size));
+        }
+        else if (size <= 0xffff) {
+            frame.push_back(char(126));
+            frame.push_back(char(size >> 8));
+            frame.push_back(char(size & 0xff));
+        }
+        else {
+            frame.push_back(char(127));
+            for (int i = 7; i >= 0; --i) {
+                frame.push_back(char((uint64_t(size) >> (i * 8)) & 0xff));
+            }
+        }
+    }
+    frame += payload;
+
+    int flags = 0;
+#ifdef MSG_NOSIGNAL
+    flags = MSG_NOSIGNAL;
+#endif
+    size_t sent = 0;
+    while (sent < frame.size()) {
+        ssize_t size = send(m_client_fd, frame.data() + sent, frame.size() - sent, flags);
+        if (size < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // The connection is gone, and will be closed when it's next read from.
+            return;
+        }
+        sent += size_t(size);
+    }
+}
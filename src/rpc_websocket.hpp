@@ -0,0 +1,82 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2020 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include "rpc.hpp"
+
+namespace realm {
+namespace rpc {
+
+// Serves the RPC protocol over a persistent WebSocket connection next to the
+// HTTP server, for the iOS and Android debug servers alike. Requests are
+// matched with their responses by id, and callbacks invoked from the event
+// loop are pushed to the client as they happen instead of waiting for it to
+// poll for them.
+//
+// Messages are text frames holding JSON, or binary frames holding
+// MessagePack if the session negotiated it:
+//
+//     {"id": 1, "request": "/get_property", "body": {...}}
+//     {"id": 1, "response": {...}}
+//     {"push": {"callback": ..., "arguments": ...}}
+//
+// Only one client is served at a time, as only one debugger is connected.
+class RPCWebSocketServer {
+  public:
+    // Throws std::runtime_error if the port can't be listened on.
+    RPCWebSocketServer(RPCServer& server, uint16_t port);
+    ~RPCWebSocketServer();
+
+    RPCWebSocketServer(const RPCWebSocketServer&) = delete;
+    RPCWebSocketServer& operator=(const RPCWebSocketServer&) = delete;
+
+  private:
+    RPCServer& m_server;
+    int m_listen_fd = -1;
+    int m_client_fd = -1;
+    // Written to by the worker thread when callbacks are queued, and on stop.
+    int m_wakeup_fds[2] = {-1, -1};
+    std::atomic<bool> m_stop{false};
+    std::thread m_thread;
+
+    // Whether the handshake with the current client is done.
+    bool m_open = false;
+    std::string m_input;
+    // The fragments of a message which hasn't been fully received.
+    std::string m_message;
+    bool m_message_binary = false;
+
+    void run();
+    void accept_client();
+    void close_client();
+    bool read_client();
+    bool handshake(std::string const& request);
+    bool read_frames();
+    bool handle_message(std::string const& payload, bool binary);
+    void push_callbacks();
+    void send_message(json const& message, RPCEncoding encoding);
+    void send_frame(uint8_t opcode, std::string const& payload);
+};
+
+} // rpc
+} // realm
@@ -0,0 +1,112 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2020 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+namespace realm {
+namespace js {
+
+// Remembers the answers of SSL verification callbacks, so that a certificate
+// which has been verified recently is answered on the sync client's thread
+// rather than by calling into JS again. The certificate itself is part of the
+// key, rather than a hash of it, so that a different certificate can never be
+// taken for one which was accepted.
+class SSLVerificationCache {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Key {
+        // Tells apart the callbacks the answers were given by.
+        uint64_t callback_id;
+        std::string server_address;
+        uint16_t server_port;
+        std::string pem_certificate;
+        bool preverify_ok;
+        int depth;
+
+        bool operator<(Key const& other) const {
+            return std::tie(callback_id, server_address, server_port, depth, preverify_ok, pem_certificate) <
+                   std::tie(other.callback_id, other.server_address, other.server_port, other.depth, other.preverify_ok, other.pem_certificate);
+        }
+    };
+
+    static SSLVerificationCache& shared() {
+        static SSLVerificationCache cache;
+        return cache;
+    }
+
+    uint64_t next_callback_id() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return ++m_last_callback_id;
+    }
+
+    // Returns true and sets `accepted` if there is an answer which hasn't
+    // expired.
+    bool find(Key const& key, bool& accepted) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_entries.find(key);
+        if (it == m_entries.end()) {
+            return false;
+        }
+        if (Clock::now() >= it->second.expires) {
+            m_entries.erase(it);
+            return false;
+        }
+        accepted = it->second.accepted;
+        return true;
+    }
+
+    void insert(Key key, bool accepted, Clock::duration ttl) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto now = Clock::now();
+        // Expired answers are only looked for once the cache has doubled in
+        // size, so that inserting stays cheap.
+        if (m_entries.size() >= m_prune_at) {
+            for (auto it = m_entries.begin(); it != m_entries.end();) {
+                it = now >= it->second.expires ? m_entries.erase(it) : std::next(it);
+            }
+            m_prune_at = std::max(m_entries.size() * 2, size_t(minimum_prune_size));
+        }
+        m_entries[std::move(key)] = {accepted, now + ttl};
+    }
+
+  private:
+    struct Entry {
+        bool accepted;
+        Clock::time_point expires;
+    };
+
+    static const size_t minimum_prune_size = 64;
+
+    std::mutex m_mutex;
+    std::map<Key, Entry> m_entries;
+    size_t m_prune_at = minimum_prune_size;
+    uint64_t m_last_callback_id = 0;
+};
+
+} // js
+} // realm
@@ -0,0 +1,147 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2020 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "sync/sync_session.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace realm {
+namespace js {
+
+// Counters for the sync sessions of the process. They are kept up to date by
+// notifiers registered on each session the first time its counters are read,
+// so that reading them only copies a few numbers per session. The byte counts
+// are the sync client's own totals, while connections are only counted from
+// when a session is first tracked.
+class SyncStats {
+  public:
+    struct Counters {
+        std::atomic<uint64_t> uploaded{0};
+        std::atomic<uint64_t> uploadable{0};
+        std::atomic<uint64_t> downloaded{0};
+        std::atomic<uint64_t> downloadable{0};
+        std::atomic<uint64_t> connects{0};
+    };
+
+    struct SessionStats {
+        std::shared_ptr<SyncSession> session;
+        std::shared_ptr<const Counters> counters;
+        std::string multiplex_identifier;
+    };
+
+    static SyncStats& shared() {
+        static SyncStats stats;
+        return stats;
+    }
+
+    void set_multiplexing_enabled() {
+        m_multiplexing_enabled = true;
+    }
+
+    bool multiplexing_enabled() const {
+        return m_multiplexing_enabled;
+    }
+
+    // The sync client only shares a connection between sessions with the
+    // same multiplex identifier, which it doesn't report back.
+    void set_multiplex_identifier(SyncSession const& session, std::string identifier) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_multiplex_identifiers[&session] = std::move(identifier);
+    }
+
+    // Returns the counters of the given sessions, starting to track those
+    // which aren't yet, and forgetting those which have been closed.
+    std::vector<SessionStats> read(std::vector<std::shared_ptr<SyncSession>> const& sessions) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto it = m_tracked.begin(); it != m_tracked.end();) {
+            if (it->second.session.expired()) {
+                m_multiplex_identifiers.erase(it->first);
+                it = m_tracked.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+
+        std::vector<SessionStats> stats;
+        stats.reserve(sessions.size());
+        for (auto const& session : sessions) {
+            auto& tracked = m_tracked[session.get()];
+            if (tracked.session.lock() != session) {
+                tracked = track(session);
+            }
+            auto identifier = m_multiplex_identifiers.find(session.get());
+            stats.push_back({session, tracked.counters,
+                             identifier == m_multiplex_identifiers.end() ? std::string() : identifier->second});
+        }
+        return stats;
+    }
+
+  private:
+    struct Tracked {
+        std::weak_ptr<SyncSession> session;
+        std::shared_ptr<Counters> counters;
+    };
+
+    std::mutex m_mutex;
+    std::atomic<bool> m_multiplexing_enabled{false};
+    std::unordered_map<SyncSession const*, Tracked> m_tracked;
+    std::unordered_map<SyncSession const*, std::string> m_multiplex_identifiers;
+
+    // The notifiers only hold on to the counters, and are dropped along
+    // with the session.
+    static Tracked track(std::shared_ptr<SyncSession> const& session) {
+        auto counters = std::make_shared<Counters>();
+        std::weak_ptr<Counters> weak_counters = counters;
+        if (session->connection_state() == SyncSession::ConnectionState::Connected) {
+            counters->connects = 1;
+        }
+        session->register_progress_notifier([weak_counters](uint64_t transferred, uint64_t transferrable) {
+            if (auto counters = weak_counters.lock()) {
+                counters->uploaded = transferred;
+                counters->uploadable = transferrable;
+            }
+        }, SyncSession::NotifierType::upload, true);
+        session->register_progress_notifier([weak_counters](uint64_t transferred, uint64_t transferrable) {
+            if (auto counters = weak_counters.lock()) {
+                counters->downloaded = transferred;
+                counters->downloadable = transferrable;
+            }
+        }, SyncSession::NotifierType::download, true);
+        session->register_connection_change_callback([weak_counters](SyncSession::ConnectionState, SyncSession::ConnectionState new_state) {
+            if (new_state != SyncSession::ConnectionState::Connected) {
+                return;
+            }
+            if (auto counters = weak_counters.lock()) {
+                ++counters->connects;
+            }
+        });
+        return {session, std::move(counters)};
+    }
+};
+
+} // js
+} // realm
@@ -0,0 +1,332 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2020 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace realm {
+namespace js {
+
+struct TraceEvent {
+    // Both point to strings which outlive the trace, either literals or
+    // strings interned with TraceEvents::intern().
+    const char* name;
+    const char* category;
+    // 'X' for a complete event, 'i' for an instant one and 'C' for a counter.
+    char phase;
+    uint64_t start_ns;
+    uint64_t duration_ns;
+    int64_t value;
+};
+
+// The events recorded by one thread, of which only the most recent are kept.
+// Only the thread itself writes to it, so its lock is only contended while
+// the trace is being stopped.
+struct TraceBuffer {
+    TraceBuffer(size_t capacity, uint64_t thread_id) : events(capacity), thread_id(thread_id) {}
+
+    std::vector<TraceEvent> events;
+    std::atomic<uint64_t> head{0};
+    std::mutex mutex;
+    uint64_t thread_id;
+    std::atomic<bool> named{false};
+    std::string thread_name;
+
+    void push(TraceEvent const& event) {
+        uint64_t index = head.load(std::memory_order_relaxed);
+        events[index % events.size()] = event;
+        head.store(index + 1, std::memory_order_release);
+    }
+};
+
+// Records begin/end events of the work done by the binding, on whichever
+// thread does it, and exports them in Chrome's trace-event format, which
+// chrome://tracing and Perfetto can open. Recording is off until started,
+// which leaves a single branch in each traced operation.
+class TraceEvents {
+  public:
+    static constexpr size_t default_buffer_size = 65536;
+
+    static TraceEvents& shared() {
+        static TraceEvents events;
+        return events;
+    }
+
+    static bool is_enabled() {
+        return enabled_flag().load(std::memory_order_relaxed);
+    }
+
+    static uint64_t now_ns() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Starts recording, keeping up to `buffer_size` events per thread.
+    void start(size_t buffer_size) {
+        if (buffer_size == 0) {
+            throw std::invalid_argument("The trace buffer size must be greater than 0.");
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (is_enabled()) {
+            throw std::logic_error("Tracing has already been started.");
+        }
+        m_buffers.clear();
+        m_buffer_size = buffer_size;
+        m_next_thread_id = 1;
+        m_start_ns = now_ns();
+        m_generation.fetch_add(1, std::memory_order_acq_rel);
+        enabled_flag().store(true, std::memory_order_release);
+    }
+
+    // Called when tracing stops, to undo what was set up for it.
+    void on_stop(std::function<void()> callback) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop_callbacks.push_back(std::move(callback));
+    }
+
+    // Stops recording, and returns the events as a JSON trace.
+    std::string stop() {
+        std::vector<std::function<void()>> callbacks;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!is_enabled()) {
+                throw std::logic_error("Tracing hasn't been started.");
+            }
+            enabled_flag().store(false, std::memory_order_release);
+            callbacks.swap(m_stop_callbacks);
+        }
+        for (auto& callback : callbacks) {
+            callback();
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::string json = "{\"traceEvents\":[";
+        uint64_t dropped = 0;
+        bool first = true;
+        for (auto const& buffer : m_buffers) {
+            // Waits for an event which was being recorded when tracing was
+            // disabled. Any later one sees that it was.
+            std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+            uint64_t head = buffer->head.load(std::memory_order_acquire);
+            uint64_t capacity = buffer->events.size();
+            uint64_t begin = head > capacity ? head - capacity : 0;
+            dropped += begin;
+            for (uint64_t i = begin; i < head; ++i) {
+                append_event(json, first, buffer->events[i % capacity], buffer->thread_id);
+            }
+            std::string name = buffer->thread_name.empty() ? "Thread " + std::to_string(buffer->thread_id) : buffer->thread_name;
+            append_separator(json, first);
+            json += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + std::to_string(buffer->thread_id);
+            json += ",\"args\":{\"name\":";
+            append_string(json, name.c_str());
+            json += "}}";
+        }
+        json += "],\"displayTimeUnit\":\"ms\",\"otherData\":{\"droppedEvents\":" + std::to_string(dropped) + "}}";
+        m_buffers.clear();
+        return json;
+    }
+
+    // Events which end after tracing was stopped, such as those of a
+    // TraceScope which was entered before, are dropped.
+    void record(TraceEvent const& event) {
+        if (auto buffer = current_buffer()) {
+            std::lock_guard<std::mutex> lock(buffer->mutex);
+            if (is_enabled()) {
+                buffer->push(event);
+            }
+        }
+    }
+
+    void instant(const char* category, const char* name) {
+        if (!is_enabled()) {
+            return;
+        }
+        record({name, category, 'i', now_ns(), 0, 0});
+    }
+
+    void counter(const char* category, const char* name, int64_t value) {
+        if (!is_enabled()) {
+            return;
+        }
+        record({name, category, 'C', now_ns(), 0, value});
+    }
+
+    // Names the calling thread in the trace. Only the first name is kept.
+    // Like recording, this does nothing unless tracing.
+    void name_current_thread(const char* name) {
+        if (!is_enabled()) {
+            return;
+        }
+        auto buffer = current_buffer();
+        if (buffer && !buffer->named.exchange(true)) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            buffer->thread_name = name;
+        }
+    }
+
+    // Returns a copy of the name which lives as long as the process, for the
+    // names which aren't literals.
+    const char* intern(std::string const& name) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_names.insert(name).first->c_str();
+    }
+
+  private:
+    struct ThreadState {
+        uint64_t generation = 0;
+        std::shared_ptr<TraceBuffer> buffer;
+    };
+
+    std::mutex m_mutex;
+    std::atomic<uint64_t> m_generation{0};
+    size_t m_buffer_size = default_buffer_size;
+    uint64_t m_start_ns = 0;
+    uint64_t m_next_thread_id = 1;
+    std::vector<std::shared_ptr<TraceBuffer>> m_buffers;
+    std::vector<std::function<void()>> m_stop_callbacks;
+    std::unordered_set<std::string> m_names;
+
+    static std::atomic<bool>& enabled_flag() {
+        static std::atomic<bool> enabled{false};
+        return enabled;
+    }
+
+    // Each thread gets a buffer the first time it records something after
+    // tracing has been started.
+    TraceBuffer* current_buffer() {
+        static thread_local ThreadState state;
+        uint64_t generation = m_generation.load(std::memory_order_acquire);
+        if (state.generation != generation) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!is_enabled()) {
+                return nullptr;
+            }
+            state.buffer = std::make_shared<TraceBuffer>(m_buffer_size, m_next_thread_id++);
+            state.generation = m_generation.load(std::memory_order_relaxed);
+            m_buffers.push_back(state.buffer);
+        }
+        return state.buffer.get();
+    }
+
+    static void append_separator(std::string& json, bool& first) {
+        if (!first) {
+            json += ',';
+        }
+        first = false;
+    }
+
+    static void append_string(std::string& json, const char* string) {
+        json += '"';
+        for (const char* c = string; *c; ++c) {
+            if (*c == '"' || *c == '\\') {
+                json += '\\';
+                json += *c;
+            }
+            else if (static_cast<unsigned char>(*c) < 0x20) {
+                char escaped[8];
+                snprintf(escaped, sizeof(escaped), "\\u%04x", *c);
+                json += escaped;
+            }
+            else {
+                json += *c;
+            }
+        }
+        json += '"';
+    }
+
+    static void append_microseconds(std::string& json, uint64_t ns) {
+        char number[32];
+        snprintf(number, sizeof(number), "%llu.%03u", (unsigned long long)(ns / 1000), unsigned(ns % 1000));
+        json += number;
+    }
+
+    void append_event(std::string& json, bool& first, TraceEvent const& event, uint64_t thread_id) const {
+        append_separator(json, first);
+        json += "{\"name\":";
+        append_string(json, event.name);
+        json += ",\"cat\":";
+        append_string(json, event.category);
+        json += ",\"ph\":\"";
+        json += event.phase;
+        json += "\",\"ts\":";
+        // Events which started before tracing are clamped to its start.
+        append_microseconds(json, event.start_ns > m_start_ns ? event.start_ns - m_start_ns : 0);
+        json += ",\"pid\":1,\"tid\":" + std::to_string(thread_id);
+        if (event.phase == 'X') {
+            json += ",\"dur\":";
+            append_microseconds(json, event.duration_ns);
+        }
+        else if (event.phase == 'i') {
+            json += ",\"s\":\"t\"";
+        }
+        else if (event.phase == 'C') {
+            json += ",\"args\":{\"value\":" + std::to_string(event.value) + "}";
+        }
+        json += '}';
+    }
+};
+
+// Records a complete event for the scope it's declared in, if tracing was
+// enabled when the scope was entered.
+class TraceScope {
+  public:
+    TraceScope(const char* category, const char* name)
+    : m_name(TraceEvents::is_enabled() ? name : nullptr) {
+        if (m_name) {
+            m_category = category;
+            m_start_ns = TraceEvents::now_ns();
+        }
+    }
+
+    // The name is only interned while tracing.
+    TraceScope(const char* category, std::string const& name)
+    : m_name(TraceEvents::is_enabled() ? TraceEvents::shared().intern(name) : nullptr) {
+        if (m_name) {
+            m_category = category;
+            m_start_ns = TraceEvents::now_ns();
+        }
+    }
+
+    ~TraceScope() {
+        if (m_name) {
+            TraceEvents::shared().record({m_name, m_category, 'X', m_start_ns, TraceEvents::now_ns() - m_start_ns, 0});
+        }
+    }
+
+    TraceScope(TraceScope const&) = delete;
+    TraceScope& operator=(TraceScope const&) = delete;
+
+  private:
+    const char* m_name;
+    const char* m_category = nullptr;
+    uint64_t m_start_ns = 0;
+};
+
+} // js
+} // realm
@@ -0,0 +1,145 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2020 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <realm/binary_data.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace realm {
+namespace js {
+
+// The element types of the typed arrays which numbers are copied in and out of.
+enum class TypedArrayType {
+    Int8,
+    Uint8,
+    Int16,
+    Uint16,
+    Int32,
+    Uint32,
+    Float32,
+    Float64,
+};
+
+inline const char* typed_array_name(TypedArrayType type) {
+    switch (type) {
+        case TypedArrayType::Int8: return "Int8Array";
+        case TypedArrayType::Uint8: return "Uint8Array";
+        case TypedArrayType::Int16: return "Int16Array";
+        case TypedArrayType::Uint16: return "Uint16Array";
+        case TypedArrayType::Int32: return "Int32Array";
+        case TypedArrayType::Uint32: return "Uint32Array";
+        case TypedArrayType::Float32: return "Float32Array";
+        case TypedArrayType::Float64: return "Float64Array";
+    }
+    return "";
+}
+
+inline TypedArrayType typed_array_type_for_name(const std::string& name) {
+    for (auto type : {TypedArrayType::Int8, TypedArrayType::Uint8, TypedArrayType::Int16, TypedArrayType::Uint16,
+                      TypedArrayType::Int32, TypedArrayType::Uint32, TypedArrayType::Float32, TypedArrayType::Float64}) {
+        if (name == typed_array_name(type)) {
+            return type;
+        }
+    }
+    throw std::invalid_argument("Unsupported typed array type '" + name + "'.");
+}
+
+inline bool is_integer_typed_array(TypedArrayType type) {
+    return type != TypedArrayType::Float32 && type != TypedArrayType::Float64;
+}
+
+namespace typed_array {
+
+template<typename Element>
+void encode(std::vector<double> const& values, char* out, const char* name) {
+    for (size_t i = 0; i < values.size(); ++i) {
+        double value = values[i];
+        // NaN, which nulls are read as, fails the comparisons too.
+        if (std::numeric_limits<Element>::is_integer &&
+            !(value >= double(std::numeric_limits<Element>::min()) && value <= double(std::numeric_limits<Element>::max()))) {
+            throw std::out_of_range("The value at index " + std::to_string(i) + " doesn't fit in " + name + ".");
+        }
+        Element element = Element(value);
+        memcpy(out + i * sizeof(Element), &element, sizeof(Element));
+    }
+}
+
+template<typename Element>
+void decode(BinaryData bytes, std::vector<double>& values) {
+    size_t count = bytes.size() / sizeof(Element);
+    values.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        Element element;
+        memcpy(&element, bytes.data() + i * sizeof(Element), sizeof(Element));
+        values[i] = double(element);
+    }
+}
+
+} // namespace typed_array
+
+inline size_t typed_array_element_size(TypedArrayType type) {
+    switch (type) {
+        case TypedArrayType::Int8: case TypedArrayType::Uint8: return 1;
+        case TypedArrayType::Int16: case TypedArrayType::Uint16: return 2;
+        case TypedArrayType::Int32: case TypedArrayType::Uint32: case TypedArrayType::Float32: return 4;
+        case TypedArrayType::Float64: return 8;
+    }
+    return 1;
+}
+
+// Lays out numbers as the elements of a typed array. Throws if a number is
+// out of the range of an integer type.
+inline std::vector<char> encode_typed_array(TypedArrayType type, std::vector<double> const& values) {
+    std::vector<char> bytes(values.size() * typed_array_element_size(type));
+    switch (type) {
+        case TypedArrayType::Int8: typed_array::encode<int8_t>(values, bytes.data(), typed_array_name(type)); break;
+        case TypedArrayType::Uint8: typed_array::encode<uint8_t>(values, bytes.data(), typed_array_name(type)); break;
+        case TypedArrayType::Int16: typed_array::encode<int16_t>(values, bytes.data(), typed_array_name(type)); break;
+        case TypedArrayType::Uint16: typed_array::encode<uint16_t>(values, bytes.data(), typed_array_name(type)); break;
+        case TypedArrayType::Int32: typed_array::encode<int32_t>(values, bytes.data(), typed_array_name(type)); break;
+        case TypedArrayType::Uint32: typed_array::encode<uint32_t>(values, bytes.data(), typed_array_name(type)); break;
+        case TypedArrayType::Float32: typed_array::encode<float>(values, bytes.data(), typed_array_name(type)); break;
+        case TypedArrayType::Float64: memcpy(bytes.data(), values.data(), bytes.size()); break;
+    }
+    return bytes;
+}
+
+inline std::vector<double> decode_typed_array(TypedArrayType type, BinaryData bytes) {
+    std::vector<double> values;
+    switch (type) {
+        case TypedArrayType::Int8: typed_array::decode<int8_t>(bytes, values); break;
+        case TypedArrayType::Uint8: typed_array::decode<uint8_t>(bytes, values); break;
+        case TypedArrayType::Int16: typed_array::decode<int16_t>(bytes, values); break;
+        case TypedArrayType::Uint16: typed_array::decode<uint16_t>(bytes, values); break;
+        case TypedArrayType::Int32: typed_array::decode<int32_t>(bytes, values); break;
+        case TypedArrayType::Uint32: typed_array::decode<uint32_t>(bytes, values); break;
+        case TypedArrayType::Float32: typed_array::decode<float>(bytes, values); break;
+        case TypedArrayType::Float64: typed_array::decode<double>(bytes, values); break;
+    }
+    return values;
+}
+
+} // js
+} // realm
@@ -0,0 +1,150 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2020 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace realm {
+namespace js {
+
+// State shared between the JS thread and a worker writing a copy of a Realm.
+class WriteCopyTask {
+  public:
+    struct Cancelled : std::runtime_error {
+        Cancelled() : std::runtime_error("The copy was cancelled.") {}
+    };
+
+    // A budget of zero doesn't limit the rate at which the copy is written,
+    // while a fraction of a byte per second still does.
+    explicit WriteCopyTask(double bytes_per_second = 0)
+    : m_bytes_per_second(bytes_per_second), m_start(Clock::now()) {}
+
+    void cancel() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_cancelled = true;
+        m_condition.notify_all();
+    }
+
+    // Lets the worker carry on after handing a chunk to the JS thread.
+    void resume() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_paused = false;
+        m_condition.notify_all();
+    }
+
+    void pause() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_paused = true;
+    }
+
+    // Blocks the worker until the task is resumed. Throws if it is cancelled.
+    void wait_until_resumed() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_condition.wait(lock, [&] { return !m_paused || m_cancelled; });
+        if (m_cancelled) {
+            throw Cancelled();
+        }
+    }
+
+    // Counts bytes written by the worker, and sleeps for as long as it's
+    // ahead of the budget. Throws if the task is cancelled.
+    void did_write(size_t bytes) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_written += bytes;
+        if (m_bytes_per_second > 0) {
+            auto due = m_start + std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<double>(double(m_written) / m_bytes_per_second));
+            m_condition.wait_until(lock, due, [&] { return m_cancelled; });
+        }
+        if (m_cancelled) {
+            throw Cancelled();
+        }
+    }
+
+    uint64_t written() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_written;
+    }
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition;
+    const double m_bytes_per_second;
+    const Clock::time_point m_start;
+    uint64_t m_written = 0;
+    bool m_paused = false;
+    bool m_cancelled = false;
+};
+
+// A stream buffer which hands what is written to it to a sink in chunks, so
+// that the core can write a copy of a Realm anywhere a chunk can be sent.
+class WriteCopyStreamBuffer : public std::streambuf {
+  public:
+    static constexpr size_t chunk_size = 1024 * 1024;
+
+    using Sink = std::function<void(const char* data, size_t size)>;
+
+    WriteCopyStreamBuffer(WriteCopyTask& task, Sink sink)
+    : m_task(task), m_sink(std::move(sink)), m_buffer(chunk_size) {
+        setp(m_buffer.data(), m_buffer.data() + m_buffer.size());
+    }
+
+  protected:
+    int_type overflow(int_type ch) override {
+        flush();
+        if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+            *pptr() = traits_type::to_char_type(ch);
+            pbump(1);
+        }
+        return traits_type::not_eof(ch);
+    }
+
+    int sync() override {
+        flush();
+        return 0;
+    }
+
+  private:
+    WriteCopyTask& m_task;
+    Sink m_sink;
+    std::vector<char> m_buffer;
+
+    void flush() {
+        size_t size = pptr() - pbase();
+        if (size) {
+            m_sink(pbase(), size);
+            m_task.did_write(size);
+            setp(m_buffer.data(), m_buffer.data() + m_buffer.size());
+        }
+    }
+};
+
+} // js
+} // realm
@@ -0,0 +1,230 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2020 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+'use strict';
+
+// Runs the end-to-end benchmarks of scenarios.js against the Realm built from
+// binding.gyp, and writes their ops/sec as JSON.
+//
+// Usage: node index.js [options] [scenario...]
+//
+//   --count <n>              Number of objects of each scenario (100000).
+//   --repeats <n>            Runs of each scenario, of which the fastest is
+//                            kept (3).
+//   --output <file>          Writes the results to the file rather than to
+//                            stdout.
+//   --baseline <file>        Fails if a scenario is slower than in the results
+//                            stored in the file.
+//   --threshold <fraction>   How much slower than the baseline a scenario may
+//                            be (0.1).
+//   --save-baseline <file>   Stores the results as a baseline.
+//   --sync-url <url>         Also runs the sync scenarios, against the object
+//                            server at the url (e.g. http://127.0.0.1:9080).
+
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+
+const Realm = require('../..');
+const scenarios = require('./scenarios');
+
+function parseArguments(argv) {
+    const options = {
+        count: 100000,
+        repeats: 3,
+        threshold: 0.1,
+        scenarios: [],
+    };
+    const numbers = ['count', 'repeats', 'threshold'];
+    const strings = ['output', 'baseline', 'save-baseline', 'sync-url'];
+    for (let i = 0; i < argv.length; i++) {
+        const arg = argv[i];
+        if (!arg.startsWith('--')) {
+            if (!scenarios[arg]) {
+                throw new Error(`Unknown scenario '${arg}', expected one of: ${Object.keys(scenarios).join(', ')}`);
+            }
+            options.scenarios.push(arg);
+            continue;
+        }
+        const name = arg.slice(2);
+        const value = argv[++i];
+        if (value === undefined) {
+            throw new Error(`Missing value for ${arg}`);
+        }
+        const key = name.replace(/-([a-z])/g, (match, letter) => letter.toUpperCase());
+        if (numbers.includes(name)) {
+            options[key] = Number(value);
+            if (!(options[key] > 0)) {
+                throw new Error(`${arg} must be a positive number`);
+            }
+        }
+        else if (strings.includes(name)) {
+            options[key] = value;
+        }
+        else {
+            throw new Error(`Unknown option ${arg}`);
+        }
+    }
+    if (options.scenarios.length === 0) {
+        options.scenarios = Object.keys(scenarios).filter((name) => !scenarios[name].sync || options.syncUrl);
+    }
+    return options;
+}
+
+function runOnce(scenario, options) {
+    let state;
+    return Promise.resolve()
+        .then(() => scenario.setup(Realm, options))
+        .then((result) => {
+            state = result;
+            const start = process.hrtime();
+            return Promise.resolve(scenario.run(state, options)).then((ops) => {
+                const [seconds, nanoseconds] = process.hrtime(start);
+                const run = {ops, ms: seconds * 1e3 + nanoseconds / 1e6};
+                if (scenario.stats) {
+                    run.stats = scenario.stats(state);
+                }
+                return run;
+            });
+        })
+        .then((result) => {
+            if (scenario.teardown) {
+                scenario.teardown(state);
+            }
+            else {
+                state.close();
+            }
+            return result;
+        });
+}
+
+function runScenario(name, options) {
+    const scenario = scenarios[name];
+    if (scenario.sync && !options.syncUrl) {
+        return Promise.reject(new Error(`The ${name} scenario needs --sync-url`));
+    }
+
+    const runs = [];
+    let chain = Promise.resolve();
+    for (let i = 0; i < options.repeats; i++) {
+        chain = chain.then(() => runOnce(scenario, options)).then((run) => runs.push(run));
+    }
+    return chain.then(() => {
+        const fastest = runs.reduce((a, b) => (b.ops / b.ms > a.ops / a.ms ? b : a));
+        const result = {
+            ops: fastest.ops,
+            ms: fastest.ms,
+            opsPerSec: fastest.ops / (fastest.ms / 1000),
+        };
+        if (fastest.stats) {
+            result.stats = fastest.stats;
+        }
+        return result;
+    });
+}
+
+// Returns the scenarios which are slower than the baseline by more than the
+// threshold. Scenarios which aren't in the baseline aren't compared.
+function regressions(results, baseline, threshold) {
+    const slower = [];
+    for (const name of Object.keys(results)) {
+        const expected = baseline.results[name];
+        if (!expected) {
+            continue;
+        }
+        const ratio = results[name].opsPerSec / expected.opsPerSec;
+        if (ratio < 1 - threshold) {
+            slower.push({name, opsPerSec: results[name].opsPerSec, baseline: expected.opsPerSec, ratio});
+        }
+    }
+    return slower;
+}
+
+function main() {
+    const options = parseArguments(process.argv.slice(2));
+    const directory = fs.mkdtempSync(path.join(os.tmpdir(), 'realm-benchmarks-'));
+    options.path = path.join(directory, 'benchmark.realm');
+    if (Realm.Sync) {
+        Realm.Sync.setLogLevel('error');
+    }
+
+    const results = {};
+    let chain = Promise.resolve();
+    for (const name of options.scenarios) {
+        chain = chain.then(() => runScenario(name, options)).then((result) => {
+            results[name] = result;
+            console.error(`${name}: ${Math.round(result.opsPerSec)} ops/sec`);
+        });
+    }
+
+    return chain.then(() => {
+        // How much slower each encrypted variant of a scenario was than the
+        // scenario on a plain Realm.
+        for (const name of Object.keys(results)) {
+            const plain = results[name.replace(/Encrypted$/, '')];
+            if (name.endsWith('Encrypted') && plain) {
+                results[name].encryptionOverhead = plain.opsPerSec / results[name].opsPerSec;
+                console.error(`${name}: ${results[name].encryptionOverhead.toFixed(2)}x the time of ${name.replace(/Encrypted$/, '')}`);
+            }
+        }
+
+        const report = {
+            date: new Date().toISOString(),
+            node: process.version,
+            platform: `${process.platform}-${process.arch}`,
+            count: options.count,
+            results,
+        };
+        const json = JSON.stringify(report, null, 2) + '\n';
+        if (options.output) {
+            fs.writeFileSync(options.output, json);
+        }
+        else {
+            process.stdout.write(json);
+        }
+        if (options.saveBaseline) {
+            fs.writeFileSync(options.saveBaseline, json);
+        }
+
+        if (options.baseline) {
+            const baseline = JSON.parse(fs.readFileSync(options.baseline, 'utf8'));
+            if (baseline.count !== options.count) {
+                console.error(`The baseline was recorded with --count ${baseline.count} rather than ${options.count}`);
+            }
+            const slower = regressions(results, baseline, options.threshold);
+            for (const regression of slower) {
+                console.error(`${regression.name} regressed: ${Math.round(regression.opsPerSec)} ops/sec, ` +
+                              `${Math.round(regression.baseline)} in the baseline (${(regression.ratio * 100).toFixed(1)}%)`);
+            }
+            if (slower.length > 0) {
+                process.exitCode = 1;
+            }
+        }
+    }).then(() => {
+        Realm.deleteFile({path: options.path});
+        fs.rmdirSync(directory);
+    }).catch((error) => {
+        console.error(error);
+        process.exitCode = 1;
+    }).then(() => {
+        // Sync sessions keep the event loop alive.
+        process.exit();
+    });
+}
+
+main();
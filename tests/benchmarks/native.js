@@ -0,0 +1,52 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2020 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+'use strict';
+
+// Runs the micro-benchmarks of the binding's hot paths (src/js_benchmarks.hpp)
+// on V8. The module is only built when REALMJS_BUILD_BENCHMARKS is set:
+//
+//   REALMJS_BUILD_BENCHMARKS=1 npx node-pre-gyp rebuild
+//
+// Usage: node native.js [filter] [iterations]
+
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+
+const candidates = ['Release', 'Debug'].map((configuration) => {
+    return path.resolve(__dirname, '..', '..', 'build', configuration, 'realm-benchmarks.node');
+});
+const modulePath = candidates.find((candidate) => fs.existsSync(candidate));
+if (!modulePath) {
+    console.error('The benchmarks module was not found, build it with REALMJS_BUILD_BENCHMARKS=1 set.');
+    process.exit(1);
+}
+const benchmarks = require(modulePath);
+
+const filter = process.argv[2] || '';
+const iterations = parseInt(process.argv[3] || '100000', 10);
+const realmPath = path.join(os.tmpdir(), `realm-benchmarks-${process.pid}.realm`);
+
+const results = benchmarks.run(realmPath, filter, iterations);
+const width = Math.max(...results.map((result) => result.name.length));
+
+console.log(`${'benchmark'.padEnd(width)}  ${'ns/op'.padStart(10)}  ${'allocs/op'.padStart(10)}`);
+for (const result of results) {
+    console.log(`${result.name.padEnd(width)}  ${result.nsPerOp.toFixed(1).padStart(10)}  ${result.allocationsPerOp.toFixed(2).padStart(10)}`);
+}
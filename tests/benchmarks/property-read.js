@@ -0,0 +1,79 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2020 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+'use strict';
+
+// Compares property reads through the named property interceptor with reads
+// through the per-schema accessor templates (the `_accessorTemplates` option).
+//
+// Usage: node property-read.js [number of objects]
+
+const Realm = require('realm');
+
+const TestObjectSchema = {
+    name: 'TestObject',
+    properties: {
+        int: 'int',
+        double: 'double',
+        string: 'string',
+    }
+};
+
+const count = parseInt(process.argv[2] || '1000000', 10);
+const path = 'property-read-benchmark.realm';
+
+function populate() {
+    Realm.deleteFile({path: path});
+    const realm = new Realm({path: path, schema: [TestObjectSchema]});
+    realm.write(() => {
+        for (let i = 0; i < count; i++) {
+            realm.create('TestObject', {int: i, double: i / 2, string: `string ${i % 100}`});
+        }
+    });
+    realm.close();
+}
+
+function run(accessorTemplates) {
+    const realm = new Realm({path: path, schema: [TestObjectSchema], _accessorTemplates: accessorTemplates});
+    const objects = realm.objects('TestObject');
+
+    const start = process.hrtime();
+    let sum = 0;
+    for (let i = 0; i < objects.length; i++) {
+        const object = objects[i];
+        sum += object.int + object.double + object.string.length;
+    }
+    const [seconds, nanoseconds] = process.hrtime(start);
+
+    realm.close();
+    return {sum: sum, ms: seconds * 1e3 + nanoseconds / 1e6};
+}
+
+populate();
+
+const interceptor = run(false);
+const accessors = run(true);
+if (interceptor.sum !== accessors.sum) {
+    throw new Error('Property reads returned different values');
+}
+
+console.log(`Reading 3 properties of ${count} objects`);
+console.log(`  interceptor:        ${interceptor.ms.toFixed(1)} ms`);
+console.log(`  accessor templates: ${accessors.ms.toFixed(1)} ms (${(interceptor.ms / accessors.ms).toFixed(2)}x)`);
+
+Realm.deleteFile({path: path});
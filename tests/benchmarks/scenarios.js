@@ -0,0 +1,326 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2020 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+'use strict';
+
+// The scenarios of the end-to-end benchmarks. The first five are those of
+// examples/ReactNativeBenchmarks. Each scenario's `run` returns the number of
+// operations it did, which the harness divides by the time it took, and
+// `setup` and `teardown` aren't timed. What a scenario's `stats` returns after
+// the run is reported along with it.
+
+const TestObjectSchema = {
+    name: 'TestObject',
+    properties: {
+        int: 'int',
+        double: 'double',
+        date: 'date',
+        string: 'string',
+    }
+};
+
+const KeyedObjectSchema = {
+    name: 'KeyedObject',
+    primaryKey: 'id',
+    properties: {
+        id: 'int',
+        string: 'string',
+    }
+};
+
+const numQueryBuckets = 100;
+
+// The key of the encrypted variants of the scenarios.
+const encryptionKey = new Int8Array(64).map((value, i) => i + 1);
+
+function testObject(i) {
+    return {int: i % numQueryBuckets, double: i, date: new Date(i), string: '' + i};
+}
+
+function populate(realm, count) {
+    realm.write(() => {
+        for (let i = 0; i < count; i++) {
+            realm.create('TestObject', testObject(i));
+        }
+    });
+}
+
+function readObject(object) {
+    object.int;
+    object.double;
+    object.date;
+    object.string;
+}
+
+function openLocal(Realm, options) {
+    Realm.deleteFile({path: options.path});
+    return new Realm({path: options.path, schema: [TestObjectSchema, KeyedObjectSchema], encryptionKey: options.encryptionKey});
+}
+
+// Expects the objects of the scenarios which only read them to exist.
+function openPopulated(Realm, options) {
+    const realm = openLocal(Realm, options);
+    populate(realm, options.count);
+    return realm;
+}
+
+function queryObjects(realm, options) {
+    return realm.objects('TestObject').filtered('int = 0 and double < $0', options.count / 2);
+}
+
+// Visits the indexes of `length` objects spread over the whole table, rather
+// than in order, so that neither the row accessors nor the pages they read
+// are reused from one to the next.
+function forEachRandomIndex(length, count, callback) {
+    let index = 0;
+    for (let i = 0; i < count; i++) {
+        index = (index * 1103515245 + 12345) % length;
+        callback(index);
+    }
+}
+
+// The scan, point lookup and write workloads, which are run on a plain Realm
+// and as an encrypted variant, so that the cost of decrypting and encrypting
+// the file can be told apart from that of reading and writing it.
+const workloads = {
+    scan: {
+        setup: openPopulated,
+        run(realm) {
+            let length = 0;
+            for (const object of realm.objects('TestObject')) {
+                readObject(object);
+                length++;
+            }
+            return length;
+        },
+    },
+
+    pointLookup: {
+        setup(Realm, options) {
+            const realm = openLocal(Realm, options);
+            realm.write(() => {
+                for (let i = 0; i < options.count; i++) {
+                    realm.create('KeyedObject', {id: i, string: '' + i});
+                }
+            });
+            return realm;
+        },
+        run(realm, options) {
+            forEachRandomIndex(options.count, options.count, (id) => {
+                realm.objectForPrimaryKey('KeyedObject', id).string;
+            });
+            return options.count;
+        },
+    },
+
+    writes: {
+        setup: openPopulated,
+        run(realm, options) {
+            const transactions = 100;
+            const objectsPerTransaction = Math.max(1, Math.floor(options.count / 1000));
+            const objects = realm.objects('TestObject');
+            for (let i = 0; i < transactions; i++) {
+                realm.write(() => {
+                    forEachRandomIndex(objects.length, objectsPerTransaction, (index) => {
+                        objects[(index + i) % objects.length].double += 1;
+                    });
+                });
+            }
+            return transactions * objectsPerTransaction;
+        },
+    },
+};
+
+// Runs a scenario on a Realm encrypted with `encryptionKey`, and reports the
+// pages of the file which are decrypted once it has run.
+function encrypted(scenario) {
+    return Object.assign({}, scenario, {
+        setup(Realm, options) {
+            return scenario.setup(Realm, Object.assign({}, options, {encryptionKey}));
+        },
+        stats(realm) {
+            return realm.fileStats().encryption;
+        },
+    });
+}
+
+const scenarios = {
+    insertions: {
+        setup: openLocal,
+        run(realm, options) {
+            const count = Math.max(1, Math.floor(options.count / 1000));
+            for (let i = 0; i < count; i++) {
+                realm.write(() => {
+                    realm.create('TestObject', testObject(i));
+                });
+            }
+            return count;
+        },
+    },
+
+    batchInsertions: {
+        setup: openLocal,
+        run(realm, options) {
+            populate(realm, options.count);
+            return options.count;
+        },
+    },
+
+    enumeration: {
+        setup: openPopulated,
+        run(realm) {
+            const objects = realm.objects('TestObject');
+            const length = objects.length;
+            for (let i = 0; i < length; i++) {
+                readObject(objects[i]);
+            }
+            return length;
+        },
+    },
+
+    queryCount: {
+        setup: openPopulated,
+        run(realm, options) {
+            const iterations = 100;
+            for (let i = 0; i < iterations; i++) {
+                queryObjects(realm, options).length;
+            }
+            return iterations;
+        },
+    },
+
+    queryEnumeration: {
+        setup: openPopulated,
+        run(realm, options) {
+            const objects = queryObjects(realm, options);
+            const length = objects.length;
+            for (let i = 0; i < length; i++) {
+                readObject(objects[i]);
+            }
+            return length;
+        },
+    },
+
+    // Reads the properties of objects spread over the whole table, rather
+    // than in order, so that the row accessors aren't reused.
+    randomReads: {
+        setup: openPopulated,
+        run(realm, options) {
+            const objects = realm.objects('TestObject');
+            const reads = options.count * 4;
+            forEachRandomIndex(objects.length, reads, (index) => readObject(objects[index]));
+            return reads;
+        },
+    },
+
+    // Writes while there are listeners on several queries, each write being
+    // counted once all of the listeners have been called for it.
+    notifications: {
+        setup(Realm, options) {
+            const realm = openPopulated(Realm, options);
+            const queries = [];
+            for (let i = 0; i < 10; i++) {
+                queries.push(realm.objects('TestObject').filtered('int = $0', i));
+            }
+            return {realm, queries};
+        },
+        run(state) {
+            const writes = 100;
+            const {realm, queries} = state;
+            const objects = realm.objects('TestObject');
+            return new Promise((resolve) => {
+                let written = 0;
+                let pending = 0;
+                const write = () => {
+                    if (written === writes) {
+                        queries.forEach((query) => query.removeAllListeners());
+                        resolve(writes);
+                        return;
+                    }
+                    pending = queries.length;
+                    realm.write(() => {
+                        objects[written % queries.length].double += 1;
+                    });
+                    written++;
+                };
+                // The first call of each listener is for the query's initial
+                // results rather than for a write.
+                let initial = queries.length;
+                const listener = () => {
+                    if (initial > 0) {
+                        if (--initial === 0) {
+                            write();
+                        }
+                        return;
+                    }
+                    if (--pending === 0) {
+                        write();
+                    }
+                };
+                queries.forEach((query) => query.addListener(listener));
+            });
+        },
+        teardown(state) {
+            state.realm.close();
+        },
+    },
+
+    // Uploads the objects as one user, and measures how long it takes
+    // another user which has never opened the Realm to download them.
+    syncDownload: {
+        sync: true,
+        setup(Realm, options) {
+            const realmUrl = `${options.syncUrl.replace(/^http/, 'realm')}/benchmark-${Date.now()}`;
+            const configuration = (user) => ({
+                schema: [TestObjectSchema],
+                sync: {user, url: realmUrl, fullSynchronization: true},
+            });
+            const login = (name) => {
+                return Realm.Sync.User.login(options.syncUrl, Realm.Sync.Credentials.nickname(name, true));
+            };
+            return login(`benchmark-uploader-${Date.now()}`).then((uploader) => {
+                const realm = new Realm(configuration(uploader));
+                populate(realm, options.count);
+                return realm.syncSession.uploadAllLocalChanges().then(() => {
+                    realm.close();
+                    return login(`benchmark-downloader-${Date.now()}`);
+                });
+            }).then((downloader) => ({Realm, config: configuration(downloader)}));
+        },
+        run(state, options) {
+            return state.Realm.open(state.config).then((realm) => {
+                const length = realm.objects('TestObject').length;
+                realm.close();
+                if (length !== options.count) {
+                    throw new Error(`Downloaded ${length} objects rather than ${options.count}`);
+                }
+                return length;
+            });
+        },
+        teardown(state) {
+            state.config.sync.user.logout();
+        },
+    },
+};
+
+for (const name of Object.keys(workloads)) {
+    scenarios[name] = workloads[name];
+    scenarios[`${name}Encrypted`] = encrypted(workloads[name]);
+}
+
+module.exports = scenarios;
@@ -0,0 +1,60 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2020 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#import <XCTest/XCTest.h>
+#import <JavaScriptCore/JavaScriptCore.h>
+
+#include <cstdlib>
+#include <new>
+
+#include "jsc_init.h"
+
+// The test bundle links RealmJS statically, so these are the operators which
+// the binding and core call, while JavaScriptCore keeps its own.
+void* operator new(size_t size) {
+    RJSBenchmarksCountAllocation();
+    if (void* pointer = std::malloc(size ? size : 1)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+@interface RealmJSBenchmarks : XCTestCase
+@end
+
+@implementation RealmJSBenchmarks
+
+- (void)testBindingHotPaths {
+    JSContext *context = [[JSContext alloc] init];
+    RJSInitializeBenchmarksInContext(context.JSGlobalContextRef);
+
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:@"realm-benchmarks.realm"];
+    JSValue *results = [context[@"RealmBenchmarks"] invokeMethod:@"run" withArguments:@[path]];
+    XCTAssertNil(context.exception, @"%@", context.exception);
+
+    for (NSDictionary *result in [results toArray]) {
+        NSLog(@"%-50@ %10.1f ns/op %10.2f allocs/op", result[@"name"],
+              [result[@"nsPerOp"] doubleValue], [result[@"allocationsPerOp"] doubleValue]);
+    }
+}
+
+@end
@@ -481,6 +481,36 @@ describe('Adapter', () => {
         realm.close();
     });
 
+    it("test chunked and raw instructions", async () => {
+        let realm = await rosController.createRealm('test1', allTypesRealmSchema);
+        await notificationPromise(rosController, 'test1', () => {
+            createAdapter(rosController)
+        });
+        var path = await notificationPromise(rosController, 'test1', () => {
+            realm.write(() => {
+                for (let i = 0; i < 5; i++) {
+                    realm.create('TestObject', [i]);
+                }
+            });
+        });
+
+        adapter.advance(path);
+        const instructions = adapter.current(path);
+        const chunks = Array.from(adapter.currentChunks(path, 2));
+        expect(chunks.every(chunk => chunk.length > 0 && chunk.length <= 2)).toBe(true);
+        expect([].concat(...chunks)).toEqual(instructions);
+
+        const raw = adapter.current(path, { raw: true });
+        expect(raw instanceof ArrayBuffer).toBe(true);
+        expect(JSON.parse(Buffer.from(raw).toString('utf8')).length).toBe(instructions.length);
+
+        // Advancing by more transactions than there are stops after the last one.
+        expect(adapter.advance(path, 10)).toBeUndefined();
+        expect(adapter.current(path)).toBeUndefined();
+        expect(Array.from(adapter.currentChunks(path, 2))).toEqual([]);
+        realm.close();
+    });
+
     it("test date type", async () => {
         let testDates = ['1969-07-20 20:18:04+00', '2017-12-12 15:00:37.447+00', '2017-12-07 20:16:03.837+00']
 
@@ -70,6 +70,30 @@ module.exports = {
         });
     },
 
+    testEncryptionFileStats: function() {
+        var realm = new Realm({schema: [Schemas.TestObject], encryptionKey: new Int8Array(64)});
+        realm.write(function() {
+            for (var i = 0; i < 1000; i++) {
+                realm.create('TestObject', {doubleCol: i});
+            }
+        });
+        TestCase.assertEqual(realm.objects('TestObject').sum('doubleCol'), 999 * 500);
+
+        var stats = realm.fileStats();
+        TestCase.assertEqual(stats.encryption.pageSize, 4096);
+        TestCase.assertEqual(stats.encryption.filePages, Math.ceil(stats.fileSize / 4096));
+        TestCase.assertTrue(stats.encryption.usedPages > 0);
+        TestCase.assertTrue(stats.encryption.usedPages <= stats.encryption.filePages);
+        if (stats.encryption.decryptedPages !== null) {
+            TestCase.assertTrue(stats.encryption.decryptedPages > 0);
+        }
+        realm.close();
+
+        var plainRealm = new Realm({schema: [Schemas.TestObject], path: 'plain.realm'});
+        TestCase.assertNull(plainRealm.fileStats().encryption);
+        plainRealm.close();
+    },
+
     testEncryptionWithSync: function() {
         if (!global.enableSyncTests) {
             return Promise.resolve();
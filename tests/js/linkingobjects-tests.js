@@ -219,5 +219,45 @@ module.exports = {
         });
 
         TestCase.assertEqual(olivier.linkingObjectsCount(), 2);
+    },
+
+    testCollectionLinkingObjects: function() {
+        if (typeof navigator !== 'undefined' && /Chrome/.test(navigator.userAgent)) { // eslint-disable-line no-undef
+            // Typed arrays arrive as plain ArrayBuffers through the debugger.
+            return;
+        }
+
+        var realm = new Realm({schema: [schemas.PersonObject]});
+
+        var children;
+        realm.write(function() {
+            var olivier = realm.create('PersonObject', {name: 'Olivier', age: 0});
+            var emma = realm.create('PersonObject', {name: 'Emma', age: 2});
+            realm.create('PersonObject', {name: 'Christine', age: 25, children: [olivier, emma]});
+            realm.create('PersonObject', {name: 'JP', age: 28, children: [olivier]});
+            realm.create('PersonObject', {name: 'John', age: 50});
+        });
+        children = realm.objects('PersonObject').filtered('age < 10').sorted('name');
+
+        var counts = children.linkingObjectsCounts('PersonObject', 'children');
+        TestCase.assertTrue(counts instanceof Int32Array);
+        TestCase.assertArraysEqual(Array.from(counts), [1, 2]);
+
+        var parents = children.linkingObjects('PersonObject', 'children');
+        TestCase.assertArraysEqual(names(parents.sorted('name')), ['Christine', 'JP']);
+
+        var christine = realm.objects('PersonObject').filtered('name = "Christine"')[0];
+        TestCase.assertArraysEqual(Array.from(christine.children.linkingObjectsCounts('PersonObject', 'children')), [2, 1]);
+        TestCase.assertEqual(realm.objects('PersonObject').filtered('age > 100').linkingObjects('PersonObject', 'children').length, 0);
+
+        realm.write(function() {
+            realm.create('PersonObject', {name: 'Anna', age: 30, children: [children[0]]});
+        });
+        TestCase.assertArraysEqual(names(parents.sorted('name')), ['Anna', 'Christine', 'JP']);
+
+        TestCase.assertThrows(() => children.linkingObjects('NoSuchSchema', 'children'),
+            "Could not find schema for type 'NoSuchSchema'");
+        TestCase.assertThrows(() => children.linkingObjectsCounts('PersonObject', 'name'),
+            "'PersonObject.name' is not a relationship to 'PersonObject'");
     }
 };
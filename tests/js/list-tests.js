@@ -597,6 +597,102 @@ module.exports = {
         }, "Cannot modify managed objects outside of a write transaction");
     },
 
+    testListAssign: function() {
+        const realm = new Realm({schema: [schemas.LinkTypes, schemas.TestObject, schemas.PrimitiveArrays]});
+        let array, ints;
+
+        realm.write(() => {
+            let obj = realm.create('LinkTypesObject', {
+                objectCol: {doubleCol: 1},
+                objectCol1: {doubleCol: 2},
+                arrayCol: [{doubleCol: 1}, {doubleCol: 2}, {doubleCol: 3}],
+            });
+            array = obj.arrayCol;
+            const [first, , third] = array;
+
+            let changes = array.assign([third, first, {doubleCol: 4}]);
+            TestCase.assertArraysEqual(array.map(o => o.doubleCol), [3, 1, 4]);
+            TestCase.assertEqual(changes.deletions, 1);
+            TestCase.assertEqual(changes.moves, 1);
+            TestCase.assertEqual(changes.insertions, 1);
+            TestCase.assertTrue(array[0].isSameObject(third));
+            TestCase.assertTrue(array[1].isSameObject(first));
+
+            // Items with the key of an object in the list are written to it.
+            const objectCount = realm.objects('TestObject').length;
+            changes = array.assign([{doubleCol: 3}, {doubleCol: 1}], {key: 'doubleCol'});
+            TestCase.assertArraysEqual(array.map(o => o.doubleCol), [3, 1]);
+            TestCase.assertEqual(changes.deletions, 1);
+            TestCase.assertEqual(changes.moves, 0);
+            TestCase.assertEqual(changes.insertions, 0);
+            TestCase.assertEqual(realm.objects('TestObject').length, objectCount);
+            TestCase.assertTrue(array[0].isSameObject(third));
+
+            TestCase.assertThrows(() => array.assign([{doubleCol: 1}], {key: 'invalidProperty'}));
+            TestCase.assertThrows(() => array.assign([1]));
+
+            ints = realm.create('PrimitiveArrays', {int: [1, 2, 3, 2]}).int;
+            changes = ints.assign([2, 3, 1, 5]);
+            TestCase.assertArraysEqual(ints.slice(), [2, 3, 1, 5]);
+            TestCase.assertEqual(changes.deletions, 1);
+            TestCase.assertEqual(changes.moves, 1);
+            TestCase.assertEqual(changes.insertions, 1);
+            TestCase.assertThrows(() => ints.assign([1], {key: 'int'}));
+        });
+
+        TestCase.assertThrowsContaining(() => array.assign([]),
+                                        "Cannot modify managed objects outside of a write transaction");
+    },
+
+    testListTypedArrays: function() {
+        if (typeof navigator !== 'undefined' && /Chrome/.test(navigator.userAgent)) { // eslint-disable-line no-undef
+            // Typed arrays arrive as plain ArrayBuffers through the debugger.
+            return;
+        }
+
+        const realm = new Realm({schema: [schemas.PrimitiveArrays]});
+        let obj;
+        realm.write(() => {
+            obj = realm.create('PrimitiveArrays', {
+                bool: [true, false],
+                int: [1, -2, 3],
+                double: [1.5, 2.5],
+                optInt: [1, null],
+                string: ['a'],
+            });
+        });
+
+        let doubles = obj.double.toTypedArray();
+        TestCase.assertTrue(doubles instanceof Float64Array);
+        TestCase.assertArraysEqual(Array.from(doubles), [1.5, 2.5]);
+        TestCase.assertTrue(obj.bool.toTypedArray() instanceof Uint8Array);
+        TestCase.assertArraysEqual(Array.from(obj.bool.toTypedArray()), [1, 0]);
+        TestCase.assertArraysEqual(Array.from(obj.int.toTypedArray('Int32Array')), [1, -2, 3]);
+        TestCase.assertArraysEqual(Array.from(obj.int.sorted().toTypedArray('Int16Array')), [-2, 1, 3]);
+        TestCase.assertTrue(isNaN(obj.optInt.toTypedArray()[1]));
+        TestCase.assertThrows(() => obj.optInt.toTypedArray('Int32Array'));
+        TestCase.assertThrows(() => obj.int.toTypedArray('Uint8Array'));
+        TestCase.assertThrows(() => obj.int.toTypedArray('Array'));
+        TestCase.assertThrows(() => obj.string.toTypedArray());
+
+        TestCase.assertThrowsContaining(() => obj.int.setFromTypedArray(new Int32Array([1])),
+                                        "Cannot modify managed objects outside of a write transaction");
+        realm.write(() => {
+            obj.int.setFromTypedArray(new Int32Array([1, 5, 3, 4]));
+            TestCase.assertArraysEqual(obj.int.slice(), [1, 5, 3, 4]);
+            obj.int.setFromTypedArray(new Float64Array([7, 8]));
+            TestCase.assertArraysEqual(obj.int.slice(), [7, 8]);
+            TestCase.assertThrows(() => obj.int.setFromTypedArray(new Float64Array([1.5])));
+            TestCase.assertThrows(() => obj.int.setFromTypedArray([1, 2]));
+
+            obj.double.setFromTypedArray(new Float32Array([0.5, 0.25, 4]));
+            TestCase.assertArraysEqual(obj.double.slice(), [0.5, 0.25, 4]);
+            obj.bool.setFromTypedArray(new Uint8Array([0, 2]));
+            TestCase.assertArraysEqual(obj.bool.slice(), [false, true]);
+            TestCase.assertThrows(() => obj.string.setFromTypedArray(new Uint8Array([1])));
+        });
+    },
+
     testListDeletions: function() {
         const realm = new Realm({schema: [schemas.LinkTypes, schemas.TestObject]});
         let object;
@@ -1003,6 +1099,29 @@ module.exports = {
         realm.close();
     },
 
+    testListSlice: function() {
+        const realm = new Realm({schema: [schemas.PersonObject, schemas.PersonList]});
+        let list;
+        realm.write(() => {
+            const people = [];
+            for (let i = 0; i < 5; i++) {
+                people.push({name: `person ${i}`, age: i});
+            }
+            list = realm.create('PersonList', {list: people}).list;
+        });
+
+        TestCase.assertArraysEqual(list.slice(1, 3).map(p => p.age), [1, 2]);
+        TestCase.assertArraysEqual(list.slice(-1).map(p => p.name), ['person 4']);
+        TestCase.assertTrue(list.slice(0, 1)[0] instanceof schemas.PersonObject);
+
+        const projected = list.slice(0, 2, {properties: ['name', 'age']});
+        TestCase.assertArraysEqual(Object.keys(projected[0]), ['name', 'age']);
+        TestCase.assertEqual(projected[1].name, 'person 1');
+        TestCase.assertEqual(projected[1].age, 1);
+
+        realm.close();
+    },
+
     testIsValid: function() {
         const realm = new Realm({schema: [schemas.PersonObject, schemas.PersonList]});
         let object;
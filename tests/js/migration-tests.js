@@ -468,4 +468,105 @@ module.exports = {
         TestCase.assertEqual(objects[1].values[1], 4);
         TestCase.assertEqual(objects[1].values[2], 5);
     },
+
+    testBulkMigrationOperations: function() {
+        let realm = new Realm({schema: [{
+            name: 'TestObject',
+            properties: {name: 'string', age: 'string', score: 'int', flag: 'bool?'}
+        }]});
+        realm.write(function() {
+            realm.create('TestObject', {name: 'a', age: '12', score: 1, flag: false});
+            realm.create('TestObject', {name: 'b', age: ' 7 ', score: 2, flag: null});
+            realm.create('TestObject', {name: 'c', age: '40', score: 3, flag: true});
+        });
+        realm.close();
+
+        let progress = [];
+        let migration;
+        realm = new Realm({
+            schema: [{
+                name: 'TestObject',
+                properties: {
+                    fullName: 'string',
+                    age: 'int',
+                    score: 'string',
+                    flag: {type: 'bool', default: true},
+                    note: {type: 'string', default: 'n/a'},
+                }
+            }],
+            schemaVersion: 1,
+            migration: function(oldRealm, newRealm, m) {
+                migration = m;
+                m.setProgressCallback((operation, objectType, done, total) => progress.push([operation, objectType, done, total]));
+
+                m.renameProperty('TestObject', 'name', 'fullName');
+                m.copyProperty('TestObject', 'age', 'age', 'toNumber');
+                m.copyProperty('TestObject', 'score', 'score', 'toString');
+                m.copyProperty('TestObject', 'flag', 'flag', 'default');
+                m.fillDefault('TestObject', 'note');
+
+                TestCase.assertThrowsContaining(() => m.copyProperty('TestObject', 'age', 'age'),
+                                                "Cannot copy 'TestObject.age' of type 'string' to 'age' of type 'int'.");
+                TestCase.assertThrowsContaining(() => m.copyProperty('TestObject', 'age', 'age', 'toBoolean'),
+                                                "Unknown transform 'toBoolean'");
+                TestCase.assertThrowsContaining(() => m.fillDefault('TestObject', 'fullName'),
+                                                "Property 'TestObject.fullName' has no default value.");
+
+                TestCase.assertEqual(m.deleteWhere('TestObject', 'fullName == $0', 'c'), 1);
+                TestCase.assertThrowsContaining(() => m.copyProperty('TestObject', 'age', 'age', 'toNumber'),
+                                                "Properties of 'TestObject' can only be copied before its objects are created or deleted.");
+            }
+        });
+
+        const objects = realm.objects('TestObject');
+        TestCase.assertEqual(objects.length, 2);
+        TestCase.assertEqual(objects[0].fullName, 'a');
+        TestCase.assertEqual(objects[0].age, 12);
+        TestCase.assertEqual(objects[0].score, '1');
+        TestCase.assertEqual(objects[0].flag, false);
+        TestCase.assertEqual(objects[0].note, 'n/a');
+        TestCase.assertEqual(objects[1].fullName, 'b');
+        TestCase.assertEqual(objects[1].age, 7);
+        TestCase.assertEqual(objects[1].score, '2');
+        TestCase.assertEqual(objects[1].flag, true);
+
+        TestCase.assertEqual(JSON.stringify(progress), JSON.stringify([
+            ['copyProperty', 'TestObject', 3, 3],
+            ['copyProperty', 'TestObject', 3, 3],
+            ['copyProperty', 'TestObject', 3, 3],
+            ['fillDefault', 'TestObject', 3, 3],
+            ['deleteWhere', 'TestObject', 1, 1],
+        ]));
+        TestCase.assertThrowsContaining(() => migration.fillDefault('TestObject', 'note'),
+                                        'Migration operations can only be used within the migration function.');
+        realm.close();
+    },
+
+    testCopyPropertyWithFunction: function() {
+        let realm = new Realm({schema: [{name: 'TestObject', properties: {value: 'int'}}]});
+        realm.write(function() {
+            realm.create('TestObject', {value: 1});
+            realm.create('TestObject', {value: 2});
+        });
+        realm.close();
+
+        realm = new Realm({
+            schema: [{name: 'TestObject', properties: {value: 'int', label: 'string?'}}],
+            schemaVersion: 1,
+            migration: function(oldRealm, newRealm, migration) {
+                migration.copyProperty('TestObject', 'value', 'label', (value) => value > 1 ? `#${value}` : null);
+
+                // The table has as many objects as before, but not the same ones.
+                newRealm.delete(newRealm.objects('TestObject')[0]);
+                newRealm.create('TestObject', {value: 3});
+                TestCase.assertThrowsContaining(() => migration.copyProperty('TestObject', 'value', 'label', String),
+                                                "Properties of 'TestObject' can only be copied before its objects are created or deleted.");
+            }
+        });
+        const objects = realm.objects('TestObject');
+        TestCase.assertEqual(objects.length, 2);
+        TestCase.assertEqual(objects[0].label, '#2');
+        TestCase.assertEqual(objects[1].label, null);
+        realm.close();
+    },
 };
@@ -446,6 +446,44 @@ describe('Notifier', () => {
         realm.close();
     });
 
+    it("should reuse the Realms of a change and close the old one with it", async function() {
+        const [callback, realm] = await createRealmAndChangeListener();
+        let oldRealm, newRealm;
+        await changeObjectPromise(
+            () => realm.write(() => realm.create('IntObject', [1])),
+            (changes) => {
+                newRealm = changes.realm;
+                oldRealm = changes.oldRealm;
+                expect(changes.realm).toBe(newRealm);
+                expect(changes.oldRealm).toBe(oldRealm);
+                expect(oldRealm.objects('IntObject').length).toEqual(0);
+            });
+        expect(oldRealm.isClosed).toBe(true);
+        expect(newRealm.objects('IntObject').length).toEqual(1);
+        realm.close();
+    });
+
+    it("should serialize change events in binary form", async function() {
+        const [callback, realm] = await createRealmAndChangeListener();
+        await changeObjectPromise(
+            () => realm.write(() => {
+                realm.create('IntObject', [1]);
+                realm.create('IntObject', [2]);
+            }),
+            (changes) => {
+                const serialized = changes.serialize({ binary: true, includeChanges: true });
+                expect(serialized instanceof ArrayBuffer).toBe(true);
+                const deserialized = (Realm.Sync as any)._deserializeChangeSet(Buffer.from(serialized));
+                expect(deserialized.path).toEqual(changes.path);
+                expect(deserialized.changes.IntObject.insertions).toEqual(changes.changes.IntObject.insertions);
+                expect(deserialized.changes.IntObject.deletions).toEqual([]);
+                deserialized.close();
+
+                expect(() => changes.serialize({ includeChanges: true })).toThrow();
+            });
+        realm.close();
+    });
+
     it("should only notify for changes to realms which match the regex", async function() {
         const [callback, realm1, realm2] = await Promise.all([
             addChangeListener('.*test1', rosController),
@@ -103,6 +103,70 @@ module.exports = {
         TestCase.assertEqual(object.nonexistent, undefined);
     },
 
+    testAccessorTemplates: function() {
+        const realm = new Realm({schema: [schemas.AllTypes, schemas.TestObject, schemas.LinkToAllTypes], _accessorTemplates: true});
+        let object;
+
+        realm.write(function() {
+            object = realm.create('AllTypesObject', allTypesValues);
+        });
+
+        TestCase.assertTrue(object instanceof Realm.Object);
+        TestCase.assertEqual(object.intCol, 1);
+        TestCase.assertEqual(object.stringCol, 'string');
+        TestCase.assertEqual(object.objectCol.doubleCol, 2.2);
+        TestCase.assertEqual(object.nonexistent, undefined);
+        TestCase.assertArraysEqual(Object.keys(object), Object.keys(realm.schema[0].properties));
+
+        TestCase.assertThrows(function() {
+            object.intCol = 2;
+        }, 'can only set property values in a write transaction');
+
+        realm.write(function() {
+            object.intCol = 2;
+            object.stringCol = 'other';
+        });
+        TestCase.assertEqual(object.intCol, 2);
+        TestCase.assertEqual(object.stringCol, 'other');
+
+        TestCase.assertThrows(function() {
+            realm.write(function() {
+                object.intCol = 'not a number';
+            });
+        });
+    },
+
+    testObjectIdentityCache: function() {
+        if (!TestCase.isNode()) {
+            return;
+        }
+
+        const realm = new Realm({schema: [schemas.LinkTypes, schemas.TestObject], _cacheObjects: true});
+        let first, second;
+        realm.write(function() {
+            first = realm.create('TestObject', {doubleCol: 1});
+            second = realm.create('TestObject', {doubleCol: 2});
+            realm.create('LinkTypesObject', {objectCol: first, objectCol1: second, arrayCol: [first, second]});
+        });
+
+        const objects = realm.objects('TestObject');
+        const links = realm.objects('LinkTypesObject');
+        TestCase.assertTrue(objects[0] === first);
+        TestCase.assertTrue(objects.filtered('doubleCol = 2')[0] === second);
+        TestCase.assertTrue(links[0].objectCol === first);
+        TestCase.assertTrue(links[0].arrayCol[1] === second);
+
+        // Deleting the first row moves the second one into its place.
+        realm.write(function() {
+            realm.delete(first);
+        });
+        TestCase.assertFalse(first.isValid());
+        TestCase.assertTrue(objects[0] === second);
+        TestCase.assertEqual(objects[0].doubleCol, 2);
+
+        realm.close();
+    },
+
     testAllTypesPropertySetters: function() {
         const realm = new Realm({schema: [schemas.AllTypes, schemas.TestObject, schemas.LinkToAllTypes]});
         let obj;
@@ -367,6 +431,50 @@ module.exports = {
         });
     },
 
+    testDataPropertiesFromViews: function() {
+        const realm = new Realm({schema: [schemas.DefaultValues, schemas.TestObject]});
+        let object;
+        realm.write(function() {
+            object = realm.create('DefaultValuesObject', {dataCol: new Uint8Array(RANDOM_DATA.buffer, 1, 2)});
+        });
+        // Views are written from their own bytes, and reads are copies.
+        TestCase.assertTrue(object.dataCol instanceof ArrayBuffer);
+        TestCase.assertArraysEqual(new Uint8Array(object.dataCol), RANDOM_DATA.subarray(1, 3));
+        realm.close();
+    },
+
+    testDatesAsNumbers: function() {
+        const realm = new Realm({schema: [schemas.DefaultValues, schemas.TestObject], _datesAsNumbers: true});
+        const date = new Date(1575000000123);
+        const long = 'a'.repeat(4096);
+        const unicode = 'Æøå ' + '\u{1F600}'.repeat(600);
+        let object;
+        realm.write(function() {
+            object = realm.create('DefaultValuesObject', {dateCol: date, stringCol: long});
+        });
+        TestCase.assertEqual(typeof object.dateCol, 'number');
+        TestCase.assertEqual(object.dateCol, date.getTime());
+        TestCase.assertEqual(object.stringCol, long);
+
+        realm.write(function() {
+            object.dateCol = date.getTime() + 1;
+            object.stringCol = unicode;
+        });
+        TestCase.assertEqual(object.dateCol, date.getTime() + 1);
+        TestCase.assertEqual(object.stringCol, unicode);
+        TestCase.assertEqual(realm.objects('DefaultValuesObject').filtered('dateCol > $0', date).length, 1);
+        realm.close();
+
+        const other = new Realm({schema: [schemas.DefaultValues, schemas.TestObject]});
+        const dates = other.objects('DefaultValuesObject')[0].dateCol;
+        TestCase.assertTrue(dates instanceof Date);
+        TestCase.assertEqual(dates.getTime(), date.getTime() + 1);
+        TestCase.assertThrows(() => other.write(() => {
+            other.objects('DefaultValuesObject')[0].dateCol = 0;
+        }));
+        other.close();
+    },
+
     testObjectConstructor: function() {
         const realm = new Realm({schema: [schemas.TestObject]});
 
@@ -606,6 +714,141 @@ module.exports = {
         await new Promise(r => resolve = r);
     },
 
+    async testNotificationKeyPaths() {
+        const PersonSchema = {
+            name: 'Person',
+            properties: { name: 'string', lastSeen: 'int' },
+        };
+        const realm = new Realm({schema: [PersonSchema]});
+
+        let obj;
+        realm.write(() => {
+            obj = realm.create('Person', { name: 'Alice', lastSeen: 0 });
+        });
+        TestCase.assertThrowsContaining(() => obj.addListener(() => {}, { keyPaths: ['age'] }),
+                                        "Key path 'age' refers to 'age', which is not a property of 'Person'.");
+
+        const objectChanges = [];
+        const collectionChanges = [];
+        let resolveObject, resolveCollection;
+        let objectNotified = new Promise(r => resolveObject = r);
+        let collectionNotified = new Promise(r => resolveCollection = r);
+
+        obj.addListener((obj, changes) => {
+            objectChanges.push(changes.changedProperties);
+            resolveObject();
+        }, { keyPaths: ['name'] });
+        realm.objects('Person').addListener((people, changes) => {
+            collectionChanges.push(changes.newModifications);
+            resolveCollection();
+        }, { keyPaths: ['name'] });
+        await Promise.all([objectNotified, collectionNotified]);
+
+        objectNotified = new Promise(r => resolveObject = r);
+        collectionNotified = new Promise(r => resolveCollection = r);
+        realm.write(() => {
+            obj.lastSeen = 1;
+        });
+        realm.write(() => {
+            obj.name = 'Bob';
+        });
+        await Promise.all([objectNotified, collectionNotified]);
+
+        // The change to lastSeen alone was not delivered.
+        TestCase.assertEqual(objectChanges.length, 2);
+        TestCase.assertArraysEqual(objectChanges[1], ['name']);
+        TestCase.assertEqual(collectionChanges.length, 2);
+        TestCase.assertArraysEqual(collectionChanges[1], [0]);
+        realm.close();
+    },
+
+    async testNotificationNestedKeyPaths() {
+        const DogSchema = {
+            name: 'Dog',
+            properties: { name: 'string', age: 'int' },
+        };
+        const OwnerSchema = {
+            name: 'Owner',
+            properties: { name: 'string', dog: 'Dog' },
+        };
+        const realm = new Realm({schema: [DogSchema, OwnerSchema]});
+
+        let owner;
+        realm.write(() => {
+            owner = realm.create('Owner', { name: 'Alice', dog: { name: 'Rex', age: 1 } });
+        });
+        TestCase.assertThrowsContaining(() => owner.addListener(() => {}, { keyPaths: ['name.first'] }),
+                                        "Key path 'name.first' continues past 'name', which is not a link.");
+
+        const changes = [];
+        let resolve;
+        let notified = new Promise(r => resolve = r);
+        owner.addListener((obj, change) => {
+            changes.push(change.changedProperties);
+            resolve();
+        }, { keyPaths: ['dog.name'] });
+        await notified;
+
+        notified = new Promise(r => resolve = r);
+        realm.write(() => {
+            owner.dog.age = 2;
+            owner.name = 'Bob';
+        });
+        realm.write(() => {
+            owner.dog.name = 'Max';
+        });
+        await notified;
+
+        // Only the change to the dog's name was delivered.
+        TestCase.assertEqual(changes.length, 2);
+        TestCase.assertArraysEqual(changes[1], ['dog']);
+        realm.close();
+    },
+
+    async testNotificationLinkKeyPathsFollowMovedObjects() {
+        const DogSchema = {
+            name: 'Dog',
+            properties: { name: 'string' },
+        };
+        const OwnerSchema = {
+            name: 'Owner',
+            properties: { name: 'string', dog: 'Dog' },
+        };
+        const realm = new Realm({schema: [DogSchema, OwnerSchema]});
+
+        let spare, alice, max;
+        realm.write(() => {
+            spare = realm.create('Dog', { name: 'Spare' });
+            alice = realm.create('Owner', { name: 'Alice', dog: { name: 'Rex' } });
+            realm.create('Owner', { name: 'Bob', dog: { name: 'Max' } });
+            max = realm.objects('Dog').filtered('name = "Max"')[0];
+        });
+
+        const changes = [];
+        let resolve;
+        let notified = new Promise(r => resolve = r);
+        realm.objects('Owner').addListener((owners, change) => {
+            changes.push(change.newModifications);
+            resolve();
+        }, { keyPaths: ['dog'] });
+        await notified;
+
+        notified = new Promise(r => resolve = r);
+        realm.write(() => {
+            // Moves Max into the row of the deleted dog.
+            realm.delete(spare);
+        });
+        realm.write(() => {
+            alice.dog = max;
+        });
+        await notified;
+
+        // Bob still links to the same dog after it moved.
+        TestCase.assertEqual(changes.length, 2);
+        TestCase.assertArraysEqual(changes[1], [0]);
+        realm.close();
+    },
+
     testAddAndRemoveListener: async function() {
         const realm = new Realm({schema: [schemas.StringOnly]});
 
@@ -694,5 +937,67 @@ module.exports = {
                 }, 2000);
             }, 2000);
         });
+    },
+
+    testToPlain: function() {
+        const realm = new Realm({schema: [schemas.PersonObject, schemas.PrimitiveArrays]});
+        let alice, bob, arrays;
+        realm.write(() => {
+            alice = realm.create('PersonObject', {name: 'Alice', age: 40});
+            bob = realm.create('PersonObject', {name: 'Bob', age: 12, children: [alice]});
+            alice.children.push(bob);
+            arrays = realm.create('PrimitiveArrays', {
+                int: [1, 2], date: [new Date(0)], optString: ['a', null], data: [new Uint8Array([104, 105]).buffer],
+            });
+        });
+
+        const plain = alice.toPlain();
+        TestCase.assertFalse(plain instanceof Realm.Object);
+        TestCase.assertEqual(plain.name, 'Alice');
+        TestCase.assertEqual(plain.married, false);
+        TestCase.assertTrue(Array.isArray(plain.children));
+        TestCase.assertEqual(plain.children[0].name, 'Bob');
+        TestCase.assertEqual(plain.children[0].children[0], plain);
+        TestCase.assertFalse('parents' in plain);
+
+        const shallow = alice.toPlain({depth: 0, properties: ['name', 'children']});
+        TestCase.assertArraysEqual(Object.keys(shallow), ['name', 'children']);
+        TestCase.assertNull(shallow.children);
+        TestCase.assertThrowsContaining(() => alice.toPlain({properties: ['nope']}), "Property 'nope' does not exist");
+
+        TestCase.assertEqual(alice.toPlain({depth: 1, properties: ['name', 'children'], json: true}),
+                             '{"name":"Alice","children":[{"name":"Bob","age":12,"married":false,"children":null}]}');
+        TestCase.assertThrowsContaining(() => alice.toPlain({json: true}), 'cycle');
+
+        const people = realm.objects('PersonObject').sorted('name');
+        const list = people.toPlain({depth: 0});
+        TestCase.assertEqual(list.length, 2);
+        TestCase.assertEqual(list[1].name, 'Bob');
+        TestCase.assertEqual(people.toPlain({properties: ['age'], json: true}), '[{"age":40},{"age":12}]');
+        TestCase.assertArraysEqual(alice.children.toPlain({properties: ['name']}).map((person) => person.name), ['Bob']);
+
+        // An object reached through a link with less depth left, or with all
+        // of its properties, isn't reused at the top.
+        const limited = people.toPlain({depth: 1});
+        TestCase.assertNull(limited[0].children[0].children);
+        TestCase.assertEqual(limited[1].children[0].name, 'Alice');
+        const projectedPeople = people.toPlain({properties: ['name', 'children']});
+        TestCase.assertEqual(projectedPeople[0].children[0].children[0].age, 40);
+        TestCase.assertArraysEqual(Object.keys(projectedPeople[1]), ['name', 'children']);
+
+        const values = arrays.toPlain();
+        TestCase.assertArraysEqual(values.int, [1, 2]);
+        TestCase.assertTrue(values.date[0] instanceof Date);
+        TestCase.assertArraysEqual(values.optString, ['a', null]);
+        TestCase.assertArraysEqual(arrays.int.toPlain(), [1, 2]);
+        TestCase.assertThrows(() => arrays.int.toPlain({properties: ['int']}));
+        const json = JSON.parse(arrays.toPlain({json: true}));
+        TestCase.assertEqual(json.date[0], new Date(0).toJSON());
+        TestCase.assertEqual(json.data[0], 'aGk=');
+        TestCase.assertArraysEqual(json.optString, ['a', null]);
+
+        realm.write(() => realm.delete(bob));
+        TestCase.assertThrows(() => bob.toPlain());
+        realm.close();
     }
 };
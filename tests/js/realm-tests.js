@@ -216,6 +216,49 @@ module.exports = {
         TestCase.assertThrowsContaining(() => new Realm({}), 'already opened with different inMemory settings.');
     },
 
+    testRealmConstructorInMemoryPersisted: function() {
+        const persistTo = 'in-memory-snapshot.realm';
+        const config = {path: 'in-memory.realm', inMemory: {persistTo, intervalMs: 10}, schema: [schemas.PersonObject]};
+
+        // A snapshot is written when the Realm is closed.
+        let realm = new Realm(config);
+        TestCase.assertEqual(realm.inMemory, true);
+        realm.write(() => {
+            realm.create('PersonObject', {name: 'Alice', age: 30, children: [{name: 'Bob', age: 5}]});
+        });
+        realm.close();
+        TestCase.assertTrue(Realm.exists({path: persistTo}));
+
+        realm = new Realm(config);
+        const people = realm.objects('PersonObject').sorted('age');
+        TestCase.assertEqual(people.length, 2);
+        TestCase.assertEqual(people[0].name, 'Bob');
+        TestCase.assertEqual(people[0].parents[0].name, 'Alice');
+        TestCase.assertEqual(people[1].children.length, 1);
+        TestCase.assertEqual(people[1].children[0].name, 'Bob');
+        realm.close();
+
+        TestCase.assertThrowsContaining(() => new Realm({path: persistTo, inMemory: {persistTo}}),
+                                        "'persistTo' must be a different path than the path of the Realm.");
+        TestCase.assertThrowsContaining(() => new Realm({inMemory: {persistTo, intervalMs: 0}}),
+                                        "'intervalMs' must be at least 1.");
+        Realm.deleteFile({path: persistTo});
+    },
+
+    async testRealmConstructorInMemoryPersistedError() {
+        const config = {path: 'in-memory.realm', inMemory: {persistTo: 'missing-directory/snapshot.realm', intervalMs: 10},
+                        schema: [schemas.PersonObject]};
+        const realm = new Realm(config);
+        realm.write(() => {
+            realm.create('PersonObject', {name: 'Alice', age: 30});
+        });
+
+        // The snapshot can't be written to a directory which doesn't exist.
+        await new Promise(resolve => setTimeout(resolve, 100));
+        TestCase.assertType(realm.memoryStats().snapshotError, 'string');
+        realm.close();
+    },
+
     testRealmConstructorReadOnly: function() {
         let realm = new Realm({schema: [schemas.TestObject]});
         realm.write(() => {
@@ -372,6 +415,64 @@ module.exports = {
     },
 
 
+    testRealmWriteAsync: function() {
+        const realm = new Realm({schema: [schemas.TestObject]});
+        TestCase.assertThrows(() => realm.writeAsync('not a function'));
+
+        const first = realm.writeAsync(() => realm.create('TestObject', {doubleCol: 1}).doubleCol);
+        const failing = realm.writeAsync(() => {
+            realm.create('TestObject', {doubleCol: 2});
+            throw new Error('failed write');
+        });
+        const last = realm.writeAsync((r) => {
+            TestCase.assertTrue(r.isInTransaction);
+            r.create('TestObject', {doubleCol: 3});
+        });
+
+        // Nothing is written until a later turn of the event loop.
+        TestCase.assertEqual(realm.objects('TestObject').length, 0);
+
+        return first.then((value) => {
+            TestCase.assertEqual(value, 1);
+            return failing.then(() => {
+                throw new Error('The failing write should have been rejected');
+            }, (error) => {
+                TestCase.assertEqual(error.message, 'failed write');
+            });
+        }).then(() => last).then(() => {
+            const objects = realm.objects('TestObject');
+            TestCase.assertEqual(objects.length, 2);
+            TestCase.assertEqual(objects.filtered('doubleCol = 2').length, 0);
+            realm.close();
+        });
+    },
+
+    testRealmCreateMany: function() {
+        const realm = new Realm({schema: [schemas.IntPrimary, schemas.TestObject]});
+
+        TestCase.assertThrowsContaining(() => realm.createMany('TestObject', [{doubleCol: 1}]),
+                                        "Cannot modify managed objects outside of a write transaction.");
+
+        realm.write(() => {
+            TestCase.assertEqual(realm.createMany('TestObject', [{doubleCol: 1}, [2], {doubleCol: 3}]), undefined);
+            TestCase.assertThrowsContaining(() => realm.createMany('TestObject', [[1, 2]]),
+                                            'Array must contain values for all object properties');
+            TestCase.assertThrows(() => realm.createMany('TestObject', {doubleCol: 1}));
+
+            realm.createMany('IntPrimaryObject', [{primaryCol: 1, valueCol: 'a'}, {primaryCol: 2, valueCol: 'b'}]);
+            realm.createMany('IntPrimaryObject', [{primaryCol: 2, valueCol: 'c'}, [3, 'd']], 'modified');
+            TestCase.assertThrowsContaining(() => realm.createMany('IntPrimaryObject', [{primaryCol: 1, valueCol: 'e'}]),
+                                            "Attempting to create an object of type 'IntPrimaryObject' with an existing primary key value '1'.");
+        });
+
+        const objects = realm.objects('TestObject');
+        TestCase.assertEqual(objects.length, 3);
+        TestCase.assertArraysEqual(objects.map(o => o.doubleCol), [1, 2, 3]);
+
+        const primaryObjects = realm.objects('IntPrimaryObject').sorted('primaryCol');
+        TestCase.assertArraysEqual(primaryObjects.map(o => o.valueCol), ['a', 'c', 'd']);
+    },
+
     testRealmCreateOrUpdate_InvalidArguments: function() {
         const realm = new Realm({schema: [schemas.TestObject]});
         realm.write(function() {
@@ -927,6 +1028,120 @@ module.exports = {
         });
     },
 
+    testRealmDeleteMixedArray: function() {
+        const realm = new Realm({schema: [schemas.TestObject, schemas.IntPrimary]});
+
+        realm.write(() => {
+            for (let i = 0; i < 10; i++) {
+                realm.create('TestObject', {doubleCol: i});
+                realm.create('IntPrimaryObject', {primaryCol: i, valueCol: `${i}`});
+            }
+        });
+
+        const objects = realm.objects('TestObject');
+        const primaryObjects = realm.objects('IntPrimaryObject');
+        realm.write(() => {
+            const toDelete = [objects[1], primaryObjects[9], objects[8], primaryObjects[0], objects[1], objects[5]];
+            realm.delete(toDelete);
+        });
+
+        TestCase.assertEqual(objects.length, 7);
+        TestCase.assertArraysEqual(objects.sorted('doubleCol').map(o => o.doubleCol), [0, 2, 3, 4, 6, 7, 9]);
+        TestCase.assertArraysEqual(primaryObjects.sorted('primaryCol').map(o => o.primaryCol), [1, 2, 3, 4, 5, 6, 7, 8]);
+    },
+
+    testRealmDeleteByPrimaryKeys: function() {
+        const realm = new Realm({schema: [schemas.TestObject, schemas.IntPrimary, schemas.StringPrimary]});
+
+        realm.write(() => {
+            for (let i = 0; i < 10; i++) {
+                realm.create('IntPrimaryObject', {primaryCol: i, valueCol: `${i}`});
+                realm.create('StringPrimaryObject', {primaryCol: `${i}`, valueCol: i});
+            }
+        });
+
+        TestCase.assertThrowsContaining(() => realm.deleteByPrimaryKeys('IntPrimaryObject', [1]),
+                                        "Can only delete objects within a transaction.");
+
+        realm.write(() => {
+            TestCase.assertEqual(realm.deleteByPrimaryKeys('IntPrimaryObject', [9, 1, 5, 1, 42]), 3);
+            TestCase.assertEqual(realm.deleteByPrimaryKeys('StringPrimaryObject', ['0', '9']), 2);
+            TestCase.assertThrowsContaining(() => realm.deleteByPrimaryKeys('TestObject', [1]),
+                                            "'TestObject' does not have a primary key defined");
+        });
+
+        TestCase.assertArraysEqual(realm.objects('IntPrimaryObject').sorted('primaryCol').map(o => o.primaryCol), [0, 2, 3, 4, 6, 7, 8]);
+        TestCase.assertEqual(realm.objects('StringPrimaryObject').length, 8);
+        TestCase.assertEqual(realm.objectForPrimaryKey('StringPrimaryObject', '9'), undefined);
+    },
+
+    testRealmObjectsForPrimaryKeys: function() {
+        const realm = new Realm({schema: [schemas.TestObject, schemas.IntPrimary, schemas.StringPrimary]});
+
+        realm.write(() => {
+            for (let i = 0; i < 10; i++) {
+                realm.create('IntPrimaryObject', {primaryCol: i, valueCol: `${i}`});
+                realm.create('StringPrimaryObject', {primaryCol: `${i}`, valueCol: i});
+            }
+        });
+
+        const intObjects = realm.objectsForPrimaryKeys('IntPrimaryObject', [3, 42, 0, 3]);
+        TestCase.assertEqual(intObjects.length, 4);
+        TestCase.assertEqual(intObjects[0].valueCol, '3');
+        TestCase.assertNull(intObjects[1]);
+        TestCase.assertEqual(intObjects[2].valueCol, '0');
+        TestCase.assertEqual(intObjects[3].valueCol, '3');
+
+        const stringObjects = realm.objectsForPrimaryKeys(schemas.StringPrimary, ['9', 'missing']);
+        TestCase.assertEqual(stringObjects[0].valueCol, 9);
+        TestCase.assertNull(stringObjects[1]);
+
+        TestCase.assertEqual(realm.objectsForPrimaryKeys('IntPrimaryObject', []).length, 0);
+        TestCase.assertThrowsContaining(() => realm.objectsForPrimaryKeys('TestObject', [1]),
+                                        "'TestObject' does not have a primary key defined");
+        TestCase.assertThrows(() => realm.objectsForPrimaryKeys('IntPrimaryObject', ['1']));
+        TestCase.assertThrows(() => realm.objectsForPrimaryKeys('IntPrimaryObject', 1));
+    },
+
+    testRealmSetLinks: function() {
+        const realm = new Realm({schema: [schemas.IntPrimary, schemas.StringPrimary, {
+            name: 'Order',
+            primaryKey: 'id',
+            properties: {
+                id: 'int',
+                customer: 'StringPrimaryObject',
+                notes: 'string[]',
+            }
+        }]});
+
+        TestCase.assertThrowsContaining(() => realm._setLinks('Order', 'customer', []),
+                                        "Cannot modify managed objects outside of a write transaction.");
+        realm.write(() => {
+            for (let i = 0; i < 3; i++) {
+                realm.create('Order', {id: i});
+                realm.create('StringPrimaryObject', {primaryCol: `${i}`, valueCol: i});
+            }
+
+            const result = realm._setLinks('Order', 'customer', [[0, '2'], [1, '1'], [2, 'missing'], [42, '0']]);
+            TestCase.assertArraysEqual(result.missingSources, [3]);
+            TestCase.assertArraysEqual(result.missingTargets, [2]);
+
+            const orders = realm.objects('Order').sorted('id');
+            TestCase.assertEqual(orders[0].customer.valueCol, 2);
+            TestCase.assertEqual(orders[1].customer.valueCol, 1);
+            TestCase.assertNull(orders[2].customer);
+
+            realm._setLinks('Order', 'customer', [[0, 'missing']]);
+            TestCase.assertNull(orders[0].customer);
+
+            TestCase.assertThrowsContaining(() => realm._setLinks('IntPrimaryObject', 'valueCol', []),
+                                            "Property 'IntPrimaryObject.valueCol' is not a link to an object.");
+            TestCase.assertThrowsContaining(() => realm._setLinks('Order', 'nope', []), 'No such property: nope');
+            TestCase.assertThrows(() => realm._setLinks('Order', 'customer', [[0]]));
+            TestCase.assertThrows(() => realm._setLinks('Order', 'customer', [['0', '1']]));
+        });
+    },
+
     testDeleteAll: function() {
         const realm = new Realm({schema: [schemas.TestObject, schemas.IntPrimary]});
 
@@ -1101,6 +1316,154 @@ module.exports = {
                                         'expected error message');
     },
 
+    testThreadSafeReferences: function() {
+        if (typeof navigator !== 'undefined' && /Chrome/.test(navigator.userAgent)) { // eslint-disable-line no-undef
+            // Thread safe references are not available through the debugger's RPC.
+            return;
+        }
+
+        const realm = new Realm({schema: [schemas.TestObject, schemas.PersonList, schemas.PersonObject]});
+        let object, list;
+        realm.write(() => {
+            object = realm.create('TestObject', {doubleCol: 1});
+            realm.create('TestObject', {doubleCol: 2});
+            list = realm.create('PersonList', {list: [{name: 'Alice', age: 20}]}).list;
+        });
+
+        const objectReference = realm.createThreadSafeReference(object);
+        TestCase.assertEqual(objectReference.type, 'Object');
+        TestCase.assertEqual(objectReference.path, realm.path);
+        // References are plain objects which survive being copied.
+        const resolved = Realm.resolveThreadSafeReference(JSON.parse(JSON.stringify(objectReference)));
+        TestCase.assertEqual(resolved.doubleCol, 1);
+        TestCase.assertThrowsContaining(() => Realm.resolveThreadSafeReference(objectReference),
+                                        'Thread safe reference does not exist or has already been resolved.');
+
+        const results = Realm.resolveThreadSafeReference(realm.createThreadSafeReference(realm.objects('TestObject').filtered('doubleCol > 1')));
+        TestCase.assertTrue(results instanceof Realm.Results);
+        TestCase.assertEqual(results.length, 1);
+
+        const resolvedList = Realm.resolveThreadSafeReference(realm.createThreadSafeReference(list));
+        TestCase.assertTrue(resolvedList instanceof Realm.List);
+        TestCase.assertEqual(resolvedList[0].name, 'Alice');
+
+        const realmReference = realm.createThreadSafeReference();
+        TestCase.assertEqual(realmReference.type, 'Realm');
+        TestCase.assertEqual(Realm.resolveThreadSafeReference(realmReference).path, realm.path);
+
+        TestCase.assertThrowsContaining(() => realm.createThreadSafeReference({}),
+                                        'Only Realm objects, Results and Lists can be referenced from another thread.');
+        realm.write(() => {
+            TestCase.assertThrows(() => realm.createThreadSafeReference(object));
+        });
+        realm.close();
+    },
+
+    testFrozenVersions: function() {
+        if (typeof navigator !== 'undefined' && /Chrome/.test(navigator.userAgent)) { // eslint-disable-line no-undef
+            // Frozen handles are not available through the debugger's RPC.
+            return;
+        }
+
+        const realm = new Realm({schema: [schemas.TestObject, schemas.PersonList, schemas.PersonObject]});
+        let list;
+        realm.write(() => {
+            realm.create('TestObject', {doubleCol: 1});
+            realm.create('TestObject', {doubleCol: 2});
+            list = realm.create('PersonList', {list: [{name: 'Alice', age: 20}]}).list;
+        });
+        TestCase.assertEqual(realm.memoryStats().frozenVersions, 0);
+
+        const frozenRealm = realm.freeze();
+        const frozen = realm.objects('TestObject').filtered('doubleCol > 1').freeze();
+        const frozenList = list.freeze();
+        TestCase.assertEqual(frozen.objectType, 'TestObject');
+        TestCase.assertEqual(frozen.version, frozenRealm.version);
+        TestCase.assertEqual(realm.memoryStats().frozenVersions, 3);
+
+        realm.write(() => {
+            realm.create('TestObject', {doubleCol: 3});
+            list[0].name = 'Bob';
+        });
+
+        // The handles keep reading the version they were frozen at.
+        TestCase.assertEqual(frozen.length, 1);
+        TestCase.assertEqual(frozen.get(0).doubleCol, 2);
+        TestCase.assertUndefined(frozen.get(1));
+        TestCase.assertEqual(frozenList.toPlain()[0].name, 'Alice');
+        const frozenObjects = frozenRealm.objects('TestObject');
+        TestCase.assertEqual(frozenObjects.length, 2);
+        TestCase.assertThrowsContaining(() => frozenRealm.objects('NoSuchType'), 'NoSuchType');
+
+        const resolved = Realm.resolveFrozen(frozen.id);
+        TestCase.assertEqual(resolved.id, frozen.id);
+        TestCase.assertEqual(resolved.toPlain({properties: ['doubleCol']})[0].doubleCol, 2);
+        const resolvedRealm = Realm.resolveFrozen(frozenRealm.id);
+        TestCase.assertEqual(resolvedRealm.version, frozenRealm.version);
+
+        frozenRealm.close();
+        frozenObjects.close();
+        resolvedRealm.close();
+        const listId = frozenList.id;
+        frozenList.close();
+        TestCase.assertTrue(frozenList.isClosed);
+        TestCase.assertThrowsContaining(() => frozenList.length, 'closed');
+        TestCase.assertThrowsContaining(() => Realm.resolveFrozen(listId), 'released');
+
+        // The version is released along with the last handle to it.
+        frozen.close();
+        TestCase.assertEqual(realm.memoryStats().frozenVersions, 1);
+        resolved.close();
+        TestCase.assertEqual(realm.memoryStats().frozenVersions, 0);
+
+        realm.write(() => {
+            TestCase.assertThrowsContaining(() => realm.freeze(), 'write transaction');
+        });
+        realm.close();
+    },
+
+    testNotificationsChangedDuringDispatch: function() {
+        const realm = new Realm({schema: []});
+        const calls = [];
+
+        function added() {
+            calls.push('added');
+        }
+        function removed() {
+            calls.push('removed');
+        }
+        realm.addListener('change', () => {
+            calls.push('first');
+            realm.removeListener('change', removed);
+            realm.addListener('change', added);
+        });
+        realm.addListener('change', removed);
+
+        // Listeners changed from inside a listener take effect from the next notification.
+        realm.write(() => {});
+        TestCase.assertArraysEqual(calls, ['first', 'removed']);
+
+        calls.length = 0;
+        realm.write(() => {});
+        TestCase.assertArraysEqual(calls, ['first', 'added']);
+
+        const dispatched = [];
+        realm._setListenerDispatchHook((name, listener, milliseconds) => {
+            TestCase.assertEqual(typeof milliseconds, 'number');
+            TestCase.assertTrue(milliseconds >= 0);
+            dispatched.push([name, listener]);
+        });
+        realm.write(() => {});
+        TestCase.assertEqual(dispatched.length, 2);
+        TestCase.assertEqual(dispatched[0][0], 'change');
+        TestCase.assertEqual(dispatched[1][1], added);
+
+        realm._setListenerDispatchHook(null);
+        realm.write(() => {});
+        TestCase.assertEqual(dispatched.length, 2);
+        realm.close();
+    },
+
     testSchema: function() {
         const originalSchema = [schemas.TestObject, schemas.AllTypes, schemas.LinkToAllTypes,
                                 schemas.IndexedTypes, schemas.IntPrimary, schemas.PersonObject,
@@ -1183,6 +1546,32 @@ module.exports = {
         }
     },
 
+    testSchemaIsCached: function() {
+        if (typeof navigator !== 'undefined' && /Chrome/.test(navigator.userAgent)) { // eslint-disable-line no-undef
+            // Schema objects are copied through the debugger's RPC.
+            return;
+        }
+
+        let realm = new Realm({schema: [schemas.TestObject, schemas.IntPrimary]});
+        const schema = realm.schema;
+        TestCase.assertEqual(realm.schema, schema);
+        TestCase.assertTrue(Object.isFrozen(schema));
+        TestCase.assertTrue(Object.isFrozen(schema[0]));
+        TestCase.assertTrue(Object.isFrozen(schema[0].properties));
+        TestCase.assertTrue(Object.isFrozen(schema[0].properties.doubleCol));
+
+        const object = realm.write(() => realm.create('TestObject', {doubleCol: 1}));
+        const objectSchema = object.objectSchema();
+        TestCase.assertEqual(object.objectSchema(), objectSchema);
+        TestCase.assertEqual(schema.find((s) => s.name === 'TestObject'), objectSchema);
+        realm.close();
+
+        realm = new Realm({schema: [schemas.TestObject, schemas.IntPrimary, schemas.StringOnly], schemaVersion: 1});
+        TestCase.assertNotEqual(realm.schema, schema);
+        TestCase.assertEqual(realm.schema.length, 3);
+        realm.close();
+    },
+
     testCopyBundledRealmFiles: function() {
         Realm.copyBundledRealmFiles();
 
@@ -1332,6 +1721,109 @@ module.exports = {
         TestCase.assertTrue(realm1.compact());
     },
 
+    testCompactAsync: function() {
+        const realm = new Realm({schema: [schemas.StringOnly]});
+        realm.write(() => {
+            for (let i = 0; i < 1000; i++) {
+                realm.create('StringOnlyObject', { stringCol: 'A'.repeat(100) });
+            }
+        });
+        realm.write(() => realm.deleteAll());
+        realm.write(() => realm.create('StringOnlyObject', { stringCol: 'B' }));
+
+        const before = realm.fileStats();
+        TestCase.assertTrue(before.fileSize > 0);
+        TestCase.assertEqual(before.fileSize, before.usedSize + before.freeSize);
+        TestCase.assertTrue(before.activeVersions >= 1);
+
+        TestCase.assertThrows(() => realm.compactAsync('not a function'));
+
+        let progressCalls = 0;
+        return realm.compactAsync(() => progressCalls++).then((compacted) => {
+            TestCase.assertTrue(compacted);
+            TestCase.assertTrue(progressCalls > 0);
+            TestCase.assertFalse(realm.isClosed);
+            TestCase.assertEqual(realm.objects('StringOnlyObject')[0].stringCol, 'B');
+
+            const after = realm.fileStats();
+            TestCase.assertTrue(after.fileSize < before.fileSize);
+            realm.close();
+        });
+    },
+
+    testCompactAsyncInWrite: function() {
+        const realm = new Realm({schema: [schemas.StringOnly]});
+        realm.write(() => {
+            TestCase.assertThrowsContaining(() => {
+                realm.compactAsync();
+            }, 'Cannot compact a Realm within a transaction.');
+        });
+        realm.close();
+
+        const inMemoryRealm = new Realm({inMemory: true, schema: [schemas.StringOnly]});
+        TestCase.assertThrowsContaining(() => inMemoryRealm.fileStats(), 'in-memory');
+        inMemoryRealm.close();
+    },
+
+    testMemoryStats: function() {
+        const realm = new Realm({schema: [schemas.TestObject]});
+        realm.write(() => realm.create('TestObject', {doubleCol: 1}));
+
+        const before = realm.memoryStats();
+        TestCase.assertTrue(before.fileSize > 0);
+        TestCase.assertTrue(before.pinnedVersions >= 1);
+        TestCase.assertTrue(before.readVersionAgeMs >= 0);
+        TestCase.assertTrue(before.oldestReadVersionAgeMs >= before.readVersionAgeMs);
+
+        const objects = realm.objects('TestObject');
+        const object = objects[0];
+        const listener = () => {};
+        objects.addListener(listener);
+        object.addListener(listener);
+
+        const during = realm.memoryStats();
+        TestCase.assertTrue(during.liveResults >= before.liveResults + 1);
+        TestCase.assertTrue(during.liveObjects >= before.liveObjects + 1);
+        TestCase.assertEqual(during.listeners, before.listeners + 2);
+
+        objects.removeAllListeners();
+        object.removeAllListeners();
+        TestCase.assertEqual(realm.memoryStats().listeners, before.listeners);
+        realm.close();
+        TestCase.assertThrowsContaining(() => realm.memoryStats(), 'closed');
+
+        const inMemoryRealm = new Realm({inMemory: true, schema: [schemas.TestObject]});
+        const inMemory = inMemoryRealm.memoryStats();
+        TestCase.assertNull(inMemory.fileSize);
+        TestCase.assertNull(inMemory.pinnedVersions);
+        TestCase.assertThrowsContaining(() => inMemoryRealm.setPinnedVersionsWarning(2, () => {}), 'in-memory');
+        inMemoryRealm.close();
+    },
+
+    testPinnedVersionsWarning: function() {
+        const realm = new Realm({schema: [schemas.TestObject]});
+        TestCase.assertThrows(() => realm.setPinnedVersionsWarning(0, () => {}));
+        TestCase.assertThrows(() => realm.setPinnedVersionsWarning(2, 'not a function'));
+
+        const warnings = [];
+        realm.setPinnedVersionsWarning(2, (r, versions) => warnings.push(versions));
+
+        // A second Realm which doesn't refresh keeps reading the version it
+        // started at while the first one writes.
+        const reader = new Realm({schema: [schemas.TestObject], _cache: false});
+        reader.autoRefresh = false;
+        reader.objects('TestObject').length;
+        for (let i = 0; i < 5; i++) {
+            realm.write(() => realm.create('TestObject', {doubleCol: i}));
+        }
+        TestCase.assertEqual(warnings.length, 1);
+        TestCase.assertTrue(warnings[0] > 2);
+
+        realm.setPinnedVersionsWarning(2, null);
+        reader.close();
+        realm.close();
+    },
+
     testRealmDeleteFileDefaultConfigPath: function() {
         const config = {schema: [schemas.TestObject]};
         const realm = new Realm(config);
@@ -1368,6 +1860,50 @@ module.exports = {
         realm.close();
     },
 
+    testRealmDeleteFiles: function() {
+        const closedConfig = {schema: [schemas.TestObject], path: 'test-realm-delete-files-closed.realm'};
+        const openConfig = {schema: [schemas.TestObject], path: 'test-realm-delete-files-open.realm'};
+        const closed = new Realm(closedConfig);
+        const closedPath = closed.path;
+        closed.close();
+        const open = new Realm(openConfig);
+
+        return Realm.deleteFiles([closedConfig.path, openConfig]).then((report) => {
+            TestCase.assertTrue(report.removed.indexOf(closedPath) !== -1);
+            TestCase.assertTrue(report.removed.indexOf(closedPath + '.lock') !== -1);
+            TestCase.assertArraysEqual(report.skipped, [open.path]);
+            TestCase.assertEqual(report.failed.length, 0);
+            TestCase.assertFalse(Realm.exists(closedConfig));
+            TestCase.assertTrue(Realm.exists(openConfig));
+
+            open.close();
+            return Realm.deleteFiles([openConfig]);
+        }).then((report) => {
+            TestCase.assertArraysEqual(report.skipped, []);
+            TestCase.assertFalse(Realm.exists(openConfig));
+        });
+    },
+
+    testRealmDeleteDirectories: function() {
+        const configs = ['one', 'two'].map((name) => ({schema: [schemas.TestObject], path: `test-tenant${pathSeparator}${name}.realm`}));
+        const paths = configs.map((config) => {
+            const realm = new Realm(config);
+            const path = realm.path;
+            realm.close();
+            return path;
+        });
+        const directory = paths[0].substring(0, paths[0].lastIndexOf(pathSeparator));
+
+        return Realm.deleteDirectories(['test-tenant', 'test-tenant-missing']).then((report) => {
+            TestCase.assertTrue(report.removed.indexOf(paths[0]) !== -1);
+            TestCase.assertTrue(report.removed.indexOf(paths[1]) !== -1);
+            TestCase.assertEqual(report.removed[report.removed.length - 1], directory);
+            TestCase.assertArraysEqual(report.skipped, []);
+            TestCase.assertEqual(report.failed.length, 0);
+            configs.forEach((config) => TestCase.assertFalse(Realm.exists(config)));
+        });
+    },
+
     testRealmDeleteFileSyncConfig: function() {
         if (!global.enableSyncTests) {
             return;
@@ -1722,6 +2258,49 @@ module.exports = {
         realm.close();
     },
 
+    testWriteCopyToAsync: function() {
+        const realm = new Realm({schema: [schemas.TestObject]});
+        realm.write(() => {
+            realm.create('TestObject', {doubleCol: 1});
+        });
+
+        TestCase.assertThrowsContaining(() => {
+            realm.writeCopyToAsync(34);
+        }, 'Target must be a path or a function.');
+        TestCase.assertThrowsContaining(() => {
+            realm.writeCopyToAsync(realm.path + '.copy-async.realm', new Int8Array(64), {bytesPerSecond: 1024});
+        }, 'An encrypted copy can only be written to a path');
+
+        const copyName = realm.path + '.copy-async.realm';
+        let progressCalls = 0;
+        const copied = realm.writeCopyToAsync(copyName, {bytesPerSecond: 1024 * 1024, progress: () => progressCalls++});
+
+        return copied.then((bytesWritten) => {
+            TestCase.assertTrue(bytesWritten > 0);
+            TestCase.assertTrue(progressCalls > 0);
+
+            const realmCopy = new Realm({path: copyName});
+            TestCase.assertEqual(1, realmCopy.objects('TestObject').length);
+            realmCopy.close();
+
+            const chunks = [];
+            return realm.writeCopyToAsync((chunk) => {
+                chunks.push(chunk);
+                return new Promise((resolve) => setTimeout(resolve, 0));
+            }).then((bytesWritten) => {
+                TestCase.assertTrue(chunks.length > 0);
+                TestCase.assertEqual(bytesWritten, chunks.reduce((size, chunk) => size + chunk.byteLength, 0));
+            });
+        }).then(() => {
+            const failure = new Error('upload failed');
+            return realm.writeCopyToAsync(() => Promise.reject(failure)).then(() => {
+                throw new Error('The copy should have been rejected');
+            }, (error) => {
+                TestCase.assertEqual(error, failure);
+            });
+        }).then(() => realm.close());
+    },
+
 
     testQueryBasedOnlyMethods: function() {
         if (!global.enableSyncTests) {
@@ -1749,6 +2328,165 @@ module.exports = {
         }, 'Wrong Realm type');
     } ,
 
+    testReopenWithSameSchemaArray: function() {
+        const schema = [schemas.TestObject, schemas.DefaultValues];
+        let realm = new Realm({schema});
+        realm.write(() => realm.create('DefaultValuesObject', {}));
+        realm.close();
+
+        // The second open reuses what was parsed for the first one,
+        // defaults included.
+        realm = new Realm({schema});
+        realm.write(() => realm.create('DefaultValuesObject', {}));
+        const objects = realm.objects('DefaultValuesObject');
+        TestCase.assertEqual(objects.length, 2);
+        TestCase.assertEqual(objects[1].intCol, -1);
+        TestCase.assertEqual(objects[1].stringCol, 'defaultString');
+        realm.close();
+
+        // Adding an object schema to the array is noticed.
+        schema.push(schemas.IntOnly);
+        realm = new Realm({schema, schemaVersion: 1});
+        TestCase.assertEqual(realm.schema.length, 3);
+        TestCase.assertEqual(realm.objects('IntOnlyObject').length, 0);
+        realm.close();
+    },
+
+    testReuseOpen: function() {
+        Realm._reuseOpenStats(true);
+
+        const config = {schema: [schemas.TestObject], _reuseOpen: true};
+        const first = new Realm(config);
+        const second = new Realm(config);
+        const other = new Realm(Object.assign({}, config, {path: 'other.realm'}));
+
+        const stats = Realm._reuseOpenStats(true);
+        TestCase.assertEqual(stats.hits, 1);
+        TestCase.assertEqual(stats.misses, 2);
+        TestCase.assertEqual(stats.hitRate, 1 / 3);
+
+        // Closing one handle leaves the Realm open for the others.
+        first.close();
+        first.close();
+        TestCase.assertTrue(first.isClosed);
+        TestCase.assertFalse(second.isClosed);
+        TestCase.assertThrowsContaining(() => first.objects('TestObject'), 'Cannot access realm that has been closed');
+        TestCase.assertThrowsContaining(() => first.write(() => {}), 'Cannot access realm that has been closed');
+        second.write(() => second.create('TestObject', {doubleCol: 1}));
+        TestCase.assertEqual(second.objects('TestObject').length, 1);
+
+        second.close();
+        TestCase.assertTrue(second.isClosed);
+        TestCase.assertTrue(first.isClosed);
+        TestCase.assertFalse(other.isClosed);
+        other.close();
+
+        // A closed Realm isn't handed out again.
+        const reopened = new Realm(config);
+        TestCase.assertFalse(reopened.isClosed);
+        TestCase.assertEqual(Realm._reuseOpenStats().hits, 0);
+        reopened.close();
+    },
+
+    testBoundaryStats: function() {
+        Realm._enableBoundaryStats(true);
+        Realm._boundaryStats(true);
+        try {
+            const realm = new Realm({schema: [schemas.TestObject]});
+            realm.write(() => realm.create('TestObject', {doubleCol: 1}));
+            realm.objects('TestObject');
+            realm.objects('TestObject');
+
+            const stats = Realm._boundaryStats(true);
+            TestCase.assertEqual(stats['Realm#objects'].calls, 2);
+            TestCase.assertTrue(stats['Realm#objects'].totalMs >= 0);
+            TestCase.assertEqual(stats['Realm#write'].calls, 1);
+            TestCase.assertUndefined(stats['Realm#objects=']);
+
+            // Reading with reset clears the counters.
+            TestCase.assertUndefined(Realm._boundaryStats()['Realm#objects']);
+            realm.close();
+        }
+        finally {
+            Realm._enableBoundaryStats(false);
+        }
+
+        // Nothing is counted while disabled.
+        Realm._boundaryStats(true);
+        new Realm({schema: [schemas.TestObject]}).close();
+        TestCase.assertEqual(Object.keys(Realm._boundaryStats()).length, 0);
+    },
+
+    testStartupStats: function() {
+        const stats = Realm._startupStats();
+        ['Realm', 'Collection', 'List', 'Results', 'Object'].forEach((name) => {
+            TestCase.assertTrue(stats[name] >= 0, `No time was recorded for ${name}`);
+        });
+
+        // Realm.Sync is created the first time it is read.
+        if (Realm.Sync) {
+            TestCase.assertTrue(Realm._startupStats().Sync >= 0);
+            TestCase.assertEqual(Realm.Sync, Realm.Sync);
+            TestCase.assertEqual(typeof Realm.Sync.User.login, 'function');
+        }
+    },
+
+    testTracing: function() {
+        TestCase.assertThrows(() => Realm.stopTracing());
+        TestCase.assertThrows(() => Realm.startTracing({bufferSize: 0}));
+
+        Realm.startTracing();
+        TestCase.assertThrows(() => Realm.startTracing());
+        let trace;
+        try {
+            const realm = new Realm({schema: [schemas.TestObject]});
+            realm.write(() => realm.create('TestObject', {doubleCol: 1}));
+            realm.objects('TestObject').filtered('doubleCol > 0').length;
+            realm.close();
+        }
+        finally {
+            trace = JSON.parse(Realm.stopTracing());
+        }
+
+        const names = trace.traceEvents.filter((event) => event.ph === 'X').map((event) => event.name);
+        ['write', 'beginTransaction', 'commitTransaction', 'filtered', 'evaluate'].forEach((name) => {
+            TestCase.assertTrue(names.indexOf(name) !== -1, `missing ${name}`);
+        });
+        const write = trace.traceEvents.find((event) => event.name === 'write');
+        const commit = trace.traceEvents.find((event) => event.name === 'commitTransaction');
+        TestCase.assertTrue(commit.ts >= write.ts && commit.ts + commit.dur <= write.ts + write.dur);
+
+        // Only the most recent events are kept.
+        Realm.startTracing({bufferSize: 2});
+        const realm = new Realm({schema: [schemas.TestObject]});
+        for (let i = 0; i < 5; i++) {
+            realm.beginTransaction();
+            realm.cancelTransaction();
+        }
+        realm.close();
+        trace = JSON.parse(Realm.stopTracing());
+        TestCase.assertTrue(trace.traceEvents.filter((event) => event.cat === 'transaction').length <= 2);
+        TestCase.assertTrue(trace.otherData.droppedEvents >= 8);
+    },
+
+    testRealmOpenAll: function() {
+        TestCase.assertThrows(() => Realm.openAll('not an array'));
+        TestCase.assertThrows(() => Realm.openAll([], {concurrency: 0}));
+
+        const configs = ['first.realm', 'second.realm', 'third.realm'].map((path) => ({path, schema: [schemas.TestObject]}));
+        return Realm.openAll(configs, {concurrency: 2}).then((realms) => {
+            TestCase.assertEqual(realms.length, 3);
+            realms.forEach((realm, index) => {
+                TestCase.assertTrue(realm.path.endsWith(configs[index].path));
+                TestCase.assertFalse(realm.isClosed);
+                realm.close();
+            });
+            return Realm.openAll([]);
+        }).then((realms) => {
+            TestCase.assertEqual(realms.length, 0);
+        });
+    },
+
     testObjectWithoutProperties: function() {
         const realm = new Realm({schema: [schemas.ObjectWithoutProperties]});
         realm.write(() => {
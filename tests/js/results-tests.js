@@ -174,6 +174,156 @@ module.exports = {
         TestCase.assertEqual(realm.objects('DefaultValuesObject').filtered('dateCol <= $0', new Date(4)).length, 2);
     },
 
+    testResultsFilteredPrepared: function() {
+        if (typeof navigator !== 'undefined' && /Chrome/.test(navigator.userAgent)) { // eslint-disable-line no-undef
+            // Prepared queries are not available through the debugger's RPC.
+            return;
+        }
+
+        var realm = new Realm({schema: [schemas.PersonObject, schemas.PersonList, schemas.TestObject]});
+        var list;
+        realm.write(function() {
+            list = realm.create('PersonList', {list: [
+                {name: 'Ari', age: 10},
+                {name: 'Tim', age: 11},
+                {name: 'Bjarne', age: 12},
+            ]}).list;
+            realm.create('PersonObject', {name: 'Alex', age: 12});
+        });
+
+        var query = realm.prepareQuery('PersonObject', 'name BEGINSWITH[c] $0 AND age > $1');
+        TestCase.assertEqual(query.run('a', 0).length, 2);
+        TestCase.assertEqual(query.run('a', 10).length, 1);
+        TestCase.assertEqual(query.run('a', 10)[0].name, 'Alex');
+        TestCase.assertEqual(query.run('t', 0)[0].name, 'Tim');
+
+        TestCase.assertEqual(realm.objects('PersonObject').filtered('age < 12').filteredPrepared(query, 'a', 0).length, 1);
+        TestCase.assertEqual(list.filteredPrepared(query, 'b', 0).length, 1);
+        TestCase.assertEqual(list.filteredPrepared(query, 'b', 0)[0].name, 'Bjarne');
+
+        TestCase.assertThrowsContaining(function() {
+            realm.objects('TestObject').filteredPrepared(query, 'a', 0);
+        }, "The query was prepared for objects of type 'PersonObject', not 'TestObject'.");
+        TestCase.assertThrows(function() {
+            realm.objects('PersonObject').filteredPrepared({}, 'a', 0);
+        });
+        TestCase.assertThrows(function() {
+            realm.prepareQuery('PersonObject', 'invalidQuery');
+        });
+        TestCase.assertThrows(function() {
+            query.run('a');
+        });
+
+        // Queries which are filtered on repeatedly give the same results.
+        for (var i = 0; i < 3; i++) {
+            TestCase.assertEqual(realm.objects('PersonObject').filtered('age = $0', 12).length, 2);
+        }
+        realm.close();
+    },
+
+    testResultsLimit: function() {
+        var realm = new Realm({schema: [schemas.IntPrimary]});
+        realm.write(function() {
+            for (var i = 0; i < 25; i++) {
+                realm.create('IntPrimaryObject', {primaryCol: i, valueCol: 'value ' + (i % 3)});
+            }
+        });
+
+        var objects = realm.objects('IntPrimaryObject');
+        TestCase.assertThrows(function() { objects.limit(-1); });
+        TestCase.assertThrows(function() { objects.limit(1.5); });
+        TestCase.assertThrows(function() { objects.limit(); });
+
+        var limited = objects.sorted('primaryCol', true).limit(5);
+        var fromQuery = objects.filtered('TRUEPREDICATE SORT(primaryCol DESC) LIMIT(5)');
+        TestCase.assertArraysEqual(limited.map(function(o) { return o.primaryCol; }), [24, 23, 22, 21, 20]);
+        TestCase.assertArraysEqual(fromQuery.map(function(o) { return o.primaryCol; }), [24, 23, 22, 21, 20]);
+        TestCase.assertEqual(objects.limit(0).length, 0);
+
+        // The objects after the limit move up when those within it are removed.
+        realm.write(function() {
+            realm.delete(realm.objectForPrimaryKey('IntPrimaryObject', 24));
+        });
+        TestCase.assertArraysEqual(limited.map(function(o) { return o.primaryCol; }), [23, 22, 21, 20, 19]);
+        realm.close();
+    },
+
+    testResultsCursor: function() {
+        if (typeof navigator !== 'undefined' && /Chrome/.test(navigator.userAgent)) { // eslint-disable-line no-undef
+            // Cursors are not yet supported by the Chrome debugger
+            return;
+        }
+
+        var realm = new Realm({schema: [schemas.IntPrimary, schemas.TestObject]});
+        realm.write(function() {
+            for (var i = 0; i < 25; i++) {
+                realm.create('IntPrimaryObject', {primaryCol: i, valueCol: 'value ' + (i % 3)});
+            }
+        });
+        var objects = realm.objects('IntPrimaryObject');
+        var keys = function(page) { return page.map(function(o) { return o.primaryCol; }); };
+
+        TestCase.assertThrows(function() { objects.cursor({sortBy: 'invalidProperty'}); });
+        TestCase.assertThrows(function() { objects.cursor({pageSize: 0}); });
+        TestCase.assertThrows(function() { objects.cursor({after: realm.objects('TestObject')}); });
+        TestCase.assertThrows(function() { realm.objects('TestObject').cursor(); });
+
+        // Objects added before the last page read don't move the ones after it.
+        var cursor = objects.cursor({pageSize: 10});
+        TestCase.assertArraysEqual(keys(cursor.next()), [0, 1, 2, 3, 4, 5, 6, 7, 8, 9]);
+        realm.write(function() {
+            realm.create('IntPrimaryObject', {primaryCol: -1, valueCol: 'value 0'});
+        });
+        TestCase.assertArraysEqual(keys(cursor.next()), [10, 11, 12, 13, 14, 15, 16, 17, 18, 19]);
+        TestCase.assertFalse(cursor.done);
+        TestCase.assertArraysEqual(keys(cursor.next()), [20, 21, 22, 23, 24]);
+        TestCase.assertTrue(cursor.done);
+        TestCase.assertEqual(cursor.next().length, 0);
+
+        // Ties are ordered by the primary key.
+        var filtered = objects.filtered('primaryCol >= 0');
+        cursor = filtered.cursor({sortBy: [['valueCol', true]], pageSize: 4});
+        TestCase.assertArraysEqual(keys(cursor.next()), [2, 5, 8, 11]);
+        var page = cursor.next();
+        TestCase.assertArraysEqual(keys(page), [14, 17, 20, 23]);
+
+        var resumed = filtered.cursor({sortBy: [['valueCol', true]], pageSize: 4, after: page[page.length - 1]});
+        TestCase.assertArraysEqual(keys(resumed.next()), [1, 4, 7, 10]);
+        realm.close();
+    },
+
+    testResultsExplainAndProfile: function() {
+        var realm = new Realm({schema: [schemas.IndexedTypes]});
+        realm.write(function() {
+            for (var i = 0; i < 10; i++) {
+                realm.create('IndexedTypesObject', {boolCol: i % 2 == 0, intCol: i, stringCol: 'String ' + i, dateCol: new Date(i)});
+            }
+        });
+
+        var results = realm.objects('IndexedTypesObject').filtered('stringCol == $0 OR stringCol BEGINSWITH "S" SORT(intCol DESC)', 'String 3');
+        var explanation = results.explain();
+        TestCase.assertEqual(explanation.objectType, 'IndexedTypesObject');
+        TestCase.assertEqual(explanation.query, results.description().split(' SORT')[0].trim());
+        TestCase.assertEqual(explanation.conditions.length, 2);
+        TestCase.assertEqual(explanation.conditions[0].keyPath, 'stringCol');
+        TestCase.assertTrue(explanation.conditions[0].indexed);
+        TestCase.assertTrue(explanation.conditions[0].usesIndex);
+        TestCase.assertTrue(explanation.conditions[1].indexed);
+        TestCase.assertFalse(explanation.conditions[1].usesIndex);
+
+        var profile = results.profile();
+        TestCase.assertEqual(profile.query, explanation.query);
+        TestCase.assertEqual(profile.rowsExamined, 10);
+        TestCase.assertEqual(profile.rowsMatched, 10);
+        TestCase.assertEqual(profile.rowsReturned, 10);
+        TestCase.assertTrue(profile.evaluateMillis >= 0);
+        TestCase.assertTrue(profile.orderMillis >= 0);
+        TestCase.assertTrue(profile.parseMillis >= 0);
+
+        TestCase.assertEqual(realm.objects('IndexedTypesObject').filtered('intCol > 5').profile().rowsMatched, 4);
+        realm.close();
+    },
+
     testResultsFilteredByForeignObject: function() {
         var realm = new Realm({schema: [schemas.LinkTypes, schemas.TestObject]});
         var realm2 = new Realm({path: '2.realm', schema: realm.schema});
@@ -476,6 +626,251 @@ module.exports = {
         });
     },
 
+    testAddListenerChangeSetFormats: function() {
+        if (typeof navigator !== 'undefined' && /Chrome/.test(navigator.userAgent)) { // eslint-disable-line no-undef
+            // FIXME: async callbacks do not work correctly in Chrome debugging mode
+            return Promise.resolve();
+        }
+
+        const realm = new Realm({ schema: [schemas.TestObject] });
+        const objects = realm.objects('TestObject');
+        TestCase.assertThrows(() => objects.addListener(() => {}, { changeSetFormat: 'unknown' }));
+
+        let resolveTyped, resolveRanges;
+        const typed = new Promise(r => resolveTyped = r);
+        const ranges = new Promise(r => resolveRanges = r);
+        let typedCalls = 0, rangesCalls = 0;
+
+        objects.addListener((collection, changes) => {
+            if (typedCalls++ === 0) {
+                return;
+            }
+            TestCase.assertTrue(changes.insertions instanceof Int32Array);
+            TestCase.assertArraysEqual(Array.from(changes.insertions), [0, 1, 2, 3, 4]);
+            TestCase.assertTrue(changes.deletions instanceof Int32Array);
+            TestCase.assertEqual(changes.insertions, changes.insertions);
+            resolveTyped();
+        }, { changeSetFormat: 'int32Array' });
+
+        objects.addListener((collection, changes) => {
+            if (rangesCalls++ === 0) {
+                return;
+            }
+            TestCase.assertEqual(changes.insertions.length, 1);
+            TestCase.assertArraysEqual(changes.insertions[0], [0, 5]);
+            TestCase.assertEqual(changes.modifications.length, 0);
+            TestCase.assertArraysEqual(Object.keys(changes).sort(),
+                ['deletions', 'insertions', 'modifications', 'newModifications', 'oldModifications']);
+            TestCase.assertEqual(JSON.stringify(changes),
+                JSON.stringify({ insertions: [[0, 5]], deletions: [], modifications: [], oldModifications: [], newModifications: [] }));
+            resolveRanges();
+        }, { changeSetFormat: 'ranges' });
+
+        realm.write(() => {
+            for (let i = 0; i < 5; i++) {
+                realm.create('TestObject', { doubleCol: i });
+            }
+        });
+
+        return Promise.all([typed, ranges]).then(() => realm.close());
+    },
+
+    testResultsObserveAggregate: function() {
+        if (typeof navigator !== 'undefined' && /Chrome/.test(navigator.userAgent)) { // eslint-disable-line no-undef
+            // FIXME: async callbacks do not work correctly in Chrome debugging mode
+            return Promise.resolve();
+        }
+
+        const realm = new Realm({ schema: [schemas.TestObject] });
+        realm.write(() => {
+            realm.create('TestObject', { doubleCol: 1 });
+            realm.create('TestObject', { doubleCol: 2 });
+            realm.create('TestObject', { doubleCol: 3 });
+        });
+        const objects = realm.objects('TestObject');
+        TestCase.assertThrows(() => objects.observeAggregate('median', 'doubleCol', () => {}));
+        TestCase.assertThrows(() => objects.observeAggregate('sum', 'invalidProperty', () => {}));
+        TestCase.assertThrows(() => objects.observeAggregate('sum', 'doubleCol'));
+
+        const maxima = [];
+        objects.observeAggregate('max', 'doubleCol', (value, details) => {
+            maxima.push([value, details.rescanned]);
+        });
+
+        const steps = [
+            () => realm.create('TestObject', { doubleCol: 4 }),
+            () => realm.delete(objects.filtered('doubleCol = 4')),
+            () => objects[0].doubleCol = 10,
+        ];
+        const sums = [];
+        return new Promise((resolve, reject) => {
+            objects.observeAggregate('sum', 'doubleCol', (value, details) => {
+                try {
+                    sums.push(value);
+                    if (sums.length === 1) {
+                        TestCase.assertUndefined(details.previousValue);
+                    }
+                    else {
+                        TestCase.assertEqual(details.previousValue, sums[sums.length - 2]);
+                        TestCase.assertFalse(details.rescanned);
+                    }
+                    const step = steps.shift();
+                    if (!step) {
+                        resolve();
+                        return;
+                    }
+                    realm.write(step);
+                }
+                catch (e) {
+                    reject(e);
+                }
+            });
+        }).then(() => {
+            TestCase.assertArraysEqual(sums, [6, 10, 6, 15]);
+            TestCase.assertArraysEqual(maxima.map(m => m[0]), [3, 4, 3, 10]);
+            // Deleting the maximum needs the others to be looked at again.
+            TestCase.assertTrue(maxima[2][1]);
+            TestCase.assertFalse(maxima[3][1]);
+            objects.removeAllListeners();
+            realm.close();
+        });
+    },
+
+    testResultsFilteredAndSortedAsync: function() {
+        if (typeof navigator !== 'undefined' && /Chrome/.test(navigator.userAgent)) { // eslint-disable-line no-undef
+            // FIXME: async callbacks do not work correctly in Chrome debugging mode
+            return Promise.resolve();
+        }
+
+        const realm = new Realm({ schema: [schemas.TestObject] });
+        realm.write(() => {
+            for (let i = 0; i < 10; i++) {
+                realm.create('TestObject', { doubleCol: i });
+            }
+        });
+        const objects = realm.objects('TestObject');
+        TestCase.assertThrows(() => objects.filteredAsync('invalidProperty > 1'));
+
+        return objects.filteredAsync('doubleCol >= $0', 5)
+            .then(filtered => {
+                TestCase.assertTrue(filtered instanceof Realm.Results);
+                TestCase.assertEqual(filtered.length, 5);
+                return filtered.sortedAsync('doubleCol', true);
+            })
+            .then(sorted => {
+                TestCase.assertArraysEqual(sorted.map(o => o.doubleCol), [9, 8, 7, 6, 5]);
+
+                // The results stay live after being evaluated.
+                realm.write(() => realm.create('TestObject', { doubleCol: 10 }));
+                TestCase.assertEqual(sorted.length, 6);
+                TestCase.assertEqual(sorted[0].doubleCol, 10);
+
+                let inWrite;
+                realm.write(() => {
+                    inWrite = objects.filteredAsync('doubleCol < 1');
+                });
+                return inWrite;
+            })
+            .then(filtered => {
+                TestCase.assertEqual(filtered.length, 1);
+
+                // Removing the listeners of a collection rejects its pending evaluations.
+                const evaluated = objects.filtered('doubleCol > 0');
+                const removed = new Promise(resolve => evaluated._evaluateAsync((results, error) => resolve(error)));
+                evaluated.removeAllListeners();
+                return removed;
+            })
+            .then(error => {
+                TestCase.assertEqual(error, 'The listeners of the collection were removed before it was evaluated.');
+
+                // Closing the Realm rejects evaluations which are still pending.
+                const pending = objects.filteredAsync('doubleCol > 0');
+                realm.close();
+                return pending.then(() => {
+                    throw new Error('The evaluation should have been rejected');
+                }, error => {
+                    TestCase.assertEqual(error.message, 'The Realm was closed before the collection was evaluated.');
+                });
+            });
+    },
+
+    testAddListenerOptions() {
+        const realm = new Realm({ schema: [schemas.TestObject] });
+        const objects = realm.objects('TestObject');
+        const listener = () => {};
+
+        // The options are validated natively both where the listener methods are wrapped and
+        // on JavaScriptCore, where they aren't.
+        realm.addListener('change', listener, {});
+        realm.addListener('change', listener, undefined);
+        objects.addListener(listener, {});
+        TestCase.assertThrowsContaining(() => realm.addListener('change', listener, 5), "options must be of type 'object'");
+        TestCase.assertThrowsContaining(() => objects.addListener(listener, 5), "options must be of type 'object'");
+        TestCase.assertThrows(() => realm.addListener('change', listener, { minInterval: -1 }));
+        TestCase.assertThrows(() => objects.addListener(listener, { maxDelay: -1 }));
+
+        if (!Object.getOwnPropertyDescriptor(Realm.prototype, 'addListener').configurable) {
+            const message = "The 'minInterval' and 'maxDelay' listener options are not supported with JavaScriptCore.";
+            TestCase.assertThrowsContaining(() => realm.addListener('change', listener, { minInterval: 10 }), message);
+            TestCase.assertThrowsContaining(() => objects.addListener(listener, { maxDelay: 10 }), message);
+        }
+
+        realm.removeAllListeners();
+        objects.removeAllListeners();
+        realm.close();
+    },
+
+    testAddListenerThrottled: function() {
+        if (!TestCase.isNode()) {
+            return Promise.resolve();
+        }
+
+        const realm = new Realm({ schema: [schemas.TestObject] });
+        const objects = realm.objects('TestObject');
+        realm.write(() => {
+            realm.create('TestObject', { doubleCol: 0 });
+            realm.create('TestObject', { doubleCol: 1 });
+        });
+        TestCase.assertThrows(() => objects.addListener(() => {}, { minInterval: -1 }));
+
+        const calls = [];
+        let resolve;
+        const done = new Promise(r => resolve = r);
+        const listener = (collection, changes) => {
+            calls.push(changes);
+            if (calls.length === 1) {
+                // Both writes arrive within the interval and are delivered together.
+                setTimeout(() => {
+                    realm.write(() => {
+                        objects[0].doubleCol = 10;
+                        realm.create('TestObject', { doubleCol: 2 });
+                    });
+                    setTimeout(() => {
+                        realm.write(() => {
+                            realm.delete(objects[1]);
+                            realm.create('TestObject', { doubleCol: 3 });
+                        });
+                    }, 0);
+                }, 0);
+            } else {
+                resolve();
+            }
+        };
+        objects.addListener(listener, { minInterval: 100 });
+
+        return done.then(() => {
+            TestCase.assertEqual(calls.length, 2);
+            const changes = calls[1];
+            TestCase.assertEqual(2 - changes.deletions.length + changes.insertions.length, objects.length);
+            TestCase.assertTrue(changes.deletions.length > 0);
+            TestCase.assertArraysEqual(changes.oldModifications, [0]);
+            TestCase.assertArraysEqual(changes.newModifications, [0]);
+
+            objects.removeListener(listener);
+            realm.close();
+        });
+    },
+
     testResultsAggregateFunctions: function() {
         var realm = new Realm({ schema: [schemas.NullableBasicTypes] });
         const N = 50;
@@ -665,6 +1060,55 @@ module.exports = {
         TestCase.assertEqual(realm.objects('TestObject').length, 0);
     },
 
+    testIteratorChunks: function() {
+        const N = 150;
+        var realm = new Realm({ schema: [ schemas.TestObject, schemas.PrimitiveArrays ]});
+        var list;
+        realm.write(() => {
+            for (let i = 0; i < N; i++) {
+                realm.create('TestObject', { doubleCol: i });
+            }
+            list = realm.create('PrimitiveArrays', { int: [1, 2, 3] }).int;
+        });
+
+        var results = realm.objects('TestObject').sorted('doubleCol');
+        var values = [];
+        for (let obj of results) {
+            TestCase.assertTrue(obj instanceof Realm.Object);
+            values.push(obj.doubleCol);
+        }
+        TestCase.assertEqual(values.length, N);
+        TestCase.assertEqual(values[N - 1], N - 1);
+
+        // The iteration reads the objects it started with.
+        var count = 0;
+        realm.write(() => {
+            for (let obj of results.iterate({ chunkSize: 10 })) {
+                if (count === 0) {
+                    realm.create('TestObject', { doubleCol: -1 });
+                }
+                count++;
+            }
+        });
+        TestCase.assertEqual(count, N);
+
+        var plain = Array.from(results.iterate({ chunkSize: 7, plain: { properties: ['doubleCol'] } }));
+        TestCase.assertEqual(plain.length, N + 1);
+        TestCase.assertFalse(plain[0] instanceof Realm.Object);
+        TestCase.assertEqual(plain[0].doubleCol, -1);
+
+        var entries = Array.from(results.entries());
+        TestCase.assertArraysEqual(entries[N], [N, entries[N][1]]);
+        TestCase.assertEqual(entries[N][1].doubleCol, N - 1);
+
+        TestCase.assertArraysEqual(Array.from(list), [1, 2, 3]);
+        TestCase.assertArraysEqual(Array.from(list.iterate({ chunkSize: 2, plain: true })), [1, 2, 3]);
+
+        TestCase.assertThrows(() => results.iterate({ chunkSize: 0 }));
+        TestCase.assertThrows(() => list.iterate({ plain: { properties: ['doubleCol'] } }));
+        realm.close();
+    },
+
     testResultsUpdate: function() {
         const N = 5;
 
@@ -815,6 +1259,110 @@ module.exports = {
         realm.close();
     },
 
+    testResultsUpdateMultipleProperties() {
+        const realm = new Realm({schema: [schemas.NullableBasicTypes]});
+        realm.write(() => {
+            for (let i = 0; i < 5; i++) {
+                realm.create('NullableBasicTypesObject', {intCol: i, stringCol: 'hello'});
+            }
+        });
+
+        const results = realm.objects('NullableBasicTypesObject').filtered('intCol < 3');
+        realm.write(() => {
+            results.update({stringCol: 'world', boolCol: true, intCol: 10, dateCol: null});
+        });
+
+        const objects = realm.objects('NullableBasicTypesObject');
+        TestCase.assertEqual(objects.filtered('stringCol = "world" AND boolCol = true AND intCol = 10').length, 3);
+        TestCase.assertEqual(objects.filtered('stringCol = "hello"').length, 2);
+
+        TestCase.assertThrows(() => {
+            realm.write(() => {
+                objects.update({stringCol: 'valid', intCol: 'not a number'});
+            });
+        });
+        TestCase.assertThrows(() => {
+            realm.write(() => {
+                objects.update({unknownCol: 1});
+            });
+        });
+
+        // Nothing is written when any of the values is invalid, even if the
+        // error is caught inside the transaction.
+        realm.write(() => {
+            TestCase.assertThrows(() => objects.update({stringCol: 'partial', dateCol: null, intCol: 'not a number'}));
+        });
+        TestCase.assertEqual(objects.filtered('stringCol = "partial"').length, 0);
+
+        realm.close();
+    },
+
+    testResultsUpdateLink() {
+        const realm = new Realm({schema: [schemas.LinkTypes, schemas.TestObject]});
+        let target;
+        realm.write(() => {
+            target = realm.create('TestObject', {doubleCol: 1});
+            for (let i = 0; i < 3; i++) {
+                realm.create('LinkTypesObject', {objectCol: null, arrayCol: []});
+            }
+        });
+
+        const objects = realm.objects('LinkTypesObject');
+        realm.write(() => {
+            objects.update('objectCol', target);
+            objects.update('objectCol1', {doubleCol: 2});
+            objects.update('arrayCol', [target]);
+        });
+        TestCase.assertEqual(objects.filtered('objectCol.doubleCol = 1 AND objectCol1.doubleCol = 2').length, 3);
+        TestCase.assertEqual(objects.filtered('arrayCol.@count = 1').length, 3);
+        TestCase.assertEqual(realm.objects('TestObject').length, 2);
+
+        realm.write(() => {
+            objects.update('objectCol', null);
+        });
+        TestCase.assertEqual(objects.filtered('objectCol = null').length, 3);
+
+        realm.close();
+    },
+
+    testResultsSlice() {
+        const realm = new Realm({schema: [schemas.LinkTypes, schemas.TestObject]});
+        realm.write(() => {
+            for (let i = 0; i < 10; i++) {
+                realm.create('LinkTypesObject', {objectCol: {doubleCol: i}, arrayCol: []});
+            }
+        });
+
+        const objects = realm.objects('TestObject');
+        TestCase.assertArraysEqual(objects.slice(2, 5).map(o => o.doubleCol), [2, 3, 4]);
+        TestCase.assertArraysEqual(objects.slice(-2).map(o => o.doubleCol), [8, 9]);
+        TestCase.assertArraysEqual(objects.slice(8, 20).map(o => o.doubleCol), [8, 9]);
+        TestCase.assertEqual(objects.slice(5, 2).length, 0);
+        TestCase.assertEqual(objects.slice().length, 10);
+        TestCase.assertTrue(objects.slice(0, 1)[0] instanceof Realm.Object);
+        TestCase.assertTrue(objects.slice(0, 1)[0].isValid());
+
+        const projected = objects.slice(0, 3, {properties: ['doubleCol']});
+        TestCase.assertEqual(projected.length, 3);
+        TestCase.assertFalse(projected[0] instanceof Realm.Object);
+        TestCase.assertArraysEqual(Object.keys(projected[0]), ['doubleCol']);
+        TestCase.assertEqual(projected[1].doubleCol, 1);
+
+        const empty = objects.slice(0, 2, {properties: []});
+        TestCase.assertEqual(empty.length, 2);
+        TestCase.assertFalse(empty[0] instanceof Realm.Object);
+        TestCase.assertArraysEqual(Object.keys(empty[0]), []);
+
+        const links = realm.objects('LinkTypesObject').slice(0, 2, {properties: ['objectCol']});
+        TestCase.assertTrue(links[0].objectCol instanceof Realm.Object);
+        TestCase.assertEqual(links[1].objectCol.doubleCol, 1);
+
+        TestCase.assertThrows(() => objects.slice(0, 1, {properties: ['unknownCol']}));
+        TestCase.assertThrows(() => objects.slice('a'));
+
+        realm.close();
+    },
+
     testResultsUpdateEmpty() {
         var realm = new Realm({schema: [schemas.NullableBasicTypes]});
 
@@ -677,6 +677,132 @@ module.exports = {
             });
     },
 
+    testProgressNotificationsWithOptions() {
+        if (!isNodeProcess) {
+            return;
+        }
+
+        const username = Utils.uuid();
+        const realmName = Utils.uuid();
+
+        const credentials = Realm.Sync.Credentials.nickname(username);
+        return Realm.Sync.User.login('http://127.0.0.1:9080', credentials)
+            .then(user => {
+                let config = {
+                    sync: {
+                        user,
+                        url: `realm://127.0.0.1:9080/~/${realmName}`
+                    },
+                    schema: [{ name: 'Dog', properties: { name: 'string' } }],
+                };
+
+                let realm = new Realm(config);
+                TestCase.assertThrows(() => realm.syncSession.addProgressNotification('upload', 'reportIndefinitely', () => {}, {minIntervalMs: -1}));
+
+                return new Promise((resolve, reject) => {
+                    let sessionCallbacks = 0;
+                    let sessionDone = false, userDone = false;
+                    realm.syncSession.addProgressNotification('upload', 'forCurrentlyOutstandingWork', (transferred, transferable) => {
+                        sessionCallbacks++;
+                        if (transferred === transferable) {
+                            sessionDone = true;
+                            if (userDone) {
+                                resolve(sessionCallbacks);
+                            }
+                        }
+                    }, {minIntervalMs: 1000, minDeltaBytes: 1024 * 1024});
+
+                    const userCallback = (transferred, transferable) => {
+                        if (transferred === transferable) {
+                            user.removeProgressNotification(userCallback);
+                            userDone = true;
+                            if (sessionDone) {
+                                resolve(sessionCallbacks);
+                            }
+                        }
+                    };
+                    user.addProgressNotification('upload', 'forCurrentlyOutstandingWork', userCallback, {minIntervalMs: 1000});
+
+                    realm.write(() => {
+                        for (let i = 1; i <= 100; i++) {
+                            realm.create('Dog', { name: `Lassy ${i}` });
+                        }
+                    });
+                    setTimeout(() => reject(new Error('The final progress was not delivered')), 10000);
+                });
+            })
+            .then(sessionCallbacks => {
+                // Only the first progress and the final one get through limits which are this wide.
+                TestCase.assertTrue(sessionCallbacks >= 1 && sessionCallbacks <= 2);
+            });
+    },
+
+    testSSLValidateCallbackCache() {
+        if (!isNodeProcess) {
+            return;
+        }
+
+        const credentials = Realm.Sync.Credentials.nickname(Utils.uuid());
+        return Realm.Sync.User.login('http://127.0.0.1:9080', credentials).then(user => {
+            const validateCallback = () => true;
+            const config = (ssl) => ({
+                sync: { user, url: `realm://127.0.0.1:9080/~/${Utils.uuid()}`, ssl },
+                schema: [{ name: 'Dog', properties: { name: 'string' } }],
+            });
+            TestCase.assertThrows(() => new Realm(config({ validateCallback, validateCallbackCacheMs: -1 })));
+            TestCase.assertThrows(() => new Realm(config({ validateCallback, validateCallbackCacheMs: 'forever' })));
+
+            // Every Realm using the callback shares its cached answers.
+            const realm1 = new Realm(config({ validateCallback, validateCallbackCacheMs: 60000 }));
+            const realm2 = new Realm(config({ validateCallback, validateCallbackCacheMs: 60000 }));
+            TestCase.assertType(validateCallback._sslVerificationCacheId, 'number');
+            realm1.close();
+            realm2.close();
+        });
+    },
+
+    testSyncStats() {
+        if (!isNodeProcess) {
+            return;
+        }
+
+        const username = Utils.uuid();
+        const realmName = Utils.uuid();
+
+        const credentials = Realm.Sync.Credentials.nickname(username);
+        return Realm.Sync.User.login('http://127.0.0.1:9080', credentials)
+            .then(user => {
+                let config = {
+                    sync: {
+                        user,
+                        url: `realm://127.0.0.1:9080/~/${realmName}`
+                    },
+                    schema: [{ name: 'Dog', properties: { name: 'string' } }],
+                };
+
+                let realm = new Realm(config);
+                realm.write(() => {
+                    for (let i = 1; i <= 100; i++) {
+                        realm.create('Dog', { name: `Lassy ${i}` });
+                    }
+                });
+                return realm.syncSession.uploadAllLocalChanges().then(() => realm);
+            })
+            .then(realm => {
+                const stats = Realm.Sync.getStats();
+                const session = stats.sessions.find(session => session.path === realm.path);
+                TestCase.assertDefined(session);
+                TestCase.assertTrue(session.uploadedBytes > 0);
+                TestCase.assertEqual(session.uploadedBytes, session.uploadableBytes);
+
+                const connection = stats.connections[session.connection];
+                TestCase.assertEqual(connection.serverUrl, 'realm://127.0.0.1:9080');
+                TestCase.assertTrue(connection.sessions >= 1);
+                TestCase.assertTrue(connection.uploadedBytes >= session.uploadedBytes);
+                realm.close();
+            });
+    },
+
     testProgressNotificationsForRealmOpen() {
         if (!isNodeProcess) {
             return;
@@ -116,6 +116,34 @@ function verifySubscriptionWithParents(parentToInclude, filterClause) {
 
 module.exports = {
 
+    testSubscribeAll() {
+        return getRealm().then(realm => {
+            const group = realm.subscribeAll([
+                { results: realm.objects("ObjectA"), options: "all-a" },
+                { results: realm.objects("Parent").filtered("name = 'p1'"), options: { name: "p1", includeLinkingObjects: [] } },
+            ]);
+            TestCase.assertEqual(group.subscriptions.length, 2);
+            TestCase.assertEqual(group.subscriptions[0].name, "all-a");
+            TestCase.assertEqual(group.subscriptions[1].name, "p1");
+            TestCase.assertEqual(group.state, Realm.Sync.SubscriptionState.Creating);
+
+            // An invalid entry creates none of the subscriptions.
+            TestCase.assertThrows(() => realm.subscribeAll([
+                { results: realm.objects("ObjectA"), options: "not-created" },
+                { results: realm.objects("ObjectA"), options: { unknown: true } },
+            ]));
+
+            return group.waitForCompletion().then(result => {
+                TestCase.assertEqual(result, group);
+                TestCase.assertEqual(group.state, Realm.Sync.SubscriptionState.Complete);
+                TestCase.assertEqual(realm.subscriptions("all-a").length, 1);
+                TestCase.assertEqual(realm.subscriptions("p1").length, 1);
+                TestCase.assertEqual(realm.subscriptions("not-created").length, 0);
+                group.unsubscribe();
+            });
+        });
+    },
+
     testSubscriptionWrapperProperties() {
         return getRealm().then(realm => {
             const subscription = realm.objects("ObjectA").subscribe("test");